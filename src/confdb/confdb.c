@@ -1139,6 +1139,17 @@ static int confdb_get_domain_internal(struct confdb_ctx *cdb,
         goto done;
     }
 
+    /* 0 means the default number of rounds of the hash function */
+    ret = get_entry_as_uint32(res->msgs[0],
+                              &domain->cache_credentials_hash_rounds,
+                              CONFDB_DOMAIN_CACHE_CREDS_HASH_ROUNDS, 0);
+    if (ret != EOK) {
+        DEBUG(SSSDBG_FATAL_FAILURE,
+              "Invalid value for %s\n",
+              CONFDB_DOMAIN_CACHE_CREDS_HASH_ROUNDS);
+        goto done;
+    }
+
     /* Get the global entry cache timeout setting */
     ret = get_entry_as_uint32(res->msgs[0], &entry_cache_timeout,
                               CONFDB_DOMAIN_ENTRY_CACHE_TIMEOUT, 5400);
@@ -99,8 +99,11 @@
 /* NSS */
 #define CONFDB_NSS_CONF_ENTRY "config/nss"
 #define CONFDB_NSS_ENUM_CACHE_TIMEOUT "enum_cache_timeout"
+#define CONFDB_NSS_ENUM_PAGE_SIZE "enum_page_size"
 #define CONFDB_NSS_ENTRY_CACHE_NOWAIT_PERCENTAGE "entry_cache_nowait_percentage"
 #define CONFDB_NSS_ENTRY_NEG_TIMEOUT "entry_negative_timeout"
+#define CONFDB_NSS_NEG_CACHE_BACKEND "negative_cache_backend"
+#define CONFDB_NSS_NEG_CACHE_BACKEND_DEFAULT "hash"
 #define CONFDB_NSS_FILTER_USERS_IN_GROUPS "filter_users_in_groups"
 #define CONFDB_NSS_FILTER_USERS "filter_users"
 #define CONFDB_NSS_FILTER_GROUPS "filter_groups"
@@ -115,6 +118,10 @@
 #define CONFDB_MEMCACHE_TIMEOUT "memcache_timeout"
 #define CONFDB_NSS_HOMEDIR_SUBSTRING "homedir_substring"
 #define CONFDB_DEFAULT_HOMEDIR_SUBSTRING "/home"
+#define CONFDB_NSS_RESULT_CACHE_SIZE "result_cache_size"
+#define CONFDB_NSS_RESULT_CACHE_SIZE_DEFAULT 0
+#define CONFDB_NSS_RESULT_CACHE_TIMEOUT "result_cache_timeout"
+#define CONFDB_NSS_RESULT_CACHE_TIMEOUT_DEFAULT 5
 
 /* PAM */
 #define CONFDB_PAM_CONF_ENTRY "config/pam"
@@ -138,6 +145,10 @@
 #define CONFDB_PAM_APP_SERVICES "pam_app_services"
 #define CONFDB_PAM_P11_ALLOWED_SERVICES "pam_p11_allowed_services"
 #define CONFDB_PAM_P11_URI "p11_uri"
+#define CONFDB_PAM_TOKEN_CACHE_SIZE "pam_token_cache_size"
+#define CONFDB_PAM_TOKEN_CACHE_SIZE_DEFAULT 1000
+#define CONFDB_PAM_TOKEN_CACHE_TIMEOUT "pam_token_cache_timeout"
+#define CONFDB_PAM_TOKEN_CACHE_TIMEOUT_DEFAULT 15
 
 /* SUDO */
 #define CONFDB_SUDO_CONF_ENTRY "config/sudo"
@@ -212,6 +223,7 @@
 #define CONFDB_DOMAIN_CACHE_CREDS_MIN_FF_LENGTH \
                                  "cache_credentials_minimal_first_factor_length"
 #define CONFDB_DEFAULT_CACHE_CREDS_MIN_FF_LENGTH 8
+#define CONFDB_DOMAIN_CACHE_CREDS_HASH_ROUNDS "cache_credentials_hash_rounds"
 #define CONFDB_DOMAIN_AUTO_UPG "auto_private_groups"
 #define CONFDB_DOMAIN_FQ "use_fully_qualified_names"
 #define CONFDB_DOMAIN_ENTRY_CACHE_TIMEOUT "entry_cache_timeout"
@@ -278,6 +290,7 @@
 #define CONFDB_KCM_MAX_CCACHES "max_ccaches"
 #define CONFDB_KCM_MAX_UID_CCACHES "max_uid_ccaches"
 #define CONFDB_KCM_MAX_CCACHE_SIZE "max_ccache_size"
+#define CONFDB_KCM_FLUSH_INTERVAL "ccache_flush_interval"
 
 /* Certificate mapping rules */
 #define CONFDB_CERTMAP_BASEDN "cn=certmap,cn=config"
@@ -359,6 +372,7 @@ struct sss_domain_info {
 
     bool cache_credentials;
     uint32_t cache_credentials_min_ff_length;
+    uint32_t cache_credentials_hash_rounds;
     bool case_sensitive;
     bool case_preserve;
 
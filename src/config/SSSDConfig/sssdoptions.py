@@ -57,9 +57,11 @@ class SSSDOptions(object):
 
         # [nss]
         'enum_cache_timeout': _('Enumeration cache timeout length (seconds)'),
+        'enum_page_size': _('Number of users or groups read from the cache at once during enumeration'),
         'entry_cache_no_wait_timeout': _('Entry cache background update timeout length (seconds)'),
         'entry_negative_timeout': _('Negative cache timeout length (seconds)'),
         'local_negative_timeout': _('Files negative cache timeout length (seconds)'),
+        'negative_cache_backend': _('Storage backend of the negative cache'),
         'filter_users': _('Users that SSSD should explicitly ignore'),
         'filter_groups': _('Groups that SSSD should explicitly ignore'),
         'filter_users_in_groups': _('Should filtered users appear in groups'),
@@ -72,6 +74,8 @@ class SSSDOptions(object):
         'shell_fallback': _('If a shell stored in central directory is allowed but not available, use this fallback'),
         'default_shell': _('Shell to use if the provider does not list one'),
         'memcache_timeout': _('How long will be in-memory cache records valid'),
+        'result_cache_size': _('Number of recent cache lookups kept in memory by the responder'),
+        'result_cache_timeout': _('How long in seconds a lookup is kept in the in-memory result cache'),
         'homedir_substring': _('The value of this option will be used in the expansion of the override_homedir option '
                                'if the template contains the format string %H.'),
         'get_domains_timeout': _('Specifies time in seconds for which the list of subdomains will be considered '
@@ -100,6 +104,8 @@ class SSSDOptions(object):
         'pam_p11_allowed_services': _('Allowed services for using smartcards'),
         'p11_wait_for_card_timeout': _('Additional timeout to wait for a card if requested'),
         'p11_uri': _('PKCS#11 URI to restrict the selection of devices for Smartcard authentication'),
+        'pam_token_cache_size': _('Maximum number of recently verified cached credentials kept in memory'),
+        'pam_token_cache_timeout': _('How many seconds a verification of cached credentials is reused'),
 
         # [sudo]
         'sudo_timed': _('Whether to evaluate the time-based attributes in sudo rules'),
@@ -187,6 +193,9 @@ class SSSDOptions(object):
         'dns_resolver_op_timeout': _('How long should keep trying to resolve single DNS query (seconds)'),
         'dns_resolver_timeout': _('How long to wait for replies from DNS when resolving servers (seconds)'),
         'dns_discovery_domain': _('The domain part of service discovery DNS query'),
+        'failover_server_selection': _('How to choose between working servers of the same priority'),
+        'dns_resolver_use_cache': _('Keep DNS answers in memory for the TTL of the records'),
+        'dns_resolver_cache_negative_timeout': _('How long to remember names that do not exist in DNS'),
         'override_gid': _('Override GID value from the identity provider with this value'),
         'case_sensitive': _('Treat usernames as case sensitive'),
         'entry_cache_user_timeout': _('Entry cache timeout length (seconds)'),
@@ -221,6 +230,7 @@ class SSSDOptions(object):
                                                            'should be saved this value determines the minimal length '
                                                            'the first authentication factor (long term password) must '
                                                            'have to be saved as SHA512 hash into the cache.'),
+        'cache_credentials_hash_rounds': _('Number of rounds of the SHA512 hash of cached passwords'),
 
         # [provider/ipa]
         'ipa_domain': _('IPA domain'),
@@ -297,6 +307,7 @@ class SSSDOptions(object):
         'ad_enable_gc': _('Whether to use the Global Catalog for lookups'),
         'ad_gpo_access_control': _('Operation mode for GPO-based access control'),
         'ad_gpo_cache_timeout': _("The amount of time between lookups of the GPO policy files against the AD server"),
+        'ad_gpo_decision_cache_timeout': _("The amount of time a GPO access decision is reused while the GPOs are unchanged"),
         'ad_gpo_map_interactive': _('PAM service names that map to the GPO (Deny)InteractiveLogonRight '
                                     'policy settings'),
         'ad_gpo_map_remote_interactive': _('PAM service names that map to the GPO (Deny)RemoteInteractiveLogonRight '
@@ -338,6 +349,8 @@ class SSSDOptions(object):
         'krb5_canonicalize': _("Enables principal canonicalization"),
         'krb5_use_enterprise_principal': _("Enables enterprise principals"),
         'krb5_map_user': _('A mapping from user names to Kerberos principal names'),
+        'krb5_child_pool_size': _('Number of long-lived krb5_child processes'),
+        'krb5_child_pool_max_requests': _('Number of requests served by a krb5_child process before it is replaced'),
 
         # [provider/krb5/chpass]
         'krb5_kpasswd': _('Server where the change password service is running if not on the KDC'),
@@ -354,6 +367,7 @@ class SSSDOptions(object):
         'ldap_default_authtok': _('The authentication token of the default bind DN'),
         'ldap_network_timeout': _('Length of time to attempt connection'),
         'ldap_opt_timeout': _('Length of time to attempt synchronous LDAP operations'),
+        'ldap_connection_pool_size': _('Number of connections used for ID lookups'),
         'ldap_offline_timeout': _('Length of time between attempts to reconnect while offline'),
         'ldap_force_upper_case_realm': _('Use only the upper case for realm names'),
         'ldap_tls_cacert': _('File that contains CA certificates'),
@@ -375,6 +389,8 @@ class SSSDOptions(object):
         'ldap_dns_service_name': _('Service name for DNS service lookups'),
         'ldap_page_size': _('The number of records to retrieve in a single LDAP query'),
         'ldap_deref_threshold': _('The number of members that must be missing to trigger a full deref'),
+        'ldap_group_nesting_concurrency': _('Maximum number of group member lookups in flight at once'),
+        'ldap_group_nesting_batch_size': _('Maximum number of group members looked up by a single search'),
         'ldap_sasl_canonicalize': _('Whether the LDAP library should perform a reverse lookup to canonicalize the '
                                     'host name during a SASL bind'),
         'ldap_rfc2307_fallback_to_local_users': _('Allows to retain local users as members of an LDAP group for '
@@ -393,6 +409,7 @@ class SSSDOptions(object):
         'ldap_search_timeout': _('Length of time to wait for a search request'),
         'ldap_enumeration_search_timeout': _('Length of time to wait for a enumeration request'),
         'ldap_enumeration_refresh_timeout': _('Length of time between enumeration updates'),
+        'ldap_enumeration_syncrepl': _('Keep the enumerated cache up to date using LDAP content synchronization'),
         'ldap_purge_cache_timeout': _('Length of time between cache cleanups'),
         'ldap_id_use_start_tls': _('Require TLS for ID lookups'),
         'ldap_id_mapping': _('Use ID-mapping of objectSID instead of pre-set IDs'),
@@ -592,6 +592,7 @@ class SSSDConfigTestSSSDDomain(unittest.TestCase):
             'enumerate',
             'cache_credentials',
             'cache_credentials_minimal_first_factor_length',
+            'cache_credentials_hash_rounds',
             'use_fully_qualified_names',
             'ignore_group_members',
             'filter_users',
@@ -612,6 +613,9 @@ class SSSDConfigTestSSSDDomain(unittest.TestCase):
             'dns_resolver_op_timeout',
             'dns_resolver_timeout',
             'dns_discovery_domain',
+            'failover_server_selection',
+            'dns_resolver_use_cache',
+            'dns_resolver_cache_negative_timeout',
             'dyndns_update',
             'dyndns_ttl',
             'dyndns_iface',
@@ -731,7 +735,9 @@ class SSSDConfigTestSSSDDomain(unittest.TestCase):
              'krb5_canonicalize',
              'krb5_use_enterprise_principal',
              'krb5_use_kdcinfo',
-             'krb5_map_user'])
+             'krb5_map_user',
+             'krb5_child_pool_size',
+             'krb5_child_pool_max_requests'])
 
         options = domain.list_options()
 
@@ -894,7 +900,9 @@ class SSSDConfigTestSSSDDomain(unittest.TestCase):
             'krb5_canonicalize',
             'krb5_use_enterprise_principal',
             'krb5_use_kdcinfo',
-            'krb5_map_user']
+            'krb5_map_user',
+            'krb5_child_pool_size',
+            'krb5_child_pool_max_requests']
 
         self.assertTrue(type(options) == dict,
                         "Options should be a dictionary")
@@ -967,6 +975,7 @@ class SSSDConfigTestSSSDDomain(unittest.TestCase):
             'enumerate',
             'cache_credentials',
             'cache_credentials_minimal_first_factor_length',
+            'cache_credentials_hash_rounds',
             'use_fully_qualified_names',
             'ignore_group_members',
             'filter_users',
@@ -987,6 +996,9 @@ class SSSDConfigTestSSSDDomain(unittest.TestCase):
             'dns_resolver_op_timeout',
             'dns_resolver_timeout',
             'dns_discovery_domain',
+            'failover_server_selection',
+            'dns_resolver_use_cache',
+            'dns_resolver_cache_negative_timeout',
             'dyndns_update',
             'dyndns_ttl',
             'dyndns_iface',
@@ -1107,7 +1119,9 @@ class SSSDConfigTestSSSDDomain(unittest.TestCase):
              'krb5_canonicalize',
              'krb5_use_enterprise_principal',
              'krb5_use_kdcinfo',
-             'krb5_map_user'])
+             'krb5_map_user',
+             'krb5_child_pool_size',
+             'krb5_child_pool_max_requests'])
 
         options = domain.list_options()
 
@@ -2052,6 +2052,60 @@ static bool sysdb_ldb_msg_difference(struct ldb_dn *entry_dn,
     return false;
 }
 
+static bool sysdb_entry_attrs_tracked(struct sysdb_ctx *sysdb,
+                                      struct ldb_dn *entry_dn)
+{
+    if (sysdb->ldb_ts == NULL) {
+        DEBUG(SSSDBG_TRACE_FUNC,
+              "Entry [%s] differs, reason: there is no ts_cache yet.\n",
+              ldb_dn_get_linearized(entry_dn));
+        return false;
+    }
+
+    if (is_ts_ldb_dn(entry_dn) == false) {
+        DEBUG(SSSDBG_TRACE_FUNC,
+              "Entry [%s] differs, reason: ts_cache doesn't trace this type of entry.\n",
+              ldb_dn_get_linearized(entry_dn));
+        return false;
+    }
+
+    return true;
+}
+
+bool sysdb_entry_msg_attrs_diff(struct sysdb_ctx *sysdb,
+                                struct ldb_dn *entry_dn,
+                                struct ldb_message *db_msg,
+                                struct sysdb_attrs *attrs,
+                                int mod_op)
+{
+    struct ldb_message *new_entry_msg;
+    TALLOC_CTX *tmp_ctx;
+    bool differs = true;
+
+    if (sysdb_entry_attrs_tracked(sysdb, entry_dn) == false) {
+        return true;
+    }
+
+    if (db_msg == NULL || ldb_dn_compare(db_msg->dn, entry_dn) != 0) {
+        return true;
+    }
+
+    tmp_ctx = talloc_new(NULL);
+    if (tmp_ctx == NULL) {
+        return true;
+    }
+
+    new_entry_msg = sysdb_attrs2msg(tmp_ctx, entry_dn, attrs, mod_op);
+    if (new_entry_msg == NULL) {
+        goto done;
+    }
+
+    differs = sysdb_ldb_msg_difference(entry_dn, db_msg, new_entry_msg);
+done:
+    talloc_free(tmp_ctx);
+    return differs;
+}
+
 bool sysdb_entry_attrs_diff(struct sysdb_ctx *sysdb,
                             struct ldb_dn *entry_dn,
                             struct sysdb_attrs *attrs,
@@ -2065,17 +2119,7 @@ bool sysdb_entry_attrs_diff(struct sysdb_ctx *sysdb,
     struct ldb_result *res;
     const char *attrnames[attrs->num+1];
 
-    if (sysdb->ldb_ts == NULL) {
-        DEBUG(SSSDBG_TRACE_FUNC,
-              "Entry [%s] differs, reason: there is no ts_cache yet.\n",
-              ldb_dn_get_linearized(entry_dn));
-        return true;
-    }
-
-    if (is_ts_ldb_dn(entry_dn) == false) {
-        DEBUG(SSSDBG_TRACE_FUNC,
-              "Entry [%s] differs, reason: ts_cache doesn't trace this type of entry.\n",
-              ldb_dn_get_linearized(entry_dn));
+    if (sysdb_entry_attrs_tracked(sysdb, entry_dn) == false) {
         return true;
     }
 
@@ -794,6 +794,19 @@ int sysdb_enumpwent_filter_with_views(TALLOC_CTX *mem_ctx,
                                       const char *addtl_filter,
                                       struct ldb_result **res);
 
+/* Paged enumeration, sysdb_enumpwent_dns() returns only the DN and the
+ * name of each user, the full objects are then read in chunks with
+ * sysdb_enumpwent_by_dns_with_views(). */
+int sysdb_enumpwent_dns(TALLOC_CTX *mem_ctx,
+                        struct sss_domain_info *domain,
+                        struct ldb_result **res);
+
+int sysdb_enumpwent_by_dns_with_views(TALLOC_CTX *mem_ctx,
+                                      struct sss_domain_info *domain,
+                                      struct ldb_message **msgs,
+                                      size_t count,
+                                      struct ldb_result **res);
+
 int sysdb_getgrnam(TALLOC_CTX *mem_ctx,
                    struct sss_domain_info *domain,
                    const char *name,
@@ -830,6 +843,17 @@ int sysdb_enumgrent_filter_with_views(TALLOC_CTX *mem_ctx,
                                       const char *addtl_filter,
                                       struct ldb_result **res);
 
+/* Paged enumeration of groups, see sysdb_enumpwent_dns(). */
+int sysdb_enumgrent_dns(TALLOC_CTX *mem_ctx,
+                        struct sss_domain_info *domain,
+                        struct ldb_result **res);
+
+int sysdb_enumgrent_by_dns_with_views(TALLOC_CTX *mem_ctx,
+                                      struct sss_domain_info *domain,
+                                      struct ldb_message **msgs,
+                                      size_t count,
+                                      struct ldb_result **res);
+
 struct sysdb_netgroup_ctx {
     enum {SYSDB_NETGROUP_TRIPLE_VAL, SYSDB_NETGROUP_GROUP_VAL} type;
     union {
@@ -1115,6 +1139,52 @@ int sysdb_store_group(struct sss_domain_info *domain,
                       uint64_t cache_timeout,
                       time_t now);
 
+/* One user as passed to sysdb_store_users_bulk(), the members have the same
+ * meaning as the parameters of sysdb_store_user(). */
+struct sysdb_store_user_data {
+    const char *name;
+    const char *pwd;
+    uid_t uid;
+    gid_t gid;
+    const char *gecos;
+    const char *homedir;
+    const char *shell;
+    const char *orig_dn;
+    struct sysdb_attrs *attrs;
+    char **remove_attrs;
+};
+
+/* One group as passed to sysdb_store_groups_bulk(), the members have the
+ * same meaning as the parameters of sysdb_store_group(). remove_attrs is a
+ * talloc array of attributes to drop from an existing entry, as for
+ * sysdb_store_user(). */
+struct sysdb_store_group_data {
+    const char *name;
+    gid_t gid;
+    struct sysdb_attrs *attrs;
+    char **remove_attrs;
+};
+
+/* Store many users in one transaction. The existing entries are read with
+ * a single search and compared in memory, only entries that changed are
+ * written to the cache, the others just get their timestamps refreshed.
+ * A failure to store one user is logged and does not stop the others;
+ * the number of such failures is returned in _failed if not NULL. */
+int sysdb_store_users_bulk(struct sss_domain_info *domain,
+                           struct sysdb_store_user_data *users,
+                           size_t count,
+                           uint64_t cache_timeout,
+                           time_t now,
+                           size_t *_failed);
+
+/* Group counterpart of sysdb_store_users_bulk(). */
+int sysdb_store_groups_bulk(struct sss_domain_info *domain,
+                            struct sysdb_store_group_data *groups,
+                            size_t count,
+                            uint64_t cache_timeout,
+                            time_t now,
+                            size_t *_failed);
+
 int sysdb_add_group_member(struct sss_domain_info *domain,
                            const char *group,
                            const char *member,
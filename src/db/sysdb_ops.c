@@ -1360,17 +1360,18 @@ static const char *get_attr_storage(int state_mask)
     return storage;
 }
 
-int sysdb_set_entry_attr(struct sysdb_ctx *sysdb,
-                         struct ldb_dn *entry_dn,
-                         struct sysdb_attrs *attrs,
-                         int mod_op)
+/* Write attrs to the timestamp cache and, if sysdb_write is true, also to
+ * the sysdb cache. */
+static int sysdb_set_entry_attr_ext(struct sysdb_ctx *sysdb,
+                                    struct ldb_dn *entry_dn,
+                                    struct sysdb_attrs *attrs,
+                                    int mod_op,
+                                    bool sysdb_write)
 {
-    bool sysdb_write = true;
     errno_t ret = EOK;
     errno_t tret = EOK;
     int state_mask = SSS_SYSDB_NO_CACHE;
 
-    sysdb_write = sysdb_entry_attrs_diff(sysdb, entry_dn, attrs, mod_op);
     if (sysdb_write == true) {
         ret = sysdb_set_cache_entry_attr(sysdb->ldb, entry_dn, attrs, mod_op);
         if (ret != EOK) {
@@ -1403,6 +1404,19 @@ int sysdb_set_entry_attr(struct sysdb_ctx *sysdb,
     return ret;
 }
 
+int sysdb_set_entry_attr(struct sysdb_ctx *sysdb,
+                         struct ldb_dn *entry_dn,
+                         struct sysdb_attrs *attrs,
+                         int mod_op)
+{
+    bool sysdb_write;
+
+    sysdb_write = sysdb_entry_attrs_diff(sysdb, entry_dn, attrs, mod_op);
+
+    return sysdb_set_entry_attr_ext(sysdb, entry_dn, attrs, mod_op,
+                                    sysdb_write);
+}
+
 static int sysdb_rep_ts_entry_attr(struct sysdb_ctx *sysdb,
                                    struct ldb_dn *entry_dn,
                                    struct sysdb_attrs *attrs)
@@ -2702,7 +2716,8 @@ static errno_t sysdb_store_new_user(struct sss_domain_info *domain,
                                     const char *orig_dn,
                                     struct sysdb_attrs *attrs,
                                     uint64_t cache_timeout,
-                                    time_t now);
+                                    time_t now,
+                                    bool *_renamed);
 
 
 static errno_t sysdb_store_user_attrs(struct sss_domain_info *domain,
@@ -2782,7 +2797,8 @@ int sysdb_store_user(struct sss_domain_info *domain,
     if (ret == ENOENT) {
         /* the user doesn't exist, turn into adding a user */
         ret = sysdb_store_new_user(domain, name, uid, gid, gecos, homedir,
-                                   shell, orig_dn, attrs, cache_timeout, now);
+                                   shell, orig_dn, attrs, cache_timeout, now,
+                                   NULL);
     } else {
         /* the user exists, let's just replace attributes when set */
         ret = sysdb_store_user_attrs(domain, name, uid, gid, gecos, homedir,
@@ -2829,7 +2845,8 @@ static errno_t sysdb_store_new_user(struct sss_domain_info *domain,
                                     const char *orig_dn,
                                     struct sysdb_attrs *attrs,
                                     uint64_t cache_timeout,
-                                    time_t now)
+                                    time_t now,
+                                    bool *_renamed)
 {
     errno_t ret;
 
@@ -2860,23 +2877,24 @@ static errno_t sysdb_store_new_user(struct sss_domain_info *domain,
                     "%s [%"SPRIgid"].\n", name, gid);
             return ret;
         }
+
+        if (_renamed != NULL) {
+            *_renamed = true;
+        }
     }
 
     return EOK;
 }
 
-static errno_t sysdb_store_user_attrs(struct sss_domain_info *domain,
-                                      const char *name,
-                                      uid_t uid,
-                                      gid_t gid,
-                                      const char *gecos,
-                                      const char *homedir,
-                                      const char *shell,
-                                      const char *orig_dn,
-                                      struct sysdb_attrs *attrs,
-                                      char **remove_attrs,
-                                      uint64_t cache_timeout,
-                                      time_t now)
+static errno_t sysdb_store_user_basic_attrs(struct sss_domain_info *domain,
+                                            uid_t uid,
+                                            gid_t gid,
+                                            const char *gecos,
+                                            const char *homedir,
+                                            const char *shell,
+                                            struct sysdb_attrs *attrs,
+                                            uint64_t cache_timeout,
+                                            time_t now)
 {
     errno_t ret;
 
@@ -2918,6 +2936,28 @@ static errno_t sysdb_store_user_attrs(struct sss_domain_info *domain,
                                   (now + cache_timeout) : 0));
     if (ret) return ret;
 
+    return EOK;
+}
+
+static errno_t sysdb_store_user_attrs(struct sss_domain_info *domain,
+                                      const char *name,
+                                      uid_t uid,
+                                      gid_t gid,
+                                      const char *gecos,
+                                      const char *homedir,
+                                      const char *shell,
+                                      const char *orig_dn,
+                                      struct sysdb_attrs *attrs,
+                                      char **remove_attrs,
+                                      uint64_t cache_timeout,
+                                      time_t now)
+{
+    errno_t ret;
+
+    ret = sysdb_store_user_basic_attrs(domain, uid, gid, gecos, homedir,
+                                       shell, attrs, cache_timeout, now);
+    if (ret) return ret;
+
     ret = sysdb_set_user_attr(domain, name, attrs, SYSDB_MOD_REP);
     if (ret) return ret;
 
@@ -3096,16 +3136,13 @@ static errno_t sysdb_store_new_group(struct sss_domain_info *domain,
     return EOK;
 }
 
-static errno_t sysdb_store_group_attrs(struct sss_domain_info *domain,
-                                       const char *name,
-                                       gid_t gid,
-                                       struct sysdb_attrs *attrs,
-                                       uint64_t cache_timeout,
-                                       time_t now)
+static errno_t sysdb_store_group_basic_attrs(gid_t gid,
+                                             struct sysdb_attrs *attrs,
+                                             uint64_t cache_timeout,
+                                             time_t now)
 {
     errno_t ret;
 
-    /* the group exists, let's just replace attributes when set */
     if (gid) {
         ret = sysdb_attrs_add_uint32(attrs, SYSDB_GIDNUM, gid);
         if (ret) {
@@ -3128,6 +3165,24 @@ static errno_t sysdb_store_group_attrs(struct sss_domain_info *domain,
         return ret;
     }
 
+    return EOK;
+}
+
+static errno_t sysdb_store_group_attrs(struct sss_domain_info *domain,
+                                       const char *name,
+                                       gid_t gid,
+                                       struct sysdb_attrs *attrs,
+                                       uint64_t cache_timeout,
+                                       time_t now)
+{
+    errno_t ret;
+
+    /* the group exists, let's just replace attributes when set */
+    ret = sysdb_store_group_basic_attrs(gid, attrs, cache_timeout, now);
+    if (ret) {
+        return ret;
+    }
+
     ret = sysdb_set_group_attr(domain, name, attrs, SYSDB_MOD_REP);
     if (ret) {
         DEBUG(SSSDBG_TRACE_LIBS, "sysdb_set_group_attr failed.\n");
@@ -3137,6 +3192,723 @@ static errno_t sysdb_store_group_attrs(struct sss_domain_info *domain,
     return EOK;
 }
 
+/* =Store-Many-Users-And-Groups=========================================== */
+
+/* Above this many objects the whole container is read instead of building
+ * a filter with all the names, a typical case is a full enumeration. */
+#define SYSDB_BULK_FILTER_MAX 100
+
+/* Value of an entry in the prefetch table that is known to exist but whose
+ * copy is not current, it has to be read from the cache again. */
+#define SYSDB_BULK_REREAD ((void *) -1)
+
+static errno_t sysdb_bulk_table_add(hash_table_t *table,
+                                    const char *key,
+                                    void *value)
+{
+    hash_key_t hkey;
+    hash_value_t hvalue;
+    int hret;
+
+    hkey.type = HASH_KEY_STRING;
+    hkey.str = discard_const(key);
+    hvalue.type = HASH_VALUE_PTR;
+    hvalue.ptr = value;
+
+    hret = hash_enter(table, &hkey, &hvalue);
+    if (hret != HASH_SUCCESS) {
+        DEBUG(SSSDBG_OP_FAILURE, "hash_enter failed [%d]: %s\n",
+              hret, hash_error_string(hret));
+        return EIO;
+    }
+
+    return EOK;
+}
+
+/* Read all existing objects with the given names with a single search and
+ * return them in a table indexed by name and alias. */
+static errno_t sysdb_bulk_prefetch(TALLOC_CTX *mem_ctx,
+                                   struct sss_domain_info *domain,
+                                   enum sysdb_obj_type type,
+                                   const char **names,
+                                   size_t count,
+                                   hash_table_t **_table)
+{
+    TALLOC_CTX *tmp_ctx;
+    hash_table_t *table;
+    struct ldb_dn *basedn;
+    struct ldb_message **msgs = NULL;
+    struct ldb_message_element *el;
+    size_t msgs_count = 0;
+    const char *class_filter;
+    const char *name;
+    char *sanitized_name;
+    char *lc_sanitized_name;
+    char *filter;
+    errno_t ret;
+
+    tmp_ctx = talloc_new(NULL);
+    if (tmp_ctx == NULL) {
+        return ENOMEM;
+    }
+
+    /* Same base and object classes as sysdb_search_by_name() */
+    switch (type) {
+    case SYSDB_USER:
+        class_filter = SYSDB_UC;
+        basedn = sysdb_user_base_dn(tmp_ctx, domain);
+        break;
+    case SYSDB_GROUP:
+        if (sss_domain_is_mpg(domain) &&
+                (!local_provider_is_built()
+                 || strcasecmp(domain->provider, "local") != 0)) {
+            class_filter = SYSDB_MPGC;
+            basedn = sysdb_domain_dn(tmp_ctx, domain);
+        } else {
+            class_filter = SYSDB_GC;
+            basedn = sysdb_group_base_dn(tmp_ctx, domain);
+        }
+        break;
+    default:
+        ret = EINVAL;
+        goto done;
+    }
+
+    if (basedn == NULL) {
+        ret = ENOMEM;
+        goto done;
+    }
+
+    ret = sss_hash_create(tmp_ctx, count, &table);
+    if (ret != EOK) {
+        goto done;
+    }
+
+    if (count == 0) {
+        goto steal;
+    }
+
+    if (count > SYSDB_BULK_FILTER_MAX) {
+        filter = talloc_asprintf(tmp_ctx, "(%s)", class_filter);
+    } else {
+        filter = talloc_asprintf(tmp_ctx, "(&(%s)(|", class_filter);
+        for (size_t i = 0; filter != NULL && i < count; i++) {
+            ret = sss_filter_sanitize_for_dom(tmp_ctx, names[i], domain,
+                                              &sanitized_name,
+                                              &lc_sanitized_name);
+            if (ret != EOK) {
+                goto done;
+            }
+
+            filter = talloc_asprintf_append_buffer(filter,
+                                            "(%s=%s)(%s=%s)(%s=%s)",
+                                            SYSDB_NAME_ALIAS, lc_sanitized_name,
+                                            SYSDB_NAME_ALIAS, sanitized_name,
+                                            SYSDB_NAME, sanitized_name);
+        }
+        if (filter != NULL) {
+            filter = talloc_asprintf_append_buffer(filter, "))");
+        }
+    }
+    if (filter == NULL) {
+        ret = ENOMEM;
+        goto done;
+    }
+
+    /* Use SUBTREE scope here, not ONELEVEL, see sysdb_search_user_by_uid() */
+    ret = sysdb_cache_search_entry(tmp_ctx, domain->sysdb->ldb, basedn,
+                                   LDB_SCOPE_SUBTREE, filter, NULL,
+                                   &msgs_count, &msgs);
+    if (ret == ENOENT) {
+        msgs_count = 0;
+    } else if (ret != EOK) {
+        DEBUG(SSSDBG_OP_FAILURE, "Cannot prefetch cached objects [%d]: %s\n",
+              ret, sss_strerror(ret));
+        goto done;
+    }
+
+    DEBUG(SSSDBG_TRACE_FUNC, "Prefetched %zu of %zu objects\n",
+          msgs_count, count);
+
+    for (size_t i = 0; i < msgs_count; i++) {
+        name = ldb_msg_find_attr_as_string(msgs[i], SYSDB_NAME, NULL);
+        if (name == NULL) {
+            continue;
+        }
+
+        ret = sysdb_bulk_table_add(table, name, msgs[i]);
+        if (ret != EOK) {
+            goto done;
+        }
+
+        el = ldb_msg_find_element(msgs[i], SYSDB_NAME_ALIAS);
+        for (size_t j = 0; el != NULL && j < el->num_values; j++) {
+            ret = sysdb_bulk_table_add(table,
+                                       (const char *) el->values[j].data,
+                                       msgs[i]);
+            if (ret != EOK) {
+                goto done;
+            }
+        }
+    }
+
+steal:
+    talloc_steal(table, msgs);
+    *_table = talloc_steal(mem_ctx, table);
+    ret = EOK;
+
+done:
+    talloc_free(tmp_ctx);
+    return ret;
+}
+
+/* Returns true if an object with this name exists. _msg is set to its
+ * cached copy or to NULL if it has to be read again. */
+static bool sysdb_bulk_lookup(hash_table_t *table,
+                              struct sss_domain_info *domain,
+                              const char *name,
+                              struct ldb_message **_msg)
+{
+    TALLOC_CTX *tmp_ctx = NULL;
+    hash_key_t key;
+    hash_value_t value;
+    int hret;
+
+    key.type = HASH_KEY_STRING;
+    key.str = discard_const(name);
+
+    hret = hash_lookup(table, &key, &value);
+    if (hret == HASH_ERROR_KEY_NOT_FOUND && !domain->case_sensitive) {
+        tmp_ctx = talloc_new(NULL);
+        if (tmp_ctx == NULL) {
+            return false;
+        }
+
+        key.str = sss_tc_utf8_str_tolower(tmp_ctx, name);
+        if (key.str != NULL) {
+            hret = hash_lookup(table, &key, &value);
+        }
+    }
+    talloc_free(tmp_ctx);
+
+    if (hret != HASH_SUCCESS) {
+        return false;
+    }
+
+    *_msg = value.ptr == SYSDB_BULK_REREAD ? NULL : value.ptr;
+    return true;
+}
+
+/* Write attrs of an existing entry, comparing them to db_msg if available
+ * instead of reading the entry again. */
+static errno_t sysdb_bulk_set_attrs(struct sysdb_ctx *sysdb,
+                                    struct ldb_dn *entry_dn,
+                                    struct ldb_message *db_msg,
+                                    struct sysdb_attrs *attrs,
+                                    bool *_written)
+{
+    bool sysdb_write;
+    errno_t ret;
+
+    if (db_msg != NULL) {
+        sysdb_write = sysdb_entry_msg_attrs_diff(sysdb, entry_dn, db_msg,
+                                                 attrs, SYSDB_MOD_REP);
+    } else {
+        sysdb_write = sysdb_entry_attrs_diff(sysdb, entry_dn, attrs,
+                                             SYSDB_MOD_REP);
+    }
+
+    ret = sysdb_set_entry_attr_ext(sysdb, entry_dn, attrs, SYSDB_MOD_REP,
+                                   sysdb_write);
+    if (ret == EOK) {
+        *_written = sysdb_write;
+    }
+
+    return ret;
+}
+
+/* Only keep the attributes that are present in db_msg. */
+static char **sysdb_bulk_remove_attrs(TALLOC_CTX *mem_ctx,
+                                      struct ldb_message *db_msg,
+                                      char **remove_attrs)
+{
+    char **present;
+    size_t n = 0;
+
+    if (db_msg == NULL) {
+        return remove_attrs;
+    }
+
+    present = talloc_zero_array(mem_ctx, char *,
+                                talloc_array_length(remove_attrs) + 1);
+    if (present == NULL) {
+        return remove_attrs;
+    }
+
+    for (size_t i = 0; remove_attrs[i] != NULL; i++) {
+        if (ldb_msg_find_element(db_msg, remove_attrs[i]) != NULL) {
+            present[n] = remove_attrs[i];
+            n++;
+        }
+    }
+
+    return present;
+}
+
+static errno_t sysdb_bulk_store_user(struct sss_domain_info *domain,
+                                     hash_table_t *table,
+                                     struct sysdb_store_user_data *user,
+                                     bool stale,
+                                     uint64_t cache_timeout,
+                                     time_t now,
+                                     bool *_renamed)
+{
+    TALLOC_CTX *tmp_ctx;
+    struct sysdb_attrs *attrs;
+    struct ldb_message *db_msg = NULL;
+    struct ldb_dn *dn;
+    char **remove_attrs;
+    bool written = false;
+    errno_t ret;
+
+    tmp_ctx = talloc_new(NULL);
+    if (tmp_ctx == NULL) {
+        return ENOMEM;
+    }
+
+    attrs = user->attrs;
+    if (attrs == NULL) {
+        attrs = sysdb_new_attrs(tmp_ctx);
+        if (attrs == NULL) {
+            ret = ENOMEM;
+            goto done;
+        }
+    }
+
+    if (user->pwd && !*user->pwd) {
+        ret = sysdb_attrs_add_string(attrs, SYSDB_PWD, user->pwd);
+        if (ret) goto done;
+    }
+
+    if (!sysdb_bulk_lookup(table, domain, user->name, &db_msg)) {
+        DEBUG(SSSDBG_TRACE_LIBS, "User %s does not exist.\n", user->name);
+        goto add;
+    }
+
+    if (stale) {
+        db_msg = NULL;
+    }
+
+    ret = sysdb_store_user_basic_attrs(domain, user->uid, user->gid,
+                                       user->gecos, user->homedir,
+                                       user->shell, attrs,
+                                       cache_timeout, now);
+    if (ret != EOK) {
+        goto done;
+    }
+
+    dn = sysdb_user_dn(tmp_ctx, domain, user->name);
+    if (dn == NULL) {
+        ret = ENOMEM;
+        goto done;
+    }
+
+    ret = sysdb_bulk_set_attrs(domain->sysdb, dn, db_msg, attrs, &written);
+    if (ret == ENOENT) {
+        /* Removed by an earlier rename in this batch */
+        DEBUG(SSSDBG_TRACE_LIBS, "User %s is gone, adding it.\n", user->name);
+        goto add;
+    } else if (ret != EOK) {
+        goto done;
+    }
+
+    if (user->remove_attrs != NULL) {
+        remove_attrs = sysdb_bulk_remove_attrs(tmp_ctx, db_msg,
+                                               user->remove_attrs);
+        if (remove_attrs[0] != NULL) {
+            ret = sysdb_remove_attrs(domain, user->name, SYSDB_MEMBER_USER,
+                                     remove_attrs);
+            if (ret != EOK) {
+                DEBUG(SSSDBG_CONF_SETTINGS,
+                      "Could not remove missing attributes\n");
+            }
+        }
+    }
+
+    DEBUG(SSSDBG_TRACE_LIBS, "User %s was %s\n", user->name,
+          written ? "updated" : "not changed");
+    ret = EOK;
+    goto done;
+
+add:
+    ret = sysdb_store_new_user(domain, user->name, user->uid, user->gid,
+                               user->gecos, user->homedir, user->shell,
+                               user->orig_dn, attrs, cache_timeout, now,
+                               _renamed);
+    if (ret == EOK) {
+        /* A later duplicate must see this entry as existing */
+        ret = sysdb_bulk_table_add(table, user->name, SYSDB_BULK_REREAD);
+    }
+
+done:
+    talloc_free(tmp_ctx);
+    return ret;
+}
+
+int sysdb_store_users_bulk(struct sss_domain_info *domain,
+                           struct sysdb_store_user_data *users,
+                           size_t count,
+                           uint64_t cache_timeout,
+                           time_t now,
+                           size_t *_failed)
+{
+    TALLOC_CTX *tmp_ctx;
+    hash_table_t *table;
+    const char **names;
+    size_t failed = 0;
+    bool stale = false;
+    errno_t ret;
+    errno_t sret;
+    bool in_transaction = false;
+
+    if (now == 0) {
+        now = time(NULL);
+    }
+
+    tmp_ctx = talloc_new(NULL);
+    if (tmp_ctx == NULL) {
+        return ENOMEM;
+    }
+
+    names = talloc_array(tmp_ctx, const char *, count);
+    if (names == NULL) {
+        ret = ENOMEM;
+        goto done;
+    }
+
+    for (size_t i = 0; i < count; i++) {
+        names[i] = users[i].name;
+    }
+
+    ret = sysdb_transaction_start(domain->sysdb);
+    if (ret != EOK) {
+        DEBUG(SSSDBG_CRIT_FAILURE, "Failed to start transaction\n");
+        goto done;
+    }
+    in_transaction = true;
+
+    ret = sysdb_bulk_prefetch(tmp_ctx, domain, SYSDB_USER, names, count,
+                              &table);
+    if (ret != EOK) {
+        goto done;
+    }
+
+    for (size_t i = 0; i < count; i++) {
+        /* Adding a user may remove another one with the same UID, which
+         * might be later in the batch with a prefetched copy that no
+         * longer exists. Once that happened the copies are not used. */
+        ret = sysdb_bulk_store_user(domain, table, &users[i], stale,
+                                    cache_timeout, now, &stale);
+        if (ret == ENOMEM) {
+            goto done;
+        } else if (ret != EOK) {
+            DEBUG(SSSDBG_OP_FAILURE, "Failed to store user %s [%d]: %s\n",
+                  users[i].name, ret, sss_strerror(ret));
+            failed++;
+        }
+    }
+
+    ret = sysdb_transaction_commit(domain->sysdb);
+    if (ret != EOK) {
+        DEBUG(SSSDBG_CRIT_FAILURE, "Failed to commit transaction\n");
+        goto done;
+    }
+    in_transaction = false;
+
+    DEBUG(SSSDBG_TRACE_FUNC, "Stored %zu users, %zu failed\n",
+          count - failed, failed);
+
+    if (_failed != NULL) {
+        *_failed = failed;
+    }
+
+done:
+    if (in_transaction) {
+        sret = sysdb_transaction_cancel(domain->sysdb);
+        if (sret != EOK) {
+            DEBUG(SSSDBG_CRIT_FAILURE, "Could not cancel transaction\n");
+        }
+    }
+    talloc_free(tmp_ctx);
+    return ret;
+}
+
+static errno_t sysdb_bulk_store_group(struct sss_domain_info *domain,
+                                      hash_table_t *table,
+                                      struct sysdb_store_group_data *group,
+                                      bool stale,
+                                      uint64_t cache_timeout,
+                                      time_t now,
+                                      bool *_written)
+{
+    TALLOC_CTX *tmp_ctx;
+    struct sysdb_attrs *attrs;
+    struct ldb_message *db_msg = NULL;
+    struct ldb_dn *dn;
+    char **remove_attrs;
+    errno_t ret;
+
+    tmp_ctx = talloc_new(NULL);
+    if (tmp_ctx == NULL) {
+        return ENOMEM;
+    }
+
+    attrs = group->attrs;
+    if (attrs == NULL) {
+        attrs = sysdb_new_attrs(tmp_ctx);
+        if (attrs == NULL) {
+            ret = ENOMEM;
+            goto done;
+        }
+    }
+
+    if (!sysdb_bulk_lookup(table, domain, group->name, &db_msg)) {
+        DEBUG(SSSDBG_TRACE_LIBS, "Group %s does not exist.\n", group->name);
+        goto add;
+    }
+
+    if (stale) {
+        db_msg = NULL;
+    }
+
+    ret = sysdb_store_group_basic_attrs(group->gid, attrs,
+                                        cache_timeout, now);
+    if (ret != EOK) {
+        goto done;
+    }
+
+    dn = sysdb_group_dn(tmp_ctx, domain, group->name);
+    if (dn == NULL) {
+        ret = ENOMEM;
+        goto done;
+    }
+
+    ret = sysdb_bulk_set_attrs(domain->sysdb, dn, db_msg, attrs, _written);
+    if (ret == ENOENT) {
+        /* Removed by an earlier rename in this batch */
+        DEBUG(SSSDBG_TRACE_LIBS, "Group %s is gone, adding it.\n",
+              group->name);
+        goto add;
+    } else if (ret != EOK) {
+        goto done;
+    }
+
+    if (group->remove_attrs != NULL) {
+        remove_attrs = sysdb_bulk_remove_attrs(tmp_ctx, db_msg,
+                                               group->remove_attrs);
+        if (remove_attrs[0] != NULL) {
+            ret = sysdb_remove_attrs(domain, group->name, SYSDB_MEMBER_GROUP,
+                                     remove_attrs);
+            if (ret != EOK) {
+                DEBUG(SSSDBG_CONF_SETTINGS,
+                      "Could not remove missing attributes\n");
+            } else {
+                *_written = true;
+            }
+        }
+    }
+
+    DEBUG(SSSDBG_TRACE_LIBS, "Group %s was %s\n", group->name,
+          *_written ? "updated" : "not changed");
+    ret = EOK;
+    goto done;
+
+add:
+    ret = sysdb_store_new_group(domain, group->name, group->gid, attrs,
+                                cache_timeout, now);
+    if (ret == EOK) {
+        *_written = true;
+        ret = sysdb_bulk_table_add(table, group->name, SYSDB_BULK_REREAD);
+    }
+
+done:
+    talloc_free(tmp_ctx);
+    return ret;
+}
+
+/* Returns EOK if the group exists and its modifyTimestamp equals the one of
+ * the prefetched copy, only its timestamp cache entry is refreshed then.
+ * ERR_TS_CACHE_MISS means the group has to be stored. */
+static errno_t sysdb_bulk_update_ts_grp(struct sss_domain_info *domain,
+                                        hash_table_t *table,
+                                        struct sysdb_store_group_data *group,
+                                        uint64_t cache_timeout,
+                                        time_t now)
+{
+    TALLOC_CTX *tmp_ctx;
+    struct ldb_message *db_msg = NULL;
+    struct ldb_dn *dn;
+    errno_t ret;
+
+    if (domain->sysdb->ldb_ts == NULL) {
+        return ERR_TS_CACHE_MISS;
+    }
+
+    if (!sysdb_bulk_lookup(table, domain, group->name, &db_msg)
+            || db_msg == NULL) {
+        return ERR_TS_CACHE_MISS;
+    }
+
+    tmp_ctx = talloc_new(NULL);
+    if (tmp_ctx == NULL) {
+        return ENOMEM;
+    }
+
+    dn = sysdb_group_dn(tmp_ctx, domain, group->name);
+    if (dn == NULL) {
+        ret = ENOMEM;
+        goto done;
+    }
+
+    /* In MPG domains the prefetched object may be a user */
+    if (ldb_dn_compare(db_msg->dn, dn) != 0
+            || sysdb_msg_attrs_modts_differs(db_msg, group->attrs)) {
+        ret = ERR_TS_CACHE_MISS;
+        goto done;
+    }
+
+    ret = sysdb_update_ts_cache(domain, dn, group->attrs, NULL,
+                                SYSDB_MOD_REP, cache_timeout, now);
+    if (ret != EOK) {
+        DEBUG(SSSDBG_OP_FAILURE,
+              "Cannot update the timestamps cache [%d]: %s\n",
+              ret, sss_strerror(ret));
+        ret = ERR_TS_CACHE_MISS;
+        goto done;
+    }
+
+    ret = EOK;
+
+done:
+    talloc_free(tmp_ctx);
+    return ret;
+}
+
+int sysdb_store_groups_bulk(struct sss_domain_info *domain,
+                            struct sysdb_store_group_data *groups,
+                            size_t count,
+                            uint64_t cache_timeout,
+                            time_t now,
+                            size_t *_failed)
+{
+    TALLOC_CTX *tmp_ctx;
+    hash_table_t *table;
+    struct sysdb_store_group_data **pending;
+    const char **names;
+    size_t num_pending = 0;
+    size_t failed = 0;
+    bool written = false;
+    bool stale = false;
+    errno_t ret;
+    errno_t sret;
+    bool in_transaction = false;
+
+    if (now == 0) {
+        now = time(NULL);
+    }
+
+    tmp_ctx = talloc_new(NULL);
+    if (tmp_ctx == NULL) {
+        return ENOMEM;
+    }
+
+    pending = talloc_array(tmp_ctx, struct sysdb_store_group_data *, count);
+    names = talloc_array(tmp_ctx, const char *, count);
+    if (pending == NULL || names == NULL) {
+        ret = ENOMEM;
+        goto done;
+    }
+
+    ret = sysdb_transaction_start(domain->sysdb);
+    if (ret != EOK) {
+        DEBUG(SSSDBG_CRIT_FAILURE, "Failed to start transaction\n");
+        goto done;
+    }
+    in_transaction = true;
+
+    for (size_t i = 0; i < count; i++) {
+        names[i] = groups[i].name;
+    }
+
+    ret = sysdb_bulk_prefetch(tmp_ctx, domain, SYSDB_GROUP, names, count,
+                              &table);
+    if (ret != EOK) {
+        goto done;
+    }
+
+    /* Groups whose modifyTimestamp did not change only need the timestamp
+     * cache refreshed, the same shortcut sysdb_store_group() takes. The
+     * timestamp is compared to the prefetched copy instead of searching
+     * for each group. */
+    for (size_t i = 0; i < count; i++) {
+        ret = sysdb_bulk_update_ts_grp(domain, table, &groups[i],
+                                       cache_timeout, now);
+        if (ret == EOK) {
+            continue;
+        } else if (ret == ENOMEM) {
+            goto done;
+        }
+
+        pending[num_pending] = &groups[i];
+        num_pending++;
+    }
+
+    DEBUG(SSSDBG_TRACE_FUNC, "%zu of %zu groups did not change\n",
+          count - num_pending, count);
+
+    for (size_t i = 0; i < num_pending; i++) {
+        written = false;
+        ret = sysdb_bulk_store_group(domain, table, pending[i], stale,
+                                     cache_timeout, now, &written);
+        if (ret == ENOMEM) {
+            goto done;
+        } else if (ret != EOK) {
+            DEBUG(SSSDBG_OP_FAILURE, "Failed to store group %s [%d]: %s\n",
+                  pending[i]->name, ret, sss_strerror(ret));
+            failed++;
+        }
+
+        /* Once a group was written the memberof plugin may have changed
+         * the members and ghosts of other groups in the batch, their
+         * prefetched copies can no longer be used for the comparison. */
+        stale = stale || written;
+    }
+
+    ret = sysdb_transaction_commit(domain->sysdb);
+    if (ret != EOK) {
+        DEBUG(SSSDBG_CRIT_FAILURE, "Failed to commit transaction\n");
+        goto done;
+    }
+    in_transaction = false;
+
+    DEBUG(SSSDBG_TRACE_FUNC, "Stored %zu groups, %zu failed\n",
+          count - failed, failed);
+
+    if (_failed != NULL) {
+        *_failed = failed;
+    }
+
+done:
+    if (in_transaction) {
+        sret = sysdb_transaction_cancel(domain->sysdb);
+        if (sret != EOK) {
+            DEBUG(SSSDBG_CRIT_FAILURE, "Could not cancel transaction\n");
+        }
+    }
+    talloc_free(tmp_ctx);
+    return ret;
+}
+
 /* =Add-User-to-Group(Native/Legacy)====================================== */
 static int
 sysdb_group_membership_mod(struct sss_domain_info *domain,
@@ -3255,6 +4027,16 @@ int sysdb_cache_password_ex(struct sss_domain_info *domain,
         goto fail;
     }
 
+    /* The number of rounds is stored with the hash, changing it does not
+     * affect the passwords which are already cached. */
+    if (domain->cache_credentials_hash_rounds != 0) {
+        salt = talloc_asprintf(tmp_ctx, "$6$rounds=%"PRIu32"$%s",
+                               domain->cache_credentials_hash_rounds, salt);
+        if (salt == NULL) {
+            ERROR_OUT(ret, ENOMEM, fail);
+        }
+    }
+
     ret = s3crypt_sha512(tmp_ctx, password, salt, &hash);
     if (ret) {
         DEBUG(SSSDBG_CONF_SETTINGS, "Failed to create password hash.\n");
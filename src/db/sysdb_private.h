@@ -322,4 +322,15 @@ bool sysdb_entry_attrs_diff(struct sysdb_ctx *sysdb,
                             struct sysdb_attrs *attrs,
                             int mod_op);
 
+/* Same as sysdb_entry_attrs_diff(), but compares against db_msg, an already
+ * fetched copy of entry_dn, instead of reading the entry from the cache.
+ * db_msg must contain all attributes that are about to be set. A NULL
+ * db_msg is treated as a difference.
+ */
+bool sysdb_entry_msg_attrs_diff(struct sysdb_ctx *sysdb,
+                                struct ldb_dn *entry_dn,
+                                struct ldb_message *db_msg,
+                                struct sysdb_attrs *attrs,
+                                int mod_op);
+
 #endif /* __INT_SYS_DB_H__ */
@@ -924,6 +924,29 @@ int sysdb_enumpwent(TALLOC_CTX *mem_ctx,
     return sysdb_enumpwent_filter(mem_ctx, domain, NULL, 0, _res);
 }
 
+static errno_t sysdb_enumpwent_add_overrides(struct sss_domain_info *domain,
+                                             struct ldb_result *res)
+{
+    size_t c;
+    errno_t ret;
+
+    if (!DOM_HAS_VIEWS(domain)) {
+        return EOK;
+    }
+
+    for (c = 0; c < res->count; c++) {
+        ret = sysdb_add_overrides_to_object(domain, res->msgs[c], NULL, NULL);
+        /* enumeration assumes that the cache is up-to-date, hence we do not
+         * need to handle ENOENT separately. */
+        if (ret != EOK) {
+            DEBUG(SSSDBG_OP_FAILURE, "sysdb_add_overrides_to_object failed.\n");
+            return ret;
+        }
+    }
+
+    return EOK;
+}
+
 int sysdb_enumpwent_filter_with_views(TALLOC_CTX *mem_ctx,
                                       struct sss_domain_info *domain,
                                       const char *name_filter,
@@ -932,7 +955,6 @@ int sysdb_enumpwent_filter_with_views(TALLOC_CTX *mem_ctx,
 {
     TALLOC_CTX *tmp_ctx;
     struct ldb_result *res;
-    size_t c;
     int ret;
 
     tmp_ctx = talloc_new(NULL);
@@ -947,31 +969,200 @@ int sysdb_enumpwent_filter_with_views(TALLOC_CTX *mem_ctx,
         goto done;
     }
 
+    ret = sysdb_enumpwent_add_overrides(domain, res);
+    if (ret != EOK) {
+        goto done;
+    }
+
+    *_res = talloc_steal(mem_ctx, res);
+
+done:
+    talloc_zfree(tmp_ctx);
+    return ret;
+}
+
+int sysdb_enumpwent_with_views(TALLOC_CTX *mem_ctx,
+                               struct sss_domain_info *domain,
+                               struct ldb_result **_res)
+{
+    return sysdb_enumpwent_filter_with_views(mem_ctx, domain, NULL, NULL, _res);
+}
+
+/* Paged enumeration
+ *
+ * Instead of loading all objects of a domain at once, the caller first
+ * fetches a light-weight list of the objects (only DN, name and, if the
+ * domain has views, the overridden name) and then reads the full objects
+ * in chunks as they are needed. */
+
+static errno_t sysdb_enum_skeleton(TALLOC_CTX *mem_ctx,
+                                   struct sss_domain_info *domain,
+                                   struct ldb_dn *base_dn,
+                                   const char *filter,
+                                   struct ldb_result **_res)
+{
+    static const char *attrs[] = { SYSDB_NAME, SYSDB_OVERRIDE_DN, NULL };
+    static const char *override_attrs[] = { SYSDB_NAME, NULL };
+    struct ldb_result *res;
+    size_t c;
+    errno_t ret;
+    int lret;
+
+    DEBUG(SSSDBG_TRACE_LIBS, "Listing cache objects with [%s]\n", filter);
+
+    lret = ldb_search(domain->sysdb->ldb, mem_ctx, &res, base_dn,
+                      LDB_SCOPE_SUBTREE, attrs, "%s", filter);
+    if (lret != LDB_SUCCESS) {
+        return sysdb_error_to_errno(lret);
+    }
+
+    /* The name filters and the negative cache are applied to the list,
+     * so it must already carry the overridden names. */
     if (DOM_HAS_VIEWS(domain)) {
         for (c = 0; c < res->count; c++) {
             ret = sysdb_add_overrides_to_object(domain, res->msgs[c], NULL,
-                                                NULL);
-            /* enumeration assumes that the cache is up-to-date, hence we do not
-             * need to handle ENOENT separately. */
+                                                override_attrs);
             if (ret != EOK) {
-                DEBUG(SSSDBG_OP_FAILURE, "sysdb_add_overrides_to_object failed.\n");
-                goto done;
+                DEBUG(SSSDBG_OP_FAILURE,
+                      "sysdb_add_overrides_to_object failed.\n");
+                talloc_free(res);
+                return ret;
             }
         }
     }
 
+    *_res = res;
+    return EOK;
+}
+
+/* Read the objects in msgs with the given attributes. Objects which were
+ * removed from the cache in the meantime are skipped. */
+static errno_t sysdb_enum_by_dns(TALLOC_CTX *mem_ctx,
+                                 struct sss_domain_info *domain,
+                                 const char **attrs,
+                                 struct ldb_message **msgs,
+                                 size_t count,
+                                 struct ldb_result **_res)
+{
+    TALLOC_CTX *tmp_ctx;
+    struct ldb_result *res;
+    struct ldb_result *entry;
+    size_t c;
+    errno_t ret;
+    int lret;
+
+    tmp_ctx = talloc_new(NULL);
+    if (tmp_ctx == NULL) {
+        return ENOMEM;
+    }
+
+    res = talloc_zero(tmp_ctx, struct ldb_result);
+    if (res == NULL) {
+        ret = ENOMEM;
+        goto done;
+    }
+
+    res->msgs = talloc_zero_array(res, struct ldb_message *, count + 1);
+    if (res->msgs == NULL) {
+        ret = ENOMEM;
+        goto done;
+    }
+
+    for (c = 0; c < count; c++) {
+        lret = ldb_search(domain->sysdb->ldb, tmp_ctx, &entry, msgs[c]->dn,
+                          LDB_SCOPE_BASE, attrs, NULL);
+        if (lret == LDB_ERR_NO_SUCH_OBJECT) {
+            continue;
+        } else if (lret != LDB_SUCCESS) {
+            ret = sysdb_error_to_errno(lret);
+            goto done;
+        }
+
+        if (entry->count == 1) {
+            res->msgs[res->count] = talloc_steal(res->msgs, entry->msgs[0]);
+            res->count++;
+        }
+        talloc_free(entry);
+    }
+
     *_res = talloc_steal(mem_ctx, res);
+    ret = EOK;
 
 done:
-    talloc_zfree(tmp_ctx);
+    talloc_free(tmp_ctx);
     return ret;
 }
 
-int sysdb_enumpwent_with_views(TALLOC_CTX *mem_ctx,
-                               struct sss_domain_info *domain,
-                               struct ldb_result **_res)
+int sysdb_enumpwent_dns(TALLOC_CTX *mem_ctx,
+                        struct sss_domain_info *domain,
+                        struct ldb_result **_res)
 {
-    return sysdb_enumpwent_filter_with_views(mem_ctx, domain, NULL, NULL, _res);
+    TALLOC_CTX *tmp_ctx;
+    struct ldb_dn *base_dn;
+    struct ldb_result *res;
+    int ret;
+
+    tmp_ctx = talloc_new(NULL);
+    if (tmp_ctx == NULL) {
+        return ENOMEM;
+    }
+
+    base_dn = sysdb_user_base_dn(tmp_ctx, domain);
+    if (base_dn == NULL) {
+        ret = ENOMEM;
+        goto done;
+    }
+
+    ret = sysdb_enum_skeleton(tmp_ctx, domain, base_dn, SYSDB_PWENT_FILTER,
+                              &res);
+    if (ret != EOK) {
+        goto done;
+    }
+
+    *_res = talloc_steal(mem_ctx, res);
+
+done:
+    talloc_free(tmp_ctx);
+    return ret;
+}
+
+int sysdb_enumpwent_by_dns_with_views(TALLOC_CTX *mem_ctx,
+                                      struct sss_domain_info *domain,
+                                      struct ldb_message **msgs,
+                                      size_t count,
+                                      struct ldb_result **_res)
+{
+    TALLOC_CTX *tmp_ctx;
+    static const char *attrs[] = SYSDB_PW_ATTRS;
+    struct ldb_result *res;
+    int ret;
+
+    tmp_ctx = talloc_new(NULL);
+    if (tmp_ctx == NULL) {
+        return ENOMEM;
+    }
+
+    ret = sysdb_enum_by_dns(tmp_ctx, domain, attrs, msgs, count, &res);
+    if (ret != EOK) {
+        goto done;
+    }
+
+    ret = sysdb_merge_res_ts_attrs(domain->sysdb, res, attrs);
+    if (ret != EOK) {
+        DEBUG(SSSDBG_MINOR_FAILURE, "Cannot merge timestamp cache values\n");
+        /* non-fatal */
+    }
+
+    ret = sysdb_enumpwent_add_overrides(domain, res);
+    if (ret != EOK) {
+        goto done;
+    }
+
+    *_res = talloc_steal(mem_ctx, res);
+
+done:
+    talloc_free(tmp_ctx);
+    return ret;
 }
 
 /* groups */
@@ -1533,6 +1724,36 @@ int sysdb_enumgrent(TALLOC_CTX *mem_ctx,
     return sysdb_enumgrent_filter(mem_ctx, domain, NULL, 0, _res);
 }
 
+static errno_t sysdb_enumgrent_add_overrides(struct sss_domain_info *domain,
+                                             struct ldb_result *res)
+{
+    size_t c;
+    errno_t ret;
+
+    for (c = 0; c < res->count; c++) {
+        if (DOM_HAS_VIEWS(domain)) {
+            ret = sysdb_add_overrides_to_object(domain, res->msgs[c], NULL,
+                                                NULL);
+            /* enumeration assumes that the cache is up-to-date, hence we do not
+             * need to handle ENOENT separately. */
+            if (ret != EOK) {
+                DEBUG(SSSDBG_OP_FAILURE, "sysdb_add_overrides_to_object failed.\n");
+                return ret;
+            }
+        }
+
+        ret = sysdb_add_group_member_overrides(domain, res->msgs[c],
+                                               DOM_HAS_VIEWS(domain));
+        if (ret != EOK) {
+            DEBUG(SSSDBG_OP_FAILURE,
+                  "sysdb_add_group_member_overrides failed.\n");
+            return ret;
+        }
+    }
+
+    return EOK;
+}
+
 int sysdb_enumgrent_filter_with_views(TALLOC_CTX *mem_ctx,
                                       struct sss_domain_info *domain,
                                       const char *name_filter,
@@ -1541,7 +1762,6 @@ int sysdb_enumgrent_filter_with_views(TALLOC_CTX *mem_ctx,
 {
     TALLOC_CTX *tmp_ctx;
     struct ldb_result *res;
-    size_t c;
     int ret;
 
     tmp_ctx = talloc_new(NULL);
@@ -1556,28 +1776,11 @@ int sysdb_enumgrent_filter_with_views(TALLOC_CTX *mem_ctx,
         goto done;
     }
 
-    for (c = 0; c < res->count; c++) {
-        if (DOM_HAS_VIEWS(domain)) {
-            ret = sysdb_add_overrides_to_object(domain, res->msgs[c], NULL,
-                                                NULL);
-            /* enumeration assumes that the cache is up-to-date, hence we do not
-             * need to handle ENOENT separately. */
-            if (ret != EOK) {
-                DEBUG(SSSDBG_OP_FAILURE, "sysdb_add_overrides_to_object failed.\n");
-                goto done;
-            }
-        }
-
-        ret = sysdb_add_group_member_overrides(domain, res->msgs[c],
-                                               DOM_HAS_VIEWS(domain));
-        if (ret != EOK) {
-            DEBUG(SSSDBG_OP_FAILURE,
-                  "sysdb_add_group_member_overrides failed.\n");
-            goto done;
-        }
+    ret = sysdb_enumgrent_add_overrides(domain, res);
+    if (ret != EOK) {
+        goto done;
     }
 
-
     *_res = talloc_steal(mem_ctx, res);
 
 done:
@@ -1592,6 +1795,89 @@ int sysdb_enumgrent_with_views(TALLOC_CTX *mem_ctx,
     return sysdb_enumgrent_filter_with_views(mem_ctx, domain, NULL, NULL, _res);
 }
 
+int sysdb_enumgrent_dns(TALLOC_CTX *mem_ctx,
+                        struct sss_domain_info *domain,
+                        struct ldb_result **_res)
+{
+    TALLOC_CTX *tmp_ctx;
+    const char *filter;
+    struct ldb_dn *base_dn;
+    struct ldb_result *res;
+    int ret;
+
+    tmp_ctx = talloc_new(NULL);
+    if (tmp_ctx == NULL) {
+        return ENOMEM;
+    }
+
+    if (sss_domain_is_mpg(domain)) {
+        filter = SYSDB_GRENT_MPG_FILTER;
+        base_dn = sysdb_domain_dn(tmp_ctx, domain);
+    } else {
+        filter = SYSDB_GRENT_FILTER;
+        base_dn = sysdb_group_base_dn(tmp_ctx, domain);
+    }
+    if (base_dn == NULL) {
+        ret = ENOMEM;
+        goto done;
+    }
+
+    ret = sysdb_enum_skeleton(tmp_ctx, domain, base_dn, filter, &res);
+    if (ret != EOK) {
+        goto done;
+    }
+
+    *_res = talloc_steal(mem_ctx, res);
+
+done:
+    talloc_free(tmp_ctx);
+    return ret;
+}
+
+int sysdb_enumgrent_by_dns_with_views(TALLOC_CTX *mem_ctx,
+                                      struct sss_domain_info *domain,
+                                      struct ldb_message **msgs,
+                                      size_t count,
+                                      struct ldb_result **_res)
+{
+    TALLOC_CTX *tmp_ctx;
+    static const char *attrs[] = SYSDB_GRSRC_ATTRS;
+    struct ldb_result *res;
+    int ret;
+
+    tmp_ctx = talloc_new(NULL);
+    if (tmp_ctx == NULL) {
+        return ENOMEM;
+    }
+
+    ret = sysdb_enum_by_dns(tmp_ctx, domain, attrs, msgs, count, &res);
+    if (ret != EOK) {
+        goto done;
+    }
+
+    ret = mpg_res_convert(res);
+    if (ret != EOK) {
+        goto done;
+    }
+
+    ret = sysdb_merge_res_ts_attrs(domain->sysdb, res, attrs);
+    if (ret != EOK) {
+        DEBUG(SSSDBG_MINOR_FAILURE, "Cannot merge timestamp cache values\n");
+        /* non-fatal */
+    }
+
+    ret = sysdb_enumgrent_add_overrides(domain, res);
+    if (ret != EOK) {
+        goto done;
+    }
+
+    *_res = talloc_steal(mem_ctx, res);
+
+done:
+    talloc_free(tmp_ctx);
+    return ret;
+}
+
 int sysdb_initgroups(TALLOC_CTX *mem_ctx,
                      struct sss_domain_info *domain,
                      const char *name,
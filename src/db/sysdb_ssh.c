@@ -49,6 +49,139 @@ sysdb_update_ssh_host(struct sss_domain_info *domain,
     return EOK;
 }
 
+static struct ldb_dn *
+sysdb_ssh_hosts_dn(TALLOC_CTX *mem_ctx,
+                   struct sss_domain_info *domain)
+{
+    return ldb_dn_new_fmt(mem_ctx, domain->sysdb->ldb,
+                          SYSDB_TMPL_CUSTOM_SUBTREE,
+                          SSH_HOSTS_SUBDIR, domain->name);
+}
+
+errno_t
+sysdb_ssh_hosts_get_generation(struct sss_domain_info *domain,
+                               uint32_t *_generation)
+{
+    TALLOC_CTX *tmp_ctx;
+    struct ldb_dn *dn;
+    struct ldb_result *res;
+    const char *attrs[] = { SYSDB_SSH_AT_GENERATION, NULL };
+    errno_t ret;
+    int lret;
+
+    tmp_ctx = talloc_new(NULL);
+    if (!tmp_ctx) {
+        return ENOMEM;
+    }
+
+    dn = sysdb_ssh_hosts_dn(tmp_ctx, domain);
+    if (!dn) {
+        ret = ENOMEM;
+        goto done;
+    }
+
+    lret = ldb_search(domain->sysdb->ldb, tmp_ctx, &res, dn, LDB_SCOPE_BASE,
+                      attrs, NULL);
+    if (lret != LDB_SUCCESS) {
+        ret = sysdb_error_to_errno(lret);
+        goto done;
+    }
+
+    if (res->count == 0) {
+        /* the container is created with the first change */
+        *_generation = 0;
+        ret = EOK;
+        goto done;
+    } else if (res->count != 1) {
+        DEBUG(SSSDBG_CRIT_FAILURE,
+              "Got more than one reply for base search!\n");
+        ret = EIO;
+        goto done;
+    }
+
+    *_generation = ldb_msg_find_attr_as_uint(res->msgs[0],
+                                             SYSDB_SSH_AT_GENERATION, 0);
+    ret = EOK;
+
+done:
+    talloc_free(tmp_ctx);
+
+    return ret;
+}
+
+errno_t
+sysdb_ssh_hosts_bump_generation(struct sss_domain_info *domain)
+{
+    TALLOC_CTX *tmp_ctx;
+    struct ldb_message *msg;
+    struct ldb_result *res;
+    const char *attrs[] = { SYSDB_SSH_AT_GENERATION, NULL };
+    uint32_t generation = 0;
+    errno_t ret;
+    int lret;
+
+    tmp_ctx = talloc_new(NULL);
+    if (!tmp_ctx) {
+        return ENOMEM;
+    }
+
+    msg = ldb_msg_new(tmp_ctx);
+    if (!msg) {
+        ret = ENOMEM;
+        goto done;
+    }
+
+    msg->dn = sysdb_ssh_hosts_dn(msg, domain);
+    if (!msg->dn) {
+        ret = ENOMEM;
+        goto done;
+    }
+
+    lret = ldb_search(domain->sysdb->ldb, tmp_ctx, &res, msg->dn,
+                      LDB_SCOPE_BASE, attrs, NULL);
+    if (lret != LDB_SUCCESS) {
+        ret = sysdb_error_to_errno(lret);
+        goto done;
+    }
+
+    if (res->count == 0) {
+        lret = ldb_msg_add_string(msg, "cn", SSH_HOSTS_SUBDIR);
+    } else {
+        generation = ldb_msg_find_attr_as_uint(res->msgs[0],
+                                               SYSDB_SSH_AT_GENERATION, 0);
+        lret = ldb_msg_add_empty(msg, SYSDB_SSH_AT_GENERATION,
+                                 LDB_FLAG_MOD_REPLACE, NULL);
+    }
+    if (lret != LDB_SUCCESS) {
+        ret = sysdb_error_to_errno(lret);
+        goto done;
+    }
+
+    lret = ldb_msg_add_fmt(msg, SYSDB_SSH_AT_GENERATION, "%"PRIu32,
+                           generation + 1);
+    if (lret != LDB_SUCCESS) {
+        ret = sysdb_error_to_errno(lret);
+        goto done;
+    }
+
+    if (res->count == 0) {
+        lret = ldb_add(domain->sysdb->ldb, msg);
+    } else {
+        lret = ldb_modify(domain->sysdb->ldb, msg);
+    }
+    if (lret != LDB_SUCCESS) {
+        DEBUG(SSSDBG_MINOR_FAILURE,
+              "ldb operation failed: [%s](%d)[%s]\n",
+              ldb_strerror(lret), lret, ldb_errstring(domain->sysdb->ldb));
+    }
+    ret = sysdb_error_to_errno(lret);
+
+done:
+    talloc_free(tmp_ctx);
+
+    return ret;
+}
+
 errno_t
 sysdb_store_ssh_host(struct sss_domain_info *domain,
                      const char *name,
@@ -169,6 +302,11 @@ sysdb_store_ssh_host(struct sss_domain_info *domain,
         goto done;
     }
 
+    ret = sysdb_ssh_hosts_bump_generation(domain);
+    if (ret != EOK) {
+        goto done;
+    }
+
     ret = sysdb_transaction_commit(domain->sysdb);
     if (ret != EOK) {
         DEBUG(SSSDBG_CRIT_FAILURE, "Failed to commit transaction\n");
@@ -198,7 +336,8 @@ sysdb_set_ssh_host_attr(struct sss_domain_info *domain,
                         struct sysdb_attrs *attrs,
                         int mod_op)
 {
-    errno_t ret;
+    errno_t ret, sret;
+    bool in_transaction = false;
     struct ldb_dn *dn;
     TALLOC_CTX *tmp_ctx;
 
@@ -213,9 +352,38 @@ sysdb_set_ssh_host_attr(struct sss_domain_info *domain,
         goto done;
     }
 
+    ret = sysdb_transaction_start(domain->sysdb);
+    if (ret != EOK) {
+        DEBUG(SSSDBG_CRIT_FAILURE, "Failed to start transaction\n");
+        goto done;
+    }
+    in_transaction = true;
+
     ret = sysdb_set_entry_attr(domain->sysdb, dn, attrs, mod_op);
+    if (ret != EOK) {
+        goto done;
+    }
+
+    ret = sysdb_ssh_hosts_bump_generation(domain);
+    if (ret != EOK) {
+        goto done;
+    }
+
+    ret = sysdb_transaction_commit(domain->sysdb);
+    if (ret != EOK) {
+        DEBUG(SSSDBG_CRIT_FAILURE, "Failed to commit transaction\n");
+        goto done;
+    }
+    in_transaction = false;
 
 done:
+    if (in_transaction) {
+        sret = sysdb_transaction_cancel(domain->sysdb);
+        if (sret != EOK) {
+            DEBUG(SSSDBG_CRIT_FAILURE, "Could not cancel transaction\n");
+        }
+    }
+
     talloc_free(tmp_ctx);
     return ret;
 }
@@ -244,6 +412,8 @@ sysdb_update_ssh_known_host_expire(struct sss_domain_info *domain,
         goto done;
     }
 
+    /* The generation is not changed, the caller refreshes the known_hosts
+     * entry of the host itself. */
     ret = sysdb_attrs_add_time_t(attrs, SYSDB_SSH_KNOWN_HOSTS_EXPIRE,
                                  now + known_hosts_timeout);
     if (ret != EOK) {
@@ -270,8 +440,44 @@ errno_t
 sysdb_delete_ssh_host(struct sss_domain_info *domain,
                       const char *name)
 {
+    errno_t ret, sret;
+    bool in_transaction = false;
+
     DEBUG(SSSDBG_TRACE_FUNC, "Deleting host %s\n", name);
-    return sysdb_delete_custom(domain, name, SSH_HOSTS_SUBDIR);
+
+    ret = sysdb_transaction_start(domain->sysdb);
+    if (ret != EOK) {
+        DEBUG(SSSDBG_CRIT_FAILURE, "Failed to start transaction\n");
+        return ret;
+    }
+    in_transaction = true;
+
+    ret = sysdb_delete_custom(domain, name, SSH_HOSTS_SUBDIR);
+    if (ret != EOK) {
+        goto done;
+    }
+
+    ret = sysdb_ssh_hosts_bump_generation(domain);
+    if (ret != EOK) {
+        goto done;
+    }
+
+    ret = sysdb_transaction_commit(domain->sysdb);
+    if (ret != EOK) {
+        DEBUG(SSSDBG_CRIT_FAILURE, "Failed to commit transaction\n");
+        goto done;
+    }
+    in_transaction = false;
+
+done:
+    if (in_transaction) {
+        sret = sysdb_transaction_cancel(domain->sysdb);
+        if (sret != EOK) {
+            DEBUG(SSSDBG_CRIT_FAILURE, "Could not cancel transaction\n");
+        }
+    }
+
+    return ret;
 }
 
 errno_t
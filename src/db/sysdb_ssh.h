@@ -29,6 +29,8 @@
 
 #define SYSDB_SSH_KNOWN_HOSTS_EXPIRE "sshKnownHostsExpire"
 
+#define SYSDB_SSH_AT_GENERATION "sshHostsGeneration"
+
 errno_t
 sysdb_store_ssh_host(struct sss_domain_info *domain,
                      const char *name,
@@ -68,6 +70,15 @@ sysdb_get_ssh_host(TALLOC_CTX *mem_ctx,
                    const char **attrs,
                    struct ldb_message **host);
 
+/* The generation of the hosts of the domain is increased on every change
+ * of a host except for its known_hosts expiration time. */
+errno_t
+sysdb_ssh_hosts_bump_generation(struct sss_domain_info *domain);
+
+errno_t
+sysdb_ssh_hosts_get_generation(struct sss_domain_info *domain,
+                               uint32_t *_generation);
+
 errno_t
 sysdb_get_ssh_known_hosts(TALLOC_CTX *mem_ctx,
                           struct sss_domain_info *domain,
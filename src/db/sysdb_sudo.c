@@ -687,6 +687,37 @@ errno_t sysdb_sudo_get_last_full_refresh(struct sss_domain_info *domain,
                                        SYSDB_SUDO_AT_LAST_FULL_REFRESH, value);
 }
 
+errno_t sysdb_sudo_bump_generation(struct sss_domain_info *domain)
+{
+    time_t generation;
+    errno_t ret;
+
+    ret = sysdb_sudo_get_refresh_time(domain, SYSDB_SUDO_AT_GENERATION,
+                                      &generation);
+    if (ret != EOK) {
+        return ret;
+    }
+
+    return sysdb_sudo_set_refresh_time(domain, SYSDB_SUDO_AT_GENERATION,
+                                       (uint32_t)(generation + 1));
+}
+
+errno_t sysdb_sudo_get_generation(struct sss_domain_info *domain,
+                                  uint32_t *_generation)
+{
+    time_t generation;
+    errno_t ret;
+
+    ret = sysdb_sudo_get_refresh_time(domain, SYSDB_SUDO_AT_GENERATION,
+                                      &generation);
+    if (ret != EOK) {
+        return ret;
+    }
+
+    *_generation = (uint32_t)generation;
+    return EOK;
+}
+
 /* ====================  Purge functions ==================== */
 
 static const char *
@@ -1145,6 +1176,8 @@ sysdb_set_sudo_rule_attr(struct sss_domain_info *domain,
                          struct sysdb_attrs *attrs,
                          int mod_op)
 {
+    bool in_transaction = false;
+    errno_t sret;
     errno_t ret;
     struct ldb_dn *dn;
     TALLOC_CTX *tmp_ctx;
@@ -1157,9 +1190,39 @@ sysdb_set_sudo_rule_attr(struct sss_domain_info *domain,
     dn = sysdb_sudo_rule_dn(tmp_ctx, domain, name);
     NULL_CHECK(dn, ret, done);
 
+    ret = sysdb_transaction_start(domain->sysdb);
+    if (ret != EOK) {
+        DEBUG(SSSDBG_CRIT_FAILURE, "Failed to start transaction\n");
+        goto done;
+    }
+    in_transaction = true;
+
     ret = sysdb_set_entry_attr(domain->sysdb, dn, attrs, mod_op);
+    if (ret != EOK) {
+        goto done;
+    }
+
+    /* e.g. an expired rule must be seen by the responder's rule index */
+    ret = sysdb_sudo_bump_generation(domain);
+    if (ret != EOK) {
+        goto done;
+    }
+
+    ret = sysdb_transaction_commit(domain->sysdb);
+    if (ret != EOK) {
+        DEBUG(SSSDBG_CRIT_FAILURE, "Failed to commit transaction\n");
+        goto done;
+    }
+    in_transaction = false;
 
 done:
+    if (in_transaction) {
+        sret = sysdb_transaction_cancel(domain->sysdb);
+        if (sret != EOK) {
+            DEBUG(SSSDBG_OP_FAILURE, "Could not cancel transaction\n");
+        }
+    }
+
     talloc_free(tmp_ctx);
     return ret;
 }
@@ -31,6 +31,8 @@
  * should be true if we have downloaded all rules atleast once */
 #define SYSDB_SUDO_AT_REFRESHED      "refreshed"
 #define SYSDB_SUDO_AT_LAST_FULL_REFRESH "sudoLastFullRefreshTime"
+/* incremented each time a refresh changed the cached rules */
+#define SYSDB_SUDO_AT_GENERATION     "sudoRulesGeneration"
 
 /* sysdb attributes */
 #define SYSDB_SUDO_CACHE_OC            "sudoRule"
@@ -130,6 +132,12 @@ errno_t sysdb_sudo_set_last_full_refresh(struct sss_domain_info *domain,
 errno_t sysdb_sudo_get_last_full_refresh(struct sss_domain_info *domain,
                                          time_t *value);
 
+/* The generation changes whenever the rules stored in the cache may have
+ * changed, it lets consumers keep derived data until the next refresh. */
+errno_t sysdb_sudo_bump_generation(struct sss_domain_info *domain);
+errno_t sysdb_sudo_get_generation(struct sss_domain_info *domain,
+                                  uint32_t *_generation);
+
 errno_t sysdb_sudo_purge(struct sss_domain_info *domain,
                          const char *delete_filter,
                          struct sysdb_attrs **rules,
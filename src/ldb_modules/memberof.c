@@ -75,6 +75,8 @@ struct mbof_memberuid_op {
     struct ldb_message_element *el;
 };
 
+struct mbof_batch_ctx;
+
 struct mbof_add_ctx {
     struct mbof_ctx *ctx;
 
@@ -90,6 +92,8 @@ struct mbof_add_ctx {
     struct mbof_memberuid_op *muops;
     int num_muops;
     int cur_muop;
+
+    struct mbof_batch_ctx *batch;
 };
 
 struct mbof_del_ancestors_ctx {
@@ -456,6 +460,18 @@ static int mbof_add_muop(struct mbof_add_ctx *add_ctx);
 static int mbof_add_muop_callback(struct ldb_request *req,
                                   struct ldb_reply *ares);
 
+static bool mbof_use_batch(struct ldb_context *ldb);
+static struct mbof_batch_ctx *mbof_batch_init(struct mbof_add_ctx *add_ctx);
+static int mbof_batch_append(struct mbof_batch_ctx *bctx,
+                             struct mbof_dn_array *parents,
+                             struct ldb_dn *entry_dn,
+                             bool direct);
+static int mbof_batch_add_ghosts(struct mbof_batch_ctx *bctx,
+                                 struct mbof_dn_array *parents,
+                                 struct ldb_val *ghvals,
+                                 unsigned int num_gh_vals);
+static int mbof_batch_next(struct mbof_batch_ctx *bctx);
+
 static int memberof_add(struct ldb_module *module, struct ldb_request *req)
 {
     struct ldb_context *ldb = ldb_module_get_ctx(module);
@@ -518,6 +534,13 @@ static int memberof_add(struct ldb_module *module, struct ldb_request *req)
         goto done;
     }
 
+    if (mbof_use_batch(ldb)) {
+        add_ctx->batch = mbof_batch_init(add_ctx);
+        if (!add_ctx->batch) {
+            return LDB_ERR_OPERATIONS_ERROR;
+        }
+    }
+
     parents = talloc_zero(add_ctx, struct mbof_dn_array);
     if (!parents) {
         return LDB_ERR_OPERATIONS_ERROR;
@@ -543,7 +566,11 @@ static int memberof_add(struct ldb_module *module, struct ldb_request *req)
                       "Adding self as member is not permitted! Skipping");
             continue;
         }
-        ret = mbof_append_addop(add_ctx, parents, valdn);
+        if (add_ctx->batch) {
+            ret = mbof_batch_append(add_ctx->batch, parents, valdn, true);
+        } else {
+            ret = mbof_append_addop(add_ctx, parents, valdn);
+        }
         if (ret != LDB_SUCCESS) {
             return ret;
         }
@@ -601,7 +628,13 @@ static int mbof_add_callback(struct ldb_request *req,
                                    LDB_SUCCESS);
         }
 
-        if (add_ctx->current_op == NULL) {
+        if (add_ctx->batch) {
+            /* the original entry was added, process the members */
+            ctx->ret_ctrls = talloc_steal(ctx, ares->controls);
+            ctx->ret_resp = talloc_steal(ctx, ares->response);
+            ret = mbof_batch_next(add_ctx->batch);
+        }
+        else if (add_ctx->current_op == NULL) {
             /* first operation */
             ctx->ret_ctrls = talloc_steal(ctx, ares->controls);
             ctx->ret_resp = talloc_steal(ctx, ares->response);
@@ -1196,6 +1229,737 @@ static int mbof_add_muop_callback(struct ldb_request *req,
 
 
 
+/* batched add operations */
+
+/* The add operation described above reads and modifies the descendants one
+ * at a time, so an entry that is reachable through several paths may be
+ * read and written several times and the queue of pending operations is
+ * searched linearly for each new member.
+ *
+ * The add operations are therefore processed in two phases. First the
+ * descendants are walked and the new memberof, memberuid and ghost values
+ * of all affected entries are computed in memory. Each entry is read at most once
+ * and the already known memberships are tracked in hash tables. Then every
+ * affected entry, including the parent groups, is written with a single
+ * modify request.
+ */
+
+struct mbof_batch_entry {
+    struct ldb_dn *dn;
+    struct ldb_message *entry;
+    bool fetched;
+    bool missing;
+};
+
+struct mbof_batch_op {
+    struct mbof_batch_op *next;
+
+    struct mbof_batch_entry *be;
+    struct mbof_dn_array *parents;
+    bool direct;
+};
+
+struct mbof_batch_mod {
+    struct ldb_message *msg;
+};
+
+struct mbof_batch_ctx {
+    struct mbof_add_ctx *add_ctx;
+
+    /* entries read so far, indexed by casefolded DN */
+    hash_table_t *entries;
+    /* "entry\nparent" pairs of known memberships */
+    hash_table_t *memberofs;
+
+    struct mbof_batch_op *first;
+    struct mbof_batch_op *last;
+
+    /* pending modifications indexed by casefolded DN and the
+     * "dn\nattribute\nvalue" triplets they already contain */
+    hash_table_t *mods_table;
+    hash_table_t *values;
+    struct mbof_batch_mod **mods;
+    int num_mods;
+    int cur_mod;
+};
+
+static int mbof_batch_fetch(struct mbof_batch_ctx *bctx,
+                            struct mbof_batch_entry *be);
+static int mbof_batch_fetch_callback(struct ldb_request *req,
+                                     struct ldb_reply *ares);
+static int mbof_batch_write(struct mbof_batch_ctx *bctx);
+static int mbof_batch_write_callback(struct ldb_request *req,
+                                     struct ldb_reply *ares);
+
+/* Tests and benchmarks compare with the serial operation by setting this
+ * opaque on the ldb context. */
+#define MBOF_SERIAL_OPAQUE "memberof_serial"
+
+static bool mbof_use_batch(struct ldb_context *ldb)
+{
+    return ldb_get_opaque(ldb, MBOF_SERIAL_OPAQUE) == NULL;
+}
+
+static struct mbof_batch_ctx *mbof_batch_init(struct mbof_add_ctx *add_ctx)
+{
+    struct mbof_batch_ctx *bctx;
+    int ret;
+
+    bctx = talloc_zero(add_ctx, struct mbof_batch_ctx);
+    if (!bctx) {
+        return NULL;
+    }
+    bctx->add_ctx = add_ctx;
+
+    ret = hash_create_ex(1024, &bctx->entries, 0, 0, 0, 0,
+                         hash_alloc, hash_free, bctx, NULL, NULL);
+    if (ret != HASH_SUCCESS) {
+        goto fail;
+    }
+
+    ret = hash_create_ex(1024, &bctx->memberofs, 0, 0, 0, 0,
+                         hash_alloc, hash_free, bctx, NULL, NULL);
+    if (ret != HASH_SUCCESS) {
+        goto fail;
+    }
+
+    ret = hash_create_ex(64, &bctx->mods_table, 0, 0, 0, 0,
+                         hash_alloc, hash_free, bctx, NULL, NULL);
+    if (ret != HASH_SUCCESS) {
+        goto fail;
+    }
+
+    ret = hash_create_ex(1024, &bctx->values, 0, 0, 0, 0,
+                         hash_alloc, hash_free, bctx, NULL, NULL);
+    if (ret != HASH_SUCCESS) {
+        goto fail;
+    }
+
+    return bctx;
+
+fail:
+    talloc_free(bctx);
+    return NULL;
+}
+
+/* Add str to the set, _added is false if it was already there. */
+static int mbof_batch_set_add(hash_table_t *set, const char *str,
+                              bool *_added)
+{
+    hash_value_t value;
+    hash_key_t key;
+    int ret;
+
+    key.type = HASH_KEY_STRING;
+    key.str = discard_const(str);
+
+    ret = hash_lookup(set, &key, &value);
+    if (ret == HASH_SUCCESS) {
+        *_added = false;
+        return LDB_SUCCESS;
+    }
+    if (ret != HASH_ERROR_KEY_NOT_FOUND) {
+        return LDB_ERR_OPERATIONS_ERROR;
+    }
+
+    value.type = HASH_VALUE_UNDEF;
+    ret = hash_enter(set, &key, &value);
+    if (ret != HASH_SUCCESS) {
+        return LDB_ERR_OPERATIONS_ERROR;
+    }
+
+    *_added = true;
+    return LDB_SUCCESS;
+}
+
+static int mbof_batch_add_memberof(struct mbof_batch_ctx *bctx,
+                                   struct ldb_dn *dn,
+                                   struct ldb_dn *parent,
+                                   bool *_added)
+{
+    char *pair;
+    int ret;
+
+    pair = talloc_asprintf(bctx, "%s\n%s", ldb_dn_get_casefold(dn),
+                           ldb_dn_get_casefold(parent));
+    if (!pair) {
+        return LDB_ERR_OPERATIONS_ERROR;
+    }
+
+    ret = mbof_batch_set_add(bctx->memberofs, pair, _added);
+    talloc_free(pair);
+    return ret;
+}
+
+static int mbof_batch_get_entry(struct mbof_batch_ctx *bctx,
+                                struct ldb_dn *dn,
+                                struct mbof_batch_entry **_be)
+{
+    struct mbof_batch_entry *be;
+    hash_value_t value;
+    hash_key_t key;
+    int ret;
+
+    key.type = HASH_KEY_STRING;
+    key.str = discard_const(ldb_dn_get_casefold(dn));
+    if (!key.str) {
+        return LDB_ERR_OPERATIONS_ERROR;
+    }
+
+    ret = hash_lookup(bctx->entries, &key, &value);
+    if (ret == HASH_SUCCESS) {
+        *_be = talloc_get_type(value.ptr, struct mbof_batch_entry);
+        return LDB_SUCCESS;
+    }
+    if (ret != HASH_ERROR_KEY_NOT_FOUND) {
+        return LDB_ERR_OPERATIONS_ERROR;
+    }
+
+    be = talloc_zero(bctx, struct mbof_batch_entry);
+    if (!be) {
+        return LDB_ERR_OPERATIONS_ERROR;
+    }
+    be->dn = ldb_dn_copy(be, dn);
+    if (!be->dn) {
+        return LDB_ERR_OPERATIONS_ERROR;
+    }
+
+    value.type = HASH_VALUE_PTR;
+    value.ptr = be;
+    ret = hash_enter(bctx->entries, &key, &value);
+    if (ret != HASH_SUCCESS) {
+        return LDB_ERR_OPERATIONS_ERROR;
+    }
+
+    *_be = be;
+    return LDB_SUCCESS;
+}
+
+/* queue the propagation of parents to entry_dn */
+static int mbof_batch_append(struct mbof_batch_ctx *bctx,
+                             struct mbof_dn_array *parents,
+                             struct ldb_dn *entry_dn,
+                             bool direct)
+{
+    struct mbof_batch_op *op;
+    int ret;
+
+    op = talloc_zero(bctx, struct mbof_batch_op);
+    if (!op) {
+        return LDB_ERR_OPERATIONS_ERROR;
+    }
+
+    ret = mbof_batch_get_entry(bctx, entry_dn, &op->be);
+    if (ret != LDB_SUCCESS) {
+        return ret;
+    }
+    op->parents = parents;
+    op->direct = direct;
+
+    if (bctx->last) {
+        bctx->last->next = op;
+    } else {
+        bctx->first = op;
+    }
+    bctx->last = op;
+
+    return LDB_SUCCESS;
+}
+
+/* schedule the addition of value to the attribute name of entry dn */
+static int mbof_batch_add_value(struct mbof_batch_ctx *bctx,
+                                struct ldb_dn *dn,
+                                const char *name,
+                                const char *val)
+{
+    struct ldb_message_element *el;
+    struct mbof_batch_mod *mod;
+    struct ldb_val *vals;
+    hash_value_t value;
+    hash_key_t key;
+    char *triplet;
+    bool added;
+    int ret;
+
+    key.type = HASH_KEY_STRING;
+    key.str = discard_const(ldb_dn_get_casefold(dn));
+    if (!key.str) {
+        return LDB_ERR_OPERATIONS_ERROR;
+    }
+
+    triplet = talloc_asprintf(bctx, "%s\n%s\n%s", key.str, name, val);
+    if (!triplet) {
+        return LDB_ERR_OPERATIONS_ERROR;
+    }
+    ret = mbof_batch_set_add(bctx->values, triplet, &added);
+    talloc_free(triplet);
+    if (ret != LDB_SUCCESS || !added) {
+        return ret;
+    }
+
+    ret = hash_lookup(bctx->mods_table, &key, &value);
+    switch (ret) {
+    case HASH_SUCCESS:
+        mod = talloc_get_type(value.ptr, struct mbof_batch_mod);
+        break;
+
+    case HASH_ERROR_KEY_NOT_FOUND:
+        mod = talloc_zero(bctx, struct mbof_batch_mod);
+        if (!mod) {
+            return LDB_ERR_OPERATIONS_ERROR;
+        }
+        mod->msg = ldb_msg_new(mod);
+        if (!mod->msg) {
+            return LDB_ERR_OPERATIONS_ERROR;
+        }
+        mod->msg->dn = ldb_dn_copy(mod->msg, dn);
+        if (!mod->msg->dn) {
+            return LDB_ERR_OPERATIONS_ERROR;
+        }
+
+        value.type = HASH_VALUE_PTR;
+        value.ptr = mod;
+        ret = hash_enter(bctx->mods_table, &key, &value);
+        if (ret != HASH_SUCCESS) {
+            return LDB_ERR_OPERATIONS_ERROR;
+        }
+
+        bctx->mods = talloc_realloc(bctx, bctx->mods,
+                                    struct mbof_batch_mod *,
+                                    bctx->num_mods + 1);
+        if (!bctx->mods) {
+            return LDB_ERR_OPERATIONS_ERROR;
+        }
+        bctx->mods[bctx->num_mods] = mod;
+        bctx->num_mods++;
+        break;
+
+    default:
+        return LDB_ERR_OPERATIONS_ERROR;
+    }
+
+    el = ldb_msg_find_element(mod->msg, name);
+    if (!el) {
+        ret = ldb_msg_add_empty(mod->msg, name, LDB_FLAG_MOD_ADD, &el);
+        if (ret != LDB_SUCCESS) {
+            return ret;
+        }
+    }
+
+    vals = talloc_realloc(mod->msg, el->values,
+                          struct ldb_val, el->num_values + 1);
+    if (!vals) {
+        return LDB_ERR_OPERATIONS_ERROR;
+    }
+    vals[el->num_values].data = (uint8_t *)talloc_strdup(vals, val);
+    if (!vals[el->num_values].data) {
+        return LDB_ERR_OPERATIONS_ERROR;
+    }
+    vals[el->num_values].length = strlen(val);
+
+    el->values = vals;
+    el->num_values++;
+
+    return LDB_SUCCESS;
+}
+
+static int mbof_batch_add_ghosts(struct mbof_batch_ctx *bctx,
+                                 struct mbof_dn_array *parents,
+                                 struct ldb_val *ghvals,
+                                 unsigned int num_gh_vals)
+{
+    int ret;
+    int i, j;
+
+    for (i = 0; i < parents->num; i++) {
+        for (j = 0; j < num_gh_vals; j++) {
+            ret = mbof_batch_add_value(bctx, parents->dns[i], DB_GHOST,
+                                       (const char *)ghvals[j].data);
+            if (ret != LDB_SUCCESS) {
+                return ret;
+            }
+        }
+    }
+
+    return LDB_SUCCESS;
+}
+
+/* compute the new parents of the entry and queue its members */
+static int mbof_batch_process(struct mbof_batch_ctx *bctx,
+                              struct mbof_batch_op *op)
+{
+    struct ldb_context *ldb;
+    struct ldb_message_element *el;
+    struct mbof_batch_entry *be;
+    struct mbof_dn_array *parents;
+    struct ldb_dn *valdn;
+    const char *name;
+    bool added;
+    int i, ret;
+
+    ldb = ldb_module_get_ctx(bctx->add_ctx->ctx->module);
+    be = op->be;
+
+    parents = talloc_zero(bctx, struct mbof_dn_array);
+    if (!parents) {
+        return LDB_ERR_OPERATIONS_ERROR;
+    }
+    parents->dns = talloc_array(parents, struct ldb_dn *,
+                                op->parents->num);
+    if (!parents->dns) {
+        return LDB_ERR_OPERATIONS_ERROR;
+    }
+
+    /* keep only the parents the entry is not yet a member of */
+    for (i = 0; i < op->parents->num; i++) {
+        if (ldb_dn_compare(op->parents->dns[i], be->dn) == 0) {
+            continue;
+        }
+
+        ret = mbof_batch_add_memberof(bctx, be->dn, op->parents->dns[i],
+                                      &added);
+        if (ret != LDB_SUCCESS) {
+            return ret;
+        }
+        if (!added) {
+            continue;
+        }
+
+        ret = mbof_batch_add_value(bctx, be->dn, DB_MEMBEROF,
+                                   ldb_dn_get_linearized(op->parents->dns[i]));
+        if (ret != LDB_SUCCESS) {
+            return ret;
+        }
+
+        parents->dns[parents->num] = op->parents->dns[i];
+        parents->num++;
+    }
+
+    if (parents->num == 0) {
+        /* already contains all parents as memberof */
+        talloc_free(parents);
+        return LDB_SUCCESS;
+    }
+
+    ret = entry_is_user_object(be->entry);
+    switch (ret) {
+    case LDB_SUCCESS:
+        name = ldb_msg_find_attr_as_string(be->entry, DB_NAME, NULL);
+        if (!name) {
+            return LDB_ERR_OPERATIONS_ERROR;
+        }
+
+        for (i = 0; i < parents->num; i++) {
+            ret = mbof_batch_add_value(bctx, parents->dns[i],
+                                       DB_MEMBERUID, name);
+            if (ret != LDB_SUCCESS) {
+                return ret;
+            }
+        }
+        break;
+
+    case LDB_ERR_NO_SUCH_ATTRIBUTE:
+        /* it is not a user object, continue */
+        break;
+
+    default:
+        return ret;
+    }
+
+    el = ldb_msg_find_element(be->entry, DB_GHOST);
+    if (el && el->num_values > 0) {
+        ret = entry_is_group_object(be->entry);
+        if (ret == LDB_SUCCESS) {
+            ret = mbof_batch_add_ghosts(bctx, parents,
+                                        el->values, el->num_values);
+        }
+        if (ret != LDB_SUCCESS && ret != LDB_ERR_NO_SUCH_ATTRIBUTE) {
+            return ret;
+        }
+    }
+
+    /* if it is a group pass the new parents to all members */
+    el = ldb_msg_find_element(be->entry, DB_MEMBER);
+    if (el) {
+        for (i = 0; i < el->num_values; i++) {
+            valdn = ldb_dn_from_ldb_val(bctx, ldb, &el->values[i]);
+            if (!valdn) {
+                ldb_debug(ldb, LDB_DEBUG_TRACE, "Invalid DN in member [%s]",
+                                            (const char *)el->values[i].data);
+                return LDB_ERR_OPERATIONS_ERROR;
+            }
+            if (!ldb_dn_validate(valdn)) {
+                ldb_debug(ldb, LDB_DEBUG_TRACE,
+                               "Invalid DN syntax for member [%s]",
+                                            (const char *)el->values[i].data);
+                return LDB_ERR_INVALID_DN_SYNTAX;
+            }
+
+            ret = mbof_batch_append(bctx, parents, valdn, false);
+            talloc_free(valdn);
+            if (ret != LDB_SUCCESS) {
+                return ret;
+            }
+        }
+    }
+
+    return LDB_SUCCESS;
+}
+
+static int mbof_batch_next(struct mbof_batch_ctx *bctx)
+{
+    struct mbof_batch_op *op;
+    struct ldb_dn *dn;
+    int ret;
+
+    while (bctx->first) {
+        op = bctx->first;
+
+        if (!op->be->fetched) {
+            /* processing continues once the entry has been read */
+            return mbof_batch_fetch(bctx, op->be);
+        }
+
+        bctx->first = op->next;
+        if (!bctx->first) {
+            bctx->last = NULL;
+        }
+
+        if (op->be->entry == NULL) {
+            /* remove unexisting direct members from the original entry */
+            if (op->direct && !op->be->missing) {
+                op->be->missing = true;
+
+                dn = ldb_dn_copy(bctx->add_ctx, op->be->dn);
+                if (!dn) {
+                    return LDB_ERR_OPERATIONS_ERROR;
+                }
+                ret = mbof_add_missing(bctx->add_ctx, dn);
+                if (ret != LDB_SUCCESS) {
+                    return ret;
+                }
+            }
+        } else {
+            ret = mbof_batch_process(bctx, op);
+            if (ret != LDB_SUCCESS) {
+                return ret;
+            }
+        }
+
+        talloc_free(op);
+    }
+
+    return mbof_batch_write(bctx);
+}
+
+static int mbof_batch_fetch(struct mbof_batch_ctx *bctx,
+                            struct mbof_batch_entry *be)
+{
+    static const char *attrs[] = { DB_OC, DB_NAME,
+                                   DB_MEMBER, DB_GHOST,
+                                   DB_MEMBEROF, NULL };
+    struct ldb_context *ldb;
+    struct ldb_request *req;
+    struct mbof_ctx *ctx;
+    int ret;
+
+    ctx = bctx->add_ctx->ctx;
+    ldb = ldb_module_get_ctx(ctx->module);
+
+    ret = ldb_build_search_req(&req, ldb, bctx,
+                               be->dn, LDB_SCOPE_BASE,
+                               NULL, attrs, NULL,
+                               bctx, mbof_batch_fetch_callback,
+                               ctx->req);
+    if (ret != LDB_SUCCESS) {
+        return ret;
+    }
+
+    return ldb_request(ldb, req);
+}
+
+static int mbof_batch_fetch_callback(struct ldb_request *req,
+                                     struct ldb_reply *ares)
+{
+    struct mbof_batch_ctx *bctx;
+    struct mbof_batch_entry *be;
+    struct ldb_message_element *el;
+    struct ldb_context *ldb;
+    struct ldb_dn *valdn;
+    struct mbof_ctx *ctx;
+    bool added;
+    int i, ret;
+
+    bctx = talloc_get_type(req->context, struct mbof_batch_ctx);
+    ctx = bctx->add_ctx->ctx;
+    ldb = ldb_module_get_ctx(ctx->module);
+    be = bctx->first->be;
+
+    if (!ares) {
+        return ldb_module_done(ctx->req, NULL, NULL,
+                               LDB_ERR_OPERATIONS_ERROR);
+    }
+    if (ares->error != LDB_SUCCESS) {
+        return ldb_module_done(ctx->req,
+                               ares->controls,
+                               ares->response,
+                               ares->error);
+    }
+
+    switch (ares->type) {
+    case LDB_REPLY_ENTRY:
+        if (be->entry != NULL) {
+            ldb_debug(ldb, LDB_DEBUG_TRACE,
+                           "Found multiple entries for (%s)",
+                           ldb_dn_get_linearized(be->dn));
+            /* more than one entry per DN!? DB corrupted? */
+            return ldb_module_done(ctx->req, NULL, NULL,
+                                   LDB_ERR_OPERATIONS_ERROR);
+        }
+
+        be->entry = talloc_steal(be, ares->message);
+        if (be->entry == NULL) {
+            return ldb_module_done(ctx->req, NULL, NULL,
+                                   LDB_ERR_OPERATIONS_ERROR);
+        }
+        break;
+
+    case LDB_REPLY_REFERRAL:
+        /* ignore */
+        break;
+
+    case LDB_REPLY_DONE:
+        talloc_zfree(ares);
+        be->fetched = true;
+
+        if (be->entry == NULL) {
+            ldb_debug(ldb, LDB_DEBUG_TRACE, "Entry not found (%s)",
+                           ldb_dn_get_linearized(be->dn));
+        } else {
+            /* remember the memberships the entry already has */
+            el = ldb_msg_find_element(be->entry, DB_MEMBEROF);
+            for (i = 0; el && i < el->num_values; i++) {
+                valdn = ldb_dn_from_ldb_val(bctx, ldb, &el->values[i]);
+                if (!valdn) {
+                    ldb_debug(ldb, LDB_DEBUG_TRACE,
+                              "Invalid DN in memberof [%s]",
+                              (const char *)el->values[i].data);
+                    return ldb_module_done(ctx->req, NULL, NULL,
+                                           LDB_ERR_OPERATIONS_ERROR);
+                }
+
+                ret = mbof_batch_add_memberof(bctx, be->dn, valdn, &added);
+                talloc_free(valdn);
+                if (ret != LDB_SUCCESS) {
+                    return ldb_module_done(ctx->req, NULL, NULL, ret);
+                }
+            }
+        }
+
+        ret = mbof_batch_next(bctx);
+        if (ret != LDB_SUCCESS) {
+            return ldb_module_done(ctx->req, NULL, NULL, ret);
+        }
+        return LDB_SUCCESS;
+    }
+
+    talloc_zfree(ares);
+    return LDB_SUCCESS;
+}
+
+/* write all pending modifications, one request per entry */
+static int mbof_batch_write(struct mbof_batch_ctx *bctx)
+{
+    struct ldb_context *ldb;
+    struct ldb_request *mod_req;
+    struct mbof_add_ctx *add_ctx;
+    struct mbof_ctx *ctx;
+    int ret;
+
+    add_ctx = bctx->add_ctx;
+    ctx = add_ctx->ctx;
+    ldb = ldb_module_get_ctx(ctx->module);
+
+    if (bctx->cur_mod >= bctx->num_mods) {
+        if (add_ctx->missing) {
+            return mbof_add_cleanup(add_ctx);
+        }
+
+        return ldb_module_done(ctx->req,
+                               ctx->ret_ctrls,
+                               ctx->ret_resp,
+                               LDB_SUCCESS);
+    }
+
+    ret = ldb_build_mod_req(&mod_req, ldb, bctx,
+                            bctx->mods[bctx->cur_mod]->msg, NULL,
+                            bctx, mbof_batch_write_callback,
+                            ctx->req);
+    if (ret != LDB_SUCCESS) {
+        return ret;
+    }
+
+    /* memberuid and ghost values may already be present */
+    ret = ldb_request_add_control(mod_req, LDB_CONTROL_PERMISSIVE_MODIFY_OID,
+                                  false, NULL);
+    if (ret != LDB_SUCCESS) {
+        talloc_free(mod_req);
+        return ret;
+    }
+
+    return ldb_next_request(ctx->module, mod_req);
+}
+
+static int mbof_batch_write_callback(struct ldb_request *req,
+                                     struct ldb_reply *ares)
+{
+    struct mbof_batch_ctx *bctx;
+    struct mbof_ctx *ctx;
+    int ret;
+
+    bctx = talloc_get_type(req->context, struct mbof_batch_ctx);
+    ctx = bctx->add_ctx->ctx;
+
+    if (!ares) {
+        return ldb_module_done(ctx->req, NULL, NULL,
+                               LDB_ERR_OPERATIONS_ERROR);
+    }
+    if (ares->error != LDB_SUCCESS) {
+        return ldb_module_done(ctx->req,
+                               ares->controls,
+                               ares->response,
+                               ares->error);
+    }
+
+    switch (ares->type) {
+    case LDB_REPLY_ENTRY:
+        /* shouldn't happen */
+        talloc_zfree(ares);
+        return ldb_module_done(ctx->req, NULL, NULL,
+                               LDB_ERR_OPERATIONS_ERROR);
+    case LDB_REPLY_REFERRAL:
+        /* ignore */
+        break;
+
+    case LDB_REPLY_DONE:
+        /* the message is not needed anymore */
+        talloc_zfree(bctx->mods[bctx->cur_mod]);
+        bctx->cur_mod++;
+
+        ret = mbof_batch_write(bctx);
+        if (ret != LDB_SUCCESS) {
+            talloc_zfree(ares);
+            return ldb_module_done(ctx->req, NULL, NULL, ret);
+        }
+    }
+
+    talloc_zfree(ares);
+    return LDB_SUCCESS;
+}
+
+
+
+
 /* delete operations */
 
 /* The implementation of delete operations is a bit more complex than an add
@@ -3654,6 +4418,44 @@ static int mbof_mod_add(struct mbof_mod_ctx *mod_ctx,
     add_ctx->ctx = ctx;
     add_ctx->msg_dn = mod_ctx->msg->dn;
 
+    if (mbof_use_batch(ldb)) {
+        add_ctx->batch = mbof_batch_init(add_ctx);
+        if (!add_ctx->batch) {
+            return LDB_ERR_OPERATIONS_ERROR;
+        }
+
+        if (addgh != NULL) {
+            ret = entry_is_group_object(mod_ctx->entry);
+            if (ret == LDB_SUCCESS) {
+                ret = mbof_batch_add_ghosts(add_ctx->batch, parents,
+                                            addgh->vals, addgh->num);
+            }
+            if (ret != LDB_SUCCESS && ret != LDB_ERR_NO_SUCH_ATTRIBUTE) {
+                return ret;
+            }
+        }
+
+        if (ael != NULL && ael->num > 0) {
+            parents->dns = talloc_realloc(parents, parents->dns,
+                                          struct ldb_dn *, parents->num + 1);
+            if (!parents->dns) {
+                return LDB_ERR_OPERATIONS_ERROR;
+            }
+            parents->dns[parents->num] = mod_ctx->entry->dn;
+            parents->num++;
+
+            for (i = 0; i < ael->num; i++) {
+                ret = mbof_batch_append(add_ctx->batch, parents,
+                                        ael->dns[i], true);
+                if (ret != LDB_SUCCESS) {
+                    return ret;
+                }
+            }
+        }
+
+        return mbof_batch_next(add_ctx->batch);
+    }
+
     if (addgh != NULL) {
         /* Build the memberuid add op */
         ret =  mbof_add_fill_ghop_ex(add_ctx, mod_ctx->entry,
@@ -437,6 +437,28 @@ sss_sifp_free_object(sss_sifp_ctx *ctx,
     *_object = NULL;
 }
 
+void
+sss_sifp_free_objects(sss_sifp_ctx *ctx,
+                      sss_sifp_object ***_objects)
+{
+    sss_sifp_object **objects = NULL;
+    unsigned int i;
+
+    if (_objects == NULL || *_objects == NULL) {
+        return;
+    }
+
+    objects = *_objects;
+
+    for (i = 0; objects[i] != NULL; i++) {
+        sss_sifp_free_object(ctx, &objects[i]);
+    }
+
+    _free(ctx, objects);
+
+    *_objects = NULL;
+}
+
 void
 sss_sifp_free_string(sss_sifp_ctx *ctx,
                      char **_str)
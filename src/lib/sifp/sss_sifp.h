@@ -482,6 +482,16 @@ void
 sss_sifp_free_object(sss_sifp_ctx *ctx,
                      sss_sifp_object **_object);
 
+/**
+ * @brief Free NULL-terminated array of sss_sifp objects and set it to NULL.
+ *
+ * @param[in] ctx sss_sifp context
+ * @param[in,out] _objects Array of objects
+ */
+void
+sss_sifp_free_objects(sss_sifp_ctx *ctx,
+                      sss_sifp_object ***_objects);
+
 /**
  * @brief Free string and set it to NULL.
  *
@@ -557,6 +567,114 @@ sss_sifp_fetch_user_by_name(sss_sifp_ctx *ctx,
                             const char *name,
                             sss_sifp_object **_user);
 
+/**
+ * @brief Find many users by name in a single call.
+ *
+ * Users that do not exist or fail to be looked up are left out of the
+ * result, which keeps the order of the input and can therefore be shorter.
+ * Fetch the name or uidNumber attribute of the results to match them
+ * with the input.
+ *
+ * @param[in] ctx            sss_sifp context
+ * @param[in] names          NULL-terminated list of user names
+ * @param[out] _object_paths List of object paths of the users found
+ */
+sss_sifp_error
+sss_sifp_find_users_by_name(sss_sifp_ctx *ctx,
+                            const char * const *names,
+                            char ***_object_paths);
+
+/**
+ * @brief Find many users by uid in a single call.
+ *
+ * Users that do not exist or fail to be looked up are left out of the
+ * result, which keeps the order of the input and can therefore be shorter.
+ * Fetch the name or uidNumber attribute of the results to match them
+ * with the input.
+ *
+ * @param[in] ctx            sss_sifp context
+ * @param[in] uids           Array of user IDs
+ * @param[in] num_uids       Number of user IDs in the array
+ * @param[out] _object_paths List of object paths of the users found
+ */
+sss_sifp_error
+sss_sifp_find_users_by_uid(sss_sifp_ctx *ctx,
+                           const uid_t *uids,
+                           unsigned int num_uids,
+                           char ***_object_paths);
+
+/**
+ * @brief Fetch selected attributes of many users in a single call.
+ *
+ * One object is returned for each object path, in the same order. Only
+ * the requested attributes that are set and that InfoPipe is allowed to
+ * return are present. All values are returned as strings.
+ *
+ * @param[in] ctx           sss_sifp context
+ * @param[in] object_paths  NULL-terminated list of user object paths
+ * @param[in] attrs         NULL-terminated list of attribute names
+ * @param[out] _users       NULL-terminated list of user objects
+ */
+sss_sifp_error
+sss_sifp_fetch_users_attrs(sss_sifp_ctx *ctx,
+                           const char * const *object_paths,
+                           const char * const *attrs,
+                           sss_sifp_object ***_users);
+
+/**
+ * @brief Find many groups by name in a single call.
+ *
+ * Groups that do not exist or fail to be looked up are left out of the
+ * result, which keeps the order of the input and can therefore be shorter.
+ * Fetch the name or gidNumber attribute of the results to match them
+ * with the input.
+ *
+ * @param[in] ctx            sss_sifp context
+ * @param[in] names          NULL-terminated list of group names
+ * @param[out] _object_paths List of object paths of the groups found
+ */
+sss_sifp_error
+sss_sifp_find_groups_by_name(sss_sifp_ctx *ctx,
+                             const char * const *names,
+                             char ***_object_paths);
+
+/**
+ * @brief Find many groups by gid in a single call.
+ *
+ * Groups that do not exist or fail to be looked up are left out of the
+ * result, which keeps the order of the input and can therefore be shorter.
+ * Fetch the name or gidNumber attribute of the results to match them
+ * with the input.
+ *
+ * @param[in] ctx            sss_sifp context
+ * @param[in] gids           Array of group IDs
+ * @param[in] num_gids       Number of group IDs in the array
+ * @param[out] _object_paths List of object paths of the groups found
+ */
+sss_sifp_error
+sss_sifp_find_groups_by_gid(sss_sifp_ctx *ctx,
+                            const gid_t *gids,
+                            unsigned int num_gids,
+                            char ***_object_paths);
+
+/**
+ * @brief Fetch selected attributes of many groups in a single call.
+ *
+ * One object is returned for each object path, in the same order. Only
+ * name, gidNumber and uniqueID are available. All values are returned
+ * as strings.
+ *
+ * @param[in] ctx           sss_sifp context
+ * @param[in] object_paths  NULL-terminated list of group object paths
+ * @param[in] attrs         NULL-terminated list of attribute names
+ * @param[out] _groups      NULL-terminated list of group objects
+ */
+sss_sifp_error
+sss_sifp_fetch_groups_attrs(sss_sifp_ctx *ctx,
+                            const char * const *object_paths,
+                            const char * const *attrs,
+                            sss_sifp_object ***_groups);
+
 /**
  * @}
  */
@@ -181,3 +181,250 @@ sss_sifp_fetch_user_by_name(sss_sifp_ctx *ctx,
                                          "org.freedesktop.sssd.infopipe.Users.User", "ByName",
                                          name, _user);
 }
+
+static sss_sifp_error
+sss_sifp_find_object_list(sss_sifp_ctx *ctx,
+                          const char *path,
+                          const char *iface,
+                          const char *method,
+                          int element_type,
+                          const void *array,
+                          unsigned int count,
+                          char ***_object_paths)
+{
+    DBusMessage *msg = NULL;
+    DBusMessage *reply = NULL;
+    sss_sifp_error ret;
+    dbus_bool_t bret;
+
+    if (ctx == NULL || _object_paths == NULL) {
+        return SSS_SIFP_INVALID_ARGUMENT;
+    }
+
+    msg = sss_sifp_create_message(path, iface, method);
+    if (msg == NULL) {
+        ret = SSS_SIFP_OUT_OF_MEMORY;
+        goto done;
+    }
+
+    bret = dbus_message_append_args(msg, DBUS_TYPE_ARRAY, element_type,
+                                    array, count, DBUS_TYPE_INVALID);
+    if (!bret) {
+        ret = SSS_SIFP_OUT_OF_MEMORY;
+        goto done;
+    }
+
+    ret = sss_sifp_send_message(ctx, msg, &reply);
+    if (ret != SSS_SIFP_OK) {
+        goto done;
+    }
+
+    ret = sss_sifp_parse_object_path_list(ctx, reply, _object_paths);
+
+done:
+    if (msg != NULL) {
+        dbus_message_unref(msg);
+    }
+
+    if (reply != NULL) {
+        dbus_message_unref(reply);
+    }
+
+    return ret;
+}
+
+static sss_sifp_error
+sss_sifp_find_objects_by_name(sss_sifp_ctx *ctx,
+                              const char *path,
+                              const char *iface,
+                              const char * const *names,
+                              char ***_object_paths)
+{
+    unsigned int count;
+
+    if (names == NULL) {
+        return SSS_SIFP_INVALID_ARGUMENT;
+    }
+
+    for (count = 0; names[count] != NULL; count++);
+
+    return sss_sifp_find_object_list(ctx, path, iface, "FindByNameList",
+                                     DBUS_TYPE_STRING, &names, count,
+                                     _object_paths);
+}
+
+static sss_sifp_error
+sss_sifp_find_objects_by_id(sss_sifp_ctx *ctx,
+                            const char *path,
+                            const char *iface,
+                            const uint32_t *ids,
+                            unsigned int count,
+                            char ***_object_paths)
+{
+    return sss_sifp_find_object_list(ctx, path, iface, "FindByIDList",
+                                     DBUS_TYPE_UINT32, &ids, count,
+                                     _object_paths);
+}
+
+static sss_sifp_error
+sss_sifp_fetch_objects_attrs(sss_sifp_ctx *ctx,
+                             const char *path,
+                             const char *iface,
+                             const char *iface_object,
+                             const char * const *object_paths,
+                             const char * const *attrs,
+                             sss_sifp_object ***_objects)
+{
+    DBusMessage *msg = NULL;
+    DBusMessage *reply = NULL;
+    unsigned int num_paths;
+    unsigned int num_attrs;
+    sss_sifp_error ret;
+    dbus_bool_t bret;
+
+    if (ctx == NULL || object_paths == NULL || attrs == NULL
+            || _objects == NULL) {
+        return SSS_SIFP_INVALID_ARGUMENT;
+    }
+
+    for (num_paths = 0; object_paths[num_paths] != NULL; num_paths++);
+    for (num_attrs = 0; attrs[num_attrs] != NULL; num_attrs++);
+
+    msg = sss_sifp_create_message(path, iface, "GetAttrs");
+    if (msg == NULL) {
+        ret = SSS_SIFP_OUT_OF_MEMORY;
+        goto done;
+    }
+
+    bret = dbus_message_append_args(msg,
+                                    DBUS_TYPE_ARRAY, DBUS_TYPE_OBJECT_PATH,
+                                    &object_paths, num_paths,
+                                    DBUS_TYPE_ARRAY, DBUS_TYPE_STRING,
+                                    &attrs, num_attrs,
+                                    DBUS_TYPE_INVALID);
+    if (!bret) {
+        ret = SSS_SIFP_OUT_OF_MEMORY;
+        goto done;
+    }
+
+    ret = sss_sifp_send_message(ctx, msg, &reply);
+    if (ret != SSS_SIFP_OK) {
+        goto done;
+    }
+
+    ret = sss_sifp_parse_object_list(ctx, reply, iface_object, object_paths,
+                                     _objects);
+
+done:
+    if (msg != NULL) {
+        dbus_message_unref(msg);
+    }
+
+    if (reply != NULL) {
+        dbus_message_unref(reply);
+    }
+
+    return ret;
+}
+
+sss_sifp_error
+sss_sifp_find_users_by_name(sss_sifp_ctx *ctx,
+                            const char * const *names,
+                            char ***_object_paths)
+{
+    return sss_sifp_find_objects_by_name(ctx, IFP_PATH_USERS, "org.freedesktop.sssd.infopipe.Users",
+                                         names, _object_paths);
+}
+
+sss_sifp_error
+sss_sifp_find_users_by_uid(sss_sifp_ctx *ctx,
+                           const uid_t *uids,
+                           unsigned int num_uids,
+                           char ***_object_paths)
+{
+    uint32_t *ids = NULL;
+    sss_sifp_error ret;
+    unsigned int i;
+
+    if (ctx == NULL || (uids == NULL && num_uids > 0)) {
+        return SSS_SIFP_INVALID_ARGUMENT;
+    }
+
+    ids = _alloc_zero(ctx, uint32_t, num_uids + 1);
+    if (ids == NULL) {
+        return SSS_SIFP_OUT_OF_MEMORY;
+    }
+
+    for (i = 0; i < num_uids; i++) {
+        ids[i] = uids[i];
+    }
+
+    ret = sss_sifp_find_objects_by_id(ctx, IFP_PATH_USERS, "org.freedesktop.sssd.infopipe.Users",
+                                      ids, num_uids, _object_paths);
+
+    _free(ctx, ids);
+
+    return ret;
+}
+
+sss_sifp_error
+sss_sifp_fetch_users_attrs(sss_sifp_ctx *ctx,
+                           const char * const *object_paths,
+                           const char * const *attrs,
+                           sss_sifp_object ***_users)
+{
+    return sss_sifp_fetch_objects_attrs(ctx, IFP_PATH_USERS, "org.freedesktop.sssd.infopipe.Users",
+                                        "org.freedesktop.sssd.infopipe.Users.User",
+                                        object_paths, attrs, _users);
+}
+
+sss_sifp_error
+sss_sifp_find_groups_by_name(sss_sifp_ctx *ctx,
+                             const char * const *names,
+                             char ***_object_paths)
+{
+    return sss_sifp_find_objects_by_name(ctx, IFP_PATH_GROUPS, "org.freedesktop.sssd.infopipe.Groups",
+                                         names, _object_paths);
+}
+
+sss_sifp_error
+sss_sifp_find_groups_by_gid(sss_sifp_ctx *ctx,
+                            const gid_t *gids,
+                            unsigned int num_gids,
+                            char ***_object_paths)
+{
+    uint32_t *ids = NULL;
+    sss_sifp_error ret;
+    unsigned int i;
+
+    if (ctx == NULL || (gids == NULL && num_gids > 0)) {
+        return SSS_SIFP_INVALID_ARGUMENT;
+    }
+
+    ids = _alloc_zero(ctx, uint32_t, num_gids + 1);
+    if (ids == NULL) {
+        return SSS_SIFP_OUT_OF_MEMORY;
+    }
+
+    for (i = 0; i < num_gids; i++) {
+        ids[i] = gids[i];
+    }
+
+    ret = sss_sifp_find_objects_by_id(ctx, IFP_PATH_GROUPS, "org.freedesktop.sssd.infopipe.Groups",
+                                      ids, num_gids, _object_paths);
+
+    _free(ctx, ids);
+
+    return ret;
+}
+
+sss_sifp_error
+sss_sifp_fetch_groups_attrs(sss_sifp_ctx *ctx,
+                            const char * const *object_paths,
+                            const char * const *attrs,
+                            sss_sifp_object ***_groups)
+{
+    return sss_sifp_fetch_objects_attrs(ctx, IFP_PATH_GROUPS, "org.freedesktop.sssd.infopipe.Groups",
+                                        "org.freedesktop.sssd.infopipe.Groups.Group",
+                                        object_paths, attrs, _groups);
+}
@@ -721,3 +721,205 @@ done:
 
     return ret;
 }
+
+/**
+ * DBusMessage format:
+ * dict_entry(string:attr_name, array of string:values)
+ *
+ * Iterator has to point to the dict entry but not inside.
+ */
+static sss_sifp_error
+sss_sifp_parse_string_list_attr(sss_sifp_ctx *ctx,
+                                DBusMessageIter *iter,
+                                sss_sifp_attr **_attr)
+{
+    DBusMessageIter dict_iter;
+    DBusMessageIter array_iter;
+    sss_sifp_attr *attr = NULL;
+    const char *name = NULL;
+    const char *value = NULL;
+    sss_sifp_error ret;
+    unsigned int i;
+
+    dbus_message_iter_recurse(iter, &dict_iter);
+
+    /* get the key */
+    check_dbus_arg(&dict_iter, DBUS_TYPE_STRING, ret, done);
+    dbus_message_iter_get_basic(&dict_iter, &name);
+
+    if (!dbus_message_iter_next(&dict_iter)) {
+        ret = SSS_SIFP_INTERNAL_ERROR;
+        goto done;
+    }
+
+    /* now read the values */
+    check_dbus_arg(&dict_iter, DBUS_TYPE_ARRAY, ret, done);
+    if (dbus_message_iter_get_element_type(&dict_iter) != DBUS_TYPE_STRING) {
+        ret = SSS_SIFP_INTERNAL_ERROR;
+        goto done;
+    }
+
+    attr = _alloc_zero(ctx, sss_sifp_attr, 1);
+    if (attr == NULL) {
+        ret = SSS_SIFP_OUT_OF_MEMORY;
+        goto done;
+    }
+
+    attr->type = SSS_SIFP_ATTR_TYPE_STRING;
+    attr->name = sss_sifp_strdup(ctx, name);
+    if (attr->name == NULL) {
+        ret = SSS_SIFP_OUT_OF_MEMORY;
+        goto done;
+    }
+
+    attr->num_values = sss_sifp_get_array_length(&dict_iter);
+    if (attr->num_values == 0) {
+        *_attr = attr;
+        ret = SSS_SIFP_OK;
+        goto done;
+    }
+
+    attr->data.str = _alloc_zero(ctx, char *, attr->num_values);
+    if (attr->data.str == NULL) {
+        ret = SSS_SIFP_OUT_OF_MEMORY;
+        goto done;
+    }
+
+    dbus_message_iter_recurse(&dict_iter, &array_iter);
+    for (i = 0; i < attr->num_values; i++) {
+        dbus_message_iter_get_basic(&array_iter, &value);
+        attr->data.str[i] = sss_sifp_strdup(ctx, value);
+        if (attr->data.str[i] == NULL) {
+            ret = SSS_SIFP_OUT_OF_MEMORY;
+            goto done;
+        }
+
+        dbus_message_iter_next(&array_iter);
+    }
+
+    *_attr = attr;
+    ret = SSS_SIFP_OK;
+
+done:
+    if (ret != SSS_SIFP_OK && attr != NULL) {
+        if (attr->data.str != NULL) {
+            for (i = 0; i < attr->num_values; i++) {
+                if (attr->data.str[i] != NULL) {
+                    _free(ctx, attr->data.str[i]);
+                }
+            }
+            _free(ctx, attr->data.str);
+        }
+        if (attr->name != NULL) {
+            _free(ctx, attr->name);
+        }
+        _free(ctx, attr);
+    }
+
+    return ret;
+}
+
+/**
+ * DBusMessage format:
+ * array of array of dict_entry(string:attr_name, array of string:values)
+ *
+ * The message contains one dictionary for each object path.
+ */
+sss_sifp_error
+sss_sifp_parse_object_list(sss_sifp_ctx *ctx,
+                           DBusMessage *msg,
+                           const char *interface,
+                           const char * const *object_paths,
+                           sss_sifp_object ***_objects)
+{
+    DBusMessageIter iter;
+    DBusMessageIter array_iter;
+    DBusMessageIter dict_iter;
+    sss_sifp_object **objects = NULL;
+    sss_sifp_object *object;
+    const char *name = NULL;
+    unsigned int num_objects;
+    unsigned int num_paths;
+    unsigned int num_attrs;
+    sss_sifp_error ret;
+    unsigned int i;
+    unsigned int j;
+
+    for (num_paths = 0; object_paths[num_paths] != NULL; num_paths++);
+
+    dbus_message_iter_init(msg, &iter);
+
+    check_dbus_arg(&iter, DBUS_TYPE_ARRAY, ret, done);
+
+    num_objects = sss_sifp_get_array_length(&iter);
+    if (num_objects != num_paths) {
+        ret = SSS_SIFP_INTERNAL_ERROR;
+        goto done;
+    }
+
+    objects = _alloc_zero(ctx, sss_sifp_object *, num_objects + 1);
+    if (objects == NULL) {
+        ret = SSS_SIFP_OUT_OF_MEMORY;
+        goto done;
+    }
+
+    dbus_message_iter_recurse(&iter, &array_iter);
+
+    for (i = 0; i < num_objects; i++) {
+        check_dbus_arg(&array_iter, DBUS_TYPE_ARRAY, ret, done);
+
+        object = _alloc_zero(ctx, sss_sifp_object, 1);
+        if (object == NULL) {
+            ret = SSS_SIFP_OUT_OF_MEMORY;
+            goto done;
+        }
+        objects[i] = object;
+
+        object->object_path = sss_sifp_strdup(ctx, object_paths[i]);
+        object->interface = sss_sifp_strdup(ctx, interface);
+        if (object->object_path == NULL || object->interface == NULL) {
+            ret = SSS_SIFP_OUT_OF_MEMORY;
+            goto done;
+        }
+
+        num_attrs = sss_sifp_get_array_length(&array_iter);
+        object->attrs = _alloc_zero(ctx, sss_sifp_attr *, num_attrs + 1);
+        if (object->attrs == NULL) {
+            ret = SSS_SIFP_OUT_OF_MEMORY;
+            goto done;
+        }
+
+        dbus_message_iter_recurse(&array_iter, &dict_iter);
+        for (j = 0; j < num_attrs; j++) {
+            ret = sss_sifp_parse_string_list_attr(ctx, &dict_iter,
+                                                  &object->attrs[j]);
+            if (ret != SSS_SIFP_OK) {
+                goto done;
+            }
+
+            dbus_message_iter_next(&dict_iter);
+        }
+
+        /* the name is only known if it was requested */
+        ret = sss_sifp_find_attr_as_string(object->attrs, "name", &name);
+        if (ret == SSS_SIFP_OK) {
+            object->name = sss_sifp_strdup(ctx, name);
+            if (object->name == NULL) {
+                ret = SSS_SIFP_OUT_OF_MEMORY;
+                goto done;
+            }
+        }
+
+        dbus_message_iter_next(&array_iter);
+    }
+
+    *_objects = objects;
+    ret = SSS_SIFP_OK;
+
+done:
+    if (ret != SSS_SIFP_OK) {
+        sss_sifp_free_objects(ctx, &objects);
+    }
+
+    return ret;
+}
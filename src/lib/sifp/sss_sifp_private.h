@@ -109,4 +109,11 @@ sss_sifp_parse_object_path_list(sss_sifp_ctx *ctx,
                                 DBusMessage *msg,
                                 char ***_object_paths);
 
+sss_sifp_error
+sss_sifp_parse_object_list(sss_sifp_ctx *ctx,
+                           DBusMessage *msg,
+                           const char *interface,
+                           const char * const *object_paths,
+                           sss_sifp_object ***_objects);
+
 #endif /* SSS_SIFP_PRIVATE_H_ */
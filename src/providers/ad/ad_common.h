@@ -56,6 +56,7 @@ enum ad_basic_opt {
     AD_GPO_IMPLICIT_DENY,
     AD_GPO_IGNORE_UNREADABLE,
     AD_GPO_CACHE_TIMEOUT,
+    AD_GPO_DECISION_CACHE_TIMEOUT,
     AD_GPO_MAP_INTERACTIVE,
     AD_GPO_MAP_REMOTE_INTERACTIVE,
     AD_GPO_MAP_NETWORK,
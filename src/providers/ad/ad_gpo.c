@@ -1754,6 +1754,312 @@ ad_gpo_perform_hbac_processing(TALLOC_CTX *mem_ctx,
     return ret;
 }
 
+/* == GPO access decision cache ============================================ */
+
+/*
+ * The result of a GPO-based access check only depends on the GPOs linked to
+ * the SOMs of the host, their content and security descriptors and on the
+ * SIDs of the user. Each result is remembered for the service map type, host
+ * and set of SIDs. Before a remembered result is used, a single LDAP search
+ * checks if any Group Policy container, organizational unit, the domain
+ * object or the computer account changed since the result was computed.
+ * Every detected change discards all remembered results.
+ */
+
+#define AD_GPO_DECISION_CACHE_SIZE 1024
+
+/* whenChanged is set by the server, allow for the maximal Kerberos clock
+ * skew between the server and this host */
+#define AD_GPO_DECISION_CLOCK_SKEW 300
+
+struct ad_gpo_decision {
+    struct ad_gpo_decision *prev;
+    struct ad_gpo_decision *next;
+
+    char *key;
+    errno_t result;
+    /* GPOs with security settings the result is based on */
+    const char **gpo_guids;
+    int num_gpo_guids;
+    time_t created;
+    time_t expire;
+};
+
+struct ad_gpo_decision_cache {
+    hash_table_t *table;
+    /* Oldest entry first. */
+    struct ad_gpo_decision *entries;
+    uint32_t count;
+    time_t timeout;
+
+    uint64_t hits;
+    uint64_t misses;
+};
+
+errno_t ad_gpo_decision_cache_init(struct ad_access_ctx *access_ctx,
+                                   int timeout)
+{
+    struct ad_gpo_decision_cache *cache;
+    errno_t ret;
+
+    if (timeout <= 0) {
+        DEBUG(SSSDBG_CONF_SETTINGS, "GPO decision cache is disabled\n");
+        access_ctx->gpo_decision_cache = NULL;
+        return EOK;
+    }
+
+    cache = talloc_zero(access_ctx, struct ad_gpo_decision_cache);
+    if (cache == NULL) {
+        return ENOMEM;
+    }
+
+    ret = sss_hash_create(cache, AD_GPO_DECISION_CACHE_SIZE, &cache->table);
+    if (ret != EOK) {
+        talloc_free(cache);
+        return ret;
+    }
+
+    cache->timeout = timeout;
+
+    access_ctx->gpo_decision_cache = cache;
+    return EOK;
+}
+
+static int ad_gpo_sid_cmp(const void *a, const void *b)
+{
+    return strcmp(*(const char * const *)a, *(const char * const *)b);
+}
+
+/*
+ * The group SIDs are sorted so that the key does not depend on the order
+ * of the user's groups in the cache.
+ */
+static char *
+ad_gpo_decision_key(TALLOC_CTX *mem_ctx,
+                    enum gpo_map_type gpo_map_type,
+                    const char *host,
+                    const char *user_sid,
+                    const char **group_sids,
+                    int group_size)
+{
+    const char **sorted;
+    char *key;
+    int i;
+
+    sorted = talloc_memdup(mem_ctx, group_sids,
+                           sizeof(const char *) * group_size);
+    if (sorted == NULL && group_size > 0) {
+        return NULL;
+    }
+    qsort(sorted, group_size, sizeof(const char *), ad_gpo_sid_cmp);
+
+    key = talloc_asprintf(mem_ctx, "%d:%s:%s", gpo_map_type,
+                          host != NULL ? host : "", user_sid);
+    for (i = 0; key != NULL && i < group_size; i++) {
+        key = talloc_asprintf_append(key, "%s%s", i == 0 ? ":" : ",",
+                                     sorted[i]);
+    }
+
+    talloc_free(sorted);
+    return key;
+}
+
+static void ad_gpo_decision_remove(struct ad_gpo_decision_cache *cache,
+                                   struct ad_gpo_decision *entry)
+{
+    hash_key_t key;
+    int hret;
+
+    key.type = HASH_KEY_STRING;
+    key.str = entry->key;
+
+    hret = hash_delete(cache->table, &key);
+    if (hret != HASH_SUCCESS) {
+        DEBUG(SSSDBG_CRIT_FAILURE,
+              "Unable to remove GPO decision [%d]: %s\n",
+              hret, hash_error_string(hret));
+    }
+
+    DLIST_REMOVE(cache->entries, entry);
+    cache->count--;
+    talloc_free(entry);
+}
+
+static void ad_gpo_decision_flush(struct ad_gpo_decision_cache *cache)
+{
+    if (cache == NULL) {
+        return;
+    }
+
+    DEBUG(SSSDBG_TRACE_FUNC, "Flushing %"PRIu32" GPO decisions\n",
+          cache->count);
+
+    while (cache->entries != NULL) {
+        ad_gpo_decision_remove(cache, cache->entries);
+    }
+}
+
+/* Returns the unexpired entry for the key, it still has to be validated
+ * against the server before it is used. */
+static struct ad_gpo_decision *
+ad_gpo_decision_get(struct ad_gpo_decision_cache *cache, const char *str)
+{
+    struct ad_gpo_decision *entry;
+    hash_key_t key;
+    hash_value_t value;
+    int hret;
+
+    if (cache == NULL || str == NULL) {
+        return NULL;
+    }
+
+    key.type = HASH_KEY_STRING;
+    key.str = discard_const(str);
+
+    hret = hash_lookup(cache->table, &key, &value);
+    if (hret != HASH_SUCCESS) {
+        if (hret != HASH_ERROR_KEY_NOT_FOUND) {
+            DEBUG(SSSDBG_MINOR_FAILURE, "hash_lookup failed [%d]: %s\n",
+                  hret, hash_error_string(hret));
+        }
+        return NULL;
+    }
+
+    entry = talloc_get_type(value.ptr, struct ad_gpo_decision);
+    if (entry->expire < time(NULL)) {
+        ad_gpo_decision_remove(cache, entry);
+        return NULL;
+    }
+
+    return entry;
+}
+
+static void ad_gpo_decision_put(struct ad_gpo_decision_cache *cache,
+                                const char *key,
+                                errno_t result,
+                                const char **gpo_guids,
+                                int num_gpo_guids)
+{
+    struct ad_gpo_decision *entry;
+    hash_key_t hkey;
+    hash_value_t value;
+    int hret;
+    int i;
+
+    if (cache == NULL || key == NULL) {
+        return;
+    }
+
+    entry = ad_gpo_decision_get(cache, key);
+    if (entry != NULL) {
+        ad_gpo_decision_remove(cache, entry);
+    }
+
+    while (cache->count >= AD_GPO_DECISION_CACHE_SIZE) {
+        ad_gpo_decision_remove(cache, cache->entries);
+    }
+
+    /* Failures are not fatal, the decision just won't be cached. */
+    entry = talloc_zero(cache, struct ad_gpo_decision);
+    if (entry == NULL) {
+        return;
+    }
+
+    entry->key = talloc_strdup(entry, key);
+    entry->gpo_guids = talloc_zero_array(entry, const char *,
+                                         num_gpo_guids + 1);
+    if (entry->key == NULL || entry->gpo_guids == NULL) {
+        talloc_free(entry);
+        return;
+    }
+
+    for (i = 0; i < num_gpo_guids; i++) {
+        entry->gpo_guids[i] = talloc_strdup(entry->gpo_guids, gpo_guids[i]);
+        if (entry->gpo_guids[i] == NULL) {
+            talloc_free(entry);
+            return;
+        }
+    }
+    entry->num_gpo_guids = num_gpo_guids;
+    entry->result = result;
+    entry->created = time(NULL);
+    entry->expire = entry->created + cache->timeout;
+
+    hkey.type = HASH_KEY_STRING;
+    hkey.str = entry->key;
+    value.type = HASH_VALUE_PTR;
+    value.ptr = entry;
+
+    hret = hash_enter(cache->table, &hkey, &value);
+    if (hret != HASH_SUCCESS) {
+        DEBUG(SSSDBG_MINOR_FAILURE, "hash_enter failed [%d]: %s\n",
+              hret, hash_error_string(hret));
+        talloc_free(entry);
+        return;
+    }
+
+    DLIST_ADD_END(cache->entries, entry, struct ad_gpo_decision *);
+    cache->count++;
+}
+
+static void ad_gpo_decision_account(struct ad_gpo_decision_cache *cache,
+                                    bool hit)
+{
+    if (hit) {
+        cache->hits++;
+    } else {
+        cache->misses++;
+    }
+
+    DEBUG(SSSDBG_TRACE_FUNC, "GPO decision cache %s (%"PRIu64" hits, "
+          "%"PRIu64" misses)\n", hit ? "hit" : "miss",
+          cache->hits, cache->misses);
+}
+
+/*
+ * Builds the filter matching the objects whose modification can change
+ * a GPO access decision made at the given time.
+ */
+static errno_t
+ad_gpo_decision_changed_filter(TALLOC_CTX *mem_ctx,
+                               time_t since,
+                               const char *sam_account_name,
+                               char **_filter)
+{
+    char *sanitized;
+    char timestamp[32];
+    struct tm tm;
+    char *filter;
+    errno_t ret;
+
+    since -= AD_GPO_DECISION_CLOCK_SKEW;
+    if (gmtime_r(&since, &tm) == NULL
+            || strftime(timestamp, sizeof(timestamp),
+                        "%Y%m%d%H%M%S.0Z", &tm) == 0) {
+        return EINVAL;
+    }
+
+    ret = sss_filter_sanitize(mem_ctx, sam_account_name, &sanitized);
+    if (ret != EOK) {
+        return ret;
+    }
+
+    filter = talloc_asprintf(mem_ctx,
+                             "(&(whenChanged>=%s)"
+                             "(|(objectclass=groupPolicyContainer)"
+                             "(objectclass=organizationalUnit)"
+                             "(objectclass=domainDNS)"
+                             "(sAMAccountName=%s)))",
+                             timestamp, sanitized);
+    talloc_free(sanitized);
+    if (filter == NULL) {
+        return ENOMEM;
+    }
+
+    *_filter = filter;
+    return EOK;
+}
+
 /* == ad_gpo_access_send/recv implementation ================================*/
 
 struct ad_gpo_access_state {
@@ -1775,6 +2081,14 @@ struct ad_gpo_access_state {
     const char *ad_hostname;
     const char *host_sid;
     const char *target_dn;
+    const char *sam_account_name;
+    char *domain_dn;
+    /* key in the GPO decision cache, NULL if the decision is not cached */
+    char *decision_key;
+    bool have_decision;
+    errno_t decision_result;
+    time_t decision_time;
+    const char **cse_filtered_gpo_guids;
     struct gp_gpo **dacl_filtered_gpos;
     int num_dacl_filtered_gpos;
     struct gp_gpo **cse_filtered_gpos;
@@ -1783,6 +2097,9 @@ struct ad_gpo_access_state {
 };
 
 static void ad_gpo_connect_done(struct tevent_req *subreq);
+static errno_t ad_gpo_decision_check(struct tevent_req *req);
+static void ad_gpo_decision_check_done(struct tevent_req *subreq);
+static errno_t ad_gpo_target_dn_search(struct tevent_req *req);
 static void ad_gpo_target_dn_retrieval_done(struct tevent_req *subreq);
 static void ad_gpo_process_som_done(struct tevent_req *subreq);
 static void ad_gpo_process_gpo_done(struct tevent_req *subreq);
@@ -1791,6 +2108,64 @@ static errno_t ad_gpo_cse_step(struct tevent_req *req);
 static void ad_gpo_cse_done(struct tevent_req *subreq);
 static void ad_gpo_get_host_sid_retrieval_done(struct tevent_req *subreq);
 
+static void
+ad_gpo_decision_lookup(struct ad_gpo_access_state *state)
+{
+    struct ad_gpo_decision_cache *cache = state->access_ctx->gpo_decision_cache;
+    struct ad_gpo_decision *entry;
+    const char *user_sid = NULL;
+    const char **group_sids = NULL;
+    int group_size = 0;
+    errno_t ret;
+    int i;
+
+    ret = ad_gpo_get_sids(state, state->user, state->user_domain,
+                          &user_sid, &group_sids, &group_size);
+    if (ret != EOK || user_sid == NULL) {
+        DEBUG(SSSDBG_MINOR_FAILURE,
+              "Unable to get SIDs of [%s], the GPO decision won't be "
+              "cached\n", state->user);
+        return;
+    }
+
+    state->decision_key = ad_gpo_decision_key(state, state->gpo_map_type,
+                                              state->ad_hostname, user_sid,
+                                              group_sids, group_size);
+    talloc_free(group_sids);
+    if (state->decision_key == NULL) {
+        return;
+    }
+
+    entry = ad_gpo_decision_get(cache, state->decision_key);
+    if (entry == NULL) {
+        ad_gpo_decision_account(cache, false);
+        return;
+    }
+
+    for (i = 0; i < entry->num_gpo_guids; i++) {
+        DEBUG(SSSDBG_TRACE_FUNC, "Cached decision is based on GPO %s\n",
+              entry->gpo_guids[i]);
+    }
+
+    state->have_decision = true;
+    state->decision_result = entry->result;
+    state->decision_time = entry->created;
+}
+
+static void
+ad_gpo_decision_store(struct ad_gpo_access_state *state, errno_t result)
+{
+    if (result != EOK && result != ERR_ACCESS_DENIED) {
+        return;
+    }
+
+    ad_gpo_decision_put(state->access_ctx->gpo_decision_cache,
+                        state->decision_key, result,
+                        state->cse_filtered_gpo_guids,
+                        state->cse_filtered_gpo_guids == NULL ?
+                                0 : state->num_cse_filtered_gpos);
+}
+
 struct tevent_req *
 ad_gpo_access_send(TALLOC_CTX *mem_ctx,
                    struct tevent_context *ev,
@@ -1896,6 +2271,14 @@ ad_gpo_access_send(TALLOC_CTX *mem_ctx,
     state->opts = ctx->sdap_access_ctx->id_ctx->opts;
     state->timeout = dp_opt_get_int(state->opts->basic, SDAP_SEARCH_TIMEOUT);
     state->conn = ad_get_dom_ldap_conn(ctx->ad_id_ctx, state->host_domain);
+
+    /* In permissive mode every would-be denial has to be logged, so the
+     * decisions are only cached when enforcing. */
+    if (ctx->gpo_decision_cache != NULL
+            && state->gpo_mode == GPO_ACCESS_CONTROL_ENFORCING) {
+        ad_gpo_decision_lookup(state);
+    }
+
     state->sdap_op = sdap_id_op_create(state, state->conn->conn_cache);
     if (state->sdap_op == NULL) {
         DEBUG(SSSDBG_OP_FAILURE, "sdap_id_op_create failed.\n");
@@ -1961,16 +2344,11 @@ ad_gpo_connect_done(struct tevent_req *subreq)
 {
     struct tevent_req *req;
     struct ad_gpo_access_state *state;
-    char *filter;
-    const char *sam_account_name;
-    char *domain_dn;
     int dp_error;
     errno_t ret;
     char *server_uri;
     LDAPURLDesc *lud;
 
-    const char *attrs[] = {AD_AT_DN, AD_AT_UAC, NULL};
-
     req = tevent_req_callback_data(subreq, struct tevent_req);
     state = tevent_req_data(req, struct ad_gpo_access_state);
 
@@ -2034,16 +2412,18 @@ ad_gpo_connect_done(struct tevent_req *subreq)
 
     /* SDAP_SASL_AUTHID contains the name used for kinit and SASL bind which
      * in the AD case is the NetBIOS name. */
-    sam_account_name = dp_opt_get_string(state->opts->basic, SDAP_SASL_AUTHID);
-    if (sam_account_name == NULL) {
+    state->sam_account_name = dp_opt_get_string(state->opts->basic,
+                                                SDAP_SASL_AUTHID);
+    if (state->sam_account_name == NULL) {
         ret = ENOMEM;
         goto done;
     }
 
-    DEBUG(SSSDBG_TRACE_FUNC, "sam_account_name is %s\n", sam_account_name);
+    DEBUG(SSSDBG_TRACE_FUNC, "sam_account_name is %s\n",
+          state->sam_account_name);
 
     /* Convert the domain name into domain DN */
-    ret = domain_to_basedn(state, state->host_domain->name, &domain_dn);
+    ret = domain_to_basedn(state, state->host_domain->name, &state->domain_dn);
     if (ret != EOK) {
         DEBUG(SSSDBG_OP_FAILURE,
               "Cannot convert domain name [%s] to base DN [%d]: %s\n",
@@ -2051,39 +2431,143 @@ ad_gpo_connect_done(struct tevent_req *subreq)
         goto done;
     }
 
+    if (state->have_decision) {
+        ret = ad_gpo_decision_check(req);
+    } else {
+        ret = ad_gpo_target_dn_search(req);
+    }
+
+ done:
+
+    if (ret != EOK) {
+        tevent_req_error(req, ret);
+    }
+}
+
+/*
+ * Searches for objects changed since the cached decision was made. If there
+ * are none the decision is used, otherwise the access is evaluated again.
+ */
+static errno_t
+ad_gpo_decision_check(struct tevent_req *req)
+{
+    struct tevent_req *subreq;
+    struct ad_gpo_access_state *state;
+    char *filter;
+    errno_t ret;
+
+    const char *attrs[] = {AD_AT_DN, NULL};
+
+    state = tevent_req_data(req, struct ad_gpo_access_state);
+
+    ret = ad_gpo_decision_changed_filter(state, state->decision_time,
+                                         state->sam_account_name, &filter);
+    if (ret != EOK) {
+        DEBUG(SSSDBG_OP_FAILURE,
+              "Unable to build the GPO change filter [%d]: %s\n",
+              ret, sss_strerror(ret));
+        return ret;
+    }
+
+    subreq = sdap_get_generic_send(state, state->ev, state->opts,
+                                   sdap_id_op_handle(state->sdap_op),
+                                   state->domain_dn, LDAP_SCOPE_SUBTREE,
+                                   filter, attrs, NULL, 0,
+                                   state->timeout,
+                                   false);
+    if (subreq == NULL) {
+        DEBUG(SSSDBG_OP_FAILURE, "sdap_get_generic_send failed.\n");
+        return EIO;
+    }
+
+    tevent_req_set_callback(subreq, ad_gpo_decision_check_done, req);
+
+    return EOK;
+}
+
+static void
+ad_gpo_decision_check_done(struct tevent_req *subreq)
+{
+    struct tevent_req *req;
+    struct ad_gpo_access_state *state;
+    struct ad_gpo_decision_cache *cache;
+    struct sysdb_attrs **reply;
+    size_t reply_count;
+    int dp_error;
+    errno_t ret;
+
+    req = tevent_req_callback_data(subreq, struct tevent_req);
+    state = tevent_req_data(req, struct ad_gpo_access_state);
+    cache = state->access_ctx->gpo_decision_cache;
+
+    ret = sdap_get_generic_recv(subreq, state, &reply_count, &reply);
+    talloc_zfree(subreq);
+    if (ret != EOK) {
+        /* the full evaluation handles a lost connection */
+        DEBUG(SSSDBG_MINOR_FAILURE,
+              "Unable to check for GPO changes [%d]: %s\n",
+              ret, sss_strerror(ret));
+        ad_gpo_decision_account(cache, false);
+    } else if (reply_count > 0) {
+        DEBUG(SSSDBG_TRACE_FUNC,
+              "%zu GPO related objects changed, discarding cached "
+              "decisions\n", reply_count);
+        ad_gpo_decision_flush(cache);
+        ad_gpo_decision_account(cache, false);
+    } else {
+        ad_gpo_decision_account(cache, true);
+        sdap_id_op_done(state->sdap_op, EOK, &dp_error);
+
+        if (state->decision_result == EOK) {
+            tevent_req_done(req);
+        } else {
+            tevent_req_error(req, state->decision_result);
+        }
+        return;
+    }
+
+    ret = ad_gpo_target_dn_search(req);
+    if (ret != EOK) {
+        tevent_req_error(req, ret);
+    }
+}
+
+static errno_t
+ad_gpo_target_dn_search(struct tevent_req *req)
+{
+    struct tevent_req *subreq;
+    struct ad_gpo_access_state *state;
+    char *filter;
+
+    const char *attrs[] = {AD_AT_DN, AD_AT_UAC, NULL};
+
+    state = tevent_req_data(req, struct ad_gpo_access_state);
+
     /* SDAP_OC_USER objectclass covers both users and computers */
     filter = talloc_asprintf(state,
                              "(&(objectclass=%s)(%s=%s))",
                              state->opts->user_map[SDAP_OC_USER].name,
                              state->opts->user_map[SDAP_AT_USER_NAME].name,
-                             sam_account_name);
+                             state->sam_account_name);
     if (filter == NULL) {
-        ret = ENOMEM;
-        goto done;
+        return ENOMEM;
     }
 
     subreq = sdap_get_generic_send(state, state->ev, state->opts,
                                    sdap_id_op_handle(state->sdap_op),
-                                   domain_dn, LDAP_SCOPE_SUBTREE,
+                                   state->domain_dn, LDAP_SCOPE_SUBTREE,
                                    filter, attrs, NULL, 0,
                                    state->timeout,
                                    false);
 
     if (subreq == NULL) {
         DEBUG(SSSDBG_OP_FAILURE, "sdap_get_generic_send failed.\n");
-        ret = EIO;
-        goto done;
+        return EIO;
     }
 
     tevent_req_set_callback(subreq, ad_gpo_target_dn_retrieval_done, req);
 
-    ret = EOK;
-
- done:
-
-    if (ret != EOK) {
-        tevent_req_error(req, ret);
-    }
+    return EOK;
 }
 
 static void
@@ -2577,6 +3061,7 @@ ad_gpo_process_gpo_done(struct tevent_req *subreq)
 
     DEBUG(SSSDBG_TRACE_FUNC, "num_cse_filtered_gpos: %d\n",
           state->num_cse_filtered_gpos);
+    state->cse_filtered_gpo_guids = cse_filtered_gpo_guids;
 
     /*
      * before we start processing each gpo, we delete the GPO Result object
@@ -2602,6 +3087,10 @@ ad_gpo_process_gpo_done(struct tevent_req *subreq)
 
  done:
 
+    if (ret != EAGAIN) {
+        ad_gpo_decision_store(state, ret);
+    }
+
     if (ret == EOK) {
         tevent_req_done(req);
     } else if (ret != EAGAIN) {
@@ -2780,6 +3269,10 @@ ad_gpo_cse_done(struct tevent_req *subreq)
 
  done:
 
+    if (ret != EAGAIN) {
+        ad_gpo_decision_store(state, ret);
+    }
+
     if (ret == EOK) {
         tevent_req_done(req);
     } else if (ret != EAGAIN) {
@@ -267,6 +267,8 @@ static errno_t ad_init_sdap_access_ctx(struct ad_access_ctx *access_ctx)
 }
 
 errno_t ad_gpo_parse_map_options(struct ad_access_ctx *access_ctx);
+errno_t ad_gpo_decision_cache_init(struct ad_access_ctx *access_ctx,
+                                   int timeout);
 
 static errno_t ad_init_gpo(struct ad_access_ctx *access_ctx)
 {
@@ -313,6 +315,16 @@ static errno_t ad_init_gpo(struct ad_access_ctx *access_ctx)
         return ret;
     }
 
+    /* GPO access decision cache */
+    ret = ad_gpo_decision_cache_init(access_ctx,
+                            dp_opt_get_int(options,
+                                           AD_GPO_DECISION_CACHE_TIMEOUT));
+    if (ret != EOK) {
+        DEBUG(SSSDBG_FATAL_FAILURE, "Could not create the GPO decision "
+              "cache [%d]: %s\n", ret, sss_strerror(ret));
+        return ret;
+    }
+
     return EOK;
 }
 
@@ -268,6 +268,9 @@ enum dp_res_opts {
     DP_RES_OPT_RESOLVER_OP_TIMEOUT,
     DP_RES_OPT_RESOLVER_SERVER_TIMEOUT,
     DP_RES_OPT_DNS_DOMAIN,
+    DP_RES_OPT_SERVER_SELECTION,
+    DP_RES_OPT_RESOLVER_USE_CACHE,
+    DP_RES_OPT_RESOLVER_CACHE_NEG_TIMEOUT,
 
     DP_RES_OPTS /* attrs counter */
 };
@@ -56,6 +56,7 @@ dp_init_interface(struct data_provider *provider)
         SBUS_METHODS(
             SBUS_SYNC(METHOD, sssd_DataProvider_Failover, ListServices, dp_failover_list_services, provider->be_ctx),
             SBUS_SYNC(METHOD, sssd_DataProvider_Failover, ListServers, dp_failover_list_servers, provider->be_ctx),
+            SBUS_SYNC(METHOD, sssd_DataProvider_Failover, ListServerLatencies, dp_failover_list_server_latencies, provider->be_ctx),
             SBUS_SYNC(METHOD, sssd_DataProvider_Failover, ActiveServer, dp_failover_active_server, provider->be_ctx)
         ),
         SBUS_SIGNALS(SBUS_NO_SIGNALS),
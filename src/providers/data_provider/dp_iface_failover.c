@@ -326,3 +326,30 @@ dp_failover_list_servers(TALLOC_CTX *mem_ctx,
 
     return EOK;
 }
+
+errno_t
+dp_failover_list_server_latencies(TALLOC_CTX *mem_ctx,
+                                  struct sbus_request *sbus_req,
+                                  struct be_ctx *be_ctx,
+                                  const char *service_name,
+                                  const char ***_servers,
+                                  uint32_t **_rtt_usec)
+{
+    struct be_svc_data *svc;
+    bool found = false;
+
+    DLIST_FOR_EACH(svc, be_ctx->be_fo->svcs) {
+        if (strcmp(svc->name, service_name) == 0) {
+            found = true;
+            break;
+        }
+    }
+
+    if (!found) {
+        DEBUG(SSSDBG_CRIT_FAILURE, "Unable to get server list\n");
+        return ENOENT;
+    }
+
+    return fo_svc_server_rtt_list(sbus_req, svc->fo_service,
+                                  _servers, _rtt_usec);
+}
@@ -44,12 +44,30 @@ int be_fo_is_srv_identifier(const char *server)
 static int be_fo_get_options(struct be_ctx *ctx,
                              struct fo_options *opts)
 {
+    const char *str_selection;
+
     opts->service_resolv_timeout = dp_opt_get_int(ctx->be_res->opts,
                                                   DP_RES_OPT_RESOLVER_TIMEOUT);
     opts->retry_timeout = 30;
     opts->srv_retry_neg_timeout = 15;
     opts->family_order = ctx->be_res->family_order;
 
+    str_selection = dp_opt_get_string(ctx->be_res->opts,
+                                      DP_RES_OPT_SERVER_SELECTION);
+    if (strcasecmp(str_selection, "order") == 0) {
+        opts->selection_policy = FO_SELECTION_ORDER;
+    } else if (strcasecmp(str_selection, "latency") == 0) {
+        opts->selection_policy = FO_SELECTION_LATENCY;
+    } else {
+        DEBUG(SSSDBG_OP_FAILURE,
+              "Unknown value for option failover_server_selection: %s\n",
+              str_selection);
+        return EINVAL;
+    }
+
+    DEBUG(SSSDBG_CONF_SETTINGS, "Failover server selection: %s\n",
+          str_selection);
+
     return EOK;
 }
 
@@ -837,6 +855,9 @@ static struct dp_option dp_res_default_opts[] = {
     { "dns_resolver_op_timeout", DP_OPT_NUMBER, { .number = 3 }, NULL_NUMBER },
     { "dns_resolver_server_timeout", DP_OPT_NUMBER, { .number = 1000 }, NULL_NUMBER },
     { "dns_discovery_domain", DP_OPT_STRING, NULL_STRING, NULL_STRING },
+    { "failover_server_selection", DP_OPT_STRING, { "order" }, NULL_STRING },
+    { "dns_resolver_use_cache", DP_OPT_BOOL, BOOL_TRUE, BOOL_TRUE },
+    { "dns_resolver_cache_negative_timeout", DP_OPT_NUMBER, { .number = 0 }, NULL_NUMBER },
     DP_OPTION_TERMINATOR
 };
 
@@ -905,5 +926,11 @@ errno_t be_res_init(struct be_ctx *ctx)
         return ret;
     }
 
+    resolv_set_cache_options(ctx->be_res->resolv,
+                             dp_opt_get_bool(ctx->be_res->opts,
+                                             DP_RES_OPT_RESOLVER_USE_CACHE),
+                             dp_opt_get_int(ctx->be_res->opts,
+                                       DP_RES_OPT_RESOLVER_CACHE_NEG_TIMEOUT));
+
     return EOK;
 }
@@ -43,6 +43,15 @@
 #define DEFAULT_SERVER_STATUS SERVER_NAME_NOT_RESOLVED
 #define DEFAULT_SRV_STATUS SRV_NEUTRAL
 
+/* Weight of a new round trip time sample is 1/2^FO_RTT_SHIFT. */
+#define FO_RTT_SHIFT 3
+/* Seconds after which the round trip time of a server that was not used
+ * is considered outdated and the server is tried again. */
+#define FO_RTT_LIFETIME 600
+/* Switch to a faster server only if its round trip time is at most
+ * FO_RTT_SWITCH_PERCENT % of the active server's round trip time. */
+#define FO_RTT_SWITCH_PERCENT 80
+
 enum srv_lookup_status {
     SRV_NEUTRAL,        /* We didn't try this SRV lookup yet */
     SRV_RESOLVED,       /* This SRV lookup is resolved       */
@@ -71,6 +80,9 @@ struct fo_service {
     struct fo_server *last_tried_server;
     struct fo_server *server_list;
 
+    /* Round trip times of the servers, see struct fo_rtt. */
+    struct fo_rtt *rtt_list;
+
     /* Function pointed by user_data_cmp returns 0 if user_data is equal
      * or nonzero value if not. Set to NULL if no user data comparison
      * is needed in fail over duplicate servers detection.
@@ -139,6 +151,21 @@ struct status {
     struct timeval last_change;
 };
 
+/* The servers expanded from SRV records are recreated on each refresh,
+ * so the round trip times are kept in the service, keyed by server name
+ * and port. */
+struct fo_rtt {
+    struct fo_rtt *prev;
+    struct fo_rtt *next;
+
+    char *name;
+    int port;
+
+    /* Smoothed round trip time in microseconds. */
+    uint32_t srtt;
+    time_t last_sample;
+};
+
 struct fo_ctx *
 fo_context_init(TALLOC_CTX *mem_ctx, struct fo_options *opts)
 {
@@ -159,6 +186,7 @@ fo_context_init(TALLOC_CTX *mem_ctx, struct fo_options *opts)
     ctx->opts->retry_timeout = opts->retry_timeout;
     ctx->opts->family_order  = opts->family_order;
     ctx->opts->service_resolv_timeout = opts->service_resolv_timeout;
+    ctx->opts->selection_policy = opts->selection_policy;
 
     DEBUG(SSSDBG_TRACE_FUNC,
           "Created new fail over context, retry timeout is %ld\n",
@@ -869,20 +897,130 @@ void fo_ref_server(TALLOC_CTX *ref_ctx,
     }
 }
 
+static struct fo_rtt *
+fo_rtt_find(struct fo_service *service, const char *name, int port)
+{
+    struct fo_rtt *rtt;
+
+    DLIST_FOR_EACH(rtt, service->rtt_list) {
+        if (rtt->port == port && strcasecmp(rtt->name, name) == 0) {
+            return rtt;
+        }
+    }
+
+    return NULL;
+}
+
+/* Returns 0 if the round trip time is not known or is outdated. */
+static uint32_t
+fo_server_current_rtt(struct fo_server *server, time_t now)
+{
+    struct fo_rtt *rtt;
+
+    if (server->common == NULL || server->common->name == NULL) {
+        return 0;
+    }
+
+    rtt = fo_rtt_find(server->service, server->common->name, server->port);
+    if (rtt == NULL || now - rtt->last_sample > FO_RTT_LIFETIME) {
+        return 0;
+    }
+
+    return rtt->srtt;
+}
+
+/*
+ * Pick the working primary or backup server with the lowest round trip
+ * time. A server without a current sample is returned first so that its
+ * round trip time gets measured. The 'current' server is kept unless
+ * another server is significantly faster, to avoid flapping between
+ * servers with similar round trip times.
+ */
+static struct fo_server *
+get_lowest_rtt_server(struct fo_service *service, bool primary,
+                      struct fo_server *current)
+{
+    struct fo_server *server;
+    struct fo_server *best = NULL;
+    uint32_t current_rtt = 0;
+    uint32_t best_rtt = 0;
+    uint32_t rtt;
+    time_t now;
+
+    now = time(NULL);
+
+    if (current != NULL) {
+        current_rtt = fo_server_current_rtt(current, now);
+        if (current_rtt == 0) {
+            return current;
+        }
+    }
+
+    DLIST_FOR_EACH(server, service->server_list) {
+        if (server->primary != primary) continue;
+
+        /* SRV lookups that were not expanded yet are left to the default
+         * selection. */
+        if (server->common == NULL || server->common->name == NULL) continue;
+
+        if (!service_works(server)) continue;
+
+        rtt = fo_server_current_rtt(server, now);
+        if (rtt == 0) {
+            DEBUG(SSSDBG_TRACE_FUNC, "Round trip time of server '%s' is not "
+                  "known, trying it\n", SERVER_NAME(server));
+            return server;
+        }
+
+        if (best == NULL || rtt < best_rtt) {
+            best = server;
+            best_rtt = rtt;
+        }
+    }
+
+    if (current == NULL || best == NULL || best == current) {
+        return best;
+    }
+
+    if ((uint64_t)best_rtt * 100
+            > (uint64_t)current_rtt * FO_RTT_SWITCH_PERCENT) {
+        return current;
+    }
+
+    DEBUG(SSSDBG_TRACE_FUNC, "Switching from server '%s' (%"PRIu32" us) to "
+          "server '%s' (%"PRIu32" us) with lower round trip time\n",
+          SERVER_NAME(current), current_rtt, SERVER_NAME(best), best_rtt);
+
+    return best;
+}
+
 static int
 get_first_server_entity(struct fo_service *service, struct fo_server **_server)
 {
     struct fo_server *server;
+    bool by_latency;
+
+    by_latency = service->ctx->opts->selection_policy == FO_SELECTION_LATENCY;
 
     /* If we already have a working server, use that one. */
     server = service->active_server;
     if (server != NULL) {
         if (service_works(server) && fo_is_server_primary(server)) {
+            if (by_latency) {
+                server = get_lowest_rtt_server(service, true, server);
+            }
             goto done;
         }
         service->active_server = NULL;
     }
 
+    if (by_latency) {
+        server = get_lowest_rtt_server(service, true, NULL);
+        if (server != NULL) {
+            goto done;
+        }
+    }
+
     /*
      * Otherwise iterate through the server list.
      */
@@ -921,6 +1059,13 @@ get_first_server_entity(struct fo_service *service, struct fo_server **_server)
         }
     }
 
+    if (by_latency) {
+        server = get_lowest_rtt_server(service, false, NULL);
+        if (server != NULL) {
+            goto done;
+        }
+    }
+
     DLIST_FOR_EACH(server, service->server_list) {
         /* Now iterate only over backup servers */
         if (server->primary) continue;
@@ -1756,6 +1901,126 @@ const char **fo_svc_server_list(TALLOC_CTX *mem_ctx,
     return list;
 }
 
+void fo_server_add_rtt_sample(struct fo_server *server,
+                              const struct timeval *start)
+{
+    struct fo_service *service;
+    struct fo_rtt *rtt;
+    struct timeval now;
+    int64_t sample;
+
+    if (server == NULL || server->common == NULL
+            || server->common->name == NULL) {
+        return;
+    }
+    service = server->service;
+
+    gettimeofday(&now, NULL);
+    sample = (now.tv_sec - start->tv_sec) * 1000000LL
+                 + (now.tv_usec - start->tv_usec);
+    if (sample <= 0) {
+        sample = 1;
+    } else if (sample > UINT32_MAX) {
+        sample = UINT32_MAX;
+    }
+
+    rtt = fo_rtt_find(service, server->common->name, server->port);
+    if (rtt == NULL) {
+        rtt = talloc_zero(service, struct fo_rtt);
+        if (rtt == NULL) {
+            return;
+        }
+
+        rtt->name = talloc_strdup(rtt, server->common->name);
+        if (rtt->name == NULL) {
+            talloc_free(rtt);
+            return;
+        }
+        rtt->port = server->port;
+        rtt->srtt = sample;
+        DLIST_ADD(service->rtt_list, rtt);
+    } else if (now.tv_sec - rtt->last_sample > FO_RTT_LIFETIME) {
+        /* The previous samples are too old to be relevant. */
+        rtt->srtt = sample;
+    } else {
+        rtt->srtt += (sample - (int64_t)rtt->srtt) / (1 << FO_RTT_SHIFT);
+    }
+    rtt->last_sample = now.tv_sec;
+
+    DEBUG(SSSDBG_TRACE_INTERNAL, "Round trip time of server '%s' port %d: "
+          "%"PRId64" us, smoothed %"PRIu32" us\n",
+          rtt->name, rtt->port, sample, rtt->srtt);
+}
+
+uint32_t fo_get_server_rtt(struct fo_server *server)
+{
+    struct fo_rtt *rtt;
+
+    if (server == NULL || server->common == NULL
+            || server->common->name == NULL) {
+        return 0;
+    }
+
+    rtt = fo_rtt_find(server->service, server->common->name, server->port);
+    if (rtt == NULL) {
+        return 0;
+    }
+
+    return rtt->srtt;
+}
+
+errno_t fo_svc_server_rtt_list(TALLOC_CTX *mem_ctx,
+                               struct fo_service *service,
+                               const char ***_servers,
+                               uint32_t **_rtt)
+{
+    const char **servers;
+    uint32_t *rtt;
+    struct fo_server *srv;
+    size_t count;
+
+    /* _srv_ placeholders have no name and are not listed */
+    count = 0;
+    DLIST_FOR_EACH(srv, service->server_list) {
+        if (fo_get_server_name(srv) != NULL) {
+            count++;
+        }
+    }
+
+    servers = talloc_zero_array(mem_ctx, const char *, count + 1);
+    if (servers == NULL) {
+        return ENOMEM;
+    }
+
+    /* the length of the array is the number of servers */
+    rtt = talloc_zero_array(mem_ctx, uint32_t, count);
+    if (rtt == NULL) {
+        talloc_free(servers);
+        return ENOMEM;
+    }
+
+    count = 0;
+    DLIST_FOR_EACH(srv, service->server_list) {
+        if (fo_get_server_name(srv) == NULL) {
+            continue;
+        }
+
+        servers[count] = talloc_strdup(servers, fo_get_server_name(srv));
+        if (servers[count] == NULL) {
+            talloc_free(servers);
+            talloc_free(rtt);
+            return ENOMEM;
+        }
+        rtt[count] = fo_get_server_rtt(srv);
+        count++;
+    }
+
+    *_servers = servers;
+    *_rtt = rtt;
+
+    return EOK;
+}
+
 bool fo_set_srv_lookup_plugin(struct fo_ctx *ctx,
                               fo_srv_lookup_plugin_send_t send_fn,
                               fo_srv_lookup_plugin_recv_t recv_fn,
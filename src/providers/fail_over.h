@@ -26,6 +26,8 @@
 #define __FAIL_OVER_H__
 
 #include <stdbool.h>
+#include <stdint.h>
+#include <sys/time.h>
 #include <talloc.h>
 
 #include "resolv/async_resolv.h"
@@ -76,12 +78,22 @@ struct fo_server;
  *
  * The family_order member specifies the order of address families to
  * try when looking up the service.
+ *
+ * The selection_policy member specifies how a server is picked among the
+ * working servers of the same priority, see enum fo_selection_policy.
  */
+enum fo_selection_policy {
+    FO_SELECTION_ORDER,     /* The first working server in the list. */
+    FO_SELECTION_LATENCY    /* The working server with the lowest round
+                             * trip time. */
+};
+
 struct fo_options {
     time_t srv_retry_neg_timeout;
     time_t retry_timeout;
     int service_resolv_timeout;
     enum restrict_family family_order;
+    enum fo_selection_policy selection_policy;
 };
 
 /*
@@ -216,6 +228,31 @@ const char **fo_svc_server_list(TALLOC_CTX *mem_ctx,
                                 struct fo_service *service,
                                 size_t *_count);
 
+/*
+ * Record the time elapsed since 'start' as a round trip time sample of
+ * 'server', e.g. the time needed to connect to the server or to receive
+ * the first reply to an operation. The samples are smoothed into an
+ * exponentially weighted moving average that is kept per server name
+ * and port, so it survives a refresh of the SRV records.
+ */
+void fo_server_add_rtt_sample(struct fo_server *server,
+                              const struct timeval *start);
+
+/*
+ * Return the smoothed round trip time of 'server' in microseconds or 0
+ * if no sample was recorded yet.
+ */
+uint32_t fo_get_server_rtt(struct fo_server *server);
+
+/*
+ * Same as fo_svc_server_list() but also return the smoothed round trip
+ * time of each server in microseconds, 0 if unknown.
+ */
+errno_t fo_svc_server_rtt_list(TALLOC_CTX *mem_ctx,
+                               struct fo_service *service,
+                               const char ***_servers,
+                               uint32_t **_rtt);
+
 /*
  * Folowing functions allow to iterate trough list of servers.
  */
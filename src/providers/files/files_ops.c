@@ -245,10 +245,39 @@ done:
     return ret;
 }
 
-static errno_t delete_all_users(struct sss_domain_info *dom)
+static errno_t add_seen_name(hash_table_t *seen, const char *name)
+{
+    hash_key_t key;
+    hash_value_t value;
+    int hret;
+
+    key.type = HASH_KEY_STRING;
+    key.str = discard_const(name);
+    value.type = HASH_VALUE_UNDEF;
+
+    hret = hash_enter(seen, &key, &value);
+    if (hret != HASH_SUCCESS) {
+        DEBUG(SSSDBG_OP_FAILURE, "Cannot add %s to the table [%d]: %s\n",
+              name, hret, hash_error_string(hret));
+        return ENOMEM;
+    }
+
+    return EOK;
+}
+
+/* Delete the cached users or groups that are not in the files anymore.
+ * The entries that are still there were already updated in place, so
+ * unchanged entries are not rewritten. */
+static errno_t delete_missing_entries(struct sss_domain_info *dom,
+                                      enum sysdb_member_type type,
+                                      hash_table_t *seen)
 {
     TALLOC_CTX *tmp_ctx;
-    struct ldb_dn *base_dn;
+    const char *attrs[] = { SYSDB_NAME, NULL };
+    struct ldb_message **msgs = NULL;
+    size_t count = 0;
+    const char *name;
+    hash_key_t key;
     errno_t ret;
 
     tmp_ctx = talloc_new(NULL);
@@ -257,20 +286,49 @@ static errno_t delete_all_users(struct sss_domain_info *dom)
         return ENOMEM;
     }
 
-    base_dn = sysdb_user_base_dn(tmp_ctx, dom);
-    if (base_dn == NULL) {
-        DEBUG(SSSDBG_CRIT_FAILURE, "Out of memory!\n");
-        ret = ENOMEM;
-        goto done;
+    if (type == SYSDB_MEMBER_USER) {
+        ret = sysdb_search_users(tmp_ctx, dom, "("SYSDB_NAME"=*)", attrs,
+                                 &count, &msgs);
+    } else {
+        ret = sysdb_search_groups(tmp_ctx, dom, "("SYSDB_NAME"=*)", attrs,
+                                  &count, &msgs);
     }
-
-    ret = sysdb_delete_recursive(dom->sysdb, base_dn, true);
-    if (ret != EOK) {
-        DEBUG(SSSDBG_OP_FAILURE, "Unable to delete users subtree [%d]: %s\n",
+    if (ret == ENOENT) {
+        ret = EOK;
+        goto done;
+    } else if (ret != EOK) {
+        DEBUG(SSSDBG_OP_FAILURE, "Unable to list cached %s [%d]: %s\n",
+              type == SYSDB_MEMBER_USER ? "users" : "groups",
               ret, sss_strerror(ret));
         goto done;
     }
 
+    key.type = HASH_KEY_STRING;
+    for (size_t i = 0; i < count; i++) {
+        name = ldb_msg_find_attr_as_string(msgs[i], SYSDB_NAME, NULL);
+        if (name == NULL) {
+            continue;
+        }
+
+        key.str = discard_const(name);
+        if (hash_has_key(seen, &key)) {
+            continue;
+        }
+
+        DEBUG(SSSDBG_TRACE_FUNC, "%s is not in the files anymore, "
+              "deleting it\n", name);
+        if (type == SYSDB_MEMBER_USER) {
+            ret = sysdb_delete_user(dom, name, 0);
+        } else {
+            ret = sysdb_delete_group(dom, name, 0);
+        }
+        if (ret != EOK && ret != ENOENT) {
+            DEBUG(SSSDBG_OP_FAILURE, "Unable to delete %s [%d]: %s\n",
+                  name, ret, sss_strerror(ret));
+            goto done;
+        }
+    }
+
     ret = EOK;
 
 done:
@@ -279,72 +337,68 @@ done:
     return ret;
 }
 
-static errno_t save_file_user(struct files_id_ctx *id_ctx,
-                              struct passwd *pw)
+/* Returns ENOENT for users that are not stored in the cache */
+static errno_t file_user_data(TALLOC_CTX *mem_ctx,
+                              struct files_id_ctx *id_ctx,
+                              struct passwd *pw,
+                              struct sysdb_store_user_data *user)
 {
-    errno_t ret;
     char *fqname;
-    TALLOC_CTX *tmp_ctx = NULL;
-    const char *shell;
-    const char *gecos;
-    struct sysdb_attrs *attrs = NULL;
+    unsigned ri;
 
     if (strcmp(pw->pw_name, "root") == 0
             || pw->pw_uid == 0
             || pw->pw_gid == 0) {
         DEBUG(SSSDBG_TRACE_FUNC, "Skipping %s\n", pw->pw_name);
-        return EOK;
-    }
-
-    tmp_ctx = talloc_new(NULL);
-    if (tmp_ctx == NULL) {
-        return ENOMEM;
+        return ENOENT;
     }
 
-    fqname = sss_create_internal_fqname(tmp_ctx, pw->pw_name,
+    fqname = sss_create_internal_fqname(mem_ctx, pw->pw_name,
                                         id_ctx->domain->name);
     if (fqname == NULL) {
-        ret = ENOMEM;
-        goto done;
+        return ENOMEM;
     }
 
-    attrs = sysdb_new_attrs(tmp_ctx);
-    if (attrs == NULL) {
-        ret = ENOMEM;
-        goto done;
-    }
+    user->name = fqname;
+    user->pwd = pw->pw_passwd;
+    user->uid = pw->pw_uid;
+    user->gid = pw->pw_gid;
+    user->homedir = pw->pw_dir;
 
     if (pw->pw_shell && pw->pw_shell[0] != '\0') {
-        shell = pw->pw_shell;
+        user->shell = pw->pw_shell;
     } else {
-        shell = NULL;
+        user->shell = NULL;
     }
 
     if (pw->pw_gecos && pw->pw_gecos[0] != '\0') {
-        gecos = pw->pw_gecos;
+        user->gecos = pw->pw_gecos;
     } else {
-        gecos = NULL;
-    }
-
-    /* FIXME - optimize later */
-    ret = sysdb_store_user(id_ctx->domain,
-                           fqname,
-                           pw->pw_passwd,
-                           pw->pw_uid,
-                           pw->pw_gid,
-                           gecos,
-                           pw->pw_dir,
-                           shell,
-                           NULL, attrs,
-                           NULL, 0, 0);
-    if (ret != EOK) {
-        goto done;
+        user->gecos = NULL;
     }
 
-    ret = EOK;
-done:
-    talloc_free(tmp_ctx);
-    return ret;
+    user->attrs = sysdb_new_attrs(mem_ctx);
+    if (user->attrs == NULL) {
+        return ENOMEM;
+    }
+
+    /* The user is updated in place, drop the fields that were emptied */
+    user->remove_attrs = talloc_zero_array(mem_ctx, char *, 3);
+    if (user->remove_attrs == NULL) {
+        return ENOMEM;
+    }
+
+    ri = 0;
+    if (user->shell == NULL) {
+        user->remove_attrs[ri] = discard_const(SYSDB_SHELL);
+        ri++;
+    }
+    if (user->gecos == NULL) {
+        user->remove_attrs[ri] = discard_const(SYSDB_GECOS);
+        ri++;
+    }
+
+    return EOK;
 }
 
 static errno_t refresh_override_attrs(struct files_id_ctx *id_ctx,
@@ -449,14 +503,18 @@ done:
 }
 
 static errno_t sf_enum_groups(struct files_id_ctx *id_ctx,
-                              const char *group_file);
+                              const char *group_file,
+                              hash_table_t *seen);
 
 errno_t sf_enum_users(struct files_id_ctx *id_ctx,
-                      const char *passwd_file)
+                      const char *passwd_file,
+                      hash_table_t *seen)
 {
     errno_t ret;
     TALLOC_CTX *tmp_ctx = NULL;
     struct passwd **users = NULL;
+    struct sysdb_store_user_data *data;
+    size_t count = 0;
 
     tmp_ctx = talloc_new(NULL);
     if (tmp_ctx == NULL) {
@@ -468,14 +526,36 @@ errno_t sf_enum_users(struct files_id_ctx *id_ctx,
         goto done;
     }
 
+    data = talloc_zero_array(tmp_ctx, struct sysdb_store_user_data,
+                             talloc_array_length(users));
+    if (data == NULL) {
+        ret = ENOMEM;
+        goto done;
+    }
+
     for (size_t i = 0; users[i]; i++) {
-        ret = save_file_user(id_ctx, users[i]);
-        if (ret != EOK) {
+        ret = file_user_data(data, id_ctx, users[i], &data[count]);
+        if (ret == ENOENT) {
+            continue;
+        } else if (ret != EOK) {
             DEBUG(SSSDBG_MINOR_FAILURE,
                   "Cannot save user %s: [%d]: %s\n",
                   users[i]->pw_name, ret, sss_strerror(ret));
             continue;
         }
+
+        ret = add_seen_name(seen, data[count].name);
+        if (ret != EOK) {
+            goto done;
+        }
+        count++;
+    }
+
+    ret = sysdb_store_users_bulk(id_ctx->domain, data, count, 0, 0, NULL);
+    if (ret != EOK) {
+        DEBUG(SSSDBG_OP_FAILURE, "Cannot save users [%d]: %s\n",
+              ret, sss_strerror(ret));
+        goto done;
     }
 
     ret = refresh_override_attrs(id_ctx, SYSDB_MEMBER_USER);
@@ -524,43 +604,12 @@ done:
     return user_names;
 }
 
-static errno_t delete_all_groups(struct sss_domain_info *dom)
-{
-    TALLOC_CTX *tmp_ctx;
-    struct ldb_dn *base_dn;
-    errno_t ret;
-
-    tmp_ctx = talloc_new(NULL);
-    if (tmp_ctx == NULL) {
-        DEBUG(SSSDBG_FATAL_FAILURE, "Out of memory!\n");
-        return ENOMEM;
-    }
-
-    base_dn = sysdb_group_base_dn(tmp_ctx, dom);
-    if (base_dn == NULL) {
-        DEBUG(SSSDBG_CRIT_FAILURE, "Out of memory!\n");
-        ret = ENOMEM;
-        goto done;
-    }
-
-    ret = sysdb_delete_recursive(dom->sysdb, base_dn, true);
-    if (ret != EOK) {
-        DEBUG(SSSDBG_OP_FAILURE, "Unable to delete groups subtree [%d]: %s\n",
-              ret, sss_strerror(ret));
-        goto done;
-    }
-
-    ret = EOK;
-
-done:
-    talloc_free(tmp_ctx);
-
-    return ret;
-}
-
-static errno_t save_file_group(struct files_id_ctx *id_ctx,
+/* Returns ENOENT for groups that are not stored in the cache */
+static errno_t file_group_data(TALLOC_CTX *mem_ctx,
+                               struct files_id_ctx *id_ctx,
                                struct group *grp,
-                               const char **cached_users)
+                               const char **cached_users,
+                               struct sysdb_store_group_data *group)
 {
     errno_t ret;
     char *fqname;
@@ -569,11 +618,14 @@ static errno_t save_file_group(struct files_id_ctx *id_ctx,
     char **fq_gr_files_mem;
     const char **fq_gr_mem;
     unsigned mi = 0;
+    char **remove_attrs;
+    struct ldb_message_element *el;
+    unsigned ri;
 
     if (strcmp(grp->gr_name, "root") == 0
             || grp->gr_gid == 0) {
         DEBUG(SSSDBG_TRACE_FUNC, "Skipping %s\n", grp->gr_name);
-        return EOK;
+        return ENOENT;
     }
 
     tmp_ctx = talloc_new(NULL);
@@ -581,7 +633,7 @@ static errno_t save_file_group(struct files_id_ctx *id_ctx,
         return ENOMEM;
     }
 
-    fqname = sss_create_internal_fqname(tmp_ctx, grp->gr_name,
+    fqname = sss_create_internal_fqname(mem_ctx, grp->gr_name,
                                         id_ctx->domain->name);
     if (fqname == NULL) {
         ret = ENOMEM;
@@ -589,7 +641,7 @@ static errno_t save_file_group(struct files_id_ctx *id_ctx,
 
     }
 
-    attrs = sysdb_new_attrs(tmp_ctx);
+    attrs = sysdb_new_attrs(mem_ctx);
     if (attrs == NULL) {
         ret = ENOMEM;
         goto done;
@@ -651,13 +703,29 @@ static errno_t save_file_group(struct files_id_ctx *id_ctx,
 
     }
 
-    ret = sysdb_store_group(id_ctx->domain, fqname, grp->gr_gid,
-                            attrs, 0, 0);
-    if (ret) {
-        DEBUG(SSSDBG_OP_FAILURE, "Could not add group to cache\n");
+    /* The group is updated in place, drop the member kinds it has none
+     * of anymore */
+    remove_attrs = talloc_zero_array(mem_ctx, char *, 3);
+    if (remove_attrs == NULL) {
+        ret = ENOMEM;
         goto done;
     }
 
+    ri = 0;
+    if (mi == 0) {
+        remove_attrs[ri] = discard_const(SYSDB_MEMBER);
+        ri++;
+    }
+    if (sysdb_attrs_get_el_ext(attrs, SYSDB_GHOST, false, &el) == ENOENT) {
+        remove_attrs[ri] = discard_const(SYSDB_GHOST);
+        ri++;
+    }
+
+    group->name = fqname;
+    group->gid = grp->gr_gid;
+    group->attrs = attrs;
+    group->remove_attrs = remove_attrs;
+
     ret = EOK;
 done:
     talloc_free(tmp_ctx);
@@ -665,12 +733,15 @@ done:
 }
 
 static errno_t sf_enum_groups(struct files_id_ctx *id_ctx,
-                              const char *group_file)
+                              const char *group_file,
+                              hash_table_t *seen)
 {
     errno_t ret;
     TALLOC_CTX *tmp_ctx = NULL;
     struct group **groups = NULL;
     const char **cached_users = NULL;
+    struct sysdb_store_group_data *data;
+    size_t count = 0;
 
     tmp_ctx = talloc_new(NULL);
     if (tmp_ctx == NULL) {
@@ -687,13 +758,36 @@ static errno_t sf_enum_groups(struct files_id_ctx *id_ctx,
         goto done;
     }
 
+    data = talloc_zero_array(tmp_ctx, struct sysdb_store_group_data,
+                             talloc_array_length(groups));
+    if (data == NULL) {
+        ret = ENOMEM;
+        goto done;
+    }
+
     for (size_t i = 0; groups[i]; i++) {
-        ret = save_file_group(id_ctx, groups[i], cached_users);
-        if (ret != EOK) {
+        ret = file_group_data(data, id_ctx, groups[i], cached_users,
+                              &data[count]);
+        if (ret == ENOENT) {
+            continue;
+        } else if (ret != EOK) {
             DEBUG(SSSDBG_MINOR_FAILURE,
                   "Cannot save group %s\n", groups[i]->gr_name);
             continue;
         }
+
+        ret = add_seen_name(seen, data[count].name);
+        if (ret != EOK) {
+            goto done;
+        }
+        count++;
+    }
+
+    ret = sysdb_store_groups_bulk(id_ctx->domain, data, count, 0, 0, NULL);
+    if (ret != EOK) {
+        DEBUG(SSSDBG_OP_FAILURE, "Cannot save groups [%d]: %s\n",
+              ret, sss_strerror(ret));
+        goto done;
     }
 
     ret = refresh_override_attrs(id_ctx, SYSDB_MEMBER_GROUP);
@@ -714,8 +808,15 @@ static errno_t sf_enum_files(struct files_id_ctx *id_ctx,
 {
     errno_t ret;
     errno_t tret;
+    TALLOC_CTX *tmp_ctx;
+    hash_table_t *seen;
     bool in_transaction = false;
 
+    tmp_ctx = talloc_new(NULL);
+    if (tmp_ctx == NULL) {
+        return ENOMEM;
+    }
+
     ret = sysdb_transaction_start(id_ctx->domain->sysdb);
     if (ret != EOK) {
         goto done;
@@ -723,14 +824,15 @@ static errno_t sf_enum_files(struct files_id_ctx *id_ctx,
     in_transaction = true;
 
     if (flags & SF_UPDATE_PASSWD) {
-        ret = delete_all_users(id_ctx->domain);
+        ret = sss_hash_create(tmp_ctx, 0, &seen);
         if (ret != EOK) {
             goto done;
         }
 
-        /* All users were deleted, therefore we need to enumerate each file again */
+        /* Existing users are updated in place, only the ones that are
+         * not in any of the files are deleted afterwards */
         for (size_t i = 0; id_ctx->passwd_files[i] != NULL; i++) {
-            ret = sf_enum_users(id_ctx, id_ctx->passwd_files[i]);
+            ret = sf_enum_users(id_ctx, id_ctx->passwd_files[i], seen);
             if (ret == ENOENT) {
                 DEBUG(SSSDBG_MINOR_FAILURE,
                       "The file %s does not exist (yet), skipping\n",
@@ -743,17 +845,21 @@ static errno_t sf_enum_files(struct files_id_ctx *id_ctx,
                 goto done;
             }
         }
+
+        ret = delete_missing_entries(id_ctx->domain, SYSDB_MEMBER_USER, seen);
+        if (ret != EOK) {
+            goto done;
+        }
     }
 
     if (flags & SF_UPDATE_GROUP) {
-        ret = delete_all_groups(id_ctx->domain);
+        ret = sss_hash_create(tmp_ctx, 0, &seen);
         if (ret != EOK) {
             goto done;
         }
 
-        /* All groups were deleted, therefore we need to enumerate each file again */
         for (size_t i = 0; id_ctx->group_files[i] != NULL; i++) {
-            ret = sf_enum_groups(id_ctx, id_ctx->group_files[i]);
+            ret = sf_enum_groups(id_ctx, id_ctx->group_files[i], seen);
             if (ret == ENOENT) {
                 DEBUG(SSSDBG_MINOR_FAILURE,
                       "The file %s does not exist (yet), skipping\n",
@@ -766,6 +872,11 @@ static errno_t sf_enum_files(struct files_id_ctx *id_ctx,
                 goto done;
             }
         }
+
+        ret = delete_missing_entries(id_ctx->domain, SYSDB_MEMBER_GROUP, seen);
+        if (ret != EOK) {
+            goto done;
+        }
     }
 
     ret = dp_add_sr_attribute(id_ctx->be);
@@ -790,6 +901,7 @@ done:
         }
     }
 
+    talloc_free(tmp_ctx);
     return ret;
 }
 
@@ -1092,6 +1092,11 @@ ipa_sudo_refresh_done(struct tevent_req *subreq)
         goto done;
     }
 
+    ret = sysdb_sudo_bump_generation(state->domain);
+    if (ret != EOK) {
+        goto done;
+    }
+
     ret = sysdb_transaction_commit(state->sysdb);
     if (ret != EOK) {
         DEBUG(SSSDBG_CRIT_FAILURE, "Failed to commit transaction\n");
@@ -439,6 +439,7 @@ struct krb5_auth_state {
     struct krb5child_req *kr;
 
     bool search_kpasswd;
+    struct timeval child_start;
 
     int pam_status;
     int dp_err;
@@ -791,6 +792,7 @@ static void krb5_auth_resolve_done(struct tevent_req *subreq)
         kr->is_offline = false;
     }
 
+    gettimeofday(&state->child_start, NULL);
     subreq = handle_child_send(state, state->ev, kr);
     if (subreq == NULL) {
         DEBUG(SSSDBG_CRIT_FAILURE, "handle_child_send failed.\n");
@@ -1085,6 +1087,7 @@ static void krb5_auth_done(struct tevent_req *subreq)
         /* found a KDC */
         be_fo_set_port_status(state->be_ctx, state->krb5_ctx->service->name,
                               kr->srv, PORT_WORKING);
+        fo_server_add_rtt_sample(kr->srv, &state->child_start);
     }
 
     /* Now only a successful authentication or password change is left.
@@ -118,12 +118,18 @@ static krb5_context krb5_error_ctx;
 
 static errno_t k5c_become_user(uid_t uid, gid_t gid, bool is_posix)
 {
+    errno_t ret;
+
     if (is_posix == false) {
         DEBUG(SSSDBG_TRACE_FUNC,
               "Will not drop privileges for a non-POSIX user\n");
         return EOK;
     }
-    return become_user(uid, gid);
+
+    ret = become_user(uid, gid);
+    child_worker_set_pdeathsig();
+
+    return ret;
 }
 
 static krb5_error_code set_lifetime_options(struct cli_opts *cli_opts,
@@ -1756,6 +1762,7 @@ static krb5_error_code get_and_save_tgt(struct krb5_req *kr,
     }
 
     kerr = restore_creds(kr->pcsc_saved_creds);
+    child_worker_set_pdeathsig();
     if (kerr != 0)  {
         DEBUG(SSSDBG_OP_FAILURE, "restore_creds failed.\n");
     }
@@ -3226,6 +3233,7 @@ int main(int argc, const char *argv[])
     gid_t fast_gid = 0;
     struct cli_opts cli_opts = { 0 };
     int sss_creds_password = 0;
+    int worker = 0;
 
     struct poptOption long_options[] = {
         POPT_AUTOHELP
@@ -3260,6 +3268,8 @@ int main(int argc, const char *argv[])
          _("Requests canonicalization of the principal name"), NULL},
         {CHILD_OPT_SSS_CREDS_PASSWORD, 0, POPT_ARG_NONE, &sss_creds_password,
          0, _("Use custom version of krb5_get_init_creds_password"), NULL},
+        {CHILD_OPT_WORKER, 0, POPT_ARG_NONE, &worker, 0,
+         _("Serve several requests, each in a forked process"), NULL},
         POPT_TABLEEND
     };
 
@@ -3306,6 +3316,21 @@ int main(int argc, const char *argv[])
 
     DEBUG(SSSDBG_TRACE_FUNC, "krb5_child started.\n");
 
+    if (worker != 0) {
+        /* Only returns in the process forked for a request. */
+        child_worker_loop(IN_BUF_SIZE);
+
+        talloc_free(discard_const(debug_prg_name));
+        debug_prg_name = talloc_asprintf(NULL, "[sssd[krb5_child[%d]]]",
+                                         getpid());
+        if (!debug_prg_name) {
+            debug_prg_name = "[sssd[krb5_child]]";
+            DEBUG(SSSDBG_CRIT_FAILURE, "talloc_asprintf failed.\n");
+            ret = ENOMEM;
+            goto done;
+        }
+    }
+
     kr = talloc_zero(NULL, struct krb5_req);
     if (kr == NULL) {
         DEBUG(SSSDBG_CRIT_FAILURE, "talloc failed.\n");
@@ -3350,6 +3375,7 @@ int main(int argc, const char *argv[])
     if (IS_SC_AUTHTOK(kr->pd->authtok)) {
         kerr = switch_creds(kr, kr->fast_uid, kr->fast_gid, 0, NULL,
                             &kr->pcsc_saved_creds);
+        child_worker_set_pdeathsig();
     } else {
         kerr = k5c_become_user(kr->uid, kr->gid, kr->posix_domain);
     }
@@ -53,6 +53,9 @@ struct handle_child_state {
     pid_t child_pid;
 
     struct child_io_fds *io;
+
+    /* request sent to a krb5_child from the pool, see krb5_child_pool */
+    struct io_buffer *send_buf;
 };
 
 static errno_t pack_authtok(struct io_buffer *buf, size_t *rp,
@@ -512,12 +515,56 @@ fail:
 static void handle_child_step(struct tevent_req *subreq);
 static void handle_child_done(struct tevent_req *subreq);
 
+/* Returns the pool of long-lived krb5_child processes or NULL if the pool
+ * is not configured or could not be created. */
+static struct sss_child_pool *krb5_child_pool(struct tevent_context *ev,
+                                              struct krb5_ctx *krb5_ctx)
+{
+    const char **extra_args;
+    int size;
+    errno_t ret;
+
+    if (krb5_ctx->child_pool != NULL) {
+        return krb5_ctx->child_pool;
+    }
+
+    size = dp_opt_get_int(krb5_ctx->opts, KRB5_CHILD_POOL_SIZE);
+    if (size <= 0) {
+        return NULL;
+    }
+
+    ret = set_extra_args(krb5_ctx, krb5_ctx, &extra_args);
+    if (ret != EOK) {
+        DEBUG(SSSDBG_OP_FAILURE, "set_extra_args failed.\n");
+        return NULL;
+    }
+
+    ret = sss_child_pool_init(krb5_ctx, ev, KRB5_CHILD, extra_args,
+                              krb5_ctx->child_debug_fd, size,
+                              dp_opt_get_int(krb5_ctx->opts,
+                                             KRB5_CHILD_POOL_MAX_REQUESTS),
+                              0, &krb5_ctx->child_pool);
+    talloc_free(extra_args);
+    if (ret != EOK) {
+        DEBUG(SSSDBG_OP_FAILURE, "Unable to start krb5_child pool [%d]: %s\n",
+              ret, sss_strerror(ret));
+        return NULL;
+    }
+
+    return krb5_ctx->child_pool;
+}
+
+static errno_t handle_child_fork(struct tevent_req *req,
+                                 struct io_buffer *buf);
+static void handle_child_pool_done(struct tevent_req *subreq);
+
 struct tevent_req *handle_child_send(TALLOC_CTX *mem_ctx,
                                      struct tevent_context *ev,
                                      struct krb5child_req *kr)
 {
     struct tevent_req *req, *subreq;
     struct handle_child_state *state;
+    struct sss_child_pool *pool;
     int ret;
     struct io_buffer *buf = NULL;
 
@@ -549,19 +596,25 @@ struct tevent_req *handle_child_send(TALLOC_CTX *mem_ctx,
         goto fail;
     }
 
-    ret = fork_child(req);
-    if (ret != EOK) {
-        DEBUG(SSSDBG_CRIT_FAILURE, "fork_child failed.\n");
-        goto fail;
+    pool = krb5_child_pool(ev, kr->krb5_ctx);
+    if (pool != NULL) {
+        state->send_buf = buf;
+        subreq = sss_child_pool_send(state, ev, pool, buf->data, buf->size,
+                                     dp_opt_get_int(kr->krb5_ctx->opts,
+                                                    KRB5_AUTH_TIMEOUT));
+        if (subreq == NULL) {
+            ret = ENOMEM;
+            goto fail;
+        }
+        tevent_req_set_callback(subreq, handle_child_pool_done, req);
+
+        return req;
     }
 
-    subreq = write_pipe_send(state, ev, buf->data, buf->size,
-                             state->io->write_to_child_fd);
-    if (!subreq) {
-        ret = ENOMEM;
+    ret = handle_child_fork(req, buf);
+    if (ret != EOK) {
         goto fail;
     }
-    tevent_req_set_callback(subreq, handle_child_step, req);
 
     return req;
 
@@ -571,6 +624,54 @@ fail:
     return req;
 }
 
+static errno_t handle_child_fork(struct tevent_req *req,
+                                 struct io_buffer *buf)
+{
+    struct handle_child_state *state = tevent_req_data(req,
+                                                     struct handle_child_state);
+    struct tevent_req *subreq;
+    errno_t ret;
+
+    ret = fork_child(req);
+    if (ret != EOK) {
+        DEBUG(SSSDBG_CRIT_FAILURE, "fork_child failed.\n");
+        return ret;
+    }
+
+    subreq = write_pipe_send(state, state->ev, buf->data, buf->size,
+                             state->io->write_to_child_fd);
+    if (!subreq) {
+        return ENOMEM;
+    }
+    tevent_req_set_callback(subreq, handle_child_step, req);
+
+    return EOK;
+}
+
+static void handle_child_pool_done(struct tevent_req *subreq)
+{
+    struct tevent_req *req = tevent_req_callback_data(subreq,
+                                                      struct tevent_req);
+    struct handle_child_state *state = tevent_req_data(req,
+                                                    struct handle_child_state);
+    int ret;
+
+    ret = sss_child_pool_recv(subreq, state, &state->buf, &state->len);
+    talloc_zfree(subreq);
+    if (ret == EBUSY) {
+        DEBUG(SSSDBG_TRACE_FUNC, "All krb5_child workers are busy, "
+              "starting a new krb5_child.\n");
+        ret = handle_child_fork(req, state->send_buf);
+    } else if (ret == EOK) {
+        tevent_req_done(req);
+        return;
+    }
+
+    if (ret != EOK) {
+        tevent_req_error(req, ret);
+    }
+}
+
 static void handle_child_step(struct tevent_req *subreq)
 {
     struct tevent_req *req = tevent_req_callback_data(subreq,
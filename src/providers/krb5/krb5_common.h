@@ -63,6 +63,8 @@ enum krb5_opts {
     KRB5_USE_KDCINFO,
     KRB5_KDCINFO_LOOKAHEAD,
     KRB5_MAP_USER,
+    KRB5_CHILD_POOL_SIZE,
+    KRB5_CHILD_POOL_MAX_REQUESTS,
 
     KRB5_OPTS
 };
@@ -82,6 +84,7 @@ struct krb5_service {
 struct fo_service;
 struct deferred_auth_ctx;
 struct renew_tgt_ctx;
+struct sss_child_pool;
 
 enum krb5_config_type {
     K5C_GENERIC,
@@ -145,6 +148,9 @@ struct krb5_ctx {
     const char *fast_principal;
 
     bool canonicalize;
+
+    /* long-lived krb5_child workers, NULL if not used */
+    struct sss_child_pool *child_pool;
 };
 
 struct remove_info_files_ctx {
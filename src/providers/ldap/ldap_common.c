@@ -25,6 +25,7 @@
 #include "providers/ldap/ldap_common.h"
 #include "providers/fail_over.h"
 #include "providers/ldap/sdap_async_private.h"
+#include "providers/ldap/sdap_sync.h"
 #include "providers/krb5/krb5_common.h"
 #include "db/sysdb_sudo.h"
 #include "db/sysdb_services.h"
@@ -40,10 +41,28 @@ int ldap_child_debug_fd = -1;
 
 errno_t ldap_id_setup_tasks(struct sdap_id_ctx *ctx)
 {
-    return sdap_id_setup_tasks(ctx->be, ctx, ctx->opts->sdom,
-                               ldap_id_enumeration_send,
-                               ldap_id_enumeration_recv,
-                               ctx);
+    errno_t ret;
+
+    ret = sdap_id_setup_tasks(ctx->be, ctx, ctx->opts->sdom,
+                              ldap_id_enumeration_send,
+                              ldap_id_enumeration_recv,
+                              ctx);
+    if (ret != EOK) {
+        return ret;
+    }
+
+    /* keep the enumerated cache current between enumeration runs */
+    if (ctx->opts->sdom->dom->enumerate
+            && dp_opt_get_bool(ctx->opts->basic, SDAP_ENUM_SYNCREPL)) {
+        ret = sdap_sync_setup(ctx, ctx->opts->sdom, &ctx->sync);
+        if (ret != EOK) {
+            DEBUG(SSSDBG_OP_FAILURE, "Unable to set up content "
+                  "synchronization [%d]: %s\n", ret, sss_strerror(ret));
+            return ret;
+        }
+    }
+
+    return EOK;
 }
 
 errno_t sdap_id_setup_tasks(struct be_ctx *be_ctx,
@@ -63,6 +63,8 @@ struct sdap_id_conn_ctx {
     bool no_mpg_user_fallback;
 };
 
+struct sdap_sync_ctx;
+
 struct sdap_id_ctx {
     struct be_ctx *be;
     struct sdap_options *opts;
@@ -83,6 +85,9 @@ struct sdap_id_ctx {
     struct timeval last_enum;
     /* cleanup loop timer */
     struct timeval last_purge;
+
+    /* content synchronization consumer, if enabled */
+    struct sdap_sync_ctx *sync;
 };
 
 struct sdap_auth_ctx {
@@ -26,6 +26,7 @@
 #include "db/sysdb.h"
 #include "providers/ldap/ldap_common.h"
 #include "providers/ldap/sdap_async_enum.h"
+#include "providers/ldap/sdap_sync.h"
 
 errno_t ldap_id_setup_enumeration(struct be_ctx *be_ctx,
                                   struct sdap_id_ctx *id_ctx,
@@ -145,6 +146,7 @@ ldap_id_enumeration_send(TALLOC_CTX *mem_ctx,
     struct tevent_req *req;
     struct tevent_req *subreq;
     struct ldap_enum_ctx *ectx;
+    time_t cleanup;
     errno_t ret;
 
     req = tevent_req_create(mem_ctx, &state,
@@ -164,6 +166,23 @@ ldap_id_enumeration_send(TALLOC_CTX *mem_ctx,
     state->dom = ectx->sdom->dom;
     state->id_ctx = talloc_get_type_abort(ectx->pvt, struct sdap_id_ctx);
 
+    /* With content synchronization the cache is already current, only
+     * enumerate when the cleanup is due to catch entries whose removal
+     * was not announced. A zero timeout disables the cleanup, so there
+     * is nothing to catch up with. */
+    if (sdap_sync_is_current(state->id_ctx->sync)) {
+        cleanup = dp_opt_get_int(state->id_ctx->opts->basic,
+                                 SDAP_PURGE_CACHE_TIMEOUT);
+        if (cleanup == 0
+                || state->id_ctx->last_purge.tv_sec + cleanup >= time(NULL)) {
+            DEBUG(SSSDBG_TRACE_FUNC, "Cache of %s is synchronized, "
+                  "skipping enumeration\n", state->dom->name);
+            tevent_req_done(req);
+            tevent_req_post(req, ev);
+            return req;
+        }
+    }
+
     subreq = sdap_dom_enum_send(state, ev, state->id_ctx, ectx->sdom,
                                 state->id_ctx->conn);
     if (subreq == NULL) {
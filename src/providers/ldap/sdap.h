@@ -46,6 +46,11 @@ struct sdap_op {
     int msgid;
     bool done;
 
+    /* when the request was sent, used to measure the server's round trip
+     * time up to the first reply */
+    struct timeval start;
+    bool replied;
+
     sdap_op_callback_t *callback;
     void *data;
 
@@ -89,6 +94,9 @@ struct sdap_handle {
 
     struct sdap_op *ops;
 
+    /* failover server the handle is connected to, if any */
+    struct fo_server *server;
+
     /* during release we need to lock access to the handler
      * from the destructor to avoid recursion */
     bool destructor_lock;
@@ -240,6 +248,10 @@ enum sdap_basic_opt {
     SDAP_MAX_ID,
     SDAP_PWDLOCKOUT_DN,
     SDAP_WILDCARD_LIMIT,
+    SDAP_NESTING_CONCURRENCY,
+    SDAP_NESTING_BATCH_SIZE,
+    SDAP_ENUM_SYNCREPL,
+    SDAP_CONNECTION_POOL_SIZE,
 
     SDAP_OPTS_BASIC /* opts counter */
 };
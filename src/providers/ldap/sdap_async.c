@@ -286,10 +286,17 @@ static void sdap_process_message(struct tevent_context *ev,
     DEBUG(SSSDBG_TRACE_ALL,
           "Message type: [%s]\n", sdap_ldap_result_str(msgtype));
 
+    if (!op->replied) {
+        op->replied = true;
+        fo_server_add_rtt_sample(sh->server, &op->start);
+    }
+
     switch (msgtype) {
     case LDAP_RES_SEARCH_ENTRY:
     case LDAP_RES_SEARCH_REFERENCE:
-        /* go and process entry */
+    case LDAP_RES_INTERMEDIATE:
+        /* go and process entry, intermediate responses (e.g. syncrepl
+         * syncInfo messages) are never the final response */
         break;
 
     case LDAP_RES_BIND:
@@ -300,7 +307,6 @@ static void sdap_process_message(struct tevent_context *ev,
     case LDAP_RES_MODDN:
     case LDAP_RES_COMPARE:
     case LDAP_RES_EXTENDED:
-    case LDAP_RES_INTERMEDIATE:
         /* no more results expected with this msgid */
         op->done = true;
         break;
@@ -342,7 +348,7 @@ static void sdap_process_message(struct tevent_context *ev,
     }
 }
 
-static void sdap_unlock_next_reply(struct sdap_op *op)
+void sdap_unlock_next_reply(struct sdap_op *op)
 {
     struct timeval tv;
     struct tevent_timer *te;
@@ -438,6 +444,7 @@ int sdap_op_add(TALLOC_CTX *memctx, struct tevent_context *ev,
     op->callback = callback;
     op->data = data;
     op->ev = ev;
+    gettimeofday(&op->start, NULL);
 
     DEBUG(SSSDBG_TRACE_INTERNAL,
           "New operation %d timeout %d\n", op->msgid, timeout);
@@ -1289,6 +1296,9 @@ typedef errno_t (*sdap_parse_cb)(struct sdap_handle *sh,
                                  struct sdap_msg *msg,
                                  void *pvt);
 
+/* Called once all entries of a page were parsed */
+typedef errno_t (*sdap_page_cb)(void *pvt);
+
 struct sdap_get_generic_ext_state {
     struct tevent_context *ev;
     struct sdap_options *opts;
@@ -1312,6 +1322,7 @@ struct sdap_get_generic_ext_state {
     char **refs;
 
     sdap_parse_cb parse_cb;
+    sdap_page_cb page_cb;
     void *cb_data;
 
     unsigned int flags;
@@ -1348,6 +1359,7 @@ sdap_get_generic_ext_send(TALLOC_CTX *memctx,
                           int sizelimit,
                           int timeout,
                           sdap_parse_cb parse_cb,
+                          sdap_page_cb page_cb,
                           void *cb_data,
                           unsigned int flags)
 {
@@ -1373,6 +1385,7 @@ sdap_get_generic_ext_send(TALLOC_CTX *memctx,
     state->cookie.bv_len = 0;
     state->cookie.bv_val = NULL;
     state->parse_cb = parse_cb;
+    state->page_cb = page_cb;
     state->cb_data = cb_data;
     state->clientctrls = clientctrls;
     state->flags = flags;
@@ -1588,6 +1601,16 @@ sdap_get_generic_ext_add_references(struct sdap_get_generic_ext_state *state,
     return EOK;
 }
 
+static errno_t
+sdap_get_generic_ext_page_done(struct sdap_get_generic_ext_state *state)
+{
+    if (state->page_cb == NULL) {
+        return EOK;
+    }
+
+    return state->page_cb(state->cb_data);
+}
+
 static void sdap_get_generic_op_finished(struct sdap_op *op,
                                          struct sdap_msg *reply,
                                          int error, void *pvt)
@@ -1714,6 +1737,12 @@ static void sdap_get_generic_op_finished(struct sdap_op *op,
                                          returned_controls, NULL );
         if (!page_control) {
             /* No paging support. We are done */
+            ret = sdap_get_generic_ext_page_done(state);
+            if (ret != EOK) {
+                tevent_req_error(req, ret);
+                return;
+            }
+
             tevent_req_done(req);
             return;
         }
@@ -1749,12 +1778,25 @@ static void sdap_get_generic_op_finished(struct sdap_op *op,
                 return;
             }
 
+            /* The next page is already being fetched by the server while
+             * the entries of this one are processed */
+            ret = sdap_get_generic_ext_page_done(state);
+            if (ret != EOK) {
+                tevent_req_error(req, ret);
+                return;
+            }
+
             return;
         }
         /* The cookie must be freed even if len == 0 */
         ber_memfree(cookie.bv_val);
 
         /* This was the last page. We're done */
+        ret = sdap_get_generic_ext_page_done(state);
+        if (ret != EOK) {
+            tevent_req_error(req, ret);
+            return;
+        }
 
         tevent_req_done(req);
         return;
@@ -1834,12 +1876,18 @@ struct sdap_get_and_parse_generic_state {
 
     struct sdap_reply sreply;
     struct sdap_options *opts;
+
+    /* streaming mode */
+    sdap_page_fn page_fn;
+    void *page_pvt;
+    size_t batch_size;
 };
 
 static void sdap_get_and_parse_generic_done(struct tevent_req *subreq);
 static errno_t sdap_get_and_parse_generic_parse_entry(struct sdap_handle *sh,
                                                       struct sdap_msg *msg,
                                                       void *pvt);
+static errno_t sdap_get_and_parse_generic_page_done(void *pvt);
 
 struct tevent_req *sdap_get_and_parse_generic_send(TALLOC_CTX *memctx,
                                                    struct tevent_context *ev,
@@ -1857,6 +1905,35 @@ struct tevent_req *sdap_get_and_parse_generic_send(TALLOC_CTX *memctx,
                                                    int sizelimit,
                                                    int timeout,
                                                    bool allow_paging)
+{
+    return sdap_get_and_parse_generic_stream_send(memctx, ev, opts, sh,
+                                                  search_base, scope, filter,
+                                                  attrs, map, map_num_attrs,
+                                                  attrsonly, serverctrls,
+                                                  clientctrls, sizelimit,
+                                                  timeout, allow_paging,
+                                                  NULL, NULL);
+}
+
+struct tevent_req *
+sdap_get_and_parse_generic_stream_send(TALLOC_CTX *memctx,
+                                       struct tevent_context *ev,
+                                       struct sdap_options *opts,
+                                       struct sdap_handle *sh,
+                                       const char *search_base,
+                                       int scope,
+                                       const char *filter,
+                                       const char **attrs,
+                                       struct sdap_attr_map *map,
+                                       int map_num_attrs,
+                                       int attrsonly,
+                                       LDAPControl **serverctrls,
+                                       LDAPControl **clientctrls,
+                                       int sizelimit,
+                                       int timeout,
+                                       bool allow_paging,
+                                       sdap_page_fn page_fn,
+                                       void *page_pvt)
 {
     struct tevent_req *req = NULL;
     struct tevent_req *subreq = NULL;
@@ -1870,6 +1947,12 @@ struct tevent_req *sdap_get_and_parse_generic_send(TALLOC_CTX *memctx,
     state->map = map;
     state->map_num_attrs = map_num_attrs;
     state->opts = opts;
+    state->page_fn = page_fn;
+    state->page_pvt = page_pvt;
+    /* Without paging the entries are still handed over in batches of the
+     * page size so that memory usage stays bounded */
+    state->batch_size = (sh != NULL && sh->page_size > 0) ? sh->page_size
+                                                          : 1000;
 
     if (allow_paging) {
         flags |= SDAP_SRCH_FLG_PAGING;
@@ -1883,6 +1966,9 @@ struct tevent_req *sdap_get_and_parse_generic_send(TALLOC_CTX *memctx,
                                        scope, filter, attrs, serverctrls,
                                        clientctrls, sizelimit, timeout,
                                        sdap_get_and_parse_generic_parse_entry,
+                                       page_fn != NULL ?
+                                          sdap_get_and_parse_generic_page_done
+                                          : NULL,
                                        state, flags);
     if (!subreq) {
         talloc_zfree(req);
@@ -1922,6 +2008,41 @@ static errno_t sdap_get_and_parse_generic_parse_entry(struct sdap_handle *sh,
     }
 
     /* add_to_reply steals attrs, no need to free them here */
+
+    if (state->page_fn != NULL
+            && state->sreply.reply_count >= state->batch_size) {
+        return sdap_get_and_parse_generic_page_done(state);
+    }
+
+    return EOK;
+}
+
+/* Hand the entries collected so far over to the caller and release them */
+static errno_t sdap_get_and_parse_generic_page_done(void *pvt)
+{
+    struct sdap_get_and_parse_generic_state *state =
+                talloc_get_type(pvt, struct sdap_get_and_parse_generic_state);
+    errno_t ret;
+
+    if (state->sreply.reply_count == 0) {
+        return EOK;
+    }
+
+    DEBUG(SSSDBG_TRACE_INTERNAL, "Processing a batch of %zu entries\n",
+          state->sreply.reply_count);
+
+    ret = state->page_fn(state->sreply.reply, state->sreply.reply_count,
+                         state->page_pvt);
+    if (ret != EOK) {
+        DEBUG(SSSDBG_OP_FAILURE, "Unable to process a batch of entries "
+              "[%d]: %s\n", ret, sss_strerror(ret));
+        return ret;
+    }
+
+    talloc_zfree(state->sreply.reply);
+    state->sreply.reply_count = 0;
+    state->sreply.reply_max = 0;
+
     return EOK;
 }
 
@@ -2093,7 +2214,7 @@ sdap_x_deref_search_send(TALLOC_CTX *memctx, struct tevent_context *ev,
                                                       : LDAP_SCOPE_SUBTREE,
                                        filter, attrs,
                                        state->ctrls, NULL, 0, timeout,
-                                       sdap_x_deref_parse_entry,
+                                       sdap_x_deref_parse_entry, NULL,
                                        state, SDAP_SRCH_FLG_PAGING);
     if (!subreq) {
         talloc_zfree(req);
@@ -2317,7 +2438,7 @@ sdap_sd_search_send(TALLOC_CTX *memctx, struct tevent_context *ev,
     subreq = sdap_get_generic_ext_send(state, ev, opts, sh, base_dn,
                                        LDAP_SCOPE_BASE, "(objectclass=*)", attrs,
                                        state->ctrls, NULL, 0, timeout,
-                                       sdap_sd_search_parse_entry,
+                                       sdap_sd_search_parse_entry, NULL,
                                        state, SDAP_SRCH_FLG_PAGING);
     if (!subreq) {
         ret = EIO;
@@ -2516,7 +2637,7 @@ sdap_asq_search_send(TALLOC_CTX *memctx, struct tevent_context *ev,
     subreq = sdap_get_generic_ext_send(state, ev, opts, sh, base_dn,
                                        LDAP_SCOPE_BASE, NULL, attrs,
                                        state->ctrls, NULL, 0, timeout,
-                                       sdap_asq_search_parse_entry,
+                                       sdap_asq_search_parse_entry, NULL,
                                        state, SDAP_SRCH_FLG_PAGING);
     if (!subreq) {
         talloc_zfree(req);
@@ -238,6 +238,36 @@ int sdap_get_and_parse_generic_recv(struct tevent_req *req,
                                     size_t *reply_count,
                                     struct sysdb_attrs ***reply);
 
+/* Receives a batch of parsed entries, at most one page. The entries are
+ * freed after the callback returns unless it steals them. */
+typedef errno_t (*sdap_page_fn)(struct sysdb_attrs **entries,
+                                size_t count,
+                                void *pvt);
+
+/* Same as sdap_get_and_parse_generic_send() but the entries are passed to
+ * page_fn as each page arrives instead of being collected, so memory usage
+ * is bounded by the page size. The next page is requested before page_fn
+ * is called. sdap_get_and_parse_generic_recv() returns no entries. */
+struct tevent_req *
+sdap_get_and_parse_generic_stream_send(TALLOC_CTX *memctx,
+                                       struct tevent_context *ev,
+                                       struct sdap_options *opts,
+                                       struct sdap_handle *sh,
+                                       const char *search_base,
+                                       int scope,
+                                       const char *filter,
+                                       const char **attrs,
+                                       struct sdap_attr_map *map,
+                                       int map_num_attrs,
+                                       int attrsonly,
+                                       LDAPControl **serverctrls,
+                                       LDAPControl **clientctrls,
+                                       int sizelimit,
+                                       int timeout,
+                                       bool allow_paging,
+                                       sdap_page_fn page_fn,
+                                       void *page_pvt);
+
 struct tevent_req *sdap_get_generic_send(TALLOC_CTX *memctx,
                                          struct tevent_context *ev,
                                          struct sdap_options *opts,
@@ -593,6 +593,9 @@ static void sdap_connect_host_done(struct tevent_req *subreq)
         goto done;
     }
 
+    fo_ref_server(state->sh, state->srv);
+    state->sh->server = state->srv;
+
     /* if TLS was used, the sdap handle is already marked as connected */
     if (!state->use_start_tls) {
         /* we need to mark handle as connected to allow anonymous bind */
@@ -1442,6 +1445,7 @@ struct sdap_cli_connect_state {
     struct sdap_handle *sh;
 
     struct fo_server *srv;
+    struct timeval connect_start;
 
     struct sdap_server_opts *srv_opts;
 
@@ -1577,6 +1581,7 @@ static void sdap_cli_resolve_done(struct tevent_req *subreq)
         return;
     }
 
+    gettimeofday(&state->connect_start, NULL);
     subreq = sdap_connect_send(state, state->ev, state->opts,
                                state->service->uri,
                                state->service->sockaddr,
@@ -1611,6 +1616,10 @@ static void sdap_cli_connect_done(struct tevent_req *subreq)
         return;
     }
 
+    fo_server_add_rtt_sample(state->srv, &state->connect_start);
+    fo_ref_server(state->sh, state->srv);
+    state->sh->server = state->srv;
+
     if (state->use_rootdse) {
         /* fetch the rootDSE this time */
         sdap_cli_rootdse_step(req);
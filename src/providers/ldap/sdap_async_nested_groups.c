@@ -78,6 +78,8 @@ struct sdap_nested_group_ctx {
     bool try_deref;
     int deref_threshold;
     int max_nesting_level;
+    int lookup_window;
+    int batch_size;
 };
 
 static struct tevent_req *
@@ -132,6 +134,19 @@ sdap_nested_group_lookup_unknown_recv(TALLOC_CTX *mem_ctx,
                                       struct sysdb_attrs **_entry,
                                       enum sdap_nested_group_dn_type *_type);
 
+static struct tevent_req *
+sdap_nested_group_lookup_batch_send(TALLOC_CTX *mem_ctx,
+                                    struct tevent_context *ev,
+                                    struct sdap_nested_group_ctx *group_ctx,
+                                    struct sdap_nested_group_member **members,
+                                    int num_members);
+
+static errno_t
+sdap_nested_group_lookup_batch_recv(TALLOC_CTX *mem_ctx,
+                                    struct tevent_req *req,
+                                    struct sysdb_attrs ***_entries,
+                                    enum sdap_nested_group_dn_type **_types);
+
 static struct tevent_req *
 sdap_nested_group_deref_send(TALLOC_CTX *mem_ctx,
                              struct tevent_context *ev,
@@ -832,6 +847,10 @@ sdap_nested_group_send(TALLOC_CTX *mem_ctx,
                                                       SDAP_DEREF_THRESHOLD);
     state->group_ctx->max_nesting_level = dp_opt_get_int(opts->basic,
                                                          SDAP_NESTING_LEVEL);
+    state->group_ctx->lookup_window = dp_opt_get_int(opts->basic,
+                                                     SDAP_NESTING_CONCURRENCY);
+    state->group_ctx->batch_size = dp_opt_get_int(opts->basic,
+                                                  SDAP_NESTING_BATCH_SIZE);
     state->group_ctx->domain = sdom->dom;
     state->group_ctx->opts = opts;
     state->group_ctx->user_search_bases = sdom->user_search_bases;
@@ -839,6 +858,11 @@ sdap_nested_group_send(TALLOC_CTX *mem_ctx,
     state->group_ctx->sh = sh;
     state->group_ctx->try_deref = sdap_has_deref_support(sh, opts);
 
+    /* at least one member lookup must be in flight */
+    if (state->group_ctx->lookup_window <= 0) {
+        state->group_ctx->lookup_window = 1;
+    }
+
     /* disable deref if threshold <= 0 */
     if (state->group_ctx->deref_threshold <= 0) {
         state->group_ctx->try_deref = false;
@@ -1340,20 +1364,30 @@ static errno_t sdap_nested_group_recurse_recv(struct tevent_req *req)
     return EOK;
 }
 
+struct sdap_nested_group_lookup {
+    struct tevent_req *req;
+    struct sdap_nested_group_member **members;
+    int num_members;
+    bool batch;
+};
+
 struct sdap_nested_group_single_state {
     struct tevent_context *ev;
     struct sdap_nested_group_ctx *group_ctx;
     struct sdap_nested_group_member *members;
     int nesting_level;
 
-    struct sdap_nested_group_member *current_member;
-    int num_members;
-    int member_index;
+    struct sdap_nested_group_lookup *lookups;
+    int num_lookups;
+    int lookup_index;
+    int num_active;
 
     struct sysdb_attrs **nested_groups;
     int num_groups;
 };
 
+static errno_t
+sdap_nested_group_single_plan(struct tevent_req *req, int num_members);
 static errno_t sdap_nested_group_single_step(struct tevent_req *req);
 static void sdap_nested_group_single_step_done(struct tevent_req *subreq);
 static void sdap_nested_group_single_done(struct tevent_req *subreq);
@@ -1382,9 +1416,6 @@ sdap_nested_group_single_send(TALLOC_CTX *mem_ctx,
     state->group_ctx = group_ctx;
     state->members = members;
     state->nesting_level = nesting_level;
-    state->current_member = NULL;
-    state->num_members = num_members;
-    state->member_index = 0;
     state->nested_groups = talloc_zero_array(state, struct sysdb_attrs *,
                                              num_groups_max);
     if (state->nested_groups == NULL) {
@@ -1393,7 +1424,12 @@ sdap_nested_group_single_send(TALLOC_CTX *mem_ctx,
     }
     state->num_groups = 0; /* we will count exact number of the groups */
 
-    /* process each member individually */
+    ret = sdap_nested_group_single_plan(req, num_members);
+    if (ret != EOK) {
+        goto immediately;
+    }
+
+    /* process members individually or in batches */
     ret = sdap_nested_group_single_step(req);
     if (ret != EAGAIN) {
         goto immediately;
@@ -1412,89 +1448,231 @@ immediately:
     return req;
 }
 
-static errno_t sdap_nested_group_single_step(struct tevent_req *req)
+static bool
+sdap_nested_group_member_batchable(struct sdap_nested_group_ctx *group_ctx,
+                                   struct sdap_nested_group_member *member)
 {
-    struct sdap_nested_group_single_state *state = NULL;
-    struct tevent_req *subreq = NULL;
-
-    state = tevent_req_data(req, struct sdap_nested_group_single_state);
-
-    if (state->member_index >= state->num_members) {
-        /* we're done */
-        return EOK;
-    }
-
-    state->current_member = &state->members[state->member_index];
-    state->member_index++;
-
-    switch (state->current_member->type) {
+    switch (member->type) {
     case SDAP_NESTED_GROUP_DN_USER:
-        subreq = sdap_nested_group_lookup_user_send(state, state->ev,
-                                                    state->group_ctx,
-                                                    state->current_member);
-        break;
+        /* IPA users are not looked up in LDAP at all */
+        return group_ctx->opts->schema_type != SDAP_SCHEMA_IPA_V1;
     case SDAP_NESTED_GROUP_DN_GROUP:
-        subreq = sdap_nested_group_lookup_group_send(state, state->ev,
-                                                     state->group_ctx,
-                                                     state->current_member);
-        break;
     case SDAP_NESTED_GROUP_DN_UNKNOWN:
-        subreq = sdap_nested_group_lookup_unknown_send(state, state->ev,
-                                                   state->group_ctx,
-                                                   state->current_member);
-        break;
-    }
-
-    if (subreq == NULL) {
-        return ENOMEM;
+        return true;
     }
 
-    tevent_req_set_callback(subreq, sdap_nested_group_single_step_done, req);
-
-    return EAGAIN;
+    return false;
 }
 
+/* Split the members into lookups. If batching is enabled, members of the
+ * same type that live in the same container and share the search base
+ * filters are looked up together. */
 static errno_t
-sdap_nested_group_single_step_process(struct tevent_req *subreq)
+sdap_nested_group_single_plan(struct tevent_req *req, int num_members)
 {
     struct sdap_nested_group_single_state *state = NULL;
-    struct tevent_req *req = NULL;
-    struct sysdb_attrs *entry = NULL;
-    enum sdap_nested_group_dn_type type = SDAP_NESTED_GROUP_DN_UNKNOWN;
-    const char *orig_dn = NULL;
+    struct sdap_nested_group_member *member = NULL;
+    struct sdap_nested_group_lookup *lookup = NULL;
+    struct ldb_context *ldb = NULL;
+    struct ldb_dn *dn = NULL;
+    struct ldb_dn *parent = NULL;
+    TALLOC_CTX *tmp_ctx = NULL;
+    hash_table_t *open = NULL;
+    hash_key_t key;
+    hash_value_t value;
+    int batch_size;
+    int hret;
+    int i;
     errno_t ret;
 
-    req = tevent_req_callback_data(subreq, struct tevent_req);
     state = tevent_req_data(req, struct sdap_nested_group_single_state);
+    batch_size = state->group_ctx->batch_size;
 
-    /* set correct type if possible */
-    if (state->current_member->type == SDAP_NESTED_GROUP_DN_UNKNOWN) {
-        ret = sdap_nested_group_lookup_unknown_recv(state, subreq,
-                                                    &entry, &type);
+    tmp_ctx = talloc_new(NULL);
+    if (tmp_ctx == NULL) {
+        return ENOMEM;
+    }
+
+    state->lookups = talloc_zero_array(state, struct sdap_nested_group_lookup,
+                                       num_members);
+    if (state->lookups == NULL) {
+        ret = ENOMEM;
+        goto done;
+    }
+
+    if (batch_size > 1) {
+        ldb = sysdb_ctx_get_ldb(state->group_ctx->domain->sysdb);
+
+        ret = sss_hash_create(tmp_ctx, 32, &open);
         if (ret != EOK) {
             goto done;
         }
+    }
+
+    key.type = HASH_KEY_STRING;
+    key.str = NULL;
+
+    for (i = 0; i < num_members; i++) {
+        member = &state->members[i];
+        lookup = NULL;
+        key.str = NULL;
+
+        if (open != NULL
+                && sdap_nested_group_member_batchable(state->group_ctx,
+                                                      member)) {
+            dn = ldb_dn_new(tmp_ctx, ldb, member->dn);
+            if (dn != NULL && ldb_dn_validate(dn)) {
+                parent = ldb_dn_get_parent(tmp_ctx, dn);
+            } else {
+                parent = NULL;
+            }
+
+            if (parent != NULL) {
+                key.str = talloc_asprintf(tmp_ctx, "%d\n%s\n%s\n%s",
+                                          member->type,
+                                          ldb_dn_get_casefold(parent),
+                                          member->user_filter == NULL ?
+                                              "" : member->user_filter,
+                                          member->group_filter == NULL ?
+                                              "" : member->group_filter);
+                if (key.str == NULL) {
+                    ret = ENOMEM;
+                    goto done;
+                }
 
-        if (entry != NULL) {
-            state->current_member->type = type;
+                hret = hash_lookup(open, &key, &value);
+                if (hret == HASH_SUCCESS) {
+                    lookup = value.ptr;
+                } else if (hret != HASH_ERROR_KEY_NOT_FOUND) {
+                    ret = EIO;
+                    goto done;
+                }
+            }
         }
-    }
 
-    switch (state->current_member->type) {
-    case SDAP_NESTED_GROUP_DN_USER:
-        if (entry == NULL) {
-            /* type was not unknown, receive data */
-            ret = sdap_nested_group_lookup_user_recv(state, subreq, &entry);
-            if (ret != EOK) {
+        if (lookup != NULL && lookup->num_members < batch_size) {
+            lookup->members[lookup->num_members] = member;
+            lookup->num_members++;
+            continue;
+        }
+
+        lookup = &state->lookups[state->num_lookups];
+        state->num_lookups++;
+
+        lookup->req = req;
+        lookup->batch = key.str != NULL;
+        lookup->members = talloc_zero_array(state->lookups,
+                                            struct sdap_nested_group_member *,
+                                            lookup->batch ? batch_size : 1);
+        if (lookup->members == NULL) {
+            ret = ENOMEM;
+            goto done;
+        }
+        lookup->members[0] = member;
+        lookup->num_members = 1;
+
+        if (lookup->batch) {
+            /* following members of this container will join this lookup */
+            value.type = HASH_VALUE_PTR;
+            value.ptr = lookup;
+            hret = hash_enter(open, &key, &value);
+            if (hret != HASH_SUCCESS) {
+                ret = EIO;
                 goto done;
             }
+        }
+    }
+
+    /* a single member is looked up directly */
+    for (i = 0; i < state->num_lookups; i++) {
+        if (state->lookups[i].num_members == 1) {
+            state->lookups[i].batch = false;
+        }
+    }
+
+    ret = EOK;
+
+done:
+    talloc_free(tmp_ctx);
+    return ret;
+}
+
+static errno_t sdap_nested_group_single_step(struct tevent_req *req)
+{
+    struct sdap_nested_group_single_state *state = NULL;
+    struct sdap_nested_group_lookup *lookup = NULL;
+    struct sdap_nested_group_member *member = NULL;
+    struct tevent_req *subreq = NULL;
+
+    state = tevent_req_data(req, struct sdap_nested_group_single_state);
+
+    /* keep up to lookup_window lookups in flight */
+    while (state->num_active < state->group_ctx->lookup_window
+            && state->lookup_index < state->num_lookups) {
+        lookup = &state->lookups[state->lookup_index];
+        state->lookup_index++;
+
+        if (lookup->batch) {
+            subreq = sdap_nested_group_lookup_batch_send(state, state->ev,
+                                                         state->group_ctx,
+                                                         lookup->members,
+                                                         lookup->num_members);
+        } else {
+            member = lookup->members[0];
 
-            if (entry == NULL) {
-                /* user not found, continue */
+            switch (member->type) {
+            case SDAP_NESTED_GROUP_DN_USER:
+                subreq = sdap_nested_group_lookup_user_send(state, state->ev,
+                                                            state->group_ctx,
+                                                            member);
+                break;
+            case SDAP_NESTED_GROUP_DN_GROUP:
+                subreq = sdap_nested_group_lookup_group_send(state, state->ev,
+                                                             state->group_ctx,
+                                                             member);
+                break;
+            case SDAP_NESTED_GROUP_DN_UNKNOWN:
+                subreq = sdap_nested_group_lookup_unknown_send(state,
+                                                           state->ev,
+                                                           state->group_ctx,
+                                                           member);
                 break;
             }
         }
 
+        if (subreq == NULL) {
+            return ENOMEM;
+        }
+
+        tevent_req_set_callback(subreq, sdap_nested_group_single_step_done,
+                                lookup);
+        state->num_active++;
+    }
+
+    if (state->num_active > 0) {
+        return EAGAIN;
+    }
+
+    /* we're done */
+    return EOK;
+}
+
+static errno_t
+sdap_nested_group_single_save(struct sdap_nested_group_single_state *state,
+                              struct sdap_nested_group_member *member,
+                              struct sysdb_attrs *entry,
+                              bool was_unknown)
+{
+    const char *orig_dn = NULL;
+    errno_t ret;
+
+    if (entry == NULL) {
+        /* not found, continue */
+        return EOK;
+    }
+
+    switch (member->type) {
+    case SDAP_NESTED_GROUP_DN_USER:
         /* save user in hash table */
         ret = sdap_nested_group_hash_user(state->group_ctx, entry);
         if (ret == EEXIST) {
@@ -1509,18 +1687,7 @@ sdap_nested_group_single_step_process(struct tevent_req *subreq)
         }
         break;
     case SDAP_NESTED_GROUP_DN_GROUP:
-        if (entry == NULL) {
-            /* type was not unknown, receive data */
-            ret = sdap_nested_group_lookup_group_recv(state, subreq, &entry);
-            if (ret != EOK) {
-                goto done;
-            }
-
-            if (entry == NULL) {
-                /* group not found, continue */
-                break;
-            }
-        } else {
+        if (was_unknown) {
             /* the type was unknown so we had to pull the group,
              * but we don't want to process it if we have reached
              * the nesting level */
@@ -1567,15 +1734,94 @@ done:
     return ret;
 }
 
+static errno_t
+sdap_nested_group_single_step_process(struct tevent_req *subreq)
+{
+    struct sdap_nested_group_single_state *state = NULL;
+    struct sdap_nested_group_lookup *lookup = NULL;
+    struct sdap_nested_group_member *member = NULL;
+    struct sysdb_attrs **entries = NULL;
+    enum sdap_nested_group_dn_type *types = NULL;
+    struct sysdb_attrs *entry = NULL;
+    enum sdap_nested_group_dn_type type = SDAP_NESTED_GROUP_DN_UNKNOWN;
+    bool was_unknown;
+    errno_t ret;
+    int i;
+
+    lookup = tevent_req_callback_data(subreq, struct sdap_nested_group_lookup);
+    state = tevent_req_data(lookup->req, struct sdap_nested_group_single_state);
+
+    if (lookup->batch) {
+        ret = sdap_nested_group_lookup_batch_recv(state, subreq,
+                                                  &entries, &types);
+        if (ret != EOK) {
+            return ret;
+        }
+
+        for (i = 0; i < lookup->num_members; i++) {
+            member = lookup->members[i];
+            was_unknown = member->type == SDAP_NESTED_GROUP_DN_UNKNOWN;
+            if (was_unknown && entries[i] != NULL) {
+                member->type = types[i];
+            }
+
+            ret = sdap_nested_group_single_save(state, member,
+                                                talloc_steal(state,
+                                                             entries[i]),
+                                                was_unknown);
+            if (ret != EOK) {
+                return ret;
+            }
+        }
+
+        talloc_free(entries);
+        talloc_free(types);
+        return EOK;
+    }
+
+    member = lookup->members[0];
+    was_unknown = member->type == SDAP_NESTED_GROUP_DN_UNKNOWN;
+
+    /* set correct type if possible */
+    switch (member->type) {
+    case SDAP_NESTED_GROUP_DN_UNKNOWN:
+        ret = sdap_nested_group_lookup_unknown_recv(state, subreq,
+                                                    &entry, &type);
+        if (ret == EOK && entry != NULL) {
+            member->type = type;
+        }
+        break;
+    case SDAP_NESTED_GROUP_DN_USER:
+        ret = sdap_nested_group_lookup_user_recv(state, subreq, &entry);
+        break;
+    case SDAP_NESTED_GROUP_DN_GROUP:
+        ret = sdap_nested_group_lookup_group_recv(state, subreq, &entry);
+        break;
+    default:
+        ret = EINVAL;
+        break;
+    }
+
+    if (ret != EOK) {
+        return ret;
+    }
+
+    return sdap_nested_group_single_save(state, member, entry, was_unknown);
+}
+
 static void sdap_nested_group_single_step_done(struct tevent_req *subreq)
 {
     struct sdap_nested_group_single_state *state = NULL;
+    struct sdap_nested_group_lookup *lookup = NULL;
     struct tevent_req *req = NULL;
     errno_t ret;
 
-    req = tevent_req_callback_data(subreq, struct tevent_req);
+    lookup = tevent_req_callback_data(subreq, struct sdap_nested_group_lookup);
+    req = lookup->req;
     state = tevent_req_data(req, struct sdap_nested_group_single_state);
 
+    state->num_active--;
+
     /* process direct members */
     ret = sdap_nested_group_single_step_process(subreq);
     talloc_zfree(subreq);
@@ -2177,6 +2423,513 @@ sdap_nested_group_lookup_unknown_recv(TALLOC_CTX *mem_ctx,
     return EOK;
 }
 
+struct sdap_nested_group_lookup_batch_state {
+    struct tevent_context *ev;
+    struct sdap_nested_group_ctx *group_ctx;
+    struct sdap_nested_group_member **members;
+    int num_members;
+    const char *parent_dn;
+    hash_table_t *index;
+
+    struct sysdb_attrs **entries;
+    enum sdap_nested_group_dn_type *types;
+};
+
+static errno_t
+sdap_nested_group_lookup_batch_users(struct tevent_req *req);
+
+static errno_t
+sdap_nested_group_lookup_batch_groups(struct tevent_req *req);
+
+static void
+sdap_nested_group_lookup_batch_users_done(struct tevent_req *subreq);
+
+static void
+sdap_nested_group_lookup_batch_groups_done(struct tevent_req *subreq);
+
+/* Members of one batch are all direct children of the same container,
+ * so they are searched with a single ONELEVEL search whose filter is an OR
+ * of their RDNs. The returned entries are matched back to the members by
+ * their DN, anything else that matches the RDNs is ignored. */
+static struct tevent_req *
+sdap_nested_group_lookup_batch_send(TALLOC_CTX *mem_ctx,
+                                    struct tevent_context *ev,
+                                    struct sdap_nested_group_ctx *group_ctx,
+                                    struct sdap_nested_group_member **members,
+                                    int num_members)
+{
+    struct sdap_nested_group_lookup_batch_state *state = NULL;
+    struct tevent_req *req = NULL;
+    struct ldb_context *ldb = NULL;
+    struct ldb_dn *dn = NULL;
+    struct ldb_dn *parent = NULL;
+    hash_key_t key;
+    hash_value_t value;
+    int hret;
+    int i;
+    errno_t ret;
+
+    req = tevent_req_create(mem_ctx, &state,
+                            struct sdap_nested_group_lookup_batch_state);
+    if (req == NULL) {
+        DEBUG(SSSDBG_CRIT_FAILURE, "tevent_req_create() failed\n");
+        return NULL;
+    }
+
+    state->ev = ev;
+    state->group_ctx = group_ctx;
+    state->members = members;
+    state->num_members = num_members;
+
+    state->entries = talloc_zero_array(state, struct sysdb_attrs *,
+                                       num_members);
+    state->types = talloc_zero_array(state, enum sdap_nested_group_dn_type,
+                                     num_members);
+    if (state->entries == NULL || state->types == NULL) {
+        ret = ENOMEM;
+        goto immediately;
+    }
+
+    ret = sss_hash_create(state, num_members, &state->index);
+    if (ret != EOK) {
+        goto immediately;
+    }
+
+    ldb = sysdb_ctx_get_ldb(group_ctx->domain->sysdb);
+
+    for (i = 0; i < num_members; i++) {
+        state->types[i] = SDAP_NESTED_GROUP_DN_UNKNOWN;
+
+        dn = ldb_dn_new(state, ldb, members[i]->dn);
+        if (dn == NULL || !ldb_dn_validate(dn)) {
+            DEBUG(SSSDBG_OP_FAILURE, "Invalid DN [%s]\n", members[i]->dn);
+            ret = EINVAL;
+            goto immediately;
+        }
+
+        if (parent == NULL) {
+            parent = ldb_dn_get_parent(state, dn);
+            if (parent == NULL) {
+                ret = ENOMEM;
+                goto immediately;
+            }
+
+            state->parent_dn = ldb_dn_get_linearized(parent);
+        }
+
+        key.type = HASH_KEY_STRING;
+        key.str = talloc_strdup(state, ldb_dn_get_casefold(dn));
+        if (key.str == NULL) {
+            ret = ENOMEM;
+            goto immediately;
+        }
+
+        value.type = HASH_VALUE_INT;
+        value.i = i;
+
+        hret = hash_enter(state->index, &key, &value);
+        if (hret != HASH_SUCCESS) {
+            ret = EIO;
+            goto immediately;
+        }
+    }
+
+    DEBUG(SSSDBG_TRACE_INTERNAL, "Looking up %d members under [%s]\n",
+          num_members, state->parent_dn);
+
+    /* members of unknown type are searched as users first */
+    if (members[0]->type == SDAP_NESTED_GROUP_DN_GROUP) {
+        ret = sdap_nested_group_lookup_batch_groups(req);
+    } else {
+        ret = sdap_nested_group_lookup_batch_users(req);
+    }
+    if (ret != EAGAIN) {
+        goto immediately;
+    }
+
+    return req;
+
+immediately:
+    if (ret == EOK) {
+        tevent_req_done(req);
+    } else {
+        tevent_req_error(req, ret);
+    }
+    tevent_req_post(req, ev);
+
+    return req;
+}
+
+/* Build (|(rdn=value)...) for all members that were not found yet.
+ * Returns NULL in _filter if there is nothing left to search for. */
+static errno_t
+sdap_nested_group_lookup_batch_filter(TALLOC_CTX *mem_ctx,
+                                      struct sdap_nested_group_lookup_batch_state *state,
+                                      char **_filter)
+{
+    TALLOC_CTX *tmp_ctx = NULL;
+    struct ldb_context *ldb = NULL;
+    struct ldb_dn *dn = NULL;
+    const struct ldb_val *val = NULL;
+    char *filter = NULL;
+    char *sanitized = NULL;
+    int count = 0;
+    int i;
+    errno_t ret;
+
+    tmp_ctx = talloc_new(NULL);
+    if (tmp_ctx == NULL) {
+        return ENOMEM;
+    }
+
+    ldb = sysdb_ctx_get_ldb(state->group_ctx->domain->sysdb);
+
+    filter = talloc_strdup(tmp_ctx, "(|");
+    if (filter == NULL) {
+        ret = ENOMEM;
+        goto done;
+    }
+
+    for (i = 0; i < state->num_members; i++) {
+        if (state->entries[i] != NULL) {
+            continue;
+        }
+
+        dn = ldb_dn_new(tmp_ctx, ldb, state->members[i]->dn);
+        if (dn == NULL) {
+            ret = ENOMEM;
+            goto done;
+        }
+
+        val = ldb_dn_get_rdn_val(dn);
+        if (val == NULL || ldb_dn_get_rdn_name(dn) == NULL) {
+            ret = EINVAL;
+            goto done;
+        }
+
+        ret = sss_filter_sanitize(tmp_ctx, (const char *)val->data,
+                                  &sanitized);
+        if (ret != EOK) {
+            goto done;
+        }
+
+        filter = talloc_asprintf_append_buffer(filter, "(%s=%s)",
+                                               ldb_dn_get_rdn_name(dn),
+                                               sanitized);
+        if (filter == NULL) {
+            ret = ENOMEM;
+            goto done;
+        }
+
+        count++;
+    }
+
+    filter = talloc_asprintf_append_buffer(filter, ")");
+    if (filter == NULL) {
+        ret = ENOMEM;
+        goto done;
+    }
+
+    *_filter = count == 0 ? NULL : talloc_steal(mem_ctx, filter);
+    ret = EOK;
+
+done:
+    talloc_free(tmp_ctx);
+    return ret;
+}
+
+static errno_t
+sdap_nested_group_lookup_batch_users(struct tevent_req *req)
+{
+    struct sdap_nested_group_lookup_batch_state *state = NULL;
+    struct sdap_options *opts = NULL;
+    struct tevent_req *subreq = NULL;
+    const char **attrs = NULL;
+    const char *base_filter = NULL;
+    char *rdn_filter = NULL;
+    char *filter = NULL;
+    errno_t ret;
+
+    state = tevent_req_data(req, struct sdap_nested_group_lookup_batch_state);
+    opts = state->group_ctx->opts;
+
+    ret = sdap_nested_group_lookup_batch_filter(state, state, &rdn_filter);
+    if (ret != EOK || rdn_filter == NULL) {
+        return ret;
+    }
+
+    /* only pull down username and originalDN */
+    attrs = talloc_array(state, const char *, 3);
+    if (attrs == NULL) {
+        return ENOMEM;
+    }
+
+    attrs[0] = "objectClass";
+    attrs[1] = opts->user_map[SDAP_AT_USER_NAME].name;
+    attrs[2] = NULL;
+
+    /* create filter, members in a batch share the search base filter */
+    base_filter = talloc_asprintf(state, "(objectclass=%s)",
+                                  opts->user_map[SDAP_OC_USER].name);
+    if (base_filter == NULL) {
+        return ENOMEM;
+    }
+
+    base_filter = sdap_combine_filters(state, base_filter,
+                                       state->members[0]->user_filter);
+    if (base_filter == NULL) {
+        return ENOMEM;
+    }
+
+    filter = talloc_asprintf(state, "(&%s%s)", base_filter, rdn_filter);
+    if (filter == NULL) {
+        return ENOMEM;
+    }
+
+    subreq = sdap_get_generic_send(state, state->ev, opts,
+                                   state->group_ctx->sh,
+                                   state->parent_dn, LDAP_SCOPE_ONELEVEL,
+                                   filter, attrs,
+                                   opts->user_map, opts->user_map_cnt,
+                                   dp_opt_get_int(opts->basic,
+                                                  SDAP_SEARCH_TIMEOUT),
+                                   false);
+    if (subreq == NULL) {
+        return ENOMEM;
+    }
+
+    tevent_req_set_callback(subreq, sdap_nested_group_lookup_batch_users_done,
+                            req);
+
+    return EAGAIN;
+}
+
+static errno_t
+sdap_nested_group_lookup_batch_groups(struct tevent_req *req)
+{
+    struct sdap_nested_group_lookup_batch_state *state = NULL;
+    struct sdap_attr_map *map = NULL;
+    struct tevent_req *subreq = NULL;
+    const char **attrs = NULL;
+    const char *base_filter = NULL;
+    char *rdn_filter = NULL;
+    char *filter = NULL;
+    char *oc_list = NULL;
+    errno_t ret;
+
+    state = tevent_req_data(req, struct sdap_nested_group_lookup_batch_state);
+    map = state->group_ctx->opts->group_map;
+
+    ret = sdap_nested_group_lookup_batch_filter(state, state, &rdn_filter);
+    if (ret != EOK || rdn_filter == NULL) {
+        return ret;
+    }
+
+    ret = build_attrs_from_map(state, map, SDAP_OPTS_GROUP, NULL, &attrs, NULL);
+    if (ret != EOK) {
+        return ret;
+    }
+
+    oc_list = sdap_make_oc_list(state, map);
+    if (oc_list == NULL) {
+        DEBUG(SSSDBG_CRIT_FAILURE, "Failed to create objectClass list.\n");
+        return ENOMEM;
+    }
+
+    base_filter = talloc_asprintf(state, "(&(%s)(%s=*))", oc_list,
+                                  map[SDAP_AT_GROUP_NAME].name);
+    if (base_filter == NULL) {
+        return ENOMEM;
+    }
+
+    base_filter = sdap_combine_filters(state, base_filter,
+                                       state->members[0]->group_filter);
+    if (base_filter == NULL) {
+        return ENOMEM;
+    }
+
+    filter = talloc_asprintf(state, "(&%s%s)", base_filter, rdn_filter);
+    if (filter == NULL) {
+        return ENOMEM;
+    }
+
+    subreq = sdap_get_generic_send(state, state->ev, state->group_ctx->opts,
+                                   state->group_ctx->sh,
+                                   state->parent_dn, LDAP_SCOPE_ONELEVEL,
+                                   filter, attrs, map, SDAP_OPTS_GROUP,
+                                   dp_opt_get_int(state->group_ctx->opts->basic,
+                                                  SDAP_SEARCH_TIMEOUT),
+                                   false);
+    if (subreq == NULL) {
+        return ENOMEM;
+    }
+
+    tevent_req_set_callback(subreq, sdap_nested_group_lookup_batch_groups_done,
+                            req);
+
+    return EAGAIN;
+}
+
+static errno_t
+sdap_nested_group_lookup_batch_assign(struct sdap_nested_group_lookup_batch_state *state,
+                                      struct sysdb_attrs **reply,
+                                      size_t count,
+                                      enum sdap_nested_group_dn_type type)
+{
+    TALLOC_CTX *tmp_ctx = NULL;
+    struct ldb_context *ldb = NULL;
+    struct ldb_dn *dn = NULL;
+    const char *orig_dn = NULL;
+    hash_key_t key;
+    hash_value_t value;
+    size_t i;
+    int hret;
+    errno_t ret;
+
+    tmp_ctx = talloc_new(NULL);
+    if (tmp_ctx == NULL) {
+        return ENOMEM;
+    }
+
+    ldb = sysdb_ctx_get_ldb(state->group_ctx->domain->sysdb);
+
+    for (i = 0; i < count; i++) {
+        ret = sysdb_attrs_get_string(reply[i], SYSDB_ORIG_DN, &orig_dn);
+        if (ret != EOK) {
+            DEBUG(SSSDBG_MINOR_FAILURE, "The entry has no originalDN\n");
+            continue;
+        }
+
+        dn = ldb_dn_new(tmp_ctx, ldb, orig_dn);
+        if (dn == NULL || !ldb_dn_validate(dn)) {
+            DEBUG(SSSDBG_MINOR_FAILURE, "Invalid DN [%s]\n", orig_dn);
+            continue;
+        }
+
+        key.type = HASH_KEY_STRING;
+        key.str = discard_const(ldb_dn_get_casefold(dn));
+
+        hret = hash_lookup(state->index, &key, &value);
+        if (hret == HASH_ERROR_KEY_NOT_FOUND) {
+            /* matched by RDN but it is not one of our members */
+            DEBUG(SSSDBG_TRACE_ALL, "Ignoring [%s]\n", orig_dn);
+            continue;
+        } else if (hret != HASH_SUCCESS) {
+            ret = EIO;
+            goto done;
+        }
+
+        if (state->entries[value.i] != NULL) {
+            DEBUG(SSSDBG_OP_FAILURE,
+                  "Search returned more than one record for [%s]\n", orig_dn);
+            ret = EIO;
+            goto done;
+        }
+
+        state->entries[value.i] = talloc_steal(state->entries, reply[i]);
+        state->types[value.i] = type;
+    }
+
+    ret = EOK;
+
+done:
+    talloc_free(tmp_ctx);
+    return ret;
+}
+
+static void
+sdap_nested_group_lookup_batch_users_done(struct tevent_req *subreq)
+{
+    struct sdap_nested_group_lookup_batch_state *state = NULL;
+    struct tevent_req *req = NULL;
+    struct sysdb_attrs **reply = NULL;
+    size_t count = 0;
+    errno_t ret;
+
+    req = tevent_req_callback_data(subreq, struct tevent_req);
+    state = tevent_req_data(req, struct sdap_nested_group_lookup_batch_state);
+
+    ret = sdap_get_generic_recv(subreq, state, &count, &reply);
+    talloc_zfree(subreq);
+    if (ret == ENOENT) {
+        count = 0;
+    } else if (ret != EOK) {
+        goto done;
+    }
+
+    ret = sdap_nested_group_lookup_batch_assign(state, reply, count,
+                                                SDAP_NESTED_GROUP_DN_USER);
+    if (ret != EOK) {
+        goto done;
+    }
+
+    if (state->members[0]->type == SDAP_NESTED_GROUP_DN_UNKNOWN) {
+        /* not found in users, try groups */
+        ret = sdap_nested_group_lookup_batch_groups(req);
+    }
+
+done:
+    if (ret == EOK) {
+        tevent_req_done(req);
+    } else if (ret != EAGAIN) {
+        tevent_req_error(req, ret);
+    }
+}
+
+static void
+sdap_nested_group_lookup_batch_groups_done(struct tevent_req *subreq)
+{
+    struct sdap_nested_group_lookup_batch_state *state = NULL;
+    struct tevent_req *req = NULL;
+    struct sysdb_attrs **reply = NULL;
+    size_t count = 0;
+    errno_t ret;
+
+    req = tevent_req_callback_data(subreq, struct tevent_req);
+    state = tevent_req_data(req, struct sdap_nested_group_lookup_batch_state);
+
+    ret = sdap_get_generic_recv(subreq, state, &count, &reply);
+    talloc_zfree(subreq);
+    if (ret == ENOENT) {
+        count = 0;
+    } else if (ret != EOK) {
+        goto done;
+    }
+
+    ret = sdap_nested_group_lookup_batch_assign(state, reply, count,
+                                                SDAP_NESTED_GROUP_DN_GROUP);
+
+done:
+    if (ret != EOK) {
+        tevent_req_error(req, ret);
+        return;
+    }
+
+    tevent_req_done(req);
+}
+
+static errno_t
+sdap_nested_group_lookup_batch_recv(TALLOC_CTX *mem_ctx,
+                                    struct tevent_req *req,
+                                    struct sysdb_attrs ***_entries,
+                                    enum sdap_nested_group_dn_type **_types)
+{
+    struct sdap_nested_group_lookup_batch_state *state = NULL;
+    state = tevent_req_data(req, struct sdap_nested_group_lookup_batch_state);
+
+    TEVENT_REQ_RETURN_ON_ERROR(req);
+
+    if (_entries != NULL) {
+        *_entries = talloc_steal(mem_ctx, state->entries);
+    }
+
+    if (_types != NULL) {
+        *_types = talloc_steal(mem_ctx, state->types);
+    }
+
+    return EOK;
+}
+
 struct sdap_nested_group_deref_state {
     struct tevent_context *ev;
     struct sdap_nested_group_ctx *group_ctx;
@@ -637,6 +637,12 @@ static void sdap_sudo_refresh_done(struct tevent_req *subreq)
         goto done;
     }
 
+    /* let the responder know the rules have changed */
+    ret = sysdb_sudo_bump_generation(state->domain);
+    if (ret != EOK) {
+        goto done;
+    }
+
     /* commit transaction */
     ret = sysdb_transaction_commit(state->sysdb);
     if (ret != EOK) {
@@ -764,14 +764,36 @@ struct sdap_search_user_state {
 
     size_t base_iter;
     struct sdap_search_base **search_bases;
+
+    /* if set, users are passed to page_fn page by page instead of being
+     * collected in users */
+    sdap_page_fn page_fn;
+    void *page_pvt;
 };
 
 static errno_t sdap_search_user_next_base(struct tevent_req *req);
 static void sdap_search_user_copy_batch(struct sdap_search_user_state *state,
                                         struct sysdb_attrs **users,
                                         size_t count);
+static errno_t sdap_search_user_page(struct sysdb_attrs **users,
+                                     size_t count,
+                                     void *pvt);
 static void sdap_search_user_process(struct tevent_req *subreq);
 
+static struct tevent_req *
+sdap_search_user_stream_send(TALLOC_CTX *memctx,
+                             struct tevent_context *ev,
+                             struct sss_domain_info *dom,
+                             struct sdap_options *opts,
+                             struct sdap_search_base **search_bases,
+                             struct sdap_handle *sh,
+                             const char **attrs,
+                             const char *filter,
+                             int timeout,
+                             enum sdap_entry_lookup_type lookup_type,
+                             sdap_page_fn page_fn,
+                             void *page_pvt);
+
 struct tevent_req *sdap_search_user_send(TALLOC_CTX *memctx,
                                          struct tevent_context *ev,
                                          struct sss_domain_info *dom,
@@ -782,6 +804,25 @@ struct tevent_req *sdap_search_user_send(TALLOC_CTX *memctx,
                                          const char *filter,
                                          int timeout,
                                          enum sdap_entry_lookup_type lookup_type)
+{
+    return sdap_search_user_stream_send(memctx, ev, dom, opts, search_bases,
+                                        sh, attrs, filter, timeout,
+                                        lookup_type, NULL, NULL);
+}
+
+static struct tevent_req *
+sdap_search_user_stream_send(TALLOC_CTX *memctx,
+                             struct tevent_context *ev,
+                             struct sss_domain_info *dom,
+                             struct sdap_options *opts,
+                             struct sdap_search_base **search_bases,
+                             struct sdap_handle *sh,
+                             const char **attrs,
+                             const char *filter,
+                             int timeout,
+                             enum sdap_entry_lookup_type lookup_type,
+                             sdap_page_fn page_fn,
+                             void *page_pvt)
 {
     errno_t ret;
     struct tevent_req *req;
@@ -803,6 +844,8 @@ struct tevent_req *sdap_search_user_send(TALLOC_CTX *memctx,
     state->base_iter = 0;
     state->search_bases = search_bases;
     state->lookup_type = lookup_type;
+    state->page_fn = page_fn;
+    state->page_pvt = page_pvt;
 
     if (!state->search_bases) {
         DEBUG(SSSDBG_CRIT_FAILURE,
@@ -857,14 +900,16 @@ static errno_t sdap_search_user_next_base(struct tevent_req *req)
         break;
     }
 
-    subreq = sdap_get_and_parse_generic_send(
+    subreq = sdap_get_and_parse_generic_stream_send(
             state, state->ev, state->opts, state->sh,
             state->search_bases[state->base_iter]->basedn,
             state->search_bases[state->base_iter]->scope,
             state->filter, state->attrs,
             state->opts->user_map, state->opts->user_map_cnt,
             0, NULL, NULL, sizelimit, state->timeout,
-            need_paging);
+            need_paging,
+            state->page_fn != NULL ? sdap_search_user_page : NULL,
+            state);
     if (subreq == NULL) {
         return ENOMEM;
     }
@@ -873,6 +918,36 @@ static errno_t sdap_search_user_next_base(struct tevent_req *req)
     return EOK;
 }
 
+static errno_t sdap_search_user_page(struct sysdb_attrs **users,
+                                     size_t count,
+                                     void *pvt)
+{
+    struct sdap_search_user_state *state =
+                talloc_get_type(pvt, struct sdap_search_user_state);
+    struct sysdb_attrs **page;
+    size_t copied;
+    errno_t ret;
+
+    page = talloc_array(state, struct sysdb_attrs *, count + 1);
+    if (page == NULL) {
+        return ENOMEM;
+    }
+
+    copied = sdap_steal_objects_in_dom(state->opts, page, 0, state->dom,
+                                       users, count,
+                                       state->lookup_type == SDAP_LOOKUP_SINGLE);
+    page[copied] = NULL;
+
+    ret = state->page_fn(page, copied, state->page_pvt);
+    talloc_free(page);
+    if (ret != EOK) {
+        return ret;
+    }
+
+    state->count += copied;
+    return EOK;
+}
+
 static void sdap_search_user_process(struct tevent_req *subreq)
 {
     struct tevent_req *req = tevent_req_callback_data(subreq,
@@ -997,8 +1072,14 @@ struct sdap_get_users_state {
     struct sysdb_attrs **users;
     struct sysdb_attrs *mapped_attrs;
     size_t count;
+
+    /* users are saved page by page while the search runs */
+    bool stream;
 };
 
+static errno_t sdap_get_users_save_page(struct sysdb_attrs **users,
+                                        size_t count,
+                                        void *pvt);
 static void sdap_get_users_done(struct tevent_req *subreq);
 
 struct tevent_req *sdap_get_users_send(TALLOC_CTX *memctx,
@@ -1046,8 +1127,17 @@ struct tevent_req *sdap_get_users_send(TALLOC_CTX *memctx,
         }
     }
 
-    subreq = sdap_search_user_send(state, ev, dom, opts, search_bases,
-                                   sh, attrs, filter, timeout, lookup_type);
+    /* Enumeration can return a huge number of users, store them as the
+     * pages arrive instead of keeping all of them in memory. */
+    state->stream = (lookup_type == SDAP_LOOKUP_ENUMERATE
+                        && state->mapped_attrs == NULL);
+
+    subreq = sdap_search_user_stream_send(state, ev, dom, opts, search_bases,
+                                          sh, attrs, filter, timeout,
+                                          lookup_type,
+                                          state->stream ?
+                                              sdap_get_users_save_page : NULL,
+                                          state);
     if (subreq == NULL) {
         ret = ENOMEM;
         goto done;
@@ -1064,6 +1154,45 @@ done:
     return req;
 }
 
+static errno_t sdap_get_users_save_page(struct sysdb_attrs **users,
+                                        size_t count,
+                                        void *pvt)
+{
+    struct sdap_get_users_state *state =
+                talloc_get_type(pvt, struct sdap_get_users_state);
+    char *usn_value = NULL;
+    errno_t ret;
+
+    PROBE(SDAP_SEARCH_USER_SAVE_BEGIN, state->filter);
+    ret = sdap_save_users(state, state->sysdb,
+                          state->dom, state->opts,
+                          users, count, NULL, &usn_value);
+    PROBE(SDAP_SEARCH_USER_SAVE_END, state->filter);
+    if (ret != EOK) {
+        DEBUG(SSSDBG_OP_FAILURE, "Failed to store users [%d][%s].\n",
+              ret, sss_strerror(ret));
+        return ret;
+    }
+
+    if (usn_value != NULL) {
+        if (state->higher_usn == NULL
+                || strlen(usn_value) > strlen(state->higher_usn)
+                || (strlen(usn_value) == strlen(state->higher_usn)
+                        && strcmp(usn_value, state->higher_usn) > 0)) {
+            talloc_free(state->higher_usn);
+            state->higher_usn = usn_value;
+        } else {
+            talloc_free(usn_value);
+        }
+    }
+
+    state->count += count;
+    DEBUG(SSSDBG_TRACE_FUNC, "Saved %zu users, %zu in total\n",
+          count, state->count);
+
+    return EOK;
+}
+
 static void sdap_get_users_done(struct tevent_req *subreq)
 {
     struct tevent_req *req = tevent_req_callback_data(subreq,
@@ -1072,8 +1201,13 @@ static void sdap_get_users_done(struct tevent_req *subreq)
                                             struct sdap_get_users_state);
     int ret;
 
-    ret = sdap_search_user_recv(state, subreq, &state->higher_usn,
-                                &state->users, &state->count);
+    if (state->stream) {
+        /* all pages were saved already */
+        ret = sdap_search_user_recv(state, subreq, NULL, NULL, NULL);
+    } else {
+        ret = sdap_search_user_recv(state, subreq, &state->higher_usn,
+                                    &state->users, &state->count);
+    }
     if (ret) {
         if (ret != ENOENT) {
             DEBUG(SSSDBG_OP_FAILURE, "Failed to retrieve users [%d][%s].\n",
@@ -1083,6 +1217,12 @@ static void sdap_get_users_done(struct tevent_req *subreq)
         return;
     }
 
+    if (state->stream) {
+        DEBUG(SSSDBG_TRACE_ALL, "Saving %zu Users - Done\n", state->count);
+        tevent_req_done(req);
+        return;
+    }
+
     PROBE(SDAP_SEARCH_USER_SAVE_BEGIN, state->filter);
 
     ret = sdap_save_users(state, state->sysdb,
@@ -32,8 +32,10 @@ struct sdap_id_conn_cache {
 
     /* list of all open connections */
     struct sdap_id_conn_data *connections;
-    /* cached (current) connection */
-    struct sdap_id_conn_data *cached_connection;
+    /* cached (current) connections, operations are scheduled on the
+     * least loaded one, a free slot is NULL */
+    struct sdap_id_conn_data **cached_connections;
+    int pool_size;
 };
 
 /* LDAP async operation tracker:
@@ -72,6 +74,8 @@ struct sdap_id_conn_data {
     int notify_lock;
     /* list of operations using connect */
     struct sdap_id_op *ops;
+    /* number of operations in ops */
+    int num_ops;
     /* A flag which is signalizing that this
      * connection will be disconnected and should
      * not be used any more */
@@ -82,6 +86,10 @@ static void sdap_id_conn_cache_be_offline_cb(void *pvt);
 static void sdap_id_conn_cache_fo_reconnect_cb(void *pvt);
 
 static void sdap_id_release_conn_data(struct sdap_id_conn_data *conn_data);
+static bool sdap_id_conn_is_cached(struct sdap_id_conn_data *conn_data);
+static bool sdap_id_conn_cache_add(struct sdap_id_conn_data *conn_data);
+static void sdap_id_conn_uncache(struct sdap_id_conn_data *conn_data);
+static void sdap_id_conn_cache_release_all(struct sdap_id_conn_cache *conn_cache);
 static int sdap_id_conn_data_destroy(struct sdap_id_conn_data *conn_data);
 static bool sdap_is_connection_expired(struct sdap_id_conn_data *conn_data, int timeout);
 static bool sdap_can_reuse_connection(struct sdap_id_conn_data *conn_data);
@@ -140,28 +148,121 @@ fail:
     return ret;
 }
 
+/* Allocate the connection slots, the options are not available yet when
+ * the cache is created */
+static errno_t sdap_id_conn_cache_init_pool(struct sdap_id_conn_cache *conn_cache)
+{
+    int pool_size;
+
+    if (conn_cache->cached_connections != NULL) {
+        return EOK;
+    }
+
+    pool_size = dp_opt_get_int(conn_cache->id_conn->id_ctx->opts->basic,
+                               SDAP_CONNECTION_POOL_SIZE);
+    if (pool_size < 1) {
+        DEBUG(SSSDBG_CONF_SETTINGS,
+              "Invalid connection pool size %d, using 1\n", pool_size);
+        pool_size = 1;
+    }
+
+    conn_cache->cached_connections = talloc_zero_array(conn_cache,
+                                                struct sdap_id_conn_data *,
+                                                pool_size);
+    if (conn_cache->cached_connections == NULL) {
+        return ENOMEM;
+    }
+    conn_cache->pool_size = pool_size;
+
+    DEBUG(SSSDBG_TRACE_FUNC, "Using up to %d connections for %s\n",
+          pool_size, conn_cache->id_conn->service->name);
+
+    return EOK;
+}
+
+/* Check whether the connection occupies a slot of the cache */
+static bool sdap_id_conn_is_cached(struct sdap_id_conn_data *conn_data)
+{
+    struct sdap_id_conn_cache *conn_cache = conn_data->conn_cache;
+    int i;
+
+    for (i = 0; i < conn_cache->pool_size; i++) {
+        if (conn_cache->cached_connections[i] == conn_data) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+/* Put the connection to a free slot of the cache */
+static bool sdap_id_conn_cache_add(struct sdap_id_conn_data *conn_data)
+{
+    struct sdap_id_conn_cache *conn_cache = conn_data->conn_cache;
+    int i;
+
+    if (sdap_id_conn_is_cached(conn_data)) {
+        return true;
+    }
+
+    for (i = 0; i < conn_cache->pool_size; i++) {
+        if (conn_cache->cached_connections[i] == NULL) {
+            conn_cache->cached_connections[i] = conn_data;
+            return true;
+        }
+    }
+
+    return false;
+}
+
+/* Drop the connection from the cache, it is not released */
+static void sdap_id_conn_uncache(struct sdap_id_conn_data *conn_data)
+{
+    struct sdap_id_conn_cache *conn_cache = conn_data->conn_cache;
+    int i;
+
+    for (i = 0; i < conn_cache->pool_size; i++) {
+        if (conn_cache->cached_connections[i] == conn_data) {
+            conn_cache->cached_connections[i] = NULL;
+        }
+    }
+}
+
+/* Drop all connections from the cache and release the unused ones */
+static void sdap_id_conn_cache_release_all(struct sdap_id_conn_cache *conn_cache)
+{
+    struct sdap_id_conn_data *cached_connection;
+    int i;
+
+    for (i = 0; i < conn_cache->pool_size; i++) {
+        cached_connection = conn_cache->cached_connections[i];
+        if (cached_connection != NULL) {
+            conn_cache->cached_connections[i] = NULL;
+            sdap_id_release_conn_data(cached_connection);
+        }
+    }
+}
+
 /* Callback on BE going offline */
 static void sdap_id_conn_cache_be_offline_cb(void *pvt)
 {
     struct sdap_id_conn_cache *conn_cache = talloc_get_type(pvt, struct sdap_id_conn_cache);
-    struct sdap_id_conn_data *cached_connection = conn_cache->cached_connection;
 
     /* Release any cached connection on going offline */
-    if (cached_connection != NULL) {
-        conn_cache->cached_connection = NULL;
-        sdap_id_release_conn_data(cached_connection);
-    }
+    sdap_id_conn_cache_release_all(conn_cache);
 }
 
 /* Callback for attempt to reconnect to primary server */
 static void sdap_id_conn_cache_fo_reconnect_cb(void *pvt)
 {
     struct sdap_id_conn_cache *conn_cache = talloc_get_type(pvt, struct sdap_id_conn_cache);
-    struct sdap_id_conn_data *cached_connection = conn_cache->cached_connection;
+    int i;
 
     /* Release any cached connection on going offline */
-    if (cached_connection != NULL) {
-        cached_connection->disconnecting = true;
+    for (i = 0; i < conn_cache->pool_size; i++) {
+        if (conn_cache->cached_connections[i] != NULL) {
+            conn_cache->cached_connections[i]->disconnecting = true;
+        }
     }
 }
 
@@ -175,7 +276,7 @@ static void sdap_id_release_conn_data(struct sdap_id_conn_data *conn_data)
     }
 
     conn_cache = conn_data->conn_cache;
-    if (conn_data == conn_cache->cached_connection) {
+    if (sdap_id_conn_is_cached(conn_data)) {
         return;
     }
 
@@ -195,6 +296,7 @@ static int sdap_id_conn_data_destroy(struct sdap_id_conn_data *conn_data)
         op->conn_data = NULL;
         DLIST_REMOVE(conn_data->ops, op);
     }
+    conn_data->num_ops = 0;
 
     return 0;
 }
@@ -275,13 +377,12 @@ static void sdap_id_conn_data_expire_handler(struct tevent_context *ev,
 {
     struct sdap_id_conn_data *conn_data = talloc_get_type(pvt,
                                                           struct sdap_id_conn_data);
-    struct sdap_id_conn_cache *conn_cache = conn_data->conn_cache;
 
     DEBUG(SSSDBG_MINOR_FAILURE,
           "connection is about to expire, releasing it\n");
 
-    if (conn_cache->cached_connection == conn_data) {
-        conn_cache->cached_connection = NULL;
+    if (sdap_id_conn_is_cached(conn_data)) {
+        sdap_id_conn_uncache(conn_data);
 
         sdap_id_release_conn_data(conn_data);
     }
@@ -316,12 +417,14 @@ static void sdap_id_op_hook_conn_data(struct sdap_id_op *op, struct sdap_id_conn
 
     if (current) {
         DLIST_REMOVE(current->ops, op);
+        current->num_ops--;
     }
 
     op->conn_data = conn_data;
 
     if (conn_data) {
         DLIST_ADD_END(conn_data->ops, op, struct sdap_id_op*);
+        conn_data->num_ops++;
     }
 
     if (current) {
@@ -458,26 +561,49 @@ static int sdap_id_op_connect_step(struct tevent_req *req)
 
     int ret = EOK;
     struct sdap_id_conn_data *conn_data;
+    struct sdap_id_conn_data *least_loaded = NULL;
     struct tevent_req *subreq = NULL;
+    int free_slots = 0;
+    int i;
 
-    /* Try to reuse context cached connection */
-    conn_data = conn_cache->cached_connection;
-    if (conn_data) {
-        if (conn_data->connect_req) {
-            DEBUG(SSSDBG_TRACE_ALL, "waiting for connection to complete\n");
-            sdap_id_op_hook_conn_data(op, conn_data);
-            goto done;
+    ret = sdap_id_conn_cache_init_pool(conn_cache);
+    if (ret != EOK) {
+        return ret;
+    }
+
+    /* Try to reuse the least loaded cached connection */
+    for (i = 0; i < conn_cache->pool_size; i++) {
+        conn_data = conn_cache->cached_connections[i];
+        if (conn_data == NULL) {
+            free_slots++;
+            continue;
         }
 
-        if (sdap_can_reuse_connection(conn_data)) {
-            DEBUG(SSSDBG_TRACE_ALL, "reusing cached connection\n");
-            sdap_id_op_hook_conn_data(op, conn_data);
-            goto done;
+        if (!conn_data->connect_req && !sdap_can_reuse_connection(conn_data)) {
+            DEBUG(SSSDBG_TRACE_ALL, "releasing expired cached connection\n");
+            conn_cache->cached_connections[i] = NULL;
+            free_slots++;
+            sdap_id_release_conn_data(conn_data);
+            continue;
         }
 
-        DEBUG(SSSDBG_TRACE_ALL, "releasing expired cached connection\n");
-        conn_cache->cached_connection = NULL;
-        sdap_id_release_conn_data(conn_data);
+        if (least_loaded == NULL || conn_data->num_ops < least_loaded->num_ops) {
+            least_loaded = conn_data;
+        }
+    }
+
+    /* Only open another connection if all cached ones are busy */
+    conn_data = least_loaded;
+    if (conn_data && (conn_data->num_ops == 0 || free_slots == 0)) {
+        if (conn_data->connect_req) {
+            DEBUG(SSSDBG_TRACE_ALL, "waiting for connection to complete\n");
+        } else {
+            DEBUG(SSSDBG_TRACE_ALL,
+                  "reusing cached connection with %d operations\n",
+                  conn_data->num_ops);
+        }
+        sdap_id_op_hook_conn_data(op, conn_data);
+        goto done;
     }
 
     DEBUG(SSSDBG_TRACE_ALL, "beginning to connect\n");
@@ -506,7 +632,7 @@ static int sdap_id_op_connect_step(struct tevent_req *req)
     conn_data->connect_req = subreq;
 
     DLIST_ADD(conn_cache->connections, conn_data);
-    conn_cache->cached_connection = conn_data;
+    sdap_id_conn_cache_add(conn_data);
 
     sdap_id_op_hook_conn_data(op, conn_data);
 
@@ -658,9 +784,7 @@ static void sdap_id_op_connect_done(struct tevent_req *subreq)
             bool retry = false;
 
             /* drop connection from cache now */
-            if (conn_cache->cached_connection == conn_data) {
-                conn_cache->cached_connection = NULL;
-            }
+            sdap_id_conn_uncache(conn_data);
 
             if (can_retry) {
                 /* determining whether retry is possible */
@@ -721,18 +845,20 @@ static void sdap_id_op_connect_done(struct tevent_req *subreq)
     if ((ret == EOK) &&
         conn_data->sh->connected &&
         !be_is_offline(conn_cache->id_conn->id_ctx->be)) {
-        DEBUG(SSSDBG_TRACE_ALL,
-              "caching successful connection after %d notifies\n", notify_count);
-        conn_cache->cached_connection = conn_data;
+        if (sdap_id_conn_cache_add(conn_data)) {
+            DEBUG(SSSDBG_TRACE_ALL,
+                  "caching successful connection after %d notifies\n",
+                  notify_count);
+        }
 
         /* Run any post-connection routines */
         be_run_unconditional_online_cb(conn_cache->id_conn->id_ctx->be);
         be_run_online_cb(conn_cache->id_conn->id_ctx->be);
 
+        /* No free slot, the connection is only kept while in use */
+        sdap_id_release_conn_data(conn_data);
     } else {
-        if (conn_cache->cached_connection == conn_data) {
-            conn_cache->cached_connection = NULL;
-        }
+        sdap_id_conn_uncache(conn_data);
 
         sdap_id_release_conn_data(conn_data);
     }
@@ -835,9 +961,10 @@ int sdap_id_op_done(struct sdap_id_op *op, int retval, int *dp_err_out)
     }
 
     if (communication_error && current_conn != 0
-            && current_conn == op->conn_cache->cached_connection) {
-        /* do not reuse failed connection */
-        op->conn_cache->cached_connection = NULL;
+            && sdap_id_conn_is_cached(current_conn)) {
+        /* do not reuse failed connection nor the other connections
+         * to the same server */
+        sdap_id_conn_cache_release_all(op->conn_cache);
 
         DEBUG(SSSDBG_FUNC_DATA,
               "communication error on cached connection, moving to next server\n");
@@ -0,0 +1,1304 @@
+/*
+    SSSD
+
+    LDAP Content Synchronization (RFC 4533) consumer
+
+    Copyright (C) 2026 Red Hat
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/* The consumer runs a single refreshAndPersist search for users and groups
+ * on a connection of its own. Announced entries are not stored directly,
+ * only their names are collected and the entries are then re-fetched in
+ * batches through the regular user and group lookups, so the cache sees
+ * exactly the same data as with enumeration. Deleted entries are removed
+ * by their original DN or, for syncIdSet messages, by their entryUUID.
+ *
+ * While a batch is being written to the cache, further replies are held in
+ * the operation queue and the cookie is only advanced once the batch was
+ * stored. The cookie is kept in memory, so a restart of the backend begins
+ * with a full refresh. */
+
+#include <ldap.h>
+#include <lber.h>
+
+#include "util/util.h"
+#include "db/sysdb.h"
+#include "providers/ldap/ldap_common.h"
+#include "providers/ldap/sdap_async.h"
+#include "providers/ldap/sdap_async_private.h"
+#include "providers/ldap/sdap_sync.h"
+
+/* Number of changed entries that are written to the cache at once. */
+#define SDAP_SYNC_BATCH_SIZE 100
+/* How long changes are collected during the persist phase. */
+#define SDAP_SYNC_FLUSH_DELAY 1
+/* Delay before the search is restarted after an error. */
+#define SDAP_SYNC_RETRY_DELAY 30
+/* Delay before a server without syncrepl support is checked again. */
+#define SDAP_SYNC_UNSUPPORTED_DELAY 3600
+
+#define SDAP_SYNC_UUID_LEN 16
+
+struct sdap_sync_batch {
+    const char **users;
+    size_t num_users;
+    const char **groups;
+    size_t num_groups;
+    const char **dns;
+    size_t num_dns;
+    const char **uuids;
+    size_t num_uuids;
+
+    struct berval *cookie;
+    bool refresh_done;
+};
+
+struct sdap_sync_ctx {
+    struct tevent_context *ev;
+    struct sdap_id_ctx *id_ctx;
+    struct sdap_domain *sdom;
+
+    /* dedicated connection, it is not shared with regular lookups */
+    struct sdap_id_conn_ctx *conn;
+    struct sdap_id_op *op;
+    struct sdap_handle *sh;
+    struct sdap_op *sop;
+    int op_error;
+
+    const char *base;
+    char *filter;
+    const char **attrs;
+
+    struct berval *cookie;
+    bool current;
+
+    struct sdap_sync_batch *batch;
+    struct tevent_req *flush_req;
+    struct tevent_timer *flush_timer;
+    struct tevent_timer *restart_timer;
+    /* the reply that triggered the flush is unlocked once it is done */
+    bool unlock_pending;
+    /* a reply arrived during the flush and waits in the queue */
+    bool held;
+};
+
+static void sdap_sync_schedule(struct sdap_sync_ctx *ctx, time_t delay);
+static void sdap_sync_process(struct sdap_sync_ctx *ctx,
+                              struct sdap_msg *reply);
+
+bool sdap_sync_is_current(struct sdap_sync_ctx *sync_ctx)
+{
+    return sync_ctx != NULL && sync_ctx->current;
+}
+
+static errno_t sdap_sync_set_cookie(TALLOC_CTX *mem_ctx,
+                                    struct berval **_dest,
+                                    struct berval *src)
+{
+    struct berval *cookie;
+
+    cookie = talloc_zero(mem_ctx, struct berval);
+    if (cookie == NULL) {
+        return ENOMEM;
+    }
+
+    cookie->bv_val = talloc_memdup(cookie, src->bv_val, src->bv_len);
+    if (cookie->bv_val == NULL && src->bv_len != 0) {
+        talloc_free(cookie);
+        return ENOMEM;
+    }
+    cookie->bv_len = src->bv_len;
+
+    talloc_free(*_dest);
+    *_dest = cookie;
+    return EOK;
+}
+
+static errno_t sdap_sync_batch_add(struct sdap_sync_batch *batch,
+                                   const char ***_list, size_t *_count,
+                                   const char *value)
+{
+    const char **list;
+
+    list = talloc_realloc(batch, *_list, const char *, *_count + 2);
+    if (list == NULL) {
+        return ENOMEM;
+    }
+
+    list[*_count] = talloc_strdup(list, value);
+    if (list[*_count] == NULL) {
+        *_list = list;
+        return ENOMEM;
+    }
+    list[*_count + 1] = NULL;
+
+    *_list = list;
+    (*_count)++;
+    return EOK;
+}
+
+static size_t sdap_sync_batch_count(struct sdap_sync_batch *batch)
+{
+    return batch->num_users + batch->num_groups
+               + batch->num_dns + batch->num_uuids;
+}
+
+/* ==Flushing-changes-to-the-cache======================================== */
+
+static errno_t sdap_sync_delete_msgs(struct sysdb_ctx *sysdb,
+                                     size_t count, struct ldb_message **msgs)
+{
+    errno_t ret;
+    size_t i;
+
+    for (i = 0; i < count; i++) {
+        DEBUG(SSSDBG_TRACE_FUNC, "Removing [%s] from cache\n",
+              ldb_dn_get_linearized(msgs[i]->dn));
+
+        ret = sysdb_delete_entry(sysdb, msgs[i]->dn, true);
+        if (ret != EOK) {
+            return ret;
+        }
+    }
+
+    return EOK;
+}
+
+static errno_t sdap_sync_delete(struct sss_domain_info *dom,
+                                struct sdap_sync_batch *batch)
+{
+    TALLOC_CTX *tmp_ctx;
+    const char *attrs[] = { SYSDB_NAME, NULL };
+    struct ldb_message **msgs;
+    struct ldb_result *res;
+    size_t count;
+    bool in_transaction = false;
+    errno_t ret;
+    size_t i;
+
+    if (batch->num_dns == 0 && batch->num_uuids == 0) {
+        return EOK;
+    }
+
+    tmp_ctx = talloc_new(NULL);
+    if (tmp_ctx == NULL) {
+        return ENOMEM;
+    }
+
+    ret = sysdb_transaction_start(dom->sysdb);
+    if (ret != EOK) {
+        goto done;
+    }
+    in_transaction = true;
+
+    for (i = 0; i < batch->num_dns; i++) {
+        ret = sysdb_search_users_by_orig_dn(tmp_ctx, dom, batch->dns[i],
+                                            attrs, &count, &msgs);
+        if (ret == EOK) {
+            ret = sdap_sync_delete_msgs(dom->sysdb, count, msgs);
+        }
+        if (ret != EOK && ret != ENOENT) {
+            goto done;
+        }
+
+        ret = sysdb_search_groups_by_orig_dn(tmp_ctx, dom, batch->dns[i],
+                                             attrs, &count, &msgs);
+        if (ret == EOK) {
+            ret = sdap_sync_delete_msgs(dom->sysdb, count, msgs);
+        }
+        if (ret != EOK && ret != ENOENT) {
+            goto done;
+        }
+    }
+
+    for (i = 0; i < batch->num_uuids; i++) {
+        ret = sysdb_search_object_by_uuid(tmp_ctx, dom, batch->uuids[i],
+                                          attrs, &res);
+        if (ret == EOK) {
+            ret = sdap_sync_delete_msgs(dom->sysdb, res->count, res->msgs);
+        }
+        if (ret != EOK && ret != ENOENT) {
+            goto done;
+        }
+    }
+
+    ret = sysdb_transaction_commit(dom->sysdb);
+    if (ret != EOK) {
+        goto done;
+    }
+    in_transaction = false;
+
+done:
+    if (in_transaction) {
+        sysdb_transaction_cancel(dom->sysdb);
+    }
+    talloc_free(tmp_ctx);
+    return ret;
+}
+
+/* (&(<objectclass filter>)(|(<name attr>=<name>)...)) */
+static char *sdap_sync_names_filter(TALLOC_CTX *mem_ctx,
+                                    const char *oc_filter,
+                                    const char *name_attr,
+                                    const char **names,
+                                    size_t num_names)
+{
+    char *filter;
+    char *sanitized;
+    errno_t ret;
+    size_t i;
+
+    filter = talloc_asprintf(mem_ctx, "(&(%s)(|", oc_filter);
+    for (i = 0; filter != NULL && i < num_names; i++) {
+        ret = sss_filter_sanitize(filter, names[i], &sanitized);
+        if (ret != EOK) {
+            talloc_free(filter);
+            return NULL;
+        }
+
+        filter = talloc_asprintf_append_buffer(filter, "(%s=%s)",
+                                               name_attr, sanitized);
+    }
+
+    if (filter != NULL) {
+        filter = talloc_asprintf_append_buffer(filter, "))");
+    }
+
+    return filter;
+}
+
+struct sdap_sync_flush_state {
+    struct tevent_context *ev;
+    struct sdap_sync_ctx *ctx;
+    struct sdap_sync_batch *batch;
+};
+
+static errno_t sdap_sync_flush_users(struct tevent_req *req);
+static void sdap_sync_flush_users_done(struct tevent_req *subreq);
+static errno_t sdap_sync_flush_groups(struct tevent_req *req);
+static void sdap_sync_flush_groups_done(struct tevent_req *subreq);
+
+static struct tevent_req *
+sdap_sync_flush_send(TALLOC_CTX *mem_ctx,
+                     struct tevent_context *ev,
+                     struct sdap_sync_ctx *ctx,
+                     struct sdap_sync_batch *batch)
+{
+    struct sdap_sync_flush_state *state;
+    struct tevent_req *req;
+    errno_t ret;
+
+    req = tevent_req_create(mem_ctx, &state, struct sdap_sync_flush_state);
+    if (req == NULL) {
+        return NULL;
+    }
+
+    state->ev = ev;
+    state->ctx = ctx;
+    state->batch = talloc_steal(state, batch);
+
+    DEBUG(SSSDBG_TRACE_FUNC, "Applying %zu user, %zu group and %zu removed "
+          "entries from content synchronization\n", batch->num_users,
+          batch->num_groups, batch->num_dns + batch->num_uuids);
+
+    ret = sdap_sync_delete(ctx->sdom->dom, batch);
+    if (ret != EOK) {
+        DEBUG(SSSDBG_OP_FAILURE, "Unable to remove deleted entries "
+              "[%d]: %s\n", ret, sss_strerror(ret));
+        goto done;
+    }
+
+    ret = sdap_sync_flush_users(req);
+
+done:
+    if (ret != EAGAIN) {
+        if (ret == EOK) {
+            tevent_req_done(req);
+        } else {
+            tevent_req_error(req, ret);
+        }
+        tevent_req_post(req, ev);
+    }
+
+    return req;
+}
+
+static errno_t sdap_sync_flush_users(struct tevent_req *req)
+{
+    struct sdap_sync_flush_state *state;
+    struct sdap_options *opts;
+    struct tevent_req *subreq;
+    const char **attrs;
+    char *oc_filter;
+    char *filter;
+    errno_t ret;
+
+    state = tevent_req_data(req, struct sdap_sync_flush_state);
+    opts = state->ctx->id_ctx->opts;
+
+    if (state->batch->num_users == 0) {
+        return sdap_sync_flush_groups(req);
+    }
+
+    oc_filter = talloc_asprintf(state, "objectclass=%s",
+                                opts->user_map[SDAP_OC_USER].name);
+    if (oc_filter == NULL) {
+        return ENOMEM;
+    }
+
+    filter = sdap_sync_names_filter(state, oc_filter,
+                                    opts->user_map[SDAP_AT_USER_NAME].name,
+                                    state->batch->users,
+                                    state->batch->num_users);
+    if (filter == NULL) {
+        return ENOMEM;
+    }
+
+    ret = build_attrs_from_map(state, opts->user_map, opts->user_map_cnt,
+                               NULL, &attrs, NULL);
+    if (ret != EOK) {
+        return ret;
+    }
+
+    subreq = sdap_get_users_send(state, state->ev, state->ctx->sdom->dom,
+                                 state->ctx->sdom->dom->sysdb, opts,
+                                 state->ctx->sdom->user_search_bases,
+                                 state->ctx->sh, attrs, filter,
+                                 dp_opt_get_int(opts->basic,
+                                                SDAP_SEARCH_TIMEOUT),
+                                 SDAP_LOOKUP_WILDCARD, NULL);
+    if (subreq == NULL) {
+        return ENOMEM;
+    }
+
+    tevent_req_set_callback(subreq, sdap_sync_flush_users_done, req);
+    return EAGAIN;
+}
+
+static void sdap_sync_flush_users_done(struct tevent_req *subreq)
+{
+    struct tevent_req *req;
+    errno_t ret;
+
+    req = tevent_req_callback_data(subreq, struct tevent_req);
+
+    ret = sdap_get_users_recv(subreq, NULL, NULL);
+    talloc_zfree(subreq);
+    if (ret != EOK && ret != ENOENT) {
+        tevent_req_error(req, ret);
+        return;
+    }
+
+    ret = sdap_sync_flush_groups(req);
+    if (ret == EOK) {
+        tevent_req_done(req);
+    } else if (ret != EAGAIN) {
+        tevent_req_error(req, ret);
+    }
+}
+
+static errno_t sdap_sync_flush_groups(struct tevent_req *req)
+{
+    struct sdap_sync_flush_state *state;
+    struct sdap_options *opts;
+    struct tevent_req *subreq;
+    const char **attrs;
+    char *oc_filter;
+    char *filter;
+    errno_t ret;
+
+    state = tevent_req_data(req, struct sdap_sync_flush_state);
+    opts = state->ctx->id_ctx->opts;
+
+    if (state->batch->num_groups == 0) {
+        return EOK;
+    }
+
+    oc_filter = sdap_make_oc_list(state, opts->group_map);
+    if (oc_filter == NULL) {
+        return ENOMEM;
+    }
+
+    filter = sdap_sync_names_filter(state, oc_filter,
+                                    opts->group_map[SDAP_AT_GROUP_NAME].name,
+                                    state->batch->groups,
+                                    state->batch->num_groups);
+    if (filter == NULL) {
+        return ENOMEM;
+    }
+
+    ret = build_attrs_from_map(state, opts->group_map, SDAP_OPTS_GROUP,
+                               NULL, &attrs, NULL);
+    if (ret != EOK) {
+        return ret;
+    }
+
+    subreq = sdap_get_groups_send(state, state->ev, state->ctx->sdom, opts,
+                                  state->ctx->sh, attrs, filter,
+                                  dp_opt_get_int(opts->basic,
+                                                 SDAP_SEARCH_TIMEOUT),
+                                  SDAP_LOOKUP_WILDCARD, false);
+    if (subreq == NULL) {
+        return ENOMEM;
+    }
+
+    tevent_req_set_callback(subreq, sdap_sync_flush_groups_done, req);
+    return EAGAIN;
+}
+
+static void sdap_sync_flush_groups_done(struct tevent_req *subreq)
+{
+    struct tevent_req *req;
+    errno_t ret;
+
+    req = tevent_req_callback_data(subreq, struct tevent_req);
+
+    ret = sdap_get_groups_recv(subreq, NULL, NULL);
+    talloc_zfree(subreq);
+    if (ret != EOK && ret != ENOENT) {
+        tevent_req_error(req, ret);
+        return;
+    }
+
+    tevent_req_done(req);
+}
+
+static errno_t sdap_sync_flush_recv(TALLOC_CTX *mem_ctx,
+                                    struct tevent_req *req,
+                                    struct sdap_sync_batch **_batch)
+{
+    struct sdap_sync_flush_state *state;
+
+    state = tevent_req_data(req, struct sdap_sync_flush_state);
+
+    TEVENT_REQ_RETURN_ON_ERROR(req);
+
+    *_batch = talloc_steal(mem_ctx, state->batch);
+
+    return EOK;
+}
+
+/* ==Consumer-state-machine=============================================== */
+
+static void sdap_sync_fail(struct sdap_sync_ctx *ctx, int error,
+                           time_t delay)
+{
+    ctx->current = false;
+    ctx->unlock_pending = false;
+    ctx->held = false;
+    talloc_zfree(ctx->flush_timer);
+    talloc_zfree(ctx->flush_req);
+    talloc_zfree(ctx->batch);
+    talloc_zfree(ctx->sop);
+
+    /* the connection is released from the timer, we might be called from
+     * within the handle release right now */
+    ctx->op_error = error;
+    sdap_sync_schedule(ctx, delay);
+}
+
+static void sdap_sync_flush_done(struct tevent_req *subreq);
+
+static void sdap_sync_flush(struct sdap_sync_ctx *ctx, bool from_reply)
+{
+    struct sdap_sync_batch *batch;
+
+    talloc_zfree(ctx->flush_timer);
+
+    batch = ctx->batch;
+    ctx->batch = talloc_zero(ctx, struct sdap_sync_batch);
+    if (ctx->batch == NULL) {
+        ctx->batch = batch;
+        sdap_sync_fail(ctx, ENOMEM, SDAP_SYNC_RETRY_DELAY);
+        return;
+    }
+
+    ctx->flush_req = sdap_sync_flush_send(ctx, ctx->ev, ctx, batch);
+    if (ctx->flush_req == NULL) {
+        talloc_free(batch);
+        sdap_sync_fail(ctx, ENOMEM, SDAP_SYNC_RETRY_DELAY);
+        return;
+    }
+
+    tevent_req_set_callback(ctx->flush_req, sdap_sync_flush_done, ctx);
+    ctx->unlock_pending = from_reply;
+}
+
+static void sdap_sync_flush_done(struct tevent_req *subreq)
+{
+    struct sdap_sync_ctx *ctx;
+    struct sdap_sync_batch *batch;
+    errno_t ret;
+
+    ctx = tevent_req_callback_data(subreq, struct sdap_sync_ctx);
+    ctx->flush_req = NULL;
+
+    ret = sdap_sync_flush_recv(ctx, subreq, &batch);
+    talloc_zfree(subreq);
+    if (ret != EOK) {
+        DEBUG(SSSDBG_OP_FAILURE, "Unable to apply synchronized changes "
+              "[%d]: %s\n", ret, sss_strerror(ret));
+        sdap_sync_fail(ctx, ret, SDAP_SYNC_RETRY_DELAY);
+        return;
+    }
+
+    if (batch->cookie != NULL) {
+        talloc_free(ctx->cookie);
+        ctx->cookie = talloc_steal(ctx, batch->cookie);
+    }
+
+    if (batch->refresh_done && !ctx->current) {
+        DEBUG(SSSDBG_TRACE_FUNC, "Content synchronization of [%s] finished "
+              "the refresh phase, the cache is up to date\n",
+              ctx->sdom->dom->name);
+        ctx->current = true;
+    }
+    talloc_free(batch);
+
+    if (ctx->unlock_pending) {
+        ctx->unlock_pending = false;
+        sdap_unlock_next_reply(ctx->sop);
+    } else if (ctx->held) {
+        ctx->held = false;
+        sdap_sync_process(ctx, ctx->sop->list);
+    }
+}
+
+static void sdap_sync_flush_timeout(struct tevent_context *ev,
+                                    struct tevent_timer *te,
+                                    struct timeval tv, void *pvt)
+{
+    struct sdap_sync_ctx *ctx;
+
+    ctx = talloc_get_type(pvt, struct sdap_sync_ctx);
+    ctx->flush_timer = NULL;
+
+    if (ctx->flush_req != NULL || sdap_sync_batch_count(ctx->batch) == 0) {
+        return;
+    }
+
+    sdap_sync_flush(ctx, false);
+}
+
+/* ==Parsing-replies====================================================== */
+
+static bool sdap_sync_has_oc(struct berval **ocs, const char *oc)
+{
+    size_t i;
+
+    if (ocs == NULL || oc == NULL) {
+        return false;
+    }
+
+    for (i = 0; ocs[i] != NULL; i++) {
+        if (strncasecmp(ocs[i]->bv_val, oc, ocs[i]->bv_len) == 0
+                && strlen(oc) == ocs[i]->bv_len) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+static errno_t sdap_sync_add_names(struct sdap_sync_ctx *ctx,
+                                   LDAPMessage *msg,
+                                   const char *attr,
+                                   const char ***_list,
+                                   size_t *_count)
+{
+    struct berval **values;
+    char *name;
+    errno_t ret = EOK;
+    size_t i;
+
+    values = ldap_get_values_len(ctx->sh->ldap, msg, attr);
+    if (values == NULL) {
+        DEBUG(SSSDBG_MINOR_FAILURE, "Synchronized entry has no [%s]\n",
+              attr);
+        return EOK;
+    }
+
+    for (i = 0; values[i] != NULL; i++) {
+        name = talloc_strndup(ctx, values[i]->bv_val, values[i]->bv_len);
+        if (name == NULL) {
+            ret = ENOMEM;
+            break;
+        }
+
+        ret = sdap_sync_batch_add(ctx->batch, _list, _count, name);
+        talloc_free(name);
+        if (ret != EOK) {
+            break;
+        }
+    }
+
+    ldap_value_free_len(values);
+    return ret;
+}
+
+static errno_t sdap_sync_entry_changed(struct sdap_sync_ctx *ctx,
+                                       LDAPMessage *msg)
+{
+    struct sdap_options *opts = ctx->id_ctx->opts;
+    struct berval **ocs;
+    errno_t ret = EOK;
+
+    ocs = ldap_get_values_len(ctx->sh->ldap, msg, "objectClass");
+    if (ocs == NULL) {
+        return EOK;
+    }
+
+    if (sdap_sync_has_oc(ocs, opts->user_map[SDAP_OC_USER].name)) {
+        ret = sdap_sync_add_names(ctx, msg,
+                                  opts->user_map[SDAP_AT_USER_NAME].name,
+                                  &ctx->batch->users,
+                                  &ctx->batch->num_users);
+    } else if (sdap_sync_has_oc(ocs, opts->group_map[SDAP_OC_GROUP].name)
+            || sdap_sync_has_oc(ocs,
+                                opts->group_map[SDAP_OC_GROUP_ALT].name)) {
+        ret = sdap_sync_add_names(ctx, msg,
+                                  opts->group_map[SDAP_AT_GROUP_NAME].name,
+                                  &ctx->batch->groups,
+                                  &ctx->batch->num_groups);
+    }
+
+    ldap_value_free_len(ocs);
+    return ret;
+}
+
+static errno_t sdap_sync_entry(struct sdap_sync_ctx *ctx, LDAPMessage *msg)
+{
+    LDAPControl **ctrls = NULL;
+    LDAPControl *ctrl;
+    BerElement *ber = NULL;
+    struct berval uuid;
+    struct berval cookie;
+    ber_len_t len;
+    ber_int_t state;
+    char *dn;
+    errno_t ret;
+    int lret;
+
+    lret = ldap_get_entry_controls(ctx->sh->ldap, msg, &ctrls);
+    if (lret != LDAP_SUCCESS) {
+        DEBUG(SSSDBG_OP_FAILURE, "ldap_get_entry_controls failed [%d]: %s\n",
+              lret, sss_ldap_err2string(lret));
+        return EIO;
+    }
+
+    ctrl = ldap_control_find(LDAP_CONTROL_SYNC_STATE, ctrls, NULL);
+    if (ctrl == NULL) {
+        DEBUG(SSSDBG_MINOR_FAILURE,
+              "Entry without Sync State control, ignoring\n");
+        ret = EOK;
+        goto done;
+    }
+
+    ber = ber_init(&ctrl->ldctl_value);
+    if (ber == NULL) {
+        ret = ENOMEM;
+        goto done;
+    }
+
+    if (ber_scanf(ber, "{em", &state, &uuid) == LBER_ERROR) {
+        DEBUG(SSSDBG_OP_FAILURE, "Malformed Sync State control\n");
+        ret = EIO;
+        goto done;
+    }
+
+    if (ber_peek_tag(ber, &len) == LDAP_TAG_SYNC_COOKIE) {
+        if (ber_scanf(ber, "m", &cookie) == LBER_ERROR) {
+            DEBUG(SSSDBG_OP_FAILURE, "Malformed Sync State cookie\n");
+            ret = EIO;
+            goto done;
+        }
+
+        ret = sdap_sync_set_cookie(ctx->batch, &ctx->batch->cookie, &cookie);
+        if (ret != EOK) {
+            goto done;
+        }
+    }
+
+    switch (state) {
+    case LDAP_SYNC_ADD:
+    case LDAP_SYNC_MODIFY:
+        ret = sdap_sync_entry_changed(ctx, msg);
+        break;
+    case LDAP_SYNC_DELETE:
+        dn = ldap_get_dn(ctx->sh->ldap, msg);
+        if (dn == NULL) {
+            ret = EIO;
+            break;
+        }
+
+        ret = sdap_sync_batch_add(ctx->batch, &ctx->batch->dns,
+                                  &ctx->batch->num_dns, dn);
+        ldap_memfree(dn);
+        break;
+    default:
+        /* present entries are unchanged */
+        ret = EOK;
+        break;
+    }
+
+done:
+    if (ber != NULL) {
+        ber_free(ber, 1);
+    }
+    ldap_controls_free(ctrls);
+    return ret;
+}
+
+static errno_t sdap_sync_info_cookie(struct sdap_sync_ctx *ctx,
+                                     BerElement *ber)
+{
+    struct berval cookie;
+    ber_len_t len;
+
+    if (ber_peek_tag(ber, &len) != LDAP_TAG_SYNC_COOKIE) {
+        return EOK;
+    }
+
+    if (ber_scanf(ber, "m", &cookie) == LBER_ERROR) {
+        return EIO;
+    }
+
+    return sdap_sync_set_cookie(ctx->batch, &ctx->batch->cookie, &cookie);
+}
+
+static errno_t sdap_sync_info_id_set(struct sdap_sync_ctx *ctx,
+                                     BerElement *ber)
+{
+    BerVarray uuids = NULL;
+    ber_int_t deletes = 0;
+    ber_len_t len;
+    unsigned char *u;
+    char str[37];
+    errno_t ret;
+    size_t i;
+
+    if (ber_scanf(ber, "{") == LBER_ERROR) {
+        return EIO;
+    }
+
+    ret = sdap_sync_info_cookie(ctx, ber);
+    if (ret != EOK) {
+        return ret;
+    }
+
+    if (ber_peek_tag(ber, &len) == LDAP_TAG_REFRESHDELETES) {
+        if (ber_scanf(ber, "b", &deletes) == LBER_ERROR) {
+            return EIO;
+        }
+    }
+
+    if (ber_scanf(ber, "[W]}", &uuids) == LBER_ERROR) {
+        return EIO;
+    }
+
+    /* a set of present entries is only relevant for a refresh without
+     * a cookie, the fallback cleanup handles those */
+    if (!deletes || uuids == NULL) {
+        ret = EOK;
+        goto done;
+    }
+
+    for (i = 0; uuids[i].bv_val != NULL; i++) {
+        if (uuids[i].bv_len != SDAP_SYNC_UUID_LEN) {
+            continue;
+        }
+
+        u = (unsigned char *) uuids[i].bv_val;
+        snprintf(str, sizeof(str),
+                 "%02x%02x%02x%02x-%02x%02x-%02x%02x-%02x%02x-"
+                 "%02x%02x%02x%02x%02x%02x",
+                 u[0], u[1], u[2], u[3], u[4], u[5], u[6], u[7],
+                 u[8], u[9], u[10], u[11], u[12], u[13], u[14], u[15]);
+
+        ret = sdap_sync_batch_add(ctx->batch, &ctx->batch->uuids,
+                                  &ctx->batch->num_uuids, str);
+        if (ret != EOK) {
+            goto done;
+        }
+    }
+
+    ret = EOK;
+
+done:
+    ber_bvarray_free(uuids);
+    return ret;
+}
+
+static errno_t sdap_sync_info(struct sdap_sync_ctx *ctx, LDAPMessage *msg)
+{
+    struct berval *data = NULL;
+    BerElement *ber = NULL;
+    char *oid = NULL;
+    ber_int_t refresh_done = 1;
+    ber_len_t len;
+    ber_tag_t tag;
+    errno_t ret;
+    int lret;
+
+    lret = ldap_parse_intermediate(ctx->sh->ldap, msg, &oid, &data, NULL, 0);
+    if (lret != LDAP_SUCCESS) {
+        DEBUG(SSSDBG_OP_FAILURE, "ldap_parse_intermediate failed [%d]: %s\n",
+              lret, sss_ldap_err2string(lret));
+        return EIO;
+    }
+
+    if (oid == NULL || strcmp(oid, LDAP_SYNC_INFO) != 0 || data == NULL) {
+        DEBUG(SSSDBG_TRACE_ALL, "Ignoring intermediate response [%s]\n",
+              oid == NULL ? "-" : oid);
+        ret = EOK;
+        goto done;
+    }
+
+    ber = ber_init(data);
+    if (ber == NULL) {
+        ret = ENOMEM;
+        goto done;
+    }
+
+    tag = ber_peek_tag(ber, &len);
+    switch (tag) {
+    case LDAP_TAG_SYNC_NEW_COOKIE:
+        ret = sdap_sync_info_cookie(ctx, ber);
+        break;
+    case LDAP_TAG_SYNC_REFRESH_DELETE:
+    case LDAP_TAG_SYNC_REFRESH_PRESENT:
+        if (ber_scanf(ber, "{") == LBER_ERROR) {
+            ret = EIO;
+            break;
+        }
+
+        ret = sdap_sync_info_cookie(ctx, ber);
+        if (ret != EOK) {
+            break;
+        }
+
+        if (ber_peek_tag(ber, &len) == LDAP_TAG_REFRESHDONE) {
+            if (ber_scanf(ber, "b", &refresh_done) == LBER_ERROR) {
+                ret = EIO;
+                break;
+            }
+        }
+
+        if (refresh_done) {
+            ctx->batch->refresh_done = true;
+        }
+        ret = EOK;
+        break;
+    case LDAP_TAG_SYNC_ID_SET:
+        ret = sdap_sync_info_id_set(ctx, ber);
+        break;
+    default:
+        DEBUG(SSSDBG_MINOR_FAILURE, "Unknown syncInfo message [%lx]\n",
+              (unsigned long) tag);
+        ret = EOK;
+        break;
+    }
+
+    if (ret != EOK) {
+        DEBUG(SSSDBG_OP_FAILURE, "Malformed syncInfo message\n");
+    }
+
+done:
+    if (ber != NULL) {
+        ber_free(ber, 1);
+    }
+    ldap_memfree(oid);
+    ber_bvfree(data);
+    return ret;
+}
+
+static void sdap_sync_result(struct sdap_sync_ctx *ctx, LDAPMessage *msg)
+{
+    char *errmsg = NULL;
+    int result;
+    int lret;
+
+    lret = ldap_parse_result(ctx->sh->ldap, msg, &result,
+                             NULL, &errmsg, NULL, NULL, 0);
+    if (lret != LDAP_SUCCESS) {
+        DEBUG(SSSDBG_OP_FAILURE, "ldap_parse_result failed [%d]: %s\n",
+              lret, sss_ldap_err2string(lret));
+        sdap_sync_fail(ctx, EIO, SDAP_SYNC_RETRY_DELAY);
+        return;
+    }
+
+    switch (result) {
+    case LDAP_SYNC_REFRESH_REQUIRED:
+        DEBUG(SSSDBG_TRACE_FUNC, "Server requires a full refresh\n");
+        talloc_zfree(ctx->cookie);
+        sdap_sync_fail(ctx, EOK, 0);
+        break;
+    case LDAP_SUCCESS:
+        DEBUG(SSSDBG_TRACE_FUNC, "Server finished the synchronization, "
+              "restarting\n");
+        sdap_sync_fail(ctx, EOK, 0);
+        break;
+    default:
+        DEBUG(SSSDBG_OP_FAILURE, "Content synchronization failed [%d]: %s "
+              "(%s)\n", result, sss_ldap_err2string(result),
+              errmsg == NULL ? "no message" : errmsg);
+        sdap_sync_fail(ctx, EIO, SDAP_SYNC_RETRY_DELAY);
+        break;
+    }
+
+    ldap_memfree(errmsg);
+}
+
+static void sdap_sync_process(struct sdap_sync_ctx *ctx,
+                              struct sdap_msg *reply)
+{
+    struct timeval tv;
+    errno_t ret;
+
+    switch (ldap_msgtype(reply->msg)) {
+    case LDAP_RES_SEARCH_ENTRY:
+        ret = sdap_sync_entry(ctx, reply->msg);
+        break;
+    case LDAP_RES_INTERMEDIATE:
+        ret = sdap_sync_info(ctx, reply->msg);
+        break;
+    case LDAP_RES_SEARCH_RESULT:
+        sdap_sync_result(ctx, reply->msg);
+        return;
+    default:
+        /* references are not followed */
+        ret = EOK;
+        break;
+    }
+
+    if (ret != EOK) {
+        sdap_sync_fail(ctx, ret, SDAP_SYNC_RETRY_DELAY);
+        return;
+    }
+
+    if (ctx->batch->refresh_done
+            || sdap_sync_batch_count(ctx->batch) >= SDAP_SYNC_BATCH_SIZE) {
+        sdap_sync_flush(ctx, true);
+        return;
+    }
+
+    if (sdap_sync_batch_count(ctx->batch) == 0) {
+        /* nothing to store, the cookie can be advanced right away */
+        if (ctx->batch->cookie != NULL) {
+            talloc_free(ctx->cookie);
+            ctx->cookie = talloc_steal(ctx, ctx->batch->cookie);
+            ctx->batch->cookie = NULL;
+        }
+    } else if (ctx->flush_timer == NULL) {
+        tv = tevent_timeval_current_ofs(SDAP_SYNC_FLUSH_DELAY, 0);
+        ctx->flush_timer = tevent_add_timer(ctx->ev, ctx, tv,
+                                            sdap_sync_flush_timeout, ctx);
+        if (ctx->flush_timer == NULL) {
+            sdap_sync_fail(ctx, ENOMEM, SDAP_SYNC_RETRY_DELAY);
+            return;
+        }
+    }
+
+    sdap_unlock_next_reply(ctx->sop);
+}
+
+static void sdap_sync_op_cb(struct sdap_op *op, struct sdap_msg *reply,
+                            int error, void *pvt)
+{
+    struct sdap_sync_ctx *ctx = talloc_get_type(pvt, struct sdap_sync_ctx);
+
+    if (error != EOK || reply == NULL) {
+        DEBUG(SSSDBG_OP_FAILURE, "Content synchronization interrupted "
+              "[%d]: %s\n", error, sss_strerror(error));
+        sdap_sync_fail(ctx, error != EOK ? error : EIO,
+                       SDAP_SYNC_RETRY_DELAY);
+        return;
+    }
+
+    if (ctx->flush_req != NULL) {
+        /* keep the reply queued until the cache was updated */
+        ctx->held = true;
+        return;
+    }
+
+    sdap_sync_process(ctx, reply);
+}
+
+/* ==Starting-the-search================================================== */
+
+static errno_t sdap_sync_create_control(struct berval *cookie,
+                                        LDAPControl **_ctrl)
+{
+    BerElement *ber;
+    struct berval value;
+    errno_t ret;
+    int lret;
+
+    ber = ber_alloc_t(LBER_USE_DER);
+    if (ber == NULL) {
+        return ENOMEM;
+    }
+
+    lret = ber_printf(ber, "{e", (ber_int_t) LDAP_SYNC_REFRESH_AND_PERSIST);
+    if (lret != -1 && cookie != NULL) {
+        lret = ber_printf(ber, "O", cookie);
+    }
+    if (lret != -1) {
+        lret = ber_printf(ber, "}");
+    }
+    if (lret == -1) {
+        ret = EIO;
+        goto done;
+    }
+
+    lret = ber_flatten2(ber, &value, 0);
+    if (lret == -1) {
+        ret = EIO;
+        goto done;
+    }
+
+    lret = ldap_control_create(LDAP_CONTROL_SYNC, 1, &value, 1, _ctrl);
+    if (lret != LDAP_SUCCESS) {
+        ret = EIO;
+        goto done;
+    }
+
+    ret = EOK;
+
+done:
+    ber_free(ber, 1);
+    return ret;
+}
+
+static errno_t sdap_sync_search(struct sdap_sync_ctx *ctx)
+{
+    LDAPControl *ctrls[2] = { NULL, NULL };
+    int msgid;
+    errno_t ret;
+    int lret;
+
+    ctx->batch = talloc_zero(ctx, struct sdap_sync_batch);
+    if (ctx->batch == NULL) {
+        return ENOMEM;
+    }
+
+    ret = sdap_sync_create_control(ctx->cookie, &ctrls[0]);
+    if (ret != EOK) {
+        DEBUG(SSSDBG_OP_FAILURE, "Unable to create Sync Request control\n");
+        return ret;
+    }
+
+    DEBUG(SSSDBG_TRACE_FUNC, "Starting content synchronization of [%s] "
+          "with filter [%s] (%s cookie)\n", ctx->base, ctx->filter,
+          ctx->cookie == NULL ? "without" : "with");
+
+    lret = ldap_search_ext(ctx->sh->ldap, ctx->base, LDAP_SCOPE_SUBTREE,
+                           ctx->filter, discard_const(ctx->attrs), 0,
+                           ctrls, NULL, NULL, LDAP_NO_LIMIT, &msgid);
+    ldap_control_free(ctrls[0]);
+    if (lret != LDAP_SUCCESS) {
+        DEBUG(SSSDBG_OP_FAILURE, "ldap_search_ext failed [%d]: %s\n",
+              lret, sss_ldap_err2string(lret));
+        return EIO;
+    }
+
+    /* the search never finishes on its own, no timeout */
+    ret = sdap_op_add(ctx, ctx->ev, ctx->sh, msgid,
+                      sdap_sync_op_cb, ctx, 0, &ctx->sop);
+    if (ret != EOK) {
+        DEBUG(SSSDBG_CRIT_FAILURE, "Failed to set up operation!\n");
+        return ret;
+    }
+
+    return EOK;
+}
+
+static void sdap_sync_connect_done(struct tevent_req *subreq);
+
+static void sdap_sync_restart(struct tevent_context *ev,
+                              struct tevent_timer *te,
+                              struct timeval tv, void *pvt)
+{
+    struct sdap_sync_ctx *ctx;
+    struct tevent_req *subreq;
+    int dp_error;
+    errno_t ret;
+
+    ctx = talloc_get_type(pvt, struct sdap_sync_ctx);
+    ctx->restart_timer = NULL;
+
+    if (ctx->op != NULL) {
+        sdap_id_op_done(ctx->op, ctx->op_error, &dp_error);
+        talloc_zfree(ctx->op);
+        ctx->sh = NULL;
+    }
+
+    ctx->op = sdap_id_op_create(ctx, ctx->conn->conn_cache);
+    if (ctx->op == NULL) {
+        DEBUG(SSSDBG_CRIT_FAILURE, "sdap_id_op_create failed\n");
+        sdap_sync_schedule(ctx, SDAP_SYNC_RETRY_DELAY);
+        return;
+    }
+
+    subreq = sdap_id_op_connect_send(ctx->op, ctx, &ret);
+    if (subreq == NULL) {
+        DEBUG(SSSDBG_OP_FAILURE, "sdap_id_op_connect_send failed "
+              "[%d]: %s\n", ret, sss_strerror(ret));
+        talloc_zfree(ctx->op);
+        sdap_sync_schedule(ctx, SDAP_SYNC_RETRY_DELAY);
+        return;
+    }
+
+    tevent_req_set_callback(subreq, sdap_sync_connect_done, ctx);
+}
+
+static void sdap_sync_connect_done(struct tevent_req *subreq)
+{
+    struct sdap_sync_ctx *ctx;
+    int dp_error;
+    errno_t ret;
+
+    ctx = tevent_req_callback_data(subreq, struct sdap_sync_ctx);
+
+    ret = sdap_id_op_connect_recv(subreq, &dp_error);
+    talloc_zfree(subreq);
+    if (ret != EOK) {
+        DEBUG(SSSDBG_MINOR_FAILURE, "Unable to connect for content "
+              "synchronization [%d]: %s\n", ret, sss_strerror(ret));
+        talloc_zfree(ctx->op);
+        sdap_sync_schedule(ctx, SDAP_SYNC_RETRY_DELAY);
+        return;
+    }
+
+    ctx->sh = sdap_id_op_handle(ctx->op);
+
+    if (!sdap_is_control_supported(ctx->sh, LDAP_CONTROL_SYNC)) {
+        DEBUG(SSSDBG_CONF_SETTINGS, "The server does not support content "
+              "synchronization, only the periodic enumeration is used\n");
+        ctx->op_error = EOK;
+        sdap_sync_schedule(ctx, SDAP_SYNC_UNSUPPORTED_DELAY);
+        return;
+    }
+
+    ret = sdap_sync_search(ctx);
+    if (ret != EOK) {
+        sdap_sync_fail(ctx, ret, SDAP_SYNC_RETRY_DELAY);
+        return;
+    }
+}
+
+static void sdap_sync_schedule(struct sdap_sync_ctx *ctx, time_t delay)
+{
+    struct timeval tv;
+
+    talloc_zfree(ctx->restart_timer);
+
+    tv = tevent_timeval_current_ofs(delay, 0);
+    ctx->restart_timer = tevent_add_timer(ctx->ev, ctx, tv,
+                                          sdap_sync_restart, ctx);
+    if (ctx->restart_timer == NULL) {
+        DEBUG(SSSDBG_CRIT_FAILURE, "Unable to schedule content "
+              "synchronization, only the periodic enumeration is used\n");
+    }
+}
+
+errno_t sdap_sync_setup(struct sdap_id_ctx *id_ctx,
+                        struct sdap_domain *sdom,
+                        struct sdap_sync_ctx **_sync_ctx)
+{
+    struct sdap_options *opts = id_ctx->opts;
+    struct sdap_sync_ctx *ctx;
+    char *oc_list;
+    errno_t ret;
+
+    if (sdom->search_bases == NULL || sdom->search_bases[0] == NULL) {
+        DEBUG(SSSDBG_CRIT_FAILURE, "No search base for [%s]\n",
+              sdom->dom->name);
+        return EINVAL;
+    }
+
+    ctx = talloc_zero(id_ctx, struct sdap_sync_ctx);
+    if (ctx == NULL) {
+        return ENOMEM;
+    }
+
+    ctx->ev = id_ctx->be->ev;
+    ctx->id_ctx = id_ctx;
+    ctx->sdom = sdom;
+    ctx->base = sdom->search_bases[0]->basedn;
+
+    if (sdom->search_bases[1] != NULL) {
+        DEBUG(SSSDBG_CONF_SETTINGS, "Only [%s] is synchronized, entries "
+              "from other search bases are enumerated\n", ctx->base);
+    }
+
+    oc_list = sdap_make_oc_list(ctx, opts->group_map);
+    if (oc_list == NULL) {
+        ret = ENOMEM;
+        goto done;
+    }
+
+    ctx->filter = talloc_asprintf(ctx, "(|(objectclass=%s)(%s))",
+                                  opts->user_map[SDAP_OC_USER].name,
+                                  oc_list);
+    if (ctx->filter == NULL) {
+        ret = ENOMEM;
+        goto done;
+    }
+
+    ctx->attrs = talloc_zero_array(ctx, const char *, 4);
+    if (ctx->attrs == NULL) {
+        ret = ENOMEM;
+        goto done;
+    }
+    ctx->attrs[0] = "objectClass";
+    ctx->attrs[1] = opts->user_map[SDAP_AT_USER_NAME].name;
+    ctx->attrs[2] = opts->group_map[SDAP_AT_GROUP_NAME].name;
+
+    /* a connection of its own, the persistent search must not block
+     * the connection used for regular lookups */
+    ctx->conn = talloc_zero(ctx, struct sdap_id_conn_ctx);
+    if (ctx->conn == NULL) {
+        ret = ENOMEM;
+        goto done;
+    }
+    ctx->conn->id_ctx = id_ctx;
+    ctx->conn->service = id_ctx->conn->service;
+
+    ret = sdap_id_conn_cache_create(ctx->conn, ctx->conn,
+                                    &ctx->conn->conn_cache);
+    if (ret != EOK) {
+        goto done;
+    }
+
+    DEBUG(SSSDBG_TRACE_FUNC, "Setting up content synchronization for %s\n",
+          sdom->dom->name);
+
+    sdap_sync_schedule(ctx, 0);
+    if (ctx->restart_timer == NULL) {
+        ret = ENOMEM;
+        goto done;
+    }
+
+    *_sync_ctx = ctx;
+    ret = EOK;
+
+done:
+    if (ret != EOK) {
+        talloc_free(ctx);
+    }
+    return ret;
+}
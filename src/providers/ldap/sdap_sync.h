@@ -0,0 +1,40 @@
+/*
+    SSSD
+
+    LDAP Content Synchronization (RFC 4533) consumer
+
+    Copyright (C) 2026 Red Hat
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef _SDAP_SYNC_H_
+#define _SDAP_SYNC_H_
+
+#include "providers/ldap/ldap_common.h"
+
+struct sdap_sync_ctx;
+
+/* Start a refreshAndPersist content synchronization of users and groups
+ * under the domain search base on a dedicated connection. Changes are
+ * applied to the cache as they are announced by the server. */
+errno_t sdap_sync_setup(struct sdap_id_ctx *id_ctx,
+                        struct sdap_domain *sdom,
+                        struct sdap_sync_ctx **_sync_ctx);
+
+/* True if the initial refresh has finished and the consumer is receiving
+ * persistent updates, i.e. the cache is up to date with the server. */
+bool sdap_sync_is_current(struct sdap_sync_ctx *sync_ctx);
+
+#endif /* _SDAP_SYNC_H_ */
@@ -88,6 +88,31 @@ struct resolv_ctx {
      * if our pending requests didn't timeout. */
     int pending_requests;
     struct tevent_timer *timeout_watcher;
+
+    /* Answers received from DNS, most recently used first. Disabled
+     * unless resolv_set_cache_options() is called. */
+    bool cache_enabled;
+    uint32_t cache_negative_timeout;
+    struct resolv_cache_entry *cache;
+    struct resolv_cache_entry *cache_last;
+    uint32_t cache_count;
+    uint64_t cache_hits;
+    uint64_t cache_misses;
+};
+
+struct resolv_cache_entry {
+    struct resolv_cache_entry *prev;
+    struct resolv_cache_entry *next;
+
+    /* ns_t_a, ns_t_aaaa or ns_t_srv */
+    int type;
+    char *name;
+    time_t expire;
+
+    /* ARES_SUCCESS or the c-ares code of a negative answer */
+    int status;
+    struct resolv_hostent *rhostent;
+    struct ares_srv_reply *reply_list;
 };
 
 struct request_watch {
@@ -488,6 +513,9 @@ done:
 void
 resolv_reread_configuration(struct resolv_ctx *ctx)
 {
+    /* The new configuration may point to different servers or search
+     * domains, do not keep answers that came from the old ones. */
+    resolv_cache_flush(ctx);
     recreate_ares_channel(ctx);
 }
 
@@ -663,6 +691,301 @@ fail:
     return NULL;
 }
 
+/* =================== DNS answer cache ==================================*/
+
+void
+resolv_set_cache_options(struct resolv_ctx *ctx, bool enabled,
+                         uint32_t negative_timeout)
+{
+    ctx->cache_enabled = enabled;
+    ctx->cache_negative_timeout = negative_timeout;
+
+    if (!enabled) {
+        resolv_cache_flush(ctx);
+    }
+}
+
+void
+resolv_get_cache_stats(struct resolv_ctx *ctx,
+                       uint64_t *_hits, uint64_t *_misses)
+{
+    if (_hits != NULL) {
+        *_hits = ctx->cache_hits;
+    }
+    if (_misses != NULL) {
+        *_misses = ctx->cache_misses;
+    }
+}
+
+static const char *
+resolv_cache_type_str(int type)
+{
+    switch (type) {
+    case ns_t_a:
+        return "A";
+    case ns_t_aaaa:
+        return "AAAA";
+    case ns_t_srv:
+        return "SRV";
+    }
+
+    return "unknown";
+}
+
+static void
+resolv_cache_remove(struct resolv_ctx *ctx, struct resolv_cache_entry *entry)
+{
+    if (ctx->cache_last == entry) {
+        ctx->cache_last = entry->prev;
+    }
+
+    DLIST_REMOVE(ctx->cache, entry);
+    ctx->cache_count--;
+    talloc_free(entry);
+}
+
+void
+resolv_cache_flush(struct resolv_ctx *ctx)
+{
+    if (ctx->cache_count > 0) {
+        DEBUG(SSSDBG_TRACE_FUNC, "Flushing %"PRIu32" cached DNS answers\n",
+              ctx->cache_count);
+    }
+
+    while (ctx->cache != NULL) {
+        resolv_cache_remove(ctx, ctx->cache);
+    }
+}
+
+/* Returns a valid entry for the given record or NULL. Expired entries are
+ * dropped on the way. */
+static struct resolv_cache_entry *
+resolv_cache_lookup(struct resolv_ctx *ctx, int type, const char *name)
+{
+    struct resolv_cache_entry *entry;
+    time_t now;
+
+    if (!ctx->cache_enabled) {
+        return NULL;
+    }
+
+    now = time(NULL);
+    DLIST_FOR_EACH(entry, ctx->cache) {
+        if (entry->type == type && strcasecmp(entry->name, name) == 0) {
+            break;
+        }
+    }
+
+    if (entry != NULL && entry->expire <= now) {
+        resolv_cache_remove(ctx, entry);
+        entry = NULL;
+    }
+
+    if (entry == NULL) {
+        ctx->cache_misses++;
+        return NULL;
+    }
+
+    ctx->cache_hits++;
+    DEBUG(SSSDBG_TRACE_LIBS, "Using cached %s answer for '%s' "
+          "(%"PRIu64" hits, %"PRIu64" misses)\n", resolv_cache_type_str(type),
+          name, ctx->cache_hits, ctx->cache_misses);
+
+    if (entry != ctx->cache) {
+        if (ctx->cache_last == entry) {
+            ctx->cache_last = entry->prev;
+        }
+        DLIST_PROMOTE(ctx->cache, entry);
+    }
+
+    return entry;
+}
+
+/* Takes ownership of rhostent and reply_list. */
+static void
+resolv_cache_store(struct resolv_ctx *ctx, int type, const char *name,
+                   int status, uint32_t ttl,
+                   struct resolv_hostent *rhostent,
+                   struct ares_srv_reply *reply_list)
+{
+    struct resolv_cache_entry *entry;
+
+    if (!ctx->cache_enabled || ttl == 0
+            || (status == ARES_SUCCESS
+                    && rhostent == NULL && reply_list == NULL)) {
+        talloc_free(rhostent);
+        talloc_free(reply_list);
+        return;
+    }
+
+    DLIST_FOR_EACH(entry, ctx->cache) {
+        if (entry->type == type && strcasecmp(entry->name, name) == 0) {
+            resolv_cache_remove(ctx, entry);
+            break;
+        }
+    }
+
+    while (ctx->cache_count >= RESOLV_CACHE_MAX_ENTRIES
+            && ctx->cache_last != NULL) {
+        resolv_cache_remove(ctx, ctx->cache_last);
+    }
+
+    /* Failures are not fatal, the answer just won't be cached. */
+    entry = talloc_zero(ctx, struct resolv_cache_entry);
+    if (entry == NULL) {
+        talloc_free(rhostent);
+        talloc_free(reply_list);
+        return;
+    }
+
+    entry->name = talloc_strdup(entry, name);
+    if (entry->name == NULL) {
+        talloc_free(entry);
+        talloc_free(rhostent);
+        talloc_free(reply_list);
+        return;
+    }
+
+    entry->type = type;
+    entry->status = status;
+    entry->expire = time(NULL) + ttl;
+    entry->rhostent = talloc_steal(entry, rhostent);
+    entry->reply_list = talloc_steal(entry, reply_list);
+
+    if (ctx->cache_last == NULL) {
+        ctx->cache_last = entry;
+    }
+    DLIST_ADD(ctx->cache, entry);
+    ctx->cache_count++;
+
+    DEBUG(SSSDBG_TRACE_LIBS, "Caching %s %s answer for '%s' for %"PRIu32
+          " seconds\n", status == ARES_SUCCESS ? "positive" : "negative",
+          resolv_cache_type_str(type), name, ttl);
+}
+
+static uint32_t
+resolv_cache_remaining_ttl(struct resolv_cache_entry *entry)
+{
+    time_t now = time(NULL);
+
+    return entry->expire > now ? entry->expire - now : 0;
+}
+
+/* Copies a host entry, the address TTLs are capped at max_ttl. */
+static struct resolv_hostent *
+resolv_cache_copy_hostent(TALLOC_CTX *mem_ctx,
+                          struct resolv_hostent *src,
+                          uint32_t max_ttl)
+{
+    struct resolv_hostent *ret;
+    size_t addrlen;
+    int len;
+    int i;
+
+    ret = talloc_zero(mem_ctx, struct resolv_hostent);
+    if (ret == NULL) {
+        return NULL;
+    }
+
+    ret->family = src->family;
+    if (src->name != NULL) {
+        ret->name = talloc_strdup(ret, src->name);
+        if (ret->name == NULL) {
+            goto fail;
+        }
+    }
+
+    if (src->aliases != NULL) {
+        for (len = 0; src->aliases[len] != NULL; len++);
+
+        ret->aliases = talloc_array(ret, char *, len + 1);
+        if (ret->aliases == NULL) {
+            goto fail;
+        }
+
+        for (i = 0; i < len; i++) {
+            ret->aliases[i] = talloc_strdup(ret->aliases, src->aliases[i]);
+            if (ret->aliases[i] == NULL) {
+                goto fail;
+            }
+        }
+        ret->aliases[len] = NULL;
+    }
+
+    addrlen = src->family == AF_INET6 ? sizeof(struct in6_addr)
+                                      : sizeof(struct in_addr);
+
+    for (len = 0; src->addr_list[len] != NULL; len++);
+
+    ret->addr_list = talloc_array(ret, struct resolv_addr *, len + 1);
+    if (ret->addr_list == NULL) {
+        goto fail;
+    }
+
+    for (i = 0; i < len; i++) {
+        ret->addr_list[i] = talloc_zero(ret->addr_list, struct resolv_addr);
+        if (ret->addr_list[i] == NULL) {
+            goto fail;
+        }
+
+        ret->addr_list[i]->ipaddr = talloc_memdup(ret->addr_list[i],
+                                                  src->addr_list[i]->ipaddr,
+                                                  addrlen);
+        if (ret->addr_list[i]->ipaddr == NULL) {
+            goto fail;
+        }
+        ret->addr_list[i]->ttl = MIN(src->addr_list[i]->ttl, max_ttl);
+    }
+    ret->addr_list[len] = NULL;
+
+    return ret;
+
+fail:
+    talloc_free(ret);
+    return NULL;
+}
+
+static struct ares_srv_reply *
+resolv_cache_copy_srv_reply(TALLOC_CTX *mem_ctx,
+                            struct ares_srv_reply *reply_list)
+{
+    struct ares_srv_reply *new_list = NULL;
+    struct ares_srv_reply *ptr = NULL;
+    struct ares_srv_reply *src;
+
+    for (src = reply_list; src != NULL; src = src->next) {
+        if (new_list == NULL) {
+            new_list = talloc_zero(mem_ctx, struct ares_srv_reply);
+            ptr = new_list;
+        } else {
+            ptr->next = talloc_zero(new_list, struct ares_srv_reply);
+            ptr = ptr->next;
+        }
+        if (ptr == NULL) {
+            talloc_free(new_list);
+            return NULL;
+        }
+
+        ptr->weight = src->weight;
+        ptr->priority = src->priority;
+        ptr->port = src->port;
+        ptr->host = talloc_strdup(ptr, src->host);
+        if (ptr->host == NULL) {
+            talloc_free(new_list);
+            return NULL;
+        }
+    }
+
+    return new_list;
+}
+
+/* Negative answers are only cached if a negative timeout is set. */
+static bool
+resolv_cache_is_negative(int status)
+{
+    return status == ARES_ENOTFOUND || status == ARES_ENODATA;
+}
+
 /* =================== Resolve host name in files =========================*/
 struct gethostbyname_files_state {
     struct resolv_ctx *resolv_ctx;
@@ -784,6 +1107,18 @@ resolv_gethostbyname_dns_query_done(void *arg, int status, int timeouts,
 static int
 resolv_gethostbyname_dns_parse(struct gethostbyname_dns_state *state,
                                int status, unsigned char *abuf, int alen);
+static void
+resolv_gethostbyname_dns_cached(struct tevent_req *req,
+                                struct gethostbyname_dns_state *state,
+                                struct resolv_cache_entry *entry);
+static void
+resolv_gethostbyname_dns_cache_store(struct gethostbyname_dns_state *state);
+
+static int
+resolv_gethostbyname_dns_type(struct gethostbyname_dns_state *state)
+{
+    return (state->family == AF_INET) ? ns_t_a : ns_t_aaaa;
+}
 
 static struct tevent_req *
 resolv_gethostbyname_dns_send(TALLOC_CTX *mem_ctx, struct tevent_context *ev,
@@ -836,6 +1171,7 @@ resolv_gethostbyname_dns_wakeup(struct tevent_req *subreq)
                                                 struct tevent_req);
     struct gethostbyname_dns_state *state = tevent_req_data(req,
                                         struct gethostbyname_dns_state);
+    struct resolv_cache_entry *entry;
 
     if (!tevent_wakeup_recv(subreq)) {
         tevent_req_error(req, EIO);
@@ -843,6 +1179,14 @@ resolv_gethostbyname_dns_wakeup(struct tevent_req *subreq)
     }
     talloc_zfree(subreq);
 
+    entry = resolv_cache_lookup(state->resolv_ctx,
+                                resolv_gethostbyname_dns_type(state),
+                                state->name);
+    if (entry != NULL) {
+        resolv_gethostbyname_dns_cached(req, state, entry);
+        return;
+    }
+
     if (state->resolv_ctx->channel == NULL) {
         DEBUG(SSSDBG_CRIT_FAILURE,
               "Invalid ares channel - this is likely a bug\n");
@@ -853,6 +1197,55 @@ resolv_gethostbyname_dns_wakeup(struct tevent_req *subreq)
     resolv_gethostbyname_dns_query(req, state);
 }
 
+static void
+resolv_gethostbyname_dns_cached(struct tevent_req *req,
+                                struct gethostbyname_dns_state *state,
+                                struct resolv_cache_entry *entry)
+{
+    state->status = entry->status;
+    state->timeouts = 0;
+
+    if (entry->status != ARES_SUCCESS) {
+        tevent_req_error(req, ENOENT);
+        return;
+    }
+
+    state->rhostent = resolv_cache_copy_hostent(state, entry->rhostent,
+                                          resolv_cache_remaining_ttl(entry));
+    if (state->rhostent == NULL) {
+        tevent_req_error(req, ENOMEM);
+        return;
+    }
+
+    tevent_req_done(req);
+}
+
+static void
+resolv_gethostbyname_dns_cache_store(struct gethostbyname_dns_state *state)
+{
+    struct resolv_hostent *copy;
+    uint32_t ttl = UINT32_MAX;
+    int i;
+
+    if (!state->resolv_ctx->cache_enabled || state->rhostent == NULL) {
+        return;
+    }
+
+    /* The answer is only valid as long as its shortest lived address. */
+    for (i = 0; state->rhostent->addr_list[i] != NULL; i++) {
+        ttl = MIN(ttl, state->rhostent->addr_list[i]->ttl);
+    }
+
+    copy = resolv_cache_copy_hostent(NULL, state->rhostent, UINT32_MAX);
+    if (copy == NULL) {
+        return;
+    }
+
+    resolv_cache_store(state->resolv_ctx,
+                       resolv_gethostbyname_dns_type(state),
+                       state->name, ARES_SUCCESS, ttl, copy, NULL);
+}
+
 static void
 resolv_gethostbyname_dns_query(struct tevent_req *req,
                                struct gethostbyname_dns_state *state)
@@ -870,7 +1263,7 @@ resolv_gethostbyname_dns_query(struct tevent_req *req,
 
     ares_search(state->resolv_ctx->channel,
                 state->name, ns_c_in,
-                (state->family == AF_INET) ? ns_t_a : ns_t_aaaa,
+                resolv_gethostbyname_dns_type(state),
                 resolv_gethostbyname_dns_query_done, rreq);
 }
 
@@ -909,7 +1302,13 @@ resolv_gethostbyname_dns_query_done(void *arg, int status, int timeouts,
         return;
     }
 
-    if (status == ARES_ENOTFOUND || status == ARES_ENODATA) {
+    if (resolv_cache_is_negative(status)) {
+        resolv_cache_store(state->resolv_ctx,
+                           resolv_gethostbyname_dns_type(state),
+                           state->name, status,
+                           state->resolv_ctx->cache_negative_timeout,
+                           NULL, NULL);
+
         /* Just say we didn't find anything and let the caller decide
          * about retrying */
         tevent_req_error(req, ENOENT);
@@ -930,6 +1329,7 @@ resolv_gethostbyname_dns_query_done(void *arg, int status, int timeouts,
         return;
     }
 
+    resolv_gethostbyname_dns_cache_store(state);
     tevent_req_done(req);
 }
 
@@ -1575,6 +1975,10 @@ ares_getsrv_wakeup(struct tevent_req *subreq);
 static void
 resolv_getsrv_query(struct tevent_req *req,
                     struct getsrv_state *state);
+static void
+resolv_getsrv_cached(struct tevent_req *req,
+                     struct getsrv_state *state,
+                     struct resolv_cache_entry *entry);
 
 struct tevent_req *
 resolv_getsrv_send(TALLOC_CTX *mem_ctx, struct tevent_context *ev,
@@ -1736,6 +2140,12 @@ resolv_getsrv_done(void *arg, int status, int timeouts, unsigned char *abuf, int
     state->timeouts = timeouts;
 
     if (status != ARES_SUCCESS) {
+        if (resolv_cache_is_negative(status)) {
+            resolv_cache_store(state->resolv_ctx, ns_t_srv, state->query,
+                               status,
+                               state->resolv_ctx->cache_negative_timeout,
+                               NULL, NULL);
+        }
         ret = return_code(status);
         goto fail;
     }
@@ -1759,6 +2169,12 @@ resolv_getsrv_done(void *arg, int status, int timeouts, unsigned char *abuf, int
     }
     DEBUG(SSSDBG_TRACE_LIBS, "Using TTL [%"PRIu32"]\n", state->ttl);
 
+    if (state->resolv_ctx->cache_enabled) {
+        resolv_cache_store(state->resolv_ctx, ns_t_srv, state->query,
+                           ARES_SUCCESS, state->ttl, NULL,
+                           resolv_cache_copy_srv_reply(NULL, reply_list));
+    }
+
     tevent_req_done(req);
     return;
 
@@ -1796,12 +2212,19 @@ ares_getsrv_wakeup(struct tevent_req *subreq)
                                                 struct tevent_req);
     struct getsrv_state *state = tevent_req_data(req,
                                                 struct getsrv_state);
+    struct resolv_cache_entry *entry;
 
     if (!tevent_wakeup_recv(subreq)) {
         return;
     }
     talloc_zfree(subreq);
 
+    entry = resolv_cache_lookup(state->resolv_ctx, ns_t_srv, state->query);
+    if (entry != NULL) {
+        resolv_getsrv_cached(req, state, entry);
+        return;
+    }
+
     if (state->resolv_ctx->channel == NULL) {
         DEBUG(SSSDBG_CRIT_FAILURE,
               "Invalid ares channel - this is likely a bug\n");
@@ -1828,6 +2251,29 @@ resolv_getsrv_query(struct tevent_req *req,
                ns_c_in, ns_t_srv, resolv_getsrv_done, rreq);
 }
 
+static void
+resolv_getsrv_cached(struct tevent_req *req,
+                     struct getsrv_state *state,
+                     struct resolv_cache_entry *entry)
+{
+    state->status = entry->status;
+    state->timeouts = 0;
+
+    if (entry->status != ARES_SUCCESS) {
+        tevent_req_error(req, return_code(entry->status));
+        return;
+    }
+
+    state->reply_list = resolv_cache_copy_srv_reply(req, entry->reply_list);
+    if (state->reply_list == NULL) {
+        tevent_req_error(req, ENOMEM);
+        return;
+    }
+    state->ttl = resolv_cache_remaining_ttl(entry);
+
+    tevent_req_done(req);
+}
+
 /* TXT parsing is not used anywhere in the code yet, so we disable it
  * for now
  */
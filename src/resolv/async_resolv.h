@@ -40,6 +40,10 @@
 #define RESOLV_DEFAULT_SRV_TTL 14400
 #endif  /* RESOLV_DEFAULT_SRV_TTL */
 
+#ifndef RESOLV_CACHE_MAX_ENTRIES
+#define RESOLV_CACHE_MAX_ENTRIES 256
+#endif  /* RESOLV_CACHE_MAX_ENTRIES */
+
 #include "util/util.h"
 
 /*
@@ -56,6 +60,17 @@ int resolv_init(TALLOC_CTX *mem_ctx, struct tevent_context *ev_ctx,
 
 void resolv_reread_configuration(struct resolv_ctx *ctx);
 
+/* Keep A, AAAA and SRV answers received from DNS for the TTL of the
+ * records. Negative answers are kept for negative_timeout seconds, zero
+ * disables negative caching. Lookups in /etc/hosts are never cached. */
+void resolv_set_cache_options(struct resolv_ctx *ctx, bool enabled,
+                              uint32_t negative_timeout);
+
+void resolv_cache_flush(struct resolv_ctx *ctx);
+
+void resolv_get_cache_stats(struct resolv_ctx *ctx,
+                            uint64_t *_hits, uint64_t *_misses);
+
 const char *resolv_strerror(int ares_code);
 
 struct resolv_hostent *
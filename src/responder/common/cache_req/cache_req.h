@@ -157,6 +157,12 @@ cache_req_data_set_bypass_dp(struct cache_req_data *data,
                              bool bypass_dp);
 
 
+/* Users and groups enumeration will return only the DN and the name of
+ * each object, see sysdb_enumpwent_dns(). */
+void
+cache_req_data_set_enum_paged(struct cache_req_data *data,
+                              bool enum_paged);
+
 enum cache_req_type
 cache_req_data_get_type(struct cache_req_data *data);
 
@@ -231,6 +237,22 @@ errno_t cache_req_single_domain_recv(TALLOC_CTX *mem_ctx,
                                      struct tevent_req *req,
                                      struct cache_req_result **_result);
 
+/* Result cache.
+ *
+ * Optional bounded LRU of recent sysdb search results kept in front of
+ * the cache lookups. Entries live at most timeout seconds and never past
+ * the cache expiration of the object itself. */
+
+struct cache_req_lru;
+
+errno_t cache_req_lru_init(TALLOC_CTX *mem_ctx,
+                           uint32_t size,
+                           uint32_t timeout,
+                           struct cache_req_lru **_lru);
+
+/* Drop all entries. It is safe to call this with NULL. */
+void cache_req_lru_flush(struct cache_req_lru *lru);
+
 /* Plug-ins. */
 
 struct tevent_req *
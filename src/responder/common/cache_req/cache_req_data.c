@@ -445,6 +445,18 @@ cache_req_data_set_bypass_dp(struct cache_req_data *data,
     data->bypass_dp = bypass_dp;
 }
 
+void
+cache_req_data_set_enum_paged(struct cache_req_data *data,
+                              bool enum_paged)
+{
+    if (data == NULL) {
+        DEBUG(SSSDBG_CRIT_FAILURE, "cache_req_data should never be NULL\n");
+        return;
+    }
+
+    data->enum_paged = enum_paged;
+}
+
 enum cache_req_type
 cache_req_data_get_type(struct cache_req_data *data)
 {
@@ -0,0 +1,238 @@
+/*
+    Copyright (C) 2026 Red Hat
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <ldb.h>
+#include <talloc.h>
+#include <time.h>
+
+#include "util/util.h"
+#include "responder/common/cache_req/cache_req_private.h"
+
+struct cache_req_lru_entry {
+    struct cache_req_lru_entry *prev;
+    struct cache_req_lru_entry *next;
+
+    char *key;
+    struct ldb_result *result;
+    time_t expire;
+};
+
+struct cache_req_lru {
+    hash_table_t *table;
+
+    /* Most recently used entry first. */
+    struct cache_req_lru_entry *entries;
+    struct cache_req_lru_entry *last;
+
+    uint32_t size;
+    uint32_t count;
+    time_t timeout;
+
+    uint64_t hits;
+    uint64_t misses;
+};
+
+errno_t cache_req_lru_init(TALLOC_CTX *mem_ctx,
+                           uint32_t size,
+                           uint32_t timeout,
+                           struct cache_req_lru **_lru)
+{
+    struct cache_req_lru *lru;
+    errno_t ret;
+
+    if (size == 0 || timeout == 0) {
+        return EINVAL;
+    }
+
+    lru = talloc_zero(mem_ctx, struct cache_req_lru);
+    if (lru == NULL) {
+        return ENOMEM;
+    }
+
+    ret = sss_hash_create(lru, size, &lru->table);
+    if (ret != EOK) {
+        talloc_free(lru);
+        return ret;
+    }
+
+    lru->size = size;
+    lru->timeout = timeout;
+
+    *_lru = lru;
+    return EOK;
+}
+
+static void cache_req_lru_unlink(struct cache_req_lru *lru,
+                                 struct cache_req_lru_entry *entry)
+{
+    if (lru->last == entry) {
+        lru->last = entry->prev;
+    }
+
+    DLIST_REMOVE(lru->entries, entry);
+}
+
+static void cache_req_lru_push(struct cache_req_lru *lru,
+                               struct cache_req_lru_entry *entry)
+{
+    if (lru->last == NULL) {
+        lru->last = entry;
+    }
+
+    DLIST_ADD(lru->entries, entry);
+}
+
+static void cache_req_lru_remove(struct cache_req_lru *lru,
+                                 struct cache_req_lru_entry *entry)
+{
+    hash_key_t key;
+    int hret;
+
+    key.type = HASH_KEY_STRING;
+    key.str = entry->key;
+
+    hret = hash_delete(lru->table, &key);
+    if (hret != HASH_SUCCESS) {
+        DEBUG(SSSDBG_CRIT_FAILURE,
+              "Unable to remove result cache entry [%d]: %s\n",
+              hret, hash_error_string(hret));
+    }
+
+    cache_req_lru_unlink(lru, entry);
+    lru->count--;
+    talloc_free(entry);
+}
+
+static struct cache_req_lru_entry *
+cache_req_lru_lookup(struct cache_req_lru *lru, const char *str)
+{
+    hash_key_t key;
+    hash_value_t value;
+    int hret;
+
+    key.type = HASH_KEY_STRING;
+    key.str = discard_const(str);
+
+    hret = hash_lookup(lru->table, &key, &value);
+    if (hret != HASH_SUCCESS) {
+        if (hret != HASH_ERROR_KEY_NOT_FOUND) {
+            DEBUG(SSSDBG_MINOR_FAILURE, "hash_lookup failed [%d]: %s\n",
+                  hret, hash_error_string(hret));
+        }
+        return NULL;
+    }
+
+    return talloc_get_type(value.ptr, struct cache_req_lru_entry);
+}
+
+struct ldb_result *cache_req_lru_get(TALLOC_CTX *mem_ctx,
+                                     struct cache_req_lru *lru,
+                                     const char *key)
+{
+    struct cache_req_lru_entry *entry;
+
+    if (lru == NULL) {
+        return NULL;
+    }
+
+    entry = cache_req_lru_lookup(lru, key);
+    if (entry != NULL && entry->expire < time(NULL)) {
+        cache_req_lru_remove(lru, entry);
+        entry = NULL;
+    }
+
+    if (entry == NULL) {
+        lru->misses++;
+        return NULL;
+    }
+
+    lru->hits++;
+    DEBUG(SSSDBG_TRACE_ALL, "Result cache hit (%"PRIu64" hits, "
+          "%"PRIu64" misses)\n", lru->hits, lru->misses);
+
+    cache_req_lru_unlink(lru, entry);
+    cache_req_lru_push(lru, entry);
+
+    return cache_req_copy_ldb_result(mem_ctx, entry->result);
+}
+
+void cache_req_lru_put(struct cache_req_lru *lru,
+                       const char *key,
+                       struct ldb_result *result)
+{
+    struct cache_req_lru_entry *entry;
+    hash_key_t hkey;
+    hash_value_t value;
+    int hret;
+
+    if (lru == NULL || result == NULL || result->count == 0) {
+        return;
+    }
+
+    entry = cache_req_lru_lookup(lru, key);
+    if (entry != NULL) {
+        cache_req_lru_remove(lru, entry);
+    }
+
+    while (lru->count >= lru->size && lru->last != NULL) {
+        cache_req_lru_remove(lru, lru->last);
+    }
+
+    /* Failures are not fatal, the result just won't be cached. */
+    entry = talloc_zero(lru, struct cache_req_lru_entry);
+    if (entry == NULL) {
+        return;
+    }
+
+    entry->key = talloc_strdup(entry, key);
+    entry->result = cache_req_copy_ldb_result(entry, result);
+    if (entry->key == NULL || entry->result == NULL) {
+        talloc_free(entry);
+        return;
+    }
+    entry->expire = time(NULL) + lru->timeout;
+
+    hkey.type = HASH_KEY_STRING;
+    hkey.str = entry->key;
+    value.type = HASH_VALUE_PTR;
+    value.ptr = entry;
+
+    hret = hash_enter(lru->table, &hkey, &value);
+    if (hret != HASH_SUCCESS) {
+        DEBUG(SSSDBG_MINOR_FAILURE, "hash_enter failed [%d]: %s\n",
+              hret, hash_error_string(hret));
+        talloc_free(entry);
+        return;
+    }
+
+    cache_req_lru_push(lru, entry);
+    lru->count++;
+}
+
+void cache_req_lru_flush(struct cache_req_lru *lru)
+{
+    if (lru == NULL) {
+        return;
+    }
+
+    DEBUG(SSSDBG_TRACE_FUNC, "Flushing %"PRIu32" cached results\n",
+          lru->count);
+
+    while (lru->entries != NULL) {
+        cache_req_lru_remove(lru, lru->entries);
+    }
+}
@@ -99,6 +99,9 @@ struct cache_req_data {
 
     bool bypass_cache;
     bool bypass_dp;
+
+    /* Enumeration returns only DN and name of the objects. */
+    bool enum_paged;
 };
 
 struct tevent_req *
@@ -133,6 +136,14 @@ cache_req_steal_data_and_send(TALLOC_CTX *mem_ctx,
 void cache_req_search_ncache_add_to_domain(struct cache_req *cr,
                                            struct sss_domain_info *domain);
 
+struct ldb_result *cache_req_lru_get(TALLOC_CTX *mem_ctx,
+                                     struct cache_req_lru *lru,
+                                     const char *key);
+
+void cache_req_lru_put(struct cache_req_lru *lru,
+                       const char *key,
+                       struct ldb_result *result);
+
 errno_t
 cache_req_add_result(TALLOC_CTX *mem_ctx,
                      struct cache_req_result *new_result,
@@ -164,6 +175,11 @@ struct ldb_result *
 cache_req_create_ldb_result_from_msg(TALLOC_CTX *mem_ctx,
                                      struct ldb_message *ldb_msg);
 
+/* Deep copy of all messages in result. */
+struct ldb_result *
+cache_req_copy_ldb_result(TALLOC_CTX *mem_ctx,
+                          struct ldb_result *result);
+
 struct cache_req_result *
 cache_req_create_result_from_msg(TALLOC_CTX *mem_ctx,
                                  struct sss_domain_info *domain,
@@ -187,6 +187,37 @@ cache_req_create_ldb_result_from_msg(TALLOC_CTX *mem_ctx,
     return ldb_result;
 }
 
+struct ldb_result *
+cache_req_copy_ldb_result(TALLOC_CTX *mem_ctx,
+                          struct ldb_result *result)
+{
+    struct ldb_result *copy;
+    unsigned int i;
+
+    copy = talloc_zero(mem_ctx, struct ldb_result);
+    if (copy == NULL) {
+        return NULL;
+    }
+
+    copy->count = result->count;
+    copy->msgs = talloc_zero_array(copy, struct ldb_message *,
+                                   result->count + 1);
+    if (copy->msgs == NULL) {
+        talloc_free(copy);
+        return NULL;
+    }
+
+    for (i = 0; i < result->count; i++) {
+        copy->msgs[i] = ldb_msg_copy(copy->msgs, result->msgs[i]);
+        if (copy->msgs[i] == NULL) {
+            talloc_free(copy);
+            return NULL;
+        }
+    }
+
+    return copy;
+}
+
 struct cache_req_result *
 cache_req_create_result_from_msg(TALLOC_CTX *mem_ctx,
                                  struct sss_domain_info *domain,
@@ -281,6 +281,59 @@ cache_req_expiration_status(struct cache_req *cr,
     return CACHE_OBJECT_EXPIRED;
 }
 
+static char *cache_req_search_key(TALLOC_CTX *mem_ctx,
+                                  struct cache_req *cr,
+                                  bool bypass_cache,
+                                  bool bypass_dp);
+
+/* Return a copy of a recent search result if the responder keeps
+ * a result cache and the object is still valid. */
+static struct ldb_result *
+cache_req_search_lru_get(TALLOC_CTX *mem_ctx,
+                         struct cache_req *cr)
+{
+    struct ldb_result *result;
+    char *key;
+
+    if (cr->rctx->cache_req_lru == NULL) {
+        return NULL;
+    }
+
+    key = cache_req_search_key(NULL, cr, false, false);
+    if (key == NULL) {
+        return NULL;
+    }
+
+    result = cache_req_lru_get(mem_ctx, cr->rctx->cache_req_lru, key);
+    talloc_free(key);
+
+    if (result != NULL
+            && cache_req_expiration_status(cr, result) != CACHE_OBJECT_VALID) {
+        talloc_free(result);
+        return NULL;
+    }
+
+    return result;
+}
+
+static void cache_req_search_lru_put(struct cache_req *cr,
+                                     struct ldb_result *result)
+{
+    char *key;
+
+    if (cr->rctx->cache_req_lru == NULL) {
+        return;
+    }
+
+    key = cache_req_search_key(NULL, cr, false, false);
+    if (key == NULL) {
+        return;
+    }
+
+    cache_req_lru_put(cr->rctx->cache_req_lru, key, result);
+    talloc_free(key);
+}
+
 struct cache_req_search_state {
     /* input data */
     struct tevent_context *ev;
@@ -297,12 +350,12 @@ static errno_t cache_req_search_dp(struct tevent_req *req,
 static void cache_req_search_oob_done(struct tevent_req *subreq);
 static void cache_req_search_done(struct tevent_req *subreq);
 
-struct tevent_req *
-cache_req_search_send(TALLOC_CTX *mem_ctx,
-                      struct tevent_context *ev,
-                      struct cache_req *cr,
-                      bool bypass_cache,
-                      bool bypass_dp)
+static struct tevent_req *
+cache_req_search_run_send(TALLOC_CTX *mem_ctx,
+                          struct tevent_context *ev,
+                          struct cache_req *cr,
+                          bool bypass_cache,
+                          bool bypass_dp)
 {
     struct cache_req_search_state *state;
     enum cache_object_status status;
@@ -320,11 +373,6 @@ cache_req_search_send(TALLOC_CTX *mem_ctx,
     state->ev = ev;
     state->cr = cr;
 
-    ret = cache_req_search_ncache(cr);
-    if (ret != EOK) {
-        goto done;
-    }
-
     /* If bypass_cache is enabled we always contact data provider before
      * searching the cache. Thus we set expiration status to missing,
      * which will trigger data provider request later.
@@ -336,6 +384,15 @@ cache_req_search_send(TALLOC_CTX *mem_ctx,
     state->result = NULL;
     status = CACHE_OBJECT_MISSING;
     if (!bypass_cache) {
+        state->result = cache_req_search_lru_get(state, cr);
+        if (state->result != NULL) {
+            CACHE_REQ_DEBUG(SSSDBG_TRACE_FUNC, cr,
+                            "Returning [%s] from result cache\n",
+                            cr->debugobj);
+            ret = EOK;
+            goto done;
+        }
+
         ret = cache_req_search_cache(state, cr, &state->result);
         if (ret != EOK && ret != ENOENT) {
             goto done;
@@ -345,6 +402,7 @@ cache_req_search_send(TALLOC_CTX *mem_ctx,
         if (status == CACHE_OBJECT_VALID) {
             CACHE_REQ_DEBUG(SSSDBG_TRACE_FUNC, cr,
                             "Returning [%s] from cache\n", cr->debugobj);
+            cache_req_search_lru_put(cr, state->result);
             ret = EOK;
             goto done;
         }
@@ -485,6 +543,11 @@ static void cache_req_search_done(struct tevent_req *subreq)
     }
 
     /* ret == EOK */
+    if (cache_req_expiration_status(state->cr, state->result)
+            == CACHE_OBJECT_VALID) {
+        cache_req_search_lru_put(state->cr, state->result);
+    }
+
     ret = cache_req_search_ncache_filter(state, state->cr, &state->result);
     if (ret != EOK) {
         goto done;
@@ -503,13 +566,484 @@ done:
     return;
 }
 
+static errno_t cache_req_search_run_recv(TALLOC_CTX *mem_ctx,
+                                         struct tevent_req *req,
+                                         struct ldb_result **_result,
+                                         bool *_dp_success)
+{
+    struct cache_req_search_state *state = NULL;
+    state = tevent_req_data(req, struct cache_req_search_state);
+
+    *_dp_success = state->dp_success;
+
+    TEVENT_REQ_RETURN_ON_ERROR(req);
+
+    *_result = talloc_steal(mem_ctx, state->result);
+
+    return EOK;
+}
+
+/* In-flight request coalescing
+ *
+ * When a popular object expires, many clients may ask for it at the same
+ * time. Identical searches (same plugin, domain and normalized input) that
+ * run concurrently therefore share one cache lookup and one data provider
+ * request. The first request becomes the leader and performs the search,
+ * the following ones are queued on the in-flight entry and receive a copy
+ * of the leader's result once it finishes. If the leader is cancelled
+ * before it finishes, the queued requests are restarted and one of them
+ * takes over.
+ *
+ * Coalescing is enabled when the responder context has a table of
+ * in-flight searches (rctx->cache_req_inflight).
+ */
+
+struct cache_req_coalesce_state;
+
+struct cache_req_inflight {
+    hash_table_t *table;
+    char *key;
+
+    struct cache_req_coalesce_state *leader;
+    struct cache_req_coalesce_state *followers;
+};
+
+struct cache_req_coalesce_state {
+    struct cache_req_coalesce_state *prev;
+    struct cache_req_coalesce_state *next;
+
+    /* input data */
+    struct tevent_context *ev;
+    struct tevent_req *req;
+    struct cache_req *cr;
+    bool bypass_cache;
+    bool bypass_dp;
+    char *key;
+
+    struct cache_req_inflight *inflight;
+    struct tevent_immediate *restart;
+
+    /* output data */
+    struct ldb_result *result;
+    bool dp_success;
+};
+
+static errno_t cache_req_search_join(struct tevent_req *req);
+static errno_t cache_req_search_start(struct tevent_req *req,
+                                      hash_table_t *table);
+static void cache_req_search_leader_done(struct tevent_req *subreq);
+
+static errno_t cache_req_search_key_add_str(char **_key, const char *str)
+{
+    char *key;
+
+    /* Prefix with length so the concatenated key is unambiguous. */
+    if (str == NULL) {
+        key = talloc_asprintf_append_buffer(*_key, "-;");
+    } else {
+        key = talloc_asprintf_append_buffer(*_key, "%zu:%s;",
+                                            strlen(str), str);
+    }
+
+    if (key == NULL) {
+        return ENOMEM;
+    }
+
+    *_key = key;
+    return EOK;
+}
+
+static char *cache_req_search_key(TALLOC_CTX *mem_ctx,
+                                  struct cache_req *cr,
+                                  bool bypass_cache,
+                                  bool bypass_dp)
+{
+    struct cache_req_data *data = cr->data;
+    char *key;
+    errno_t ret;
+    uint32_t i;
+
+    key = talloc_asprintf(mem_ctx,
+                          "%d;%d;%d;%d;%"PRIu32";%"PRIu16";%"PRIu32";",
+                          data->type, bypass_cache, bypass_dp,
+                          data->enum_paged, data->id,
+                          data->svc.port, data->addr.af);
+    if (key == NULL) {
+        return NULL;
+    }
+
+    ret = cache_req_search_key_add_str(&key, cr->domain->name);
+    if (ret != EOK) goto done;
+
+    ret = cache_req_search_key_add_str(&key, data->name.lookup);
+    if (ret != EOK) goto done;
+
+    ret = cache_req_search_key_add_str(&key, data->cert);
+    if (ret != EOK) goto done;
+
+    ret = cache_req_search_key_add_str(&key, data->sid);
+    if (ret != EOK) goto done;
+
+    ret = cache_req_search_key_add_str(&key, data->alias);
+    if (ret != EOK) goto done;
+
+    ret = cache_req_search_key_add_str(&key, data->autofs_entry_name);
+    if (ret != EOK) goto done;
+
+    ret = cache_req_search_key_add_str(&key, data->svc.name == NULL ? NULL
+                                                : data->svc.name->lookup);
+    if (ret != EOK) goto done;
+
+    ret = cache_req_search_key_add_str(&key, data->svc.protocol.lookup);
+    if (ret != EOK) goto done;
+
+    for (i = 0; i < data->addr.len; i++) {
+        key = talloc_asprintf_append_buffer(key, "%02x", data->addr.data[i]);
+        if (key == NULL) {
+            ret = ENOMEM;
+            goto done;
+        }
+    }
+
+    for (i = 0; data->attrs != NULL && data->attrs[i] != NULL; i++) {
+        ret = cache_req_search_key_add_str(&key, data->attrs[i]);
+        if (ret != EOK) goto done;
+    }
+
+    ret = EOK;
+
+done:
+    if (ret != EOK) {
+        talloc_free(key);
+        return NULL;
+    }
+
+    return key;
+}
+
+static void cache_req_inflight_remove(struct cache_req_inflight *inflight)
+{
+    hash_key_t key;
+    int hret;
+
+    key.type = HASH_KEY_STRING;
+    key.str = inflight->key;
+
+    hret = hash_delete(inflight->table, &key);
+    if (hret != HASH_SUCCESS) {
+        DEBUG(SSSDBG_CRIT_FAILURE,
+              "Unable to remove in-flight search [%d]: %s\n",
+              hret, hash_error_string(hret));
+    }
+}
+
+/* Hand the leader's result over to all queued requests. The callbacks
+ * are deferred to the next tevent iteration since they may start new
+ * searches or free other requests. */
+static void cache_req_inflight_finish(struct cache_req_inflight *inflight,
+                                      errno_t ret,
+                                      struct ldb_result *result,
+                                      bool dp_success)
+{
+    struct cache_req_coalesce_state *follower;
+    errno_t fret;
+
+    cache_req_inflight_remove(inflight);
+    inflight->leader->inflight = NULL;
+
+    while ((follower = inflight->followers) != NULL) {
+        DLIST_REMOVE(inflight->followers, follower);
+        follower->inflight = NULL;
+        follower->dp_success = dp_success;
+
+        fret = ret;
+        if (fret == EOK) {
+            follower->result = cache_req_copy_ldb_result(follower, result);
+            if (follower->result == NULL) {
+                fret = ENOMEM;
+            }
+        }
+
+        tevent_req_defer_callback(follower->req, follower->ev);
+
+        if (fret != EOK) {
+            tevent_req_error(follower->req, fret);
+        } else {
+            tevent_req_done(follower->req);
+        }
+    }
+
+    talloc_free(inflight);
+}
+
+static void cache_req_search_restart(struct tevent_context *ev,
+                                     struct tevent_immediate *imm,
+                                     void *private_data)
+{
+    struct tevent_req *req;
+    struct cache_req_coalesce_state *state;
+    errno_t ret;
+
+    req = talloc_get_type(private_data, struct tevent_req);
+    state = tevent_req_data(req, struct cache_req_coalesce_state);
+    talloc_zfree(state->restart);
+
+    ret = cache_req_search_join(req);
+    if (ret != EAGAIN) {
+        tevent_req_error(req, ret);
+    }
+}
+
+/* The leader was freed before its search finished, restart the queued
+ * requests so one of them becomes the new leader. */
+static void cache_req_inflight_abandon(struct cache_req_inflight *inflight)
+{
+    struct cache_req_coalesce_state *follower;
+
+    cache_req_inflight_remove(inflight);
+
+    while ((follower = inflight->followers) != NULL) {
+        DLIST_REMOVE(inflight->followers, follower);
+        follower->inflight = NULL;
+
+        follower->restart = tevent_create_immediate(follower);
+        if (follower->restart == NULL) {
+            tevent_req_defer_callback(follower->req, follower->ev);
+            tevent_req_error(follower->req, ENOMEM);
+            continue;
+        }
+
+        tevent_schedule_immediate(follower->restart, follower->ev,
+                                  cache_req_search_restart, follower->req);
+    }
+
+    talloc_free(inflight);
+}
+
+static int
+cache_req_coalesce_state_destructor(struct cache_req_coalesce_state *state)
+{
+    struct cache_req_inflight *inflight = state->inflight;
+
+    if (inflight == NULL) {
+        return 0;
+    }
+
+    state->inflight = NULL;
+
+    if (inflight->leader != state) {
+        DLIST_REMOVE(inflight->followers, state);
+        return 0;
+    }
+
+    cache_req_inflight_abandon(inflight);
+    return 0;
+}
+
+struct tevent_req *
+cache_req_search_send(TALLOC_CTX *mem_ctx,
+                      struct tevent_context *ev,
+                      struct cache_req *cr,
+                      bool bypass_cache,
+                      bool bypass_dp)
+{
+    struct cache_req_coalesce_state *state;
+    struct tevent_req *req;
+    errno_t ret;
+
+    req = tevent_req_create(mem_ctx, &state, struct cache_req_coalesce_state);
+    if (req == NULL) {
+        DEBUG(SSSDBG_CRIT_FAILURE, "tevent_req_create() failed\n");
+        return NULL;
+    }
+
+    state->ev = ev;
+    state->req = req;
+    state->cr = cr;
+    state->bypass_cache = bypass_cache;
+    state->bypass_dp = bypass_dp;
+
+    talloc_set_destructor(state, cache_req_coalesce_state_destructor);
+
+    /* Each request consults the negative cache on its own, there is
+     * nothing to share if the object is known not to exist. */
+    ret = cache_req_search_ncache(cr);
+    if (ret != EOK) {
+        goto done;
+    }
+
+    state->key = cache_req_search_key(state, cr, bypass_cache, bypass_dp);
+    if (state->key == NULL) {
+        ret = ENOMEM;
+        goto done;
+    }
+
+    ret = cache_req_search_join(req);
+    if (ret != EAGAIN) {
+        goto done;
+    }
+
+    return req;
+
+done:
+    if (ret == EOK) {
+        tevent_req_done(req);
+    } else {
+        tevent_req_error(req, ret);
+    }
+    tevent_req_post(req, ev);
+
+    return req;
+}
+
+/* Either join an identical search which is already running or start
+ * a new one as its leader. */
+static errno_t cache_req_search_join(struct tevent_req *req)
+{
+    struct cache_req_coalesce_state *state;
+    struct cache_req_inflight *inflight;
+    struct resp_ctx *rctx;
+    hash_table_t *table;
+    hash_key_t key;
+    hash_value_t value;
+    int hret;
+
+    state = tevent_req_data(req, struct cache_req_coalesce_state);
+    rctx = state->cr->rctx;
+
+    table = rctx->cache_req_inflight;
+    if (table == NULL) {
+        /* coalescing is disabled */
+        return cache_req_search_start(req, NULL);
+    }
+
+    key.type = HASH_KEY_STRING;
+    key.str = state->key;
+
+    hret = hash_lookup(table, &key, &value);
+    switch (hret) {
+    case HASH_SUCCESS:
+        inflight = talloc_get_type(value.ptr, struct cache_req_inflight);
+        if (inflight == NULL) {
+            DEBUG(SSSDBG_CRIT_FAILURE, "Invalid in-flight search pointer\n");
+            return ERR_INTERNAL;
+        }
+
+        DLIST_ADD_END(inflight->followers, state,
+                      struct cache_req_coalesce_state *);
+        state->inflight = inflight;
+        rctx->cache_req_coalesced++;
+
+        CACHE_REQ_DEBUG(SSSDBG_TRACE_FUNC, state->cr,
+                        "Joining in-flight search for [%s] "
+                        "(%"PRIu64" of %"PRIu64" searches coalesced)\n",
+                        state->cr->debugobj, rctx->cache_req_coalesced,
+                        rctx->cache_req_searches + rctx->cache_req_coalesced);
+        return EAGAIN;
+    case HASH_ERROR_KEY_NOT_FOUND:
+        break;
+    default:
+        DEBUG(SSSDBG_MINOR_FAILURE, "hash_lookup failed [%d]: %s\n",
+              hret, hash_error_string(hret));
+        return cache_req_search_start(req, NULL);
+    }
+
+    return cache_req_search_start(req, table);
+}
+
+/* Run the search as a leader. If table is set, the search is registered
+ * there so identical requests can join it. */
+static errno_t cache_req_search_start(struct tevent_req *req,
+                                      hash_table_t *table)
+{
+    struct cache_req_coalesce_state *state;
+    struct cache_req_inflight *inflight;
+    struct tevent_req *subreq;
+    hash_key_t key;
+    hash_value_t value;
+    int hret;
+
+    state = tevent_req_data(req, struct cache_req_coalesce_state);
+
+    subreq = cache_req_search_run_send(state, state->ev, state->cr,
+                                       state->bypass_cache, state->bypass_dp);
+    if (subreq == NULL) {
+        return ENOMEM;
+    }
+    tevent_req_set_callback(subreq, cache_req_search_leader_done, req);
+    state->cr->rctx->cache_req_searches++;
+
+    /* The search may have finished already, there is nothing to share
+     * in that case. */
+    if (table == NULL || !tevent_req_is_in_progress(subreq)) {
+        return EAGAIN;
+    }
+
+    /* Failures below are not fatal, this search just won't be shared. */
+    inflight = talloc_zero(table, struct cache_req_inflight);
+    if (inflight == NULL) {
+        return EAGAIN;
+    }
+
+    inflight->table = table;
+    inflight->leader = state;
+    inflight->key = talloc_strdup(inflight, state->key);
+    if (inflight->key == NULL) {
+        talloc_free(inflight);
+        return EAGAIN;
+    }
+
+    key.type = HASH_KEY_STRING;
+    key.str = inflight->key;
+    value.type = HASH_VALUE_PTR;
+    value.ptr = inflight;
+
+    hret = hash_enter(table, &key, &value);
+    if (hret != HASH_SUCCESS) {
+        DEBUG(SSSDBG_MINOR_FAILURE, "hash_enter failed [%d]: %s\n",
+              hret, hash_error_string(hret));
+        talloc_free(inflight);
+        return EAGAIN;
+    }
+
+    state->inflight = inflight;
+
+    return EAGAIN;
+}
+
+static void cache_req_search_leader_done(struct tevent_req *subreq)
+{
+    struct cache_req_coalesce_state *state;
+    struct tevent_req *req;
+    errno_t ret;
+
+    req = tevent_req_callback_data(subreq, struct tevent_req);
+    state = tevent_req_data(req, struct cache_req_coalesce_state);
+
+    ret = cache_req_search_run_recv(state, subreq, &state->result,
+                                    &state->dp_success);
+    talloc_zfree(subreq);
+
+    if (state->inflight != NULL) {
+        cache_req_inflight_finish(state->inflight, ret, state->result,
+                                  state->dp_success);
+    }
+
+    if (ret != EOK) {
+        tevent_req_error(req, ret);
+        return;
+    }
+
+    tevent_req_done(req);
+}
+
 errno_t cache_req_search_recv(TALLOC_CTX *mem_ctx,
                               struct tevent_req *req,
                               struct ldb_result **_result,
                               bool *_dp_success)
 {
-    struct cache_req_search_state *state = NULL;
-    state = tevent_req_data(req, struct cache_req_search_state);
+    struct cache_req_coalesce_state *state = NULL;
+    state = tevent_req_data(req, struct cache_req_coalesce_state);
 
     *_dp_success = state->dp_success;
 
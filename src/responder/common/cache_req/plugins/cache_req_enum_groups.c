@@ -41,6 +41,10 @@ cache_req_enum_groups_lookup(TALLOC_CTX *mem_ctx,
                              struct sss_domain_info *domain,
                              struct ldb_result **_result)
 {
+    if (data->enum_paged) {
+        return sysdb_enumgrent_dns(mem_ctx, domain, _result);
+    }
+
     return sysdb_enumgrent_with_views(mem_ctx, domain, _result);
 }
 
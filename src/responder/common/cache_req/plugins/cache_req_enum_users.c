@@ -41,6 +41,10 @@ cache_req_enum_users_lookup(TALLOC_CTX *mem_ctx,
                             struct sss_domain_info *domain,
                             struct ldb_result **_result)
 {
+    if (data->enum_paged) {
+        return sysdb_enumpwent_dns(mem_ctx, domain, _result);
+    }
+
     return sysdb_enumpwent_with_views(mem_ctx, domain, _result);
 }
 
@@ -19,31 +19,18 @@
    along with this program.  If not, see <http://www.gnu.org/licenses/>.
 */
 
-#include <fcntl.h>
 #include <time.h>
-#include "tdb.h"
 #include "util/util.h"
 #include "util/nss_dl_load.h"
 #include "confdb/confdb.h"
 #include "responder/common/negcache_files.h"
 #include "responder/common/responder.h"
 #include "responder/common/negcache.h"
-
-
-#define NC_ENTRY_PREFIX "NCE/"
-#define NC_USER_PREFIX NC_ENTRY_PREFIX"USER"
-#define NC_GROUP_PREFIX NC_ENTRY_PREFIX"GROUP"
-#define NC_NETGROUP_PREFIX NC_ENTRY_PREFIX"NETGR"
-#define NC_SERVICE_PREFIX NC_ENTRY_PREFIX"SERVICE"
-#define NC_UID_PREFIX NC_ENTRY_PREFIX"UID"
-#define NC_GID_PREFIX NC_ENTRY_PREFIX"GID"
-#define NC_SID_PREFIX NC_ENTRY_PREFIX"SID"
-#define NC_CERT_PREFIX NC_ENTRY_PREFIX"CERT"
-#define NC_DOMAIN_ACCT_LOCATE_PREFIX NC_ENTRY_PREFIX"DOM_LOCATE"
-#define NC_DOMAIN_ACCT_LOCATE_TYPE_PREFIX NC_ENTRY_PREFIX"DOM_LOCATE_TYPE"
+#include "responder/common/negcache_private.h"
 
 struct sss_nc_ctx {
-    struct tdb_context *tdb;
+    const struct sss_nc_backend *be;
+    void *be_ctx;
     uint32_t timeout;
     uint32_t local_timeout;
     struct sss_nss_ops ops;
@@ -56,16 +43,6 @@ static int sss_ncache_set_ent(struct sss_nc_ctx *ctx, bool permanent,
                               struct sss_domain_info *dom, const char *name,
                               ncache_set_byname_fn_t setter);
 
-static int string_to_tdb_data(char *str, TDB_DATA *ret)
-{
-    if (!str || !ret) return EINVAL;
-
-    ret->dptr = (uint8_t *)str;
-    ret->dsize = strlen(str)+1;
-
-    return EOK;
-}
-
 static errno_t ncache_load_nss_symbols(struct sss_nss_ops *ops)
 {
     errno_t ret;
@@ -85,8 +62,9 @@ static errno_t ncache_load_nss_symbols(struct sss_nss_ops *ops)
     return EOK;
 }
 
-int sss_ncache_init(TALLOC_CTX *memctx, uint32_t timeout,
-                    uint32_t local_timeout, struct sss_nc_ctx **_ctx)
+int sss_ncache_init_ex(TALLOC_CTX *memctx, enum sss_ncache_backend backend,
+                       uint32_t timeout, uint32_t local_timeout,
+                       struct sss_nc_ctx **_ctx)
 {
     errno_t ret;
     struct sss_nc_ctx *ctx;
@@ -102,10 +80,28 @@ int sss_ncache_init(TALLOC_CTX *memctx, uint32_t timeout,
         return ret;
     }
 
-    errno = 0;
-    /* open a memory only tdb with default hash size */
-    ctx->tdb = tdb_open("memcache", 0, TDB_INTERNAL, O_RDWR|O_CREAT, 0);
-    if (!ctx->tdb) return errno;
+    switch (backend) {
+    case SSS_NCACHE_BACKEND_HASH:
+        ctx->be = &sss_nc_backend_hash;
+        break;
+    case SSS_NCACHE_BACKEND_TDB:
+        ctx->be = &sss_nc_backend_tdb;
+        break;
+    default:
+        DEBUG(SSSDBG_CRIT_FAILURE, "Unknown negative cache backend [%d]\n",
+              backend);
+        talloc_free(ctx);
+        return EINVAL;
+    }
+
+    ret = ctx->be->init(ctx, &ctx->be_ctx);
+    if (ret != EOK) {
+        DEBUG(SSSDBG_FATAL_FAILURE,
+              "Unable to initialize negative cache backend %s [%d]: %s\n",
+              ctx->be->name, ret, sss_strerror(ret));
+        talloc_free(ctx);
+        return ret;
+    }
 
     ctx->timeout = timeout;
     ctx->local_timeout = local_timeout;
@@ -114,184 +110,136 @@ int sss_ncache_init(TALLOC_CTX *memctx, uint32_t timeout,
     return EOK;
 };
 
+int sss_ncache_init(TALLOC_CTX *memctx, uint32_t timeout,
+                    uint32_t local_timeout, struct sss_nc_ctx **_ctx)
+{
+    return sss_ncache_init_ex(memctx, SSS_NCACHE_BACKEND_HASH,
+                              timeout, local_timeout, _ctx);
+}
+
 uint32_t sss_ncache_get_timeout(struct sss_nc_ctx *ctx)
 {
     return ctx->timeout;
 }
 
-static int sss_ncache_check_str(struct sss_nc_ctx *ctx, char *str)
+static const char *sss_ncache_key_type_str(enum sss_nc_key_type type)
 {
-    TDB_DATA key;
-    TDB_DATA data;
-    unsigned long long int timestamp;
-    bool expired = false;
-    char *ep;
-    int ret;
-
-    DEBUG(SSSDBG_TRACE_INTERNAL, "Checking negative cache for [%s]\n", str);
-
-    data.dptr = NULL;
-
-    ret = string_to_tdb_data(str, &key);
-    if (ret != EOK) goto done;
-
-    data = tdb_fetch(ctx->tdb, key);
-
-    if (!data.dptr) {
-        ret = ENOENT;
-        goto done;
-    }
-
-    errno = 0;
-    timestamp = strtoull((const char *)data.dptr, &ep, 10);
-    if (errno != 0 || *ep != '\0') {
-        /* Malformed entry, remove it and return no entry */
-        expired = true;
-        goto done;
-    }
-
-    if (timestamp == 0) {
-        /* a 0 timestamp means this is a permanent entry */
-        ret = EEXIST;
-        goto done;
-    }
-
-    if (timestamp >= time(NULL)) {
-        /* still valid */
-        ret = EEXIST;
-        goto done;
+    switch (type) {
+    case SSS_NC_KEY_USER:
+        return "USER";
+    case SSS_NC_KEY_GROUP:
+        return "GROUP";
+    case SSS_NC_KEY_NETGROUP:
+        return "NETGR";
+    case SSS_NC_KEY_SERVICE:
+        return "SERVICE";
+    case SSS_NC_KEY_UID:
+        return "UID";
+    case SSS_NC_KEY_GID:
+        return "GID";
+    case SSS_NC_KEY_SID:
+        return "SID";
+    case SSS_NC_KEY_CERT:
+        return "CERT";
+    case SSS_NC_KEY_LOCATE_TYPE:
+        return "DOM_LOCATE_TYPE";
+    case SSS_NC_KEY_LOCATE_UID:
+        return "DOM_LOCATE/UID";
+    case SSS_NC_KEY_LOCATE_GID:
+        return "DOM_LOCATE/GID";
+    case SSS_NC_KEY_SENTINEL:
+        break;
     }
 
-    expired = true;
+    return "UNKNOWN";
+}
 
-done:
-    if (expired) {
-        /* expired, remove and return no entry */
-        tdb_delete(ctx->tdb, key);
-        ret = ENOENT;
-    }
+#define NC_KEY_DEBUG(level, msg, key, suffix) do { \
+    if ((key)->name != NULL) { \
+        DEBUG(level, msg" [%s/%s/%s]%s\n", \
+              sss_ncache_key_type_str((key)->type), \
+              (key)->domain ? (key)->domain : "", (key)->name, suffix); \
+    } else { \
+        DEBUG(level, msg" [%s/%s/%"PRIu32"]%s\n", \
+              sss_ncache_key_type_str((key)->type), \
+              (key)->domain ? (key)->domain : "", (key)->id, suffix); \
+    } \
+} while (0)
+
+static int sss_ncache_check_key(struct sss_nc_ctx *ctx,
+                                const struct sss_nc_key *key)
+{
+    NC_KEY_DEBUG(SSSDBG_TRACE_INTERNAL, "Checking negative cache for",
+                 key, "");
 
-    free(data.dptr);
-    return ret;
+    return ctx->be->check(ctx->be_ctx, key, time(NULL));
 }
 
-static int sss_ncache_set_str(struct sss_nc_ctx *ctx, char *str,
+static int sss_ncache_set_key(struct sss_nc_ctx *ctx,
+                              const struct sss_nc_key *key,
                               bool permanent, bool use_local_negative)
 {
-    TDB_DATA key;
-    TDB_DATA data;
-    char *timest;
-    unsigned long long int timell;
-    int ret;
+    time_t now;
+    time_t expire;
 
-    ret = string_to_tdb_data(str, &key);
-    if (ret != EOK) return ret;
+    now = time(NULL);
 
     if (permanent) {
-        timest = talloc_strdup(ctx, "0");
+        expire = 0;
     } else {
         if (use_local_negative == true && ctx->local_timeout > ctx->timeout) {
-            timell = ctx->local_timeout;
+            expire = ctx->local_timeout;
         } else {
             /* EOK is tested in cwrap based unit test */
             if (ctx->timeout == 0) {
                 return EOK;
             }
-            timell = ctx->timeout;
+            expire = ctx->timeout;
         }
-        timell += (unsigned long long int)time(NULL);
-        timest = talloc_asprintf(ctx, "%llu", timell);
+        expire += now;
     }
-    if (!timest) return ENOMEM;
 
-    ret = string_to_tdb_data(timest, &data);
-    if (ret != EOK) goto done;
+    NC_KEY_DEBUG(SSSDBG_TRACE_FUNC, "Adding", key,
+                 permanent ? " to negative cache permanently"
+                           : " to negative cache");
 
-    DEBUG(SSSDBG_TRACE_FUNC, "Adding [%s] to negative cache%s\n",
-              str, permanent?" permanently":"");
-
-    ret = tdb_store(ctx->tdb, key, data, TDB_REPLACE);
-    if (ret != 0) {
-        DEBUG(SSSDBG_CRIT_FAILURE, "Negative cache failed to set entry: [%s]\n",
-                  tdb_errorstr(ctx->tdb));
-        ret = EFAULT;
-    }
-
-done:
-    talloc_free(timest);
-    return ret;
+    return ctx->be->set(ctx->be_ctx, key, now, expire);
 }
 
-static int sss_ncache_check_user_int(struct sss_nc_ctx *ctx, const char *domain,
-                                     const char *name)
+static int sss_ncache_check_name_int(struct sss_nc_ctx *ctx,
+                                     enum sss_nc_key_type type,
+                                     const char *domain, const char *name)
 {
-    char *str;
-    int ret;
+    struct sss_nc_key key = { type, domain, name, 0 };
 
     if (!name || !*name) return EINVAL;
 
-    str = talloc_asprintf(ctx, "%s/%s/%s", NC_USER_PREFIX, domain, name);
-    if (!str) return ENOMEM;
-
-    ret = sss_ncache_check_str(ctx, str);
+    return sss_ncache_check_key(ctx, &key);
+}
 
-    talloc_free(str);
-    return ret;
+static int sss_ncache_check_user_int(struct sss_nc_ctx *ctx, const char *domain,
+                                     const char *name)
+{
+    return sss_ncache_check_name_int(ctx, SSS_NC_KEY_USER, domain, name);
 }
 
 static int sss_ncache_check_group_int(struct sss_nc_ctx *ctx,
                                       const char *domain, const char *name)
 {
-    char *str;
-    int ret;
-
-    if (!name || !*name) return EINVAL;
-
-    str = talloc_asprintf(ctx, "%s/%s/%s", NC_GROUP_PREFIX, domain, name);
-    if (!str) return ENOMEM;
-
-    ret = sss_ncache_check_str(ctx, str);
-
-    talloc_free(str);
-    return ret;
+    return sss_ncache_check_name_int(ctx, SSS_NC_KEY_GROUP, domain, name);
 }
 
 static int sss_ncache_check_netgr_int(struct sss_nc_ctx *ctx,
                                       const char *domain, const char *name)
 {
-    char *str;
-    int ret;
-
-    if (!name || !*name) return EINVAL;
-
-    str = talloc_asprintf(ctx, "%s/%s/%s", NC_NETGROUP_PREFIX, domain, name);
-    if (!str) return ENOMEM;
-
-    ret = sss_ncache_check_str(ctx, str);
-
-    talloc_free(str);
-    return ret;
+    return sss_ncache_check_name_int(ctx, SSS_NC_KEY_NETGROUP, domain, name);
 }
 
 static int sss_ncache_check_service_int(struct sss_nc_ctx *ctx,
                                         const char *domain,
                                         const char *name)
 {
-    char *str;
-    int ret;
-
-    if (!name || !*name) return EINVAL;
-
-    str = talloc_asprintf(ctx, "%s/%s/%s",
-                          NC_SERVICE_PREFIX,
-                          domain,
-                          name);
-    if (!str) return ENOMEM;
-
-    ret = sss_ncache_check_str(ctx, str);
-
-    talloc_free(str);
-    return ret;
+    return sss_ncache_check_name_int(ctx, SSS_NC_KEY_SERVICE, domain, name);
 }
 
 typedef int (*ncache_check_byname_fn_t)(struct sss_nc_ctx *, const char *,
@@ -355,18 +303,11 @@ int sss_ncache_check_netgr(struct sss_nc_ctx *ctx, struct sss_domain_info *dom,
 static int sss_ncache_set_service_int(struct sss_nc_ctx *ctx, bool permanent,
                                       const char *domain, const char *name)
 {
-    char *str;
-    int ret;
+    struct sss_nc_key key = { SSS_NC_KEY_SERVICE, domain, name, 0 };
 
     if (!name || !*name) return EINVAL;
 
-    str = talloc_asprintf(ctx, "%s/%s/%s", NC_SERVICE_PREFIX, domain, name);
-    if (!str) return ENOMEM;
-
-    ret = sss_ncache_set_str(ctx, str, permanent, false);
-
-    talloc_free(str);
-    return ret;
+    return sss_ncache_set_key(ctx, &key, permanent, false);
 }
 
 int sss_ncache_set_service_name(struct sss_nc_ctx *ctx, bool permanent,
@@ -440,129 +381,76 @@ int sss_ncache_check_service_port(struct sss_nc_ctx *ctx,
 int sss_ncache_check_uid(struct sss_nc_ctx *ctx, struct sss_domain_info *dom,
                          uid_t uid)
 {
-    char *str;
-    int ret;
-
-    if (dom != NULL) {
-        str = talloc_asprintf(ctx, "%s/%s/%"SPRIuid, NC_UID_PREFIX, dom->name,
-                              uid);
-    } else {
-        str = talloc_asprintf(ctx, "%s/%"SPRIuid, NC_UID_PREFIX, uid);
-    }
-    if (!str) return ENOMEM;
-
-    ret = sss_ncache_check_str(ctx, str);
+    struct sss_nc_key key = { SSS_NC_KEY_UID,
+                              dom != NULL ? dom->name : NULL,
+                              NULL, uid };
 
-    talloc_free(str);
-    return ret;
+    return sss_ncache_check_key(ctx, &key);
 }
 
 int sss_ncache_check_gid(struct sss_nc_ctx *ctx, struct sss_domain_info *dom,
                          gid_t gid)
 {
-    char *str;
-    int ret;
-
-    if (dom != NULL) {
-        str = talloc_asprintf(ctx, "%s/%s/%"SPRIgid, NC_GID_PREFIX, dom->name,
-                              gid);
-    } else {
-        str = talloc_asprintf(ctx, "%s/%"SPRIgid, NC_GID_PREFIX, gid);
-    }
-    if (!str) return ENOMEM;
-
-    ret = sss_ncache_check_str(ctx, str);
+    struct sss_nc_key key = { SSS_NC_KEY_GID,
+                              dom != NULL ? dom->name : NULL,
+                              NULL, gid };
 
-    talloc_free(str);
-    return ret;
+    return sss_ncache_check_key(ctx, &key);
 }
 
 int sss_ncache_check_sid(struct sss_nc_ctx *ctx, const char *sid)
 {
-    char *str;
-    int ret;
-
-    str = talloc_asprintf(ctx, "%s/%s", NC_SID_PREFIX, sid);
-    if (!str) return ENOMEM;
+    struct sss_nc_key key = { SSS_NC_KEY_SID, NULL, sid, 0 };
 
-    ret = sss_ncache_check_str(ctx, str);
-
-    talloc_free(str);
-    return ret;
+    return sss_ncache_check_key(ctx, &key);
 }
 
 int sss_ncache_check_cert(struct sss_nc_ctx *ctx, const char *cert)
 {
-    char *str;
-    int ret;
+    struct sss_nc_key key = { SSS_NC_KEY_CERT, NULL, cert, 0 };
 
-    str = talloc_asprintf(ctx, "%s/%s", NC_CERT_PREFIX, cert);
-    if (!str) return ENOMEM;
-
-    ret = sss_ncache_check_str(ctx, str);
-
-    talloc_free(str);
-    return ret;
+    return sss_ncache_check_key(ctx, &key);
 }
 
 
 static int sss_ncache_set_user_int(struct sss_nc_ctx *ctx, bool permanent,
                                    const char *domain, const char *name)
 {
+    struct sss_nc_key key = { SSS_NC_KEY_USER, domain, name, 0 };
     bool use_local_negative = false;
-    char *str;
-    int ret;
 
     if (!name || !*name) return EINVAL;
 
-    str = talloc_asprintf(ctx, "%s/%s/%s", NC_USER_PREFIX, domain, name);
-    if (!str) return ENOMEM;
-
     if ((!permanent) && (ctx->local_timeout > 0)) {
         use_local_negative = is_user_local_by_name(&ctx->ops, name);
     }
-    ret = sss_ncache_set_str(ctx, str, permanent, use_local_negative);
 
-    talloc_free(str);
-    return ret;
+    return sss_ncache_set_key(ctx, &key, permanent, use_local_negative);
 }
 
 static int sss_ncache_set_group_int(struct sss_nc_ctx *ctx, bool permanent,
                                     const char *domain, const char *name)
 {
+    struct sss_nc_key key = { SSS_NC_KEY_GROUP, domain, name, 0 };
     bool use_local_negative = false;
-    char *str;
-    int ret;
 
     if (!name || !*name) return EINVAL;
 
-    str = talloc_asprintf(ctx, "%s/%s/%s", NC_GROUP_PREFIX, domain, name);
-    if (!str) return ENOMEM;
-
     if ((!permanent) && (ctx->local_timeout > 0)) {
         use_local_negative = is_group_local_by_name(&ctx->ops, name);
     }
-    ret = sss_ncache_set_str(ctx, str, permanent, use_local_negative);
 
-    talloc_free(str);
-    return ret;
+    return sss_ncache_set_key(ctx, &key, permanent, use_local_negative);
 }
 
 static int sss_ncache_set_netgr_int(struct sss_nc_ctx *ctx, bool permanent,
                                     const char *domain, const char *name)
 {
-    char *str;
-    int ret;
+    struct sss_nc_key key = { SSS_NC_KEY_NETGROUP, domain, name, 0 };
 
     if (!name || !*name) return EINVAL;
 
-    str = talloc_asprintf(ctx, "%s/%s/%s", NC_NETGROUP_PREFIX, domain, name);
-    if (!str) return ENOMEM;
-
-    ret = sss_ncache_set_str(ctx, str, permanent, false);
-
-    talloc_free(str);
-    return ret;
+    return sss_ncache_set_key(ctx, &key, permanent, false);
 }
 
 static int sss_ncache_set_ent(struct sss_nc_ctx *ctx, bool permanent,
@@ -624,332 +512,153 @@ int sss_ncache_set_netgr(struct sss_nc_ctx *ctx, bool permanent,
 int sss_ncache_set_uid(struct sss_nc_ctx *ctx, bool permanent,
                        struct sss_domain_info *dom, uid_t uid)
 {
+    struct sss_nc_key key = { SSS_NC_KEY_UID,
+                              dom != NULL ? dom->name : NULL,
+                              NULL, uid };
     bool use_local_negative = false;
-    char *str;
-    int ret;
-
-    if (dom != NULL) {
-        str = talloc_asprintf(ctx, "%s/%s/%"SPRIuid, NC_UID_PREFIX, dom->name,
-                              uid);
-    } else {
-        str = talloc_asprintf(ctx, "%s/%"SPRIuid, NC_UID_PREFIX, uid);
-    }
-    if (!str) return ENOMEM;
 
     if ((!permanent) && (ctx->local_timeout > 0)) {
         use_local_negative = is_user_local_by_uid(&ctx->ops, uid);
     }
-    ret = sss_ncache_set_str(ctx, str, permanent, use_local_negative);
 
-    talloc_free(str);
-    return ret;
+    return sss_ncache_set_key(ctx, &key, permanent, use_local_negative);
 }
 
 int sss_ncache_set_gid(struct sss_nc_ctx *ctx, bool permanent,
                        struct sss_domain_info *dom, gid_t gid)
 {
+    struct sss_nc_key key = { SSS_NC_KEY_GID,
+                              dom != NULL ? dom->name : NULL,
+                              NULL, gid };
     bool use_local_negative = false;
-    char *str;
-    int ret;
-
-    if (dom != NULL) {
-        str = talloc_asprintf(ctx, "%s/%s/%"SPRIgid, NC_GID_PREFIX, dom->name,
-                              gid);
-    } else {
-        str = talloc_asprintf(ctx, "%s/%"SPRIgid, NC_GID_PREFIX, gid);
-    }
-    if (!str) return ENOMEM;
 
     if ((!permanent) && (ctx->local_timeout > 0)) {
         use_local_negative = is_group_local_by_gid(&ctx->ops, gid);
     }
-    ret = sss_ncache_set_str(ctx, str, permanent, use_local_negative);
 
-    talloc_free(str);
-    return ret;
+    return sss_ncache_set_key(ctx, &key, permanent, use_local_negative);
 }
 
 int sss_ncache_set_sid(struct sss_nc_ctx *ctx, bool permanent, const char *sid)
 {
-    char *str;
-    int ret;
-
-    str = talloc_asprintf(ctx, "%s/%s", NC_SID_PREFIX, sid);
-    if (!str) return ENOMEM;
+    struct sss_nc_key key = { SSS_NC_KEY_SID, NULL, sid, 0 };
 
-    ret = sss_ncache_set_str(ctx, str, permanent, false);
-
-    talloc_free(str);
-    return ret;
+    return sss_ncache_set_key(ctx, &key, permanent, false);
 }
 
 int sss_ncache_set_cert(struct sss_nc_ctx *ctx, bool permanent,
                         const char *cert)
 {
-    char *str;
-    int ret;
-
-    str = talloc_asprintf(ctx, "%s/%s", NC_CERT_PREFIX, cert);
-    if (!str) return ENOMEM;
+    struct sss_nc_key key = { SSS_NC_KEY_CERT, NULL, cert, 0 };
 
-    ret = sss_ncache_set_str(ctx, str, permanent, false);
-
-    talloc_free(str);
-    return ret;
-}
-
-static char *domain_lookup_type_str(TALLOC_CTX *mem_ctx,
-                                    struct sss_domain_info *dom,
-                                    const char *lookup_type)
-{
-    return talloc_asprintf(mem_ctx,
-                           "%s/%s/%s",
-                           NC_DOMAIN_ACCT_LOCATE_TYPE_PREFIX,
-                           dom->name,
-                           lookup_type);
+    return sss_ncache_set_key(ctx, &key, permanent, false);
 }
 
 int sss_ncache_set_domain_locate_type(struct sss_nc_ctx *ctx,
                                       struct sss_domain_info *dom,
                                       const char *lookup_type)
 {
-    char *str;
-    int ret;
-
-    str = domain_lookup_type_str(ctx, dom, lookup_type);
-    if (!str) return ENOMEM;
+    struct sss_nc_key key = { SSS_NC_KEY_LOCATE_TYPE, dom->name,
+                              lookup_type, 0 };
 
     /* Permanent cache is always used here, because the lookup
      * type's (getgrgid, getpwuid, ..) support locating an entry's domain
      * doesn't change
      */
-    ret = sss_ncache_set_str(ctx, str, true, false);
-    talloc_free(str);
-    return ret;
+    return sss_ncache_set_key(ctx, &key, true, false);
 }
 
 int sss_ncache_check_domain_locate_type(struct sss_nc_ctx *ctx,
                                         struct sss_domain_info *dom,
                                         const char *lookup_type)
 {
-    char *str;
-    int ret;
+    struct sss_nc_key key = { SSS_NC_KEY_LOCATE_TYPE, dom->name,
+                              lookup_type, 0 };
 
-    str = domain_lookup_type_str(ctx, dom, lookup_type);
-    if (!str) return ENOMEM;
-
-    ret = sss_ncache_check_str(ctx, str);
-    talloc_free(str);
-    return ret;
-}
-
-static char *locate_gid_str(TALLOC_CTX *mem_ctx,
-                            struct sss_domain_info *dom,
-                            gid_t gid)
-{
-    return talloc_asprintf(mem_ctx,
-                           "%s/%s/%s/%"SPRIgid,
-                           NC_DOMAIN_ACCT_LOCATE_PREFIX,
-                           NC_GID_PREFIX,
-                           dom->name,
-                           gid);
+    return sss_ncache_check_key(ctx, &key);
 }
 
 int sss_ncache_set_locate_gid(struct sss_nc_ctx *ctx,
                               struct sss_domain_info *dom,
                               gid_t gid)
 {
-    char *str;
-    int ret;
+    struct sss_nc_key key = { SSS_NC_KEY_LOCATE_GID, NULL, NULL, gid };
 
     if (dom == NULL) {
         return EINVAL;
     }
+    key.domain = dom->name;
 
-    str = locate_gid_str(ctx, dom, gid);
-    if (str == NULL) {
-        return ENOMEM;
-    }
-
-    ret = sss_ncache_set_str(ctx, str, false, false);
-    talloc_free(str);
-    return ret;
+    return sss_ncache_set_key(ctx, &key, false, false);
 }
 
 int sss_ncache_check_locate_gid(struct sss_nc_ctx *ctx,
                                 struct sss_domain_info *dom,
                                 gid_t gid)
 {
-    char *str;
-    int ret;
+    struct sss_nc_key key = { SSS_NC_KEY_LOCATE_GID, NULL, NULL, gid };
 
     if (dom == NULL) {
         return EINVAL;
     }
+    key.domain = dom->name;
 
-    str = locate_gid_str(ctx, dom, gid);
-    if (str == NULL) {
-        return ENOMEM;
-    }
-
-    ret = sss_ncache_check_str(ctx, str);
-    talloc_free(str);
-    return ret;
-}
-
-static char *locate_uid_str(struct sss_nc_ctx *ctx,
-                            struct sss_domain_info *dom,
-                            uid_t uid)
-{
-    return talloc_asprintf(ctx,
-                           "%s/%s/%s/%"SPRIuid,
-                           NC_DOMAIN_ACCT_LOCATE_PREFIX,
-                           NC_UID_PREFIX,
-                           dom->name,
-                           uid);
+    return sss_ncache_check_key(ctx, &key);
 }
 
 int sss_ncache_set_locate_uid(struct sss_nc_ctx *ctx,
                               struct sss_domain_info *dom,
                               uid_t uid)
 {
-    char *str;
-    int ret;
+    struct sss_nc_key key = { SSS_NC_KEY_LOCATE_UID, NULL, NULL, uid };
 
     if (dom == NULL) {
         return EINVAL;
     }
+    key.domain = dom->name;
 
-    str = locate_uid_str(ctx, dom, uid);
-    if (str == NULL) {
-        return ENOMEM;
-    }
-
-    ret = sss_ncache_set_str(ctx, str, false, false);
-    talloc_free(str);
-    return ret;
+    return sss_ncache_set_key(ctx, &key, false, false);
 }
 
 int sss_ncache_check_locate_uid(struct sss_nc_ctx *ctx,
                                 struct sss_domain_info *dom,
                                 uid_t uid)
 {
-    char *str;
-    int ret;
+    struct sss_nc_key key = { SSS_NC_KEY_LOCATE_UID, NULL, NULL, uid };
 
     if (dom == NULL) {
         return EINVAL;
     }
+    key.domain = dom->name;
 
-    str = locate_uid_str(ctx, dom, uid);
-    if (str == NULL) {
-        return ENOMEM;
-    }
-
-    ret = sss_ncache_check_str(ctx, str);
-    talloc_free(str);
-    return ret;
-}
-
-static int delete_permanent(struct tdb_context *tdb,
-                            TDB_DATA key, TDB_DATA data, void *state)
-{
-    unsigned long long int timestamp;
-    bool remove_key = false;
-    char *ep;
-
-    if (strncmp((char *)key.dptr,
-                NC_ENTRY_PREFIX, sizeof(NC_ENTRY_PREFIX) - 1) != 0) {
-        /* not interested in this key */
-        return 0;
-    }
-
-    errno = 0;
-    timestamp = strtoull((const char *)data.dptr, &ep, 10);
-    if (errno != 0 || *ep != '\0') {
-        /* Malformed entry, remove it */
-        remove_key = true;
-        goto done;
-    }
-
-    if (timestamp == 0) {
-        /* a 0 timestamp means this is a permanent entry */
-        remove_key = true;
-    }
-
-done:
-    if (remove_key) {
-        return tdb_delete(tdb, key);
-    }
-
-    return 0;
+    return sss_ncache_check_key(ctx, &key);
 }
 
 int sss_ncache_reset_permanent(struct sss_nc_ctx *ctx)
 {
-    int ret;
-
-    ret = tdb_traverse(ctx->tdb, delete_permanent, NULL);
-    if (ret < 0)
-        return EIO;
-
-    return EOK;
-}
-
-static int delete_prefix(struct tdb_context *tdb,
-                         TDB_DATA key, TDB_DATA data, void *state)
-{
-    const char *prefix = (const char *) state;
-
-    if (strncmp((char *)key.dptr, prefix, strlen(prefix) - 1) != 0) {
-        /* not interested in this key */
-        return 0;
-    }
-
-    return tdb_delete(tdb, key);
-}
-
-static int sss_ncache_reset_pfx(struct sss_nc_ctx *ctx,
-                                const char **prefixes)
-{
-    int ret;
-
-    if (prefixes == NULL) {
-        return EOK;
-    }
-
-    for (int i = 0; prefixes[i] != NULL; i++) {
-        ret = tdb_traverse(ctx->tdb,
-                           delete_prefix,
-                           discard_const(prefixes[i]));
-        if (ret < 0) {
-            return EIO;
-        }
-    }
-
-    return EOK;
+    return ctx->be->reset_permanent(ctx->be_ctx);
 }
 
 int sss_ncache_reset_users(struct sss_nc_ctx *ctx)
 {
-    const char *prefixes[] = {
-        NC_USER_PREFIX,
-        NC_UID_PREFIX,
-        NULL,
+    const enum sss_nc_key_type types[] = {
+        SSS_NC_KEY_USER,
+        SSS_NC_KEY_UID,
+        SSS_NC_KEY_SENTINEL,
     };
 
-    return sss_ncache_reset_pfx(ctx, prefixes);
+    return ctx->be->reset_types(ctx->be_ctx, types);
 }
 
 int sss_ncache_reset_groups(struct sss_nc_ctx *ctx)
 {
-    const char *prefixes[] = {
-        NC_GROUP_PREFIX,
-        NC_GID_PREFIX,
-        NULL,
+    const enum sss_nc_key_type types[] = {
+        SSS_NC_KEY_GROUP,
+        SSS_NC_KEY_GID,
+        SSS_NC_KEY_SENTINEL,
     };
 
-    return sss_ncache_reset_pfx(ctx, prefixes);
+    return ctx->be->reset_types(ctx->be_ctx, types);
 }
 
 errno_t sss_ncache_prepopulate(struct sss_nc_ctx *ncache,
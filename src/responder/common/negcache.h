@@ -24,10 +24,21 @@
 
 struct sss_nc_ctx;
 
+enum sss_ncache_backend {
+    SSS_NCACHE_BACKEND_HASH,
+    SSS_NCACHE_BACKEND_TDB,
+};
+
 /* init the in memory negative cache */
 int sss_ncache_init(TALLOC_CTX *memctx, uint32_t timeout,
                     uint32_t local_timeout, struct sss_nc_ctx **_ctx);
 
+/* init the in memory negative cache using the given storage backend,
+ * sss_ncache_init() uses SSS_NCACHE_BACKEND_HASH */
+int sss_ncache_init_ex(TALLOC_CTX *memctx, enum sss_ncache_backend backend,
+                       uint32_t timeout, uint32_t local_timeout,
+                       struct sss_nc_ctx **_ctx);
+
 uint32_t sss_ncache_get_timeout(struct sss_nc_ctx *ctx);
 
 /* check if the user is expired according to the passed in time to live */
@@ -0,0 +1,475 @@
+/*
+   SSSD
+
+   Negative cache hash table backend
+
+   Copyright (C) 2026 Red Hat
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/* Entries are stored in an open addressing (linear probing) hash table
+ * keyed directly by the typed key, so neither lookups nor updates need to
+ * format or parse strings. The table is split into shards selected by the
+ * top bits of the hash which are resized independently, this keeps the
+ * latency of a single resize bounded even with millions of entries.
+ *
+ * Expiring entries are additionally linked into a timer wheel with one
+ * second granularity, every operation advances the wheel and drops the
+ * entries which expired since the previous operation. Permanent entries
+ * are kept on a separate list so sss_ncache_reset_permanent() does not
+ * need to walk the whole cache. */
+
+#include <time.h>
+
+#include "util/util.h"
+#include "util/dlinklist.h"
+#include "util/crypto/sss_crypto.h"
+#include "shared/murmurhash3.h"
+#include "responder/common/negcache_private.h"
+
+#define NC_HASH_SHARD_BITS 4
+#define NC_HASH_SHARDS (1 << NC_HASH_SHARD_BITS)
+#define NC_HASH_SHARD_MIN_SIZE 64
+#define NC_HASH_WHEEL_SIZE 1024
+
+struct nc_hash_entry {
+    struct nc_hash_entry *prev;
+    struct nc_hash_entry *next;
+
+    time_t expire;
+    uint32_t hash;
+    enum sss_nc_key_type type;
+    uint32_t id;
+    const char *domain;
+    const char *name;
+    char strs[];
+};
+
+struct nc_hash_slot {
+    uint32_t hash;
+    struct nc_hash_entry *entry;
+};
+
+struct nc_hash_shard {
+    struct nc_hash_slot *slots;
+    uint32_t size;
+    uint32_t count;
+};
+
+struct nc_hash_ctx {
+    struct nc_hash_shard shards[NC_HASH_SHARDS];
+    struct nc_hash_entry *wheel[NC_HASH_WHEEL_SIZE];
+    struct nc_hash_entry *permanent;
+    time_t wheel_time;
+    uint32_t seed;
+};
+
+static uint32_t nc_hash_key(struct nc_hash_ctx *hctx,
+                            const struct sss_nc_key *key)
+{
+    uint32_t fixed[2];
+    uint32_t hash;
+
+    fixed[0] = key->type;
+    fixed[1] = key->id;
+    hash = murmurhash3((const char *)fixed, sizeof(fixed), hctx->seed);
+
+    if (key->domain != NULL) {
+        hash = murmurhash3(key->domain, strlen(key->domain), hash);
+    }
+
+    if (key->name != NULL) {
+        hash = murmurhash3(key->name, strlen(key->name), hash);
+    }
+
+    return hash;
+}
+
+static bool nc_hash_str_equal(const char *a, const char *b)
+{
+    if (a == NULL || b == NULL) {
+        return a == b;
+    }
+
+    return strcmp(a, b) == 0;
+}
+
+static bool nc_hash_key_equal(struct nc_hash_entry *entry,
+                              const struct sss_nc_key *key)
+{
+    return entry->type == key->type
+               && entry->id == key->id
+               && nc_hash_str_equal(entry->name, key->name)
+               && nc_hash_str_equal(entry->domain, key->domain);
+}
+
+static struct nc_hash_shard *nc_hash_shard(struct nc_hash_ctx *hctx,
+                                           uint32_t hash)
+{
+    return &hctx->shards[hash >> (32 - NC_HASH_SHARD_BITS)];
+}
+
+static struct nc_hash_entry **nc_hash_list(struct nc_hash_ctx *hctx,
+                                           time_t expire)
+{
+    if (expire == 0) {
+        return &hctx->permanent;
+    }
+
+    return &hctx->wheel[expire % NC_HASH_WHEEL_SIZE];
+}
+
+/* Returns the slot index of the key or -1 if not found. */
+static int64_t nc_hash_find(struct nc_hash_shard *shard, uint32_t hash,
+                            const struct sss_nc_key *key,
+                            struct nc_hash_entry *entry)
+{
+    uint32_t mask = shard->size - 1;
+    uint32_t idx;
+
+    for (idx = hash & mask;
+         shard->slots[idx].entry != NULL;
+         idx = (idx + 1) & mask) {
+        if (shard->slots[idx].hash != hash) {
+            continue;
+        }
+
+        if (entry != NULL) {
+            if (shard->slots[idx].entry == entry) {
+                return idx;
+            }
+        } else if (nc_hash_key_equal(shard->slots[idx].entry, key)) {
+            return idx;
+        }
+    }
+
+    return -1;
+}
+
+static void nc_hash_slot_insert(struct nc_hash_slot *slots, uint32_t size,
+                                uint32_t hash, struct nc_hash_entry *entry)
+{
+    uint32_t mask = size - 1;
+    uint32_t idx;
+
+    for (idx = hash & mask;
+         slots[idx].entry != NULL;
+         idx = (idx + 1) & mask);
+
+    slots[idx].hash = hash;
+    slots[idx].entry = entry;
+}
+
+/* Backward shift deletion, keeps the probe sequences intact without
+ * tombstones. */
+static void nc_hash_slot_remove(struct nc_hash_shard *shard, uint32_t idx)
+{
+    uint32_t mask = shard->size - 1;
+    uint32_t hole = idx;
+    uint32_t next = idx;
+    uint32_t home;
+
+    for (;;) {
+        next = (next + 1) & mask;
+        if (shard->slots[next].entry == NULL) {
+            break;
+        }
+
+        home = shard->slots[next].hash & mask;
+
+        /* Entries whose home slot lies cyclically in (hole, next] must
+         * stay where they are. */
+        if (hole <= next ? (hole < home && home <= next)
+                         : (hole < home || home <= next)) {
+            continue;
+        }
+
+        shard->slots[hole] = shard->slots[next];
+        hole = next;
+    }
+
+    shard->slots[hole].hash = 0;
+    shard->slots[hole].entry = NULL;
+    shard->count--;
+}
+
+static errno_t nc_hash_shard_resize(struct nc_hash_ctx *hctx,
+                                    struct nc_hash_shard *shard,
+                                    uint32_t size)
+{
+    struct nc_hash_slot *slots;
+    uint32_t i;
+
+    slots = talloc_zero_array(hctx, struct nc_hash_slot, size);
+    if (slots == NULL) {
+        return ENOMEM;
+    }
+
+    for (i = 0; i < shard->size; i++) {
+        if (shard->slots[i].entry != NULL) {
+            nc_hash_slot_insert(slots, size, shard->slots[i].hash,
+                                shard->slots[i].entry);
+        }
+    }
+
+    talloc_free(shard->slots);
+    shard->slots = slots;
+    shard->size = size;
+
+    return EOK;
+}
+
+static void nc_hash_remove(struct nc_hash_ctx *hctx,
+                           struct nc_hash_entry *entry)
+{
+    struct nc_hash_shard *shard;
+    int64_t idx;
+
+    shard = nc_hash_shard(hctx, entry->hash);
+    idx = nc_hash_find(shard, entry->hash, NULL, entry);
+    if (idx >= 0) {
+        nc_hash_slot_remove(shard, idx);
+    }
+
+    DLIST_REMOVE(*nc_hash_list(hctx, entry->expire), entry);
+    talloc_free(entry);
+}
+
+/* Drop all entries which expired since the wheel was advanced last time.
+ * Entries in a bucket which belong to a later round of the wheel are
+ * left alone. */
+static void nc_hash_advance(struct nc_hash_ctx *hctx, time_t now)
+{
+    struct nc_hash_entry *entry;
+    struct nc_hash_entry *next;
+    time_t steps;
+    time_t t;
+
+    if (now <= hctx->wheel_time) {
+        return;
+    }
+
+    steps = now - hctx->wheel_time;
+    if (steps > NC_HASH_WHEEL_SIZE) {
+        steps = NC_HASH_WHEEL_SIZE;
+    }
+
+    for (t = now - steps + 1; t <= now; t++) {
+        for (entry = hctx->wheel[t % NC_HASH_WHEEL_SIZE];
+             entry != NULL;
+             entry = next) {
+            next = entry->next;
+            if (entry->expire < now) {
+                nc_hash_remove(hctx, entry);
+            }
+        }
+    }
+
+    hctx->wheel_time = now;
+}
+
+static errno_t nc_hash_init(TALLOC_CTX *mem_ctx, void **_pvt)
+{
+    struct nc_hash_ctx *hctx;
+    errno_t ret;
+    int i;
+
+    hctx = talloc_zero(mem_ctx, struct nc_hash_ctx);
+    if (hctx == NULL) {
+        return ENOMEM;
+    }
+
+    /* random seed to avoid collision attacks */
+    ret = sss_generate_csprng_buffer((uint8_t *)&hctx->seed,
+                                     sizeof(hctx->seed));
+    if (ret != EOK) {
+        DEBUG(SSSDBG_CRIT_FAILURE, "Unable to generate hash seed\n");
+        goto done;
+    }
+
+    for (i = 0; i < NC_HASH_SHARDS; i++) {
+        ret = nc_hash_shard_resize(hctx, &hctx->shards[i],
+                                   NC_HASH_SHARD_MIN_SIZE);
+        if (ret != EOK) {
+            goto done;
+        }
+    }
+
+    hctx->wheel_time = time(NULL);
+
+    *_pvt = hctx;
+    ret = EOK;
+
+done:
+    if (ret != EOK) {
+        talloc_free(hctx);
+    }
+
+    return ret;
+}
+
+static errno_t nc_hash_check(void *pvt, const struct sss_nc_key *key,
+                             time_t now)
+{
+    struct nc_hash_ctx *hctx = talloc_get_type(pvt, struct nc_hash_ctx);
+    struct nc_hash_shard *shard;
+    struct nc_hash_entry *entry;
+    uint32_t hash;
+    int64_t idx;
+
+    nc_hash_advance(hctx, now);
+
+    hash = nc_hash_key(hctx, key);
+    shard = nc_hash_shard(hctx, hash);
+
+    idx = nc_hash_find(shard, hash, key, NULL);
+    if (idx < 0) {
+        return ENOENT;
+    }
+
+    entry = shard->slots[idx].entry;
+    if (entry->expire != 0 && entry->expire < now) {
+        nc_hash_remove(hctx, entry);
+        return ENOENT;
+    }
+
+    return EEXIST;
+}
+
+static errno_t nc_hash_set(void *pvt, const struct sss_nc_key *key,
+                           time_t now, time_t expire)
+{
+    struct nc_hash_ctx *hctx = talloc_get_type(pvt, struct nc_hash_ctx);
+    struct nc_hash_shard *shard;
+    struct nc_hash_entry *entry;
+    size_t domain_len;
+    size_t name_len;
+    uint32_t hash;
+    int64_t idx;
+    errno_t ret;
+
+    nc_hash_advance(hctx, now);
+
+    hash = nc_hash_key(hctx, key);
+    shard = nc_hash_shard(hctx, hash);
+
+    idx = nc_hash_find(shard, hash, key, NULL);
+    if (idx >= 0) {
+        entry = shard->slots[idx].entry;
+        DLIST_REMOVE(*nc_hash_list(hctx, entry->expire), entry);
+        entry->expire = expire;
+        DLIST_ADD(*nc_hash_list(hctx, entry->expire), entry);
+        return EOK;
+    }
+
+    /* keep the load factor under 3/4 */
+    if ((shard->count + 1) * 4 > shard->size * 3) {
+        ret = nc_hash_shard_resize(hctx, shard, shard->size * 2);
+        if (ret != EOK) {
+            return ret;
+        }
+    }
+
+    domain_len = key->domain == NULL ? 0 : strlen(key->domain) + 1;
+    name_len = key->name == NULL ? 0 : strlen(key->name) + 1;
+
+    entry = talloc_size(hctx, sizeof(struct nc_hash_entry)
+                                  + domain_len + name_len);
+    if (entry == NULL) {
+        return ENOMEM;
+    }
+    talloc_set_name_const(entry, "struct nc_hash_entry");
+
+    entry->prev = NULL;
+    entry->next = NULL;
+    entry->expire = expire;
+    entry->hash = hash;
+    entry->type = key->type;
+    entry->id = key->id;
+    entry->domain = NULL;
+    entry->name = NULL;
+
+    if (key->domain != NULL) {
+        memcpy(entry->strs, key->domain, domain_len);
+        entry->domain = entry->strs;
+    }
+
+    if (key->name != NULL) {
+        memcpy(entry->strs + domain_len, key->name, name_len);
+        entry->name = entry->strs + domain_len;
+    }
+
+    nc_hash_slot_insert(shard->slots, shard->size, hash, entry);
+    shard->count++;
+
+    DLIST_ADD(*nc_hash_list(hctx, entry->expire), entry);
+
+    return EOK;
+}
+
+static errno_t nc_hash_reset_permanent(void *pvt)
+{
+    struct nc_hash_ctx *hctx = talloc_get_type(pvt, struct nc_hash_ctx);
+
+    while (hctx->permanent != NULL) {
+        nc_hash_remove(hctx, hctx->permanent);
+    }
+
+    return EOK;
+}
+
+static void nc_hash_reset_list(struct nc_hash_ctx *hctx,
+                               struct nc_hash_entry *list,
+                               const enum sss_nc_key_type *types)
+{
+    struct nc_hash_entry *entry;
+    struct nc_hash_entry *next;
+    int i;
+
+    for (entry = list; entry != NULL; entry = next) {
+        next = entry->next;
+
+        for (i = 0; types[i] != SSS_NC_KEY_SENTINEL; i++) {
+            if (entry->type == types[i]) {
+                nc_hash_remove(hctx, entry);
+                break;
+            }
+        }
+    }
+}
+
+static errno_t nc_hash_reset_types(void *pvt,
+                                   const enum sss_nc_key_type *types)
+{
+    struct nc_hash_ctx *hctx = talloc_get_type(pvt, struct nc_hash_ctx);
+    int i;
+
+    for (i = 0; i < NC_HASH_WHEEL_SIZE; i++) {
+        nc_hash_reset_list(hctx, hctx->wheel[i], types);
+    }
+
+    nc_hash_reset_list(hctx, hctx->permanent, types);
+
+    return EOK;
+}
+
+const struct sss_nc_backend sss_nc_backend_hash = {
+    .name = "hash",
+    .init = nc_hash_init,
+    .check = nc_hash_check,
+    .set = nc_hash_set,
+    .reset_permanent = nc_hash_reset_permanent,
+    .reset_types = nc_hash_reset_types,
+};
@@ -0,0 +1,82 @@
+/*
+   SSSD
+
+   Negative cache storage backends
+
+   Copyright (C) 2026 Red Hat
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef _NEGCACHE_PRIVATE_H_
+#define _NEGCACHE_PRIVATE_H_
+
+#include <time.h>
+#include <talloc.h>
+
+#include "util/util_errors.h"
+
+enum sss_nc_key_type {
+    SSS_NC_KEY_USER,
+    SSS_NC_KEY_GROUP,
+    SSS_NC_KEY_NETGROUP,
+    SSS_NC_KEY_SERVICE,
+    SSS_NC_KEY_UID,
+    SSS_NC_KEY_GID,
+    SSS_NC_KEY_SID,
+    SSS_NC_KEY_CERT,
+    SSS_NC_KEY_LOCATE_TYPE,
+    SSS_NC_KEY_LOCATE_UID,
+    SSS_NC_KEY_LOCATE_GID,
+
+    SSS_NC_KEY_SENTINEL
+};
+
+/* Typed negative cache key. Keys identified by a name have id set to 0,
+ * keys identified by an ID have name set to NULL. domain is NULL for
+ * keys which are not bound to a domain (SIDs, certificates and IDs
+ * looked up in all domains). */
+struct sss_nc_key {
+    enum sss_nc_key_type type;
+    const char *domain;
+    const char *name;
+    uint32_t id;
+};
+
+struct sss_nc_backend {
+    const char *name;
+
+    /* Allocate the backend private data on mem_ctx. */
+    errno_t (*init)(TALLOC_CTX *mem_ctx, void **_pvt);
+
+    /* Return EEXIST if the key is cached and not expired at now, ENOENT
+     * otherwise. Expired entries are removed. */
+    errno_t (*check)(void *pvt, const struct sss_nc_key *key, time_t now);
+
+    /* Add or replace the key, expire 0 means the entry is permanent. */
+    errno_t (*set)(void *pvt, const struct sss_nc_key *key,
+                   time_t now, time_t expire);
+
+    /* Remove all permanent entries. */
+    errno_t (*reset_permanent)(void *pvt);
+
+    /* Remove all entries of the given types, the list is terminated by
+     * SSS_NC_KEY_SENTINEL. */
+    errno_t (*reset_types)(void *pvt, const enum sss_nc_key_type *types);
+};
+
+extern const struct sss_nc_backend sss_nc_backend_tdb;
+extern const struct sss_nc_backend sss_nc_backend_hash;
+
+#endif /* _NEGCACHE_PRIVATE_H_ */
@@ -0,0 +1,326 @@
+/*
+   SSSD
+
+   Negative cache TDB backend
+
+   Copyright (C) Simo Sorce <ssorce@redhat.com>	2008
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <fcntl.h>
+#include <time.h>
+#include "tdb.h"
+#include "util/util.h"
+#include "responder/common/negcache_private.h"
+
+#define NC_ENTRY_PREFIX "NCE/"
+#define NC_USER_PREFIX NC_ENTRY_PREFIX"USER"
+#define NC_GROUP_PREFIX NC_ENTRY_PREFIX"GROUP"
+#define NC_NETGROUP_PREFIX NC_ENTRY_PREFIX"NETGR"
+#define NC_SERVICE_PREFIX NC_ENTRY_PREFIX"SERVICE"
+#define NC_UID_PREFIX NC_ENTRY_PREFIX"UID"
+#define NC_GID_PREFIX NC_ENTRY_PREFIX"GID"
+#define NC_SID_PREFIX NC_ENTRY_PREFIX"SID"
+#define NC_CERT_PREFIX NC_ENTRY_PREFIX"CERT"
+#define NC_DOMAIN_ACCT_LOCATE_PREFIX NC_ENTRY_PREFIX"DOM_LOCATE"
+#define NC_DOMAIN_ACCT_LOCATE_TYPE_PREFIX NC_ENTRY_PREFIX"DOM_LOCATE_TYPE"
+
+struct sss_nc_tdb_ctx {
+    struct tdb_context *tdb;
+};
+
+static int string_to_tdb_data(char *str, TDB_DATA *ret)
+{
+    if (!str || !ret) return EINVAL;
+
+    ret->dptr = (uint8_t *)str;
+    ret->dsize = strlen(str)+1;
+
+    return EOK;
+}
+
+static const char *sss_nc_tdb_prefix(enum sss_nc_key_type type)
+{
+    switch (type) {
+    case SSS_NC_KEY_USER:
+        return NC_USER_PREFIX;
+    case SSS_NC_KEY_GROUP:
+        return NC_GROUP_PREFIX;
+    case SSS_NC_KEY_NETGROUP:
+        return NC_NETGROUP_PREFIX;
+    case SSS_NC_KEY_SERVICE:
+        return NC_SERVICE_PREFIX;
+    case SSS_NC_KEY_UID:
+        return NC_UID_PREFIX;
+    case SSS_NC_KEY_GID:
+        return NC_GID_PREFIX;
+    case SSS_NC_KEY_SID:
+        return NC_SID_PREFIX;
+    case SSS_NC_KEY_CERT:
+        return NC_CERT_PREFIX;
+    case SSS_NC_KEY_LOCATE_TYPE:
+        return NC_DOMAIN_ACCT_LOCATE_TYPE_PREFIX;
+    case SSS_NC_KEY_LOCATE_UID:
+        return NC_DOMAIN_ACCT_LOCATE_PREFIX"/"NC_UID_PREFIX;
+    case SSS_NC_KEY_LOCATE_GID:
+        return NC_DOMAIN_ACCT_LOCATE_PREFIX"/"NC_GID_PREFIX;
+    case SSS_NC_KEY_SENTINEL:
+        break;
+    }
+
+    return NULL;
+}
+
+static char *sss_nc_tdb_key_str(TALLOC_CTX *mem_ctx,
+                                const struct sss_nc_key *key)
+{
+    const char *prefix;
+
+    prefix = sss_nc_tdb_prefix(key->type);
+    if (prefix == NULL) {
+        return NULL;
+    }
+
+    if (key->name != NULL) {
+        if (key->domain != NULL) {
+            return talloc_asprintf(mem_ctx, "%s/%s/%s",
+                                   prefix, key->domain, key->name);
+        }
+
+        return talloc_asprintf(mem_ctx, "%s/%s", prefix, key->name);
+    }
+
+    if (key->domain != NULL) {
+        return talloc_asprintf(mem_ctx, "%s/%s/%"PRIu32,
+                               prefix, key->domain, key->id);
+    }
+
+    return talloc_asprintf(mem_ctx, "%s/%"PRIu32, prefix, key->id);
+}
+
+static errno_t sss_nc_tdb_init(TALLOC_CTX *mem_ctx, void **_pvt)
+{
+    struct sss_nc_tdb_ctx *tctx;
+
+    tctx = talloc_zero(mem_ctx, struct sss_nc_tdb_ctx);
+    if (tctx == NULL) {
+        return ENOMEM;
+    }
+
+    errno = 0;
+    /* open a memory only tdb with default hash size */
+    tctx->tdb = tdb_open("memcache", 0, TDB_INTERNAL, O_RDWR|O_CREAT, 0);
+    if (!tctx->tdb) {
+        talloc_free(tctx);
+        return errno;
+    }
+
+    *_pvt = tctx;
+    return EOK;
+}
+
+static errno_t sss_nc_tdb_check(void *pvt, const struct sss_nc_key *nc_key,
+                                time_t now)
+{
+    struct sss_nc_tdb_ctx *tctx = talloc_get_type(pvt, struct sss_nc_tdb_ctx);
+    TDB_DATA key;
+    TDB_DATA data;
+    unsigned long long int timestamp;
+    bool expired = false;
+    char *str;
+    char *ep;
+    int ret;
+
+    data.dptr = NULL;
+
+    str = sss_nc_tdb_key_str(tctx, nc_key);
+    if (str == NULL) {
+        return ENOMEM;
+    }
+
+    ret = string_to_tdb_data(str, &key);
+    if (ret != EOK) goto done;
+
+    data = tdb_fetch(tctx->tdb, key);
+
+    if (!data.dptr) {
+        ret = ENOENT;
+        goto done;
+    }
+
+    errno = 0;
+    timestamp = strtoull((const char *)data.dptr, &ep, 10);
+    if (errno != 0 || *ep != '\0') {
+        /* Malformed entry, remove it and return no entry */
+        expired = true;
+        goto done;
+    }
+
+    if (timestamp == 0) {
+        /* a 0 timestamp means this is a permanent entry */
+        ret = EEXIST;
+        goto done;
+    }
+
+    if (timestamp >= now) {
+        /* still valid */
+        ret = EEXIST;
+        goto done;
+    }
+
+    expired = true;
+
+done:
+    if (expired) {
+        /* expired, remove and return no entry */
+        tdb_delete(tctx->tdb, key);
+        ret = ENOENT;
+    }
+
+    free(data.dptr);
+    talloc_free(str);
+    return ret;
+}
+
+static errno_t sss_nc_tdb_set(void *pvt, const struct sss_nc_key *nc_key,
+                              time_t now, time_t expire)
+{
+    struct sss_nc_tdb_ctx *tctx = talloc_get_type(pvt, struct sss_nc_tdb_ctx);
+    TDB_DATA key;
+    TDB_DATA data;
+    char *timest = NULL;
+    char *str;
+    int ret;
+
+    str = sss_nc_tdb_key_str(tctx, nc_key);
+    if (str == NULL) {
+        return ENOMEM;
+    }
+
+    ret = string_to_tdb_data(str, &key);
+    if (ret != EOK) goto done;
+
+    timest = talloc_asprintf(tctx, "%llu", (unsigned long long int)expire);
+    if (!timest) {
+        ret = ENOMEM;
+        goto done;
+    }
+
+    ret = string_to_tdb_data(timest, &data);
+    if (ret != EOK) goto done;
+
+    ret = tdb_store(tctx->tdb, key, data, TDB_REPLACE);
+    if (ret != 0) {
+        DEBUG(SSSDBG_CRIT_FAILURE, "Negative cache failed to set entry: [%s]\n",
+                  tdb_errorstr(tctx->tdb));
+        ret = EFAULT;
+    }
+
+done:
+    talloc_free(timest);
+    talloc_free(str);
+    return ret;
+}
+
+static int delete_permanent(struct tdb_context *tdb,
+                            TDB_DATA key, TDB_DATA data, void *state)
+{
+    unsigned long long int timestamp;
+    bool remove_key = false;
+    char *ep;
+
+    if (strncmp((char *)key.dptr,
+                NC_ENTRY_PREFIX, sizeof(NC_ENTRY_PREFIX) - 1) != 0) {
+        /* not interested in this key */
+        return 0;
+    }
+
+    errno = 0;
+    timestamp = strtoull((const char *)data.dptr, &ep, 10);
+    if (errno != 0 || *ep != '\0') {
+        /* Malformed entry, remove it */
+        remove_key = true;
+        goto done;
+    }
+
+    if (timestamp == 0) {
+        /* a 0 timestamp means this is a permanent entry */
+        remove_key = true;
+    }
+
+done:
+    if (remove_key) {
+        return tdb_delete(tdb, key);
+    }
+
+    return 0;
+}
+
+static errno_t sss_nc_tdb_reset_permanent(void *pvt)
+{
+    struct sss_nc_tdb_ctx *tctx = talloc_get_type(pvt, struct sss_nc_tdb_ctx);
+    int ret;
+
+    ret = tdb_traverse(tctx->tdb, delete_permanent, NULL);
+    if (ret < 0)
+        return EIO;
+
+    return EOK;
+}
+
+static int delete_prefix(struct tdb_context *tdb,
+                         TDB_DATA key, TDB_DATA data, void *state)
+{
+    const char *prefix = (const char *) state;
+
+    if (strncmp((char *)key.dptr, prefix, strlen(prefix)) != 0) {
+        /* not interested in this key */
+        return 0;
+    }
+
+    return tdb_delete(tdb, key);
+}
+
+static errno_t sss_nc_tdb_reset_types(void *pvt,
+                                      const enum sss_nc_key_type *types)
+{
+    struct sss_nc_tdb_ctx *tctx = talloc_get_type(pvt, struct sss_nc_tdb_ctx);
+    char *prefix;
+    int ret;
+
+    for (int i = 0; types[i] != SSS_NC_KEY_SENTINEL; i++) {
+        prefix = talloc_asprintf(tctx, "%s/", sss_nc_tdb_prefix(types[i]));
+        if (prefix == NULL) {
+            return ENOMEM;
+        }
+
+        ret = tdb_traverse(tctx->tdb, delete_prefix, prefix);
+        talloc_free(prefix);
+        if (ret < 0) {
+            return EIO;
+        }
+    }
+
+    return EOK;
+}
+
+const struct sss_nc_backend sss_nc_backend_tdb = {
+    .name = "tdb",
+    .init = sss_nc_tdb_init,
+    .check = sss_nc_tdb_check,
+    .set = sss_nc_tdb_set,
+    .reset_permanent = sss_nc_tdb_reset_permanent,
+    .reset_types = sss_nc_tdb_reset_types,
+};
@@ -149,6 +149,17 @@ struct resp_ctx {
 
     uint32_t cache_req_num;
 
+    /* In-flight cache_req searches shared by identical requests */
+    hash_table_t *cache_req_inflight;
+    uint64_t cache_req_searches;
+    uint64_t cache_req_coalesced;
+
+    /* Recent cache_req search results, NULL if disabled */
+    struct cache_req_lru *cache_req_lru;
+
+    /* Packet buffers reused by all client connections, NULL if disabled */
+    struct sss_packet_pool *packet_pool;
+
     void *pvt_ctx;
 
     bool shutting_down;
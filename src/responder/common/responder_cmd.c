@@ -34,9 +34,9 @@ int sss_cmd_send_error(struct cli_ctx *cctx, int err)
     if (!pctx) return EINVAL;
 
     /* create response packet */
-    ret = sss_packet_new(pctx->creq, 0,
-                         sss_packet_get_cmd(pctx->creq->in),
-                         &pctx->creq->out);
+    ret = sss_packet_new_pooled(pctx->creq, cctx->rctx->packet_pool, 0,
+                                sss_packet_get_cmd(pctx->creq->in),
+                                &pctx->creq->out);
     if (ret != EOK) {
         DEBUG(SSSDBG_CRIT_FAILURE, "Cannot create new packet: %d\n", ret);
         return ret;
@@ -75,9 +75,9 @@ int sss_cmd_send_empty(struct cli_ctx *cctx)
     if (!pctx) return EINVAL;
 
     /* create response packet */
-    ret = sss_packet_new(pctx->creq, 0,
-                         sss_packet_get_cmd(pctx->creq->in),
-                         &pctx->creq->out);
+    ret = sss_packet_new_pooled(pctx->creq, cctx->rctx->packet_pool, 0,
+                                sss_packet_get_cmd(pctx->creq->in),
+                                &pctx->creq->out);
     if (ret != EOK) {
         return ret;
     }
@@ -322,8 +322,9 @@ static void client_recv(struct cli_ctx *cctx)
     }
 
     if (!pctx->creq->in) {
-        ret = sss_packet_new(pctx->creq, SSS_PACKET_MAX_RECV_SIZE,
-                             0, &pctx->creq->in);
+        ret = sss_packet_new_pooled(pctx->creq, cctx->rctx->packet_pool,
+                                    SSS_PACKET_MAX_RECV_SIZE,
+                                    0, &pctx->creq->in);
         if (ret != EOK) {
             DEBUG(SSSDBG_FATAL_FAILURE,
                   "Failed to alloc request, aborting client!\n");
@@ -1120,11 +1121,19 @@ static errno_t responder_init_ncache(TALLOC_CTX *mem_ctx,
                                      struct confdb_ctx *cdb,
                                      struct sss_nc_ctx **ncache)
 {
+    TALLOC_CTX *tmp_ctx;
+    enum sss_ncache_backend backend;
+    char *backend_str;
     uint32_t neg_timeout;
     uint32_t locals_timeout;
     int tmp_value;
     int ret;
 
+    tmp_ctx = talloc_new(NULL);
+    if (tmp_ctx == NULL) {
+        return ENOMEM;
+    }
+
     /* neg_timeout */
     ret = confdb_get_int(cdb, CONFDB_NSS_CONF_ENTRY,
                          CONFDB_NSS_ENTRY_NEG_TIMEOUT,
@@ -1162,8 +1171,32 @@ static errno_t responder_init_ncache(TALLOC_CTX *mem_ctx,
 
     locals_timeout = tmp_value;
 
+    /* negative cache backend */
+    ret = confdb_get_string(cdb, tmp_ctx, CONFDB_NSS_CONF_ENTRY,
+                            CONFDB_NSS_NEG_CACHE_BACKEND,
+                            CONFDB_NSS_NEG_CACHE_BACKEND_DEFAULT,
+                            &backend_str);
+    if (ret != EOK) {
+        DEBUG(SSSDBG_FATAL_FAILURE,
+              "Fatal failure of setup negative cache backend.\n");
+        goto done;
+    }
+
+    if (strcasecmp(backend_str, "hash") == 0) {
+        backend = SSS_NCACHE_BACKEND_HASH;
+    } else if (strcasecmp(backend_str, "tdb") == 0) {
+        backend = SSS_NCACHE_BACKEND_TDB;
+    } else {
+        DEBUG(SSSDBG_FATAL_FAILURE,
+              "Unknown value [%s] of option %s\n",
+              backend_str, CONFDB_NSS_NEG_CACHE_BACKEND);
+        ret = EINVAL;
+        goto done;
+    }
+
     /* negative cache init */
-    ret = sss_ncache_init(mem_ctx, neg_timeout, locals_timeout, ncache);
+    ret = sss_ncache_init_ex(mem_ctx, backend, neg_timeout, locals_timeout,
+                             ncache);
     if (ret != EOK) {
         DEBUG(SSSDBG_FATAL_FAILURE,
               "Fatal failure of initializing negative cache.\n");
@@ -1173,6 +1206,7 @@ static errno_t responder_init_ncache(TALLOC_CTX *mem_ctx,
     ret = EOK;
 
 done:
+    talloc_free(tmp_ctx);
     return ret;
 }
 
@@ -1450,6 +1484,14 @@ int sss_process_init(TALLOC_CTX *mem_ctx,
     }
 
     /* after all initializations we are ready to listen on our socket */
+    ret = sss_packet_pool_new(rctx, &rctx->packet_pool);
+    if (ret != EOK) {
+        DEBUG(SSSDBG_MINOR_FAILURE,
+              "Could not create packet pool, packets will be "
+              "allocated for each request\n");
+        /* Non-fatal, continue */
+    }
+
     ret = activate_unix_sockets(rctx, conn_setup);
     if (ret != EOK) {
         DEBUG(SSSDBG_FATAL_FAILURE, "fatal error initializing socket\n");
@@ -1462,6 +1504,13 @@ int sss_process_init(TALLOC_CTX *mem_ctx,
         goto fail;
     }
 
+    ret = sss_hash_create(rctx, 64, &rctx->cache_req_inflight);
+    if (ret != EOK) {
+        DEBUG(SSSDBG_CRIT_FAILURE,
+              "Unable to create table of in-flight cache requests\n");
+        goto fail;
+    }
+
     ret = sss_ad_default_names_ctx(rctx, &rctx->global_names);
     if (ret != EOK) {
         DEBUG(SSSDBG_CRIT_FAILURE, "sss_ad_default_names_ctx failed.\n");
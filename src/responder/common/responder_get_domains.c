@@ -20,6 +20,7 @@
 
 #include "util/util.h"
 #include "responder/common/responder.h"
+#include "responder/common/cache_req/cache_req.h"
 #include "providers/data_provider.h"
 #include "db/sysdb.h"
 #include "sss_iface/sss_iface_async.h"
@@ -307,6 +308,7 @@ sss_dp_get_domains_process(struct tevent_req *subreq)
         }
 
         sss_resp_update_certmaps(state->rctx);
+        cache_req_lru_flush(state->rctx->cache_req_lru);
 
         ret = sss_ncache_reset_repopulate_permanent(state->rctx,
                                                     state->rctx->ncache);
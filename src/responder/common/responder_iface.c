@@ -19,6 +19,7 @@
 #include "sss_iface/sss_iface_async.h"
 #include "responder/common/negcache.h"
 #include "responder/common/responder.h"
+#include "responder/common/cache_req/cache_req.h"
 
 static void set_domain_state_by_name(struct resp_ctx *rctx,
                                      const char *domain_name,
@@ -79,6 +80,7 @@ sss_resp_reset_ncache_users(TALLOC_CTX *mem_ctx,
                             struct resp_ctx *rctx)
 {
     sss_ncache_reset_users(rctx->ncache);
+    cache_req_lru_flush(rctx->cache_req_lru);
 
     return EOK;
 }
@@ -89,6 +91,7 @@ sss_resp_reset_ncache_groups(TALLOC_CTX *mem_ctx,
                             struct resp_ctx *rctx)
 {
     sss_ncache_reset_groups(rctx->ncache);
+    cache_req_lru_flush(rctx->cache_req_lru);
 
     return EOK;
 }
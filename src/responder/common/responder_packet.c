@@ -21,6 +21,7 @@
 
 #include <sys/types.h>
 #include <sys/socket.h>
+#include <sys/uio.h>
 #include <string.h>
 #include <errno.h>
 #include <talloc.h>
@@ -30,9 +31,42 @@
 
 #define SSSSRV_PACKET_MEM_SIZE 512
 
+/* Buffer sizes kept by a packet pool. Requests and most replies fit in the
+ * smallest classes, larger buffers are allocated for each packet. */
+static const size_t sss_packet_pool_classes[] = { SSSSRV_PACKET_MEM_SIZE,
+                                                  4096, 65536 };
+#define SSS_PACKET_POOL_CLASSES \
+    (sizeof(sss_packet_pool_classes) / sizeof(sss_packet_pool_classes[0]))
+#define SSS_PACKET_POOL_MAX_SIZE \
+    sss_packet_pool_classes[SSS_PACKET_POOL_CLASSES - 1]
+
+/* Number of free buffers kept per class. The pool is shared by all clients
+ * of a responder, so an idle responder holds about 208 KiB no matter how
+ * many connections are open. */
+static const int sss_packet_pool_depths[] = { 32, 16, 2 };
+#define SSS_PACKET_POOL_MAX_DEPTH 32
+
+struct sss_packet_pool {
+    /* packets currently using buffers of the pool */
+    struct sss_packet *packets;
+
+    struct {
+        uint8_t *buffers[SSS_PACKET_POOL_MAX_DEPTH];
+        int num;
+    } free[SSS_PACKET_POOL_CLASSES];
+};
+
 struct sss_packet {
+    struct sss_packet *prev;
+    struct sss_packet *next;
+    struct sss_packet_pool *pool;
+
     size_t memsize;
 
+    /* Largest length sss_packet_recv() accepts without enlarging the
+     * packet, the buffer of a pooled packet may be larger. */
+    size_t recv_limit;
+
     /* Structure of the buffer:
     * Bytes    Content
     * ---------------------------------
@@ -44,6 +78,11 @@ struct sss_packet {
     * 16+      packet body */
     uint8_t *buffer;
 
+    /* Data sent after the buffer, not accessible through
+     * sss_packet_get_body(). The packet length includes it. */
+    uint8_t *tail;
+    size_t tail_len;
+
     /* io pointer */
     size_t iop;
 };
@@ -59,29 +98,133 @@ static void sss_packet_set_cmd(struct sss_packet *packet,
                                enum sss_cli_command cmd);
 static uint32_t sss_packet_get_len(struct sss_packet *packet);
 
+static int sss_packet_pool_find_class(size_t size)
+{
+    int i;
+
+    for (i = 0; i < SSS_PACKET_POOL_CLASSES; i++) {
+        if (size <= sss_packet_pool_classes[i]) {
+            return i;
+        }
+    }
+
+    return -1;
+}
+
+static int sss_packet_pool_destructor(struct sss_packet_pool *pool)
+{
+    struct sss_packet *packet;
+
+    /* The packets may outlive the pool, their buffers are simply freed
+     * with them then. */
+    while ((packet = pool->packets) != NULL) {
+        DLIST_REMOVE(pool->packets, packet);
+        packet->pool = NULL;
+    }
+
+    return 0;
+}
+
+int sss_packet_pool_new(TALLOC_CTX *mem_ctx, struct sss_packet_pool **_pool)
+{
+    struct sss_packet_pool *pool;
+
+    pool = talloc_zero(mem_ctx, struct sss_packet_pool);
+    if (pool == NULL) {
+        return ENOMEM;
+    }
+
+    talloc_set_destructor(pool, sss_packet_pool_destructor);
+
+    *_pool = pool;
+    return EOK;
+}
+
+/* Allocate a buffer of at least size bytes for the packet. Pooled packets
+ * get a buffer of the matching size class, possibly a reused one. */
+static uint8_t *sss_packet_buffer_get(struct sss_packet *packet, size_t size,
+                                      size_t *_memsize)
+{
+    struct sss_packet_pool *pool = packet->pool;
+    uint8_t *buffer;
+    int c;
+
+    c = pool == NULL ? -1 : sss_packet_pool_find_class(size);
+    if (c == -1) {
+        *_memsize = size;
+        return talloc_size(packet, size);
+    }
+
+    *_memsize = sss_packet_pool_classes[c];
+    if (pool->free[c].num == 0) {
+        return talloc_size(packet, sss_packet_pool_classes[c]);
+    }
+
+    buffer = pool->free[c].buffers[--pool->free[c].num];
+    return talloc_steal(packet, buffer);
+}
+
+static void sss_packet_buffer_put(struct sss_packet_pool *pool,
+                                  uint8_t *buffer, size_t memsize)
+{
+    int c;
+
+    c = pool == NULL ? -1 : sss_packet_pool_find_class(memsize);
+    if (c == -1 || sss_packet_pool_classes[c] != memsize
+            || pool->free[c].num == sss_packet_pool_depths[c]) {
+        talloc_free(buffer);
+        return;
+    }
+
+    pool->free[c].buffers[pool->free[c].num++] = talloc_steal(pool, buffer);
+}
+
+static int sss_packet_destructor(struct sss_packet *packet)
+{
+    if (packet->pool != NULL) {
+        DLIST_REMOVE(packet->pool->packets, packet);
+        sss_packet_buffer_put(packet->pool, packet->buffer, packet->memsize);
+        packet->pool = NULL;
+    }
+
+    return 0;
+}
+
 /*
  * Allocate a new packet structure
  *
  * - if size is defined use it otherwise the default packet will be
  *   SSSSRV_PACKET_MEM_SIZE bytes.
+ * - if pool is defined the buffer is taken from it and given back when the
+ *   packet is freed.
  */
-int sss_packet_new(TALLOC_CTX *mem_ctx, size_t size,
-                   enum sss_cli_command cmd,
-                   struct sss_packet **rpacket)
+int sss_packet_new_pooled(TALLOC_CTX *mem_ctx,
+                          struct sss_packet_pool *pool,
+                          size_t size,
+                          enum sss_cli_command cmd,
+                          struct sss_packet **rpacket)
 {
     struct sss_packet *packet;
+    size_t memsize;
 
-    packet = talloc(mem_ctx, struct sss_packet);
+    packet = talloc_zero(mem_ctx, struct sss_packet);
     if (!packet) return ENOMEM;
 
     if (size) {
         int n = (size + SSS_NSS_HEADER_SIZE) / SSSSRV_PACKET_MEM_SIZE;
-        packet->memsize = (n + 1) * SSSSRV_PACKET_MEM_SIZE;
+        memsize = (n + 1) * SSSSRV_PACKET_MEM_SIZE;
     } else {
-        packet->memsize = SSSSRV_PACKET_MEM_SIZE;
+        memsize = SSSSRV_PACKET_MEM_SIZE;
     }
+    packet->recv_limit = memsize;
 
-    packet->buffer = talloc_size(packet, packet->memsize);
+    if (pool != NULL) {
+        packet->pool = pool;
+        DLIST_ADD(pool->packets, packet);
+        talloc_set_destructor(packet, sss_packet_destructor);
+    }
+
+    packet->buffer = sss_packet_buffer_get(packet, memsize, &packet->memsize);
     if (!packet->buffer) {
         talloc_free(packet);
         return ENOMEM;
@@ -98,21 +241,22 @@ int sss_packet_new(TALLOC_CTX *mem_ctx, size_t size,
     return EOK;
 }
 
-/* grows a packet size only in SSSSRV_PACKET_MEM_SIZE chunks */
-int sss_packet_grow(struct sss_packet *packet, size_t size)
+int sss_packet_new(TALLOC_CTX *mem_ctx, size_t size,
+                   enum sss_cli_command cmd,
+                   struct sss_packet **rpacket)
 {
-    size_t totlen, len;
-    uint8_t *newmem;
-    uint32_t packet_len;
+    return sss_packet_new_pooled(mem_ctx, NULL, size, cmd, rpacket);
+}
 
-    if (size == 0) {
-        return EOK;
-    }
+/* make sure the buffer holds at least len bytes, the buffer only grows in
+ * SSSSRV_PACKET_MEM_SIZE chunks */
+static int sss_packet_make_room(struct sss_packet *packet, size_t len)
+{
+    size_t totlen;
+    size_t memsize;
+    uint8_t *newmem;
 
     totlen = packet->memsize;
-    packet_len = sss_packet_get_len(packet);
-
-    len = packet_len + size;
 
     /* make sure we do not overflow */
     if (totlen < len) {
@@ -123,18 +267,54 @@ int sss_packet_grow(struct sss_packet *packet, size_t size)
         }
     }
 
-    if (totlen > packet->memsize) {
+    if (totlen <= packet->memsize) {
+        return EOK;
+    }
+
+    if (packet->pool != NULL && packet->memsize <= SSS_PACKET_POOL_MAX_SIZE) {
+        /* Move to a buffer of a larger class. The whole old buffer is
+         * copied, sss_packet_recv() may have read past the length. */
+        newmem = sss_packet_buffer_get(packet, totlen, &memsize);
+        if (!newmem) {
+            return ENOMEM;
+        }
+
+        memcpy(newmem, packet->buffer, packet->memsize);
+        sss_packet_buffer_put(packet->pool, packet->buffer, packet->memsize);
+    } else {
         newmem = talloc_realloc_size(packet, packet->buffer, totlen);
         if (!newmem) {
             return ENOMEM;
         }
+        memsize = totlen;
+    }
 
-        packet->memsize = totlen;
+    packet->memsize = memsize;
+    packet->buffer = newmem;
 
-        /* re-set pointers if realloc had to move memory */
-        if (newmem != packet->buffer) {
-            packet->buffer = newmem;
-        }
+    return EOK;
+}
+
+/* grows a packet size only in SSSSRV_PACKET_MEM_SIZE chunks */
+int sss_packet_grow(struct sss_packet *packet, size_t size)
+{
+    uint32_t packet_len;
+    int ret;
+
+    if (size == 0) {
+        return EOK;
+    }
+
+    /* nothing can be appended after the tail */
+    if (packet->tail != NULL) {
+        return EINVAL;
+    }
+
+    packet_len = sss_packet_get_len(packet);
+
+    ret = sss_packet_make_room(packet, packet_len + size);
+    if (ret != EOK) {
+        return ret;
     }
 
     packet_len += size;
@@ -144,6 +324,52 @@ int sss_packet_grow(struct sss_packet *packet, size_t size)
     return 0;
 }
 
+/* make room for size more bytes without changing the packet length, so
+ * that encoders which know the size of the result up front do not need
+ * to reallocate the buffer field by field */
+int sss_packet_reserve(struct sss_packet *packet, size_t size)
+{
+    size_t len;
+
+    if (packet->tail != NULL) {
+        return EINVAL;
+    }
+
+    len = sss_packet_get_len(packet) + size;
+    if (len < size) {
+        return EINVAL;
+    }
+
+    return sss_packet_make_room(packet, len);
+}
+
+int sss_packet_set_tail(struct sss_packet *packet,
+                        uint8_t *data, size_t len)
+{
+    uint32_t packet_len;
+
+    /* Only replies built for a client connection are sent without being
+     * read back with sss_packet_get_body(). */
+    if (packet->pool == NULL) {
+        return ENOTSUP;
+    }
+
+    if (packet->tail != NULL) {
+        return EINVAL;
+    }
+
+    packet_len = sss_packet_get_len(packet);
+    if (len > UINT32_MAX - packet_len) {
+        return EINVAL;
+    }
+
+    packet->tail = talloc_steal(packet, data);
+    packet->tail_len = len;
+    sss_packet_set_len(packet, packet_len + len);
+
+    return EOK;
+}
+
 /* reclaim back previously reserved space in the packet
  * usually done in function recovering from not fatal errors */
 int sss_packet_shrink(struct sss_packet *packet, size_t size)
@@ -154,7 +380,7 @@ int sss_packet_shrink(struct sss_packet *packet, size_t size)
     if (size > oldlen) return EINVAL;
 
     newlen = oldlen - size;
-    if (newlen < SSS_NSS_HEADER_SIZE) return EINVAL;
+    if (newlen < SSS_NSS_HEADER_SIZE + packet->tail_len) return EINVAL;
 
     sss_packet_set_len(packet, newlen);
     return 0;
@@ -169,17 +395,41 @@ int sss_packet_set_size(struct sss_packet *packet, size_t size)
     /* make sure we do not overflow */
     if (packet->memsize < newlen) return EINVAL;
 
+    talloc_zfree(packet->tail);
+    packet->tail_len = 0;
+
     sss_packet_set_len(packet, newlen);
 
     return 0;
 }
 
+static size_t sss_packet_max_recv_size(enum sss_cli_command cmd)
+{
+    switch (cmd) {
+    case SSS_NSS_GETNAMEBYCERT:
+    case SSS_NSS_GETLISTBYCERT:
+        return SSS_CERT_PACKET_MAX_RECV_SIZE;
+    case SSS_NSS_GETPWNAM_LIST:
+    case SSS_NSS_GETPWUID_LIST:
+    case SSS_NSS_GETGRNAM_LIST:
+    case SSS_NSS_GETGRGID_LIST:
+    case SSS_NSS_GETSIDBYNAME_LIST:
+    case SSS_NSS_GETSIDBYID_LIST:
+    case SSS_NSS_GETNAMEBYSID_LIST:
+    case SSS_NSS_GETIDBYSID_LIST:
+        return SSS_LIST_PACKET_MAX_RECV_SIZE;
+    default:
+        return SSS_PACKET_MAX_RECV_SIZE;
+    }
+}
+
 int sss_packet_recv(struct sss_packet *packet, int fd)
 {
     size_t rb;
     size_t len;
     void *buf;
     size_t new_len;
+    size_t max_len;
     int ret;
 
     buf = (uint8_t *)packet->buffer + packet->iop;
@@ -206,22 +456,21 @@ int sss_packet_recv(struct sss_packet *packet, int fd)
         return ENODATA;
     }
 
-    if (sss_packet_get_len(packet) > packet->memsize) {
-        /* Allow certificate based requests to use larger buffer but not
-         * larger than SSS_CERT_PACKET_MAX_RECV_SIZE. Due to the way
+    if (sss_packet_get_len(packet) > packet->recv_limit) {
+        /* Allow certificate based and batched requests to use larger buffer
+         * but not larger than their maximal receive size. Due to the way
          * sss_packet_grow() works the packet len must be set to '0' first and
          * then grow to the expected size. */
-        if ((sss_packet_get_cmd(packet) == SSS_NSS_GETNAMEBYCERT
-                    || sss_packet_get_cmd(packet) == SSS_NSS_GETLISTBYCERT)
-                && packet->memsize < SSS_CERT_PACKET_MAX_RECV_SIZE
-                && (new_len = sss_packet_get_len(packet))
-                                   < SSS_CERT_PACKET_MAX_RECV_SIZE) {
+        max_len = sss_packet_max_recv_size(sss_packet_get_cmd(packet));
+        if (packet->recv_limit < max_len
+                && (new_len = sss_packet_get_len(packet)) < max_len) {
             new_len = sss_packet_get_len(packet);
             sss_packet_set_len(packet, 0);
             ret = sss_packet_grow(packet, new_len);
             if (ret != EOK) {
                 return ret;
             }
+            packet->recv_limit = packet->memsize;
         } else {
             return EINVAL;
         }
@@ -241,20 +490,36 @@ int sss_packet_recv(struct sss_packet *packet, int fd)
 
 int sss_packet_send(struct sss_packet *packet, int fd)
 {
+    struct iovec iov[2];
+    int iovcnt;
     size_t rb;
-    size_t len;
-    void *buf;
+    size_t buflen;
 
     if (!packet) {
         /* No packet object to write to? */
         return EINVAL;
     }
 
-    buf = packet->buffer + packet->iop;
-    len = sss_packet_get_len(packet) - packet->iop;
+    /* the tail is sent right after the buffer in the same call */
+    buflen = sss_packet_get_len(packet) - packet->tail_len;
+    iovcnt = 0;
+    if (packet->iop < buflen) {
+        iov[iovcnt].iov_base = packet->buffer + packet->iop;
+        iov[iovcnt].iov_len = buflen - packet->iop;
+        iovcnt++;
+    }
+    if (packet->tail_len > 0) {
+        iov[iovcnt].iov_base = packet->tail;
+        iov[iovcnt].iov_len = packet->tail_len;
+        if (packet->iop > buflen) {
+            iov[iovcnt].iov_base = packet->tail + (packet->iop - buflen);
+            iov[iovcnt].iov_len -= packet->iop - buflen;
+        }
+        iovcnt++;
+    }
 
     errno = 0;
-    rb = send(fd, buf, len, 0);
+    rb = writev(fd, iov, iovcnt);
 
     if (rb == -1) {
         if (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR) {
@@ -297,7 +562,8 @@ uint32_t sss_packet_get_status(struct sss_packet *packet)
 void sss_packet_get_body(struct sss_packet *packet, uint8_t **body, size_t *blen)
 {
     *body = packet->buffer + SSS_PACKET_BODY_OFFSET;
-    *blen = sss_packet_get_len(packet) - SSS_NSS_HEADER_SIZE;
+    *blen = sss_packet_get_len(packet) - SSS_NSS_HEADER_SIZE
+                - packet->tail_len;
 }
 
 void sss_packet_set_error(struct sss_packet *packet, int error)
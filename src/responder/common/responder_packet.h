@@ -26,13 +26,30 @@
 
 #define SSS_PACKET_MAX_RECV_SIZE 1024
 #define SSS_CERT_PACKET_MAX_RECV_SIZE ( 10 * SSS_PACKET_MAX_RECV_SIZE )
+#define SSS_LIST_PACKET_MAX_RECV_SIZE SSS_NSS_MAX_LIST_REQ_SIZE
 
 struct sss_packet;
 
+/* Buffers of freed packets kept for the next packets of any client. */
+struct sss_packet_pool;
+
+int sss_packet_pool_new(TALLOC_CTX *mem_ctx, struct sss_packet_pool **_pool);
+
 int sss_packet_new(TALLOC_CTX *mem_ctx, size_t size,
                    enum sss_cli_command cmd,
                    struct sss_packet **rpacket);
+int sss_packet_new_pooled(TALLOC_CTX *mem_ctx,
+                          struct sss_packet_pool *pool,
+                          size_t size,
+                          enum sss_cli_command cmd,
+                          struct sss_packet **rpacket);
 int sss_packet_grow(struct sss_packet *packet, size_t size);
+int sss_packet_reserve(struct sss_packet *packet, size_t size);
+/* Send the talloc allocated data after the body without copying it into
+ * the packet, the packet becomes its owner. Nothing can be added to the
+ * packet afterwards. Returns ENOTSUP for packets not created from a pool. */
+int sss_packet_set_tail(struct sss_packet *packet,
+                        uint8_t *data, size_t len);
 int sss_packet_shrink(struct sss_packet *packet, size_t size);
 int sss_packet_set_size(struct sss_packet *packet, size_t size);
 int sss_packet_recv(struct sss_packet *packet, int fd);
@@ -934,6 +934,113 @@ ifp_domains_domain_list_servers_recv(TALLOC_CTX *mem_ctx,
     return EOK;
 }
 
+struct ifp_domains_domain_list_server_latencies_state {
+    const char **servers;
+    uint32_t *rtt_usec;
+};
+
+static void
+ifp_domains_domain_list_server_latencies_done(struct tevent_req *subreq);
+
+struct tevent_req *
+ifp_domains_domain_list_server_latencies_send(TALLOC_CTX *mem_ctx,
+                                              struct tevent_context *ev,
+                                              struct sbus_request *sbus_req,
+                                              struct ifp_ctx *ifp_ctx,
+                                              const char *service)
+{
+    struct ifp_domains_domain_list_server_latencies_state *state;
+    struct sss_domain_info *dom;
+    struct tevent_req *subreq;
+    struct tevent_req *req;
+    struct be_conn *be_conn;
+    errno_t ret;
+
+    req = tevent_req_create(mem_ctx, &state,
+                    struct ifp_domains_domain_list_server_latencies_state);
+    if (req == NULL) {
+        DEBUG(SSSDBG_CRIT_FAILURE, "Unable to create tevent request!\n");
+        return NULL;
+    }
+
+    dom = get_domain_info_from_req(sbus_req, ifp_ctx);
+    if (dom == NULL) {
+        ret = ERR_DOMAIN_NOT_FOUND;
+        goto done;
+    }
+
+    ret = sss_dp_get_domain_conn(ifp_ctx->rctx, dom->conn_name, &be_conn);
+    if (ret != EOK) {
+        DEBUG(SSSDBG_CRIT_FAILURE, "BUG: The Data Provider connection for "
+              "%s is not available!\n", dom->name);
+        goto done;
+    }
+
+    subreq = sbus_call_dp_failover_ListServerLatencies_send(state,
+                be_conn->conn, be_conn->bus_name, SSS_BUS_PATH, service);
+    if (subreq == NULL) {
+        DEBUG(SSSDBG_CRIT_FAILURE, "Unable to create subrequest!\n");
+        ret = ENOMEM;
+        goto done;
+    }
+
+    tevent_req_set_callback(subreq,
+                            ifp_domains_domain_list_server_latencies_done,
+                            req);
+
+    ret = EAGAIN;
+
+done:
+    if (ret != EAGAIN) {
+        tevent_req_error(req, ret);
+        tevent_req_post(req, ev);
+    }
+
+    return req;
+}
+
+static void
+ifp_domains_domain_list_server_latencies_done(struct tevent_req *subreq)
+{
+    struct ifp_domains_domain_list_server_latencies_state *state;
+    struct tevent_req *req;
+    errno_t ret;
+
+    req = tevent_req_callback_data(subreq, struct tevent_req);
+    state = tevent_req_data(req,
+                    struct ifp_domains_domain_list_server_latencies_state);
+
+    ret = sbus_call_dp_failover_ListServerLatencies_recv(state, subreq,
+                                                         &state->servers,
+                                                         &state->rtt_usec);
+    talloc_zfree(subreq);
+    if (ret != EOK) {
+        tevent_req_error(req, ret);
+        return;
+    }
+
+    tevent_req_done(req);
+    return;
+}
+
+errno_t
+ifp_domains_domain_list_server_latencies_recv(TALLOC_CTX *mem_ctx,
+                                              struct tevent_req *req,
+                                              const char ***_servers,
+                                              uint32_t **_rtt_usec)
+{
+    struct ifp_domains_domain_list_server_latencies_state *state;
+    state = tevent_req_data(req,
+                    struct ifp_domains_domain_list_server_latencies_state);
+
+    TEVENT_REQ_RETURN_ON_ERROR(req);
+
+    *_servers = talloc_steal(mem_ctx, state->servers);
+    *_rtt_usec = talloc_steal(mem_ctx, state->rtt_usec);
+
+    return EOK;
+}
+
 struct ifp_domains_domain_refresh_access_rules_state {
     int dummy;
 };
@@ -295,6 +295,46 @@ ifp_groups_find_by_id_recv(TALLOC_CTX *mem_ctx,
     return EOK;
 }
 
+struct tevent_req *
+ifp_groups_find_by_name_list_send(TALLOC_CTX *mem_ctx,
+                                  struct tevent_context *ev,
+                                  struct sbus_request *sbus_req,
+                                  struct ifp_ctx *ctx,
+                                  const char **names)
+{
+    return ifp_find_list_send(mem_ctx, ev, ctx, CACHE_REQ_GROUP_BY_NAME,
+                              CACHE_REQ_ANY_DOM, names, NULL,
+                              ifp_groups_build_path_from_msg);
+}
+
+errno_t
+ifp_groups_find_by_name_list_recv(TALLOC_CTX *mem_ctx,
+                                  struct tevent_req *req,
+                                  const char ***_paths)
+{
+    return ifp_find_list_recv(mem_ctx, req, _paths);
+}
+
+struct tevent_req *
+ifp_groups_find_by_id_list_send(TALLOC_CTX *mem_ctx,
+                                struct tevent_context *ev,
+                                struct sbus_request *sbus_req,
+                                struct ifp_ctx *ctx,
+                                uint32_t *ids)
+{
+    return ifp_find_list_send(mem_ctx, ev, ctx, CACHE_REQ_GROUP_BY_ID,
+                              CACHE_REQ_POSIX_DOM, NULL, ids,
+                              ifp_groups_build_path_from_msg);
+}
+
+errno_t
+ifp_groups_find_by_id_list_recv(TALLOC_CTX *mem_ctx,
+                                struct tevent_req *req,
+                                const char ***_paths)
+{
+    return ifp_find_list_recv(mem_ctx, req, _paths);
+}
+
 struct ifp_groups_list_by_name_state {
     struct ifp_ctx *ifp_ctx;
     struct ifp_list_ctx *list_ctx;
@@ -951,6 +991,141 @@ ifp_groups_group_get_unique_id(TALLOC_CTX *mem_ctx,
     return EOK;
 }
 
+static errno_t
+ifp_groups_get_attrs_of(TALLOC_CTX *mem_ctx,
+                        struct ifp_ctx *ifp_ctx,
+                        const char *path,
+                        const char **attrs,
+                        hash_table_t **_table)
+{
+    TALLOC_CTX *tmp_ctx;
+    struct sss_domain_info *domain;
+    struct ldb_message_element *el;
+    struct ldb_message *msg;
+    hash_table_t *table;
+    const char *name;
+    char *out_name;
+    char *key;
+    errno_t ret;
+    int i;
+
+    tmp_ctx = talloc_new(NULL);
+    if (tmp_ctx == NULL) {
+        return ENOMEM;
+    }
+
+    ret = sss_hash_create(tmp_ctx, 10, &table);
+    if (ret != EOK) {
+        DEBUG(SSSDBG_CRIT_FAILURE, "Unable to create hash table!\n");
+        goto done;
+    }
+
+    /* A group that does not exist gets an empty dictionary. */
+    ret = ifp_groups_decompose_path(tmp_ctx, ifp_ctx->rctx->domains, path,
+                                    &domain, &key);
+    if (ret != EOK) {
+        DEBUG(SSSDBG_MINOR_FAILURE, "Unable to decompose object path "
+              "[%s] [%d]: %s\n", path, ret, sss_strerror(ret));
+        ret = EOK;
+        goto found;
+    }
+
+    ret = ifp_groups_get_from_cache(tmp_ctx, domain, key, &msg);
+    if (ret == ENOENT) {
+        DEBUG(SSSDBG_TRACE_FUNC, "Group [%s] is not cached\n", path);
+        ret = EOK;
+        goto found;
+    } else if (ret != EOK) {
+        goto done;
+    }
+
+    /* Only the attributes that are also available as properties. */
+    for (i = 0; attrs[i] != NULL; i++) {
+        if (strcmp(attrs[i], SYSDB_NAME) == 0) {
+            name = sss_view_ldb_msg_find_attr_as_string(domain, msg,
+                                                        SYSDB_NAME, NULL);
+            if (name == NULL) {
+                DEBUG(SSSDBG_OP_FAILURE, "No name?\n");
+                ret = ERR_INTERNAL;
+                goto done;
+            }
+
+            out_name = ifp_format_name_attr(tmp_ctx, ifp_ctx, name, domain);
+            if (out_name == NULL) {
+                ret = ENOMEM;
+                goto done;
+            }
+
+            ret = ifp_attrs_add_string(table, attrs[i], out_name);
+        } else if (strcmp(attrs[i], SYSDB_GIDNUM) == 0
+                || strcmp(attrs[i], SYSDB_UUID) == 0) {
+            el = sss_view_ldb_msg_find_element(domain, msg, attrs[i]);
+            if (el == NULL || el->num_values == 0) {
+                continue;
+            }
+
+            ret = ifp_attrs_add_el(table, attrs[i], el);
+        } else {
+            DEBUG(SSSDBG_TRACE_ALL, "Attribute %s is not supported\n",
+                  attrs[i]);
+            continue;
+        }
+
+        if (ret != EOK) {
+            goto done;
+        }
+    }
+
+found:
+    *_table = talloc_steal(mem_ctx, table);
+    ret = EOK;
+
+done:
+    talloc_free(tmp_ctx);
+    return ret;
+}
+
+errno_t
+ifp_groups_get_attrs(TALLOC_CTX *mem_ctx,
+                     struct sbus_request *sbus_req,
+                     struct ifp_ctx *ifp_ctx,
+                     const char **paths,
+                     const char **attrs,
+                     hash_table_t ***_out)
+{
+    static const char *no_attrs[] = {NULL};
+    hash_table_t **tables;
+    size_t count;
+    errno_t ret;
+    size_t i;
+
+    if (attrs == NULL) {
+        attrs = no_attrs;
+    }
+
+    for (count = 0; paths != NULL && paths[count] != NULL; count++) {
+        /* Just count the objects. */
+    }
+
+    tables = talloc_zero_array(mem_ctx, hash_table_t *, count + 1);
+    if (tables == NULL) {
+        return ENOMEM;
+    }
+
+    for (i = 0; i < count; i++) {
+        ret = ifp_groups_get_attrs_of(tables, ifp_ctx, paths[i], attrs,
+                                      &tables[i]);
+        if (ret != EOK) {
+            talloc_free(tables);
+            return ret;
+        }
+    }
+
+    *_out = tables;
+
+    return EOK;
+}
+
 static errno_t
 ifp_groups_group_get_members(TALLOC_CTX *mem_ctx,
                              struct sbus_request *sbus_req,
@@ -55,6 +55,38 @@ ifp_groups_find_by_id_recv(TALLOC_CTX *mem_ctx,
                            struct tevent_req *req,
                            const char **_path);
 
+struct tevent_req *
+ifp_groups_find_by_name_list_send(TALLOC_CTX *mem_ctx,
+                                  struct tevent_context *ev,
+                                  struct sbus_request *sbus_req,
+                                  struct ifp_ctx *ctx,
+                                  const char **names);
+
+errno_t
+ifp_groups_find_by_name_list_recv(TALLOC_CTX *mem_ctx,
+                                  struct tevent_req *req,
+                                  const char ***_paths);
+
+struct tevent_req *
+ifp_groups_find_by_id_list_send(TALLOC_CTX *mem_ctx,
+                                struct tevent_context *ev,
+                                struct sbus_request *sbus_req,
+                                struct ifp_ctx *ctx,
+                                uint32_t *ids);
+
+errno_t
+ifp_groups_find_by_id_list_recv(TALLOC_CTX *mem_ctx,
+                                struct tevent_req *req,
+                                const char ***_paths);
+
+errno_t
+ifp_groups_get_attrs(TALLOC_CTX *mem_ctx,
+                     struct sbus_request *sbus_req,
+                     struct ifp_ctx *ifp_ctx,
+                     const char **paths,
+                     const char **attrs,
+                     hash_table_t ***_out);
+
 struct tevent_req *
 ifp_groups_list_by_name_send(TALLOC_CTX *mem_ctx,
                              struct tevent_context *ev,
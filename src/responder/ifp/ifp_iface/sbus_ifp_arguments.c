@@ -56,6 +56,45 @@ errno_t _sbus_ifp_invoker_write_ao
     return EOK;
 }
 
+errno_t _sbus_ifp_invoker_read_aoas
+   (TALLOC_CTX *mem_ctx,
+    DBusMessageIter *iter,
+    struct _sbus_ifp_invoker_args_aoas *args)
+{
+    errno_t ret;
+
+    ret = sbus_iterator_read_ao(mem_ctx, iter, &args->arg0);
+    if (ret != EOK) {
+        return ret;
+    }
+
+    ret = sbus_iterator_read_as(mem_ctx, iter, &args->arg1);
+    if (ret != EOK) {
+        return ret;
+    }
+
+    return EOK;
+}
+
+errno_t _sbus_ifp_invoker_write_aoas
+   (DBusMessageIter *iter,
+    struct _sbus_ifp_invoker_args_aoas *args)
+{
+    errno_t ret;
+
+    ret = sbus_iterator_write_ao(iter, args->arg0);
+    if (ret != EOK) {
+        return ret;
+    }
+
+    ret = sbus_iterator_write_as(iter, args->arg1);
+    if (ret != EOK) {
+        return ret;
+    }
+
+    return EOK;
+}
+
 errno_t _sbus_ifp_invoker_read_as
    (TALLOC_CTX *mem_ctx,
     DBusMessageIter *iter,
@@ -85,6 +124,74 @@ errno_t _sbus_ifp_invoker_write_as
     return EOK;
 }
 
+errno_t _sbus_ifp_invoker_read_asau
+   (TALLOC_CTX *mem_ctx,
+    DBusMessageIter *iter,
+    struct _sbus_ifp_invoker_args_asau *args)
+{
+    errno_t ret;
+
+    ret = sbus_iterator_read_as(mem_ctx, iter, &args->arg0);
+    if (ret != EOK) {
+        return ret;
+    }
+
+    ret = sbus_iterator_read_au(mem_ctx, iter, &args->arg1);
+    if (ret != EOK) {
+        return ret;
+    }
+
+    return EOK;
+}
+
+errno_t _sbus_ifp_invoker_write_asau
+   (DBusMessageIter *iter,
+    struct _sbus_ifp_invoker_args_asau *args)
+{
+    errno_t ret;
+
+    ret = sbus_iterator_write_as(iter, args->arg0);
+    if (ret != EOK) {
+        return ret;
+    }
+
+    ret = sbus_iterator_write_au(iter, args->arg1);
+    if (ret != EOK) {
+        return ret;
+    }
+
+    return EOK;
+}
+
+errno_t _sbus_ifp_invoker_read_au
+   (TALLOC_CTX *mem_ctx,
+    DBusMessageIter *iter,
+    struct _sbus_ifp_invoker_args_au *args)
+{
+    errno_t ret;
+
+    ret = sbus_iterator_read_au(mem_ctx, iter, &args->arg0);
+    if (ret != EOK) {
+        return ret;
+    }
+
+    return EOK;
+}
+
+errno_t _sbus_ifp_invoker_write_au
+   (DBusMessageIter *iter,
+    struct _sbus_ifp_invoker_args_au *args)
+{
+    errno_t ret;
+
+    ret = sbus_iterator_write_au(iter, args->arg0);
+    if (ret != EOK) {
+        return ret;
+    }
+
+    return EOK;
+}
+
 errno_t _sbus_ifp_invoker_read_b
    (TALLOC_CTX *mem_ctx,
     DBusMessageIter *iter,
@@ -114,6 +221,35 @@ errno_t _sbus_ifp_invoker_write_b
     return EOK;
 }
 
+errno_t _sbus_ifp_invoker_read_ifp_attrs_list
+   (TALLOC_CTX *mem_ctx,
+    DBusMessageIter *iter,
+    struct _sbus_ifp_invoker_args_ifp_attrs_list *args)
+{
+    errno_t ret;
+
+    ret = sbus_iterator_read_ifp_attrs_list(mem_ctx, iter, &args->arg0);
+    if (ret != EOK) {
+        return ret;
+    }
+
+    return EOK;
+}
+
+errno_t _sbus_ifp_invoker_write_ifp_attrs_list
+   (DBusMessageIter *iter,
+    struct _sbus_ifp_invoker_args_ifp_attrs_list *args)
+{
+    errno_t ret;
+
+    ret = sbus_iterator_write_ifp_attrs_list(iter, args->arg0);
+    if (ret != EOK) {
+        return ret;
+    }
+
+    return EOK;
+}
+
 errno_t _sbus_ifp_invoker_read_ifp_extra
    (TALLOC_CTX *mem_ctx,
     DBusMessageIter *iter,
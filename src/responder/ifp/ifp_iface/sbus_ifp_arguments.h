@@ -43,6 +43,22 @@ _sbus_ifp_invoker_write_ao
    (DBusMessageIter *iter,
     struct _sbus_ifp_invoker_args_ao *args);
 
+struct _sbus_ifp_invoker_args_aoas {
+    const char ** arg0;
+    const char ** arg1;
+};
+
+errno_t
+_sbus_ifp_invoker_read_aoas
+   (TALLOC_CTX *mem_ctx,
+    DBusMessageIter *iter,
+    struct _sbus_ifp_invoker_args_aoas *args);
+
+errno_t
+_sbus_ifp_invoker_write_aoas
+   (DBusMessageIter *iter,
+    struct _sbus_ifp_invoker_args_aoas *args);
+
 struct _sbus_ifp_invoker_args_as {
     const char ** arg0;
 };
@@ -58,6 +74,37 @@ _sbus_ifp_invoker_write_as
    (DBusMessageIter *iter,
     struct _sbus_ifp_invoker_args_as *args);
 
+struct _sbus_ifp_invoker_args_asau {
+    const char ** arg0;
+    uint32_t * arg1;
+};
+
+errno_t
+_sbus_ifp_invoker_read_asau
+   (TALLOC_CTX *mem_ctx,
+    DBusMessageIter *iter,
+    struct _sbus_ifp_invoker_args_asau *args);
+
+errno_t
+_sbus_ifp_invoker_write_asau
+   (DBusMessageIter *iter,
+    struct _sbus_ifp_invoker_args_asau *args);
+
+struct _sbus_ifp_invoker_args_au {
+    uint32_t * arg0;
+};
+
+errno_t
+_sbus_ifp_invoker_read_au
+   (TALLOC_CTX *mem_ctx,
+    DBusMessageIter *iter,
+    struct _sbus_ifp_invoker_args_au *args);
+
+errno_t
+_sbus_ifp_invoker_write_au
+   (DBusMessageIter *iter,
+    struct _sbus_ifp_invoker_args_au *args);
+
 struct _sbus_ifp_invoker_args_b {
     bool arg0;
 };
@@ -73,6 +120,21 @@ _sbus_ifp_invoker_write_b
    (DBusMessageIter *iter,
     struct _sbus_ifp_invoker_args_b *args);
 
+struct _sbus_ifp_invoker_args_ifp_attrs_list {
+    hash_table_t ** arg0;
+};
+
+errno_t
+_sbus_ifp_invoker_read_ifp_attrs_list
+   (TALLOC_CTX *mem_ctx,
+    DBusMessageIter *iter,
+    struct _sbus_ifp_invoker_args_ifp_attrs_list *args);
+
+errno_t
+_sbus_ifp_invoker_write_ifp_attrs_list
+   (DBusMessageIter *iter,
+    struct _sbus_ifp_invoker_args_ifp_attrs_list *args);
+
 struct _sbus_ifp_invoker_args_ifp_extra {
     hash_table_t * arg0;
 };
@@ -265,6 +265,173 @@ done:
     return ret;
 }
 
+static errno_t
+sbus_method_in_aoas_out_ifp_attrs_list
+    (TALLOC_CTX *mem_ctx,
+     struct sbus_sync_connection *conn,
+     const char *bus,
+     const char *path,
+     const char *iface,
+     const char *method,
+     const char ** arg0,
+     const char ** arg1,
+     hash_table_t *** _arg0)
+{
+    TALLOC_CTX *tmp_ctx;
+    struct _sbus_ifp_invoker_args_aoas in;
+    struct _sbus_ifp_invoker_args_ifp_attrs_list *out;
+    DBusMessage *reply;
+    errno_t ret;
+
+    tmp_ctx = talloc_new(NULL);
+    if (tmp_ctx == NULL) {
+        DEBUG(SSSDBG_FATAL_FAILURE, "Out of memory!\n");
+        return ENOMEM;
+    }
+
+    out = talloc_zero(tmp_ctx, struct _sbus_ifp_invoker_args_ifp_attrs_list);
+    if (out == NULL) {
+        DEBUG(SSSDBG_CRIT_FAILURE,
+              "Unable to allocate space for output parameters!\n");
+        ret = ENOMEM;
+        goto done;
+    }
+
+    in.arg0 = arg0;
+    in.arg1 = arg1;
+
+    ret = sbus_sync_call_method(tmp_ctx, conn, NULL,
+                                (sbus_invoker_writer_fn)_sbus_ifp_invoker_write_aoas,
+                                bus, path, iface, method, &in, &reply);
+    if (ret != EOK) {
+        goto done;
+    }
+
+    ret = sbus_read_output(out, reply, (sbus_invoker_reader_fn)_sbus_ifp_invoker_read_ifp_attrs_list, out);
+    if (ret != EOK) {
+        goto done;
+    }
+
+    *_arg0 = talloc_steal(mem_ctx, out->arg0);
+
+    ret = EOK;
+
+done:
+    talloc_free(tmp_ctx);
+
+    return ret;
+}
+
+static errno_t
+sbus_method_in_as_out_ao
+    (TALLOC_CTX *mem_ctx,
+     struct sbus_sync_connection *conn,
+     const char *bus,
+     const char *path,
+     const char *iface,
+     const char *method,
+     const char ** arg0,
+     const char *** _arg0)
+{
+    TALLOC_CTX *tmp_ctx;
+    struct _sbus_ifp_invoker_args_as in;
+    struct _sbus_ifp_invoker_args_ao *out;
+    DBusMessage *reply;
+    errno_t ret;
+
+    tmp_ctx = talloc_new(NULL);
+    if (tmp_ctx == NULL) {
+        DEBUG(SSSDBG_FATAL_FAILURE, "Out of memory!\n");
+        return ENOMEM;
+    }
+
+    out = talloc_zero(tmp_ctx, struct _sbus_ifp_invoker_args_ao);
+    if (out == NULL) {
+        DEBUG(SSSDBG_CRIT_FAILURE,
+              "Unable to allocate space for output parameters!\n");
+        ret = ENOMEM;
+        goto done;
+    }
+
+    in.arg0 = arg0;
+
+    ret = sbus_sync_call_method(tmp_ctx, conn, NULL,
+                                (sbus_invoker_writer_fn)_sbus_ifp_invoker_write_as,
+                                bus, path, iface, method, &in, &reply);
+    if (ret != EOK) {
+        goto done;
+    }
+
+    ret = sbus_read_output(out, reply, (sbus_invoker_reader_fn)_sbus_ifp_invoker_read_ao, out);
+    if (ret != EOK) {
+        goto done;
+    }
+
+    *_arg0 = talloc_steal(mem_ctx, out->arg0);
+
+    ret = EOK;
+
+done:
+    talloc_free(tmp_ctx);
+
+    return ret;
+}
+
+static errno_t
+sbus_method_in_au_out_ao
+    (TALLOC_CTX *mem_ctx,
+     struct sbus_sync_connection *conn,
+     const char *bus,
+     const char *path,
+     const char *iface,
+     const char *method,
+     uint32_t * arg0,
+     const char *** _arg0)
+{
+    TALLOC_CTX *tmp_ctx;
+    struct _sbus_ifp_invoker_args_au in;
+    struct _sbus_ifp_invoker_args_ao *out;
+    DBusMessage *reply;
+    errno_t ret;
+
+    tmp_ctx = talloc_new(NULL);
+    if (tmp_ctx == NULL) {
+        DEBUG(SSSDBG_FATAL_FAILURE, "Out of memory!\n");
+        return ENOMEM;
+    }
+
+    out = talloc_zero(tmp_ctx, struct _sbus_ifp_invoker_args_ao);
+    if (out == NULL) {
+        DEBUG(SSSDBG_CRIT_FAILURE,
+              "Unable to allocate space for output parameters!\n");
+        ret = ENOMEM;
+        goto done;
+    }
+
+    in.arg0 = arg0;
+
+    ret = sbus_sync_call_method(tmp_ctx, conn, NULL,
+                                (sbus_invoker_writer_fn)_sbus_ifp_invoker_write_au,
+                                bus, path, iface, method, &in, &reply);
+    if (ret != EOK) {
+        goto done;
+    }
+
+    ret = sbus_read_output(out, reply, (sbus_invoker_reader_fn)_sbus_ifp_invoker_read_ao, out);
+    if (ret != EOK) {
+        goto done;
+    }
+
+    *_arg0 = talloc_steal(mem_ctx, out->arg0);
+
+    ret = EOK;
+
+done:
+    talloc_free(tmp_ctx);
+
+    return ret;
+}
+
 static errno_t
 sbus_method_in_s_out_ao
     (TALLOC_CTX *mem_ctx,
@@ -375,6 +542,63 @@ done:
     return ret;
 }
 
+static errno_t
+sbus_method_in_s_out_asau
+    (TALLOC_CTX *mem_ctx,
+     struct sbus_sync_connection *conn,
+     const char *bus,
+     const char *path,
+     const char *iface,
+     const char *method,
+     const char * arg0,
+     const char *** _arg0,
+     uint32_t ** _arg1)
+{
+    TALLOC_CTX *tmp_ctx;
+    struct _sbus_ifp_invoker_args_s in;
+    struct _sbus_ifp_invoker_args_asau *out;
+    DBusMessage *reply;
+    errno_t ret;
+
+    tmp_ctx = talloc_new(NULL);
+    if (tmp_ctx == NULL) {
+        DEBUG(SSSDBG_FATAL_FAILURE, "Out of memory!\n");
+        return ENOMEM;
+    }
+
+    out = talloc_zero(tmp_ctx, struct _sbus_ifp_invoker_args_asau);
+    if (out == NULL) {
+        DEBUG(SSSDBG_CRIT_FAILURE,
+              "Unable to allocate space for output parameters!\n");
+        ret = ENOMEM;
+        goto done;
+    }
+
+    in.arg0 = arg0;
+
+    ret = sbus_sync_call_method(tmp_ctx, conn, NULL,
+                                (sbus_invoker_writer_fn)_sbus_ifp_invoker_write_s,
+                                bus, path, iface, method, &in, &reply);
+    if (ret != EOK) {
+        goto done;
+    }
+
+    ret = sbus_read_output(out, reply, (sbus_invoker_reader_fn)_sbus_ifp_invoker_read_asau, out);
+    if (ret != EOK) {
+        goto done;
+    }
+
+    *_arg0 = talloc_steal(mem_ctx, out->arg0);
+    *_arg1 = talloc_steal(mem_ctx, out->arg1);
+
+    ret = EOK;
+
+done:
+    talloc_free(tmp_ctx);
+
+    return ret;
+}
+
 static errno_t
 sbus_method_in_s_out_o
     (TALLOC_CTX *mem_ctx,
@@ -998,6 +1222,22 @@ sbus_call_ifp_domain_IsOnline
           _arg_status);
 }
 
+errno_t
+sbus_call_ifp_domain_ListServerLatencies
+    (TALLOC_CTX *mem_ctx,
+     struct sbus_sync_connection *conn,
+     const char *busname,
+     const char *object_path,
+     const char * arg_service_name,
+     const char *** _arg_servers,
+     uint32_t ** _arg_rtt_usec)
+{
+     return sbus_method_in_s_out_asau(mem_ctx, conn,
+          busname, object_path, "org.freedesktop.sssd.infopipe.Domains.Domain", "ListServerLatencies", arg_service_name,
+          _arg_servers,
+          _arg_rtt_usec);
+}
+
 errno_t
 sbus_call_ifp_domain_ListServers
     (TALLOC_CTX *mem_ctx,
@@ -1049,6 +1289,20 @@ sbus_call_ifp_groups_FindByID
           _arg_result);
 }
 
+errno_t
+sbus_call_ifp_groups_FindByIDList
+    (TALLOC_CTX *mem_ctx,
+     struct sbus_sync_connection *conn,
+     const char *busname,
+     const char *object_path,
+     uint32_t * arg_ids,
+     const char *** _arg_result)
+{
+     return sbus_method_in_au_out_ao(mem_ctx, conn,
+          busname, object_path, "org.freedesktop.sssd.infopipe.Groups", "FindByIDList", arg_ids,
+          _arg_result);
+}
+
 errno_t
 sbus_call_ifp_groups_FindByName
     (TALLOC_CTX *mem_ctx,
@@ -1063,6 +1317,35 @@ sbus_call_ifp_groups_FindByName
           _arg_result);
 }
 
+errno_t
+sbus_call_ifp_groups_FindByNameList
+    (TALLOC_CTX *mem_ctx,
+     struct sbus_sync_connection *conn,
+     const char *busname,
+     const char *object_path,
+     const char ** arg_names,
+     const char *** _arg_result)
+{
+     return sbus_method_in_as_out_ao(mem_ctx, conn,
+          busname, object_path, "org.freedesktop.sssd.infopipe.Groups", "FindByNameList", arg_names,
+          _arg_result);
+}
+
+errno_t
+sbus_call_ifp_groups_GetAttrs
+    (TALLOC_CTX *mem_ctx,
+     struct sbus_sync_connection *conn,
+     const char *busname,
+     const char *object_path,
+     const char ** arg_objects,
+     const char ** arg_attrs,
+     hash_table_t *** _arg_result)
+{
+     return sbus_method_in_aoas_out_ifp_attrs_list(mem_ctx, conn,
+          busname, object_path, "org.freedesktop.sssd.infopipe.Groups", "GetAttrs", arg_objects, arg_attrs,
+          _arg_result);
+}
+
 errno_t
 sbus_call_ifp_groups_ListByDomainAndName
     (TALLOC_CTX *mem_ctx,
@@ -1132,6 +1415,20 @@ sbus_call_ifp_users_FindByID
           _arg_result);
 }
 
+errno_t
+sbus_call_ifp_users_FindByIDList
+    (TALLOC_CTX *mem_ctx,
+     struct sbus_sync_connection *conn,
+     const char *busname,
+     const char *object_path,
+     uint32_t * arg_ids,
+     const char *** _arg_result)
+{
+     return sbus_method_in_au_out_ao(mem_ctx, conn,
+          busname, object_path, "org.freedesktop.sssd.infopipe.Users", "FindByIDList", arg_ids,
+          _arg_result);
+}
+
 errno_t
 sbus_call_ifp_users_FindByName
     (TALLOC_CTX *mem_ctx,
@@ -1161,6 +1458,35 @@ sbus_call_ifp_users_FindByNameAndCertificate
           _arg_result);
 }
 
+errno_t
+sbus_call_ifp_users_FindByNameList
+    (TALLOC_CTX *mem_ctx,
+     struct sbus_sync_connection *conn,
+     const char *busname,
+     const char *object_path,
+     const char ** arg_names,
+     const char *** _arg_result)
+{
+     return sbus_method_in_as_out_ao(mem_ctx, conn,
+          busname, object_path, "org.freedesktop.sssd.infopipe.Users", "FindByNameList", arg_names,
+          _arg_result);
+}
+
+errno_t
+sbus_call_ifp_users_GetAttrs
+    (TALLOC_CTX *mem_ctx,
+     struct sbus_sync_connection *conn,
+     const char *busname,
+     const char *object_path,
+     const char ** arg_objects,
+     const char ** arg_attrs,
+     hash_table_t *** _arg_result)
+{
+     return sbus_method_in_aoas_out_ifp_attrs_list(mem_ctx, conn,
+          busname, object_path, "org.freedesktop.sssd.infopipe.Users", "GetAttrs", arg_objects, arg_attrs,
+          _arg_result);
+}
+
 errno_t
 sbus_call_ifp_users_ListByCertificate
     (TALLOC_CTX *mem_ctx,
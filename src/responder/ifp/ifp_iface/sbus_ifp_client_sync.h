@@ -170,6 +170,16 @@ sbus_call_ifp_domain_IsOnline
      const char *object_path,
      bool* _arg_status);
 
+errno_t
+sbus_call_ifp_domain_ListServerLatencies
+    (TALLOC_CTX *mem_ctx,
+     struct sbus_sync_connection *conn,
+     const char *busname,
+     const char *object_path,
+     const char * arg_service_name,
+     const char *** _arg_servers,
+     uint32_t ** _arg_rtt_usec);
+
 errno_t
 sbus_call_ifp_domain_ListServers
     (TALLOC_CTX *mem_ctx,
@@ -202,6 +212,15 @@ sbus_call_ifp_groups_FindByID
      uint32_t arg_id,
      const char ** _arg_result);
 
+errno_t
+sbus_call_ifp_groups_FindByIDList
+    (TALLOC_CTX *mem_ctx,
+     struct sbus_sync_connection *conn,
+     const char *busname,
+     const char *object_path,
+     uint32_t * arg_ids,
+     const char *** _arg_result);
+
 errno_t
 sbus_call_ifp_groups_FindByName
     (TALLOC_CTX *mem_ctx,
@@ -211,6 +230,25 @@ sbus_call_ifp_groups_FindByName
      const char * arg_name,
      const char ** _arg_result);
 
+errno_t
+sbus_call_ifp_groups_FindByNameList
+    (TALLOC_CTX *mem_ctx,
+     struct sbus_sync_connection *conn,
+     const char *busname,
+     const char *object_path,
+     const char ** arg_names,
+     const char *** _arg_result);
+
+errno_t
+sbus_call_ifp_groups_GetAttrs
+    (TALLOC_CTX *mem_ctx,
+     struct sbus_sync_connection *conn,
+     const char *busname,
+     const char *object_path,
+     const char ** arg_objects,
+     const char ** arg_attrs,
+     hash_table_t *** _arg_result);
+
 errno_t
 sbus_call_ifp_groups_ListByDomainAndName
     (TALLOC_CTX *mem_ctx,
@@ -256,6 +294,15 @@ sbus_call_ifp_users_FindByID
      uint32_t arg_id,
      const char ** _arg_result);
 
+errno_t
+sbus_call_ifp_users_FindByIDList
+    (TALLOC_CTX *mem_ctx,
+     struct sbus_sync_connection *conn,
+     const char *busname,
+     const char *object_path,
+     uint32_t * arg_ids,
+     const char *** _arg_result);
+
 errno_t
 sbus_call_ifp_users_FindByName
     (TALLOC_CTX *mem_ctx,
@@ -275,6 +322,25 @@ sbus_call_ifp_users_FindByNameAndCertificate
      const char * arg_pem_cert,
      const char ** _arg_result);
 
+errno_t
+sbus_call_ifp_users_FindByNameList
+    (TALLOC_CTX *mem_ctx,
+     struct sbus_sync_connection *conn,
+     const char *busname,
+     const char *object_path,
+     const char ** arg_names,
+     const char *** _arg_result);
+
+errno_t
+sbus_call_ifp_users_GetAttrs
+    (TALLOC_CTX *mem_ctx,
+     struct sbus_sync_connection *conn,
+     const char *busname,
+     const char *object_path,
+     const char ** arg_objects,
+     const char ** arg_attrs,
+     hash_table_t *** _arg_result);
+
 errno_t
 sbus_call_ifp_users_ListByCertificate
     (TALLOC_CTX *mem_ctx,
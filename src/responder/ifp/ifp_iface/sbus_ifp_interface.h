@@ -1100,6 +1100,28 @@
         (handler_send), (handler_recv), (data)); \
 })
 
+/* Method: org.freedesktop.sssd.infopipe.Domains.Domain.ListServerLatencies */
+#define SBUS_METHOD_SYNC_org_freedesktop_sssd_infopipe_Domains_Domain_ListServerLatencies(handler, data) ({ \
+    SBUS_CHECK_SYNC((handler), (data), const char *, const char ***, uint32_t **); \
+    sbus_method_sync("ListServerLatencies", \
+        &_sbus_ifp_args_org_freedesktop_sssd_infopipe_Domains_Domain_ListServerLatencies, \
+        NULL, \
+        _sbus_ifp_invoke_in_s_out_asau_send, \
+        _sbus_ifp_key_s_0, \
+        (handler), (data)); \
+})
+
+#define SBUS_METHOD_ASYNC_org_freedesktop_sssd_infopipe_Domains_Domain_ListServerLatencies(handler_send, handler_recv, data) ({ \
+    SBUS_CHECK_SEND((handler_send), (data), const char *); \
+    SBUS_CHECK_RECV((handler_recv), const char ***, uint32_t **); \
+    sbus_method_async("ListServerLatencies", \
+        &_sbus_ifp_args_org_freedesktop_sssd_infopipe_Domains_Domain_ListServerLatencies, \
+        NULL, \
+        _sbus_ifp_invoke_in_s_out_asau_send, \
+        _sbus_ifp_key_s_0, \
+        (handler_send), (handler_recv), (data)); \
+})
+
 /* Method: org.freedesktop.sssd.infopipe.Domains.Domain.ListServers */
 #define SBUS_METHOD_SYNC_org_freedesktop_sssd_infopipe_Domains_Domain_ListServers(handler, data) ({ \
     SBUS_CHECK_SYNC((handler), (data), const char *, const char ***); \
@@ -1194,6 +1216,28 @@
         (handler_send), (handler_recv), (data)); \
 })
 
+/* Method: org.freedesktop.sssd.infopipe.Groups.FindByIDList */
+#define SBUS_METHOD_SYNC_org_freedesktop_sssd_infopipe_Groups_FindByIDList(handler, data) ({ \
+    SBUS_CHECK_SYNC((handler), (data), uint32_t *, const char ***); \
+    sbus_method_sync("FindByIDList", \
+        &_sbus_ifp_args_org_freedesktop_sssd_infopipe_Groups_FindByIDList, \
+        NULL, \
+        _sbus_ifp_invoke_in_au_out_ao_send, \
+        NULL, \
+        (handler), (data)); \
+})
+
+#define SBUS_METHOD_ASYNC_org_freedesktop_sssd_infopipe_Groups_FindByIDList(handler_send, handler_recv, data) ({ \
+    SBUS_CHECK_SEND((handler_send), (data), uint32_t *); \
+    SBUS_CHECK_RECV((handler_recv), const char ***); \
+    sbus_method_async("FindByIDList", \
+        &_sbus_ifp_args_org_freedesktop_sssd_infopipe_Groups_FindByIDList, \
+        NULL, \
+        _sbus_ifp_invoke_in_au_out_ao_send, \
+        NULL, \
+        (handler_send), (handler_recv), (data)); \
+})
+
 /* Method: org.freedesktop.sssd.infopipe.Groups.FindByName */
 #define SBUS_METHOD_SYNC_org_freedesktop_sssd_infopipe_Groups_FindByName(handler, data) ({ \
     SBUS_CHECK_SYNC((handler), (data), const char *, const char **); \
@@ -1216,6 +1260,50 @@
         (handler_send), (handler_recv), (data)); \
 })
 
+/* Method: org.freedesktop.sssd.infopipe.Groups.FindByNameList */
+#define SBUS_METHOD_SYNC_org_freedesktop_sssd_infopipe_Groups_FindByNameList(handler, data) ({ \
+    SBUS_CHECK_SYNC((handler), (data), const char **, const char ***); \
+    sbus_method_sync("FindByNameList", \
+        &_sbus_ifp_args_org_freedesktop_sssd_infopipe_Groups_FindByNameList, \
+        NULL, \
+        _sbus_ifp_invoke_in_as_out_ao_send, \
+        NULL, \
+        (handler), (data)); \
+})
+
+#define SBUS_METHOD_ASYNC_org_freedesktop_sssd_infopipe_Groups_FindByNameList(handler_send, handler_recv, data) ({ \
+    SBUS_CHECK_SEND((handler_send), (data), const char **); \
+    SBUS_CHECK_RECV((handler_recv), const char ***); \
+    sbus_method_async("FindByNameList", \
+        &_sbus_ifp_args_org_freedesktop_sssd_infopipe_Groups_FindByNameList, \
+        NULL, \
+        _sbus_ifp_invoke_in_as_out_ao_send, \
+        NULL, \
+        (handler_send), (handler_recv), (data)); \
+})
+
+/* Method: org.freedesktop.sssd.infopipe.Groups.GetAttrs */
+#define SBUS_METHOD_SYNC_org_freedesktop_sssd_infopipe_Groups_GetAttrs(handler, data) ({ \
+    SBUS_CHECK_SYNC((handler), (data), const char **, const char **, hash_table_t ***); \
+    sbus_method_sync("GetAttrs", \
+        &_sbus_ifp_args_org_freedesktop_sssd_infopipe_Groups_GetAttrs, \
+        NULL, \
+        _sbus_ifp_invoke_in_aoas_out_ifp_attrs_list_send, \
+        NULL, \
+        (handler), (data)); \
+})
+
+#define SBUS_METHOD_ASYNC_org_freedesktop_sssd_infopipe_Groups_GetAttrs(handler_send, handler_recv, data) ({ \
+    SBUS_CHECK_SEND((handler_send), (data), const char **, const char **); \
+    SBUS_CHECK_RECV((handler_recv), hash_table_t ***); \
+    sbus_method_async("GetAttrs", \
+        &_sbus_ifp_args_org_freedesktop_sssd_infopipe_Groups_GetAttrs, \
+        NULL, \
+        _sbus_ifp_invoke_in_aoas_out_ifp_attrs_list_send, \
+        NULL, \
+        (handler_send), (handler_recv), (data)); \
+})
+
 /* Method: org.freedesktop.sssd.infopipe.Groups.ListByDomainAndName */
 #define SBUS_METHOD_SYNC_org_freedesktop_sssd_infopipe_Groups_ListByDomainAndName(handler, data) ({ \
     SBUS_CHECK_SYNC((handler), (data), const char *, const char *, uint32_t, const char ***); \
@@ -1513,6 +1601,28 @@
         (handler_send), (handler_recv), (data)); \
 })
 
+/* Method: org.freedesktop.sssd.infopipe.Users.FindByIDList */
+#define SBUS_METHOD_SYNC_org_freedesktop_sssd_infopipe_Users_FindByIDList(handler, data) ({ \
+    SBUS_CHECK_SYNC((handler), (data), uint32_t *, const char ***); \
+    sbus_method_sync("FindByIDList", \
+        &_sbus_ifp_args_org_freedesktop_sssd_infopipe_Users_FindByIDList, \
+        NULL, \
+        _sbus_ifp_invoke_in_au_out_ao_send, \
+        NULL, \
+        (handler), (data)); \
+})
+
+#define SBUS_METHOD_ASYNC_org_freedesktop_sssd_infopipe_Users_FindByIDList(handler_send, handler_recv, data) ({ \
+    SBUS_CHECK_SEND((handler_send), (data), uint32_t *); \
+    SBUS_CHECK_RECV((handler_recv), const char ***); \
+    sbus_method_async("FindByIDList", \
+        &_sbus_ifp_args_org_freedesktop_sssd_infopipe_Users_FindByIDList, \
+        NULL, \
+        _sbus_ifp_invoke_in_au_out_ao_send, \
+        NULL, \
+        (handler_send), (handler_recv), (data)); \
+})
+
 /* Method: org.freedesktop.sssd.infopipe.Users.FindByName */
 #define SBUS_METHOD_SYNC_org_freedesktop_sssd_infopipe_Users_FindByName(handler, data) ({ \
     SBUS_CHECK_SYNC((handler), (data), const char *, const char **); \
@@ -1557,6 +1667,50 @@
         (handler_send), (handler_recv), (data)); \
 })
 
+/* Method: org.freedesktop.sssd.infopipe.Users.FindByNameList */
+#define SBUS_METHOD_SYNC_org_freedesktop_sssd_infopipe_Users_FindByNameList(handler, data) ({ \
+    SBUS_CHECK_SYNC((handler), (data), const char **, const char ***); \
+    sbus_method_sync("FindByNameList", \
+        &_sbus_ifp_args_org_freedesktop_sssd_infopipe_Users_FindByNameList, \
+        NULL, \
+        _sbus_ifp_invoke_in_as_out_ao_send, \
+        NULL, \
+        (handler), (data)); \
+})
+
+#define SBUS_METHOD_ASYNC_org_freedesktop_sssd_infopipe_Users_FindByNameList(handler_send, handler_recv, data) ({ \
+    SBUS_CHECK_SEND((handler_send), (data), const char **); \
+    SBUS_CHECK_RECV((handler_recv), const char ***); \
+    sbus_method_async("FindByNameList", \
+        &_sbus_ifp_args_org_freedesktop_sssd_infopipe_Users_FindByNameList, \
+        NULL, \
+        _sbus_ifp_invoke_in_as_out_ao_send, \
+        NULL, \
+        (handler_send), (handler_recv), (data)); \
+})
+
+/* Method: org.freedesktop.sssd.infopipe.Users.GetAttrs */
+#define SBUS_METHOD_SYNC_org_freedesktop_sssd_infopipe_Users_GetAttrs(handler, data) ({ \
+    SBUS_CHECK_SYNC((handler), (data), const char **, const char **, hash_table_t ***); \
+    sbus_method_sync("GetAttrs", \
+        &_sbus_ifp_args_org_freedesktop_sssd_infopipe_Users_GetAttrs, \
+        NULL, \
+        _sbus_ifp_invoke_in_aoas_out_ifp_attrs_list_send, \
+        NULL, \
+        (handler), (data)); \
+})
+
+#define SBUS_METHOD_ASYNC_org_freedesktop_sssd_infopipe_Users_GetAttrs(handler_send, handler_recv, data) ({ \
+    SBUS_CHECK_SEND((handler_send), (data), const char **, const char **); \
+    SBUS_CHECK_RECV((handler_recv), hash_table_t ***); \
+    sbus_method_async("GetAttrs", \
+        &_sbus_ifp_args_org_freedesktop_sssd_infopipe_Users_GetAttrs, \
+        NULL, \
+        _sbus_ifp_invoke_in_aoas_out_ifp_attrs_list_send, \
+        NULL, \
+        (handler_send), (handler_recv), (data)); \
+})
+
 /* Method: org.freedesktop.sssd.infopipe.Users.ListByCertificate */
 #define SBUS_METHOD_SYNC_org_freedesktop_sssd_infopipe_Users_ListByCertificate(handler, data) ({ \
     SBUS_CHECK_SYNC((handler), (data), const char *, uint32_t, const char ***); \
@@ -47,8 +47,12 @@ _sbus_ifp_declare_invoker(, ifp_extra);
 _sbus_ifp_declare_invoker(, o);
 _sbus_ifp_declare_invoker(, s);
 _sbus_ifp_declare_invoker(, u);
+_sbus_ifp_declare_invoker(aoas, ifp_attrs_list);
+_sbus_ifp_declare_invoker(as, ao);
+_sbus_ifp_declare_invoker(au, ao);
 _sbus_ifp_declare_invoker(s, ao);
 _sbus_ifp_declare_invoker(s, as);
+_sbus_ifp_declare_invoker(s, asau);
 _sbus_ifp_declare_invoker(s, o);
 _sbus_ifp_declare_invoker(s, s);
 _sbus_ifp_declare_invoker(sas, raw);
@@ -216,6 +216,19 @@ _sbus_ifp_args_org_freedesktop_sssd_infopipe_Domains_Domain_IsOnline = {
     }
 };
 
+const struct sbus_method_arguments
+_sbus_ifp_args_org_freedesktop_sssd_infopipe_Domains_Domain_ListServerLatencies = {
+    .input = (const struct sbus_argument[]){
+        {.type = "s", .name = "service_name"},
+        {NULL}
+    },
+    .output = (const struct sbus_argument[]){
+        {.type = "as", .name = "servers"},
+        {.type = "au", .name = "rtt_usec"},
+        {NULL}
+    }
+};
+
 const struct sbus_method_arguments
 _sbus_ifp_args_org_freedesktop_sssd_infopipe_Domains_Domain_ListServers = {
     .input = (const struct sbus_argument[]){
@@ -261,6 +274,18 @@ _sbus_ifp_args_org_freedesktop_sssd_infopipe_Groups_FindByID = {
     }
 };
 
+const struct sbus_method_arguments
+_sbus_ifp_args_org_freedesktop_sssd_infopipe_Groups_FindByIDList = {
+    .input = (const struct sbus_argument[]){
+        {.type = "au", .name = "ids"},
+        {NULL}
+    },
+    .output = (const struct sbus_argument[]){
+        {.type = "ao", .name = "result"},
+        {NULL}
+    }
+};
+
 const struct sbus_method_arguments
 _sbus_ifp_args_org_freedesktop_sssd_infopipe_Groups_FindByName = {
     .input = (const struct sbus_argument[]){
@@ -273,6 +298,31 @@ _sbus_ifp_args_org_freedesktop_sssd_infopipe_Groups_FindByName = {
     }
 };
 
+const struct sbus_method_arguments
+_sbus_ifp_args_org_freedesktop_sssd_infopipe_Groups_FindByNameList = {
+    .input = (const struct sbus_argument[]){
+        {.type = "as", .name = "names"},
+        {NULL}
+    },
+    .output = (const struct sbus_argument[]){
+        {.type = "ao", .name = "result"},
+        {NULL}
+    }
+};
+
+const struct sbus_method_arguments
+_sbus_ifp_args_org_freedesktop_sssd_infopipe_Groups_GetAttrs = {
+    .input = (const struct sbus_argument[]){
+        {.type = "ao", .name = "objects"},
+        {.type = "as", .name = "attrs"},
+        {NULL}
+    },
+    .output = (const struct sbus_argument[]){
+        {.type = "aa{sas}", .name = "result"},
+        {NULL}
+    }
+};
+
 const struct sbus_method_arguments
 _sbus_ifp_args_org_freedesktop_sssd_infopipe_Groups_ListByDomainAndName = {
     .input = (const struct sbus_argument[]){
@@ -334,6 +384,18 @@ _sbus_ifp_args_org_freedesktop_sssd_infopipe_Users_FindByID = {
     }
 };
 
+const struct sbus_method_arguments
+_sbus_ifp_args_org_freedesktop_sssd_infopipe_Users_FindByIDList = {
+    .input = (const struct sbus_argument[]){
+        {.type = "au", .name = "ids"},
+        {NULL}
+    },
+    .output = (const struct sbus_argument[]){
+        {.type = "ao", .name = "result"},
+        {NULL}
+    }
+};
+
 const struct sbus_method_arguments
 _sbus_ifp_args_org_freedesktop_sssd_infopipe_Users_FindByName = {
     .input = (const struct sbus_argument[]){
@@ -359,6 +421,31 @@ _sbus_ifp_args_org_freedesktop_sssd_infopipe_Users_FindByNameAndCertificate = {
     }
 };
 
+const struct sbus_method_arguments
+_sbus_ifp_args_org_freedesktop_sssd_infopipe_Users_FindByNameList = {
+    .input = (const struct sbus_argument[]){
+        {.type = "as", .name = "names"},
+        {NULL}
+    },
+    .output = (const struct sbus_argument[]){
+        {.type = "ao", .name = "result"},
+        {NULL}
+    }
+};
+
+const struct sbus_method_arguments
+_sbus_ifp_args_org_freedesktop_sssd_infopipe_Users_GetAttrs = {
+    .input = (const struct sbus_argument[]){
+        {.type = "ao", .name = "objects"},
+        {.type = "as", .name = "attrs"},
+        {NULL}
+    },
+    .output = (const struct sbus_argument[]){
+        {.type = "aa{sas}", .name = "result"},
+        {NULL}
+    }
+};
+
 const struct sbus_method_arguments
 _sbus_ifp_args_org_freedesktop_sssd_infopipe_Users_ListByCertificate = {
     .input = (const struct sbus_argument[]){
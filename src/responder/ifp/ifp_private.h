@@ -33,6 +33,7 @@
 #include "confdb/confdb.h"
 #include "responder/common/responder.h"
 #include "responder/common/negcache.h"
+#include "responder/common/cache_req/cache_req.h"
 #include "responder/ifp/ifp_iface/ifp_iface_async.h"
 
 struct ifp_ctx {
@@ -132,4 +133,39 @@ errno_t ifp_ldb_el_output_name(struct resp_ctx *rctx,
 char *ifp_format_name_attr(TALLOC_CTX *mem_ctx, struct ifp_ctx *ifp_ctx,
                            const char *in_name, struct sss_domain_info *dom);
 
+/* Used for batch calls */
+typedef char *(*ifp_build_path_fn)(TALLOC_CTX *mem_ctx,
+                                   struct sss_domain_info *domain,
+                                   struct ldb_message *msg);
+
+/* Look up many objects of the same cache_req type at once, either by
+ * @names (NULL-terminated) or by @ids (talloc array). The result contains
+ * the object paths of the objects that were found, in the order they were
+ * requested. Missing objects are left out rather than marked, an object
+ * path cannot be empty. Objects that fail to be looked up are logged and
+ * skipped; the first such error is returned only if no object was found
+ * at all. */
+struct tevent_req *
+ifp_find_list_send(TALLOC_CTX *mem_ctx,
+                   struct tevent_context *ev,
+                   struct ifp_ctx *ctx,
+                   enum cache_req_type type,
+                   enum cache_req_dom_type req_dom_type,
+                   const char **names,
+                   uint32_t *ids,
+                   ifp_build_path_fn build_path);
+
+errno_t
+ifp_find_list_recv(TALLOC_CTX *mem_ctx,
+                   struct tevent_req *req,
+                   const char ***_paths);
+
+errno_t ifp_attrs_add_string(hash_table_t *table,
+                             const char *attr,
+                             const char *value);
+
+errno_t ifp_attrs_add_el(hash_table_t *table,
+                         const char *attr,
+                         struct ldb_message_element *el);
+
 #endif /* _IFPSRV_PRIVATE_H_ */
@@ -298,6 +298,46 @@ ifp_users_find_by_id_recv(TALLOC_CTX *mem_ctx,
     return EOK;
 }
 
+struct tevent_req *
+ifp_users_find_by_name_list_send(TALLOC_CTX *mem_ctx,
+                                 struct tevent_context *ev,
+                                 struct sbus_request *sbus_req,
+                                 struct ifp_ctx *ctx,
+                                 const char **names)
+{
+    return ifp_find_list_send(mem_ctx, ev, ctx, CACHE_REQ_USER_BY_NAME,
+                              CACHE_REQ_ANY_DOM, names, NULL,
+                              ifp_users_build_path_from_msg);
+}
+
+errno_t
+ifp_users_find_by_name_list_recv(TALLOC_CTX *mem_ctx,
+                                 struct tevent_req *req,
+                                 const char ***_paths)
+{
+    return ifp_find_list_recv(mem_ctx, req, _paths);
+}
+
+struct tevent_req *
+ifp_users_find_by_id_list_send(TALLOC_CTX *mem_ctx,
+                               struct tevent_context *ev,
+                               struct sbus_request *sbus_req,
+                               struct ifp_ctx *ctx,
+                               uint32_t *ids)
+{
+    return ifp_find_list_send(mem_ctx, ev, ctx, CACHE_REQ_USER_BY_ID,
+                              CACHE_REQ_POSIX_DOM, NULL, ids,
+                              ifp_users_build_path_from_msg);
+}
+
+errno_t
+ifp_users_find_by_id_list_recv(TALLOC_CTX *mem_ctx,
+                               struct tevent_req *req,
+                               const char ***_paths)
+{
+    return ifp_find_list_recv(mem_ctx, req, _paths);
+}
+
 struct ifp_users_find_by_cert_state {
     const char *path;
 };
@@ -1627,6 +1667,190 @@ done:
     return ret;
 }
 
+static errno_t
+ifp_users_get_attrs_of(TALLOC_CTX *mem_ctx,
+                       struct ifp_ctx *ifp_ctx,
+                       const char *path,
+                       const char **attrs,
+                       hash_table_t **_table)
+{
+    /* Attributes that are read from the view-aware passwd entry. */
+    static const char *pw_attrs[] = {SYSDB_UIDNUM, SYSDB_GIDNUM,
+                                     SYSDB_GECOS, SYSDB_HOMEDIR,
+                                     SYSDB_SHELL, SYSDB_UUID, NULL};
+    TALLOC_CTX *tmp_ctx;
+    struct sss_domain_info *domain;
+    struct ldb_message *extra_msg = NULL;
+    struct ldb_message_element *el;
+    struct ldb_message *msg;
+    hash_table_t *table;
+    const char **extra;
+    const char *name;
+    char *out_name;
+    size_t extra_num;
+    char *key;
+    errno_t ret;
+    int i;
+
+    tmp_ctx = talloc_new(NULL);
+    if (tmp_ctx == NULL) {
+        return ENOMEM;
+    }
+
+    ret = sss_hash_create(tmp_ctx, 10, &table);
+    if (ret != EOK) {
+        DEBUG(SSSDBG_CRIT_FAILURE, "Unable to create hash table!\n");
+        goto done;
+    }
+
+    /* A user that does not exist gets an empty dictionary. */
+    ret = ifp_users_decompose_path(tmp_ctx, ifp_ctx->rctx->domains, path,
+                                   &domain, &key);
+    if (ret != EOK) {
+        DEBUG(SSSDBG_MINOR_FAILURE, "Unable to decompose object path "
+              "[%s] [%d]: %s\n", path, ret, sss_strerror(ret));
+        ret = EOK;
+        goto found;
+    }
+
+    ret = ifp_users_get_from_cache(tmp_ctx, domain, key, &msg);
+    if (ret == ENOENT) {
+        DEBUG(SSSDBG_TRACE_FUNC, "User [%s] is not cached\n", path);
+        ret = EOK;
+        goto found;
+    } else if (ret != EOK) {
+        goto done;
+    }
+
+    name = ldb_msg_find_attr_as_string(msg, SYSDB_NAME, NULL);
+    if (name == NULL) {
+        DEBUG(SSSDBG_CRIT_FAILURE, "A user with no name\n");
+        ret = ERR_INTERNAL;
+        goto done;
+    }
+
+    /* Anything else is an extra attribute that needs another search. */
+    for (i = 0; attrs[i] != NULL; i++) {
+        /* Just count the attributes. */
+    }
+
+    extra = talloc_zero_array(tmp_ctx, const char *, i + 1);
+    if (extra == NULL) {
+        ret = ENOMEM;
+        goto done;
+    }
+
+    extra_num = 0;
+    for (i = 0; attrs[i] != NULL; i++) {
+        if (strcmp(attrs[i], SYSDB_NAME) != 0
+                && strcmp(attrs[i], "domainname") != 0
+                && !string_in_list(attrs[i], discard_const(pw_attrs), true)
+                && ifp_is_user_attr_allowed(ifp_ctx, attrs[i])) {
+            extra[extra_num] = attrs[i];
+            extra_num++;
+        }
+    }
+
+    if (extra_num > 0) {
+        ret = sysdb_search_user_by_name(tmp_ctx, domain, name, extra,
+                                        &extra_msg);
+        if (ret != EOK) {
+            DEBUG(SSSDBG_OP_FAILURE, "Unable to lookup user [%d]: %s\n",
+                  ret, sss_strerror(ret));
+            goto done;
+        }
+    }
+
+    for (i = 0; attrs[i] != NULL; i++) {
+        if (!ifp_is_user_attr_allowed(ifp_ctx, attrs[i])) {
+            DEBUG(SSSDBG_TRACE_ALL, "Attribute %s is not allowed\n",
+                  attrs[i]);
+            continue;
+        }
+
+        if (strcmp(attrs[i], SYSDB_NAME) == 0) {
+            name = sss_view_ldb_msg_find_attr_as_string(domain, msg,
+                                                        SYSDB_NAME, NULL);
+            out_name = ifp_format_name_attr(tmp_ctx, ifp_ctx, name, domain);
+            if (out_name == NULL) {
+                ret = ENOMEM;
+                goto done;
+            }
+
+            ret = ifp_attrs_add_string(table, attrs[i], out_name);
+        } else if (strcmp(attrs[i], "domainname") == 0) {
+            ret = ifp_attrs_add_string(table, attrs[i], domain->name);
+        } else {
+            if (string_in_list(attrs[i], discard_const(pw_attrs), true)) {
+                el = sss_view_ldb_msg_find_element(domain, msg, attrs[i]);
+            } else {
+                el = ldb_msg_find_element(extra_msg, attrs[i]);
+            }
+
+            if (el == NULL || el->num_values == 0) {
+                DEBUG(SSSDBG_TRACE_ALL, "Attribute %s not found, "
+                      "skipping...\n", attrs[i]);
+                continue;
+            }
+
+            ret = ifp_attrs_add_el(table, attrs[i], el);
+        }
+
+        if (ret != EOK) {
+            goto done;
+        }
+    }
+
+found:
+    *_table = talloc_steal(mem_ctx, table);
+    ret = EOK;
+
+done:
+    talloc_free(tmp_ctx);
+    return ret;
+}
+
+errno_t
+ifp_users_get_attrs(TALLOC_CTX *mem_ctx,
+                    struct sbus_request *sbus_req,
+                    struct ifp_ctx *ifp_ctx,
+                    const char **paths,
+                    const char **attrs,
+                    hash_table_t ***_out)
+{
+    static const char *no_attrs[] = {NULL};
+    hash_table_t **tables;
+    size_t count;
+    errno_t ret;
+    size_t i;
+
+    if (attrs == NULL) {
+        attrs = no_attrs;
+    }
+
+    for (count = 0; paths != NULL && paths[count] != NULL; count++) {
+        /* Just count the objects. */
+    }
+
+    tables = talloc_zero_array(mem_ctx, hash_table_t *, count + 1);
+    if (tables == NULL) {
+        return ENOMEM;
+    }
+
+    for (i = 0; i < count; i++) {
+        ret = ifp_users_get_attrs_of(tables, ifp_ctx, paths[i], attrs,
+                                     &tables[i]);
+        if (ret != EOK) {
+            talloc_free(tables);
+            return ret;
+        }
+    }
+
+    *_out = tables;
+
+    return EOK;
+}
+
 errno_t
 ifp_cache_list_user(TALLOC_CTX *mem_ctx,
                     struct sbus_request *sbus_req,
@@ -451,3 +451,304 @@ done:
     talloc_free(tmp_ctx);
     return ret_name;
 }
+
+/* Number of cache requests of a batch call that run at the same time. */
+#define IFP_FIND_LIST_PARALLEL 50
+
+struct ifp_find_list_state {
+    struct tevent_context *ev;
+    struct ifp_ctx *ctx;
+    enum cache_req_type type;
+    enum cache_req_dom_type req_dom_type;
+    const char **names;
+    uint32_t *ids;
+    ifp_build_path_fn build_path;
+
+    size_t count;
+    size_t next;
+    size_t active;
+
+    /* One slot per requested object, NULL if it was not found. */
+    const char **paths;
+    size_t found;
+
+    /* The first lookup error, returned only if nothing was found. */
+    errno_t error;
+};
+
+struct ifp_find_list_item {
+    struct tevent_req *req;
+    size_t index;
+};
+
+static errno_t ifp_find_list_step(struct tevent_req *req);
+static void ifp_find_list_done(struct tevent_req *subreq);
+
+struct tevent_req *
+ifp_find_list_send(TALLOC_CTX *mem_ctx,
+                   struct tevent_context *ev,
+                   struct ifp_ctx *ctx,
+                   enum cache_req_type type,
+                   enum cache_req_dom_type req_dom_type,
+                   const char **names,
+                   uint32_t *ids,
+                   ifp_build_path_fn build_path)
+{
+    struct ifp_find_list_state *state;
+    struct tevent_req *req;
+    errno_t ret;
+
+    req = tevent_req_create(mem_ctx, &state, struct ifp_find_list_state);
+    if (req == NULL) {
+        DEBUG(SSSDBG_CRIT_FAILURE, "Unable to create tevent request!\n");
+        return NULL;
+    }
+
+    state->ev = ev;
+    state->ctx = ctx;
+    state->type = type;
+    state->req_dom_type = req_dom_type;
+    state->names = names;
+    state->ids = ids;
+    state->build_path = build_path;
+
+    if (names != NULL) {
+        for (state->count = 0; names[state->count] != NULL; state->count++) {
+            /* Just count the names. */
+        }
+    } else {
+        state->count = talloc_array_length(ids);
+    }
+
+    state->paths = talloc_zero_array(state, const char *, state->count + 1);
+    if (state->paths == NULL) {
+        ret = ENOMEM;
+        goto done;
+    }
+
+    if (state->count == 0) {
+        ret = EOK;
+        goto done;
+    }
+
+    DEBUG(SSSDBG_TRACE_FUNC, "Looking up %zu objects\n", state->count);
+
+    ret = ifp_find_list_step(req);
+    if (ret == EOK) {
+        ret = EAGAIN;
+    }
+
+done:
+    if (ret == EOK) {
+        tevent_req_done(req);
+        tevent_req_post(req, ev);
+    } else if (ret != EAGAIN) {
+        tevent_req_error(req, ret);
+        tevent_req_post(req, ev);
+    }
+
+    return req;
+}
+
+static errno_t ifp_find_list_step(struct tevent_req *req)
+{
+    struct ifp_find_list_state *state;
+    struct ifp_find_list_item *item;
+    struct cache_req_data *data;
+    struct tevent_req *subreq;
+
+    state = tevent_req_data(req, struct ifp_find_list_state);
+
+    while (state->active < IFP_FIND_LIST_PARALLEL
+            && state->next < state->count) {
+        item = talloc_zero(state, struct ifp_find_list_item);
+        if (item == NULL) {
+            return ENOMEM;
+        }
+
+        item->req = req;
+        item->index = state->next;
+
+        if (state->names != NULL) {
+            data = cache_req_data_name(item, state->type,
+                                       state->names[item->index]);
+        } else {
+            data = cache_req_data_id(item, state->type,
+                                     state->ids[item->index]);
+        }
+        if (data == NULL) {
+            talloc_free(item);
+            return ENOMEM;
+        }
+
+        subreq = cache_req_send(item, state->ev, state->ctx->rctx,
+                                state->ctx->rctx->ncache, 0,
+                                state->req_dom_type, NULL, data);
+        if (subreq == NULL) {
+            DEBUG(SSSDBG_CRIT_FAILURE, "Unable to create subrequest!\n");
+            talloc_free(item);
+            return ENOMEM;
+        }
+
+        tevent_req_set_callback(subreq, ifp_find_list_done, item);
+
+        state->next++;
+        state->active++;
+    }
+
+    return EOK;
+}
+
+static void ifp_find_list_done(struct tevent_req *subreq)
+{
+    struct ifp_find_list_state *state;
+    struct ifp_find_list_item *item;
+    struct cache_req_result *result;
+    struct tevent_req *req;
+    errno_t ret;
+
+    item = tevent_req_callback_data(subreq, struct ifp_find_list_item);
+    req = item->req;
+    state = tevent_req_data(req, struct ifp_find_list_state);
+
+    ret = cache_req_single_domain_recv(item, subreq, &result);
+    if (ret == EOK) {
+        state->paths[item->index] = state->build_path(state->paths,
+                                                      result->domain,
+                                                      result->msgs[0]);
+        if (state->paths[item->index] == NULL) {
+            ret = ENOMEM;
+        } else {
+            state->found++;
+        }
+    } else if (ret == ENOENT || ret == ERR_DOMAIN_NOT_FOUND) {
+        DEBUG(SSSDBG_TRACE_FUNC, "Object %zu was not found, skipping\n",
+              item->index);
+        ret = EOK;
+    } else if (ret != ENOMEM) {
+        /* A single broken object must not fail the whole list. */
+        if (state->names != NULL) {
+            DEBUG(SSSDBG_OP_FAILURE, "Unable to find object [%s], "
+                  "skipping [%d]: %s\n", state->names[item->index],
+                  ret, sss_strerror(ret));
+        } else {
+            DEBUG(SSSDBG_OP_FAILURE, "Unable to find object [%"PRIu32"], "
+                  "skipping [%d]: %s\n", state->ids[item->index],
+                  ret, sss_strerror(ret));
+        }
+
+        if (state->error == EOK) {
+            state->error = ret;
+        }
+        ret = EOK;
+    }
+
+    /* This frees subreq as well. */
+    talloc_free(item);
+    state->active--;
+
+    if (ret != EOK) {
+        tevent_req_error(req, ret);
+        return;
+    }
+
+    ret = ifp_find_list_step(req);
+    if (ret != EOK) {
+        tevent_req_error(req, ret);
+        return;
+    }
+
+    if (state->active == 0) {
+        tevent_req_done(req);
+    }
+}
+
+errno_t
+ifp_find_list_recv(TALLOC_CTX *mem_ctx,
+                   struct tevent_req *req,
+                   const char ***_paths)
+{
+    struct ifp_find_list_state *state;
+    size_t found;
+    size_t i;
+
+    state = tevent_req_data(req, struct ifp_find_list_state);
+
+    TEVENT_REQ_RETURN_ON_ERROR(req);
+
+    if (state->found == 0 && state->error != EOK) {
+        return state->error;
+    }
+
+    /* Leave out the objects that were not found. */
+    for (i = 0, found = 0; i < state->count; i++) {
+        if (state->paths[i] != NULL) {
+            state->paths[found] = state->paths[i];
+            found++;
+        }
+    }
+    state->paths[found] = NULL;
+
+    *_paths = talloc_steal(mem_ctx, state->paths);
+
+    return EOK;
+}
+
+static errno_t ifp_attrs_add(hash_table_t *table,
+                             const char *attr,
+                             const char **values)
+{
+    hash_key_t key;
+    hash_value_t value;
+    int hret;
+
+    key.type = HASH_KEY_STRING;
+    key.str = discard_const(attr);
+
+    value.type = HASH_VALUE_PTR;
+    value.ptr = values;
+
+    hret = hash_enter(table, &key, &value);
+    if (hret != HASH_SUCCESS) {
+        DEBUG(SSSDBG_CRIT_FAILURE, "Unable to insert entry "
+              "into hash table: %d\n", hret);
+        return EIO;
+    }
+
+    return EOK;
+}
+
+errno_t ifp_attrs_add_string(hash_table_t *table,
+                             const char *attr,
+                             const char *value)
+{
+    const char **values;
+
+    values = talloc_zero_array(table, const char *, 2);
+    if (values == NULL) {
+        return ENOMEM;
+    }
+
+    values[0] = talloc_strdup(values, value);
+    if (values[0] == NULL) {
+        talloc_free(values);
+        return ENOMEM;
+    }
+
+    return ifp_attrs_add(table, attr, values);
+}
+
+errno_t ifp_attrs_add_el(hash_table_t *table,
+                         const char *attr,
+                         struct ldb_message_element *el)
+{
+    const char **values;
+
+    values = sss_ldb_el_to_string_list(table, el);
+    if (values == NULL) {
+        DEBUG(SSSDBG_CRIT_FAILURE, "sss_ldb_el_to_string_list() failed\n");
+        return ENOMEM;
+    }
+
+    return ifp_attrs_add(table, attr, values);
+}
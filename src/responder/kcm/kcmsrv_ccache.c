@@ -94,6 +94,63 @@ done:
     return ret;
 }
 
+struct kcm_ccache *kcm_cc_copy(TALLOC_CTX *mem_ctx,
+                               const struct kcm_ccache *cc)
+{
+    struct kcm_ccache *out;
+    struct kcm_cred *crd;
+    struct kcm_cred *crd_copy;
+    struct sss_iobuf *blob;
+    krb5_error_code kret;
+
+    out = talloc_zero(mem_ctx, struct kcm_ccache);
+    if (out == NULL) {
+        return NULL;
+    }
+    talloc_set_destructor(out, kcm_cc_destructor);
+
+    out->name = talloc_strdup(out, cc->name);
+    if (out->name == NULL) {
+        goto fail;
+    }
+
+    out->owner = cc->owner;
+    uuid_copy(out->uuid, cc->uuid);
+    out->kdc_offset = cc->kdc_offset;
+
+    if (cc->client != NULL) {
+        kret = krb5_copy_principal(NULL, cc->client, &out->client);
+        if (kret != 0) {
+            DEBUG(SSSDBG_OP_FAILURE,
+                  "krb5_copy_principal failed: %d\n", kret);
+            goto fail;
+        }
+    }
+
+    /* keep the order of the credentials */
+    DLIST_FOR_EACH(crd, cc->creds) {
+        blob = sss_iobuf_init_readonly(out,
+                                       sss_iobuf_get_data(crd->cred_blob),
+                                       sss_iobuf_get_size(crd->cred_blob));
+        if (blob == NULL) {
+            goto fail;
+        }
+
+        crd_copy = kcm_cred_new(out, crd->uuid, blob);
+        if (crd_copy == NULL) {
+            goto fail;
+        }
+
+        DLIST_ADD_END(out->creds, crd_copy, struct kcm_cred *);
+    }
+
+    return out;
+
+fail:
+    talloc_free(out);
+    return NULL;
+}
+
 const char *kcm_cc_get_name(struct kcm_ccache *cc)
 {
     return cc ? cc->name : NULL;
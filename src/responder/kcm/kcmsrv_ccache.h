@@ -72,6 +72,13 @@ errno_t kcm_cc_new(TALLOC_CTX *mem_ctx,
                    krb5_principal princ,
                    struct kcm_ccache **_cc);
 
+/*
+ * Create a deep copy of a ccache including all its credentials, the copy
+ * does not share any memory with the original
+ */
+struct kcm_ccache *kcm_cc_copy(TALLOC_CTX *mem_ctx,
+                               const struct kcm_ccache *cc);
+
 /*
  * Returns true if a client can access a ccache.
  *
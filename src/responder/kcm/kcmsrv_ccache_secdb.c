@@ -35,6 +35,10 @@
 #define KCM_SECDB_CCACHE_FMT  KCM_SECDB_BASE_FMT"ccache/"
 #define KCM_SECDB_DFL_FMT     KCM_SECDB_BASE_FMT"default"
 
+#define KCM_SECDB_DEFAULT_FLUSH_INTERVAL 5
+/* Maximum number of UIDs whose ccaches are kept in memory */
+#define KCM_SECDB_MAX_CACHED_UIDS 256
+
 static errno_t sec_get_b64(TALLOC_CTX *mem_ctx,
                            struct sss_sec_req *req,
                            struct sss_iobuf **_buf)
@@ -222,8 +226,43 @@ done:
     return ret;
 }
 
+/* A ccache of a cached UID. The ccache is parsed from the database on first
+ * use and served from memory afterwards. If the ccache was modified, payload
+ * holds its serialized form until it is written back to the database, it is
+ * kept until a write succeeds. */
+struct ccdb_secdb_cc {
+    struct ccdb_secdb_cc *prev;
+    struct ccdb_secdb_cc *next;
+
+    char *key;
+    struct kcm_ccache *cc;
+    struct sss_iobuf *payload;
+};
+
+/* The ccaches of one UID. The list of keys is read from the database once,
+ * creating and deleting a ccache is written through so the list stays in
+ * sync with the database. */
+struct ccdb_secdb_uid {
+    struct ccdb_secdb_uid *prev;
+    struct ccdb_secdb_uid *next;
+
+    uid_t uid;
+    struct ccdb_secdb_cc *ccs;
+};
+
 struct ccdb_secdb {
     struct sss_sec_ctx *sctx;
+    struct tevent_context *ev;
+
+    /* Most recently used first */
+    struct ccdb_secdb_uid *uids;
+    unsigned int num_uids;
+
+    /* Modified ccaches are written back after flush_interval seconds,
+     * 0 writes them immediately */
+    uint32_t flush_interval;
+    struct tevent_timer *flush_timer;
+    int max_payload_size;
 };
 
 /* Since with the synchronous database, the database operations are just
@@ -365,158 +404,409 @@ done:
     return ret;
 }
 
-static errno_t key_by_uuid(TALLOC_CTX *mem_ctx,
-                           struct sss_sec_ctx *sctx,
-                           struct cli_creds *client,
-                           uuid_t uuid,
-                           char **_key)
+static errno_t secdb_get_cc(TALLOC_CTX *mem_ctx,
+                            struct sss_sec_ctx *sctx,
+                            const char *secdb_key,
+                            struct cli_creds *client,
+                            struct kcm_ccache **_cc)
 {
-    TALLOC_CTX *tmp_ctx;
     errno_t ret;
-    char *key_match = NULL;
-    char **keys = NULL;
-    size_t nkeys;
+    TALLOC_CTX *tmp_ctx = NULL;
+    struct kcm_ccache *cc = NULL;
     struct sss_sec_req *sreq = NULL;
+    struct sss_iobuf *ccbuf;
 
     tmp_ctx = talloc_new(mem_ctx);
     if (tmp_ctx == NULL) {
         return ENOMEM;
     }
 
-    ret = secdb_container_url_req(tmp_ctx, sctx, client, &sreq);
+    ret = secdb_cc_key_req(tmp_ctx, sctx, client, secdb_key, &sreq);
     if (ret != EOK) {
+        DEBUG(SSSDBG_OP_FAILURE,
+              "Cannot create secdb request [%d][%s]\n", ret, sss_strerror(ret));
         goto done;
     }
 
-    ret = sss_sec_list(tmp_ctx, sreq, &keys, &nkeys);
-    if (ret == ENOENT) {
-        DEBUG(SSSDBG_MINOR_FAILURE, "The container was not found\n");
+    ret = sec_get_b64(tmp_ctx, sreq, &ccbuf);
+    if (ret != EOK) {
+        DEBUG(SSSDBG_OP_FAILURE,
+              "Cannot get the secret [%d][%s]\n", ret, sss_strerror(ret));
         goto done;
-    } else if (ret != EOK) {
+    }
+
+    ret = sec_kv_to_ccache(tmp_ctx,
+                           secdb_key,
+                           (const char *) sss_iobuf_get_data(ccbuf),
+                           client,
+                           &cc);
+    if (ret != EOK) {
+        DEBUG(SSSDBG_OP_FAILURE,
+              "Cannot convert JSON keyval to ccache blob [%d]: %s\n",
+              ret, sss_strerror(ret));
         goto done;
     }
 
-    for (size_t i = 0; i < nkeys; i++) {
-        if (sec_key_match_uuid(keys[i], uuid)) {
-            key_match = keys[i];
-            break;
-        }
+    ret = EOK;
+    DEBUG(SSSDBG_TRACE_INTERNAL, "Fetched the ccache\n");
+    *_cc = talloc_steal(mem_ctx, cc);
+done:
+    talloc_free(tmp_ctx);
+    return ret;
+}
+
+static errno_t secdb_cc_flush(struct ccdb_secdb *secdb,
+                              struct ccdb_secdb_uid *uid_cache,
+                              struct ccdb_secdb_cc *ccwrap)
+{
+    TALLOC_CTX *tmp_ctx;
+    struct sss_sec_req *sreq;
+    const char *url;
+    errno_t ret;
+
+    if (ccwrap->payload == NULL) {
+        return EOK;
+    }
+
+    tmp_ctx = talloc_new(NULL);
+    if (tmp_ctx == NULL) {
+        return ENOMEM;
+    }
+
+    url = talloc_asprintf(tmp_ctx, KCM_SECDB_CCACHE_FMT"%s",
+                          uid_cache->uid, ccwrap->key);
+    if (url == NULL) {
+        ret = ENOMEM;
+        goto done;
     }
 
-    if (key_match == NULL) {
-        DEBUG(SSSDBG_TRACE_INTERNAL, "No key matched\n");
-        ret = ENOENT;
+    ret = sss_sec_new_req(tmp_ctx, secdb->sctx, url, geteuid(), &sreq);
+    if (ret != EOK) {
+        goto done;
+    }
+
+    ret = sec_update_b64(tmp_ctx, sreq, ccwrap->payload);
+    if (ret != EOK) {
         goto done;
     }
 
+    DEBUG(SSSDBG_TRACE_INTERNAL, "Wrote back %s\n", url);
+    talloc_zfree(ccwrap->payload);
     ret = EOK;
-    DEBUG(SSSDBG_TRACE_INTERNAL, "Found key %s\n", key_match);
-    *_key = talloc_steal(mem_ctx, key_match);
+
 done:
+    if (ret != EOK) {
+        DEBUG(SSSDBG_OP_FAILURE,
+              "Cannot write back ccache %s, keeping it modified [%d]: %s\n",
+              ccwrap->key, ret, sss_strerror(ret));
+    }
     talloc_free(tmp_ctx);
     return ret;
 }
 
-static errno_t key_by_name(TALLOC_CTX *mem_ctx,
-                           struct sss_sec_ctx *sctx,
-                           struct cli_creds *client,
-                           const char *name,
-                           char **_key)
+/* Returns an error if any of the modified ccaches could not be written */
+static errno_t secdb_flush_all(struct ccdb_secdb *secdb)
 {
-    TALLOC_CTX *tmp_ctx;
+    struct ccdb_secdb_uid *uid_cache;
+    struct ccdb_secdb_cc *ccwrap;
+    errno_t ret = EOK;
+    errno_t cret;
+
+    talloc_zfree(secdb->flush_timer);
+
+    DLIST_FOR_EACH(uid_cache, secdb->uids) {
+        DLIST_FOR_EACH(ccwrap, uid_cache->ccs) {
+            cret = secdb_cc_flush(secdb, uid_cache, ccwrap);
+            if (cret != EOK) {
+                ret = cret;
+            }
+        }
+    }
+
+    return ret;
+}
+
+static void secdb_flush_timer(struct tevent_context *ev,
+                              struct tevent_timer *te,
+                              struct timeval tv,
+                              void *pvt);
+
+static errno_t secdb_schedule_flush(struct ccdb_secdb *secdb)
+{
+    if (secdb->flush_timer != NULL) {
+        return EOK;
+    }
+
+    secdb->flush_timer = tevent_add_timer(secdb->ev, secdb,
+                                          tevent_timeval_current_ofs(
+                                                secdb->flush_interval, 0),
+                                          secdb_flush_timer, secdb);
+    if (secdb->flush_timer == NULL) {
+        return ENOMEM;
+    }
+
+    return EOK;
+}
+
+static void secdb_flush_timer(struct tevent_context *ev,
+                              struct tevent_timer *te,
+                              struct timeval tv,
+                              void *pvt)
+{
+    struct ccdb_secdb *secdb = talloc_get_type(pvt, struct ccdb_secdb);
+    errno_t ret;
+
+    secdb->flush_timer = NULL;
+    ret = secdb_flush_all(secdb);
+    if (ret == EOK) {
+        return;
+    }
+
+    /* The ccaches which could not be written are retried later */
+    ret = secdb_schedule_flush(secdb);
+    if (ret != EOK) {
+        DEBUG(SSSDBG_MINOR_FAILURE, "Cannot schedule write back, the "
+              "modified ccaches are written on next change\n");
+    }
+}
+
+static int secdb_destructor(struct ccdb_secdb *secdb)
+{
+    DEBUG(SSSDBG_TRACE_FUNC, "Writing back modified ccaches\n");
+    secdb_flush_all(secdb);
+    return 0;
+}
+
+/* Writes back the UID's modified ccaches and forgets them. The UID stays
+ * cached if any of its ccaches could not be written. */
+static errno_t secdb_uid_drop(struct ccdb_secdb *secdb,
+                              struct ccdb_secdb_uid *uid_cache)
+{
+    struct ccdb_secdb_cc *ccwrap;
     errno_t ret;
-    char *key_match = NULL;
+
+    DLIST_FOR_EACH(ccwrap, uid_cache->ccs) {
+        ret = secdb_cc_flush(secdb, uid_cache, ccwrap);
+        if (ret != EOK) {
+            return ret;
+        }
+    }
+
+    DLIST_REMOVE(secdb->uids, uid_cache);
+    secdb->num_uids--;
+    talloc_free(uid_cache);
+    return EOK;
+}
+
+static struct ccdb_secdb_uid *secdb_uid_find(struct ccdb_secdb *secdb,
+                                             uid_t uid)
+{
+    struct ccdb_secdb_uid *uid_cache;
+
+    DLIST_FOR_EACH(uid_cache, secdb->uids) {
+        if (uid_cache->uid == uid) {
+            return uid_cache;
+        }
+    }
+
+    return NULL;
+}
+
+static errno_t secdb_uid_get(struct ccdb_secdb *secdb,
+                             struct cli_creds *client,
+                             struct ccdb_secdb_uid **_uid_cache)
+{
+    TALLOC_CTX *tmp_ctx;
+    struct ccdb_secdb_uid *uid_cache;
+    struct ccdb_secdb_uid *last;
+    struct ccdb_secdb_cc *ccwrap;
+    struct sss_sec_req *sreq;
     char **keys = NULL;
     size_t nkeys;
-    struct sss_sec_req *sreq = NULL;
+    errno_t ret;
 
-    tmp_ctx = talloc_new(mem_ctx);
+    uid_cache = secdb_uid_find(secdb, cli_creds_get_uid(client));
+    if (uid_cache != NULL) {
+        DLIST_PROMOTE(secdb->uids, uid_cache);
+        *_uid_cache = uid_cache;
+        return EOK;
+    }
+
+    tmp_ctx = talloc_new(NULL);
     if (tmp_ctx == NULL) {
         return ENOMEM;
     }
 
-    ret = secdb_container_url_req(tmp_ctx, sctx, client, &sreq);
+    ret = secdb_container_url_req(tmp_ctx, secdb->sctx, client, &sreq);
     if (ret != EOK) {
         goto done;
     }
 
     ret = sss_sec_list(tmp_ctx, sreq, &keys, &nkeys);
     if (ret == ENOENT) {
-        DEBUG(SSSDBG_MINOR_FAILURE, "The container was not found\n");
-        goto done;
+        nkeys = 0;
     } else if (ret != EOK) {
+        DEBUG(SSSDBG_OP_FAILURE,
+              "Cannot list keys [%d]: %s\n", ret, sss_strerror(ret));
+        goto done;
+    }
+
+    uid_cache = talloc_zero(tmp_ctx, struct ccdb_secdb_uid);
+    if (uid_cache == NULL) {
+        ret = ENOMEM;
         goto done;
     }
+    uid_cache->uid = cli_creds_get_uid(client);
 
     for (size_t i = 0; i < nkeys; i++) {
-        if (sec_key_match_name(keys[i], name)) {
-            key_match = keys[i];
-            break;
+        ccwrap = talloc_zero(uid_cache, struct ccdb_secdb_cc);
+        if (ccwrap == NULL) {
+            ret = ENOMEM;
+            goto done;
         }
+        ccwrap->key = talloc_steal(ccwrap, keys[i]);
+        DLIST_ADD_END(uid_cache->ccs, ccwrap, struct ccdb_secdb_cc *);
     }
 
-    if (key_match == NULL) {
-        DEBUG(SSSDBG_TRACE_INTERNAL, "No key matched\n");
-        ret = ENOENT;
-        goto done;
+    if (secdb->num_uids >= KCM_SECDB_MAX_CACHED_UIDS) {
+        last = secdb->uids;
+        while (last->next != NULL) {
+            last = last->next;
+        }
+        DEBUG(SSSDBG_TRACE_INTERNAL,
+              "Dropping cached ccaches of UID %"SPRIuid"\n", last->uid);
+        ret = secdb_uid_drop(secdb, last);
+        if (ret != EOK) {
+            DEBUG(SSSDBG_MINOR_FAILURE,
+                  "Keeping the modified ccaches of UID %"SPRIuid"\n",
+                  last->uid);
+        }
     }
 
+    DEBUG(SSSDBG_TRACE_INTERNAL, "Cached %zu ccache keys of UID %"SPRIuid"\n",
+          nkeys, uid_cache->uid);
+    DLIST_ADD(secdb->uids, uid_cache);
+    secdb->num_uids++;
+    *_uid_cache = talloc_steal(secdb, uid_cache);
     ret = EOK;
-    DEBUG(SSSDBG_TRACE_INTERNAL, "Found key %s\n", key_match);
-    *_key = talloc_steal(mem_ctx, key_match);
+
 done:
     talloc_free(tmp_ctx);
     return ret;
 }
 
-static errno_t secdb_get_cc(TALLOC_CTX *mem_ctx,
-                            struct sss_sec_ctx *sctx,
-                            const char *secdb_key,
+static struct ccdb_secdb_cc *secdb_cc_by_uuid(struct ccdb_secdb_uid *uid_cache,
+                                              uuid_t uuid)
+{
+    struct ccdb_secdb_cc *ccwrap;
+
+    DLIST_FOR_EACH(ccwrap, uid_cache->ccs) {
+        if (sec_key_match_uuid(ccwrap->key, uuid)) {
+            return ccwrap;
+        }
+    }
+
+    DEBUG(SSSDBG_TRACE_INTERNAL, "No key matched\n");
+    return NULL;
+}
+
+static struct ccdb_secdb_cc *secdb_cc_by_name(struct ccdb_secdb_uid *uid_cache,
+                                              const char *name)
+{
+    struct ccdb_secdb_cc *ccwrap;
+
+    DLIST_FOR_EACH(ccwrap, uid_cache->ccs) {
+        if (sec_key_match_name(ccwrap->key, name)) {
+            return ccwrap;
+        }
+    }
+
+    DEBUG(SSSDBG_TRACE_INTERNAL, "No key matched\n");
+    return NULL;
+}
+
+/* Returns a copy of the cached ccache owned by the caller, the ccache is
+ * read from the database first if needed. */
+static errno_t secdb_cc_get(TALLOC_CTX *mem_ctx,
+                            struct ccdb_secdb *secdb,
                             struct cli_creds *client,
+                            struct ccdb_secdb_cc *ccwrap,
                             struct kcm_ccache **_cc)
 {
+    struct kcm_ccache *cc;
     errno_t ret;
-    TALLOC_CTX *tmp_ctx = NULL;
-    struct kcm_ccache *cc = NULL;
-    struct sss_sec_req *sreq = NULL;
-    struct sss_iobuf *ccbuf;
 
-    tmp_ctx = talloc_new(mem_ctx);
-    if (tmp_ctx == NULL) {
+    if (ccwrap->cc == NULL) {
+        ret = secdb_get_cc(ccwrap, secdb->sctx, ccwrap->key, client,
+                           &ccwrap->cc);
+        if (ret != EOK) {
+            return ret;
+        }
+    }
+
+    cc = kcm_cc_copy(mem_ctx, ccwrap->cc);
+    if (cc == NULL) {
         return ENOMEM;
     }
 
-    ret = secdb_cc_key_req(tmp_ctx, sctx, client, secdb_key, &sreq);
+    /* as if it was just read from the database for this client */
+    cc->owner.uid = cli_creds_get_uid(client);
+    cc->owner.gid = cli_creds_get_gid(client);
+
+    *_cc = cc;
+    return EOK;
+}
+
+/* Replaces the cached ccache with a modified one and schedules writing it
+ * back. The payload size quota is checked right away so that the client
+ * learns about a ccache which is too big. */
+static errno_t secdb_cc_replace(struct ccdb_secdb *secdb,
+                                struct ccdb_secdb_uid *uid_cache,
+                                struct ccdb_secdb_cc *ccwrap,
+                                struct kcm_ccache *cc)
+{
+    struct sss_iobuf *payload;
+    size_t b64_size;
+    errno_t ret;
+
+    ret = kcm_ccache_to_sec_input(ccwrap, cc, NULL, &payload);
     if (ret != EOK) {
-        DEBUG(SSSDBG_OP_FAILURE,
-              "Cannot create secdb request [%d][%s]\n", ret, sss_strerror(ret));
-        goto done;
+        return ret;
     }
 
-    ret = sec_get_b64(tmp_ctx, sreq, &ccbuf);
-    if (ret != EOK) {
+    /* the payload is stored base64 encoded */
+    b64_size = (sss_iobuf_get_size(payload) + 2) / 3 * 4;
+    if (secdb->max_payload_size > 0
+            && b64_size > (size_t) secdb->max_payload_size * 1024) {
         DEBUG(SSSDBG_OP_FAILURE,
-              "Cannot get the secret [%d][%s]\n", ret, sss_strerror(ret));
-        goto done;
+              "Payload size [%zu] exceeds the maximum allowed payload "
+              "size [%d kb]\n", b64_size, secdb->max_payload_size);
+        talloc_free(payload);
+        return ERR_SEC_PAYLOAD_SIZE_IS_TOO_LARGE;
     }
 
-    ret = sec_kv_to_ccache(tmp_ctx,
-                           secdb_key,
-                           (const char *) sss_iobuf_get_data(ccbuf),
-                           client,
-                           &cc);
+    talloc_free(ccwrap->cc);
+    ccwrap->cc = talloc_steal(ccwrap, cc);
+    talloc_free(ccwrap->payload);
+    ccwrap->payload = payload;
+
+    if (secdb->flush_interval > 0) {
+        ret = secdb_schedule_flush(secdb);
+        if (ret == EOK) {
+            return EOK;
+        }
+        DEBUG(SSSDBG_MINOR_FAILURE,
+              "Cannot schedule write back, writing immediately\n");
+    }
+
+    ret = secdb_cc_flush(secdb, uid_cache, ccwrap);
     if (ret != EOK) {
-        DEBUG(SSSDBG_OP_FAILURE,
-              "Cannot convert JSON keyval to ccache blob [%d]: %s\n",
-              ret, sss_strerror(ret));
-        goto done;
+        /* Written through, so the client gets the error and the stored
+         * version is read again on next use */
+        talloc_zfree(ccwrap->payload);
+        talloc_zfree(ccwrap->cc);
     }
 
-    ret = EOK;
-    DEBUG(SSSDBG_TRACE_INTERNAL, "Fetched the ccache\n");
-    *_cc = talloc_steal(mem_ctx, cc);
-done:
-    talloc_free(tmp_ctx);
     return ret;
 }
 
@@ -526,6 +816,7 @@ static errno_t ccdb_secdb_init(struct kcm_ccdb *db,
 {
     struct ccdb_secdb *secdb = NULL;
     errno_t ret;
+    int flush_interval;
     struct sss_sec_hive_config **kcm_section_quota;
     struct sss_sec_quota_opt dfl_kcm_nest_level = {
         .opt_name = CONFDB_SEC_CONTAINERS_NEST_LEVEL,
@@ -591,15 +882,36 @@ static errno_t ccdb_secdb_init(struct kcm_ccdb *db,
         kcm_section_quota[0]->quota.max_uid_secrets += 2;
     }
 
-    ret = sss_sec_init(db, kcm_section_quota, &secdb->sctx);
+    secdb->max_payload_size = kcm_section_quota[0]->quota.max_payload_size;
+
+    ret = confdb_get_int(cdb,
+                         confdb_service_path,
+                         CONFDB_KCM_FLUSH_INTERVAL,
+                         KCM_SECDB_DEFAULT_FLUSH_INTERVAL,
+                         &flush_interval);
+    if (ret != EOK) {
+        DEBUG(SSSDBG_FATAL_FAILURE,
+              "Failed to get the ccache flush interval [%d]: %s\n",
+              ret, sss_strerror(ret));
+        talloc_free(secdb);
+        return ret;
+    }
+    secdb->flush_interval = flush_interval > 0 ? flush_interval : 0;
+    secdb->ev = db->ev;
+
+    /* The database must outlive the destructor that writes back the
+     * modified ccaches */
+    ret = sss_sec_init(secdb, kcm_section_quota, &secdb->sctx);
     if (ret != EOK) {
         DEBUG(SSSDBG_CRIT_FAILURE,
               "Cannot initialize the security database\n");
         talloc_free(secdb);
         return ret;
     }
+    talloc_set_destructor(secdb, secdb_destructor);
 
-    DEBUG(SSSDBG_TRACE_INTERNAL, "secdb initialized\n");
+    DEBUG(SSSDBG_TRACE_INTERNAL, "secdb initialized, ccache flush interval "
+          "%"PRIu32" seconds\n", secdb->flush_interval);
     db->db_handle = secdb;
     return EOK;
 }
@@ -608,15 +920,10 @@ struct ccdb_secdb_nextid_state {
     unsigned int nextid;
 };
 
-static bool is_in_use(char **keys, size_t nkeys, const char *nextid_name)
+static bool is_in_use(struct ccdb_secdb_uid *uid_cache,
+                      const char *nextid_name)
 {
-    for (size_t i = 0; i < nkeys; i++) {
-        if (sec_key_match_name(keys[i], nextid_name) == true) {
-            return true;
-        }
-    }
-
-    return false;
+    return secdb_cc_by_name(uid_cache, nextid_name) != NULL;
 }
 
 static struct tevent_req *ccdb_secdb_nextid_send(TALLOC_CTX *mem_ctx,
@@ -630,9 +937,7 @@ static struct tevent_req *ccdb_secdb_nextid_send(TALLOC_CTX *mem_ctx,
     const int maxtries = 3;
     int numtry;
     errno_t ret;
-    struct sss_sec_req *sreq = NULL;
-    char **keys = NULL;
-    size_t nkeys;
+    struct ccdb_secdb_uid *uid_cache = NULL;
     char *nextid_name = NULL;
 
     DEBUG(SSSDBG_TRACE_LIBS, "Generating a new ID\n");
@@ -648,22 +953,11 @@ static struct tevent_req *ccdb_secdb_nextid_send(TALLOC_CTX *mem_ctx,
         goto immediate;
     }
 
-    ret = secdb_container_url_req(state, secdb->sctx, client, &sreq);
+    ret = secdb_uid_get(secdb, client, &uid_cache);
     if (ret != EOK) {
         goto immediate;
     }
 
-    ret = sss_sec_list(state, sreq, &keys, &nkeys);
-    if (ret == ENOENT) {
-        keys = NULL;
-        nkeys = 0;
-    } else if (ret != EOK) {
-        DEBUG(SSSDBG_OP_FAILURE,
-              "Cannot list keys [%d]: %s\n",
-              ret, sss_strerror(ret));
-        goto immediate;
-    }
-
     for (numtry = 0; numtry  < maxtries; numtry++) {
         state->nextid = sss_rand() % MAX_CC_NUM;
         nextid_name = talloc_asprintf(state, "%"SPRIuid":%u",
@@ -674,7 +968,7 @@ static struct tevent_req *ccdb_secdb_nextid_send(TALLOC_CTX *mem_ctx,
             goto immediate;
         }
 
-        if (!is_in_use(keys, nkeys, nextid_name)) {
+        if (!is_in_use(uid_cache, nextid_name)) {
             break;
         }
     }
@@ -858,9 +1152,10 @@ static struct tevent_req *ccdb_secdb_list_send(TALLOC_CTX *mem_ctx,
     struct tevent_req *req = NULL;
     struct ccdb_secdb_list_state *state = NULL;
     errno_t ret;
-    char **keys = NULL;
-    size_t nkeys;
-    struct sss_sec_req *sreq = NULL;
+    struct ccdb_secdb_uid *uid_cache = NULL;
+    struct ccdb_secdb_cc *ccwrap;
+    size_t nkeys = 0;
+    size_t i = 0;
 
     DEBUG(SSSDBG_TRACE_INTERNAL, "Listing all ccaches\n");
 
@@ -869,17 +1164,13 @@ static struct tevent_req *ccdb_secdb_list_send(TALLOC_CTX *mem_ctx,
         return NULL;
     }
 
-    ret = secdb_container_url_req(state, secdb->sctx, client, &sreq);
+    ret = secdb_uid_get(secdb, client, &uid_cache);
     if (ret != EOK) {
         goto immediate;
     }
 
-    ret = sss_sec_list(state, sreq, &keys, &nkeys);
-    if (ret == ENOENT) {
-        nkeys = 0;
-        /* Fall through and return an empty list */
-    } else if (ret != EOK) {
-        goto immediate;
+    DLIST_FOR_EACH(ccwrap, uid_cache->ccs) {
+        nkeys++;
     }
     DEBUG(SSSDBG_TRACE_INTERNAL, "Found %zu ccaches\n", nkeys);
 
@@ -889,12 +1180,13 @@ static struct tevent_req *ccdb_secdb_list_send(TALLOC_CTX *mem_ctx,
         goto immediate;
     }
 
-    for (size_t i = 0; i < nkeys; i++) {
-        ret = sec_key_get_uuid(keys[i],
+    DLIST_FOR_EACH(ccwrap, uid_cache->ccs) {
+        ret = sec_key_get_uuid(ccwrap->key,
                                state->uuid_list[i]);
         if (ret != EOK) {
             goto immediate;
         }
+        i++;
     }
     /* Sentinel */
     uuid_clear(state->uuid_list[nkeys]);
@@ -937,7 +1229,8 @@ static struct tevent_req *ccdb_secdb_getbyuuid_send(TALLOC_CTX *mem_ctx,
     struct tevent_req *req = NULL;
     struct ccdb_secdb_getbyuuid_state *state = NULL;
     errno_t ret;
-    char *secdb_key = NULL;
+    struct ccdb_secdb_uid *uid_cache = NULL;
+    struct ccdb_secdb_cc *ccwrap;
 
     DEBUG(SSSDBG_TRACE_INTERNAL, "Getting ccache by UUID\n");
 
@@ -946,16 +1239,19 @@ static struct tevent_req *ccdb_secdb_getbyuuid_send(TALLOC_CTX *mem_ctx,
         return NULL;
     }
 
-    ret = key_by_uuid(state, secdb->sctx, client, uuid, &secdb_key);
-    if (ret == ENOENT) {
+    ret = secdb_uid_get(secdb, client, &uid_cache);
+    if (ret != EOK) {
+        goto immediate;
+    }
+
+    ccwrap = secdb_cc_by_uuid(uid_cache, uuid);
+    if (ccwrap == NULL) {
         state->cc = NULL;
         ret = EOK;
         goto immediate;
-    } else if (ret != EOK) {
-        goto immediate;
     }
 
-    ret = secdb_get_cc(state, secdb->sctx, secdb_key, client, &state->cc);
+    ret = secdb_cc_get(state, secdb, client, ccwrap, &state->cc);
     if (ret != EOK) {
         goto immediate;
     }
@@ -998,7 +1294,8 @@ static struct tevent_req *ccdb_secdb_getbyname_send(TALLOC_CTX *mem_ctx,
     struct tevent_req *req = NULL;
     struct ccdb_secdb_getbyname_state *state = NULL;
     errno_t ret;
-    char *secdb_key = NULL;
+    struct ccdb_secdb_uid *uid_cache = NULL;
+    struct ccdb_secdb_cc *ccwrap;
 
     DEBUG(SSSDBG_TRACE_INTERNAL, "Getting ccache by name\n");
 
@@ -1007,16 +1304,19 @@ static struct tevent_req *ccdb_secdb_getbyname_send(TALLOC_CTX *mem_ctx,
         return NULL;
     }
 
-    ret = key_by_name(state, secdb->sctx, client, name, &secdb_key);
-    if (ret == ENOENT) {
+    ret = secdb_uid_get(secdb, client, &uid_cache);
+    if (ret != EOK) {
+        goto immediate;
+    }
+
+    ccwrap = secdb_cc_by_name(uid_cache, name);
+    if (ccwrap == NULL) {
         state->cc = NULL;
         ret = EOK;
         goto immediate;
-    } else if (ret != EOK) {
-        goto immediate;
     }
 
-    ret = secdb_get_cc(state, secdb->sctx, secdb_key, client, &state->cc);
+    ret = secdb_cc_get(state, secdb, client, ccwrap, &state->cc);
     if (ret != EOK) {
         goto immediate;
     }
@@ -1060,7 +1360,8 @@ struct tevent_req *ccdb_secdb_name_by_uuid_send(TALLOC_CTX *mem_ctx,
     struct tevent_req *req = NULL;
     struct ccdb_secdb_name_by_uuid_state *state = NULL;
     errno_t ret;
-    char *key;
+    struct ccdb_secdb_uid *uid_cache = NULL;
+    struct ccdb_secdb_cc *ccwrap;
     const char *name;
 
     DEBUG(SSSDBG_TRACE_INTERNAL, "Translating UUID to name\n");
@@ -1070,15 +1371,18 @@ struct tevent_req *ccdb_secdb_name_by_uuid_send(TALLOC_CTX *mem_ctx,
         return NULL;
     }
 
-    ret = key_by_uuid(state, secdb->sctx, client, uuid, &key);
-    if (ret == ENOENT) {
-        ret = ERR_NO_CREDS;
+    ret = secdb_uid_get(secdb, client, &uid_cache);
+    if (ret != EOK) {
         goto immediate;
-    } else if (ret != EOK) {
+    }
+
+    ccwrap = secdb_cc_by_uuid(uid_cache, uuid);
+    if (ccwrap == NULL) {
+        ret = ERR_NO_CREDS;
         goto immediate;
     }
 
-    name = sec_key_get_name(key);
+    name = sec_key_get_name(ccwrap->key);
     if (ret != EOK) {
         DEBUG(SSSDBG_CRIT_FAILURE,
               "Malformed key, cannot get name\n");
@@ -1128,7 +1432,8 @@ struct tevent_req *ccdb_secdb_uuid_by_name_send(TALLOC_CTX *mem_ctx,
     struct tevent_req *req = NULL;
     struct ccdb_secdb_uuid_by_name_state *state = NULL;
     errno_t ret;
-    char *key;
+    struct ccdb_secdb_uid *uid_cache = NULL;
+    struct ccdb_secdb_cc *ccwrap;
 
     DEBUG(SSSDBG_TRACE_INTERNAL, "Translating name to UUID\n");
 
@@ -1137,15 +1442,18 @@ struct tevent_req *ccdb_secdb_uuid_by_name_send(TALLOC_CTX *mem_ctx,
         return NULL;
     }
 
-    ret = key_by_name(state, secdb->sctx, client, name, &key);
-    if (ret == ENOENT) {
-        ret = ERR_NO_CREDS;
+    ret = secdb_uid_get(secdb, client, &uid_cache);
+    if (ret != EOK) {
         goto immediate;
-    } else if (ret != EOK) {
+    }
+
+    ccwrap = secdb_cc_by_name(uid_cache, name);
+    if (ccwrap == NULL) {
+        ret = ERR_NO_CREDS;
         goto immediate;
     }
 
-    ret = sec_key_get_uuid(key, state->uuid);
+    ret = sec_key_get_uuid(ccwrap->key, state->uuid);
     if (ret != EOK) {
         DEBUG(SSSDBG_CRIT_FAILURE,
                 "Malformed key, cannot get UUID\n");
@@ -1190,6 +1498,8 @@ static struct tevent_req *ccdb_secdb_create_send(TALLOC_CTX *mem_ctx,
     struct sss_sec_req *ccache_req = NULL;
     const char *url;
     struct sss_iobuf *ccache_payload;
+    struct ccdb_secdb_uid *uid_cache;
+    struct ccdb_secdb_cc *ccwrap;
 
     DEBUG(SSSDBG_TRACE_INTERNAL, "Creating ccache storage for %s\n", cc->name);
 
@@ -1237,6 +1547,32 @@ static struct tevent_req *ccdb_secdb_create_send(TALLOC_CTX *mem_ctx,
     }
 
     DEBUG(SSSDBG_TRACE_INTERNAL, "payload created\n");
+
+    /* If the ccaches of the UID are not cached yet, the new one is read
+     * along with the others on first use */
+    uid_cache = secdb_uid_find(secdb, cli_creds_get_uid(client));
+    if (uid_cache != NULL) {
+        ccwrap = talloc_zero(uid_cache, struct ccdb_secdb_cc);
+        if (ccwrap != NULL) {
+            ccwrap->key = discard_const(sec_key_create(ccwrap, cc->name,
+                                                       cc->uuid));
+            ccwrap->cc = kcm_cc_copy(ccwrap, cc);
+        }
+
+        if (ccwrap == NULL || ccwrap->key == NULL || ccwrap->cc == NULL) {
+            /* the cache would miss the new ccache */
+            talloc_free(ccwrap);
+            ret = secdb_uid_drop(secdb, uid_cache);
+            if (ret != EOK) {
+                DEBUG(SSSDBG_OP_FAILURE,
+                      "Cannot drop the cached ccaches of UID %"SPRIuid", "
+                      "the new ccache is not listed\n", uid_cache->uid);
+            }
+        } else {
+            DLIST_ADD_END(uid_cache->ccs, ccwrap, struct ccdb_secdb_cc *);
+        }
+    }
+
     ret = EOK;
 immediate:
     if (ret == EOK) {
@@ -1265,10 +1601,9 @@ static struct tevent_req *ccdb_secdb_mod_send(TALLOC_CTX *mem_ctx,
     struct tevent_req *req = NULL;
     struct ccdb_secdb_state *state = NULL;
     errno_t ret;
-    char *secdb_key = NULL;
+    struct ccdb_secdb_uid *uid_cache = NULL;
+    struct ccdb_secdb_cc *ccwrap;
     struct kcm_ccache *cc = NULL;
-    struct sss_iobuf *payload = NULL;
-    struct sss_sec_req *sreq = NULL;
 
     DEBUG(SSSDBG_TRACE_INTERNAL, "Modifying ccache\n");
 
@@ -1277,15 +1612,19 @@ static struct tevent_req *ccdb_secdb_mod_send(TALLOC_CTX *mem_ctx,
         return NULL;
     }
 
-    ret = key_by_uuid(state, secdb->sctx, client, uuid, &secdb_key);
-    if (ret == ENOENT) {
-        ret = ERR_NO_CREDS;
+    ret = secdb_uid_get(secdb, client, &uid_cache);
+    if (ret != EOK) {
         goto immediate;
-    } else if (ret != EOK) {
+    }
+
+    ccwrap = secdb_cc_by_uuid(uid_cache, uuid);
+    if (ccwrap == NULL) {
+        ret = ERR_NO_CREDS;
         goto immediate;
     }
 
-    ret = secdb_get_cc(state, secdb->sctx, secdb_key, client, &cc);
+    /* modify a copy so that the cached ccache is kept on failure */
+    ret = secdb_cc_get(state, secdb, client, ccwrap, &cc);
     if (ret != EOK) {
         goto immediate;
     }
@@ -1298,17 +1637,7 @@ static struct tevent_req *ccdb_secdb_mod_send(TALLOC_CTX *mem_ctx,
         goto immediate;
     }
 
-    ret = kcm_ccache_to_sec_input(state, cc, client, &payload);
-    if (ret != EOK) {
-        goto immediate;
-    }
-
-    ret = secdb_cc_key_req(state, secdb->sctx, client, secdb_key, &sreq);
-    if (ret != EOK) {
-        goto immediate;
-    }
-
-    ret = sec_update_b64(state, sreq, payload);
+    ret = secdb_cc_replace(secdb, uid_cache, ccwrap, cc);
     if (ret != EOK) {
         goto immediate;
     }
@@ -1340,10 +1669,9 @@ static struct tevent_req *ccdb_secdb_store_cred_send(TALLOC_CTX *mem_ctx,
     struct ccdb_secdb *secdb = talloc_get_type(db->db_handle, struct ccdb_secdb);
     struct tevent_req *req = NULL;
     struct ccdb_secdb_state *state = NULL;
-    char *secdb_key = NULL;
+    struct ccdb_secdb_uid *uid_cache = NULL;
+    struct ccdb_secdb_cc *ccwrap;
     struct kcm_ccache *cc = NULL;
-    struct sss_iobuf *payload = NULL;
-    struct sss_sec_req *sreq = NULL;
     errno_t ret;
 
     DEBUG(SSSDBG_TRACE_INTERNAL, "Storing creds in ccache\n");
@@ -1353,15 +1681,19 @@ static struct tevent_req *ccdb_secdb_store_cred_send(TALLOC_CTX *mem_ctx,
         return NULL;
     }
 
-    ret = key_by_uuid(state, secdb->sctx, client, uuid, &secdb_key);
-    if (ret == ENOENT) {
-        ret = ERR_NO_CREDS;
+    ret = secdb_uid_get(secdb, client, &uid_cache);
+    if (ret != EOK) {
         goto immediate;
-    } else if (ret != EOK) {
+    }
+
+    ccwrap = secdb_cc_by_uuid(uid_cache, uuid);
+    if (ccwrap == NULL) {
+        ret = ERR_NO_CREDS;
         goto immediate;
     }
 
-    ret = secdb_get_cc(state, secdb->sctx, secdb_key, client, &cc);
+    /* modify a copy so that the cached ccache is kept on failure */
+    ret = secdb_cc_get(state, secdb, client, ccwrap, &cc);
     if (ret != EOK) {
         goto immediate;
     }
@@ -1374,17 +1706,7 @@ static struct tevent_req *ccdb_secdb_store_cred_send(TALLOC_CTX *mem_ctx,
         goto immediate;
     }
 
-    ret = kcm_ccache_to_sec_input(state, cc, client, &payload);
-    if (ret != EOK) {
-        goto immediate;
-    }
-
-    ret = secdb_cc_key_req(state, secdb->sctx, client, secdb_key, &sreq);
-    if (ret != EOK) {
-        goto immediate;
-    }
-
-    ret = sec_update_b64(state, sreq, payload);
+    ret = secdb_cc_replace(secdb, uid_cache, ccwrap, cc);
     if (ret != EOK) {
         goto immediate;
     }
@@ -1417,9 +1739,8 @@ static struct tevent_req *ccdb_secdb_delete_send(TALLOC_CTX *mem_ctx,
     struct ccdb_secdb *secdb = talloc_get_type(db->db_handle, struct ccdb_secdb);
     struct sss_sec_req *container_req = NULL;
     struct sss_sec_req *sreq = NULL;
-    char *secdb_key = NULL;
-    char **keys = NULL;
-    size_t nkeys;
+    struct ccdb_secdb_uid *uid_cache = NULL;
+    struct ccdb_secdb_cc *ccwrap;
     errno_t ret;
 
     DEBUG(SSSDBG_TRACE_INTERNAL, "Deleting ccache\n");
@@ -1434,27 +1755,25 @@ static struct tevent_req *ccdb_secdb_delete_send(TALLOC_CTX *mem_ctx,
         goto immediate;
     }
 
-    ret = sss_sec_list(state, container_req, &keys, &nkeys);
+    ret = secdb_uid_get(secdb, client, &uid_cache);
     if (ret != EOK) {
-        DEBUG(SSSDBG_MINOR_FAILURE, "No ccaches to delete\n");
         goto immediate;
     }
-    DEBUG(SSSDBG_TRACE_INTERNAL, "Found %zu ccaches\n", nkeys);
 
-    if (nkeys == 0) {
+    if (uid_cache->ccs == NULL) {
+        /* the container is removed along with the last ccache */
+        DEBUG(SSSDBG_MINOR_FAILURE, "No ccaches to delete\n");
         ret = EOK;
         goto immediate;
     }
 
-    ret = key_by_uuid(state, secdb->sctx, client, uuid, &secdb_key);
-    if (ret == ENOENT) {
+    ccwrap = secdb_cc_by_uuid(uid_cache, uuid);
+    if (ccwrap == NULL) {
         ret = ERR_NO_CREDS;
         goto immediate;
-    } else if (ret != EOK) {
-        goto immediate;
     }
 
-    ret = secdb_cc_key_req(state, secdb->sctx, client, secdb_key, &sreq);
+    ret = secdb_cc_key_req(state, secdb->sctx, client, ccwrap->key, &sreq);
     if (ret != EOK) {
         goto immediate;
     }
@@ -1464,7 +1783,11 @@ static struct tevent_req *ccdb_secdb_delete_send(TALLOC_CTX *mem_ctx,
         goto immediate;
     }
 
-    if (nkeys > 1) {
+    /* pending changes of the deleted ccache are dropped */
+    DLIST_REMOVE(uid_cache->ccs, ccwrap);
+    talloc_free(ccwrap);
+
+    if (uid_cache->ccs != NULL) {
         DEBUG(SSSDBG_TRACE_INTERNAL, "There are other ccaches, done\n");
         ret = EOK;
         goto immediate;
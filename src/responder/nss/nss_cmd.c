@@ -238,7 +238,7 @@ static errno_t nss_getby_svc(struct cli_ctx *cli_ctx,
           port);
 
     subreq = nss_get_object_send(cmd_ctx, cli_ctx->ev, cli_ctx,
-                                 data, SSS_MC_NONE, NULL, 0);
+                                 data, SSS_MC_SERVICES, name, port);
     if (subreq == NULL) {
         DEBUG(SSSDBG_CRIT_FAILURE, "Unable to create tevent request!\n");
         return ENOMEM;
@@ -398,6 +398,8 @@ static errno_t nss_getby_sid(struct cli_ctx *cli_ctx,
                              enum cache_req_type type,
                              nss_protocol_fill_packet_fn fill_fn)
 {
+    const char *attrs[] = { SYSDB_SID_STR, SYSDB_UIDNUM, SYSDB_GIDNUM,
+                            ORIGINALAD_PREFIX SYSDB_NAME, NULL };
     struct cache_req_data *data;
     struct nss_cmd_ctx *cmd_ctx;
     struct tevent_req *subreq;
@@ -423,7 +425,7 @@ static errno_t nss_getby_sid(struct cli_ctx *cli_ctx,
           (fill_fn == nss_protocol_fill_name) ? "name"
           : ((fill_fn == nss_protocol_fill_id) ? "id" : ""));
 
-    data = cache_req_data_sid(cmd_ctx, type, sid, NULL);
+    data = cache_req_data_sid(cmd_ctx, type, sid, attrs);
     if (data == NULL) {
         DEBUG(SSSDBG_CRIT_FAILURE, "Unable to set cache request data!\n");
         ret = ENOMEM;
@@ -431,7 +433,7 @@ static errno_t nss_getby_sid(struct cli_ctx *cli_ctx,
     }
 
     subreq = nss_get_object_send(cmd_ctx, cli_ctx->ev, cli_ctx,
-                                 data, SSS_MC_NONE, NULL, 0);
+                                 data, SSS_MC_SID, sid, 0);
     if (subreq == NULL) {
         DEBUG(SSSDBG_CRIT_FAILURE, "Unable to create tevent request!\n");
         ret = ENOMEM;
@@ -451,6 +453,272 @@ done:
     return EOK;
 }
 
+enum nss_list_key_type {
+    NSS_LIST_KEY_NAME,
+    NSS_LIST_KEY_ID,
+    NSS_LIST_KEY_SID
+};
+
+struct nss_list_ctx;
+
+struct nss_list_key {
+    struct nss_list_ctx *list_ctx;
+    struct nss_cmd_ctx *cmd_ctx;
+    struct sss_packet *packet;
+    errno_t status;
+};
+
+struct nss_list_ctx {
+    struct cli_ctx *cli_ctx;
+    struct nss_ctx *nss_ctx;
+    uint32_t num_keys;
+    uint32_t num_pending;
+    struct nss_list_key *keys;
+};
+
+static void nss_getby_list_done(struct tevent_req *subreq);
+static void nss_getby_list_reply(struct nss_list_ctx *list_ctx);
+
+/* Batched lookups. Each key is resolved by its own cache request, all of
+ * them run concurrently and the reply is sent once the last one finishes.
+ * Every key gets the reply body the single-key command would produce. */
+static errno_t nss_getby_list(struct cli_ctx *cli_ctx,
+                              enum nss_list_key_type key_type,
+                              enum cache_req_type type,
+                              const char **attrs,
+                              enum sss_mc_type memcache,
+                              nss_protocol_fill_packet_fn fill_fn)
+{
+    struct nss_list_ctx *list_ctx;
+    struct nss_list_key *key;
+    struct cache_req_data *data;
+    struct tevent_req *subreq;
+    const char **names = NULL;
+    uint32_t *ids = NULL;
+    uint32_t num;
+    uint32_t i;
+    errno_t ret;
+
+    list_ctx = talloc_zero(cli_ctx, struct nss_list_ctx);
+    if (list_ctx == NULL) {
+        ret = ENOMEM;
+        goto done;
+    }
+
+    list_ctx->cli_ctx = cli_ctx;
+    list_ctx->nss_ctx = talloc_get_type(cli_ctx->rctx->pvt_ctx,
+                                        struct nss_ctx);
+
+    switch (key_type) {
+    case NSS_LIST_KEY_NAME:
+        ret = nss_protocol_parse_name_list(list_ctx, cli_ctx, &names, &num);
+        break;
+    case NSS_LIST_KEY_SID:
+        ret = nss_protocol_parse_sid_list(list_ctx, cli_ctx, &names, &num);
+        break;
+    case NSS_LIST_KEY_ID:
+        ret = nss_protocol_parse_id_list(list_ctx, cli_ctx, &ids, &num);
+        break;
+    default:
+        ret = EINVAL;
+        break;
+    }
+    if (ret != EOK) {
+        DEBUG(SSSDBG_CRIT_FAILURE, "Invalid request message!\n");
+        goto done;
+    }
+
+    DEBUG(SSSDBG_TRACE_FUNC, "Input: %u keys\n", num);
+
+    list_ctx->keys = talloc_zero_array(list_ctx, struct nss_list_key, num);
+    if (list_ctx->keys == NULL) {
+        ret = ENOMEM;
+        goto done;
+    }
+    list_ctx->num_keys = num;
+
+    for (i = 0; i < num; i++) {
+        key = &list_ctx->keys[i];
+        key->list_ctx = list_ctx;
+
+        if (names != NULL && names[i] == NULL) {
+            /* malformed key */
+            key->status = EINVAL;
+            continue;
+        }
+
+        key->cmd_ctx = nss_cmd_ctx_create(list_ctx, cli_ctx, type, fill_fn);
+        if (key->cmd_ctx == NULL) {
+            ret = ENOMEM;
+            goto done;
+        }
+
+        /* It will be detected when constructing output packet. */
+        key->cmd_ctx->sid_id_type = SSS_ID_TYPE_NOT_SPECIFIED;
+
+        switch (key_type) {
+        case NSS_LIST_KEY_NAME:
+            data = cache_req_data_name_attrs(key->cmd_ctx, type, names[i],
+                                             attrs);
+            break;
+        case NSS_LIST_KEY_SID:
+            data = cache_req_data_sid(key->cmd_ctx, type, names[i], attrs);
+            break;
+        case NSS_LIST_KEY_ID:
+            data = cache_req_data_id_attrs(key->cmd_ctx, type, ids[i], attrs);
+            break;
+        default:
+            data = NULL;
+            break;
+        }
+        if (data == NULL) {
+            DEBUG(SSSDBG_CRIT_FAILURE, "Unable to set cache request data!\n");
+            ret = ENOMEM;
+            goto done;
+        }
+
+        subreq = nss_get_object_send(key->cmd_ctx, cli_ctx->ev, cli_ctx, data,
+                                     memcache,
+                                     names == NULL ? NULL : names[i],
+                                     ids == NULL ? 0 : ids[i]);
+        if (subreq == NULL) {
+            DEBUG(SSSDBG_CRIT_FAILURE, "Unable to create tevent request!\n");
+            ret = ENOMEM;
+            goto done;
+        }
+
+        tevent_req_set_callback(subreq, nss_getby_list_done, key);
+        list_ctx->num_pending++;
+    }
+
+    if (list_ctx->num_pending == 0) {
+        /* all keys were malformed */
+        nss_getby_list_reply(list_ctx);
+    }
+
+    ret = EOK;
+
+done:
+    if (ret != EOK) {
+        talloc_free(list_ctx);
+        return nss_protocol_done(cli_ctx, ret);
+    }
+
+    return EOK;
+}
+
+static void nss_getby_list_done(struct tevent_req *subreq)
+{
+    struct cache_req_result *result;
+    struct nss_list_key *key;
+    struct nss_list_ctx *list_ctx;
+    struct nss_cmd_ctx *cmd_ctx;
+    errno_t ret;
+
+    key = tevent_req_callback_data(subreq, struct nss_list_key);
+    list_ctx = key->list_ctx;
+    cmd_ctx = key->cmd_ctx;
+
+    ret = nss_get_object_recv(cmd_ctx, subreq, &result, &cmd_ctx->rawname);
+    talloc_zfree(subreq);
+    if (ret != EOK) {
+        goto done;
+    }
+
+    ret = sss_packet_new(list_ctx, 0, SSS_CLI_NULL, &key->packet);
+    if (ret != EOK) {
+        goto done;
+    }
+
+    ret = cmd_ctx->fill_fn(list_ctx->nss_ctx, cmd_ctx, key->packet, result);
+
+done:
+    if (ret != EOK) {
+        DEBUG(SSSDBG_TRACE_FUNC, "Key lookup finished [%d]: %s\n",
+              ret, sss_strerror(ret));
+    }
+
+    key->status = ret;
+    key->cmd_ctx = NULL;
+    talloc_free(cmd_ctx);
+
+    list_ctx->num_pending--;
+    if (list_ctx->num_pending == 0) {
+        nss_getby_list_reply(list_ctx);
+    }
+}
+
+static void nss_getby_list_reply(struct nss_list_ctx *list_ctx)
+{
+    struct cli_protocol *pctx;
+    struct sss_packet *out;
+    struct nss_list_key *key;
+    uint8_t *key_body;
+    size_t key_len;
+    uint32_t status;
+    uint32_t len;
+    uint8_t *body;
+    size_t body_len;
+    size_t rp;
+    uint32_t i;
+    errno_t ret;
+
+    pctx = talloc_get_type(list_ctx->cli_ctx->protocol_ctx,
+                           struct cli_protocol);
+
+    ret = sss_packet_new(pctx->creq, 0, sss_packet_get_cmd(pctx->creq->in),
+                         &pctx->creq->out);
+    if (ret != EOK) {
+        goto done;
+    }
+    out = pctx->creq->out;
+
+    /* First two fields (number of keys and reserved). */
+    ret = sss_packet_grow(out, 2 * sizeof(uint32_t));
+    if (ret != EOK) {
+        goto done;
+    }
+
+    rp = 2 * sizeof(uint32_t);
+
+    for (i = 0; i < list_ctx->num_keys; i++) {
+        key = &list_ctx->keys[i];
+
+        key_body = NULL;
+        key_len = 0;
+        if (key->status == EOK) {
+            sss_packet_get_body(key->packet, &key_body, &key_len);
+        }
+
+        ret = sss_packet_grow(out, 2 * sizeof(uint32_t) + key_len);
+        if (ret != EOK) {
+            goto done;
+        }
+
+        sss_packet_get_body(out, &body, &body_len);
+
+        status = key->status;
+        len = key_len;
+        SAFEALIGN_SET_UINT32(&body[rp], status, &rp);
+        SAFEALIGN_SET_UINT32(&body[rp], len, &rp);
+        if (key_len > 0) {
+            safealign_memcpy(&body[rp], key_body, key_len, &rp);
+        }
+    }
+
+    sss_packet_get_body(out, &body, &body_len);
+    SAFEALIGN_COPY_UINT32(body, &list_ctx->num_keys, NULL);
+    SAFEALIGN_SETMEM_UINT32(body + sizeof(uint32_t), 0, NULL); /* reserved */
+
+    sss_packet_set_error(out, EOK);
+
+    ret = EOK;
+
+done:
+    nss_protocol_done(list_ctx->cli_ctx, ret);
+    talloc_free(list_ctx);
+}
+
 static errno_t nss_getby_addr(struct cli_ctx *cli_ctx,
                               enum cache_req_type type,
                               enum sss_mc_type memcache,
@@ -743,7 +1011,9 @@ static void nss_getent_done(struct tevent_req *subreq)
 {
     struct cache_req_result *limited;
     struct cache_req_result *result;
+    struct cache_req_result *page;
     struct nss_cmd_ctx *cmd_ctx;
+    uint32_t limit;
     errno_t ret;
 
     cmd_ctx = tevent_req_callback_data(subreq, struct nss_cmd_ctx);
@@ -754,27 +1024,51 @@ static void nss_getent_done(struct tevent_req *subreq)
         goto done;
     }
 
-    result = nss_getent_get_result(cmd_ctx->enum_ctx, cmd_ctx->enum_index);
-    if (result == NULL) {
-        /* No more records to return. */
-        ret = ENOENT;
-        goto done;
+    limit = cmd_ctx->enum_limit;
+    if (cmd_ctx->enum_ctx->paged
+            && limit > (uint32_t)cmd_ctx->nss_ctx->enum_page_size) {
+        limit = cmd_ctx->nss_ctx->enum_page_size;
     }
 
-    /* Create copy of the result with limited number of records. */
-    limited = cache_req_copy_limited_result(cmd_ctx, result,
-                                            cmd_ctx->enum_index->result,
-                                            cmd_ctx->enum_limit);
-    if (limited == NULL) {
-        ret = ERR_INTERNAL;
-        goto done;
-    }
+    do {
+        result = nss_getent_get_result(cmd_ctx->enum_ctx,
+                                       cmd_ctx->enum_index);
+        if (result == NULL) {
+            /* No more records to return. */
+            ret = ENOENT;
+            goto done;
+        }
+
+        /* Create copy of the result with limited number of records. */
+        limited = cache_req_copy_limited_result(cmd_ctx, result,
+                                                cmd_ctx->enum_index->result,
+                                                limit);
+        if (limited == NULL) {
+            ret = ERR_INTERNAL;
+            goto done;
+        }
 
-    cmd_ctx->enum_index->result += result->count;
+        cmd_ctx->enum_index->result += limited->count;
+
+        if (!cmd_ctx->enum_ctx->paged) {
+            break;
+        }
+
+        /* Read the listed objects from the cache. Objects removed since
+         * the enumeration started are skipped, so continue with the next
+         * chunk if none of them is left. */
+        ret = nss_setent_read_page(cmd_ctx, cmd_ctx->type, limited, &page);
+        if (ret != EOK) {
+            goto done;
+        }
+
+        talloc_free(limited);
+        limited = page;
+    } while (limited->count == 0);
 
     /* Reply with limited result. */
     nss_protocol_reply(cmd_ctx->cli_ctx, cmd_ctx->nss_ctx, cmd_ctx,
-                       result, cmd_ctx->fill_fn);
+                       limited, cmd_ctx->fill_fn);
 
     ret = EOK;
 
@@ -996,6 +1290,18 @@ static errno_t nss_cmd_getpwuid_ex(struct cli_ctx *cli_ctx)
                         SSS_MC_PASSWD, nss_protocol_fill_pwent);
 }
 
+static errno_t nss_cmd_getpwnam_list(struct cli_ctx *cli_ctx)
+{
+    return nss_getby_list(cli_ctx, NSS_LIST_KEY_NAME, CACHE_REQ_USER_BY_NAME,
+                          NULL, SSS_MC_PASSWD, nss_protocol_fill_pwent);
+}
+
+static errno_t nss_cmd_getpwuid_list(struct cli_ctx *cli_ctx)
+{
+    return nss_getby_list(cli_ctx, NSS_LIST_KEY_ID, CACHE_REQ_USER_BY_ID,
+                          NULL, SSS_MC_PASSWD, nss_protocol_fill_pwent);
+}
+
 static errno_t nss_cmd_setpwent(struct cli_ctx *cli_ctx)
 {
     struct nss_ctx *nss_ctx;
@@ -1051,6 +1357,18 @@ static errno_t nss_cmd_getgrgid_ex(struct cli_ctx *cli_ctx)
                         SSS_MC_GROUP, nss_protocol_fill_grent);
 }
 
+static errno_t nss_cmd_getgrnam_list(struct cli_ctx *cli_ctx)
+{
+    return nss_getby_list(cli_ctx, NSS_LIST_KEY_NAME, CACHE_REQ_GROUP_BY_NAME,
+                          NULL, SSS_MC_GROUP, nss_protocol_fill_grent);
+}
+
+static errno_t nss_cmd_getgrgid_list(struct cli_ctx *cli_ctx)
+{
+    return nss_getby_list(cli_ctx, NSS_LIST_KEY_ID, CACHE_REQ_GROUP_BY_ID,
+                          NULL, SSS_MC_GROUP, nss_protocol_fill_grent);
+}
+
 
 static errno_t nss_cmd_setgrent(struct cli_ctx *cli_ctx)
 {
@@ -1180,34 +1498,38 @@ static errno_t nss_cmd_endservent(struct cli_ctx *cli_ctx)
 
 static errno_t nss_cmd_getsidbyname(struct cli_ctx *cli_ctx)
 {
-    const char *attrs[] = { SYSDB_SID_STR, NULL };
+    const char *attrs[] = { SYSDB_SID_STR, SYSDB_UIDNUM, SYSDB_GIDNUM,
+                            ORIGINALAD_PREFIX SYSDB_NAME, NULL };
 
     return nss_getby_name(cli_ctx, false, CACHE_REQ_OBJECT_BY_NAME, attrs,
-                          SSS_MC_NONE, nss_protocol_fill_sid);
+                          SSS_MC_SID, nss_protocol_fill_sid);
 }
 
 static errno_t nss_cmd_getsidbyid(struct cli_ctx *cli_ctx)
 {
-    const char *attrs[] = { SYSDB_SID_STR, NULL };
+    const char *attrs[] = { SYSDB_SID_STR, SYSDB_UIDNUM, SYSDB_GIDNUM,
+                            ORIGINALAD_PREFIX SYSDB_NAME, NULL };
 
     return nss_getby_id(cli_ctx, false, CACHE_REQ_OBJECT_BY_ID, attrs,
-                        SSS_MC_NONE, nss_protocol_fill_sid);
+                        SSS_MC_SID, nss_protocol_fill_sid);
 }
 
 static errno_t nss_cmd_getsidbyuid(struct cli_ctx *cli_ctx)
 {
-    const char *attrs[] = { SYSDB_SID_STR, NULL };
+    const char *attrs[] = { SYSDB_SID_STR, SYSDB_UIDNUM, SYSDB_GIDNUM,
+                            ORIGINALAD_PREFIX SYSDB_NAME, NULL };
 
     return nss_getby_id(cli_ctx, false, CACHE_REQ_USER_BY_ID, attrs,
-                        SSS_MC_NONE, nss_protocol_fill_sid);
+                        SSS_MC_SID, nss_protocol_fill_sid);
 }
 
 static errno_t nss_cmd_getsidbygid(struct cli_ctx *cli_ctx)
 {
-    const char *attrs[] = { SYSDB_SID_STR, NULL };
+    const char *attrs[] = { SYSDB_SID_STR, SYSDB_UIDNUM, SYSDB_GIDNUM,
+                            ORIGINALAD_PREFIX SYSDB_NAME, NULL };
 
     return nss_getby_id(cli_ctx, false, CACHE_REQ_GROUP_BY_ID, attrs,
-                        SSS_MC_NONE, nss_protocol_fill_sid);
+                        SSS_MC_SID, nss_protocol_fill_sid);
 }
 
 static errno_t nss_cmd_getnamebysid(struct cli_ctx *cli_ctx)
@@ -1222,6 +1544,42 @@ static errno_t nss_cmd_getidbysid(struct cli_ctx *cli_ctx)
                          nss_protocol_fill_id);
 }
 
+static errno_t nss_cmd_getsidbyname_list(struct cli_ctx *cli_ctx)
+{
+    const char *attrs[] = { SYSDB_SID_STR, SYSDB_UIDNUM, SYSDB_GIDNUM,
+                            ORIGINALAD_PREFIX SYSDB_NAME, NULL };
+
+    return nss_getby_list(cli_ctx, NSS_LIST_KEY_NAME, CACHE_REQ_OBJECT_BY_NAME,
+                          attrs, SSS_MC_SID, nss_protocol_fill_sid);
+}
+
+static errno_t nss_cmd_getsidbyid_list(struct cli_ctx *cli_ctx)
+{
+    const char *attrs[] = { SYSDB_SID_STR, SYSDB_UIDNUM, SYSDB_GIDNUM,
+                            ORIGINALAD_PREFIX SYSDB_NAME, NULL };
+
+    return nss_getby_list(cli_ctx, NSS_LIST_KEY_ID, CACHE_REQ_OBJECT_BY_ID,
+                          attrs, SSS_MC_SID, nss_protocol_fill_sid);
+}
+
+static errno_t nss_cmd_getnamebysid_list(struct cli_ctx *cli_ctx)
+{
+    const char *attrs[] = { SYSDB_SID_STR, SYSDB_UIDNUM, SYSDB_GIDNUM,
+                            ORIGINALAD_PREFIX SYSDB_NAME, NULL };
+
+    return nss_getby_list(cli_ctx, NSS_LIST_KEY_SID, CACHE_REQ_OBJECT_BY_SID,
+                          attrs, SSS_MC_SID, nss_protocol_fill_name);
+}
+
+static errno_t nss_cmd_getidbysid_list(struct cli_ctx *cli_ctx)
+{
+    const char *attrs[] = { SYSDB_SID_STR, SYSDB_UIDNUM, SYSDB_GIDNUM,
+                            ORIGINALAD_PREFIX SYSDB_NAME, NULL };
+
+    return nss_getby_list(cli_ctx, NSS_LIST_KEY_SID, CACHE_REQ_OBJECT_BY_SID,
+                          attrs, SSS_MC_SID, nss_protocol_fill_id);
+}
+
 static errno_t nss_cmd_getorigbyname(struct cli_ctx *cli_ctx)
 {
     errno_t ret;
@@ -1400,6 +1758,14 @@ struct sss_cmd_table *get_nss_cmds(void)
         { SSS_NSS_GETGRNAM_EX, nss_cmd_getgrnam_ex },
         { SSS_NSS_GETGRGID_EX, nss_cmd_getgrgid_ex },
         { SSS_NSS_INITGR_EX, nss_cmd_initgroups_ex },
+        { SSS_NSS_GETPWNAM_LIST, nss_cmd_getpwnam_list },
+        { SSS_NSS_GETPWUID_LIST, nss_cmd_getpwuid_list },
+        { SSS_NSS_GETGRNAM_LIST, nss_cmd_getgrnam_list },
+        { SSS_NSS_GETGRGID_LIST, nss_cmd_getgrgid_list },
+        { SSS_NSS_GETSIDBYNAME_LIST, nss_cmd_getsidbyname_list },
+        { SSS_NSS_GETSIDBYID_LIST, nss_cmd_getsidbyid_list },
+        { SSS_NSS_GETNAMEBYSID_LIST, nss_cmd_getnamebysid_list },
+        { SSS_NSS_GETIDBYSID_LIST, nss_cmd_getidbysid_list },
         { SSS_NSS_GETHOSTBYNAME, nss_cmd_gethostbyname },
         { SSS_NSS_GETHOSTBYNAME2, nss_cmd_gethostbyname },
         { SSS_NSS_GETHOSTBYADDR, nss_cmd_gethostbyaddr },
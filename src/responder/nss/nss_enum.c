@@ -35,6 +35,7 @@ struct nss_setent_internal_state {
     struct nss_enum_ctx *enum_ctx;
     nss_setent_set_timeout_fn timeout_handler;
     enum cache_req_type type;
+    bool paged;
 };
 
 static void nss_setent_internal_done(struct tevent_req *subreq);
@@ -47,7 +48,8 @@ nss_setent_internal_send(TALLOC_CTX *mem_ctx,
                          struct cache_req_data *data,
                          enum cache_req_type type,
                          struct nss_enum_ctx *enum_ctx,
-                         nss_setent_set_timeout_fn timeout_handler)
+                         nss_setent_set_timeout_fn timeout_handler,
+                         bool paged)
 {
     struct nss_setent_internal_state *state;
     struct tevent_req *subreq;
@@ -67,6 +69,7 @@ nss_setent_internal_send(TALLOC_CTX *mem_ctx,
     state->enum_ctx = enum_ctx;
     state->type = type;
     state->timeout_handler = timeout_handler;
+    state->paged = paged;
 
     if (state->enum_ctx->is_ready) {
         /* Object is already constructed, just return here. */
@@ -92,6 +95,7 @@ nss_setent_internal_send(TALLOC_CTX *mem_ctx,
 
     /* Create new object. */
     state->enum_ctx->is_ready = false;
+    cache_req_data_set_enum_paged(data, paged);
     subreq = cache_req_send(req, ev, cli_ctx->rctx, cli_ctx->rctx->ncache,
                             state->nss_ctx->cache_refresh_percent,
                             CACHE_REQ_POSIX_DOM, NULL, data);
@@ -140,6 +144,7 @@ static void nss_setent_internal_done(struct tevent_req *subreq)
     case EOK:
         talloc_zfree(state->enum_ctx->result);
         state->enum_ctx->result = talloc_steal(state->enum_ctx, result);
+        state->enum_ctx->paged = state->paged;
 
         if (state->type == CACHE_REQ_NETGROUP_BY_NAME) {
             /* We need to expand the netgroup into triples and members. */
@@ -242,6 +247,8 @@ nss_setent_send(TALLOC_CTX *mem_ctx,
                 struct nss_enum_ctx *enum_ctx)
 {
     struct cache_req_data *data;
+    struct nss_ctx *nss_ctx;
+    bool paged;
 
     data = cache_req_data_enum(mem_ctx, type);
     if (data == NULL) {
@@ -249,8 +256,14 @@ nss_setent_send(TALLOC_CTX *mem_ctx,
         return NULL;
     }
 
+    /* Users and groups can be read from the cache in chunks. */
+    nss_ctx = talloc_get_type(cli_ctx->rctx->pvt_ctx, struct nss_ctx);
+    paged = nss_ctx->enum_page_size > 0
+                && (type == CACHE_REQ_ENUM_USERS
+                        || type == CACHE_REQ_ENUM_GROUPS);
+
     return nss_setent_internal_send(mem_ctx, ev, cli_ctx, data, type, enum_ctx,
-                                    nss_setent_set_timeout);
+                                    nss_setent_set_timeout, paged);
 }
 
 errno_t nss_setent_recv(struct tevent_req *req)
@@ -258,6 +271,118 @@ errno_t nss_setent_recv(struct tevent_req *req)
     return nss_setent_internal_recv(req);
 }
 
+/* The responder may have added attributes to the listed objects, e.g.
+ * session recording, copy them over to the objects read from the cache. */
+static errno_t
+nss_setent_copy_listed_attrs(struct ldb_result *listed,
+                             struct ldb_result *page)
+{
+    static const char *attrs[] = { SYSDB_SESSION_RECORDING, NULL };
+    const char *value;
+    char *copy;
+    unsigned int i;
+    unsigned int j;
+    int a;
+    int lret;
+
+    /* Both results are in the same order, page may have gaps. */
+    for (i = 0, j = 0; i < page->count && j < listed->count; j++) {
+        if (ldb_dn_compare(page->msgs[i]->dn, listed->msgs[j]->dn) != 0) {
+            continue;
+        }
+
+        for (a = 0; attrs[a] != NULL; a++) {
+            value = ldb_msg_find_attr_as_string(listed->msgs[j], attrs[a],
+                                                NULL);
+            if (value == NULL) {
+                continue;
+            }
+
+            copy = talloc_strdup(page->msgs[i], value);
+            if (copy == NULL) {
+                return ENOMEM;
+            }
+
+            ldb_msg_remove_attr(page->msgs[i], attrs[a]);
+            lret = ldb_msg_add_steal_string(page->msgs[i], attrs[a], copy);
+            if (lret != LDB_SUCCESS) {
+                talloc_free(copy);
+                return sysdb_error_to_errno(lret);
+            }
+        }
+
+        i++;
+    }
+
+    return EOK;
+}
+
+/* Read the objects of a paged enumeration result from the cache. */
+errno_t
+nss_setent_read_page(TALLOC_CTX *mem_ctx,
+                     enum cache_req_type type,
+                     struct cache_req_result *listed,
+                     struct cache_req_result **_page)
+{
+    TALLOC_CTX *tmp_ctx;
+    struct cache_req_result *page;
+    struct ldb_result *ldb_result;
+    errno_t ret;
+
+    tmp_ctx = talloc_new(NULL);
+    if (tmp_ctx == NULL) {
+        return ENOMEM;
+    }
+
+    switch (type) {
+    case CACHE_REQ_ENUM_USERS:
+        ret = sysdb_enumpwent_by_dns_with_views(tmp_ctx, listed->domain,
+                                                listed->msgs, listed->count,
+                                                &ldb_result);
+        break;
+    case CACHE_REQ_ENUM_GROUPS:
+        ret = sysdb_enumgrent_by_dns_with_views(tmp_ctx, listed->domain,
+                                                listed->msgs, listed->count,
+                                                &ldb_result);
+        break;
+    default:
+        DEBUG(SSSDBG_CRIT_FAILURE, "Bug: unsupported paged enumeration "
+              "type [%d]\n", type);
+        ret = ERR_INTERNAL;
+        break;
+    }
+
+    if (ret != EOK) {
+        DEBUG(SSSDBG_OP_FAILURE, "Unable to read enumeration page [%d]: %s\n",
+              ret, sss_strerror(ret));
+        goto done;
+    }
+
+    ret = nss_setent_copy_listed_attrs(listed->ldb_result, ldb_result);
+    if (ret != EOK) {
+        goto done;
+    }
+
+    page = talloc_zero(tmp_ctx, struct cache_req_result);
+    if (page == NULL) {
+        ret = ENOMEM;
+        goto done;
+    }
+
+    page->domain = listed->domain;
+    page->ldb_result = talloc_steal(page, ldb_result);
+    page->count = ldb_result->count;
+    page->msgs = ldb_result->msgs;
+    page->lookup_name = listed->lookup_name;
+
+    *_page = talloc_steal(mem_ctx, page);
+    ret = EOK;
+
+done:
+    talloc_free(tmp_ctx);
+    return ret;
+}
+
 static void
 nss_setnetgrent_timeout(struct tevent_context *ev,
                         struct tevent_timer *te,
@@ -357,7 +482,7 @@ nss_setnetgrent_send(TALLOC_CTX *mem_ctx,
     }
 
     return nss_setent_internal_send(mem_ctx, ev, cli_ctx, data, type, enum_ctx,
-                                    nss_setnetgrent_set_timeout);
+                                    nss_setnetgrent_set_timeout, false);
 }
 
 errno_t nss_setnetgrent_recv(struct tevent_req *req)
@@ -42,6 +42,12 @@ memcache_delete_entry_by_name(struct nss_ctx *nss_ctx,
     case SSS_MC_INITGROUPS:
         ret = sss_mmap_cache_initgr_invalidate(nss_ctx->initgr_mc_ctx, name);
         break;
+    case SSS_MC_SERVICES:
+        ret = sss_mmap_cache_svc_invalidate(nss_ctx->svc_mc_ctx, name);
+        break;
+    case SSS_MC_SID:
+        ret = sss_mmap_cache_sid_invalidate(nss_ctx->sid_mc_ctx, name);
+        break;
     default:
         return EINVAL;
     }
@@ -71,6 +77,13 @@ memcache_delete_entry_by_id(struct nss_ctx *nss_ctx,
     case SSS_MC_GROUP:
         ret = sss_mmap_cache_gr_invalidate_gid(nss_ctx->grp_mc_ctx, (gid_t)id);
         break;
+    case SSS_MC_SERVICES:
+        ret = sss_mmap_cache_svc_invalidate_port(nss_ctx->svc_mc_ctx,
+                                                 (uint16_t)id);
+        break;
+    case SSS_MC_SID:
+        ret = sss_mmap_cache_sid_invalidate_id(nss_ctx->sid_mc_ctx, id);
+        break;
     default:
         return EINVAL;
     }
@@ -96,8 +109,26 @@ memcache_delete_entry(struct nss_ctx *nss_ctx,
 {
     struct sss_domain_info *dom;
     struct sized_string *sized_name;
+    struct sized_string raw_name;
     errno_t ret;
 
+    if (type == SSS_MC_SERVICES || type == SSS_MC_SID) {
+        /* Service names are not qualified with the domain name and SID
+         * lookups are keyed by the SID or the name exactly as the client
+         * sent it. A found entry is going to be overwritten by the reply
+         * anyway, so only drop entries that do not exist anymore. */
+        if (domain != NULL) {
+            return EOK;
+        }
+
+        if (name != NULL) {
+            to_sized_string(&raw_name, name);
+            return memcache_delete_entry_by_name(nss_ctx, &raw_name, type);
+        }
+
+        return memcache_delete_entry_by_id(nss_ctx, id, type);
+    }
+
     for (dom = rctx->domains;
          dom != NULL;
          dom = get_next_domain(dom, SSS_GND_DESCEND)) {
@@ -154,6 +154,7 @@ nss_memorycache_invalidate_users(TALLOC_CTX *mem_ctx,
 {
     DEBUG(SSSDBG_TRACE_LIBS, "Invalidating all users in memory cache\n");
     sss_mmap_cache_reset(nctx->pwd_mc_ctx);
+    cache_req_lru_flush(nctx->rctx->cache_req_lru);
 
     return EOK;
 }
@@ -165,6 +166,7 @@ nss_memorycache_invalidate_groups(TALLOC_CTX *mem_ctx,
 {
     DEBUG(SSSDBG_TRACE_LIBS, "Invalidating all groups in memory cache\n");
     sss_mmap_cache_reset(nctx->grp_mc_ctx);
+    cache_req_lru_flush(nctx->rctx->cache_req_lru);
 
     return EOK;
 }
@@ -177,6 +179,7 @@ nss_memorycache_invalidate_initgroups(TALLOC_CTX *mem_ctx,
     DEBUG(SSSDBG_TRACE_LIBS,
           "Invalidating all initgroup records in memory cache\n");
     sss_mmap_cache_reset(nctx->initgr_mc_ctx);
+    cache_req_lru_flush(nctx->rctx->cache_req_lru);
 
     return EOK;
 }
@@ -195,6 +198,10 @@ nss_memorycache_update_initgroups(TALLOC_CTX *mem_ctx,
     nss_update_initgr_memcache(nctx, user, domain,
                                talloc_array_length(groups), groups);
 
+    /* Result cache entries are keyed by the request, not by the object, so
+     * the ones describing this user or its groups cannot be picked out. */
+    cache_req_lru_flush(nctx->rctx->cache_req_lru);
+
     return EOK;
 }
 
@@ -209,6 +216,7 @@ nss_memorycache_invalidate_group_by_id(TALLOC_CTX *mem_ctx,
           "Invalidating group %u from memory cache\n", gid);
 
     sss_mmap_cache_gr_invalidate_gid(nctx->grp_mc_ctx, gid);
+    cache_req_lru_flush(nctx->rctx->cache_req_lru);
 
     return EOK;
 }
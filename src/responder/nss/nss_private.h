@@ -49,6 +49,10 @@ struct nss_enum_ctx {
     /* If true, the object is already constructed. */
     bool is_ready;
 
+    /* If true, result contains only DN and name of each object and the
+     * objects are read from the cache as they are returned. */
+    bool paged;
+
     /* List of setent requests awaiting the result. We finish
      * them when the ongoing cache request is completed. */
     struct setent_req_list *notify_list;
@@ -72,6 +76,7 @@ struct nss_ctx {
     /* Options. */
     int cache_refresh_percent;
     int enum_cache_timeout;
+    int enum_page_size;
     bool filter_users_in_groups;
     char *pwfield;
     char *override_homedir;
@@ -91,6 +96,8 @@ struct nss_ctx {
     struct sss_mc_ctx *pwd_mc_ctx;
     struct sss_mc_ctx *grp_mc_ctx;
     struct sss_mc_ctx *initgr_mc_ctx;
+    struct sss_mc_ctx *svc_mc_ctx;
+    struct sss_mc_ctx *sid_mc_ctx;
     uid_t mc_uid;
     gid_t mc_gid;
 };
@@ -132,6 +139,12 @@ nss_setent_send(TALLOC_CTX *mem_ctx,
 errno_t
 nss_setent_recv(struct tevent_req *req);
 
+errno_t
+nss_setent_read_page(TALLOC_CTX *mem_ctx,
+                     enum cache_req_type type,
+                     struct cache_req_result *listed,
+                     struct cache_req_result **_page);
+
 struct tevent_req *
 nss_setnetgrent_send(TALLOC_CTX *mem_ctx,
                      struct tevent_context *ev,
@@ -36,9 +36,10 @@ nss_protocol_done(struct cli_ctx *cli_ctx, errno_t error)
     case EOK:
         /* Create empty packet if none was provided. */
         if (pctx->creq->out == NULL) {
-            ret = sss_packet_new(pctx->creq, 0,
-                                 sss_packet_get_cmd(pctx->creq->in),
-                                 &pctx->creq->out);
+            ret = sss_packet_new_pooled(pctx->creq,
+                                        cli_ctx->rctx->packet_pool, 0,
+                                        sss_packet_get_cmd(pctx->creq->in),
+                                        &pctx->creq->out);
             if (ret != EOK) {
                 goto done;
             }
@@ -82,8 +83,9 @@ void nss_protocol_reply(struct cli_ctx *cli_ctx,
 
     pctx = talloc_get_type(cli_ctx->protocol_ctx, struct cli_protocol);
 
-    ret = sss_packet_new(pctx->creq, 0, sss_packet_get_cmd(pctx->creq->in),
-                         &pctx->creq->out);
+    ret = sss_packet_new_pooled(pctx->creq, cli_ctx->rctx->packet_pool, 0,
+                                sss_packet_get_cmd(pctx->creq->in),
+                                &pctx->creq->out);
     if (ret != EOK) {
         goto done;
     }
@@ -442,6 +444,209 @@ nss_protocol_parse_sid(struct cli_ctx *cli_ctx,
     return EOK;
 }
 
+static errno_t
+nss_protocol_parse_str_list(TALLOC_CTX *mem_ctx,
+                            struct cli_ctx *cli_ctx,
+                            const char ***_strs,
+                            uint32_t *_num)
+{
+    struct cli_protocol *pctx;
+    const char **strs;
+    uint32_t num;
+    uint32_t i;
+    uint8_t *body;
+    uint8_t *p;
+    size_t blen;
+    size_t rp;
+
+    pctx = talloc_get_type(cli_ctx->protocol_ctx, struct cli_protocol);
+
+    sss_packet_get_body(pctx->creq->in, &body, &blen);
+
+    if (blen < sizeof(uint32_t) + 1) {
+        DEBUG(SSSDBG_CRIT_FAILURE, "Body too short!\n");
+        return EINVAL;
+    }
+
+    /* If last argument not terminated fail. */
+    if (body[blen - 1] != '\0') {
+        DEBUG(SSSDBG_CRIT_FAILURE, "Body is not null terminated!\n");
+        return EINVAL;
+    }
+
+    rp = 0;
+    SAFEALIGN_COPY_UINT32(&num, body, &rp);
+    if (num == 0 || num > SSS_NSS_MAX_LIST_KEYS) {
+        DEBUG(SSSDBG_CRIT_FAILURE, "Invalid number of keys [%u]!\n", num);
+        return EINVAL;
+    }
+
+    strs = talloc_zero_array(mem_ctx, const char *, num);
+    if (strs == NULL) {
+        return ENOMEM;
+    }
+
+    for (i = 0; i < num; i++) {
+        if (rp >= blen) {
+            DEBUG(SSSDBG_CRIT_FAILURE, "Body has unexpected size!\n");
+            goto fail;
+        }
+
+        p = memchr(body + rp, '\0', blen - rp);
+        if (p == NULL) {
+            DEBUG(SSSDBG_CRIT_FAILURE, "Key is not null terminated!\n");
+            goto fail;
+        }
+
+        strs[i] = (const char *)(body + rp);
+        rp = (p - body) + 1;
+    }
+
+    if (rp != blen) {
+        DEBUG(SSSDBG_CRIT_FAILURE, "Body has unexpected size!\n");
+        goto fail;
+    }
+
+    *_strs = strs;
+    *_num = num;
+
+    return EOK;
+
+fail:
+    talloc_free(strs);
+    return EINVAL;
+}
+
+errno_t
+nss_protocol_parse_name_list(TALLOC_CTX *mem_ctx,
+                             struct cli_ctx *cli_ctx,
+                             const char ***_rawnames,
+                             uint32_t *_num)
+{
+    const char **rawnames;
+    uint32_t num;
+    uint32_t i;
+    errno_t ret;
+
+    ret = nss_protocol_parse_str_list(mem_ctx, cli_ctx, &rawnames, &num);
+    if (ret != EOK) {
+        return ret;
+    }
+
+    /* A malformed key must not fail the other keys of the batch, it is
+     * reported in its own status instead. */
+    for (i = 0; i < num; i++) {
+        if (rawnames[i][0] == '\0') {
+            DEBUG(SSSDBG_MINOR_FAILURE, "An empty name was provided!\n");
+            rawnames[i] = NULL;
+            continue;
+        }
+
+        if (!sss_utf8_check((const uint8_t *)rawnames[i],
+                            strlen(rawnames[i]))) {
+            DEBUG(SSSDBG_MINOR_FAILURE, "Name is not UTF-8 string!\n");
+            rawnames[i] = NULL;
+            continue;
+        }
+    }
+
+    *_rawnames = rawnames;
+    *_num = num;
+
+    return EOK;
+}
+
+errno_t
+nss_protocol_parse_sid_list(TALLOC_CTX *mem_ctx,
+                            struct cli_ctx *cli_ctx,
+                            const char ***_sids,
+                            uint32_t *_num)
+{
+    struct nss_ctx *nss_ctx;
+    const char **sids;
+    uint8_t *bin_sid;
+    size_t bin_len;
+    uint32_t num;
+    uint32_t i;
+    enum idmap_error_code err;
+    errno_t ret;
+
+    nss_ctx = talloc_get_type(cli_ctx->rctx->pvt_ctx, struct nss_ctx);
+
+    ret = nss_protocol_parse_str_list(mem_ctx, cli_ctx, &sids, &num);
+    if (ret != EOK) {
+        return ret;
+    }
+
+    for (i = 0; i < num; i++) {
+        /* If the key isn't a SID, only this key fails */
+        err = sss_idmap_sid_to_bin_sid(nss_ctx->idmap_ctx, sids[i], &bin_sid,
+                                       &bin_len);
+        if (err != IDMAP_SUCCESS) {
+            DEBUG(SSSDBG_MINOR_FAILURE,
+                  "Unable to convert SID to binary [%s].\n", sids[i]);
+            sids[i] = NULL;
+            continue;
+        }
+
+        sss_idmap_free_bin_sid(nss_ctx->idmap_ctx, bin_sid);
+    }
+
+    *_sids = sids;
+    *_num = num;
+
+    return EOK;
+}
+
+errno_t
+nss_protocol_parse_id_list(TALLOC_CTX *mem_ctx,
+                           struct cli_ctx *cli_ctx,
+                           uint32_t **_ids,
+                           uint32_t *_num)
+{
+    struct cli_protocol *pctx;
+    uint32_t *ids;
+    uint32_t num;
+    uint32_t i;
+    uint8_t *body;
+    size_t blen;
+    size_t rp;
+
+    pctx = talloc_get_type(cli_ctx->protocol_ctx, struct cli_protocol);
+
+    sss_packet_get_body(pctx->creq->in, &body, &blen);
+
+    if (blen < sizeof(uint32_t)) {
+        return EINVAL;
+    }
+
+    rp = 0;
+    SAFEALIGN_COPY_UINT32(&num, body, &rp);
+    if (num == 0 || num > SSS_NSS_MAX_LIST_KEYS) {
+        DEBUG(SSSDBG_CRIT_FAILURE, "Invalid number of keys [%u]!\n", num);
+        return EINVAL;
+    }
+
+    if (blen != (num + 1) * sizeof(uint32_t)) {
+        DEBUG(SSSDBG_CRIT_FAILURE, "Body has unexpected size!\n");
+        return EINVAL;
+    }
+
+    ids = talloc_array(mem_ctx, uint32_t, num);
+    if (ids == NULL) {
+        return ENOMEM;
+    }
+
+    for (i = 0; i < num; i++) {
+        SAFEALIGN_COPY_UINT32(&ids[i], body + rp, &rp);
+    }
+
+    *_ids = ids;
+    *_num = num;
+
+    return EOK;
+}
+
 errno_t
 nss_protocol_parse_addr(struct cli_ctx *cli_ctx,
                         uint32_t *_af,
@@ -121,6 +121,26 @@ errno_t
 nss_protocol_parse_sid(struct cli_ctx *cli_ctx,
                        const char **_sid);
 
+/* Keys which are not valid names or SIDs are set to NULL in the returned
+ * array, the caller reports them with EINVAL in their status. */
+errno_t
+nss_protocol_parse_name_list(TALLOC_CTX *mem_ctx,
+                             struct cli_ctx *cli_ctx,
+                             const char ***_rawnames,
+                             uint32_t *_num);
+
+errno_t
+nss_protocol_parse_sid_list(TALLOC_CTX *mem_ctx,
+                            struct cli_ctx *cli_ctx,
+                            const char ***_sids,
+                            uint32_t *_num);
+
+errno_t
+nss_protocol_parse_id_list(TALLOC_CTX *mem_ctx,
+                           struct cli_ctx *cli_ctx,
+                           uint32_t **_ids,
+                           uint32_t *_num);
+
 errno_t
 nss_protocol_parse_addr(struct cli_ctx *cli_ctx,
                         uint32_t *_af,
@@ -112,13 +112,48 @@ nss_get_group_ghosts(struct sss_domain_info *domain,
     return el;
 }
 
+/* Member lists at least this large are not copied into the reply of a
+ * single group but sent from their own buffer after it. */
+#define NSS_MEMBERS_TAIL_SIZE 16384
+
+/* Expected size of the member list, internal names are already fully
+ * qualified so they are close to the output names. */
+static size_t
+nss_get_members_size(struct sss_domain_info *domain,
+                     struct ldb_message *msg)
+{
+    struct ldb_message_element *members[2];
+    size_t size = 0;
+    int i, j;
+
+    if (domain->ignore_group_members) {
+        return 0;
+    }
+
+    members[0] = nss_get_group_members(domain, msg);
+    members[1] = ldb_msg_find_element(msg, SYSDB_GHOST);
+
+    for (i = 0; i < sizeof(members) / sizeof(members[0]); i++) {
+        if (members[i] == NULL) {
+            continue;
+        }
+
+        for (j = 0; j < members[i]->num_values; j++) {
+            size += members[i]->values[j].length + 1;
+        }
+    }
+
+    return size;
+}
+
 static errno_t
-nss_protocol_fill_members(struct sss_packet *packet,
+nss_protocol_fill_members(TALLOC_CTX *mem_ctx,
                           struct nss_ctx *nss_ctx,
                           struct sss_domain_info *domain,
                           struct ldb_message *msg,
                           const char *group_name,
-                          size_t *_rp,
+                          uint8_t **_members,
+                          size_t *_members_size,
                           uint32_t *_num_members)
 {
     TALLOC_CTX *tmp_ctx;
@@ -128,8 +163,10 @@ nss_protocol_fill_members(struct sss_packet *packet,
     struct sized_string *name;
     const char *member_name;
     uint32_t num_members;
-    size_t body_len;
-    uint8_t *body;
+    uint8_t *buf;
+    uint8_t *newbuf;
+    size_t buf_size;
+    size_t rp;
     errno_t ret;
     int i, j;
 
@@ -141,8 +178,16 @@ nss_protocol_fill_members(struct sss_packet *packet,
     members[0] = nss_get_group_members(domain, msg);
     members[1] = nss_get_group_ghosts(domain, msg, group_name);
 
-    sss_packet_get_body(packet, &body, &body_len);
+    /* The list is built at once so that it is copied into the packet
+     * with a single grow or not copied at all. */
+    buf_size = nss_get_members_size(domain, msg);
+    buf = talloc_size(mem_ctx, buf_size > 0 ? buf_size : 1);
+    if (buf == NULL) {
+        ret = ENOMEM;
+        goto done;
+    }
 
+    rp = 0;
     num_members = 0;
     for (i = 0; i < sizeof(members) / sizeof(members[0]); i++) {
         el = members[i];
@@ -170,22 +215,33 @@ nss_protocol_fill_members(struct sss_packet *packet,
                 goto done;
             }
 
-            ret = sss_packet_grow(packet, name->len);
-            if (ret != EOK) {
-                goto done;
+            if (rp + name->len > buf_size) {
+                buf_size = MAX(2 * buf_size, rp + name->len);
+                newbuf = talloc_realloc(mem_ctx, buf, uint8_t, buf_size);
+                if (newbuf == NULL) {
+                    ret = ENOMEM;
+                    goto done;
+                }
+                buf = newbuf;
             }
 
-            sss_packet_get_body(packet, &body, &body_len);
-            SAFEALIGN_SET_STRING(&body[*_rp], name->str, name->len, _rp);
+            SAFEALIGN_SET_STRING(&buf[rp], name->str, name->len, &rp);
+            talloc_free(name);
 
             num_members++;
         }
     }
 
+    *_members = buf;
+    *_members_size = rp;
+    *_num_members = num_members;
+
     ret = EOK;
 
 done:
-    *_num_members = num_members;
+    if (ret != EOK) {
+        talloc_free(buf);
+    }
     talloc_free(tmp_ctx);
 
     return ret;
@@ -201,14 +257,14 @@ nss_protocol_fill_grent(struct nss_ctx *nss_ctx,
     struct ldb_message *msg;
     struct sized_string *name;
     struct sized_string pwfield;
+    const char *sysdb_name;
     uint32_t gid;
     uint32_t num_results;
     uint32_t num_members;
-    char *members;
+    uint8_t *members_buf;
     size_t members_size;
+    size_t reserve;
     size_t rp;
-    size_t rp_members;
-    size_t rp_num_members;
     size_t body_len;
     uint8_t *body;
     int i;
@@ -219,10 +275,32 @@ nss_protocol_fill_grent(struct nss_ctx *nss_ctx,
         return ENOMEM;
     }
 
+    /* Password field content. */
+    to_sized_string(&pwfield, nss_get_pwfield(nss_ctx, result->domain));
+
+    /* Size the packet for the whole result up front. */
+    reserve = 2 * sizeof(uint32_t);
+    for (i = 0; i < result->count; i++) {
+        msg = result->msgs[i];
+        sysdb_name = ldb_msg_find_attr_as_string(msg, SYSDB_NAME, "");
+
+        reserve += 2 * sizeof(uint32_t) + strlen(sysdb_name) + 1
+                       + pwfield.len;
+        members_size = nss_get_members_size(result->domain, msg);
+        if (result->count > 1 || members_size < NSS_MEMBERS_TAIL_SIZE) {
+            reserve += members_size;
+        }
+    }
+
+    ret = sss_packet_reserve(packet, reserve);
+    if (ret != EOK) {
+        goto done;
+    }
+
     /* First two fields (length and reserved), filled up later. */
     ret = sss_packet_grow(packet, 2 * sizeof(uint32_t));
     if (ret != EOK) {
-        return ret;
+        goto done;
     }
 
     rp = 2 * sizeof(uint32_t);
@@ -232,15 +310,19 @@ nss_protocol_fill_grent(struct nss_ctx *nss_ctx,
         talloc_free_children(tmp_ctx);
         msg = result->msgs[i];
 
-        /* Password field content. */
-        to_sized_string(&pwfield, nss_get_pwfield(nss_ctx, result->domain));
-
         ret = nss_get_grent(tmp_ctx, nss_ctx, result->domain, msg,
                             &gid, &name);
         if (ret != EOK) {
             continue;
         }
 
+        ret = nss_protocol_fill_members(tmp_ctx, nss_ctx, result->domain, msg,
+                                        name->str, &members_buf,
+                                        &members_size, &num_members);
+        if (ret != EOK) {
+            goto done;
+        }
+
         /* Adjust packet size: gid, num_members + string fields. */
 
         ret = sss_packet_grow(packet, 2 * sizeof(uint32_t)
@@ -254,23 +336,28 @@ nss_protocol_fill_grent(struct nss_ctx *nss_ctx,
         /* Fill packet. */
 
         SAFEALIGN_SET_UINT32(&body[rp], gid, &rp);
-
-        /* Remember pointer to number of members field. */
-        rp_num_members = rp;
-        SAFEALIGN_SET_UINT32(&body[rp], 0, &rp);
+        SAFEALIGN_SET_UINT32(&body[rp], num_members, &rp);
         SAFEALIGN_SET_STRING(&body[rp], name->str, name->len, &rp);
         SAFEALIGN_SET_STRING(&body[rp], pwfield.str, pwfield.len, &rp);
-        rp_members = rp;
 
-        /* Fill members. */
-        ret = nss_protocol_fill_members(packet, nss_ctx, result->domain, msg,
-                                        name->str, &rp, &num_members);
-        if (ret != EOK) {
-            goto done;
+        /* A large member list of a single group is the end of the reply,
+         * it is sent from its own buffer if the packet allows it. */
+        ret = ENOTSUP;
+        if (result->count == 1 && members_size >= NSS_MEMBERS_TAIL_SIZE) {
+            ret = sss_packet_set_tail(packet, members_buf, members_size);
         }
 
-        sss_packet_get_body(packet, &body, &body_len);
-        SAFEALIGN_SET_UINT32(&body[rp_num_members], num_members, NULL);
+        if (ret == ENOTSUP) {
+            ret = sss_packet_grow(packet, members_size);
+            if (ret != EOK) {
+                goto done;
+            }
+
+            sss_packet_get_body(packet, &body, &body_len);
+            safealign_memcpy(&body[rp], members_buf, members_size, &rp);
+        } else if (ret != EOK) {
+            goto done;
+        }
 
         num_results++;
 
@@ -278,11 +365,9 @@ nss_protocol_fill_grent(struct nss_ctx *nss_ctx,
          * requested. */
         if (!cmd_ctx->enumeration
                 && (cmd_ctx->flags & SSS_NSS_EX_FLAG_INVALIDATE_CACHE) == 0) {
-            members = (char *)&body[rp_members];
-            members_size = body_len - rp_members;
             ret = sss_mmap_cache_gr_store(&nss_ctx->grp_mc_ctx, name, &pwfield,
-                                          gid, num_members, members,
-                                          members_size);
+                                          gid, num_members,
+                                          (char *)members_buf, members_size);
             if (ret != EOK) {
                 DEBUG(SSSDBG_MINOR_FAILURE,
                       "Failed to store group %s (%s) in mem-cache [%d]: %s!\n",
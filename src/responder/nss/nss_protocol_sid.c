@@ -87,6 +87,73 @@ nss_get_id_type(struct nss_cmd_ctx *cmd_ctx,
     return EOK;
 }
 
+static errno_t
+nss_get_ad_name(TALLOC_CTX *mem_ctx,
+                struct resp_ctx *rctx,
+                struct cache_req_result *result,
+                struct sized_string **_sz_name);
+
+/* Stores the SID, name and ID of the object in the memory cache so that
+ * libsss_nss_idmap can answer subsequent lookups without contacting the
+ * responder. Well known objects and lookups which override the ID type
+ * (e.g. by certificate) are not cached. */
+static void
+nss_sid_mc_store(struct nss_ctx *nss_ctx,
+                 struct nss_cmd_ctx *cmd_ctx,
+                 struct cache_req_result *result,
+                 enum sss_id_type id_type)
+{
+    struct ldb_message *msg;
+    struct sized_string *sz_name;
+    struct sized_string sz_sid;
+    const char *sid;
+    uint64_t id64;
+    errno_t ret;
+
+    if (nss_ctx->sid_mc_ctx == NULL
+            || cmd_ctx->sid_id_type != SSS_ID_TYPE_NOT_SPECIFIED
+            || result->well_known_object
+            || result->ldb_result == NULL
+            || result->count != 1) {
+        return;
+    }
+
+    msg = result->msgs[0];
+
+    sid = ldb_msg_find_attr_as_string(msg, SYSDB_SID_STR, NULL);
+    if (sid == NULL) {
+        return;
+    }
+
+    if (id_type == SSS_ID_TYPE_GID) {
+        id64 = ldb_msg_find_attr_as_uint64(msg, SYSDB_GIDNUM, 0);
+    } else {
+        id64 = ldb_msg_find_attr_as_uint64(msg, SYSDB_UIDNUM, 0);
+    }
+
+    if (id64 == 0 || id64 >= UINT32_MAX) {
+        /* object without POSIX ID */
+        return;
+    }
+
+    ret = nss_get_ad_name(cmd_ctx, nss_ctx->rctx, result, &sz_name);
+    if (ret != EOK) {
+        return;
+    }
+
+    to_sized_string(&sz_sid, sid);
+
+    ret = sss_mmap_cache_sid_store(&nss_ctx->sid_mc_ctx, &sz_sid, sz_name,
+                                   id_type, (uint32_t)id64);
+    if (ret != EOK) {
+        DEBUG(SSSDBG_MINOR_FAILURE,
+              "Failed to store SID %s (%s) in mmap cache [%d]: %s!\n",
+              sid, sz_name->str, ret, sss_strerror(ret));
+    }
+
+    talloc_free(sz_name);
+}
+
 errno_t
 nss_protocol_fill_sid(struct nss_ctx *nss_ctx,
                       struct nss_cmd_ctx *cmd_ctx,
@@ -128,6 +195,8 @@ nss_protocol_fill_sid(struct nss_ctx *nss_ctx,
     SAFEALIGN_SET_UINT32(&body[rp], id_type, &rp);
     SAFEALIGN_SET_STRING(&body[rp], sz_sid.str, sz_sid.len, &rp);
 
+    nss_sid_mc_store(nss_ctx, cmd_ctx, result, id_type);
+
     return EOK;
 }
 
@@ -444,6 +513,8 @@ nss_protocol_fill_name(struct nss_ctx *nss_ctx,
 
     talloc_free(sz_name);
 
+    nss_sid_mc_store(nss_ctx, cmd_ctx, result, id_type);
+
     return EOK;
 }
 
@@ -498,6 +569,8 @@ nss_protocol_fill_id(struct nss_ctx *nss_ctx,
     SAFEALIGN_SET_UINT32(&body[rp], id_type, &rp);
     SAFEALIGN_SET_UINT32(&body[rp], id, &rp);
 
+    nss_sid_mc_store(nss_ctx, cmd_ctx, result, id_type);
+
     return EOK;
 }
 
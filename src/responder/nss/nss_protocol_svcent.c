@@ -250,6 +250,19 @@ nss_protocol_fill_svcent(struct nss_ctx *nss_ctx,
         }
 
         num_results++;
+
+        /* Do not store entry in memory cache during enumeration. */
+        if (!cmd_ctx->enumeration) {
+            ret = sss_mmap_cache_svc_store(&nss_ctx->svc_mc_ctx, &name,
+                                           &protocol, port, num_aliases,
+                                           aliases);
+            if (ret != EOK) {
+                DEBUG(SSSDBG_MINOR_FAILURE,
+                      "Failed to store service %s/%s (%s) in mmap cache "
+                      "[%d]: %s!\n", name.str, protocol.str,
+                      result->domain->name, ret, sss_strerror(ret));
+            }
+        }
     }
 
     ret = EOK;
@@ -57,6 +57,9 @@ nss_clear_memcache(TALLOC_CTX *mem_ctx,
     int memcache_timeout;
     errno_t ret;
 
+    /* sss_cache has just expired objects in sysdb. */
+    cache_req_lru_flush(nctx->rctx->cache_req_lru);
+
     ret = unlink(SSS_NSS_MCACHE_DIR"/"CLEAR_MC_FLAG);
     if (ret != 0) {
         ret = errno;
@@ -115,6 +118,26 @@ nss_clear_memcache(TALLOC_CTX *mem_ctx,
         return ret;
     }
 
+    ret = sss_mmap_cache_reinit(nctx, nctx->mc_uid, nctx->mc_gid,
+                                SSS_MC_CACHE_ELEMENTS,
+                                (time_t)memcache_timeout,
+                                &nctx->svc_mc_ctx);
+    if (ret != EOK) {
+        DEBUG(SSSDBG_CRIT_FAILURE,
+              "services mmap cache invalidation failed\n");
+        return ret;
+    }
+
+    ret = sss_mmap_cache_reinit(nctx, nctx->mc_uid, nctx->mc_gid,
+                                SSS_MC_CACHE_ELEMENTS,
+                                (time_t)memcache_timeout,
+                                &nctx->sid_mc_ctx);
+    if (ret != EOK) {
+        DEBUG(SSSDBG_CRIT_FAILURE,
+              "sid mmap cache invalidation failed\n");
+        return ret;
+    }
+
     return EOK;
 }
 
@@ -126,6 +149,7 @@ nss_clear_netgroup_hash_table(TALLOC_CTX *mem_ctx,
     DEBUG(SSSDBG_TRACE_FUNC, "Invalidating netgroup hash table\n");
 
     sss_ptr_hash_delete_all(nss_ctx->netgrent, false);
+    cache_req_lru_flush(nss_ctx->rctx->cache_req_lru);
 
     return EOK;
 }
@@ -141,6 +165,11 @@ static int nss_get_config(struct nss_ctx *nctx,
                          &nctx->enum_cache_timeout);
     if (ret != EOK) goto done;
 
+    ret = confdb_get_int(cdb, CONFDB_NSS_CONF_ENTRY,
+                         CONFDB_NSS_ENUM_PAGE_SIZE, 0,
+                         &nctx->enum_page_size);
+    if (ret != EOK) goto done;
+
     ret = confdb_get_bool(cdb, CONFDB_NSS_CONF_ENTRY,
                          CONFDB_NSS_FILTER_USERS_IN_GROUPS, true,
                          &nctx->filter_users_in_groups);
@@ -267,6 +296,24 @@ static int setup_memcaches(struct nss_ctx *nctx)
         DEBUG(SSSDBG_CRIT_FAILURE, "initgroups mmap cache is DISABLED\n");
     }
 
+    ret = sss_mmap_cache_init(nctx, "services",
+                              nctx->mc_uid, nctx->mc_gid,
+                              SSS_MC_SERVICES,
+                              SSS_MC_CACHE_ELEMENTS, (time_t)memcache_timeout,
+                              &nctx->svc_mc_ctx);
+    if (ret) {
+        DEBUG(SSSDBG_CRIT_FAILURE, "services mmap cache is DISABLED\n");
+    }
+
+    ret = sss_mmap_cache_init(nctx, "sid",
+                              nctx->mc_uid, nctx->mc_gid,
+                              SSS_MC_SID,
+                              SSS_MC_CACHE_ELEMENTS, (time_t)memcache_timeout,
+                              &nctx->sid_mc_ctx);
+    if (ret) {
+        DEBUG(SSSDBG_CRIT_FAILURE, "sid mmap cache is DISABLED\n");
+    }
+
     return EOK;
 }
 
@@ -370,6 +417,57 @@ done:
     return ret;
 }
 
+/* The in-memory result cache is only flushed by the NSS invalidation
+ * methods (sss_cache, memory cache and negative cache resets), so no other
+ * responder may use it. */
+static errno_t nss_init_result_cache(struct resp_ctx *rctx)
+{
+    int size;
+    int timeout;
+    errno_t ret;
+
+    ret = confdb_get_int(rctx->cdb, CONFDB_NSS_CONF_ENTRY,
+                         CONFDB_NSS_RESULT_CACHE_SIZE,
+                         CONFDB_NSS_RESULT_CACHE_SIZE_DEFAULT,
+                         &size);
+    if (ret != EOK) {
+        DEBUG(SSSDBG_CRIT_FAILURE,
+              "Cannot get the result cache size [%d]: %s\n",
+              ret, sss_strerror(ret));
+        return ret;
+    }
+
+    ret = confdb_get_int(rctx->cdb, CONFDB_NSS_CONF_ENTRY,
+                         CONFDB_NSS_RESULT_CACHE_TIMEOUT,
+                         CONFDB_NSS_RESULT_CACHE_TIMEOUT_DEFAULT,
+                         &timeout);
+    if (ret != EOK) {
+        DEBUG(SSSDBG_CRIT_FAILURE,
+              "Cannot get the result cache timeout [%d]: %s\n",
+              ret, sss_strerror(ret));
+        return ret;
+    }
+
+    if (size <= 0 || timeout <= 0) {
+        DEBUG(SSSDBG_CONF_SETTINGS, "Result cache is disabled\n");
+        return EOK;
+    }
+
+    ret = cache_req_lru_init(rctx, size, timeout, &rctx->cache_req_lru);
+    if (ret != EOK) {
+        DEBUG(SSSDBG_CRIT_FAILURE,
+              "Unable to create the result cache [%d]: %s\n",
+              ret, sss_strerror(ret));
+        return ret;
+    }
+
+    DEBUG(SSSDBG_CONF_SETTINGS,
+          "Result cache holds up to %d entries for %d seconds\n",
+          size, timeout);
+
+    return EOK;
+}
+
 int nss_process_init(TALLOC_CTX *mem_ctx,
                      struct tevent_context *ev,
                      struct confdb_ctx *cdb)
@@ -487,6 +585,12 @@ int nss_process_init(TALLOC_CTX *mem_ctx,
         goto fail;
     }
 
+    ret = nss_init_result_cache(rctx);
+    if (ret != EOK) {
+        DEBUG(SSSDBG_FATAL_FAILURE, "fatal error initializing result cache\n");
+        goto fail;
+    }
+
     /* Set up file descriptor limits */
     ret = confdb_get_int(nctx->rctx->cdb,
                          CONFDB_NSS_CONF_ENTRY,
@@ -34,6 +34,11 @@
 #define SSS_AVG_GROUP_PAYLOAD (MC_SLOT_SIZE * 3)
 /* average place for 40 supplementary groups + 2 names */
 #define SSS_AVG_INITGROUP_PAYLOAD (MC_SLOT_SIZE * 5)
+/* service name, protocol and a couple of aliases */
+#define SSS_AVG_SERVICES_PAYLOAD (MC_SLOT_SIZE * 3)
+/* SID and fully qualified name, each object is stored twice (keyed by SID
+ * and keyed by name) */
+#define SSS_AVG_SID_PAYLOAD (MC_SLOT_SIZE * 6)
 
 #define MC_NEXT_BARRIER(val) ((((val) + 1) & 0x00ffffff) | 0xf0000000)
 
@@ -482,6 +487,12 @@ static errno_t sss_mc_get_strs_offset(struct sss_mc_ctx *mcc,
     case SSS_MC_INITGROUPS:
         *_offset = offsetof(struct sss_mc_initgr_data, gids);
         return EOK;
+    case SSS_MC_SERVICES:
+        *_offset = offsetof(struct sss_mc_svc_data, strs);
+        return EOK;
+    case SSS_MC_SID:
+        *_offset = offsetof(struct sss_mc_sid_data, strs);
+        return EOK;
     default:
         DEBUG(SSSDBG_FATAL_FAILURE, "Unknown memory cache type.\n");
         return EINVAL;
@@ -502,12 +513,31 @@ static errno_t sss_mc_get_strs_len(struct sss_mc_ctx *mcc,
     case SSS_MC_INITGROUPS:
         *_len = ((struct sss_mc_initgr_data *)&rec->data)->data_len;
         return EOK;
+    case SSS_MC_SERVICES:
+        *_len = ((struct sss_mc_svc_data *)&rec->data)->strs_len;
+        return EOK;
+    case SSS_MC_SID:
+        *_len = ((struct sss_mc_sid_data *)&rec->data)->strs_len;
+        return EOK;
     default:
         DEBUG(SSSDBG_FATAL_FAILURE, "Unknown memory cache type.\n");
         return EINVAL;
     }
 }
 
+/* Service records are looked up by name and protocol, but clients may
+ * omit the protocol, so the key is "name\0protocol\0" and only the name
+ * part of it is hashed. All other record types use the whole key. */
+static size_t sss_mc_key_hash_len(struct sss_mc_ctx *mcc,
+                                  struct sized_string *key)
+{
+    if (mcc->type == SSS_MC_SERVICES) {
+        return strnlen(key->str, key->len - 1) + 1;
+    }
+
+    return key->len;
+}
+
 static struct sss_mc_rec *sss_mc_find_record(struct sss_mc_ctx *mcc,
                                              struct sized_string *key)
 {
@@ -521,7 +551,7 @@ static struct sss_mc_rec *sss_mc_find_record(struct sss_mc_ctx *mcc,
     uint8_t *max_addr;
     errno_t ret;
 
-    hash = sss_mc_hash(mcc, key->str, key->len);
+    hash = sss_mc_hash(mcc, key->str, sss_mc_key_hash_len(mcc, key));
 
     slot = mcc->hash_table[hash];
     if (!MC_SLOT_WITHIN_BOUNDS(slot, mcc->dt_size)) {
@@ -577,7 +607,10 @@ static struct sss_mc_rec *sss_mc_find_record(struct sss_mc_ctx *mcc,
             return NULL;
         }
 
-        if (strcmp(key->str, t_key) == 0) {
+        /* the key may span several consecutive strings (see
+         * sss_mc_key_hash_len()), so compare it as a whole */
+        if (key->len <= strs_offset + strs_len - name_ptr
+                && memcmp(key->str, t_key, key->len) == 0) {
             break;
         }
 
@@ -1056,6 +1089,433 @@ errno_t sss_mmap_cache_initgr_invalidate(struct sss_mc_ctx *mcc,
     return sss_mmap_cache_invalidate(mcc, name);
 }
 
+/***************************************************************************
+ * services map
+ ***************************************************************************/
+
+errno_t sss_mmap_cache_svc_store(struct sss_mc_ctx **_mcc,
+                                 struct sized_string *name,
+                                 struct sized_string *protocol,
+                                 uint16_t port, uint32_t num_aliases,
+                                 struct sized_string *aliases)
+{
+    struct sss_mc_ctx *mcc = *_mcc;
+    struct sss_mc_rec *rec;
+    struct sss_mc_svc_data *data;
+    struct sized_string key;
+    struct sized_string portkey;
+    char portstr[6];
+    char *keybuf;
+    size_t data_len;
+    size_t rec_len;
+    size_t pos;
+    uint32_t i;
+    int ret;
+
+    if (mcc == NULL) {
+        /* cache not initialized? */
+        return EINVAL;
+    }
+
+    ret = snprintf(portstr, 6, "%u", (unsigned int)port);
+    if (ret > 5) {
+        return EINVAL;
+    }
+    to_sized_string(&portkey, portstr);
+
+    data_len = name->len + protocol->len;
+    for (i = 0; i < num_aliases; i++) {
+        data_len += aliases[i].len;
+    }
+    rec_len = sizeof(struct sss_mc_rec) +
+              sizeof(struct sss_mc_svc_data) +
+              data_len;
+    if (rec_len > mcc->dt_size) {
+        return ENOMEM;
+    }
+
+    /* services are unique by name and protocol, the key is "name\0proto\0"
+     * which is exactly how the strings are laid out in the record */
+    keybuf = talloc_size(NULL, name->len + protocol->len);
+    if (keybuf == NULL) {
+        return ENOMEM;
+    }
+    memcpy(keybuf, name->str, name->len);
+    memcpy(keybuf + name->len, protocol->str, protocol->len);
+    key.str = keybuf;
+    key.len = name->len + protocol->len;
+
+    ret = sss_mc_get_record(_mcc, rec_len, &key, &rec);
+    talloc_free(keybuf);
+    if (ret != EOK) {
+        return ret;
+    }
+
+    data = (struct sss_mc_svc_data *)rec->data;
+    pos = 0;
+
+    MC_RAISE_BARRIER(rec);
+
+    /* header */
+    sss_mmap_set_rec_header(mcc, rec, rec_len, mcc->valid_time_slot,
+                            name->str, name->len, portkey.str, portkey.len);
+
+    /* services struct */
+    data->name = MC_PTR_DIFF(data->strs, data);
+    data->port = port;
+    data->aliases = num_aliases;
+    data->strs_len = data_len;
+    memcpy(&data->strs[pos], name->str, name->len);
+    pos += name->len;
+    memcpy(&data->strs[pos], protocol->str, protocol->len);
+    pos += protocol->len;
+    for (i = 0; i < num_aliases; i++) {
+        memcpy(&data->strs[pos], aliases[i].str, aliases[i].len);
+        pos += aliases[i].len;
+    }
+
+    MC_LOWER_BARRIER(rec);
+
+    /* finally chain the rec in the hash table */
+    sss_mmap_chain_in_rec(mcc, rec);
+
+    return EOK;
+}
+
+/* A service may be cached once per protocol, so all records matching
+ * either the name or the port are dropped. */
+static errno_t sss_mmap_cache_svc_invalidate_key(struct sss_mc_ctx *mcc,
+                                                 const char *key,
+                                                 size_t key_len,
+                                                 const char *name,
+                                                 uint16_t port)
+{
+    struct sss_mc_rec *rec;
+    struct sss_mc_svc_data *data;
+    uint32_t hash;
+    uint32_t slot;
+    uint32_t next;
+    errno_t ret = ENOENT;
+
+    hash = sss_mc_hash(mcc, key, key_len);
+
+    slot = mcc->hash_table[hash];
+    if (!MC_SLOT_WITHIN_BOUNDS(slot, mcc->dt_size)) {
+        return ENOENT;
+    }
+
+    while (slot != MC_INVALID_VAL) {
+        if (!MC_SLOT_WITHIN_BOUNDS(slot, mcc->dt_size)) {
+            DEBUG(SSSDBG_FATAL_FAILURE, "Corrupted memcache.\n");
+            sss_mc_save_corrupted(mcc);
+            sss_mmap_cache_reset(mcc);
+            return ENOENT;
+        }
+
+        rec = MC_SLOT_TO_PTR(mcc->data_table, slot, struct sss_mc_rec);
+        data = (struct sss_mc_svc_data *)(&rec->data);
+        next = sss_mc_next_slot_with_hash(rec, hash);
+
+        if (name != NULL) {
+            if (rec->hash1 == hash
+                    && data->name == MC_PTR_DIFF(data->strs, data)
+                    && strncmp(data->strs, name, data->strs_len) == 0) {
+                sss_mc_invalidate_rec(mcc, rec);
+                ret = EOK;
+            }
+        } else if (rec->hash2 == hash && data->port == port) {
+            sss_mc_invalidate_rec(mcc, rec);
+            ret = EOK;
+        }
+
+        slot = next;
+    }
+
+    return ret;
+}
+
+errno_t sss_mmap_cache_svc_invalidate(struct sss_mc_ctx *mcc,
+                                      struct sized_string *name)
+{
+    if (mcc == NULL) {
+        /* cache not initialized? */
+        return EINVAL;
+    }
+
+    return sss_mmap_cache_svc_invalidate_key(mcc, name->str, name->len,
+                                             name->str, 0);
+}
+
+errno_t sss_mmap_cache_svc_invalidate_port(struct sss_mc_ctx *mcc,
+                                           uint16_t port)
+{
+    char portstr[6];
+    int ret;
+
+    if (mcc == NULL) {
+        /* cache not initialized? */
+        return EINVAL;
+    }
+
+    ret = snprintf(portstr, 6, "%u", (unsigned int)port);
+    if (ret > 5) {
+        return EINVAL;
+    }
+
+    return sss_mmap_cache_svc_invalidate_key(mcc, portstr, ret + 1,
+                                             NULL, port);
+}
+
+/***************************************************************************
+ * sid map
+ ***************************************************************************/
+
+/* Every object is stored in two records sharing the same "sid\0name\0"
+ * layout. The SID-keyed record is chained by SID (hash1) and ID (hash2),
+ * the name-keyed record by name (hash1) and SID (hash2). data->name
+ * tells which one is which. */
+static errno_t sss_mmap_cache_sid_store_rec(struct sss_mc_ctx **_mcc,
+                                            struct sized_string *sid,
+                                            struct sized_string *name,
+                                            uint32_t type, uint32_t id,
+                                            bool by_name)
+{
+    struct sss_mc_ctx *mcc = *_mcc;
+    struct sss_mc_rec *rec;
+    struct sss_mc_sid_data *data;
+    struct sized_string *key;
+    struct sized_string *key2;
+    struct sized_string idkey;
+    char idstr[11];
+    size_t data_len;
+    size_t rec_len;
+    int ret;
+
+    ret = snprintf(idstr, 11, "%u", (unsigned int)id);
+    if (ret > 10) {
+        return EINVAL;
+    }
+    to_sized_string(&idkey, idstr);
+
+    data_len = sid->len + name->len;
+    rec_len = sizeof(struct sss_mc_rec) +
+              sizeof(struct sss_mc_sid_data) +
+              data_len;
+    if (rec_len > mcc->dt_size) {
+        return ENOMEM;
+    }
+
+    if (by_name) {
+        key = name;
+        key2 = sid;
+    } else {
+        key = sid;
+        key2 = &idkey;
+    }
+
+    ret = sss_mc_get_record(_mcc, rec_len, key, &rec);
+    if (ret != EOK) {
+        return ret;
+    }
+
+    data = (struct sss_mc_sid_data *)rec->data;
+
+    MC_RAISE_BARRIER(rec);
+
+    /* header */
+    sss_mmap_set_rec_header(mcc, rec, rec_len, mcc->valid_time_slot,
+                            key->str, key->len, key2->str, key2->len);
+
+    /* sid struct */
+    data->name = MC_PTR_DIFF(data->strs, data) + (by_name ? sid->len : 0);
+    data->type = type;
+    data->id = id;
+    data->reserved = MC_INVALID_VAL32;
+    data->strs_len = data_len;
+    memcpy(data->strs, sid->str, sid->len);
+    memcpy(&data->strs[sid->len], name->str, name->len);
+
+    MC_LOWER_BARRIER(rec);
+
+    /* finally chain the rec in the hash table */
+    sss_mmap_chain_in_rec(mcc, rec);
+
+    return EOK;
+}
+
+errno_t sss_mmap_cache_sid_store(struct sss_mc_ctx **_mcc,
+                                 struct sized_string *sid,
+                                 struct sized_string *name,
+                                 uint32_t type, uint32_t id)
+{
+    errno_t ret;
+
+    if (*_mcc == NULL) {
+        /* cache not initialized? */
+        return EINVAL;
+    }
+
+    ret = sss_mmap_cache_sid_store_rec(_mcc, sid, name, type, id, false);
+    if (ret != EOK) {
+        return ret;
+    }
+
+    return sss_mmap_cache_sid_store_rec(_mcc, sid, name, type, id, true);
+}
+
+/* Invalidates all records on the chain of key which match either the SID,
+ * the name or (if key is an ID) the ID. The SIDs of the invalidated
+ * records are returned so that the companion records can be dropped as
+ * well. */
+static errno_t sss_mmap_cache_sid_invalidate_chain(TALLOC_CTX *mem_ctx,
+                                                   struct sss_mc_ctx *mcc,
+                                                   struct sized_string *key,
+                                                   bool by_id, uint32_t id,
+                                                   char ***_sids,
+                                                   size_t *_num_sids)
+{
+    struct sss_mc_rec *rec;
+    struct sss_mc_sid_data *data;
+    const char *rec_sid;
+    const char *rec_name;
+    size_t sid_len;
+    uint32_t hash;
+    uint32_t slot;
+    uint32_t next;
+    bool match;
+    char **sids = *_sids;
+    size_t num_sids = *_num_sids;
+    errno_t ret = ENOENT;
+
+    hash = sss_mc_hash(mcc, key->str, key->len);
+
+    slot = mcc->hash_table[hash];
+    if (!MC_SLOT_WITHIN_BOUNDS(slot, mcc->dt_size)) {
+        return ENOENT;
+    }
+
+    while (slot != MC_INVALID_VAL) {
+        if (!MC_SLOT_WITHIN_BOUNDS(slot, mcc->dt_size)) {
+            DEBUG(SSSDBG_FATAL_FAILURE, "Corrupted memcache.\n");
+            sss_mc_save_corrupted(mcc);
+            sss_mmap_cache_reset(mcc);
+            return ENOENT;
+        }
+
+        rec = MC_SLOT_TO_PTR(mcc->data_table, slot, struct sss_mc_rec);
+        data = (struct sss_mc_sid_data *)(&rec->data);
+        next = sss_mc_next_slot_with_hash(rec, hash);
+
+        rec_sid = data->strs;
+        sid_len = strnlen(rec_sid, data->strs_len) + 1;
+        if (sid_len >= data->strs_len) {
+            slot = next;
+            continue;
+        }
+        rec_name = data->strs + sid_len;
+
+        if (by_id) {
+            match = (rec->hash2 == hash && data->id == id
+                     && data->name == MC_PTR_DIFF(data->strs, data));
+        } else {
+            match = (strncmp(rec_sid, key->str, sid_len) == 0
+                     || strncmp(rec_name, key->str,
+                                data->strs_len - sid_len) == 0);
+        }
+
+        if (match) {
+            if (strcmp(rec_sid, key->str) != 0) {
+                sids = talloc_realloc(mem_ctx, sids, char *, num_sids + 1);
+                if (sids == NULL) {
+                    return ENOMEM;
+                }
+                sids[num_sids] = talloc_strdup(sids, rec_sid);
+                if (sids[num_sids] == NULL) {
+                    return ENOMEM;
+                }
+                num_sids++;
+                *_sids = sids;
+                *_num_sids = num_sids;
+            }
+
+            sss_mc_invalidate_rec(mcc, rec);
+            ret = EOK;
+        }
+
+        slot = next;
+    }
+
+    return ret;
+}
+
+static errno_t sss_mmap_cache_sid_invalidate_key(struct sss_mc_ctx *mcc,
+                                                 struct sized_string *key,
+                                                 bool by_id, uint32_t id)
+{
+    TALLOC_CTX *tmp_ctx;
+    struct sized_string sid_key;
+    char **sids = NULL;
+    size_t num_sids = 0;
+    char **unused = NULL;
+    size_t num_unused = 0;
+    size_t i;
+    errno_t ret;
+
+    if (mcc == NULL) {
+        /* cache not initialized? */
+        return EINVAL;
+    }
+
+    tmp_ctx = talloc_new(NULL);
+    if (tmp_ctx == NULL) {
+        return ENOMEM;
+    }
+
+    ret = sss_mmap_cache_sid_invalidate_chain(tmp_ctx, mcc, key, by_id, id,
+                                              &sids, &num_sids);
+    if (ret != EOK) {
+        goto done;
+    }
+
+    /* drop the companion records chained by the SID */
+    for (i = 0; i < num_sids; i++) {
+        to_sized_string(&sid_key, sids[i]);
+        ret = sss_mmap_cache_sid_invalidate_chain(tmp_ctx, mcc, &sid_key,
+                                                  false, 0,
+                                                  &unused, &num_unused);
+        if (ret != EOK && ret != ENOENT) {
+            goto done;
+        }
+    }
+
+    ret = EOK;
+
+done:
+    talloc_free(tmp_ctx);
+    return ret;
+}
+
+errno_t sss_mmap_cache_sid_invalidate(struct sss_mc_ctx *mcc,
+                                      struct sized_string *key)
+{
+    return sss_mmap_cache_sid_invalidate_key(mcc, key, false, 0);
+}
+
+errno_t sss_mmap_cache_sid_invalidate_id(struct sss_mc_ctx *mcc, uint32_t id)
+{
+    struct sized_string idkey;
+    char idstr[11];
+    int ret;
+
+    ret = snprintf(idstr, 11, "%u", (unsigned int)id);
+    if (ret > 10) {
+        return EINVAL;
+    }
+    to_sized_string(&idkey, idstr);
+
+    return sss_mmap_cache_sid_invalidate_key(mcc, &idkey, true, id);
+}
+
 /***************************************************************************
  * initialization
  ***************************************************************************/
@@ -1268,6 +1728,12 @@ errno_t sss_mmap_cache_init(TALLOC_CTX *mem_ctx, const char *name,
     case SSS_MC_INITGROUPS:
         payload = SSS_AVG_INITGROUP_PAYLOAD;
         break;
+    case SSS_MC_SERVICES:
+        payload = SSS_AVG_SERVICES_PAYLOAD;
+        break;
+    case SSS_MC_SID:
+        payload = SSS_AVG_SID_PAYLOAD;
+        break;
     default:
         return EINVAL;
     }
@@ -167,6 +167,8 @@ static int pam_process_init(TALLOC_CTX *mem_ctx,
     struct pam_ctx *pctx;
     int ret;
     int id_timeout;
+    int token_cache_timeout;
+    int token_cache_size;
     int fd_limit;
 
     pam_cmds = get_pam_cmds();
@@ -221,6 +223,30 @@ static int pam_process_init(TALLOC_CTX *mem_ctx,
 
     pctx->id_timeout = (size_t)id_timeout;
 
+    /* Set up the cache of verified cached credentials */
+    ret = confdb_get_int(cdb, CONFDB_PAM_CONF_ENTRY,
+                         CONFDB_PAM_TOKEN_CACHE_TIMEOUT,
+                         CONFDB_PAM_TOKEN_CACHE_TIMEOUT_DEFAULT,
+                         &token_cache_timeout);
+    if (ret != EOK) goto done;
+
+    ret = confdb_get_int(cdb, CONFDB_PAM_CONF_ENTRY,
+                         CONFDB_PAM_TOKEN_CACHE_SIZE,
+                         CONFDB_PAM_TOKEN_CACHE_SIZE_DEFAULT,
+                         &token_cache_size);
+    if (ret != EOK) goto done;
+
+    if (token_cache_timeout > 0 && token_cache_size > 0) {
+        ret = pam_token_cache_init(pctx, token_cache_size,
+                                   token_cache_timeout, &pctx->token_cache);
+        if (ret != EOK) {
+            DEBUG(SSSDBG_FATAL_FAILURE,
+                  "Could not create token cache: [%s]\n",
+                  sss_strerror(ret));
+            goto done;
+        }
+    }
+
     ret = sss_ncache_prepopulate(pctx->rctx->ncache, cdb, pctx->rctx);
     if (ret != EOK) {
         goto done;
@@ -29,6 +29,7 @@
 #include "lib/certmap/sss_certmap.h"
 
 struct pam_auth_req;
+struct pam_token_cache;
 
 typedef void (pam_dp_callback_t)(struct pam_auth_req *preq);
 
@@ -54,6 +55,9 @@ struct pam_ctx {
 
     char **prompting_config_sections;
     int num_prompting_config_sections;
+
+    /* Recently verified cached credentials, NULL if disabled. */
+    struct pam_token_cache *token_cache;
 };
 
 struct pam_auth_req {
@@ -86,6 +90,29 @@ int LOCAL_pam_handler(struct pam_auth_req *preq);
 
 errno_t p11_child_init(struct pam_ctx *pctx);
 
+errno_t pam_token_cache_init(TALLOC_CTX *mem_ctx,
+                             uint32_t size,
+                             uint32_t timeout,
+                             struct pam_token_cache **_cache);
+
+/* True if the password of the user was successfully checked against the
+ * cached credentials recently. */
+bool pam_token_cache_check(struct pam_token_cache *cache,
+                           struct sss_domain_info *domain,
+                           const char *user,
+                           const char *password,
+                           time_t *_expire_date);
+
+void pam_token_cache_add(struct pam_token_cache *cache,
+                         struct sss_domain_info *domain,
+                         const char *user,
+                         const char *password,
+                         time_t expire_date);
+
+void pam_token_cache_remove(struct pam_token_cache *cache,
+                            struct sss_domain_info *domain,
+                            const char *user);
+
 struct cert_auth_info;
 const char *sss_cai_get_cert(struct cert_auth_info *i);
 const char *sss_cai_get_token_name(struct cert_auth_info *i);
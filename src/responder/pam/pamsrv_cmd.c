@@ -812,6 +812,16 @@ static void pam_reply(struct pam_auth_req *preq)
           "this result might be changed during processing\n",
           pd->pam_status, pam_strerror(NULL, pd->pam_status));
 
+    /* The backend handled the authentication and might have cached a new
+     * password, do not accept the old one from memory. */
+    if (pd->cmd == SSS_PAM_AUTHENTICATE
+            && preq->domain != NULL
+            && !preq->use_cached_auth
+            && !pd->offline_auth
+            && pd->pam_status != PAM_AUTHINFO_UNAVAIL) {
+        pam_token_cache_remove(pctx->token_cache, preq->domain, pd->user);
+    }
+
     if (pd->cmd == SSS_PAM_AUTHENTICATE
             && !preq->cert_auth_local
             && (pd->pam_status == PAM_AUTHINFO_UNAVAIL
@@ -867,10 +877,26 @@ static void pam_reply(struct pam_auth_req *preq)
                     goto done;
                 }
 
-                ret = sysdb_cache_auth(preq->domain,
-                                       pd->user, password,
-                                       pctx->rctx->cdb, false,
-                                       &exp_date, &delay_until);
+                if (pam_token_cache_check(pctx->token_cache, preq->domain,
+                                          pd->user, password, &exp_date)) {
+                    DEBUG(SSSDBG_TRACE_FUNC, "Cached credentials of [%s] "
+                          "were verified recently\n", pd->user);
+                    ret = EOK;
+                } else {
+                    ret = sysdb_cache_auth(preq->domain,
+                                           pd->user, password,
+                                           pctx->rctx->cdb, false,
+                                           &exp_date, &delay_until);
+                    if (ret == EOK) {
+                        pam_token_cache_add(pctx->token_cache, preq->domain,
+                                            pd->user, password, exp_date);
+                    } else {
+                        /* A wrong password must be checked against the
+                         * cache to count the failed login attempts. */
+                        pam_token_cache_remove(pctx->token_cache,
+                                               preq->domain, pd->user);
+                    }
+                }
 
                 pam_handle_cached_login(preq, ret, exp_date, delay_until,
                                         use_cached_auth);
@@ -909,6 +935,8 @@ static void pam_reply(struct pam_auth_req *preq)
     }
 
     if (pd->pam_status == PAM_SUCCESS && pd->cmd == SSS_PAM_CHAUTHTOK) {
+        pam_token_cache_remove(pctx->token_cache, preq->domain, pd->user);
+
         ret = pam_null_last_online_auth_with_curr_token(preq->domain,
                                                         pd->user);
         if (ret != EOK) {
@@ -0,0 +1,341 @@
+/*
+   SSSD
+
+   PAM Responder - cache of recently verified cached credentials
+
+   Copyright (C) 2026 Red Hat
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <talloc.h>
+#include <time.h>
+
+#include "util/util.h"
+#include "util/crypto/sss_crypto.h"
+#include "responder/pam/pamsrv.h"
+
+/* Checking a password against the cached credentials computes the salted
+ * SHA512 hash with thousands of rounds and updates the cache. Services
+ * such as mail servers authenticate the same user over and over, so the
+ * last successful check of each user is remembered for a short time.
+ *
+ * Only an HMAC of the user name and the password is kept, the key is
+ * random and never leaves the process. */
+
+struct pam_token_cache_entry {
+    struct pam_token_cache_entry *prev;
+    struct pam_token_cache_entry *next;
+
+    char *key;
+    unsigned char digest[SSS_SHA1_LENGTH];
+    time_t expire_date;
+    time_t expire;
+};
+
+struct pam_token_cache {
+    hash_table_t *table;
+
+    /* Oldest entry first. */
+    struct pam_token_cache_entry *entries;
+
+    unsigned char secret[SSS_SHA1_LENGTH];
+    uint32_t size;
+    uint32_t count;
+    time_t timeout;
+
+    uint64_t hits;
+    uint64_t misses;
+};
+
+static int pam_token_cache_destructor(struct pam_token_cache *cache)
+{
+    sss_erase_mem_securely(cache->secret, sizeof(cache->secret));
+    return 0;
+}
+
+errno_t pam_token_cache_init(TALLOC_CTX *mem_ctx,
+                             uint32_t size,
+                             uint32_t timeout,
+                             struct pam_token_cache **_cache)
+{
+    struct pam_token_cache *cache;
+    errno_t ret;
+
+    if (size == 0 || timeout == 0) {
+        return EINVAL;
+    }
+
+    cache = talloc_zero(mem_ctx, struct pam_token_cache);
+    if (cache == NULL) {
+        return ENOMEM;
+    }
+
+    ret = sss_hash_create(cache, size, &cache->table);
+    if (ret != EOK) {
+        talloc_free(cache);
+        return ret;
+    }
+
+    ret = sss_generate_csprng_buffer(cache->secret, sizeof(cache->secret));
+    if (ret != EOK) {
+        DEBUG(SSSDBG_OP_FAILURE,
+              "sss_generate_csprng_buffer() failed [%d]: %s\n",
+              ret, sss_strerror(ret));
+        talloc_free(cache);
+        return ret;
+    }
+    talloc_set_destructor(cache, pam_token_cache_destructor);
+
+    cache->size = size;
+    cache->timeout = timeout;
+
+    *_cache = cache;
+    return EOK;
+}
+
+static char *pam_token_cache_key(TALLOC_CTX *mem_ctx,
+                                 struct sss_domain_info *domain,
+                                 const char *user)
+{
+    return talloc_asprintf(mem_ctx, "%s/%s", domain->name, user);
+}
+
+static errno_t pam_token_cache_digest(struct pam_token_cache *cache,
+                                      const char *key,
+                                      const char *password,
+                                      unsigned char *digest)
+{
+    char *in;
+    size_t key_len;
+    size_t password_len;
+    errno_t ret;
+
+    key_len = strlen(key);
+    password_len = strlen(password);
+
+    /* The terminating zero of the key separates it from the password. */
+    in = talloc_size(NULL, key_len + 1 + password_len);
+    if (in == NULL) {
+        return ENOMEM;
+    }
+
+    memcpy(in, key, key_len + 1);
+    memcpy(in + key_len + 1, password, password_len);
+
+    ret = sss_hmac_sha1(cache->secret, sizeof(cache->secret),
+                        (unsigned char *)in, key_len + 1 + password_len,
+                        digest);
+
+    sss_erase_mem_securely(in, key_len + 1 + password_len);
+    talloc_free(in);
+
+    return ret;
+}
+
+static bool pam_token_cache_digest_equal(const unsigned char *a,
+                                         const unsigned char *b)
+{
+    unsigned char diff = 0;
+    size_t i;
+
+    /* Do not let the time of the comparison depend on the data. */
+    for (i = 0; i < SSS_SHA1_LENGTH; i++) {
+        diff |= a[i] ^ b[i];
+    }
+
+    return diff == 0;
+}
+
+static struct pam_token_cache_entry *
+pam_token_cache_lookup(struct pam_token_cache *cache, const char *str)
+{
+    hash_key_t key;
+    hash_value_t value;
+    int hret;
+
+    key.type = HASH_KEY_STRING;
+    key.str = discard_const(str);
+
+    hret = hash_lookup(cache->table, &key, &value);
+    if (hret != HASH_SUCCESS) {
+        if (hret != HASH_ERROR_KEY_NOT_FOUND) {
+            DEBUG(SSSDBG_MINOR_FAILURE, "hash_lookup failed [%d]: %s\n",
+                  hret, hash_error_string(hret));
+        }
+        return NULL;
+    }
+
+    return talloc_get_type(value.ptr, struct pam_token_cache_entry);
+}
+
+static void pam_token_cache_delete(struct pam_token_cache *cache,
+                                   struct pam_token_cache_entry *entry)
+{
+    hash_key_t key;
+    int hret;
+
+    key.type = HASH_KEY_STRING;
+    key.str = entry->key;
+
+    hret = hash_delete(cache->table, &key);
+    if (hret != HASH_SUCCESS) {
+        DEBUG(SSSDBG_CRIT_FAILURE,
+              "Unable to remove token cache entry [%d]: %s\n",
+              hret, hash_error_string(hret));
+    }
+
+    DLIST_REMOVE(cache->entries, entry);
+    cache->count--;
+
+    sss_erase_mem_securely(entry->digest, sizeof(entry->digest));
+    talloc_free(entry);
+}
+
+bool pam_token_cache_check(struct pam_token_cache *cache,
+                           struct sss_domain_info *domain,
+                           const char *user,
+                           const char *password,
+                           time_t *_expire_date)
+{
+    struct pam_token_cache_entry *entry;
+    unsigned char digest[SSS_SHA1_LENGTH];
+    char *key;
+    bool match = false;
+    errno_t ret;
+
+    if (cache == NULL) {
+        return false;
+    }
+
+    key = pam_token_cache_key(NULL, domain, user);
+    if (key == NULL) {
+        return false;
+    }
+
+    entry = pam_token_cache_lookup(cache, key);
+    if (entry != NULL && entry->expire < time(NULL)) {
+        pam_token_cache_delete(cache, entry);
+        entry = NULL;
+    }
+
+    if (entry != NULL) {
+        ret = pam_token_cache_digest(cache, key, password, digest);
+        if (ret == EOK) {
+            match = pam_token_cache_digest_equal(entry->digest, digest);
+        }
+        sss_erase_mem_securely(digest, sizeof(digest));
+    }
+
+    if (match) {
+        cache->hits++;
+        *_expire_date = entry->expire_date;
+    } else {
+        cache->misses++;
+    }
+
+    DEBUG(SSSDBG_TRACE_ALL, "Token cache %s for [%s] (%"PRIu64" hits, "
+          "%"PRIu64" misses)\n", match ? "hit" : "miss", key,
+          cache->hits, cache->misses);
+
+    talloc_free(key);
+    return match;
+}
+
+void pam_token_cache_add(struct pam_token_cache *cache,
+                         struct sss_domain_info *domain,
+                         const char *user,
+                         const char *password,
+                         time_t expire_date)
+{
+    struct pam_token_cache_entry *entry;
+    hash_key_t hkey;
+    hash_value_t value;
+    int hret;
+    errno_t ret;
+
+    if (cache == NULL) {
+        return;
+    }
+
+    pam_token_cache_remove(cache, domain, user);
+
+    while (cache->count >= cache->size && cache->entries != NULL) {
+        pam_token_cache_delete(cache, cache->entries);
+    }
+
+    /* Failures are not fatal, the next check just uses the cache again. */
+    entry = talloc_zero(cache, struct pam_token_cache_entry);
+    if (entry == NULL) {
+        return;
+    }
+
+    entry->key = pam_token_cache_key(entry, domain, user);
+    if (entry->key == NULL) {
+        talloc_free(entry);
+        return;
+    }
+
+    ret = pam_token_cache_digest(cache, entry->key, password, entry->digest);
+    if (ret != EOK) {
+        DEBUG(SSSDBG_MINOR_FAILURE, "sss_hmac_sha1() failed [%d]: %s\n",
+              ret, sss_strerror(ret));
+        talloc_free(entry);
+        return;
+    }
+    entry->expire_date = expire_date;
+    entry->expire = time(NULL) + cache->timeout;
+
+    hkey.type = HASH_KEY_STRING;
+    hkey.str = entry->key;
+    value.type = HASH_VALUE_PTR;
+    value.ptr = entry;
+
+    hret = hash_enter(cache->table, &hkey, &value);
+    if (hret != HASH_SUCCESS) {
+        DEBUG(SSSDBG_MINOR_FAILURE, "hash_enter failed [%d]: %s\n",
+              hret, hash_error_string(hret));
+        sss_erase_mem_securely(entry->digest, sizeof(entry->digest));
+        talloc_free(entry);
+        return;
+    }
+
+    DLIST_ADD_END(cache->entries, entry, struct pam_token_cache_entry *);
+    cache->count++;
+}
+
+void pam_token_cache_remove(struct pam_token_cache *cache,
+                            struct sss_domain_info *domain,
+                            const char *user)
+{
+    struct pam_token_cache_entry *entry;
+    char *key;
+
+    if (cache == NULL) {
+        return;
+    }
+
+    key = pam_token_cache_key(NULL, domain, user);
+    if (key == NULL) {
+        return;
+    }
+
+    entry = pam_token_cache_lookup(cache, key);
+    if (entry != NULL) {
+        DEBUG(SSSDBG_TRACE_FUNC, "Removing [%s] from token cache\n", key);
+        pam_token_cache_delete(cache, entry);
+    }
+
+    talloc_free(key);
+}
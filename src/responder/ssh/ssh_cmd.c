@@ -374,9 +374,7 @@ static void ssh_cmd_get_host_pubkeys_done(struct tevent_req *subreq)
     if (ret == EOK || ret == ENOENT) {
         domain = ssh_get_result_domain(ssh_ctx->rctx, result, cmd_ctx->domain);
 
-        ssh_update_known_hosts_file(ssh_ctx->rctx->domains, domain,
-                                    cmd_ctx->name, ssh_ctx->hash_known_hosts,
-                                    ssh_ctx->known_hosts_timeout);
+        ssh_update_known_hosts_file(ssh_ctx, domain, cmd_ctx->name);
     }
 
     if (ret != EOK) {
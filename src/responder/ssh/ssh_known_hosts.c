@@ -21,6 +21,7 @@
 #include "config.h"
 
 #include <talloc.h>
+#include <tevent.h>
 
 #include "util/util.h"
 #include "util/crypto/sss_crypto.h"
@@ -166,106 +167,428 @@ done:
     return result;
 }
 
+
+/* The known_hosts file is generated from an in-memory copy of the hosts
+ * it contains. A lookup only refreshes the entry of the requested host and
+ * the file is rewritten only if that changed its content. Entries whose
+ * known_hosts timeout passed are removed in batches by a timer.
+ *
+ * Hosts are also stored, invalidated and removed outside of the lookups,
+ * e.g. by the provider or sss_cache. These changes increase the generation
+ * of the hosts of the domain, and the entries of the domain are then read
+ * again from the cache. */
+
+/* Delay of the removal of expired hosts, collects the hosts expiring
+ * within this interval into a single rewrite. */
+#define SSH_KNOWN_HOSTS_PRUNE_DELAY 5
+
+struct ssh_known_host {
+    struct ssh_known_host *prev;
+    struct ssh_known_host *next;
+
+    char *key;
+    struct sss_domain_info *domain;
+    char *name;
+
+    /* Plain known_hosts lines, used to detect changes of the entry. */
+    char *plain;
+    /* Lines written to the file, hashed if ssh_hash_known_hosts is set. */
+    char *line;
+    time_t expire;
+
+    /* Not found in the cache yet while the domain is read again. */
+    bool stale;
+};
+
+/* Generation of the cached hosts the entries of the domain match. */
+struct ssh_known_hosts_domain {
+    struct ssh_known_hosts_domain *prev;
+    struct ssh_known_hosts_domain *next;
+
+    char *name;
+    uint32_t generation;
+};
+
+struct ssh_known_hosts {
+    struct ssh_ctx *ssh_ctx;
+
+    hash_table_t *table;
+    struct ssh_known_host *hosts;
+    struct ssh_known_hosts_domain *domains;
+
+    /* The file does not match the hosts, e.g. a write failed. */
+    bool dirty;
+
+    struct tevent_timer *prune_timer;
+    time_t prune_time;
+};
+
+static const char *ssh_known_hosts_attrs[] = {
+    SYSDB_NAME,
+    SYSDB_NAME_ALIAS,
+    SYSDB_SSH_PUBKEY,
+    SYSDB_CACHE_EXPIRE,
+    SYSDB_SSH_KNOWN_HOSTS_EXPIRE,
+    NULL
+};
+
+static errno_t
+ssh_known_hosts_init(struct ssh_ctx *ssh_ctx,
+                     struct ssh_known_hosts **_kh)
+{
+    struct ssh_known_hosts *kh;
+    errno_t ret;
+
+    kh = talloc_zero(ssh_ctx, struct ssh_known_hosts);
+    if (kh == NULL) {
+        return ENOMEM;
+    }
+
+    ret = sss_hash_create(kh, 0, &kh->table);
+    if (ret != EOK) {
+        talloc_free(kh);
+        return ret;
+    }
+
+    kh->ssh_ctx = ssh_ctx;
+
+    *_kh = kh;
+    return EOK;
+}
+
+static struct ssh_known_host *
+ssh_known_hosts_lookup(struct ssh_known_hosts *kh, const char *str)
+{
+    hash_key_t key;
+    hash_value_t value;
+    int hret;
+
+    key.type = HASH_KEY_STRING;
+    key.str = discard_const(str);
+
+    hret = hash_lookup(kh->table, &key, &value);
+    if (hret != HASH_SUCCESS) {
+        if (hret != HASH_ERROR_KEY_NOT_FOUND) {
+            DEBUG(SSSDBG_MINOR_FAILURE, "hash_lookup failed [%d]: %s\n",
+                  hret, hash_error_string(hret));
+        }
+        return NULL;
+    }
+
+    return talloc_get_type(value.ptr, struct ssh_known_host);
+}
+
+static void
+ssh_known_hosts_remove(struct ssh_known_hosts *kh,
+                       struct ssh_known_host *host)
+{
+    hash_key_t key;
+    int hret;
+
+    DEBUG(SSSDBG_TRACE_FUNC, "Removing [%s] from known hosts\n", host->key);
+
+    key.type = HASH_KEY_STRING;
+    key.str = host->key;
+
+    hret = hash_delete(kh->table, &key);
+    if (hret != HASH_SUCCESS) {
+        DEBUG(SSSDBG_CRIT_FAILURE,
+              "Unable to remove known host [%d]: %s\n",
+              hret, hash_error_string(hret));
+    }
+
+    DLIST_REMOVE(kh->hosts, host);
+    talloc_free(host);
+}
+
+/* Time until which the host belongs to the known_hosts file, the same
+ * condition as in sysdb_get_ssh_known_hosts(). */
+static time_t
+ssh_known_host_expire(struct ldb_message *msg)
+{
+    time_t expire;
+    time_t cache_expire;
+
+    expire = ldb_msg_find_attr_as_uint64(msg, SYSDB_SSH_KNOWN_HOSTS_EXPIRE, 0);
+    cache_expire = ldb_msg_find_attr_as_uint64(msg, SYSDB_CACHE_EXPIRE, 0);
+    if (cache_expire != 0 && cache_expire < expire) {
+        expire = cache_expire;
+    }
+
+    return expire;
+}
+
+/* Bring the entry of the host in sync with its cache object. Only a new or
+ * modified entry is formatted again, which is what makes hashing the
+ * names cheap. */
 static errno_t
-ssh_write_known_hosts(struct sss_domain_info *domains,
-                      bool hash_known_hosts,
-                      time_t now,
-                      int fd)
+ssh_known_hosts_set(struct ssh_known_hosts *kh,
+                    struct sss_domain_info *domain,
+                    struct ldb_message *msg,
+                    time_t now,
+                    bool *_changed)
 {
     TALLOC_CTX *tmp_ctx;
-    struct sss_domain_info *dom;
-    struct ldb_message **hosts;
-    struct sysdb_ctx *sysdb;
+    struct ssh_known_host *host;
+    struct ssh_known_host *old;
     struct sss_ssh_ent *ent;
-    char *entstr;
+    const char *name;
+    hash_key_t hkey;
+    hash_value_t value;
+    char *key;
+    char *plain;
+    time_t expire;
+    int hret;
+    errno_t ret;
+
+    *_changed = false;
+
+    tmp_ctx = talloc_new(NULL);
+    if (tmp_ctx == NULL) {
+        return ENOMEM;
+    }
+
+    name = ldb_msg_find_attr_as_string(msg, SYSDB_NAME, NULL);
+    if (name == NULL) {
+        ret = EINVAL;
+        goto done;
+    }
+
+    key = talloc_asprintf(tmp_ctx, "%s/%s", domain->name, name);
+    if (key == NULL) {
+        ret = ENOMEM;
+        goto done;
+    }
+
+    old = ssh_known_hosts_lookup(kh, key);
+    expire = ssh_known_host_expire(msg);
+    if (expire <= now) {
+        if (old != NULL) {
+            ssh_known_hosts_remove(kh, old);
+            *_changed = true;
+        }
+        ret = EOK;
+        goto done;
+    }
+
+    ret = sss_ssh_make_ent(tmp_ctx, msg, &ent);
+    if (ret != EOK) {
+        DEBUG(SSSDBG_OP_FAILURE, "Failed to get SSH host public keys\n");
+        goto done;
+    }
+
+    plain = ssh_host_pubkeys_format_known_host_plain(tmp_ctx, ent);
+    if (plain == NULL) {
+        DEBUG(SSSDBG_OP_FAILURE, "Failed to format known_hosts data "
+              "for [%s]\n", ent->name);
+        ret = ENOMEM;
+        goto done;
+    }
+
+    if (old != NULL && strcmp(old->plain, plain) == 0) {
+        old->expire = expire;
+        old->stale = false;
+        ret = EOK;
+        goto done;
+    }
+
+    host = talloc_zero(kh, struct ssh_known_host);
+    if (host == NULL) {
+        ret = ENOMEM;
+        goto done;
+    }
+
+    host->key = talloc_steal(host, key);
+    host->name = talloc_strdup(host, name);
+    host->plain = talloc_steal(host, plain);
+    if (kh->ssh_ctx->hash_known_hosts) {
+        host->line = ssh_host_pubkeys_format_known_host_hashed(host, ent);
+    } else {
+        host->line = host->plain;
+    }
+    if (host->name == NULL || host->line == NULL) {
+        DEBUG(SSSDBG_OP_FAILURE, "Failed to format known_hosts data "
+              "for [%s]\n", ent->name);
+        talloc_free(host);
+        ret = ENOMEM;
+        goto done;
+    }
+    host->domain = domain;
+    host->expire = expire;
+
+    if (old != NULL) {
+        ssh_known_hosts_remove(kh, old);
+    }
+
+    hkey.type = HASH_KEY_STRING;
+    hkey.str = host->key;
+    value.type = HASH_VALUE_PTR;
+    value.ptr = host;
+
+    hret = hash_enter(kh->table, &hkey, &value);
+    if (hret != HASH_SUCCESS) {
+        DEBUG(SSSDBG_MINOR_FAILURE, "hash_enter failed [%d]: %s\n",
+              hret, hash_error_string(hret));
+        talloc_free(host);
+        ret = EIO;
+        goto done;
+    }
+
+    DLIST_ADD_END(kh->hosts, host, struct ssh_known_host *);
+    *_changed = true;
+    ret = EOK;
+
+done:
+    talloc_free(tmp_ctx);
+    return ret;
+}
+
+/* Read the hosts of the domain again from the cache, reusing the entries
+ * that did not change. */
+static errno_t
+ssh_known_hosts_load(struct ssh_known_hosts *kh,
+                     struct sss_domain_info *domain,
+                     time_t now,
+                     bool *_changed)
+{
+    TALLOC_CTX *tmp_ctx;
+    struct ssh_known_host *host;
+    struct ssh_known_host *next;
+    struct ldb_message **hosts;
     size_t num_hosts;
     size_t i;
-    ssize_t wret;
+    bool changed;
     errno_t ret;
 
-    static const char *attrs[] = {
-        SYSDB_NAME,
-        SYSDB_NAME_ALIAS,
-        SYSDB_SSH_PUBKEY,
-        NULL
-    };
-
     tmp_ctx = talloc_new(NULL);
     if (tmp_ctx == NULL) {
         DEBUG(SSSDBG_FATAL_FAILURE, "Out of memory!\n");
         return ENOMEM;
     }
 
-    for (dom = domains; dom != NULL; dom = get_next_domain(dom, false)) {
-        sysdb = dom->sysdb;
-        if (sysdb == NULL) {
+    ret = sysdb_get_ssh_known_hosts(tmp_ctx, domain, now,
+                                    ssh_known_hosts_attrs,
+                                    &hosts, &num_hosts);
+    if (ret == ENOENT) {
+        num_hosts = 0;
+    } else if (ret != EOK) {
+        DEBUG(SSSDBG_OP_FAILURE, "Host search failed for domain "
+              "%s [%d]: %s\n", domain->name, ret, sss_strerror(ret));
+        goto done;
+    }
+
+    DLIST_FOR_EACH(host, kh->hosts) {
+        if (host->domain == domain) {
+            host->stale = true;
+        }
+    }
+
+    for (i = 0; i < num_hosts; i++) {
+        ret = ssh_known_hosts_set(kh, domain, hosts[i], now, &changed);
+        if (ret == ENOMEM) {
+            goto done;
+        }
+        *_changed |= changed;
+    }
+
+    for (host = kh->hosts; host != NULL; host = next) {
+        next = host->next;
+        if (host->domain == domain && host->stale) {
+            ssh_known_hosts_remove(kh, host);
+            *_changed = true;
+        }
+    }
+
+    ret = EOK;
+
+done:
+    talloc_free(tmp_ctx);
+
+    return ret;
+}
+
+/* Read again the domains whose hosts changed since they were read last. */
+static errno_t
+ssh_known_hosts_sync(struct ssh_known_hosts *kh,
+                     time_t now,
+                     bool *_changed)
+{
+    struct sss_domain_info *dom;
+    struct ssh_known_hosts_domain *khdom;
+    uint32_t generation;
+    errno_t ret;
+
+    *_changed = false;
+
+    for (dom = kh->ssh_ctx->rctx->domains;
+         dom != NULL;
+         dom = get_next_domain(dom, false)) {
+        if (dom->sysdb == NULL) {
             DEBUG(SSSDBG_FATAL_FAILURE,
                   "Fatal: Sysdb CTX not found for this domain!\n");
-            ret = EFAULT;
-            goto done;
+            return EFAULT;
         }
 
-        ret = sysdb_get_ssh_known_hosts(tmp_ctx, dom, now, attrs,
-                                        &hosts, &num_hosts);
-        if (ret == ENOENT) {
-            continue;
-        } else if (ret != EOK) {
-            DEBUG(SSSDBG_OP_FAILURE, "Host search failed for domain "
-                  "%s [%d]: %s\n", dom->name, ret, sss_strerror(ret));
+        /* read the generation first, a change that happens in the meantime
+         * only causes another reload */
+        ret = sysdb_ssh_hosts_get_generation(dom, &generation);
+        if (ret != EOK) {
+            DEBUG(SSSDBG_OP_FAILURE, "Unable to get hosts generation of "
+                  "domain %s [%d]: %s\n", dom->name, ret, sss_strerror(ret));
             continue;
         }
 
-        for (i = 0; i < num_hosts; i++) {
-            ret = sss_ssh_make_ent(tmp_ctx, hosts[i], &ent);
-            if (ret != EOK) {
-                DEBUG(SSSDBG_OP_FAILURE,
-                      "Failed to get SSH host public keys\n");
-                continue;
+        DLIST_FOR_EACH(khdom, kh->domains) {
+            if (strcmp(khdom->name, dom->name) == 0) {
+                break;
             }
+        }
 
-            if (hash_known_hosts) {
-                entstr = ssh_host_pubkeys_format_known_host_hashed(ent, ent);
-            } else {
-                entstr = ssh_host_pubkeys_format_known_host_plain(ent, ent);
-            }
+        if (khdom != NULL && khdom->generation == generation) {
+            continue;
+        }
 
-            if (entstr == NULL) {
-                DEBUG(SSSDBG_OP_FAILURE, "Failed to format known_hosts data "
-                      "for [%s]\n", ent->name);
-                continue;
+        if (khdom == NULL) {
+            khdom = talloc_zero(kh, struct ssh_known_hosts_domain);
+            if (khdom == NULL) {
+                return ENOMEM;
             }
 
-            wret = sss_atomic_write_s(fd, entstr, strlen(entstr));
-            if (wret == -1) {
-                ret = errno;
-                goto done;
+            khdom->name = talloc_strdup(khdom, dom->name);
+            if (khdom->name == NULL) {
+                talloc_free(khdom);
+                return ENOMEM;
             }
 
-            talloc_free(ent);
+            DLIST_ADD(kh->domains, khdom);
+        } else {
+            DEBUG(SSSDBG_TRACE_FUNC, "Hosts of [%s] changed\n", dom->name);
         }
 
-        talloc_free(hosts);
-    }
-
-    ret = EOK;
+        ret = ssh_known_hosts_load(kh, dom, now, _changed);
+        if (ret == ENOMEM) {
+            return ret;
+        } else if (ret != EOK) {
+            /* try again next time */
+            DLIST_REMOVE(kh->domains, khdom);
+            talloc_free(khdom);
+            continue;
+        }
 
-done:
-    talloc_free(tmp_ctx);
+        khdom->generation = generation;
+    }
 
-    return ret;
+    return EOK;
 }
 
-errno_t
-ssh_update_known_hosts_file(struct sss_domain_info *domains,
-                            struct sss_domain_info *domain,
-                            const char *name,
-                            bool hash_known_hosts,
-                            int known_hosts_timeout)
+static errno_t
+ssh_known_hosts_write(struct ssh_known_hosts *kh)
 {
     TALLOC_CTX *tmp_ctx;
+    struct ssh_known_host *host;
     char *filename;
+    ssize_t wret;
     errno_t ret;
-    time_t now;
     int fd = -1;
 
     tmp_ctx = talloc_new(NULL);
@@ -274,17 +597,6 @@ ssh_update_known_hosts_file(struct sss_domain_info *domains,
         return ENOMEM;
     }
 
-    now = time(NULL);
-
-    /* Update host's expiration time. */
-    if (domain != NULL) {
-        ret = sysdb_update_ssh_known_host_expire(domain, name, now,
-                                                 known_hosts_timeout);
-        if (ret != EOK && ret != ENOENT) {
-            goto done;
-        }
-    }
-
     /* Create temporary known hosts file. */
     filename = talloc_strdup(tmp_ctx, SSS_SSH_KNOWN_HOSTS_TEMP_TMPL);
     if (filename == NULL) {
@@ -299,14 +611,16 @@ ssh_update_known_hosts_file(struct sss_domain_info *domains,
     }
 
     /* Write contents. */
-    ret = ssh_write_known_hosts(domains, hash_known_hosts, now, fd);
-    if (ret != EOK) {
-        DEBUG(SSSDBG_CRIT_FAILURE, "Unable to write known hosts file "
-              "[%d]: %s\n", ret, sss_strerror(ret));
-        goto done;
+    DLIST_FOR_EACH(host, kh->hosts) {
+        wret = sss_atomic_write_s(fd, host->line, strlen(host->line));
+        if (wret == -1) {
+            ret = errno;
+            DEBUG(SSSDBG_CRIT_FAILURE, "Unable to write known hosts file "
+                  "[%d]: %s\n", ret, sss_strerror(ret));
+            goto done;
+        }
     }
 
-
     /* Rename to SSH known hosts file. */
     ret = fchmod(fd, 0644);
     if (ret == -1) {
@@ -331,3 +645,228 @@ done:
 
     return ret;
 }
+
+static void
+ssh_known_hosts_prune(struct tevent_context *ev,
+                      struct tevent_timer *te,
+                      struct timeval current_time,
+                      void *pvt);
+
+/* Make sure the prune timer fires after the earliest expiration time of
+ * the hosts in the file. */
+static void
+ssh_known_hosts_schedule_prune(struct ssh_known_hosts *kh)
+{
+    struct ssh_known_host *host;
+    time_t next = 0;
+
+    DLIST_FOR_EACH(host, kh->hosts) {
+        if (next == 0 || host->expire < next) {
+            next = host->expire;
+        }
+    }
+
+    if (next == 0) {
+        return;
+    }
+    next += SSH_KNOWN_HOSTS_PRUNE_DELAY;
+
+    if (kh->prune_timer != NULL && kh->prune_time <= next) {
+        return;
+    }
+
+    talloc_zfree(kh->prune_timer);
+    kh->prune_timer = tevent_add_timer(kh->ssh_ctx->rctx->ev, kh,
+                                       tevent_timeval_set(next, 0),
+                                       ssh_known_hosts_prune, kh);
+    if (kh->prune_timer == NULL) {
+        DEBUG(SSSDBG_CRIT_FAILURE,
+              "Unable to schedule removal of expired known hosts\n");
+        return;
+    }
+    kh->prune_time = next;
+}
+
+static void
+ssh_known_hosts_prune(struct tevent_context *ev,
+                      struct tevent_timer *te,
+                      struct timeval current_time,
+                      void *pvt)
+{
+    struct ssh_known_hosts *kh;
+    struct ssh_known_host *host;
+    struct ssh_known_host *next;
+    bool changed = false;
+    time_t now;
+    errno_t ret;
+
+    kh = talloc_get_type(pvt, struct ssh_known_hosts);
+    kh->prune_timer = NULL;
+
+    now = time(NULL);
+
+    /* the expiration times in memory may be outdated */
+    ret = ssh_known_hosts_sync(kh, now, &changed);
+    if (ret != EOK) {
+        DEBUG(SSSDBG_OP_FAILURE, "Unable to read known hosts "
+              "[%d]: %s\n", ret, sss_strerror(ret));
+        changed = false;
+    }
+
+    for (host = kh->hosts; host != NULL; host = next) {
+        next = host->next;
+        if (host->expire <= now) {
+            ssh_known_hosts_remove(kh, host);
+            changed = true;
+        }
+    }
+
+    if (changed || kh->dirty) {
+        ret = ssh_known_hosts_write(kh);
+        if (ret != EOK) {
+            DEBUG(SSSDBG_OP_FAILURE, "Unable to update known hosts file "
+                  "[%d]: %s\n", ret, sss_strerror(ret));
+        }
+        kh->dirty = (ret != EOK);
+    }
+
+    ssh_known_hosts_schedule_prune(kh);
+}
+
+/* Refresh the entries of the host with the given name, in all domains if
+ * the domain is not known. */
+static errno_t
+ssh_known_hosts_refresh(struct ssh_known_hosts *kh,
+                        struct sss_domain_info *domain,
+                        const char *name,
+                        time_t now,
+                        bool *_changed)
+{
+    TALLOC_CTX *tmp_ctx;
+    struct ssh_known_host *host;
+    struct ssh_known_host *next;
+    struct ldb_message *msg;
+    char *key;
+    errno_t ret;
+
+    *_changed = false;
+
+    if (domain == NULL) {
+        for (host = kh->hosts; host != NULL; host = next) {
+            next = host->next;
+            if (strcmp(host->name, name) == 0) {
+                ssh_known_hosts_remove(kh, host);
+                *_changed = true;
+            }
+        }
+        return EOK;
+    }
+
+    tmp_ctx = talloc_new(NULL);
+    if (tmp_ctx == NULL) {
+        return ENOMEM;
+    }
+
+    ret = sysdb_get_ssh_host(tmp_ctx, domain, name, ssh_known_hosts_attrs,
+                             &msg);
+    if (ret == ENOENT) {
+        key = talloc_asprintf(tmp_ctx, "%s/%s", domain->name, name);
+        if (key == NULL) {
+            ret = ENOMEM;
+            goto done;
+        }
+
+        host = ssh_known_hosts_lookup(kh, key);
+        if (host != NULL) {
+            ssh_known_hosts_remove(kh, host);
+            *_changed = true;
+        }
+        ret = EOK;
+        goto done;
+    } else if (ret != EOK) {
+        DEBUG(SSSDBG_OP_FAILURE, "Unable to read host [%s] [%d]: %s\n",
+              name, ret, sss_strerror(ret));
+        goto done;
+    }
+
+    ret = ssh_known_hosts_set(kh, domain, msg, now, _changed);
+
+done:
+    talloc_free(tmp_ctx);
+    return ret;
+}
+
+errno_t
+ssh_update_known_hosts_file(struct ssh_ctx *ssh_ctx,
+                            struct sss_domain_info *domain,
+                            const char *name)
+{
+    struct ssh_known_hosts *kh;
+    bool changed;
+    bool host_changed;
+    errno_t ret;
+    time_t now;
+
+    now = time(NULL);
+
+    /* Update host's expiration time. */
+    if (domain != NULL) {
+        ret = sysdb_update_ssh_known_host_expire(domain, name, now,
+                                                 ssh_ctx->known_hosts_timeout);
+        if (ret != EOK && ret != ENOENT) {
+            return ret;
+        }
+    }
+
+    if (ssh_ctx->known_hosts == NULL) {
+        /* All hosts are read only when the file is generated first, later
+         * only the domains whose hosts changed. */
+        ret = ssh_known_hosts_init(ssh_ctx, &kh);
+        if (ret != EOK) {
+            return ret;
+        }
+
+        ret = ssh_known_hosts_sync(kh, now, &changed);
+        if (ret != EOK) {
+            talloc_free(kh);
+            return ret;
+        }
+
+        ssh_ctx->known_hosts = kh;
+        changed = true;
+    } else {
+        kh = ssh_ctx->known_hosts;
+
+        ret = ssh_known_hosts_sync(kh, now, &changed);
+        if (ret != EOK) {
+            return ret;
+        }
+
+        /* the known_hosts expiration time of the host does not change the
+         * generation */
+        ret = ssh_known_hosts_refresh(kh, domain, name, now, &host_changed);
+        if (ret != EOK) {
+            return ret;
+        }
+        changed |= host_changed;
+    }
+
+    if (changed || kh->dirty) {
+        /* ssh reads the file right after the reply, the host must be
+         * there already. */
+        ret = ssh_known_hosts_write(kh);
+        kh->dirty = (ret != EOK);
+        if (ret != EOK) {
+            DEBUG(SSSDBG_CRIT_FAILURE, "Unable to write known hosts file "
+                  "[%d]: %s\n", ret, sss_strerror(ret));
+            return ret;
+        }
+    } else {
+        DEBUG(SSSDBG_TRACE_FUNC,
+              "Known hosts of [%s] did not change\n", name);
+    }
+
+    ssh_known_hosts_schedule_prune(kh);
+
+    return EOK;
+}
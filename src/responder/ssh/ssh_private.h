@@ -24,8 +24,13 @@
 #include "responder/common/responder.h"
 #include "responder/common/cache_req/cache_req.h"
 
+/* can be overridden by tests */
+#ifndef SSS_SSH_KNOWN_HOSTS_PATH
 #define SSS_SSH_KNOWN_HOSTS_PATH PUBCONF_PATH"/known_hosts"
+#endif
+#ifndef SSS_SSH_KNOWN_HOSTS_TEMP_TMPL
 #define SSS_SSH_KNOWN_HOSTS_TEMP_TMPL PUBCONF_PATH"/.known_hosts.XXXXXX"
+#endif
 
 struct ssh_ctx {
     struct resp_ctx *rctx;
@@ -33,6 +38,7 @@ struct ssh_ctx {
 
     bool hash_known_hosts;
     int known_hosts_timeout;
+    struct ssh_known_hosts *known_hosts;
     char *ca_db;
     bool use_cert_keys;
 
@@ -81,10 +87,8 @@ ssh_protocol_build_reply(struct sss_packet *packet,
                          uint32_t num_keys);
 
 errno_t
-ssh_update_known_hosts_file(struct sss_domain_info *domains,
+ssh_update_known_hosts_file(struct ssh_ctx *ssh_ctx,
                             struct sss_domain_info *domain,
-                            const char *name,
-                            bool hash_known_hosts,
-                            int known_hosts_timeout);
+                            const char *name);
 
 #endif /* _SSHSRV_PRIVATE_H_ */
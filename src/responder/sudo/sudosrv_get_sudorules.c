@@ -203,6 +203,571 @@ static errno_t sudosrv_format_rules(struct resp_ctx *rctx,
     return ret;
 }
 
+/* == Rule index =========================================================== */
+
+/*
+ * The sudo rules of a domain only change when the provider refreshes them,
+ * so instead of searching the cache with a filter built from the user and
+ * all of his groups on every sudo invocation, the rules are loaded once
+ * after each refresh, sorted by sudoOrder and indexed by their sudoUser
+ * values. A lookup then only has to merge the lists of the user's tokens.
+ */
+
+#define SUDOSRV_INDEX_USER      0x01
+#define SUDOSRV_INDEX_NETGROUP  0x02
+
+/* Rule positions in ascending order, i.e. by priority. */
+struct sudosrv_posting {
+    uint32_t *ids;
+    uint32_t count;
+};
+
+struct sudosrv_rule_index {
+    struct sudosrv_rule_index *prev;
+    struct sudosrv_rule_index *next;
+
+    const char *domain;
+    uint32_t generation;
+
+    struct sysdb_attrs **rules;
+    time_t *expire;
+    uint32_t num_rules;
+
+    /* sudoUser value -> struct sudosrv_posting */
+    hash_table_t *users;
+    /* rules with a +netgroup sudoUser */
+    struct sudosrv_posting netgroups;
+    /* position of the defaults entry or -1 */
+    int64_t defaults;
+};
+
+static const char *sudosrv_rule_attrs[] = { SYSDB_OBJECTCLASS,
+                                            SYSDB_SUDO_CACHE_AT_CN,
+                                            SYSDB_SUDO_CACHE_AT_HOST,
+                                            SYSDB_SUDO_CACHE_AT_COMMAND,
+                                            SYSDB_SUDO_CACHE_AT_OPTION,
+                                            SYSDB_SUDO_CACHE_AT_RUNAS,
+                                            SYSDB_SUDO_CACHE_AT_RUNASUSER,
+                                            SYSDB_SUDO_CACHE_AT_RUNASGROUP,
+                                            SYSDB_SUDO_CACHE_AT_NOTBEFORE,
+                                            SYSDB_SUDO_CACHE_AT_NOTAFTER,
+                                            SYSDB_SUDO_CACHE_AT_ORDER,
+                                            NULL };
+
+static const char *sudosrv_ng_rule_attrs[] = { SYSDB_OBJECTCLASS,
+                                               SYSDB_SUDO_CACHE_AT_CN,
+                                               SYSDB_SUDO_CACHE_AT_USER,
+                                               SYSDB_SUDO_CACHE_AT_HOST,
+                                               SYSDB_SUDO_CACHE_AT_COMMAND,
+                                               SYSDB_SUDO_CACHE_AT_OPTION,
+                                               SYSDB_SUDO_CACHE_AT_RUNAS,
+                                               SYSDB_SUDO_CACHE_AT_RUNASUSER,
+                                               SYSDB_SUDO_CACHE_AT_RUNASGROUP,
+                                               SYSDB_SUDO_CACHE_AT_NOTBEFORE,
+                                               SYSDB_SUDO_CACHE_AT_NOTAFTER,
+                                               SYSDB_SUDO_CACHE_AT_ORDER,
+                                               NULL };
+
+static const char *sudosrv_name_attrs[] = { SYSDB_NAME, NULL };
+
+static errno_t sudosrv_posting_add(TALLOC_CTX *mem_ctx,
+                                   struct sudosrv_posting *posting,
+                                   uint32_t id)
+{
+    uint32_t *ids;
+
+    /* a rule may list the same value several times */
+    if (posting->count > 0 && posting->ids[posting->count - 1] == id) {
+        return EOK;
+    }
+
+    ids = talloc_realloc(mem_ctx, posting->ids, uint32_t, posting->count + 1);
+    if (ids == NULL) {
+        return ENOMEM;
+    }
+
+    ids[posting->count] = id;
+    posting->ids = ids;
+    posting->count++;
+
+    return EOK;
+}
+
+static errno_t sudosrv_index_add_user(struct sudosrv_rule_index *index,
+                                      const char *value,
+                                      uint32_t id)
+{
+    struct sudosrv_posting *posting;
+    hash_key_t key;
+    hash_value_t hvalue;
+    int hret;
+
+    key.type = HASH_KEY_STRING;
+    key.str = discard_const(value);
+
+    hret = hash_lookup(index->users, &key, &hvalue);
+    if (hret == HASH_SUCCESS) {
+        posting = talloc_get_type(hvalue.ptr, struct sudosrv_posting);
+        return sudosrv_posting_add(posting, posting, id);
+    } else if (hret != HASH_ERROR_KEY_NOT_FOUND) {
+        DEBUG(SSSDBG_OP_FAILURE, "hash_lookup failed [%d]: %s\n",
+              hret, hash_error_string(hret));
+        return EIO;
+    }
+
+    posting = talloc_zero(index, struct sudosrv_posting);
+    if (posting == NULL) {
+        return ENOMEM;
+    }
+
+    hvalue.type = HASH_VALUE_PTR;
+    hvalue.ptr = posting;
+
+    hret = hash_enter(index->users, &key, &hvalue);
+    if (hret != HASH_SUCCESS) {
+        DEBUG(SSSDBG_OP_FAILURE, "hash_enter failed [%d]: %s\n",
+              hret, hash_error_string(hret));
+        talloc_free(posting);
+        return EIO;
+    }
+
+    return sudosrv_posting_add(posting, posting, id);
+}
+
+static errno_t sudosrv_index_build(TALLOC_CTX *mem_ctx,
+                                   struct sss_domain_info *domain,
+                                   uint32_t generation,
+                                   bool inverse_order,
+                                   struct sudosrv_rule_index **_index)
+{
+    struct sudosrv_rule_index *index;
+    struct ldb_message_element *el;
+    struct ldb_message **msgs;
+    const char *name;
+    uint32_t expire;
+    size_t count;
+    uint32_t i;
+    unsigned int j;
+    errno_t ret;
+    const char *attrs[] = { SYSDB_OBJECTCLASS,
+                            SYSDB_NAME,
+                            SYSDB_CACHE_EXPIRE,
+                            SYSDB_SUDO_CACHE_AT_CN,
+                            SYSDB_SUDO_CACHE_AT_USER,
+                            SYSDB_SUDO_CACHE_AT_HOST,
+                            SYSDB_SUDO_CACHE_AT_COMMAND,
+                            SYSDB_SUDO_CACHE_AT_OPTION,
+                            SYSDB_SUDO_CACHE_AT_RUNAS,
+                            SYSDB_SUDO_CACHE_AT_RUNASUSER,
+                            SYSDB_SUDO_CACHE_AT_RUNASGROUP,
+                            SYSDB_SUDO_CACHE_AT_NOTBEFORE,
+                            SYSDB_SUDO_CACHE_AT_NOTAFTER,
+                            SYSDB_SUDO_CACHE_AT_ORDER,
+                            NULL };
+
+    index = talloc_zero(mem_ctx, struct sudosrv_rule_index);
+    if (index == NULL) {
+        return ENOMEM;
+    }
+
+    index->domain = talloc_strdup(index, domain->name);
+    if (index->domain == NULL) {
+        ret = ENOMEM;
+        goto done;
+    }
+    index->generation = generation;
+    index->defaults = -1;
+
+    ret = sysdb_search_custom(index, domain, "("SYSDB_OBJECTCLASS"="
+                              SYSDB_SUDO_CACHE_OC")", SUDORULE_SUBDIR,
+                              attrs, &count, &msgs);
+    if (ret == ENOENT) {
+        count = 0;
+        msgs = NULL;
+    } else if (ret != EOK) {
+        DEBUG(SSSDBG_CRIT_FAILURE, "Error looking up SUDO rules\n");
+        goto done;
+    }
+
+    ret = sss_hash_create(index, count > 0 ? count : 1, &index->users);
+    if (ret != EOK) {
+        goto done;
+    }
+
+    if (count > 0) {
+        ret = sysdb_msg2attrs(index, count, msgs, &index->rules);
+        talloc_free(msgs);
+        if (ret != EOK) {
+            DEBUG(SSSDBG_CRIT_FAILURE,
+                  "Could not convert ldb message to sysdb_attrs\n");
+            goto done;
+        }
+
+        ret = sort_sudo_rules(index->rules, count, inverse_order);
+        if (ret != EOK) {
+            goto done;
+        }
+    }
+    index->num_rules = count;
+
+    index->expire = talloc_array(index, time_t, count);
+    if (index->expire == NULL) {
+        ret = ENOMEM;
+        goto done;
+    }
+
+    for (i = 0; i < index->num_rules; i++) {
+        ret = sysdb_attrs_get_uint32_t(index->rules[i], SYSDB_CACHE_EXPIRE,
+                                       &expire);
+        index->expire[i] = (ret == EOK ? (time_t)expire : -1);
+
+        ret = sysdb_attrs_get_string(index->rules[i], SYSDB_NAME, &name);
+        if (ret == EOK && strcmp(name, "defaults") == 0) {
+            index->defaults = i;
+        }
+
+        ret = sysdb_attrs_get_el_ext(index->rules[i],
+                                     SYSDB_SUDO_CACHE_AT_USER, false, &el);
+        if (ret == ENOENT) {
+            continue;
+        } else if (ret != EOK) {
+            goto done;
+        }
+
+        for (j = 0; j < el->num_values; j++) {
+            name = (const char *)el->values[j].data;
+            if (name[0] == '+') {
+                ret = sudosrv_posting_add(index, &index->netgroups, i);
+                if (ret != EOK) {
+                    goto done;
+                }
+            }
+
+            ret = sudosrv_index_add_user(index, name, i);
+            if (ret != EOK) {
+                goto done;
+            }
+        }
+    }
+
+    DEBUG(SSSDBG_TRACE_FUNC, "Indexed %"PRIu32" sudo rules of [%s], "
+          "generation %"PRIu32"\n", index->num_rules, domain->name,
+          generation);
+
+    *_index = index;
+    ret = EOK;
+
+done:
+    if (ret != EOK) {
+        talloc_free(index);
+    }
+
+    return ret;
+}
+
+/* Returns the index of the domain that stores the rules, built again
+ * if a refresh changed the rules since it was built. */
+static errno_t sudosrv_index_get(struct sudo_ctx *sudo_ctx,
+                                 struct sss_domain_info *domain,
+                                 struct sudosrv_rule_index **_index)
+{
+    struct sudosrv_rule_index *index;
+    uint32_t generation;
+    errno_t ret;
+
+    if (IS_SUBDOMAIN(domain)) {
+        /* rules are stored inside parent domain tree */
+        domain = domain->parent;
+    }
+
+    /* read the generation first, a refresh that finishes in the meantime
+     * only causes another rebuild */
+    ret = sysdb_sudo_get_generation(domain, &generation);
+    if (ret != EOK) {
+        DEBUG(SSSDBG_OP_FAILURE, "Unable to get sudo rules generation "
+              "[%d]: %s\n", ret, sss_strerror(ret));
+        return ret;
+    }
+
+    DLIST_FOR_EACH(index, sudo_ctx->rule_indexes) {
+        if (strcmp(index->domain, domain->name) == 0) {
+            break;
+        }
+    }
+
+    if (index != NULL && index->generation == generation) {
+        *_index = index;
+        return EOK;
+    }
+
+    if (index != NULL) {
+        DEBUG(SSSDBG_TRACE_FUNC, "Sudo rules of [%s] were refreshed\n",
+              domain->name);
+        DLIST_REMOVE(sudo_ctx->rule_indexes, index);
+        talloc_free(index);
+    }
+
+    ret = sudosrv_index_build(sudo_ctx, domain, generation,
+                              sudo_ctx->inverse_order, &index);
+    if (ret != EOK) {
+        DEBUG(SSSDBG_OP_FAILURE, "Unable to index sudo rules [%d]: %s\n",
+              ret, sss_strerror(ret));
+        return ret;
+    }
+
+    DLIST_ADD(sudo_ctx->rule_indexes, index);
+
+    *_index = index;
+    return EOK;
+}
+
+static void sudosrv_index_mark(struct sudosrv_rule_index *index,
+                               const char *value,
+                               uint8_t *matches)
+{
+    struct sudosrv_posting *posting;
+    hash_key_t key;
+    hash_value_t hvalue;
+    uint32_t i;
+    int hret;
+
+    key.type = HASH_KEY_STRING;
+    key.str = discard_const(value);
+
+    hret = hash_lookup(index->users, &key, &hvalue);
+    if (hret != HASH_SUCCESS) {
+        return;
+    }
+
+    posting = talloc_get_type(hvalue.ptr, struct sudosrv_posting);
+    for (i = 0; i < posting->count; i++) {
+        matches[posting->ids[i]] |= SUDOSRV_INDEX_USER;
+    }
+}
+
+/*
+ * Marks the rules that apply to the user in the same way as
+ * sysdb_sudo_filter_user() and sysdb_sudo_filter_netgroups() select them.
+ */
+static errno_t sudosrv_index_match(TALLOC_CTX *mem_ctx,
+                                   struct sudosrv_rule_index *index,
+                                   uid_t uid,
+                                   const char *username,
+                                   char **groups,
+                                   uint8_t **_matches)
+{
+    uint8_t *matches;
+    char *value;
+    uint32_t i;
+
+    matches = talloc_zero_array(mem_ctx, uint8_t, index->num_rules + 1);
+    if (matches == NULL) {
+        return ENOMEM;
+    }
+
+    for (i = 0; i < index->netgroups.count; i++) {
+        matches[index->netgroups.ids[i]] |= SUDOSRV_INDEX_NETGROUP;
+    }
+
+    sudosrv_index_mark(index, "ALL", matches);
+    sudosrv_index_mark(index, username, matches);
+
+    if (uid != 0) {
+        value = talloc_asprintf(matches, "#%"SPRIuid, uid);
+        if (value == NULL) {
+            talloc_free(matches);
+            return ENOMEM;
+        }
+        sudosrv_index_mark(index, value, matches);
+        talloc_free(value);
+    }
+
+    for (i = 0; groups != NULL && groups[i] != NULL; i++) {
+        value = talloc_asprintf(matches, "%%%s", groups[i]);
+        if (value == NULL) {
+            talloc_free(matches);
+            return ENOMEM;
+        }
+        sudosrv_index_mark(index, value, matches);
+        talloc_free(value);
+    }
+
+    *_matches = matches;
+    return EOK;
+}
+
+static struct sysdb_attrs *sudosrv_copy_rule(TALLOC_CTX *mem_ctx,
+                                             struct sysdb_attrs *rule,
+                                             const char **attrs)
+{
+    struct sysdb_attrs *copy;
+    struct ldb_message_element *el;
+    unsigned int i;
+    unsigned int j;
+    errno_t ret;
+
+    copy = sysdb_new_attrs(mem_ctx);
+    if (copy == NULL) {
+        return NULL;
+    }
+
+    for (i = 0; i < rule->num; i++) {
+        el = &rule->a[i];
+        if (!string_in_list(el->name, discard_const(attrs), false)) {
+            continue;
+        }
+
+        for (j = 0; j < el->num_values; j++) {
+            ret = sysdb_attrs_add_val(copy, el->name, &el->values[j]);
+            if (ret != EOK) {
+                talloc_free(copy);
+                return NULL;
+            }
+        }
+    }
+
+    return copy;
+}
+
+static errno_t sudosrv_index_user_rules(TALLOC_CTX *mem_ctx,
+                                        struct sudosrv_rule_index *index,
+                                        uid_t cli_uid,
+                                        uid_t orig_uid,
+                                        const char *username,
+                                        char **groups,
+                                        struct sysdb_attrs ***_rules,
+                                        uint32_t *_num_rules)
+{
+    TALLOC_CTX *tmp_ctx;
+    struct sysdb_attrs **rules;
+    uint32_t num_rules = 0;
+    uint8_t *matches;
+    const char *uid_value;
+    uint32_t i;
+    errno_t ret;
+
+    tmp_ctx = talloc_new(NULL);
+    if (tmp_ctx == NULL) {
+        return ENOMEM;
+    }
+
+    ret = sudosrv_index_match(tmp_ctx, index, orig_uid, username, groups,
+                              &matches);
+    if (ret != EOK) {
+        goto done;
+    }
+
+    rules = talloc_zero_array(tmp_ctx, struct sysdb_attrs *,
+                              index->num_rules + 1);
+    uid_value = talloc_asprintf(tmp_ctx, "#%"SPRIuid, cli_uid);
+    if (rules == NULL || uid_value == NULL) {
+        ret = ENOMEM;
+        goto done;
+    }
+
+    /* the rules are already sorted by sudoOrder */
+    for (i = 0; i < index->num_rules; i++) {
+        if (matches[i] & SUDOSRV_INDEX_USER) {
+            rules[num_rules] = sudosrv_copy_rule(rules, index->rules[i],
+                                                 sudosrv_rule_attrs);
+            if (rules[num_rules] == NULL) {
+                ret = ENOMEM;
+                goto done;
+            }
+
+            /* Add sudoUser: #uid to prevent conflicts with fqnames. */
+            ret = sysdb_attrs_add_string(rules[num_rules],
+                                         SYSDB_SUDO_CACHE_AT_USER, uid_value);
+            if (ret != EOK) {
+                DEBUG(SSSDBG_CRIT_FAILURE, "Unable to alter sudoUser "
+                      "attribute [%d]: %s\n", ret, sss_strerror(ret));
+            }
+        } else if (matches[i] & SUDOSRV_INDEX_NETGROUP) {
+            rules[num_rules] = sudosrv_copy_rule(rules, index->rules[i],
+                                                 sudosrv_ng_rule_attrs);
+            if (rules[num_rules] == NULL) {
+                ret = ENOMEM;
+                goto done;
+            }
+        } else {
+            continue;
+        }
+
+        num_rules++;
+    }
+
+    *_rules = num_rules == 0 ? NULL : talloc_steal(mem_ctx, rules);
+    *_num_rules = num_rules;
+    ret = EOK;
+
+done:
+    talloc_free(tmp_ctx);
+    return ret;
+}
+
+static errno_t sudosrv_index_expired_rules(TALLOC_CTX *mem_ctx,
+                                           struct sudosrv_rule_index *index,
+                                           uid_t uid,
+                                           const char *username,
+                                           char **groups,
+                                           struct sysdb_attrs ***_rules,
+                                           uint32_t *_num_rules)
+{
+    TALLOC_CTX *tmp_ctx;
+    struct sysdb_attrs **rules;
+    uint32_t num_rules = 0;
+    uint8_t *matches;
+    time_t now;
+    uint32_t i;
+    errno_t ret;
+
+    tmp_ctx = talloc_new(NULL);
+    if (tmp_ctx == NULL) {
+        return ENOMEM;
+    }
+
+    ret = sudosrv_index_match(tmp_ctx, index, uid, username, groups,
+                              &matches);
+    if (ret != EOK) {
+        goto done;
+    }
+
+    if (index->defaults >= 0) {
+        matches[index->defaults] |= SUDOSRV_INDEX_USER;
+    }
+
+    rules = talloc_zero_array(tmp_ctx, struct sysdb_attrs *,
+                              index->num_rules + 1);
+    if (rules == NULL) {
+        ret = ENOMEM;
+        goto done;
+    }
+
+    now = time(NULL);
+    for (i = 0; i < index->num_rules; i++) {
+        if (matches[i] == 0
+                || index->expire[i] == -1 || index->expire[i] > now) {
+            continue;
+        }
+
+        rules[num_rules] = sudosrv_copy_rule(rules, index->rules[i],
+                                             sudosrv_name_attrs);
+        if (rules[num_rules] == NULL) {
+            ret = ENOMEM;
+            goto done;
+        }
+        num_rules++;
+    }
+
+    *_rules = num_rules == 0 ? NULL : talloc_steal(mem_ctx, rules);
+    *_num_rules = num_rules;
+    ret = EOK;
+
+done:
+    talloc_free(tmp_ctx);
+    return ret;
+}
+
 static errno_t sudosrv_query_cache(TALLOC_CTX *mem_ctx,
                                    struct sss_domain_info *domain,
                                    const char **attrs,
@@ -258,6 +823,7 @@ done:
 }
 
 static errno_t sudosrv_expired_rules(TALLOC_CTX *mem_ctx,
+                                     struct sudo_ctx *sudo_ctx,
                                      struct sss_domain_info *domain,
                                      uid_t uid,
                                      const char *username,
@@ -265,10 +831,17 @@ static errno_t sudosrv_expired_rules(TALLOC_CTX *mem_ctx,
                                      struct sysdb_attrs ***_rules,
                                      uint32_t *_num_rules)
 {
+    struct sudosrv_rule_index *index;
     const char *attrs[] = { SYSDB_NAME, NULL };
     char *filter;
     errno_t ret;
 
+    ret = sudosrv_index_get(sudo_ctx, domain, &index);
+    if (ret == EOK) {
+        return sudosrv_index_expired_rules(mem_ctx, index, uid, username,
+                                           groups, _rules, _num_rules);
+    }
+
     filter = sysdb_sudo_filter_expired(NULL, username, groups, uid);
     if (filter == NULL) {
         return ENOMEM;
@@ -390,8 +963,7 @@ static errno_t sudosrv_cached_rules_by_ng(TALLOC_CTX *mem_ctx,
     return ret;
 }
 
-static errno_t sudosrv_cached_rules(TALLOC_CTX *mem_ctx,
-                                    struct resp_ctx *rctx,
+static errno_t sudosrv_search_rules(TALLOC_CTX *mem_ctx,
                                     struct sss_domain_info *domain,
                                     uid_t cli_uid,
                                     uid_t orig_uid,
@@ -459,12 +1031,6 @@ static errno_t sudosrv_cached_rules(TALLOC_CTX *mem_ctx,
         goto done;
     }
 
-    ret = sudosrv_format_rules(rctx, rules, num_rules);
-    if (ret != EOK) {
-        DEBUG(SSSDBG_OP_FAILURE, "Could not format sudo rules\n");
-        goto done;
-    }
-
     *_rules = talloc_steal(mem_ctx, rules);
     *_num_rules = num_rules;
 
@@ -475,6 +1041,55 @@ done:
     return ret;
 }
 
+static errno_t sudosrv_cached_rules(TALLOC_CTX *mem_ctx,
+                                    struct sudo_ctx *sudo_ctx,
+                                    struct sss_domain_info *domain,
+                                    uid_t cli_uid,
+                                    uid_t orig_uid,
+                                    const char *username,
+                                    char **groups,
+                                    struct sysdb_attrs ***_rules,
+                                    uint32_t *_num_rules)
+{
+    struct sudosrv_rule_index *index;
+    struct sysdb_attrs **rules;
+    uint32_t num_rules;
+    errno_t ret;
+
+    ret = sudosrv_index_get(sudo_ctx, domain, &index);
+    if (ret == EOK) {
+        ret = sudosrv_index_user_rules(mem_ctx, index, cli_uid, orig_uid,
+                                       username, groups, &rules, &num_rules);
+    } else {
+        DEBUG(SSSDBG_MINOR_FAILURE, "Sudo rule index is not available, "
+              "searching the cache\n");
+        ret = sudosrv_search_rules(mem_ctx, domain, cli_uid, orig_uid,
+                                   username, groups, sudo_ctx->inverse_order,
+                                   &rules, &num_rules);
+    }
+    if (ret != EOK) {
+        return ret;
+    }
+
+    if (num_rules == 0) {
+        *_rules = NULL;
+        *_num_rules = 0;
+        return EOK;
+    }
+
+    ret = sudosrv_format_rules(sudo_ctx->rctx, rules, num_rules);
+    if (ret != EOK) {
+        DEBUG(SSSDBG_OP_FAILURE, "Could not format sudo rules\n");
+        talloc_free(rules);
+        return ret;
+    }
+
+    *_rules = rules;
+    *_num_rules = num_rules;
+
+    return EOK;
+}
+
 static errno_t sudosrv_cached_defaults(TALLOC_CTX *mem_ctx,
                                        struct sss_domain_info *domain,
                                        struct sysdb_attrs ***_rules,
@@ -509,14 +1124,13 @@ static errno_t sudosrv_cached_defaults(TALLOC_CTX *mem_ctx,
 }
 
 static errno_t sudosrv_fetch_rules(TALLOC_CTX *mem_ctx,
-                                   struct resp_ctx *rctx,
+                                   struct sudo_ctx *sudo_ctx,
                                    enum sss_sudo_type type,
                                    struct sss_domain_info *domain,
                                    uid_t cli_uid,
                                    uid_t orig_uid,
                                    const char *username,
                                    char **groups,
-                                   bool inverse_order,
                                    struct sysdb_attrs ***_rules,
                                    uint32_t *_num_rules)
 {
@@ -531,9 +1145,9 @@ static errno_t sudosrv_fetch_rules(TALLOC_CTX *mem_ctx,
               username, domain->name);
         debug_name = "rules";
 
-        ret = sudosrv_cached_rules(mem_ctx, rctx, domain,
+        ret = sudosrv_cached_rules(mem_ctx, sudo_ctx, domain,
                                    cli_uid, orig_uid, username, groups,
-                                   inverse_order, &rules, &num_rules);
+                                   &rules, &num_rules);
 
         break;
     case SSS_SUDO_DEFAULTS:
@@ -581,7 +1195,7 @@ static void sudosrv_refresh_rules_done(struct tevent_req *subreq);
 static struct tevent_req *
 sudosrv_refresh_rules_send(TALLOC_CTX *mem_ctx,
                            struct tevent_context *ev,
-                           struct resp_ctx *rctx,
+                           struct sudo_ctx *sudo_ctx,
                            struct sss_domain_info *domain,
                            int threshold,
                            uid_t uid,
@@ -602,11 +1216,11 @@ sudosrv_refresh_rules_send(TALLOC_CTX *mem_ctx,
         return NULL;
     }
 
-    state->rctx = rctx;
+    state->rctx = sudo_ctx->rctx;
     state->domain = domain;
     state->username = username;
 
-    ret = sudosrv_expired_rules(state, domain, uid, username, groups,
+    ret = sudosrv_expired_rules(state, sudo_ctx, domain, uid, username, groups,
                                 &rules, &num_rules);
     if (ret != EOK) {
         DEBUG(SSSDBG_CRIT_FAILURE,
@@ -630,11 +1244,11 @@ sudosrv_refresh_rules_send(TALLOC_CTX *mem_ctx,
               "Rules threshold [%d] is reached, performing full refresh "
               "instead.\n", threshold);
 
-        subreq = sss_dp_get_sudoers_send(state, rctx, domain, false,
+        subreq = sss_dp_get_sudoers_send(state, state->rctx, domain, false,
                                          SSS_DP_SUDO_FULL_REFRESH,
                                          username, 0, NULL);
     } else {
-        subreq = sss_dp_get_sudoers_send(state, rctx, domain, false,
+        subreq = sss_dp_get_sudoers_send(state, state->rctx, domain, false,
                                          SSS_DP_SUDO_REFRESH_RULES,
                                          username, num_rules, rules);
     }
@@ -723,13 +1337,13 @@ static errno_t sudosrv_refresh_rules_recv(struct tevent_req *req)
 
 struct sudosrv_get_rules_state {
     struct tevent_context *ev;
+    struct sudo_ctx *sudo_ctx;
     struct resp_ctx *rctx;
     enum sss_sudo_type type;
     uid_t cli_uid;
     const char *username;
     struct sss_domain_info *domain;
     char **groups;
-    bool inverse_order;
     int threshold;
 
     uid_t orig_uid;
@@ -761,10 +1375,10 @@ struct tevent_req *sudosrv_get_rules_send(TALLOC_CTX *mem_ctx,
     }
 
     state->ev = ev;
+    state->sudo_ctx = sudo_ctx;
     state->rctx = sudo_ctx->rctx;
     state->type = type;
     state->cli_uid = cli_uid;
-    state->inverse_order = sudo_ctx->inverse_order;
     state->threshold = sudo_ctx->threshold;
 
     DEBUG(SSSDBG_TRACE_FUNC, "Running initgroups for [%s]\n", username);
@@ -823,7 +1437,7 @@ static void sudosrv_get_rules_initgr_done(struct tevent_req *subreq)
         goto done;
     }
 
-    subreq = sudosrv_refresh_rules_send(state, state->ev, state->rctx,
+    subreq = sudosrv_refresh_rules_send(state, state->ev, state->sudo_ctx,
                                         state->domain, state->threshold,
                                         state->orig_uid,
                                         state->orig_username,
@@ -863,12 +1477,12 @@ static void sudosrv_get_rules_done(struct tevent_req *subreq)
               "in cache.\n");
     }
 
-    ret = sudosrv_fetch_rules(state, state->rctx, state->type, state->domain,
+    ret = sudosrv_fetch_rules(state, state->sudo_ctx, state->type,
+                              state->domain,
                               state->cli_uid,
                               state->orig_uid,
                               state->orig_username,
                               state->groups,
-                              state->inverse_order,
                               &state->rules, &state->num_rules);
 
     if (ret != EOK) {
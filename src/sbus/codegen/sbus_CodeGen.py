@@ -262,6 +262,8 @@ def InitializeDataTypes():
                     DBusType="uua(uay)", RequireTalloc=True)
     DataType.Create("ifp_extra", "hash_table_t *",
                     DBusType="a{sas}", RequireTalloc=True)
+    DataType.Create("ifp_attrs_list", "hash_table_t **",
+                    DBusType="aa{sas}", RequireTalloc=True)
 
 
 def main():
@@ -64,18 +64,188 @@
 
 /* common functions */
 
-static int sss_cli_sd = -1; /* the sss client socket descriptor */
-static struct stat sss_cli_sb; /* the sss client stat buffer */
+struct sss_cli_conn {
+    int sd;                 /* the sss client socket descriptor */
+    struct stat sb;         /* the sss client stat buffer */
+    pid_t pid;              /* process which opened the socket */
+    bool busy;              /* in use by a thread (connection pool only) */
+};
+
+static struct sss_cli_conn sss_cli_conn = { .sd = -1 };
+
+static void sss_cli_close_conn(struct sss_cli_conn *conn)
+{
+    if (conn->sd != -1) {
+        close(conn->sd);
+        conn->sd = -1;
+    }
+}
+
+/* NSS connection pool
+ *
+ * By default all NSS requests of a process share one socket which is
+ * serialized by sss_nss_lock(). If the environment variable
+ * SSS_NSS_CONNECTION_POOL is set to a number between 1 and
+ * SSS_CLI_CONN_POOL_MAX, single object lookups (see
+ * sss_cli_conn_pool_cmd()) use one of that many sockets instead and
+ * sss_nss_lookup_lock() does not serialize them. Enumerations keep
+ * using the shared socket since the responder keeps their state per
+ * connection. */
+#define SSS_CLI_CONN_POOL_MAX 16
+
+#if HAVE_PTHREAD
+static struct sss_cli_conn_pool {
+    pthread_once_t once;
+    pthread_mutex_t mtx;
+    pthread_cond_t cond;
+    size_t size;
+    pid_t pid;
+    struct sss_cli_conn conns[SSS_CLI_CONN_POOL_MAX];
+} sss_cli_conn_pool = { .once = PTHREAD_ONCE_INIT,
+                        .mtx = PTHREAD_MUTEX_INITIALIZER,
+                        .cond = PTHREAD_COND_INITIALIZER };
+
+static void sss_cli_conn_pool_init(void)
+{
+    char *envval;
+    char *endptr;
+    long size;
+    size_t c;
+
+    for (c = 0; c < SSS_CLI_CONN_POOL_MAX; c++) {
+        sss_cli_conn_pool.conns[c].sd = -1;
+    }
+
+    envval = getenv("SSS_NSS_CONNECTION_POOL");
+    if (envval == NULL || *envval == '\0') {
+        return;
+    }
+
+    errno = 0;
+    size = strtol(envval, &endptr, 10);
+    if (errno != 0 || *endptr != '\0' || size <= 0) {
+        return;
+    }
+
+    if (size > SSS_CLI_CONN_POOL_MAX) {
+        size = SSS_CLI_CONN_POOL_MAX;
+    }
+
+    sss_cli_conn_pool.size = size;
+    sss_cli_conn_pool.pid = getpid();
+}
+
+static bool sss_cli_conn_pool_enabled(void)
+{
+    pthread_once(&sss_cli_conn_pool.once, sss_cli_conn_pool_init);
+
+    return sss_cli_conn_pool.size > 0;
+}
+
+/* Commands which do not depend on any state kept by the responder for the
+ * connection and whose callers do not rely on sss_nss_lock() to protect
+ * static data. */
+static bool sss_cli_conn_pool_cmd(enum sss_cli_command cmd)
+{
+    switch (cmd) {
+    case SSS_NSS_GETPWNAM:
+    case SSS_NSS_GETPWUID:
+    case SSS_NSS_INITGR:
+        return true;
+    default:
+        return false;
+    }
+}
+
+static struct sss_cli_conn *sss_cli_conn_get(enum sss_cli_command cmd,
+                                             int *old_cancel_state)
+{
+    struct sss_cli_conn *conn = NULL;
+    size_t c;
+
+    if (!sss_cli_conn_pool_enabled() || !sss_cli_conn_pool_cmd(cmd)) {
+        return &sss_cli_conn;
+    }
+
+    /* the request must not be cancelled while a connection is held */
+    pthread_setcancelstate(PTHREAD_CANCEL_DISABLE, old_cancel_state);
+    pthread_mutex_lock(&sss_cli_conn_pool.mtx);
+
+    if (sss_cli_conn_pool.pid != getpid()) {
+        /* threads of the parent process do not exist after fork,
+         * sockets are checked in sss_cli_check_socket() */
+        for (c = 0; c < sss_cli_conn_pool.size; c++) {
+            sss_cli_conn_pool.conns[c].busy = false;
+        }
+        sss_cli_conn_pool.pid = getpid();
+    }
+
+    while (conn == NULL) {
+        for (c = 0; c < sss_cli_conn_pool.size; c++) {
+            if (!sss_cli_conn_pool.conns[c].busy) {
+                conn = &sss_cli_conn_pool.conns[c];
+                break;
+            }
+        }
+
+        if (conn == NULL) {
+            pthread_cond_wait(&sss_cli_conn_pool.cond,
+                              &sss_cli_conn_pool.mtx);
+        }
+    }
+
+    conn->busy = true;
+    pthread_mutex_unlock(&sss_cli_conn_pool.mtx);
+
+    return conn;
+}
+
+static void sss_cli_conn_put(struct sss_cli_conn *conn, int old_cancel_state)
+{
+    if (conn == &sss_cli_conn) {
+        return;
+    }
+
+    pthread_mutex_lock(&sss_cli_conn_pool.mtx);
+    conn->busy = false;
+    pthread_cond_signal(&sss_cli_conn_pool.cond);
+    pthread_mutex_unlock(&sss_cli_conn_pool.mtx);
+    pthread_setcancelstate(old_cancel_state, NULL);
+}
+
+static void sss_cli_conn_pool_close(void)
+{
+    size_t c;
+
+    for (c = 0; c < sss_cli_conn_pool.size; c++) {
+        sss_cli_close_conn(&sss_cli_conn_pool.conns[c]);
+    }
+}
+#else
+static struct sss_cli_conn *sss_cli_conn_get(enum sss_cli_command cmd,
+                                             int *old_cancel_state)
+{
+    return &sss_cli_conn;
+}
+
+static void sss_cli_conn_put(struct sss_cli_conn *conn, int old_cancel_state)
+{
+    return;
+}
+
+static void sss_cli_conn_pool_close(void)
+{
+    return;
+}
+#endif /* HAVE_PTHREAD */
 
 #if HAVE_FUNCTION_ATTRIBUTE_DESTRUCTOR
 __attribute__((destructor))
 #endif
 static void sss_cli_close_socket(void)
 {
-    if (sss_cli_sd != -1) {
-        close(sss_cli_sd);
-        sss_cli_sd = -1;
-    }
+    sss_cli_close_conn(&sss_cli_conn);
+    sss_cli_conn_pool_close();
 }
 
 /* Requests:
@@ -86,7 +256,8 @@ static void sss_cli_close_socket(void)
  * byte 12-15: 32bit unsigned (reserved)
  * byte 16-X: (optional) request structure associated to the command code used
  */
-static enum sss_status sss_cli_send_req(enum sss_cli_command cmd,
+static enum sss_status sss_cli_send_req(struct sss_cli_conn *conn,
+                                        enum sss_cli_command cmd,
                                         struct sss_cli_req_data *rd,
                                         int timeout,
                                         int *errnop)
@@ -107,7 +278,7 @@ static enum sss_status sss_cli_send_req(enum sss_cli_command cmd,
         int res, error;
 
         *errnop = 0;
-        pfd.fd = sss_cli_sd;
+        pfd.fd = conn->sd;
         pfd.events = POLLOUT;
 
         do {
@@ -141,19 +312,19 @@ static enum sss_status sss_cli_send_req(enum sss_cli_command cmd,
             break;
         }
         if (*errnop) {
-            sss_cli_close_socket();
+            sss_cli_close_conn(conn);
             return SSS_STATUS_UNAVAIL;
         }
 
         errno = 0;
         if (datasent < SSS_NSS_HEADER_SIZE) {
-            res = send(sss_cli_sd,
+            res = send(conn->sd,
                        (char *)header + datasent,
                        SSS_NSS_HEADER_SIZE - datasent,
                        SSS_DEFAULT_WRITE_FLAGS);
         } else {
             rdsent = datasent - SSS_NSS_HEADER_SIZE;
-            res = send(sss_cli_sd,
+            res = send(conn->sd,
                        (const char *)rd->data + rdsent,
                        rd->len - rdsent,
                        SSS_DEFAULT_WRITE_FLAGS);
@@ -169,7 +340,7 @@ static enum sss_status sss_cli_send_req(enum sss_cli_command cmd,
             }
 
             /* Write failed */
-            sss_cli_close_socket();
+            sss_cli_close_conn(conn);
             *errnop = error;
             return SSS_STATUS_UNAVAIL;
         }
@@ -189,7 +360,8 @@ static enum sss_status sss_cli_send_req(enum sss_cli_command cmd,
  * byte 16-X: (optional) reply structure associated to the command code used
  */
 
-static enum sss_status sss_cli_recv_rep(enum sss_cli_command cmd,
+static enum sss_status sss_cli_recv_rep(struct sss_cli_conn *conn,
+                                        enum sss_cli_command cmd,
                                         int timeout,
                                         uint8_t **_buf, int *_len,
                                         int *errnop)
@@ -216,7 +388,7 @@ static enum sss_status sss_cli_recv_rep(enum sss_cli_command cmd,
         int bufrecv;
         int res, error;
 
-        pfd.fd = sss_cli_sd;
+        pfd.fd = conn->sd;
         pfd.events = POLLIN;
 
         do {
@@ -253,19 +425,19 @@ static enum sss_status sss_cli_recv_rep(enum sss_cli_command cmd,
             break;
         }
         if (*errnop) {
-            sss_cli_close_socket();
+            sss_cli_close_conn(conn);
             ret = SSS_STATUS_UNAVAIL;
             goto failed;
         }
 
         errno = 0;
         if (datarecv < SSS_NSS_HEADER_SIZE) {
-            res = read(sss_cli_sd,
+            res = read(conn->sd,
                        (char *)header + datarecv,
                        SSS_NSS_HEADER_SIZE - datarecv);
         } else {
             bufrecv = datarecv - SSS_NSS_HEADER_SIZE;
-            res = read(sss_cli_sd,
+            res = read(conn->sd,
                        (char *) buf + bufrecv,
                        header[0] - datarecv);
         }
@@ -284,7 +456,7 @@ static enum sss_status sss_cli_recv_rep(enum sss_cli_command cmd,
              * since the transaction has failed half way
              * through. */
 
-            sss_cli_close_socket();
+            sss_cli_close_conn(conn);
             *errnop = error;
             ret = SSS_STATUS_UNAVAIL;
             goto failed;
@@ -298,7 +470,7 @@ static enum sss_status sss_cli_recv_rep(enum sss_cli_command cmd,
              * been read, do checks and proceed */
             if (header[2] != 0) {
                 /* server side error */
-                sss_cli_close_socket();
+                sss_cli_close_conn(conn);
                 *errnop = header[2];
                 if (*errnop == EAGAIN) {
                     ret = SSS_STATUS_TRYAGAIN;
@@ -310,7 +482,7 @@ static enum sss_status sss_cli_recv_rep(enum sss_cli_command cmd,
             }
             if (header[1] != cmd) {
                 /* wrong command id */
-                sss_cli_close_socket();
+                sss_cli_close_conn(conn);
                 *errnop = EBADMSG;
                 ret = SSS_STATUS_UNAVAIL;
                 goto failed;
@@ -319,7 +491,7 @@ static enum sss_status sss_cli_recv_rep(enum sss_cli_command cmd,
                 len = header[0] - SSS_NSS_HEADER_SIZE;
                 buf = malloc(len);
                 if (!buf) {
-                    sss_cli_close_socket();
+                    sss_cli_close_conn(conn);
                     *errnop = ENOMEM;
                     ret = SSS_STATUS_UNAVAIL;
                     goto failed;
@@ -329,7 +501,7 @@ static enum sss_status sss_cli_recv_rep(enum sss_cli_command cmd,
     }
 
     if (pollhup) {
-        sss_cli_close_socket();
+        sss_cli_close_conn(conn);
     }
 
     *_len = len;
@@ -345,6 +517,7 @@ failed:
 /* this function will check command codes match and returned length is ok */
 /* repbuf and replen report only the data section not the header */
 static enum sss_status sss_cli_make_request_nochecks(
+                                       struct sss_cli_conn *conn,
                                        enum sss_cli_command cmd,
                                        struct sss_cli_req_data *rd,
                                        int timeout,
@@ -356,13 +529,13 @@ static enum sss_status sss_cli_make_request_nochecks(
     int len = 0;
 
     /* send data */
-    ret = sss_cli_send_req(cmd, rd, timeout, errnop);
+    ret = sss_cli_send_req(conn, cmd, rd, timeout, errnop);
     if (ret != SSS_STATUS_SUCCESS) {
         return ret;
     }
 
     /* data sent, now get reply */
-    ret = sss_cli_recv_rep(cmd, timeout, &buf, &len, errnop);
+    ret = sss_cli_recv_rep(conn, cmd, timeout, &buf, &len, errnop);
     if (ret != SSS_STATUS_SUCCESS) {
         return ret;
     }
@@ -388,7 +561,8 @@ static enum sss_status sss_cli_make_request_nochecks(
  * 0-3: 32bit unsigned version number
  */
 
-static bool sss_cli_check_version(const char *socket_name, int timeout)
+static bool sss_cli_check_version(struct sss_cli_conn *conn,
+                                  const char *socket_name, int timeout)
 {
     uint8_t *repbuf = NULL;
     size_t replen;
@@ -418,8 +592,8 @@ static bool sss_cli_check_version(const char *socket_name, int timeout)
     req.len = sizeof(expected_version);
     req.data = &expected_version;
 
-    nret = sss_cli_make_request_nochecks(SSS_GET_VERSION, &req, timeout,
-                                         &repbuf, &replen, &errnop);
+    nret = sss_cli_make_request_nochecks(conn, SSS_GET_VERSION, &req,
+                                         timeout, &repbuf, &replen, &errnop);
     if (nret != SSS_STATUS_SUCCESS) {
         return false;
     }
@@ -529,7 +703,8 @@ static int make_safe_fd(int fd)
     return new_fd;
 }
 
-static int sss_cli_open_socket(int *errnop, const char *socket_name, int timeout)
+static int sss_cli_open_socket(struct sss_cli_conn *conn, int *errnop,
+                               const char *socket_name, int timeout)
 {
     struct sockaddr_un nssaddr;
     bool inprogress = true;
@@ -624,7 +799,7 @@ static int sss_cli_open_socket(int *errnop, const char *socket_name, int timeout
         return -1;
     }
 
-    ret = fstat(sd, &sss_cli_sb);
+    ret = fstat(sd, &conn->sb);
     if (ret != 0) {
         close(sd);
         return -1;
@@ -633,35 +808,35 @@ static int sss_cli_open_socket(int *errnop, const char *socket_name, int timeout
     return sd;
 }
 
-static enum sss_status sss_cli_check_socket(int *errnop,
+static enum sss_status sss_cli_check_socket(struct sss_cli_conn *conn,
+                                            int *errnop,
                                             const char *socket_name,
                                             int timeout)
 {
-    static pid_t mypid;
     struct stat mysb;
     int mysd;
     int ret;
 
-    if (getpid() != mypid) {
-        ret = fstat(sss_cli_sd, &mysb);
+    if (getpid() != conn->pid) {
+        ret = fstat(conn->sd, &mysb);
         if (ret == 0) {
             if (S_ISSOCK(mysb.st_mode) &&
-                mysb.st_dev == sss_cli_sb.st_dev &&
-                mysb.st_ino == sss_cli_sb.st_ino) {
-                sss_cli_close_socket();
+                mysb.st_dev == conn->sb.st_dev &&
+                mysb.st_ino == conn->sb.st_ino) {
+                sss_cli_close_conn(conn);
             }
         }
-        sss_cli_sd = -1;
-        mypid = getpid();
+        conn->sd = -1;
+        conn->pid = getpid();
     }
 
     /* check if the socket has been closed on the other side */
-    if (sss_cli_sd != -1) {
+    if (conn->sd != -1) {
         struct pollfd pfd;
         int res, error;
 
         *errnop = 0;
-        pfd.fd = sss_cli_sd;
+        pfd.fd = conn->sd;
         pfd.events = POLLIN | POLLOUT;
 
         do {
@@ -698,21 +873,21 @@ static enum sss_status sss_cli_check_socket(int *errnop,
             return SSS_STATUS_SUCCESS;
         }
 
-        sss_cli_close_socket();
+        sss_cli_close_conn(conn);
     }
 
-    mysd = sss_cli_open_socket(errnop, socket_name, timeout);
+    mysd = sss_cli_open_socket(conn, errnop, socket_name, timeout);
     if (mysd == -1) {
         return SSS_STATUS_UNAVAIL;
     }
 
-    sss_cli_sd = mysd;
+    conn->sd = mysd;
 
-    if (sss_cli_check_version(socket_name, timeout)) {
+    if (sss_cli_check_version(conn, socket_name, timeout)) {
         return SSS_STATUS_SUCCESS;
     }
 
-    sss_cli_close_socket();
+    sss_cli_close_conn(conn);
     *errnop = EFAULT;
     return SSS_STATUS_UNAVAIL;
 }
@@ -725,6 +900,8 @@ enum nss_status sss_nss_make_request_timeout(enum sss_cli_command cmd,
                                              uint8_t **repbuf, size_t *replen,
                                              int *errnop)
 {
+    struct sss_cli_conn *conn;
+    int old_cancel_state;
     enum sss_status ret;
     char *envval;
 
@@ -734,8 +911,11 @@ enum nss_status sss_nss_make_request_timeout(enum sss_cli_command cmd,
         return NSS_STATUS_NOTFOUND;
     }
 
-    ret = sss_cli_check_socket(errnop, SSS_NSS_SOCKET_NAME, timeout);
+    conn = sss_cli_conn_get(cmd, &old_cancel_state);
+
+    ret = sss_cli_check_socket(conn, errnop, SSS_NSS_SOCKET_NAME, timeout);
     if (ret != SSS_STATUS_SUCCESS) {
+        sss_cli_conn_put(conn, old_cancel_state);
 #ifdef NONSTANDARD_SSS_NSS_BEHAVIOUR
         *errnop = 0;
         errno = 0;
@@ -745,12 +925,14 @@ enum nss_status sss_nss_make_request_timeout(enum sss_cli_command cmd,
 #endif
     }
 
-    ret = sss_cli_make_request_nochecks(cmd, rd, timeout, repbuf, replen,
-                                        errnop);
+    ret = sss_cli_make_request_nochecks(conn, cmd, rd, timeout,
+                                        repbuf, replen, errnop);
     if (ret == SSS_STATUS_UNAVAIL && *errnop == EPIPE) {
         /* try reopen socket */
-        ret = sss_cli_check_socket(errnop, SSS_NSS_SOCKET_NAME, timeout);
+        ret = sss_cli_check_socket(conn, errnop, SSS_NSS_SOCKET_NAME,
+                                   timeout);
         if (ret != SSS_STATUS_SUCCESS) {
+            sss_cli_conn_put(conn, old_cancel_state);
 #ifdef NONSTANDARD_SSS_NSS_BEHAVIOUR
             *errnop = 0;
             errno = 0;
@@ -761,9 +943,12 @@ enum nss_status sss_nss_make_request_timeout(enum sss_cli_command cmd,
         }
 
         /* and make request one more time */
-        ret = sss_cli_make_request_nochecks(cmd, rd, timeout, repbuf, replen,
-                                            errnop);
+        ret = sss_cli_make_request_nochecks(conn, cmd, rd, timeout,
+                                            repbuf, replen, errnop);
     }
+
+    sss_cli_conn_put(conn, old_cancel_state);
+
     switch (ret) {
     case SSS_STATUS_TRYAGAIN:
         return NSS_STATUS_TRYAGAIN;
@@ -795,7 +980,7 @@ int sss_pac_check_and_open(void)
     enum sss_status ret;
     int errnop;
 
-    ret = sss_cli_check_socket(&errnop, SSS_PAC_SOCKET_NAME,
+    ret = sss_cli_check_socket(&sss_cli_conn, &errnop, SSS_PAC_SOCKET_NAME,
                                SSS_CLI_SOCKET_TIMEOUT);
     if (ret != SSS_STATUS_SUCCESS) {
         return EIO;
@@ -819,23 +1004,25 @@ int sss_pac_make_request(enum sss_cli_command cmd,
         return NSS_STATUS_NOTFOUND;
     }
 
-    ret = sss_cli_check_socket(errnop, SSS_PAC_SOCKET_NAME, timeout);
+    ret = sss_cli_check_socket(&sss_cli_conn, errnop, SSS_PAC_SOCKET_NAME,
+                               timeout);
     if (ret != SSS_STATUS_SUCCESS) {
         return NSS_STATUS_UNAVAIL;
     }
 
-    ret = sss_cli_make_request_nochecks(cmd, rd, timeout, repbuf, replen,
-                                        errnop);
+    ret = sss_cli_make_request_nochecks(&sss_cli_conn, cmd, rd, timeout,
+                                        repbuf, replen, errnop);
     if (ret == SSS_STATUS_UNAVAIL && *errnop == EPIPE) {
         /* try reopen socket */
-        ret = sss_cli_check_socket(errnop, SSS_PAC_SOCKET_NAME, timeout);
+        ret = sss_cli_check_socket(&sss_cli_conn, errnop, SSS_PAC_SOCKET_NAME,
+                               timeout);
         if (ret != SSS_STATUS_SUCCESS) {
             return NSS_STATUS_UNAVAIL;
         }
 
         /* and make request one more time */
-        ret = sss_cli_make_request_nochecks(cmd, rd, timeout, repbuf, replen,
-                                            errnop);
+        ret = sss_cli_make_request_nochecks(&sss_cli_conn, cmd, rd, timeout,
+                                            repbuf, replen, errnop);
     }
     switch (ret) {
     case SSS_STATUS_TRYAGAIN:
@@ -955,32 +1142,35 @@ int sss_pam_make_request(enum sss_cli_command cmd,
         }
     }
 
-    status = sss_cli_check_socket(errnop, socket_name, timeout);
+    status = sss_cli_check_socket(&sss_cli_conn, errnop, socket_name,
+                                  timeout);
     if (status != SSS_STATUS_SUCCESS) {
         ret = PAM_SERVICE_ERR;
         goto out;
     }
 
-    error = check_server_cred(sss_cli_sd);
+    error = check_server_cred(sss_cli_conn.sd);
     if (error != 0) {
-        sss_cli_close_socket();
+        sss_cli_close_conn(&sss_cli_conn);
         *errnop = error;
         ret = PAM_SERVICE_ERR;
         goto out;
     }
 
-    status = sss_cli_make_request_nochecks(cmd, rd, timeout, repbuf, replen,
-                                           errnop);
+    status = sss_cli_make_request_nochecks(&sss_cli_conn, cmd, rd, timeout,
+                                           repbuf, replen, errnop);
     if (status == SSS_STATUS_UNAVAIL && *errnop == EPIPE) {
         /* try reopen socket */
-        status = sss_cli_check_socket(errnop, socket_name, timeout);
+        status = sss_cli_check_socket(&sss_cli_conn, errnop, socket_name,
+                                  timeout);
         if (status != SSS_STATUS_SUCCESS) {
             ret = PAM_SERVICE_ERR;
             goto out;
         }
 
         /* and make request one more time */
-        status = sss_cli_make_request_nochecks(cmd, rd, timeout, repbuf, replen,
+        status = sss_cli_make_request_nochecks(&sss_cli_conn, cmd, rd,
+                                               timeout, repbuf, replen,
                                                errnop);
     }
 
@@ -999,10 +1189,7 @@ void sss_pam_close_fd(void)
 {
     sss_pam_lock();
 
-    if (sss_cli_sd != -1) {
-        close(sss_cli_sd);
-        sss_cli_sd = -1;
-    }
+    sss_cli_close_conn(&sss_cli_conn);
 
     sss_pam_unlock();
 }
@@ -1017,23 +1204,25 @@ sss_cli_make_request_with_checks(enum sss_cli_command cmd,
 {
     enum sss_status ret = SSS_STATUS_UNAVAIL;
 
-    ret = sss_cli_check_socket(errnop, socket_name, timeout);
+    ret = sss_cli_check_socket(&sss_cli_conn, errnop, socket_name,
+                               timeout);
     if (ret != SSS_STATUS_SUCCESS) {
         return SSS_STATUS_UNAVAIL;
     }
 
-    ret = sss_cli_make_request_nochecks(cmd, rd, timeout, repbuf, replen,
-                                        errnop);
+    ret = sss_cli_make_request_nochecks(&sss_cli_conn, cmd, rd, timeout,
+                                        repbuf, replen, errnop);
     if (ret == SSS_STATUS_UNAVAIL && *errnop == EPIPE) {
         /* try reopen socket */
-        ret = sss_cli_check_socket(errnop, socket_name, timeout);
+        ret = sss_cli_check_socket(&sss_cli_conn, errnop, socket_name,
+                               timeout);
         if (ret != SSS_STATUS_SUCCESS) {
             return SSS_STATUS_UNAVAIL;
         }
 
         /* and make request one more time */
-        ret = sss_cli_make_request_nochecks(cmd, rd, timeout, repbuf, replen,
-                                            errnop);
+        ret = sss_cli_make_request_nochecks(&sss_cli_conn, cmd, rd, timeout,
+                                            repbuf, replen, errnop);
     }
 
     return ret;
@@ -1167,6 +1356,21 @@ void sss_nss_unlock(void)
     sss_mt_unlock(&sss_nss_mtx);
 }
 
+/* NSS single object lookups do not need to be serialized when they
+ * use the connection pool */
+void sss_nss_lookup_lock(void)
+{
+    if (!sss_cli_conn_pool_enabled()) {
+        sss_mt_lock(&sss_nss_mtx);
+    }
+}
+void sss_nss_lookup_unlock(void)
+{
+    if (!sss_cli_conn_pool_enabled()) {
+        sss_mt_unlock(&sss_nss_mtx);
+    }
+}
+
 /* NSS mutex wrappers */
 void sss_pam_lock(void)
 {
@@ -1202,6 +1406,8 @@ void sss_pac_unlock(void)
 /* sorry no mutexes available */
 void sss_nss_lock(void) { return; }
 void sss_nss_unlock(void) { return; }
+void sss_nss_lookup_lock(void) { return; }
+void sss_nss_lookup_unlock(void) { return; }
 void sss_pam_lock(void) { return; }
 void sss_pam_unlock(void) { return; }
 void sss_nss_mc_lock(void) { return; }
@@ -23,6 +23,7 @@
 */
 
 #include <stdlib.h>
+#include <stdbool.h>
 #include <errno.h>
 #include <nss.h>
 
@@ -201,76 +202,46 @@ done:
     return ret;
 }
 
-static int sss_nss_getyyybyxxx(union input inp, enum sss_cli_command cmd,
-                               unsigned int timeout, struct output *out)
+static int sss_nss_mc_getyyybyxxx(union input inp, size_t inp_len,
+                                  enum sss_cli_command cmd,
+                                  struct output *out)
 {
-    int ret;
-    size_t inp_len;
-    struct sss_cli_req_data rd;
-    uint8_t *repbuf = NULL;
-    size_t replen;
-    int errnop;
-    enum nss_status nret;
-    uint32_t num_results;
-    char *str = NULL;
-    size_t data_len;
-    uint32_t c;
-    struct sss_nss_kv *kv_list;
-    char **names;
-    enum sss_id_type *types;
-    int time_left = SSS_CLI_SOCKET_TIMEOUT;
-
     switch (cmd) {
     case SSS_NSS_GETSIDBYNAME:
-    case SSS_NSS_GETNAMEBYSID:
-    case SSS_NSS_GETIDBYSID:
-    case SSS_NSS_GETORIGBYNAME:
-        ret = sss_strnlen(inp.str, 2048, &inp_len);
-        if (ret != EOK) {
-            return EINVAL;
-        }
-
-        rd.len = inp_len + 1;
-        rd.data = inp.str;
-
-        break;
-    case SSS_NSS_GETNAMEBYCERT:
-    case SSS_NSS_GETLISTBYCERT:
-        ret = sss_strnlen(inp.str, 10 * 1024 , &inp_len);
-        if (ret != EOK) {
-            return EINVAL;
-        }
-
-        rd.len = inp_len + 1;
-        rd.data = inp.str;
-
-        break;
+        return sss_nss_mc_getsidbyname(inp.str, inp_len,
+                                       &out->d.str, &out->type);
     case SSS_NSS_GETSIDBYID:
+        return sss_nss_mc_getsidbyid(inp.id, SSS_ID_TYPE_NOT_SPECIFIED,
+                                     &out->d.str, &out->type);
     case SSS_NSS_GETSIDBYUID:
+        return sss_nss_mc_getsidbyid(inp.id, SSS_ID_TYPE_UID,
+                                     &out->d.str, &out->type);
     case SSS_NSS_GETSIDBYGID:
-        rd.len = sizeof(uint32_t);
-        rd.data = &inp.id;
-
-        break;
+        return sss_nss_mc_getsidbyid(inp.id, SSS_ID_TYPE_GID,
+                                     &out->d.str, &out->type);
+    case SSS_NSS_GETNAMEBYSID:
+        return sss_nss_mc_getnamebysid(inp.str, inp_len,
+                                       &out->d.str, &out->type);
+    case SSS_NSS_GETIDBYSID:
+        return sss_nss_mc_getidbysid(inp.str, inp_len,
+                                     &out->d.id, &out->type);
     default:
-        return EINVAL;
-    }
-
-    if (timeout == NO_TIMEOUT) {
-        sss_nss_lock();
-    } else {
-        ret = sss_nss_timedlock(timeout, &time_left);
-        if (ret != 0) {
-            return ret;
-        }
+        return ENOENT;
     }
+}
 
-    nret = sss_nss_make_request_timeout(cmd, &rd, time_left, &repbuf, &replen,
-                                        &errnop);
-    if (nret != NSS_STATUS_SUCCESS) {
-        ret = nss_status_to_errno(nret);
-        goto done;
-    }
+static int sss_nss_parse_reply(enum sss_cli_command cmd,
+                               uint8_t *repbuf, size_t replen,
+                               struct output *out)
+{
+    int ret;
+    uint32_t num_results;
+    char *str = NULL;
+    size_t data_len;
+    uint32_t c;
+    struct sss_nss_kv *kv_list;
+    char **names;
+    enum sss_id_type *types;
 
     if (replen < 8) {
         ret = EBADMSG;
@@ -354,8 +325,6 @@ static int sss_nss_getyyybyxxx(union input inp, enum sss_cli_command cmd,
     ret = EOK;
 
 done:
-    sss_nss_unlock();
-    free(repbuf);
     if (ret != EOK) {
         free(str);
     }
@@ -363,6 +332,365 @@ done:
     return ret;
 }
 
+static int sss_nss_getyyybyxxx(union input inp, enum sss_cli_command cmd,
+                               unsigned int timeout, struct output *out)
+{
+    int ret;
+    size_t inp_len = 0;
+    struct sss_cli_req_data rd;
+    uint8_t *repbuf = NULL;
+    size_t replen;
+    int errnop;
+    enum nss_status nret;
+    int time_left = SSS_CLI_SOCKET_TIMEOUT;
+
+    switch (cmd) {
+    case SSS_NSS_GETSIDBYNAME:
+    case SSS_NSS_GETNAMEBYSID:
+    case SSS_NSS_GETIDBYSID:
+    case SSS_NSS_GETORIGBYNAME:
+        ret = sss_strnlen(inp.str, 2048, &inp_len);
+        if (ret != EOK) {
+            return EINVAL;
+        }
+
+        rd.len = inp_len + 1;
+        rd.data = inp.str;
+
+        break;
+    case SSS_NSS_GETNAMEBYCERT:
+    case SSS_NSS_GETLISTBYCERT:
+        ret = sss_strnlen(inp.str, 10 * 1024 , &inp_len);
+        if (ret != EOK) {
+            return EINVAL;
+        }
+
+        rd.len = inp_len + 1;
+        rd.data = inp.str;
+
+        break;
+    case SSS_NSS_GETSIDBYID:
+    case SSS_NSS_GETSIDBYUID:
+    case SSS_NSS_GETSIDBYGID:
+        rd.len = sizeof(uint32_t);
+        rd.data = &inp.id;
+
+        break;
+    default:
+        return EINVAL;
+    }
+
+    /* if the mmapped cache has no entry or cannot be used,
+     * fall back to socket based comms */
+    ret = sss_nss_mc_getyyybyxxx(inp, inp_len, cmd, out);
+    if (ret == EOK) {
+        return EOK;
+    }
+
+    if (timeout == NO_TIMEOUT) {
+        sss_nss_lock();
+    } else {
+        ret = sss_nss_timedlock(timeout, &time_left);
+        if (ret != 0) {
+            return ret;
+        }
+    }
+
+    /* previous thread might already initialize entry in mmap cache */
+    ret = sss_nss_mc_getyyybyxxx(inp, inp_len, cmd, out);
+    if (ret == EOK) {
+        goto done;
+    }
+
+    nret = sss_nss_make_request_timeout(cmd, &rd, time_left, &repbuf, &replen,
+                                        &errnop);
+    if (nret != NSS_STATUS_SUCCESS) {
+        ret = nss_status_to_errno(nret);
+        goto done;
+    }
+
+    ret = sss_nss_parse_reply(cmd, repbuf, replen, out);
+
+done:
+    sss_nss_unlock();
+    free(repbuf);
+
+    return ret;
+}
+
+void sss_nss_free_items(struct sss_nss_idmap_item *items, size_t num)
+{
+    size_t c;
+
+    if (items != NULL) {
+        for (c = 0; c < num; c++) {
+            free(items[c].str);
+        }
+        free(items);
+    }
+}
+
+static enum sss_cli_command sss_nss_list_to_single_cmd(enum sss_cli_command cmd)
+{
+    switch (cmd) {
+    case SSS_NSS_GETSIDBYNAME_LIST:
+        return SSS_NSS_GETSIDBYNAME;
+    case SSS_NSS_GETSIDBYID_LIST:
+        return SSS_NSS_GETSIDBYID;
+    case SSS_NSS_GETNAMEBYSID_LIST:
+        return SSS_NSS_GETNAMEBYSID;
+    case SSS_NSS_GETIDBYSID_LIST:
+        return SSS_NSS_GETIDBYSID;
+    default:
+        return SSS_CLI_NULL;
+    }
+}
+
+static void sss_nss_set_item(enum sss_cli_command cmd, struct output *out,
+                             struct sss_nss_idmap_item *item)
+{
+    item->status = EOK;
+    item->type = out->type;
+
+    if (cmd == SSS_NSS_GETIDBYSID) {
+        item->id = out->d.id;
+    } else {
+        item->str = out->d.str;
+    }
+}
+
+/* Parses the reply of a *_LIST command, see sss_cli.h for the format. */
+static int sss_nss_parse_list_reply(enum sss_cli_command cmd,
+                                    uint8_t *repbuf, size_t replen,
+                                    size_t *todo, size_t num_todo,
+                                    struct sss_nss_idmap_item *items)
+{
+    struct sss_nss_idmap_item *item;
+    struct output out;
+    uint32_t num_keys;
+    uint32_t status;
+    uint32_t len;
+    size_t rp;
+    size_t c;
+    int ret;
+
+    if (replen < LIST_START) {
+        return EBADMSG;
+    }
+
+    rp = 0;
+    SAFEALIGN_COPY_UINT32(&num_keys, repbuf, &rp);
+    if (num_keys != num_todo) {
+        return EBADMSG;
+    }
+
+    rp = LIST_START;
+    for (c = 0; c < num_todo; c++) {
+        item = &items[todo[c]];
+
+        if (replen - rp < 2 * sizeof(uint32_t)) {
+            return EBADMSG;
+        }
+
+        SAFEALIGN_COPY_UINT32(&status, repbuf + rp, &rp);
+        SAFEALIGN_COPY_UINT32(&len, repbuf + rp, &rp);
+        if (len > replen - rp) {
+            return EBADMSG;
+        }
+
+        if (status != EOK) {
+            item->status = status;
+        } else {
+            memset(&out, 0, sizeof(out));
+            ret = sss_nss_parse_reply(cmd, repbuf + rp, len, &out);
+            if (ret == EOK) {
+                sss_nss_set_item(cmd, &out, item);
+            } else {
+                item->status = ret;
+            }
+        }
+
+        rp += len;
+    }
+
+    return EOK;
+}
+
+static int sss_nss_getyyybyxxx_list(const union input *inp, size_t num,
+                                    enum sss_cli_command cmd,
+                                    unsigned int timeout,
+                                    struct sss_nss_idmap_item **_items)
+{
+    enum sss_cli_command single_cmd;
+    struct sss_nss_idmap_item *items = NULL;
+    struct sss_cli_req_data rd;
+    struct output out;
+    size_t *inp_len = NULL;
+    size_t *todo = NULL;
+    size_t num_todo = 0;
+    size_t num_chunk;
+    size_t key_len;
+    size_t next;
+    uint8_t *reqbuf = NULL;
+    size_t reqlen;
+    uint32_t num_keys;
+    uint8_t *repbuf = NULL;
+    size_t replen;
+    int errnop;
+    enum nss_status nret;
+    bool locked = false;
+    int time_left = SSS_CLI_SOCKET_TIMEOUT;
+    size_t c;
+    int ret;
+
+    single_cmd = sss_nss_list_to_single_cmd(cmd);
+    if (single_cmd == SSS_CLI_NULL || inp == NULL || num == 0) {
+        return EINVAL;
+    }
+
+    items = calloc(num, sizeof(struct sss_nss_idmap_item));
+    inp_len = calloc(num, sizeof(size_t));
+    todo = calloc(num, sizeof(size_t));
+    if (items == NULL || inp_len == NULL || todo == NULL) {
+        ret = ENOMEM;
+        goto done;
+    }
+
+    for (c = 0; c < num; c++) {
+        if (cmd != SSS_NSS_GETSIDBYID_LIST) {
+            if (inp[c].str == NULL || *inp[c].str == '\0') {
+                ret = EINVAL;
+                goto done;
+            }
+
+            ret = sss_strnlen(inp[c].str, 2048, &inp_len[c]);
+            if (ret != EOK) {
+                ret = EINVAL;
+                goto done;
+            }
+        }
+
+        /* only keys missing in the mmapped cache are sent to SSSD */
+        memset(&out, 0, sizeof(out));
+        ret = sss_nss_mc_getyyybyxxx(inp[c], inp_len[c], single_cmd, &out);
+        if (ret == EOK) {
+            sss_nss_set_item(single_cmd, &out, &items[c]);
+        } else {
+            items[c].status = ENOENT;
+            todo[num_todo] = c;
+            num_todo++;
+        }
+    }
+
+    if (num_todo == 0) {
+        ret = EOK;
+        goto done;
+    }
+
+    reqbuf = malloc(SSS_NSS_MAX_LIST_REQ_SIZE);
+    if (reqbuf == NULL) {
+        ret = ENOMEM;
+        goto done;
+    }
+
+    if (timeout == NO_TIMEOUT) {
+        sss_nss_lock();
+    } else {
+        ret = sss_nss_timedlock(timeout, &time_left);
+        if (ret != 0) {
+            goto done;
+        }
+    }
+    locked = true;
+
+    for (next = 0; next < num_todo; next += num_chunk) {
+        /* Fill as many keys as the responder accepts in a single request. */
+        reqlen = sizeof(uint32_t);
+        for (num_chunk = 0;
+             next + num_chunk < num_todo
+                && num_chunk < SSS_NSS_MAX_LIST_KEYS;
+             num_chunk++) {
+            c = todo[next + num_chunk];
+            key_len = (cmd == SSS_NSS_GETSIDBYID_LIST) ? sizeof(uint32_t)
+                                                       : inp_len[c] + 1;
+            if (reqlen + key_len
+                    > SSS_NSS_MAX_LIST_REQ_SIZE - SSS_NSS_HEADER_SIZE - 1) {
+                break;
+            }
+
+            if (cmd == SSS_NSS_GETSIDBYID_LIST) {
+                SAFEALIGN_COPY_UINT32(reqbuf + reqlen, &inp[c].id, NULL);
+            } else {
+                memcpy(reqbuf + reqlen, inp[c].str, key_len);
+            }
+            reqlen += key_len;
+        }
+
+        num_keys = num_chunk;
+        SAFEALIGN_COPY_UINT32(reqbuf, &num_keys, NULL);
+
+        rd.len = reqlen;
+        rd.data = reqbuf;
+
+        nret = sss_nss_make_request_timeout(cmd, &rd, time_left,
+                                            &repbuf, &replen, &errnop);
+        if (nret != NSS_STATUS_SUCCESS) {
+            ret = nss_status_to_errno(nret);
+            goto done;
+        }
+
+        ret = sss_nss_parse_list_reply(single_cmd, repbuf, replen,
+                                       todo + next, num_chunk, items);
+        free(repbuf);
+        repbuf = NULL;
+        if (ret != EOK) {
+            goto done;
+        }
+    }
+
+    ret = EOK;
+
+done:
+    if (locked) {
+        sss_nss_unlock();
+    }
+    free(repbuf);
+    free(reqbuf);
+    free(todo);
+    free(inp_len);
+    if (ret == EOK) {
+        *_items = items;
+    } else {
+        sss_nss_free_items(items, num);
+    }
+
+    return ret;
+}
+
+static int sss_nss_str_list_to_input(const char * const *strs, size_t num,
+                                     union input **_inp)
+{
+    union input *inp;
+    size_t c;
+
+    if (strs == NULL || num == 0) {
+        return EINVAL;
+    }
+
+    inp = calloc(num, sizeof(union input));
+    if (inp == NULL) {
+        return ENOMEM;
+    }
+
+    for (c = 0; c < num; c++) {
+        inp[c].str = strs[c];
+    }
+
+    *_inp = inp;
+
+    return EOK;
+}
+
 int sss_nss_getsidbyname_timeout(const char *fq_name, unsigned int timeout,
                                  char **sid, enum sss_id_type *type)
 {
@@ -611,3 +939,125 @@ int sss_nss_getlistbycert(const char *cert, char ***fq_name,
 {
     return sss_nss_getlistbycert_timeout(cert, NO_TIMEOUT, fq_name, type);
 }
+
+int sss_nss_getsidbyname_list_timeout(const char * const *fq_names,
+                                      size_t num, unsigned int timeout,
+                                      struct sss_nss_idmap_item **items)
+{
+    int ret;
+    union input *inp;
+
+    if (items == NULL) {
+        return EINVAL;
+    }
+
+    ret = sss_nss_str_list_to_input(fq_names, num, &inp);
+    if (ret != EOK) {
+        return ret;
+    }
+
+    ret = sss_nss_getyyybyxxx_list(inp, num, SSS_NSS_GETSIDBYNAME_LIST,
+                                   timeout, items);
+    free(inp);
+
+    return ret;
+}
+
+int sss_nss_getsidbyname_list(const char * const *fq_names, size_t num,
+                              struct sss_nss_idmap_item **items)
+{
+    return sss_nss_getsidbyname_list_timeout(fq_names, num, NO_TIMEOUT,
+                                             items);
+}
+
+int sss_nss_getsidbyid_list_timeout(const uint32_t *ids, size_t num,
+                                    unsigned int timeout,
+                                    struct sss_nss_idmap_item **items)
+{
+    int ret;
+    union input *inp;
+    size_t c;
+
+    if (ids == NULL || num == 0 || items == NULL) {
+        return EINVAL;
+    }
+
+    inp = calloc(num, sizeof(union input));
+    if (inp == NULL) {
+        return ENOMEM;
+    }
+
+    for (c = 0; c < num; c++) {
+        inp[c].id = ids[c];
+    }
+
+    ret = sss_nss_getyyybyxxx_list(inp, num, SSS_NSS_GETSIDBYID_LIST,
+                                   timeout, items);
+    free(inp);
+
+    return ret;
+}
+
+int sss_nss_getsidbyid_list(const uint32_t *ids, size_t num,
+                            struct sss_nss_idmap_item **items)
+{
+    return sss_nss_getsidbyid_list_timeout(ids, num, NO_TIMEOUT, items);
+}
+
+int sss_nss_getnamebysid_list_timeout(const char * const *sids, size_t num,
+                                      unsigned int timeout,
+                                      struct sss_nss_idmap_item **items)
+{
+    int ret;
+    union input *inp;
+
+    if (items == NULL) {
+        return EINVAL;
+    }
+
+    ret = sss_nss_str_list_to_input(sids, num, &inp);
+    if (ret != EOK) {
+        return ret;
+    }
+
+    ret = sss_nss_getyyybyxxx_list(inp, num, SSS_NSS_GETNAMEBYSID_LIST,
+                                   timeout, items);
+    free(inp);
+
+    return ret;
+}
+
+int sss_nss_getnamebysid_list(const char * const *sids, size_t num,
+                              struct sss_nss_idmap_item **items)
+{
+    return sss_nss_getnamebysid_list_timeout(sids, num, NO_TIMEOUT, items);
+}
+
+int sss_nss_getidbysid_list_timeout(const char * const *sids, size_t num,
+                                    unsigned int timeout,
+                                    struct sss_nss_idmap_item **items)
+{
+    int ret;
+    union input *inp;
+
+    if (items == NULL) {
+        return EINVAL;
+    }
+
+    ret = sss_nss_str_list_to_input(sids, num, &inp);
+    if (ret != EOK) {
+        return ret;
+    }
+
+    ret = sss_nss_getyyybyxxx_list(inp, num, SSS_NSS_GETIDBYSID_LIST,
+                                   timeout, items);
+    free(inp);
+
+    return ret;
+}
+
+int sss_nss_getidbysid_list(const char * const *sids, size_t num,
+                            struct sss_nss_idmap_item **items)
+{
+    return sss_nss_getidbysid_list_timeout(sids, num, NO_TIMEOUT, items);
+}
@@ -45,6 +45,20 @@ struct sss_nss_kv {
     char *value;
 };
 
+/**
+ * Result of a single key of a batched request
+ */
+struct sss_nss_idmap_item {
+    int status;            /**< 0 (EOK) on success, ENOENT if the object was
+                                not found or any other error code of the
+                                related single key call */
+    enum sss_id_type type; /**< Type of the object */
+    char *str;             /**< SID or fully qualified name, NULL for
+                                sss_nss_getidbysid_list() */
+    uint32_t id;           /**< POSIX ID, only set by
+                                sss_nss_getidbysid_list() */
+};
+
 /**
  * @brief Find SID by fully qualified name
  *
@@ -189,6 +203,78 @@ int sss_nss_getlistbycert(const char *cert, char ***fq_name,
  */
 void sss_nss_free_kv(struct sss_nss_kv *kv_list);
 
+/**
+ * @brief Find SIDs for a list of fully qualified names
+ *
+ * All names which cannot be answered from the memory cache are sent to SSSD
+ * in a single request (or a few if the list is long) and are resolved
+ * concurrently.
+ *
+ * @param[in] fq_names Array of fully qualified names of users or groups
+ * @param[in] num      Number of elements in fq_names
+ * @param[out] items   Array of num results in the order of fq_names, must be
+ *                     freed by the caller with sss_nss_free_items()
+ *
+ * @return
+ *  - 0 (EOK): success, the status of each name is stored in the related item
+ *  - EINVAL: input cannot be parsed
+ *  - ENOMEM: memory allocation failed
+ *  - EBADMSG: the reply of SSSD cannot be parsed
+ *  - see #sss_nss_getsidbyname for other error codes
+ */
+int sss_nss_getsidbyname_list(const char * const *fq_names, size_t num,
+                              struct sss_nss_idmap_item **items);
+
+/**
+ * @brief Find SIDs for a list of POSIX UIDs or GIDs
+ *
+ * @param[in] ids      Array of POSIX IDs
+ * @param[in] num      Number of elements in ids
+ * @param[out] items   Array of num results in the order of ids, must be
+ *                     freed by the caller with sss_nss_free_items()
+ *
+ * @return
+ *  - see #sss_nss_getsidbyname_list
+ */
+int sss_nss_getsidbyid_list(const uint32_t *ids, size_t num,
+                            struct sss_nss_idmap_item **items);
+
+/**
+ * @brief Return the fully qualified names for a list of SIDs
+ *
+ * @param[in] sids     Array of string representations of SIDs
+ * @param[in] num      Number of elements in sids
+ * @param[out] items   Array of num results in the order of sids, must be
+ *                     freed by the caller with sss_nss_free_items()
+ *
+ * @return
+ *  - see #sss_nss_getsidbyname_list
+ */
+int sss_nss_getnamebysid_list(const char * const *sids, size_t num,
+                              struct sss_nss_idmap_item **items);
+
+/**
+ * @brief Return the POSIX IDs for a list of SIDs
+ *
+ * @param[in] sids     Array of string representations of SIDs
+ * @param[in] num      Number of elements in sids
+ * @param[out] items   Array of num results in the order of sids, must be
+ *                     freed by the caller with sss_nss_free_items()
+ *
+ * @return
+ *  - see #sss_nss_getsidbyname_list
+ */
+int sss_nss_getidbysid_list(const char * const *sids, size_t num,
+                            struct sss_nss_idmap_item **items);
+
+/**
+ * @brief Free results returned by the sss_nss_*_list() calls
+ *
+ * @param[in] items    Array returned by one of the sss_nss_*_list() calls
+ * @param[in] num      Number of elements in items
+ */
+void sss_nss_free_items(struct sss_nss_idmap_item *items, size_t num);
+
 /**
  * Flags to control the behavior and the results for sss_*_ex() calls
  */
@@ -483,5 +569,71 @@ int sss_nss_getnamebycert_timeout(const char *cert, unsigned int timeout,
 int sss_nss_getlistbycert_timeout(const char *cert, unsigned int timeout,
                                   char ***fq_name, enum sss_id_type **type);
 
+/**
+ * @brief Find SIDs for a list of fully qualified names with timeout
+ *
+ * @param[in] fq_names Array of fully qualified names of users or groups
+ * @param[in] num      Number of elements in fq_names
+ * @param[in] timeout  timeout in milliseconds
+ * @param[out] items   Array of num results in the order of fq_names, must be
+ *                     freed by the caller with sss_nss_free_items()
+ *
+ * @return
+ *  - see #sss_nss_getsidbyname_list
+ *  - ETIME:     request timed out but was send to SSSD
+ *  - ETIMEDOUT: request timed out but was not send to SSSD
+ */
+int sss_nss_getsidbyname_list_timeout(const char * const *fq_names,
+                                      size_t num, unsigned int timeout,
+                                      struct sss_nss_idmap_item **items);
+
+/**
+ * @brief Find SIDs for a list of POSIX UIDs or GIDs with timeout
+ *
+ * @param[in] ids      Array of POSIX IDs
+ * @param[in] num      Number of elements in ids
+ * @param[in] timeout  timeout in milliseconds
+ * @param[out] items   Array of num results in the order of ids, must be
+ *                     freed by the caller with sss_nss_free_items()
+ *
+ * @return
+ *  - see #sss_nss_getsidbyname_list_timeout
+ */
+int sss_nss_getsidbyid_list_timeout(const uint32_t *ids, size_t num,
+                                    unsigned int timeout,
+                                    struct sss_nss_idmap_item **items);
+
+/**
+ * @brief Return the fully qualified names for a list of SIDs with timeout
+ *
+ * @param[in] sids     Array of string representations of SIDs
+ * @param[in] num      Number of elements in sids
+ * @param[in] timeout  timeout in milliseconds
+ * @param[out] items   Array of num results in the order of sids, must be
+ *                     freed by the caller with sss_nss_free_items()
+ *
+ * @return
+ *  - see #sss_nss_getsidbyname_list_timeout
+ */
+int sss_nss_getnamebysid_list_timeout(const char * const *sids, size_t num,
+                                      unsigned int timeout,
+                                      struct sss_nss_idmap_item **items);
+
+/**
+ * @brief Return the POSIX IDs for a list of SIDs with timeout
+ *
+ * @param[in] sids     Array of string representations of SIDs
+ * @param[in] num      Number of elements in sids
+ * @param[in] timeout  timeout in milliseconds
+ * @param[out] items   Array of num results in the order of sids, must be
+ *                     freed by the caller with sss_nss_free_items()
+ *
+ * @return
+ *  - see #sss_nss_getsidbyname_list_timeout
+ */
+int sss_nss_getidbysid_list_timeout(const char * const *sids, size_t num,
+                                    unsigned int timeout,
+                                    struct sss_nss_idmap_item **items);
+
 #endif /* IPA_389DS_PLUGIN_HELPER_CALLS */
 #endif /* SSS_NSS_IDMAP_H_ */
@@ -0,0 +1,334 @@
+/*
+    SSSD
+
+    NSS Responder Interface for ID-SID mappings - mmap cache readers
+
+    Copyright (C) 2026 Red Hat
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <errno.h>
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include <stddef.h>
+#include <time.h>
+
+#include "sss_client/nss_mc.h"
+#include "sss_client/idmap/sss_nss_idmap.h"
+#include "sss_client/idmap/sss_nss_idmap_private.h"
+
+static struct sss_cli_mc_ctx sid_mc_ctx = { UNINITIALIZED, -1, 0, NULL, 0,
+                                            NULL, 0, NULL, 0, 0 };
+
+enum sss_nss_mc_sid_key {
+    SSS_NSS_MC_SID_BY_SID,
+    SSS_NSS_MC_SID_BY_NAME,
+    SSS_NSS_MC_SID_BY_ID,
+};
+
+/* Checks the record and returns pointers to the SID and the name inside
+ * of it. The record must be a private copy returned by
+ * sss_nss_mc_get_record(). */
+static errno_t sss_nss_mc_sid_parse_rec(struct sss_mc_rec *rec,
+                                        const char **_sid,
+                                        const char **_name)
+{
+    struct sss_mc_sid_data *data;
+    const size_t strs_offset = offsetof(struct sss_mc_sid_data, strs);
+    size_t sid_len;
+    size_t name_len;
+
+    data = (struct sss_mc_sid_data *)rec->data;
+
+    /* Integrity check
+     * - all strings must be within copy of record
+     * - both strings must be zero-terminated
+     * - data->name must point either to the SID or to the name */
+    if (data->strs_len > rec->len
+            || data->strs_len > rec->len - sizeof(struct sss_mc_rec)
+                                - strs_offset) {
+        return EINVAL;
+    }
+
+    sid_len = strnlen(data->strs, data->strs_len) + 1;
+    if (sid_len >= data->strs_len) {
+        return EINVAL;
+    }
+
+    name_len = strnlen(data->strs + sid_len, data->strs_len - sid_len) + 1;
+    if (sid_len + name_len > data->strs_len) {
+        return EINVAL;
+    }
+
+    if (data->name != strs_offset && data->name != strs_offset + sid_len) {
+        return EINVAL;
+    }
+
+    *_sid = data->strs;
+    *_name = data->strs + sid_len;
+
+    return 0;
+}
+
+static bool sss_nss_mc_sid_type_match(enum sss_id_type requested,
+                                      enum sss_id_type type)
+{
+    switch (requested) {
+    case SSS_ID_TYPE_UID:
+        return type == SSS_ID_TYPE_UID || type == SSS_ID_TYPE_BOTH;
+    case SSS_ID_TYPE_GID:
+        return type == SSS_ID_TYPE_GID || type == SSS_ID_TYPE_BOTH;
+    default:
+        return true;
+    }
+}
+
+/* Walks the chain of the key and returns a copy of the first valid record
+ * matching it. When looking up by ID without a specific type users are
+ * preferred over groups, like the responder does. */
+static errno_t sss_nss_mc_sid_lookup(enum sss_nss_mc_sid_key key_type,
+                                     const char *key, size_t key_len,
+                                     uint32_t id,
+                                     enum sss_id_type id_type,
+                                     struct sss_mc_rec **_rec)
+{
+    struct sss_mc_rec *rec = NULL;
+    struct sss_mc_rec *candidate = NULL;
+    struct sss_mc_sid_data *data;
+    const size_t strs_offset = offsetof(struct sss_mc_sid_data, strs);
+    const char *rec_sid;
+    const char *rec_name;
+    uint32_t hash;
+    uint32_t slot;
+    int ret;
+
+    ret = sss_nss_mc_get_ctx("sid", &sid_mc_ctx);
+    if (ret) {
+        return ret;
+    }
+
+    /* hashes are calculated including the NULL terminator */
+    hash = sss_nss_mc_hash(&sid_mc_ctx, key, key_len + 1);
+    slot = sid_mc_ctx.hash_table[hash];
+
+    /* If slot is not within the bounds of mmapped region and
+     * it's value is not MC_INVALID_VAL, then the cache is
+     * probably corrupted. */
+    while (MC_SLOT_WITHIN_BOUNDS(slot, sid_mc_ctx.dt_size)) {
+        /* free record from previous iteration */
+        free(rec);
+        rec = NULL;
+
+        ret = sss_nss_mc_get_record(&sid_mc_ctx, slot, &rec);
+        if (ret) {
+            goto done;
+        }
+
+        slot = sss_nss_mc_next_slot_with_hash(rec, hash);
+
+        if (key_type == SSS_NSS_MC_SID_BY_ID) {
+            if (hash != rec->hash2) {
+                continue;
+            }
+        } else if (hash != rec->hash1) {
+            continue;
+        }
+
+        if (rec->expire < time(NULL)) {
+            continue;
+        }
+
+        ret = sss_nss_mc_sid_parse_rec(rec, &rec_sid, &rec_name);
+        if (ret) {
+            ret = ENOENT;
+            goto done;
+        }
+
+        data = (struct sss_mc_sid_data *)rec->data;
+
+        switch (key_type) {
+        case SSS_NSS_MC_SID_BY_SID:
+            if (data->name == strs_offset && strcmp(key, rec_sid) == 0) {
+                goto found;
+            }
+            break;
+        case SSS_NSS_MC_SID_BY_NAME:
+            if (data->name != strs_offset && strcmp(key, rec_name) == 0) {
+                goto found;
+            }
+            break;
+        case SSS_NSS_MC_SID_BY_ID:
+            if (data->name != strs_offset || data->id != id
+                    || !sss_nss_mc_sid_type_match(id_type, data->type)) {
+                break;
+            }
+
+            if (id_type == SSS_ID_TYPE_NOT_SPECIFIED
+                    && data->type == SSS_ID_TYPE_GID) {
+                /* keep looking for a user with this ID */
+                if (candidate == NULL) {
+                    candidate = rec;
+                    rec = NULL;
+                }
+                break;
+            }
+
+            goto found;
+        }
+    }
+
+    if (candidate != NULL) {
+        free(rec);
+        rec = candidate;
+        candidate = NULL;
+        goto found;
+    }
+
+    ret = ENOENT;
+    goto done;
+
+found:
+    *_rec = rec;
+    rec = NULL;
+    ret = 0;
+
+done:
+    free(rec);
+    free(candidate);
+    __sync_sub_and_fetch(&sid_mc_ctx.active_threads, 1);
+    return ret;
+}
+
+errno_t sss_nss_mc_getsidbyname(const char *name, size_t name_len,
+                                char **_sid, enum sss_id_type *_type)
+{
+    struct sss_mc_rec *rec = NULL;
+    const char *sid;
+    const char *rec_name;
+    int ret;
+
+    ret = sss_nss_mc_sid_lookup(SSS_NSS_MC_SID_BY_NAME, name, name_len,
+                                0, SSS_ID_TYPE_NOT_SPECIFIED, &rec);
+    if (ret) {
+        return ret;
+    }
+
+    ret = sss_nss_mc_sid_parse_rec(rec, &sid, &rec_name);
+    if (ret) {
+        goto done;
+    }
+
+    *_sid = strdup(sid);
+    if (*_sid == NULL) {
+        ret = ENOMEM;
+        goto done;
+    }
+    *_type = ((struct sss_mc_sid_data *)rec->data)->type;
+
+done:
+    free(rec);
+    return ret;
+}
+
+errno_t sss_nss_mc_getsidbyid(uint32_t id, enum sss_id_type id_type,
+                              char **_sid, enum sss_id_type *_type)
+{
+    struct sss_mc_rec *rec = NULL;
+    const char *sid;
+    const char *name;
+    char idstr[11];
+    int len;
+    int ret;
+
+    len = snprintf(idstr, 11, "%u", (unsigned int)id);
+    if (len > 10) {
+        return EINVAL;
+    }
+
+    ret = sss_nss_mc_sid_lookup(SSS_NSS_MC_SID_BY_ID, idstr, len,
+                                id, id_type, &rec);
+    if (ret) {
+        return ret;
+    }
+
+    ret = sss_nss_mc_sid_parse_rec(rec, &sid, &name);
+    if (ret) {
+        goto done;
+    }
+
+    *_sid = strdup(sid);
+    if (*_sid == NULL) {
+        ret = ENOMEM;
+        goto done;
+    }
+    *_type = ((struct sss_mc_sid_data *)rec->data)->type;
+
+done:
+    free(rec);
+    return ret;
+}
+
+errno_t sss_nss_mc_getnamebysid(const char *sid, size_t sid_len,
+                                char **_name, enum sss_id_type *_type)
+{
+    struct sss_mc_rec *rec = NULL;
+    const char *rec_sid;
+    const char *name;
+    int ret;
+
+    ret = sss_nss_mc_sid_lookup(SSS_NSS_MC_SID_BY_SID, sid, sid_len,
+                                0, SSS_ID_TYPE_NOT_SPECIFIED, &rec);
+    if (ret) {
+        return ret;
+    }
+
+    ret = sss_nss_mc_sid_parse_rec(rec, &rec_sid, &name);
+    if (ret) {
+        goto done;
+    }
+
+    *_name = strdup(name);
+    if (*_name == NULL) {
+        ret = ENOMEM;
+        goto done;
+    }
+    *_type = ((struct sss_mc_sid_data *)rec->data)->type;
+
+done:
+    free(rec);
+    return ret;
+}
+
+errno_t sss_nss_mc_getidbysid(const char *sid, size_t sid_len,
+                              uint32_t *_id, enum sss_id_type *_type)
+{
+    struct sss_mc_rec *rec = NULL;
+    struct sss_mc_sid_data *data;
+    int ret;
+
+    ret = sss_nss_mc_sid_lookup(SSS_NSS_MC_SID_BY_SID, sid, sid_len,
+                                0, SSS_ID_TYPE_NOT_SPECIFIED, &rec);
+    if (ret) {
+        return ret;
+    }
+
+    data = (struct sss_mc_sid_data *)rec->data;
+    *_id = data->id;
+    *_type = data->type;
+
+    free(rec);
+    return 0;
+}
@@ -27,4 +27,17 @@
 
 int sss_nss_timedlock(unsigned int timeout_ms, int *time_left_ms);
 
+/* SID mmap cache readers, see sss_nss_idmap_mc.c */
+int sss_nss_mc_getsidbyname(const char *name, size_t name_len,
+                            char **_sid, enum sss_id_type *_type);
+
+int sss_nss_mc_getsidbyid(uint32_t id, enum sss_id_type id_type,
+                          char **_sid, enum sss_id_type *_type);
+
+int sss_nss_mc_getnamebysid(const char *sid, size_t sid_len,
+                            char **_name, enum sss_id_type *_type);
+
+int sss_nss_mc_getidbysid(const char *sid, size_t sid_len,
+                          uint32_t *_id, enum sss_id_type *_type);
+
 #endif /* SSS_NSS_IDMAP_PRIVATE_H_ */
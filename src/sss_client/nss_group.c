@@ -310,7 +310,7 @@ enum nss_status _nss_sss_initgroups_dyn(const char *user, gid_t group,
     rd.len = user_len + 1;
     rd.data = user;
 
-    sss_nss_lock();
+    sss_nss_lookup_lock();
 
     /* previous thread might already initialize entry in mmap cache */
     ret = sss_nss_mc_initgroups_dyn(user, user_len, group, start, size,
@@ -385,7 +385,7 @@ enum nss_status _nss_sss_initgroups_dyn(const char *user, gid_t group,
     nret = NSS_STATUS_SUCCESS;
 
 out:
-    sss_nss_unlock();
+    sss_nss_lookup_unlock();
     return nret;
 }
 
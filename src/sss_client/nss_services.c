@@ -30,6 +30,7 @@
 #include <stdio.h>
 #include <string.h>
 #include "sss_cli.h"
+#include "nss_mc.h"
 
 static struct sss_nss_getservent_data {
     size_t len;
@@ -196,6 +197,25 @@ _nss_sss_getservbyname_r(const char *name,
         }
     }
 
+    ret = sss_nss_mc_getservbyname(name, name_len, protocol,
+                                   result, buffer, buflen);
+    switch (ret) {
+    case 0:
+        *errnop = 0;
+        return NSS_STATUS_SUCCESS;
+    case ERANGE:
+        *errnop = ERANGE;
+        return NSS_STATUS_TRYAGAIN;
+    case ENOENT:
+        /* fall through, we need to actively ask the parent
+         * if no entry is found */
+        break;
+    default:
+        /* if using the mmapped cache failed,
+         * fall back to socket based comms */
+        break;
+    }
+
     rd.len = name_len + proto_len + 2;
     data = malloc(sizeof(uint8_t)*rd.len);
     if (data == NULL) {
@@ -215,6 +235,30 @@ _nss_sss_getservbyname_r(const char *name,
 
     sss_nss_lock();
 
+    /* previous thread might already initialize entry in mmap cache */
+    ret = sss_nss_mc_getservbyname(name, name_len, protocol,
+                                   result, buffer, buflen);
+    switch (ret) {
+    case 0:
+        *errnop = 0;
+        nret = NSS_STATUS_SUCCESS;
+        free(data);
+        goto out;
+    case ERANGE:
+        *errnop = ERANGE;
+        nret = NSS_STATUS_TRYAGAIN;
+        free(data);
+        goto out;
+    case ENOENT:
+        /* fall through, we need to actively ask the parent
+         * if no entry is found */
+        break;
+    default:
+        /* if using the mmapped cache failed,
+         * fall back to socket based comms */
+        break;
+    }
+
     nret = sss_nss_make_request(SSS_NSS_GETSERVBYNAME, &rd,
                                 &repbuf, &replen, errnop);
     free(data);
@@ -294,6 +338,24 @@ _nss_sss_getservbyport_r(int port, const char *protocol,
         }
     }
 
+    ret = sss_nss_mc_getservbyport(port, protocol, result, buffer, buflen);
+    switch (ret) {
+    case 0:
+        *errnop = 0;
+        return NSS_STATUS_SUCCESS;
+    case ERANGE:
+        *errnop = ERANGE;
+        return NSS_STATUS_TRYAGAIN;
+    case ENOENT:
+        /* fall through, we need to actively ask the parent
+         * if no entry is found */
+        break;
+    default:
+        /* if using the mmapped cache failed,
+         * fall back to socket based comms */
+        break;
+    }
+
     rd.len = sizeof(uint32_t)*2 + proto_len + 1;
     data = malloc(sizeof(uint8_t)*rd.len);
     if (data == NULL) {
@@ -317,6 +379,29 @@ _nss_sss_getservbyport_r(int port, const char *protocol,
 
     sss_nss_lock();
 
+    /* previous thread might already initialize entry in mmap cache */
+    ret = sss_nss_mc_getservbyport(port, protocol, result, buffer, buflen);
+    switch (ret) {
+    case 0:
+        *errnop = 0;
+        nret = NSS_STATUS_SUCCESS;
+        free(data);
+        goto out;
+    case ERANGE:
+        *errnop = ERANGE;
+        nret = NSS_STATUS_TRYAGAIN;
+        free(data);
+        goto out;
+    case ENOENT:
+        /* fall through, we need to actively ask the parent
+         * if no entry is found */
+        break;
+    default:
+        /* if using the mmapped cache failed,
+         * fall back to socket based comms */
+        break;
+    }
+
     nret = sss_nss_make_request(SSS_NSS_GETSERVBYPORT, &rd,
                                 &repbuf, &replen, errnop);
     free(data);
@@ -81,6 +81,8 @@ enum sss_cli_command {
 
     SSS_NSS_GETPWNAM_EX    = 0x0019,
     SSS_NSS_GETPWUID_EX    = 0x001A,
+    SSS_NSS_GETPWNAM_LIST  = 0x001B,
+    SSS_NSS_GETPWUID_LIST  = 0x001C,
 
 /* group */
 
@@ -93,6 +95,8 @@ enum sss_cli_command {
 
     SSS_NSS_GETGRNAM_EX    = 0x0029,
     SSS_NSS_GETGRGID_EX    = 0x002A,
+    SSS_NSS_GETGRNAM_LIST  = 0x002B,
+    SSS_NSS_GETGRGID_LIST  = 0x002C,
     SSS_NSS_INITGR_EX      = 0x002E,
 
 #if 0
@@ -282,6 +286,16 @@ SSS_NSS_GETSIDBYGID   = 0x0119, /**< Takes an unsigned 32bit integer (POSIX GID)
                                      and reurn the zero terminated string
                                      representation of the SID of the object
                                      with the given UID. */
+SSS_NSS_GETSIDBYNAME_LIST = 0x011A, /**< Batched version of
+                                         SSS_NSS_GETSIDBYNAME, see
+                                         SSS_NSS_MAX_LIST_KEYS for the
+                                         request and reply format. */
+SSS_NSS_GETSIDBYID_LIST   = 0x011B, /**< Batched version of
+                                         SSS_NSS_GETSIDBYID. */
+SSS_NSS_GETNAMEBYSID_LIST = 0x011C, /**< Batched version of
+                                         SSS_NSS_GETNAMEBYSID. */
+SSS_NSS_GETIDBYSID_LIST   = 0x011D, /**< Batched version of
+                                         SSS_NSS_GETIDBYSID. */
 };
 
 /**
@@ -383,6 +397,17 @@ enum pam_item_type {
 #define PAM_CLI_FLAGS_REQUIRE_CERT_AUTH (1 << 9)
 
 #define SSS_NSS_MAX_ENTRIES 256
+
+/* The *_LIST commands take an unsigned 32bit integer with the number of
+ * keys followed by the keys themselves, either zero terminated strings or
+ * unsigned 32bit integers. The reply starts with the number of keys and a
+ * reserved 32bit value followed by one entry per key in request order:
+ * an unsigned 32bit integer status (0 or an errno value), an unsigned 32bit
+ * integer length and the reply body the single-key command would return.
+ * The status is ENOENT and the length is 0 if the object was not found
+ * and EINVAL if the key is malformed. */
+#define SSS_NSS_MAX_LIST_KEYS 256
+#define SSS_NSS_MAX_LIST_REQ_SIZE (64 * 1024)
 #define SSS_NSS_HEADER_SIZE (sizeof(uint32_t) * 4)
 struct sss_cli_req_data {
     size_t len;
@@ -707,6 +732,8 @@ errno_t sss_strnlen(const char *str, size_t maxlen, size_t *len);
 
 void sss_nss_lock(void);
 void sss_nss_unlock(void);
+void sss_nss_lookup_lock(void);
+void sss_nss_lookup_unlock(void);
 void sss_pam_lock(void);
 void sss_pam_unlock(void);
 void sss_nss_mc_lock(void);
@@ -43,6 +43,22 @@ _sbus_sss_invoker_write_as
    (DBusMessageIter *iter,
     struct _sbus_sss_invoker_args_as *args);
 
+struct _sbus_sss_invoker_args_asau {
+    const char ** arg0;
+    uint32_t * arg1;
+};
+
+errno_t
+_sbus_sss_invoker_read_asau
+   (TALLOC_CTX *mem_ctx,
+    DBusMessageIter *iter,
+    struct _sbus_sss_invoker_args_asau *args);
+
+errno_t
+_sbus_sss_invoker_write_asau
+   (DBusMessageIter *iter,
+    struct _sbus_sss_invoker_args_asau *args);
+
 struct _sbus_sss_invoker_args_b {
     bool arg0;
 };
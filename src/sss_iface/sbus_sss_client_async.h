@@ -132,6 +132,21 @@ sbus_call_dp_failover_ActiveServer_recv
      struct tevent_req *req,
      const char ** _server);
 
+struct tevent_req *
+sbus_call_dp_failover_ListServerLatencies_send
+    (TALLOC_CTX *mem_ctx,
+     struct sbus_connection *conn,
+     const char *busname,
+     const char *object_path,
+     const char * arg_service_name);
+
+errno_t
+sbus_call_dp_failover_ListServerLatencies_recv
+    (TALLOC_CTX *mem_ctx,
+     struct tevent_req *req,
+     const char *** _servers,
+     uint32_t ** _rtt_usec);
+
 struct tevent_req *
 sbus_call_dp_failover_ListServers_send
     (TALLOC_CTX *mem_ctx,
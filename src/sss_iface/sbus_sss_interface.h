@@ -309,6 +309,28 @@
         (handler_send), (handler_recv), (data)); \
 })
 
+/* Method: sssd.DataProvider.Failover.ListServerLatencies */
+#define SBUS_METHOD_SYNC_sssd_DataProvider_Failover_ListServerLatencies(handler, data) ({ \
+    SBUS_CHECK_SYNC((handler), (data), const char *, const char ***, uint32_t **); \
+    sbus_method_sync("ListServerLatencies", \
+        &_sbus_sss_args_sssd_DataProvider_Failover_ListServerLatencies, \
+        NULL, \
+        _sbus_sss_invoke_in_s_out_asau_send, \
+        _sbus_sss_key_s_0, \
+        (handler), (data)); \
+})
+
+#define SBUS_METHOD_ASYNC_sssd_DataProvider_Failover_ListServerLatencies(handler_send, handler_recv, data) ({ \
+    SBUS_CHECK_SEND((handler_send), (data), const char *); \
+    SBUS_CHECK_RECV((handler_recv), const char ***, uint32_t **); \
+    sbus_method_async("ListServerLatencies", \
+        &_sbus_sss_args_sssd_DataProvider_Failover_ListServerLatencies, \
+        NULL, \
+        _sbus_sss_invoke_in_s_out_asau_send, \
+        _sbus_sss_key_s_0, \
+        (handler_send), (handler_recv), (data)); \
+})
+
 /* Method: sssd.DataProvider.Failover.ListServers */
 #define SBUS_METHOD_SYNC_sssd_DataProvider_Failover_ListServers(handler, data) ({ \
     SBUS_CHECK_SYNC((handler), (data), const char *, const char ***); \
@@ -44,6 +44,7 @@ _sbus_sss_declare_invoker(pam_data, pam_response);
 _sbus_sss_declare_invoker(raw, qus);
 _sbus_sss_declare_invoker(s, );
 _sbus_sss_declare_invoker(s, as);
+_sbus_sss_declare_invoker(s, asau);
 _sbus_sss_declare_invoker(s, b);
 _sbus_sss_declare_invoker(s, qus);
 _sbus_sss_declare_invoker(s, s);
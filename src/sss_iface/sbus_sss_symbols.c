@@ -154,6 +154,19 @@ _sbus_sss_args_sssd_DataProvider_Failover_ActiveServer = {
     }
 };
 
+const struct sbus_method_arguments
+_sbus_sss_args_sssd_DataProvider_Failover_ListServerLatencies = {
+    .input = (const struct sbus_argument[]){
+        {.type = "s", .name = "service_name"},
+        {NULL}
+    },
+    .output = (const struct sbus_argument[]){
+        {.type = "as", .name = "servers"},
+        {.type = "au", .name = "rtt_usec"},
+        {NULL}
+    }
+};
+
 const struct sbus_method_arguments
 _sbus_sss_args_sssd_DataProvider_Failover_ListServers = {
     .input = (const struct sbus_argument[]){
@@ -0,0 +1,328 @@
+/*
+   SSSD
+
+   Child process pool benchmark
+
+   Copyright (C) 2026 Red Hat
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/* Compares the per-request latency of a helper started for every request
+ * with a pool of long-lived helpers. The dummy-child test helper echoes
+ * the request in both modes:
+ *  - fork: a new child is executed, gets the request on its stdin and is
+ *          waited for after it wrote the reply
+ *  - pool: the request is sent to a child of a pool of the given size */
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <time.h>
+#include <sys/wait.h>
+#include <talloc.h>
+#include <tevent.h>
+#include <popt.h>
+
+#include "util/util.h"
+#include "util/child_common.h"
+
+#define DEFAULT_REQUESTS 1000
+#define DEFAULT_CHILD "./dummy-child"
+#define BENCH_REQUEST "Hello child"
+
+static double elapsed(struct timespec *start)
+{
+    struct timespec now;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+
+    return (now.tv_sec - start->tv_sec)
+               + (now.tv_nsec - start->tv_nsec) / 1e9;
+}
+
+static void report(const char *mode, int requests, double secs)
+{
+    printf("%-5s %9d requests %8.3f s %10.1f us/request\n",
+           mode, requests, secs, secs * 1e6 / requests);
+}
+
+static errno_t bench_fork_one(TALLOC_CTX *mem_ctx, const char *binary)
+{
+    int pipefd_to_child[2] = { -1, -1 };
+    int pipefd_from_child[2] = { -1, -1 };
+    uint8_t buf[sizeof(BENCH_REQUEST)];
+    ssize_t len;
+    pid_t pid;
+    int status;
+    errno_t ret;
+
+    if (pipe(pipefd_to_child) == -1 || pipe(pipefd_from_child) == -1) {
+        ret = errno;
+        goto done;
+    }
+
+    pid = fork();
+    if (pid == -1) {
+        ret = errno;
+        goto done;
+    }
+
+    if (pid == 0) {
+        /* the echo action writes the reply to file descriptor 3 */
+        exec_child_ex(mem_ctx, pipefd_to_child, pipefd_from_child,
+                      binary, -1, NULL, false, STDIN_FILENO, 3);
+        _exit(1);
+    }
+
+    close(pipefd_to_child[0]);
+    pipefd_to_child[0] = -1;
+    close(pipefd_from_child[1]);
+    pipefd_from_child[1] = -1;
+
+    len = sss_atomic_write_s(pipefd_to_child[1], discard_const(BENCH_REQUEST),
+                             sizeof(BENCH_REQUEST));
+    close(pipefd_to_child[1]);
+    pipefd_to_child[1] = -1;
+    if (len != sizeof(BENCH_REQUEST)) {
+        ret = EIO;
+        goto done;
+    }
+
+    len = sss_atomic_read_s(pipefd_from_child[0], buf, sizeof(buf));
+    if (len != sizeof(BENCH_REQUEST)) {
+        ret = EIO;
+        goto done;
+    }
+
+    if (waitpid(pid, &status, 0) == -1) {
+        ret = errno;
+        goto done;
+    }
+
+    ret = (WIFEXITED(status) && WEXITSTATUS(status) == 0) ? EOK : EIO;
+
+done:
+    PIPE_CLOSE(pipefd_to_child);
+    PIPE_CLOSE(pipefd_from_child);
+    return ret;
+}
+
+static int bench_fork(const char *binary, int requests)
+{
+    struct timespec start;
+    int ret;
+    int i;
+
+    setenv("TEST_CHILD_ACTION", "echo", 1);
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (i = 0; i < requests; i++) {
+        ret = bench_fork_one(NULL, binary);
+        if (ret != EOK) {
+            fprintf(stderr, "fork request failed [%d]: %s\n",
+                    ret, sss_strerror(ret));
+            return ret;
+        }
+    }
+    report("fork", requests, elapsed(&start));
+
+    unsetenv("TEST_CHILD_ACTION");
+    return EOK;
+}
+
+struct bench_pool_state {
+    struct sss_child_pool *pool;
+    struct tevent_context *ev;
+    int remaining;
+    int pending;
+    errno_t ret;
+};
+
+static errno_t bench_pool_next(struct bench_pool_state *state);
+
+static void bench_pool_done(struct tevent_req *req)
+{
+    struct bench_pool_state *state;
+    ssize_t len;
+    errno_t ret;
+
+    state = tevent_req_callback_data(req, struct bench_pool_state);
+    state->pending--;
+
+    ret = sss_child_pool_recv(req, NULL, NULL, &len);
+    talloc_free(req);
+    if (ret == EOK && len != sizeof(BENCH_REQUEST)) {
+        ret = EIO;
+    }
+    if (ret != EOK) {
+        state->ret = ret;
+        return;
+    }
+
+    ret = bench_pool_next(state);
+    if (ret != EOK) {
+        state->ret = ret;
+    }
+}
+
+static errno_t bench_pool_next(struct bench_pool_state *state)
+{
+    struct tevent_req *req;
+
+    if (state->remaining == 0) {
+        return EOK;
+    }
+
+    req = sss_child_pool_send(state, state->ev, state->pool,
+                              discard_const(BENCH_REQUEST),
+                              sizeof(BENCH_REQUEST), 5);
+    if (req == NULL) {
+        return ENOMEM;
+    }
+    tevent_req_set_callback(req, bench_pool_done, state);
+
+    state->remaining--;
+    state->pending++;
+    return EOK;
+}
+
+static int bench_pool(const char *binary, int requests, int size)
+{
+    TALLOC_CTX *tmp_ctx;
+    struct bench_pool_state *state;
+    struct timespec start;
+    int ret;
+    int i;
+
+    tmp_ctx = talloc_new(NULL);
+    if (tmp_ctx == NULL) {
+        return ENOMEM;
+    }
+
+    state = talloc_zero(tmp_ctx, struct bench_pool_state);
+    if (state == NULL) {
+        ret = ENOMEM;
+        goto done;
+    }
+
+    state->ev = tevent_context_init(state);
+    if (state->ev == NULL) {
+        ret = ENOMEM;
+        goto done;
+    }
+
+    ret = sss_child_pool_init(state, state->ev, binary, NULL, -1,
+                              size, 0, 0, &state->pool);
+    if (ret != EOK) {
+        goto done;
+    }
+
+    /* one request in flight per child, the children were already
+     * started so only the exchange of the requests is measured */
+    state->remaining = requests;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (i = 0; i < size && state->ret == EOK; i++) {
+        ret = bench_pool_next(state);
+        if (ret != EOK) {
+            goto done;
+        }
+    }
+
+    while (state->pending > 0) {
+        if (tevent_loop_once(state->ev) != 0) {
+            ret = EIO;
+            goto done;
+        }
+    }
+
+    ret = state->ret;
+    if (ret != EOK) {
+        goto done;
+    }
+    report("pool", requests, elapsed(&start));
+
+done:
+    if (ret != EOK) {
+        fprintf(stderr, "pool request failed [%d]: %s\n",
+                ret, sss_strerror(ret));
+    }
+    talloc_free(tmp_ctx);
+    return ret;
+}
+
+int main(int argc, const char *argv[])
+{
+    int opt;
+    poptContext pc;
+    int pc_requests = DEFAULT_REQUESTS;
+    int pc_size = 1;
+    char *pc_child = discard_const(DEFAULT_CHILD);
+    char *pc_mode = NULL;
+    int failures = 0;
+    int ret;
+
+    struct poptOption long_options[] = {
+        POPT_AUTOHELP
+        { "requests", 'n', POPT_ARG_INT | POPT_ARGFLAG_SHOW_DEFAULT,
+                    &pc_requests, 0,
+                    "Number of requests sent to the children", NULL },
+        { "size", 's', POPT_ARG_INT | POPT_ARGFLAG_SHOW_DEFAULT,
+                    &pc_size, 0,
+                    "Number of children in the pool", NULL },
+        { "child", 'c', POPT_ARG_STRING | POPT_ARGFLAG_SHOW_DEFAULT,
+                    &pc_child, 0,
+                    "Path to the dummy-child test helper", NULL },
+        { "mode", 'm', POPT_ARG_STRING, &pc_mode, 0,
+                    "Only run the given mode (fork or pool)", NULL },
+        POPT_TABLEEND
+    };
+
+    /* parse the params */
+    pc = poptGetContext(argv[0], argc, argv, long_options, 0);
+    while ((opt = poptGetNextOpt(pc)) != -1) {
+        switch (opt) {
+            default:
+                fprintf(stderr, "\nInvalid option %s: %s\n\n",
+                        poptBadOption(pc, 0), poptStrerror(opt));
+                poptPrintUsage(pc, stderr, 0);
+                return 1;
+        }
+    }
+    poptFreeContext(pc);
+
+    if (pc_requests <= 0 || pc_size <= 0) {
+        fprintf(stderr, "The number of requests and the pool size must be "
+                        "positive\n");
+        return 1;
+    }
+
+    /* a child dying early must not terminate the benchmark */
+    signal(SIGPIPE, SIG_IGN);
+
+    if (pc_mode == NULL || strcmp(pc_mode, "fork") == 0) {
+        ret = bench_fork(pc_child, pc_requests);
+        if (ret != EOK) {
+            failures++;
+        }
+    }
+
+    if (pc_mode == NULL || strcmp(pc_mode, "pool") == 0) {
+        ret = bench_pool(pc_child, pc_requests, pc_size);
+        if (ret != EOK) {
+            failures++;
+        }
+    }
+
+    return (failures == 0 ? EXIT_SUCCESS : EXIT_FAILURE);
+}
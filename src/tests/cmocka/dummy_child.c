@@ -25,14 +25,115 @@
 #include <sys/types.h>
 #include <unistd.h>
 #include <stdlib.h>
+#include <stdio.h>
 #include <popt.h>
 
 #include "util/util.h"
 #include "util/child_common.h"
 
+/* Serves requests from a pool: echoes the request, "fail" makes the
+ * request fail and "exit" terminates the child without a reply. */
+static errno_t dummy_child_request(TALLOC_CTX *mem_ctx,
+                                   uint8_t *req, size_t req_len,
+                                   uint8_t **_reply, size_t *_reply_len,
+                                   void *pvt)
+{
+    if (req_len == sizeof("fail") && memcmp(req, "fail", req_len) == 0) {
+        return EIO;
+    }
+
+    if (req_len == sizeof("exit") && memcmp(req, "exit", req_len) == 0) {
+        _exit(0);
+    }
+
+    *_reply = talloc_memdup(mem_ctx, req, req_len);
+    if (*_reply == NULL) {
+        return ENOMEM;
+    }
+    *_reply_len = req_len;
+
+    return EOK;
+}
+
+static void dummy_child_reply(const char *reply)
+{
+    ssize_t written;
+
+    errno = 0;
+    written = sss_atomic_write_s(STDOUT_FILENO, discard_const(reply),
+                                 strlen(reply) + 1);
+    _exit(written == strlen(reply) + 1 ? 0 : 1);
+}
+
+/* Changes the credentials of the request process if possible, as
+ * krb5_child does before it talks to the KDC. */
+static void dummy_child_drop_creds(void)
+{
+    if (geteuid() == 0) {
+        if (setresgid(65534, 65534, 65534) != 0
+                || setresuid(65534, 65534, 65534) != 0) {
+            _exit(1);
+        }
+    }
+    child_worker_set_pdeathsig();
+}
+
+/* Handles one request forked by child_worker_loop(): "ppid" returns the pid
+ * of the worker, "euid" the effective UID, "drop" switches the credentials
+ * first, "fail" exits without a reply and "hang" writes the pid to the file
+ * in TEST_CHILD_PID_FILE and never replies. Everything else is echoed. */
+static void dummy_child_forked_request(void)
+{
+    uint8_t buf[IN_BUF_SIZE];
+    char reply[32];
+    const char *pid_file;
+    FILE *f;
+    ssize_t len;
+
+    errno = 0;
+    len = sss_atomic_read_s(STDIN_FILENO, buf, sizeof(buf) - 1);
+    if (len <= 0) {
+        _exit(1);
+    }
+    buf[len] = '\0';
+
+    if (strcmp((char *) buf, "ppid") == 0) {
+        snprintf(reply, sizeof(reply), "%d", (int) getppid());
+        dummy_child_reply(reply);
+    } else if (strcmp((char *) buf, "euid") == 0) {
+        snprintf(reply, sizeof(reply), "%d", (int) geteuid());
+        dummy_child_reply(reply);
+    } else if (strcmp((char *) buf, "drop") == 0) {
+        dummy_child_drop_creds();
+        snprintf(reply, sizeof(reply), "%d", (int) geteuid());
+        dummy_child_reply(reply);
+    } else if (strcmp((char *) buf, "fail") == 0) {
+        _exit(1);
+    } else if (strcmp((char *) buf, "hang") == 0) {
+        pid_file = getenv("TEST_CHILD_PID_FILE");
+        if (pid_file == NULL) {
+            _exit(1);
+        }
+        f = fopen(pid_file, "w");
+        if (f == NULL) {
+            _exit(1);
+        }
+        fprintf(f, "%d\n", (int) getpid());
+        fclose(f);
+
+        dummy_child_drop_creds();
+        while (1) {
+            sleep(1);
+        }
+    }
+
+    dummy_child_reply((char *) buf);
+}
+
 int main(int argc, const char *argv[])
 {
     int opt;
+    int worker = 0;
     int debug_fd = -1;
     char *opt_logger = NULL;
     poptContext pc;
@@ -59,6 +160,8 @@ int main(int argc, const char *argv[])
         SSSD_LOGGER_OPTS
         {"guitar", 0, POPT_ARG_STRING, &guitar, 0, _("Who plays guitar"), NULL },
         {"drums", 0, POPT_ARG_STRING, &drums, 0, _("Who plays drums"), NULL },
+        {CHILD_OPT_WORKER, 0, POPT_ARG_NONE, &worker, 0,
+         _("Serve several requests"), NULL },
         POPT_TABLEEND
     };
 
@@ -81,6 +184,19 @@ int main(int argc, const char *argv[])
     sss_set_logger(opt_logger);
 
     action = getenv("TEST_CHILD_ACTION");
+
+    if (worker != 0) {
+        if (action != NULL && strcasecmp(action, "fork_worker") == 0) {
+            /* Only returns in the process forked for a request */
+            child_worker_loop(IN_BUF_SIZE);
+            dummy_child_forked_request();
+        }
+
+        ret = child_serve_requests(STDIN_FILENO, STDOUT_FILENO,
+                                   dummy_child_request, NULL);
+        _exit(ret == EOK ? 0 : 1);
+    }
+
     if (action) {
         if (strcasecmp(action, "check_extra_args") == 0) {
             if (!(strcmp(guitar, "george") == 0 \
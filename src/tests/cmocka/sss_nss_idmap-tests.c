@@ -148,12 +148,56 @@ void test_getorigbyname(void **state)
     sss_nss_free_kv(kv_list);
 }
 
+void test_getsidbyid_list(void **state)
+{
+    int ret;
+    uint32_t ids[] = { 1000, 1001 };
+    struct sss_nss_idmap_item *items = NULL;
+    uint8_t repbuf[2 * sizeof(uint32_t) + 2 * sizeof(uint32_t) + sizeof(buf1)
+                   + 2 * sizeof(uint32_t)];
+    struct sss_nss_make_request_test_data d = { repbuf, sizeof(repbuf), 0,
+                                                NSS_STATUS_SUCCESS };
+    size_t rp = 0;
+
+    SAFEALIGN_SETMEM_UINT32(repbuf, 2, &rp);
+    SAFEALIGN_SETMEM_UINT32(repbuf + rp, 0, &rp);
+    SAFEALIGN_SETMEM_UINT32(repbuf + rp, 0, &rp);
+    SAFEALIGN_SETMEM_UINT32(repbuf + rp, sizeof(buf1), &rp);
+    safealign_memcpy(repbuf + rp, buf1, sizeof(buf1), &rp);
+    SAFEALIGN_SETMEM_UINT32(repbuf + rp, ENOENT, &rp);
+    SAFEALIGN_SETMEM_UINT32(repbuf + rp, 0, &rp);
+
+    ret = sss_nss_getsidbyid_list(NULL, 2, &items);
+    assert_int_equal(ret, EINVAL);
+
+    ret = sss_nss_getsidbyid_list(ids, 0, &items);
+    assert_int_equal(ret, EINVAL);
+
+    will_return(__wrap_sss_nss_make_request_timeout, &d);
+    ret = sss_nss_getsidbyid_list(ids, 2, &items);
+    assert_int_equal(ret, EOK);
+    assert_int_equal(items[0].status, EOK);
+    assert_string_equal(items[0].str, "test");
+    assert_int_equal(items[0].type, SSS_ID_TYPE_NOT_SPECIFIED);
+    assert_int_equal(items[1].status, ENOENT);
+    assert_null(items[1].str);
+
+    sss_nss_free_items(items, 2);
+
+    /* number of results does not match the number of keys */
+    SAFEALIGN_SETMEM_UINT32(repbuf, 3, NULL);
+    will_return(__wrap_sss_nss_make_request_timeout, &d);
+    ret = sss_nss_getsidbyid_list(ids, 2, &items);
+    assert_int_equal(ret, EBADMSG);
+}
+
 int main(int argc, const char *argv[])
 {
 
     const struct CMUnitTest tests[] = {
         cmocka_unit_test(test_getsidbyname),
         cmocka_unit_test(test_getorigbyname),
+        cmocka_unit_test(test_getsidbyid_list),
     };
 
     return cmocka_run_group_tests(tests, NULL, NULL);
@@ -347,6 +347,109 @@ void test_ad_gpo_ace_includes_host_sid_true(void **state)
                                         group_size, ace_dom_sid, true);
 }
 
+void test_ad_gpo_decision_key(void **state)
+{
+    const char *user_sid = "S-1-5-21-2-3-1103";
+    const char *group_sids[] = {"S-1-5-21-2-3-513", "S-1-5-11"};
+    const char *reversed_sids[] = {"S-1-5-11", "S-1-5-21-2-3-513"};
+    char *key;
+    char *reversed_key;
+    char *other_key;
+
+    key = ad_gpo_decision_key(test_ctx, GPO_MAP_REMOTE_INTERACTIVE,
+                              "host.example.com", user_sid, group_sids, 2);
+    assert_non_null(key);
+    assert_string_equal(key, "1:host.example.com:S-1-5-21-2-3-1103:"
+                             "S-1-5-11,S-1-5-21-2-3-513");
+
+    /* the order of the groups does not matter */
+    reversed_key = ad_gpo_decision_key(test_ctx, GPO_MAP_REMOTE_INTERACTIVE,
+                                       "host.example.com", user_sid,
+                                       reversed_sids, 2);
+    assert_non_null(reversed_key);
+    assert_string_equal(key, reversed_key);
+
+    other_key = ad_gpo_decision_key(test_ctx, GPO_MAP_INTERACTIVE,
+                                    "host.example.com", user_sid,
+                                    group_sids, 2);
+    assert_non_null(other_key);
+    assert_string_not_equal(key, other_key);
+
+    talloc_free(key);
+    talloc_free(reversed_key);
+    talloc_free(other_key);
+}
+
+void test_ad_gpo_decision_cache(void **state)
+{
+    struct ad_access_ctx *access_ctx;
+    struct ad_gpo_decision_cache *cache;
+    struct ad_gpo_decision *entry;
+    const char *guids[] = {"{31B2F340-016D-11D2-945F-00C04FB984F9}"};
+    errno_t ret;
+
+    access_ctx = talloc_zero(test_ctx, struct ad_access_ctx);
+    assert_non_null(access_ctx);
+
+    ret = ad_gpo_decision_cache_init(access_ctx, 0);
+    assert_int_equal(ret, EOK);
+    assert_null(access_ctx->gpo_decision_cache);
+
+    ret = ad_gpo_decision_cache_init(access_ctx, 60);
+    assert_int_equal(ret, EOK);
+    cache = access_ctx->gpo_decision_cache;
+    assert_non_null(cache);
+
+    assert_null(ad_gpo_decision_get(cache, "allowed"));
+
+    ad_gpo_decision_put(cache, "allowed", EOK, guids, 1);
+    ad_gpo_decision_put(cache, "denied", ERR_ACCESS_DENIED, NULL, 0);
+    assert_int_equal(cache->count, 2);
+
+    entry = ad_gpo_decision_get(cache, "allowed");
+    assert_non_null(entry);
+    assert_int_equal(entry->result, EOK);
+    assert_int_equal(entry->num_gpo_guids, 1);
+    assert_string_equal(entry->gpo_guids[0], guids[0]);
+    assert_null(entry->gpo_guids[1]);
+
+    entry = ad_gpo_decision_get(cache, "denied");
+    assert_non_null(entry);
+    assert_int_equal(entry->result, ERR_ACCESS_DENIED);
+    assert_int_equal(entry->num_gpo_guids, 0);
+
+    /* expired entries are removed */
+    entry->expire = time(NULL) - 1;
+    assert_null(ad_gpo_decision_get(cache, "denied"));
+    assert_int_equal(cache->count, 1);
+
+    ad_gpo_decision_flush(cache);
+    assert_int_equal(cache->count, 0);
+    assert_null(ad_gpo_decision_get(cache, "allowed"));
+
+    talloc_free(access_ctx);
+}
+
+void test_ad_gpo_decision_changed_filter(void **state)
+{
+    char *filter;
+    errno_t ret;
+
+    /* 2001-09-09 01:46:40 UTC plus the allowed clock skew */
+    ret = ad_gpo_decision_changed_filter(test_ctx,
+                                         1000000000
+                                            + AD_GPO_DECISION_CLOCK_SKEW,
+                                         "HOST$", &filter);
+    assert_int_equal(ret, EOK);
+    assert_string_equal(filter,
+                        "(&(whenChanged>=20010909014640.0Z)"
+                        "(|(objectclass=groupPolicyContainer)"
+                        "(objectclass=organizationalUnit)"
+                        "(objectclass=domainDNS)"
+                        "(sAMAccountName=HOST$)))");
+    talloc_free(filter);
+}
+
 int main(int argc, const char *argv[])
 {
     poptContext pc;
@@ -385,6 +488,15 @@ int main(int argc, const char *argv[])
         cmocka_unit_test_setup_teardown(test_ad_gpo_ace_includes_host_sid_true,
                                         ad_gpo_test_setup,
                                         ad_gpo_test_teardown),
+        cmocka_unit_test_setup_teardown(test_ad_gpo_decision_key,
+                                        ad_gpo_test_setup,
+                                        ad_gpo_test_teardown),
+        cmocka_unit_test_setup_teardown(test_ad_gpo_decision_cache,
+                                        ad_gpo_test_setup,
+                                        ad_gpo_test_teardown),
+        cmocka_unit_test_setup_teardown(test_ad_gpo_decision_changed_filter,
+                                        ad_gpo_test_setup,
+                                        ad_gpo_test_teardown),
     };
 
     /* Set debug level to invalid value so we can decide if -d 0 was used. */
@@ -30,6 +30,7 @@
 
 #define TEST_BIN    "dummy-child"
 #define ECHO_STR    "Hello child"
+#define TEST_PID_FILE "tp_" BASE_FILE_STEM "_request.pid"
 
 static int destructor_called;
 
@@ -500,6 +501,307 @@ void sss_child_cb(int pid, int wait_status, void *pvt)
     child_ctx->test_ctx->done = true;
 }
 
+struct test_child_pool_state {
+    struct child_test_ctx *child_tctx;
+    int pending;
+    errno_t ret[2];
+    uint8_t *reply[2];
+    ssize_t reply_len[2];
+};
+
+static void test_child_pool_done(struct tevent_req *req)
+{
+    struct test_child_pool_state *state;
+    int i;
+
+    state = tevent_req_callback_data(req, struct test_child_pool_state);
+    i = 2 - state->pending;
+
+    state->ret[i] = sss_child_pool_recv(req, state, &state->reply[i],
+                                        &state->reply_len[i]);
+    talloc_free(req);
+
+    state->pending--;
+    if (state->pending == 0) {
+        state->child_tctx->test_ctx->error = EOK;
+        state->child_tctx->test_ctx->done = true;
+    }
+}
+
+static void test_child_pool_run(struct child_test_ctx *child_tctx,
+                                struct sss_child_pool *pool,
+                                struct test_child_pool_state *state,
+                                const char *input,
+                                uint32_t timeout)
+{
+    struct tevent_req *req;
+    errno_t ret;
+
+    state->pending = 1;
+    child_tctx->test_ctx->done = false;
+
+    req = sss_child_pool_send(child_tctx, child_tctx->test_ctx->ev, pool,
+                              discard_const(input), strlen(input) + 1,
+                              timeout);
+    assert_non_null(req);
+    tevent_req_set_callback(req, test_child_pool_done, state);
+
+    ret = test_ev_loop(child_tctx->test_ctx);
+    assert_int_equal(ret, EOK);
+}
+
+/* A pool of one child serves sequential requests and refuses a concurrent
+ * one, a failed request replaces the child. */
+void test_child_pool(void **state)
+{
+    struct child_test_ctx *child_tctx = talloc_get_type(*state,
+                                                        struct child_test_ctx);
+    struct test_child_pool_state *pool_state;
+    struct sss_child_pool *pool;
+    struct tevent_req *req;
+    errno_t ret;
+
+    pool_state = talloc_zero(child_tctx, struct test_child_pool_state);
+    assert_non_null(pool_state);
+    pool_state->child_tctx = child_tctx;
+
+    ret = sss_child_pool_init(child_tctx, child_tctx->test_ctx->ev,
+                              CHILD_DIR"/"TEST_BIN, NULL, -1, 1, 0, 0, &pool);
+    assert_int_equal(ret, EOK);
+
+    test_child_pool_run(child_tctx, pool, pool_state, ECHO_STR, 5);
+    assert_int_equal(pool_state->ret[1], EOK);
+    assert_int_equal(pool_state->reply_len[1], sizeof(ECHO_STR));
+    assert_string_equal((char *) pool_state->reply[1], ECHO_STR);
+
+    test_child_pool_run(child_tctx, pool, pool_state, "fail", 5);
+    assert_int_not_equal(pool_state->ret[1], EOK);
+
+    /* the failed child was replaced */
+    test_child_pool_run(child_tctx, pool, pool_state, "second", 5);
+    assert_int_equal(pool_state->ret[1], EOK);
+    assert_string_equal((char *) pool_state->reply[1], "second");
+
+    /* only one child, the second request is refused */
+    pool_state->pending = 2;
+    child_tctx->test_ctx->done = false;
+
+    req = sss_child_pool_send(child_tctx, child_tctx->test_ctx->ev, pool,
+                              discard_const(ECHO_STR), sizeof(ECHO_STR), 5);
+    assert_non_null(req);
+    tevent_req_set_callback(req, test_child_pool_done, pool_state);
+
+    req = sss_child_pool_send(child_tctx, child_tctx->test_ctx->ev, pool,
+                              discard_const(ECHO_STR), sizeof(ECHO_STR), 5);
+    assert_non_null(req);
+    tevent_req_set_callback(req, test_child_pool_done, pool_state);
+
+    ret = test_ev_loop(child_tctx->test_ctx);
+    assert_int_equal(ret, EOK);
+    /* the refused request completes first */
+    assert_int_equal(pool_state->ret[0], EBUSY);
+    assert_int_equal(pool_state->ret[1], EOK);
+    assert_string_equal((char *) pool_state->reply[1], ECHO_STR);
+
+    talloc_free(pool);
+    talloc_free(pool_state);
+}
+
+/* Runs one request in a pool of children started in the forking worker
+ * mode of krb5_child, see child_worker_loop(), and returns the number the
+ * request process replied with. */
+static int test_worker_request(struct child_test_ctx *child_tctx,
+                               struct sss_child_pool *pool,
+                               struct test_child_pool_state *state,
+                               const char *input)
+{
+    test_child_pool_run(child_tctx, pool, state, input, 5);
+    assert_int_equal(state->ret[1], EOK);
+    assert_non_null(state->reply[1]);
+
+    return atoi((char *) state->reply[1]);
+}
+
+static struct test_child_pool_state *
+test_worker_pool_setup(struct child_test_ctx *child_tctx,
+                       uint32_t max_requests,
+                       struct sss_child_pool **_pool)
+{
+    struct test_child_pool_state *pool_state;
+    errno_t ret;
+
+    ret = setenv("TEST_CHILD_ACTION", "fork_worker", 1);
+    assert_int_equal(ret, 0);
+
+    pool_state = talloc_zero(child_tctx, struct test_child_pool_state);
+    assert_non_null(pool_state);
+    pool_state->child_tctx = child_tctx;
+
+    ret = sss_child_pool_init(child_tctx, child_tctx->test_ctx->ev,
+                              CHILD_DIR"/"TEST_BIN, NULL, -1, 1,
+                              max_requests, 0, _pool);
+    assert_int_equal(ret, EOK);
+
+    return pool_state;
+}
+
+static void test_worker_pool_teardown(struct sss_child_pool *pool,
+                                      struct test_child_pool_state *state)
+{
+    errno_t ret;
+
+    talloc_free(pool);
+    talloc_free(state);
+
+    ret = unsetenv("TEST_CHILD_ACTION");
+    assert_int_equal(ret, 0);
+}
+
+/* The same worker serves the requests until max_requests is reached */
+void test_child_pool_worker_reuse(void **state)
+{
+    struct child_test_ctx *child_tctx = talloc_get_type(*state,
+                                                        struct child_test_ctx);
+    struct test_child_pool_state *pool_state;
+    struct sss_child_pool *pool;
+    pid_t worker;
+
+    pool_state = test_worker_pool_setup(child_tctx, 3, &pool);
+
+    worker = test_worker_request(child_tctx, pool, pool_state, "ppid");
+    assert_int_not_equal(worker, getpid());
+
+    /* every request runs in its own process forked by the worker */
+    assert_int_equal(test_worker_request(child_tctx, pool, pool_state,
+                                         "ppid"), worker);
+    test_child_pool_run(child_tctx, pool, pool_state, ECHO_STR, 5);
+    assert_int_equal(pool_state->ret[1], EOK);
+    assert_string_equal((char *) pool_state->reply[1], ECHO_STR);
+
+    /* the worker was recycled after three requests */
+    assert_int_not_equal(test_worker_request(child_tctx, pool, pool_state,
+                                             "ppid"), worker);
+
+    test_worker_pool_teardown(pool, pool_state);
+}
+
+/* A request that fails retires the worker */
+void test_child_pool_worker_failure(void **state)
+{
+    struct child_test_ctx *child_tctx = talloc_get_type(*state,
+                                                        struct child_test_ctx);
+    struct test_child_pool_state *pool_state;
+    struct sss_child_pool *pool;
+    pid_t worker;
+
+    pool_state = test_worker_pool_setup(child_tctx, 0, &pool);
+
+    worker = test_worker_request(child_tctx, pool, pool_state, "ppid");
+
+    test_child_pool_run(child_tctx, pool, pool_state, "fail", 5);
+    assert_int_not_equal(pool_state->ret[1], EOK);
+
+    assert_int_not_equal(test_worker_request(child_tctx, pool, pool_state,
+                                             "ppid"), worker);
+
+    test_worker_pool_teardown(pool, pool_state);
+}
+
+static bool test_process_gone(pid_t pid)
+{
+    char path[64];
+    char buf[256];
+    char *p;
+    FILE *f;
+    size_t len;
+
+    if (kill(pid, 0) == -1 && errno == ESRCH) {
+        return true;
+    }
+
+    /* Orphans might not be reaped right away, a zombie is gone as well */
+    snprintf(path, sizeof(path), "/proc/%d/stat", (int) pid);
+    f = fopen(path, "r");
+    if (f == NULL) {
+        return true;
+    }
+    len = fread(buf, 1, sizeof(buf) - 1, f);
+    fclose(f);
+    buf[len] = '\0';
+
+    p = strrchr(buf, ')');
+    return p != NULL && p[1] == ' ' && (p[2] == 'Z' || p[2] == 'X');
+}
+
+/* A request that times out retires the worker, the request process is
+ * killed with it even after switching credentials */
+void test_child_pool_worker_timeout(void **state)
+{
+    struct child_test_ctx *child_tctx = talloc_get_type(*state,
+                                                        struct child_test_ctx);
+    struct test_child_pool_state *pool_state;
+    struct sss_child_pool *pool;
+    pid_t worker;
+    pid_t request = 0;
+    FILE *f;
+    int ret;
+
+    unlink(TEST_PID_FILE);
+    ret = setenv("TEST_CHILD_PID_FILE", TEST_PID_FILE, 1);
+    assert_int_equal(ret, 0);
+
+    pool_state = test_worker_pool_setup(child_tctx, 0, &pool);
+
+    worker = test_worker_request(child_tctx, pool, pool_state, "ppid");
+
+    test_child_pool_run(child_tctx, pool, pool_state, "hang", 1);
+    assert_int_equal(pool_state->ret[1], ETIMEDOUT);
+
+    f = fopen(TEST_PID_FILE, "r");
+    assert_non_null(f);
+    assert_int_equal(fscanf(f, "%d", &request), 1);
+    fclose(f);
+    unlink(TEST_PID_FILE);
+    assert_true(request > 0);
+
+    for (int i = 0; i < 50 && !test_process_gone(request); i++) {
+        usleep(100000);
+    }
+    assert_true(test_process_gone(request));
+
+    assert_int_not_equal(test_worker_request(child_tctx, pool, pool_state,
+                                             "ppid"), worker);
+
+    test_worker_pool_teardown(pool, pool_state);
+    unsetenv("TEST_CHILD_PID_FILE");
+}
+
+/* Switching the credentials in a request does not affect the worker nor
+ * the following requests */
+void test_child_pool_worker_creds(void **state)
+{
+    struct child_test_ctx *child_tctx = talloc_get_type(*state,
+                                                        struct child_test_ctx);
+    struct test_child_pool_state *pool_state;
+    struct sss_child_pool *pool;
+    pid_t worker;
+    uid_t euid = geteuid();
+
+    pool_state = test_worker_pool_setup(child_tctx, 0, &pool);
+
+    worker = test_worker_request(child_tctx, pool, pool_state, "ppid");
+
+    assert_int_equal(test_worker_request(child_tctx, pool, pool_state,
+                                         "drop"),
+                     euid == 0 ? 65534 : euid);
+    assert_int_equal(test_worker_request(child_tctx, pool, pool_state,
+                                         "euid"), euid);
+    assert_int_equal(test_worker_request(child_tctx, pool, pool_state,
+                                         "ppid"), worker);
+
+    test_worker_pool_teardown(pool, pool_state);
+}
+
 int main(int argc, const char *argv[])
 {
     int rv;
@@ -530,6 +832,21 @@ int main(int argc, const char *argv[])
         cmocka_unit_test_setup_teardown(test_sss_child,
                                         child_test_setup,
                                         child_test_teardown),
+        cmocka_unit_test_setup_teardown(test_child_pool,
+                                        child_test_setup,
+                                        child_test_teardown),
+        cmocka_unit_test_setup_teardown(test_child_pool_worker_reuse,
+                                        child_test_setup,
+                                        child_test_teardown),
+        cmocka_unit_test_setup_teardown(test_child_pool_worker_failure,
+                                        child_test_setup,
+                                        child_test_teardown),
+        cmocka_unit_test_setup_teardown(test_child_pool_worker_timeout,
+                                        child_test_setup,
+                                        child_test_teardown),
+        cmocka_unit_test_setup_teardown(test_child_pool_worker_creds,
+                                        child_test_setup,
+                                        child_test_teardown),
         cmocka_unit_test_setup_teardown(test_exec_child_only_extra_args,
                                         only_extra_args_setup,
                                         only_extra_args_teardown),
@@ -0,0 +1,424 @@
+/*
+    SSSD
+
+    InfoPipe list lookup and attribute projection tests
+
+    Copyright (C) 2026 Red Hat
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <popt.h>
+
+#include "db/sysdb.h"
+#include "tests/cmocka/common_mock.h"
+#include "tests/cmocka/common_mock_resp.h"
+#include "responder/ifp/ifp_private.h"
+#include "responder/ifp/ifp_users.h"
+#include "responder/ifp/ifp_groups.h"
+#include "responder/ifp/ifp_iface/ifp_iface.h"
+
+#define TESTS_PATH "tp_" BASE_FILE_STEM
+#define TEST_CONF_DB "test_ifp_list_conf.ldb"
+/* no characters that need to be escaped in an object path */
+#define TEST_DOM_NAME "ifplisttest"
+#define TEST_ID_PROVIDER "ldap"
+
+#define TEST_USER_PATH(uid) IFP_PATH_USERS "/" TEST_DOM_NAME "/" uid
+#define TEST_GROUP_PATH(gid) IFP_PATH_GROUPS "/" TEST_DOM_NAME "/" gid
+
+struct ifp_list_test_ctx {
+    struct sss_test_ctx *tctx;
+    struct ifp_ctx *ifp_ctx;
+
+    const char **paths;
+};
+
+static void test_store_user(struct ifp_list_test_ctx *test_ctx,
+                            const char *shortname, uid_t uid,
+                            const char *gecos)
+{
+    struct sss_domain_info *dom = test_ctx->tctx->dom;
+    char *fqname;
+    errno_t ret;
+
+    fqname = sss_create_internal_fqname(test_ctx, shortname, dom->name);
+    assert_non_null(fqname);
+
+    ret = sysdb_store_user(dom, fqname, "*", uid, uid, gecos, "/home/user",
+                           "/bin/sh", NULL, NULL, NULL, 1000, time(NULL));
+    assert_int_equal(ret, EOK);
+
+    talloc_free(fqname);
+}
+
+static void test_store_group(struct ifp_list_test_ctx *test_ctx,
+                             const char *shortname, gid_t gid)
+{
+    struct sss_domain_info *dom = test_ctx->tctx->dom;
+    char *fqname;
+    errno_t ret;
+
+    fqname = sss_create_internal_fqname(test_ctx, shortname, dom->name);
+    assert_non_null(fqname);
+
+    ret = sysdb_store_group(dom, fqname, gid, NULL, 1000, time(NULL));
+    assert_int_equal(ret, EOK);
+
+    talloc_free(fqname);
+}
+
+static int test_ifp_list_setup(void **state)
+{
+    static const char *whitelist[] = {SYSDB_NAME, SYSDB_UIDNUM, SYSDB_GECOS,
+                                      NULL};
+    struct ifp_list_test_ctx *test_ctx;
+    struct resp_ctx *rctx;
+
+    assert_true(leak_check_setup());
+
+    test_dom_suite_setup(TESTS_PATH);
+
+    test_ctx = talloc_zero(global_talloc_context, struct ifp_list_test_ctx);
+    assert_non_null(test_ctx);
+
+    test_ctx->tctx = create_dom_test_ctx(test_ctx, TESTS_PATH, TEST_CONF_DB,
+                                         TEST_DOM_NAME, TEST_ID_PROVIDER, NULL);
+    assert_non_null(test_ctx->tctx);
+
+    rctx = mock_rctx(test_ctx, test_ctx->tctx->ev, test_ctx->tctx->dom, NULL);
+    assert_non_null(rctx);
+
+    test_ctx->ifp_ctx = talloc_zero(test_ctx, struct ifp_ctx);
+    assert_non_null(test_ctx->ifp_ctx);
+    test_ctx->ifp_ctx->rctx = rctx;
+    test_ctx->ifp_ctx->user_whitelist = whitelist;
+
+    test_store_user(test_ctx, "user1", 1001, "User One");
+    test_store_user(test_ctx, "user2", 1002, "User Two");
+    test_store_group(test_ctx, "group1", 2001);
+
+    check_leaks_push(test_ctx);
+    *state = test_ctx;
+
+    return 0;
+}
+
+static int test_ifp_list_teardown(void **state)
+{
+    struct ifp_list_test_ctx *test_ctx;
+
+    test_ctx = talloc_get_type_abort(*state, struct ifp_list_test_ctx);
+
+    talloc_zfree(test_ctx->paths);
+
+    assert_true(check_leaks_pop(test_ctx));
+    talloc_zfree(test_ctx);
+    test_dom_suite_cleanup(TESTS_PATH, TEST_CONF_DB, TEST_DOM_NAME);
+    assert_true(leak_check_teardown());
+
+    return 0;
+}
+
+static void test_users_by_name_done(struct tevent_req *req)
+{
+    struct ifp_list_test_ctx *test_ctx;
+    errno_t ret;
+
+    test_ctx = tevent_req_callback_data(req, struct ifp_list_test_ctx);
+
+    ret = ifp_users_find_by_name_list_recv(test_ctx, req, &test_ctx->paths);
+    talloc_free(req);
+
+    test_ev_done(test_ctx->tctx, ret);
+}
+
+static errno_t test_users_by_name(struct ifp_list_test_ctx *test_ctx,
+                                  const char **names)
+{
+    struct tevent_req *req;
+
+    req = ifp_users_find_by_name_list_send(test_ctx, test_ctx->tctx->ev,
+                                           NULL, test_ctx->ifp_ctx, names);
+    assert_non_null(req);
+    tevent_req_set_callback(req, test_users_by_name_done, test_ctx);
+
+    return test_ev_loop(test_ctx->tctx);
+}
+
+static void test_users_by_id_done(struct tevent_req *req)
+{
+    struct ifp_list_test_ctx *test_ctx;
+    errno_t ret;
+
+    test_ctx = tevent_req_callback_data(req, struct ifp_list_test_ctx);
+
+    ret = ifp_users_find_by_id_list_recv(test_ctx, req, &test_ctx->paths);
+    talloc_free(req);
+
+    test_ev_done(test_ctx->tctx, ret);
+}
+
+static const char *test_hash_value(hash_table_t *table, const char *attr)
+{
+    hash_key_t key;
+    hash_value_t value;
+    const char **values;
+    int hret;
+
+    key.type = HASH_KEY_STRING;
+    key.str = discard_const(attr);
+
+    hret = hash_lookup(table, &key, &value);
+    if (hret != HASH_SUCCESS) {
+        return NULL;
+    }
+
+    values = value.ptr;
+    assert_non_null(values[0]);
+    assert_null(values[1]);
+
+    return values[0];
+}
+
+/* Names are looked up in the requested order, objects that are not found
+ * or fail to be looked up are left out. */
+static void test_users_by_name_list(void **state)
+{
+    struct ifp_list_test_ctx *test_ctx;
+    const char *names[] = {"user1", "nodomain", "broken", "user2", NULL};
+    errno_t ret;
+
+    test_ctx = talloc_get_type_abort(*state, struct ifp_list_test_ctx);
+
+    mock_parse_inp("user1", NULL, EOK);
+    mock_parse_inp(NULL, NULL, ERR_DOMAIN_NOT_FOUND);
+    mock_parse_inp(NULL, NULL, EIO);
+    mock_parse_inp("user2", NULL, EOK);
+
+    ret = test_users_by_name(test_ctx, names);
+    assert_int_equal(ret, EOK);
+
+    assert_non_null(test_ctx->paths);
+    assert_string_equal(test_ctx->paths[0], TEST_USER_PATH("1001"));
+    assert_string_equal(test_ctx->paths[1], TEST_USER_PATH("1002"));
+    assert_null(test_ctx->paths[2]);
+}
+
+/* The lookup error is returned only if no object was found at all. */
+static void test_users_by_name_list_all_failed(void **state)
+{
+    struct ifp_list_test_ctx *test_ctx;
+    const char *names[] = {"broken1", "nodomain", "broken2", NULL};
+    errno_t ret;
+
+    test_ctx = talloc_get_type_abort(*state, struct ifp_list_test_ctx);
+
+    mock_parse_inp(NULL, NULL, EIO);
+    mock_parse_inp(NULL, NULL, ERR_DOMAIN_NOT_FOUND);
+    mock_parse_inp(NULL, NULL, EINVAL);
+
+    ret = test_users_by_name(test_ctx, names);
+    assert_int_equal(ret, EIO);
+    assert_null(test_ctx->paths);
+}
+
+/* Nothing found and nothing failed is an empty list. */
+static void test_users_by_name_list_none_found(void **state)
+{
+    struct ifp_list_test_ctx *test_ctx;
+    const char *names[] = {"nodomain", NULL};
+    errno_t ret;
+
+    test_ctx = talloc_get_type_abort(*state, struct ifp_list_test_ctx);
+
+    mock_parse_inp(NULL, NULL, ERR_DOMAIN_NOT_FOUND);
+
+    ret = test_users_by_name(test_ctx, names);
+    assert_int_equal(ret, EOK);
+
+    assert_non_null(test_ctx->paths);
+    assert_null(test_ctx->paths[0]);
+}
+
+static void test_users_by_id_list(void **state)
+{
+    struct ifp_list_test_ctx *test_ctx;
+    struct tevent_req *req;
+    uint32_t *ids;
+    errno_t ret;
+
+    test_ctx = talloc_get_type_abort(*state, struct ifp_list_test_ctx);
+
+    ids = talloc_array(test_ctx, uint32_t, 3);
+    assert_non_null(ids);
+    ids[0] = 1002;
+    ids[1] = 1099;
+    ids[2] = 1001;
+
+    /* The missing user is requested from the data provider. */
+    mock_account_recv_simple();
+
+    req = ifp_users_find_by_id_list_send(test_ctx, test_ctx->tctx->ev,
+                                         NULL, test_ctx->ifp_ctx, ids);
+    assert_non_null(req);
+    tevent_req_set_callback(req, test_users_by_id_done, test_ctx);
+
+    ret = test_ev_loop(test_ctx->tctx);
+    assert_int_equal(ret, EOK);
+
+    assert_non_null(test_ctx->paths);
+    assert_string_equal(test_ctx->paths[0], TEST_USER_PATH("1002"));
+    assert_string_equal(test_ctx->paths[1], TEST_USER_PATH("1001"));
+    assert_null(test_ctx->paths[2]);
+
+    talloc_free(ids);
+}
+
+/* Only the requested attributes that are also whitelisted are returned,
+ * an unknown object gets an empty dictionary. */
+static void test_users_get_attrs(void **state)
+{
+    struct ifp_list_test_ctx *test_ctx;
+    const char *paths[] = {TEST_USER_PATH("1001"),
+                           TEST_USER_PATH("1099"),
+                           IFP_PATH_USERS "/nosuchdomain/1002",
+                           TEST_USER_PATH("1002"),
+                           NULL};
+    const char *attrs[] = {SYSDB_NAME, SYSDB_GECOS, SYSDB_SHELL,
+                           SYSDB_HOMEDIR, NULL};
+    hash_table_t **tables;
+    errno_t ret;
+
+    test_ctx = talloc_get_type_abort(*state, struct ifp_list_test_ctx);
+
+    ret = ifp_users_get_attrs(test_ctx, NULL, test_ctx->ifp_ctx, paths,
+                              attrs, &tables);
+    assert_int_equal(ret, EOK);
+
+    assert_non_null(tables[0]);
+    assert_int_equal(hash_count(tables[0]), 2);
+    assert_string_equal(test_hash_value(tables[0], SYSDB_NAME), "user1");
+    assert_string_equal(test_hash_value(tables[0], SYSDB_GECOS), "User One");
+    assert_null(test_hash_value(tables[0], SYSDB_SHELL));
+
+    assert_non_null(tables[1]);
+    assert_int_equal(hash_count(tables[1]), 0);
+
+    assert_non_null(tables[2]);
+    assert_int_equal(hash_count(tables[2]), 0);
+
+    assert_non_null(tables[3]);
+    assert_int_equal(hash_count(tables[3]), 2);
+    assert_string_equal(test_hash_value(tables[3], SYSDB_NAME), "user2");
+    assert_string_equal(test_hash_value(tables[3], SYSDB_GECOS), "User Two");
+
+    assert_null(tables[4]);
+
+    talloc_free(tables);
+}
+
+static void test_groups_get_attrs(void **state)
+{
+    struct ifp_list_test_ctx *test_ctx;
+    const char *paths[] = {TEST_GROUP_PATH("2001"),
+                           TEST_GROUP_PATH("2099"),
+                           NULL};
+    const char *attrs[] = {SYSDB_NAME, SYSDB_GIDNUM, SYSDB_GECOS, NULL};
+    hash_table_t **tables;
+    errno_t ret;
+
+    test_ctx = talloc_get_type_abort(*state, struct ifp_list_test_ctx);
+
+    ret = ifp_groups_get_attrs(test_ctx, NULL, test_ctx->ifp_ctx, paths,
+                               attrs, &tables);
+    assert_int_equal(ret, EOK);
+
+    assert_non_null(tables[0]);
+    assert_int_equal(hash_count(tables[0]), 2);
+    assert_string_equal(test_hash_value(tables[0], SYSDB_NAME), "group1");
+    assert_string_equal(test_hash_value(tables[0], SYSDB_GIDNUM), "2001");
+
+    assert_non_null(tables[1]);
+    assert_int_equal(hash_count(tables[1]), 0);
+
+    assert_null(tables[2]);
+
+    talloc_free(tables);
+}
+
+int main(int argc, const char *argv[])
+{
+    int rv;
+    int no_cleanup = 0;
+    poptContext pc;
+    int opt;
+    struct poptOption long_options[] = {
+        POPT_AUTOHELP
+        SSSD_DEBUG_OPTS
+        {"no-cleanup", 'n', POPT_ARG_NONE, &no_cleanup, 0,
+         _("Do not delete the test database after a test run"), NULL },
+        POPT_TABLEEND
+    };
+
+    const struct CMUnitTest tests[] = {
+        cmocka_unit_test_setup_teardown(test_users_by_name_list,
+                                        test_ifp_list_setup,
+                                        test_ifp_list_teardown),
+        cmocka_unit_test_setup_teardown(test_users_by_name_list_all_failed,
+                                        test_ifp_list_setup,
+                                        test_ifp_list_teardown),
+        cmocka_unit_test_setup_teardown(test_users_by_name_list_none_found,
+                                        test_ifp_list_setup,
+                                        test_ifp_list_teardown),
+        cmocka_unit_test_setup_teardown(test_users_by_id_list,
+                                        test_ifp_list_setup,
+                                        test_ifp_list_teardown),
+        cmocka_unit_test_setup_teardown(test_users_get_attrs,
+                                        test_ifp_list_setup,
+                                        test_ifp_list_teardown),
+        cmocka_unit_test_setup_teardown(test_groups_get_attrs,
+                                        test_ifp_list_setup,
+                                        test_ifp_list_teardown),
+    };
+
+    /* Set debug level to invalid value so we can decide if -d 0 was used. */
+    debug_level = SSSDBG_INVALID;
+
+    pc = poptGetContext(argv[0], argc, argv, long_options, 0);
+    while ((opt = poptGetNextOpt(pc)) != -1) {
+        switch (opt) {
+        default:
+            fprintf(stderr, "\nInvalid option %s: %s\n\n",
+                    poptBadOption(pc, 0), poptStrerror(opt));
+            poptPrintUsage(pc, stderr, 0);
+            return 1;
+        }
+    }
+    poptFreeContext(pc);
+
+    DEBUG_CLI_INIT(debug_level);
+
+    /* Even though normally the tests should clean up after themselves
+     * they might not after a failed run. Remove the old DB to be sure */
+    tests_set_cwd();
+    test_dom_suite_cleanup(TESTS_PATH, TEST_CONF_DB, TEST_DOM_NAME);
+    test_dom_suite_setup(TESTS_PATH);
+
+    rv = cmocka_run_group_tests(tests, NULL, NULL);
+    if (rv == 0 && !no_cleanup) {
+        test_dom_suite_cleanup(TESTS_PATH, TEST_CONF_DB, TEST_DOM_NAME);
+    }
+    return rv;
+}
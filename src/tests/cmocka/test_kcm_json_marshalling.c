@@ -270,6 +270,58 @@ static void test_kcm_ccache_no_princ(void **state)
     assert_cc_equal(cc, cc2);
 }
 
+static void test_kcm_ccache_copy(void **state)
+{
+    struct kcm_marshalling_test_ctx *test_ctx = talloc_get_type(*state,
+                                        struct kcm_marshalling_test_ctx);
+    errno_t ret;
+    struct cli_creds owner;
+    const char *name;
+    struct kcm_ccache *cc;
+    struct kcm_ccache *cc2;
+    struct sss_iobuf *cred_blob;
+    struct kcm_cred *crd;
+
+    owner.ucred.uid = getuid();
+    owner.ucred.gid = getuid();
+
+    name = talloc_asprintf(test_ctx, "%"SPRIuid, getuid());
+    assert_non_null(name);
+
+    ret = kcm_cc_new(test_ctx,
+                     test_ctx->kctx,
+                     &owner,
+                     name,
+                     test_ctx->princ,
+                     &cc);
+    assert_int_equal(ret, EOK);
+
+    cred_blob = sss_iobuf_init_readonly(cc,
+                                        (const uint8_t *) TEST_CREDS,
+                                        sizeof(TEST_CREDS));
+    assert_non_null(cred_blob);
+
+    ret = kcm_cc_store_cred_blob(cc, cred_blob);
+    assert_int_equal(ret, EOK);
+
+    cc2 = kcm_cc_copy(test_ctx, cc);
+    assert_non_null(cc2);
+    assert_cc_equal(cc, cc2);
+
+    /* The copy must stay valid once the original is gone */
+    talloc_free(cc);
+
+    crd = kcm_cc_get_cred(cc2);
+    assert_non_null(crd);
+    assert_int_equal(sss_iobuf_get_size(kcm_cred_get_creds(crd)),
+                     sizeof(TEST_CREDS));
+    assert_string_equal(sss_iobuf_get_data(kcm_cred_get_creds(crd)),
+                        TEST_CREDS);
+    assert_null(kcm_cc_next_cred(crd));
+
+    talloc_free(cc2);
+}
+
 void test_sec_key_get_uuid(void **state)
 {
     errno_t ret;
@@ -346,6 +398,9 @@ int main(int argc, const char *argv[])
         cmocka_unit_test_setup_teardown(test_kcm_ccache_no_princ,
                                         setup_kcm_marshalling,
                                         teardown_kcm_marshalling),
+        cmocka_unit_test_setup_teardown(test_kcm_ccache_copy,
+                                        setup_kcm_marshalling,
+                                        teardown_kcm_marshalling),
         cmocka_unit_test(test_sec_key_get_uuid),
         cmocka_unit_test(test_sec_key_get_name),
         cmocka_unit_test(test_sec_key_match_name),
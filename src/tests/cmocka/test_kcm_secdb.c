@@ -0,0 +1,687 @@
+/*
+    Copyright (C) 2026 Red Hat
+
+    SSSD tests: Test the in-memory cache of the KCM secdb back end
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "config.h"
+
+#include <stdio.h>
+#include <popt.h>
+
+#include "util/util_creds.h"
+#include "tests/cmocka/common_mock.h"
+
+/* Include the source file to test the static cache functions */
+#include "responder/kcm/kcmsrv_ccache_secdb.c"
+
+#define TEST_REALM            "TESTREALM"
+#define TEST_PRINC_COMPONENT  "PRINC_NAME"
+#define TEST_CREDS            "TESTCREDS"
+#define TEST_UID              10000
+#define TEST_FLUSH_INTERVAL   1
+
+const struct kcm_ccdb_ops ccdb_mem_ops;
+const struct kcm_ccdb_ops ccdb_sec_ops;
+
+/* A fake secrets database keeping the secrets in a list, containers are
+ * stored as secrets without a value. */
+struct test_secret {
+    struct test_secret *prev;
+    struct test_secret *next;
+
+    char *url;
+    char *secret;
+};
+
+struct sss_sec_ctx {
+    struct test_secret *secrets;
+
+    /* returned by every write while set */
+    errno_t write_error;
+};
+
+struct sss_sec_req {
+    struct sss_sec_ctx *sctx;
+    char *url;
+};
+
+static struct test_secret *test_secret_find(struct sss_sec_ctx *sctx,
+                                            const char *url)
+{
+    struct test_secret *s;
+
+    DLIST_FOR_EACH(s, sctx->secrets) {
+        if (strcmp(s->url, url) == 0) {
+            return s;
+        }
+    }
+
+    return NULL;
+}
+
+static errno_t test_secret_add(struct sss_sec_req *req, const char *secret)
+{
+    struct test_secret *s;
+
+    if (req->sctx->write_error != EOK) {
+        return req->sctx->write_error;
+    }
+
+    if (test_secret_find(req->sctx, req->url) != NULL) {
+        return EEXIST;
+    }
+
+    s = talloc_zero(req->sctx, struct test_secret);
+    if (s == NULL) {
+        return ENOMEM;
+    }
+
+    s->url = talloc_strdup(s, req->url);
+    if (s->url == NULL) {
+        talloc_free(s);
+        return ENOMEM;
+    }
+
+    if (secret != NULL) {
+        s->secret = talloc_strdup(s, secret);
+        if (s->secret == NULL) {
+            talloc_free(s);
+            return ENOMEM;
+        }
+    }
+
+    DLIST_ADD(req->sctx->secrets, s);
+    return EOK;
+}
+
+errno_t sss_sec_init(TALLOC_CTX *mem_ctx,
+                     struct sss_sec_hive_config **config_list,
+                     struct sss_sec_ctx **_sec_ctx)
+{
+    *_sec_ctx = talloc_zero(mem_ctx, struct sss_sec_ctx);
+    return *_sec_ctx == NULL ? ENOMEM : EOK;
+}
+
+errno_t sss_sec_get_quota(struct confdb_ctx *cdb,
+                          const char *section_config_path,
+                          struct sss_sec_quota_opt *dfl_max_containers_nest_level,
+                          struct sss_sec_quota_opt *dfl_max_num_secrets,
+                          struct sss_sec_quota_opt *dfl_max_num_uid_secrets,
+                          struct sss_sec_quota_opt *dfl_max_payload,
+                          struct sss_sec_quota *quota)
+{
+    memset(quota, 0, sizeof(struct sss_sec_quota));
+    return EOK;
+}
+
+errno_t sss_sec_new_req(TALLOC_CTX *mem_ctx,
+                        struct sss_sec_ctx *sec_ctx,
+                        const char *url,
+                        uid_t client,
+                        struct sss_sec_req **_req)
+{
+    struct sss_sec_req *req;
+
+    req = talloc_zero(mem_ctx, struct sss_sec_req);
+    if (req == NULL) {
+        return ENOMEM;
+    }
+
+    req->sctx = sec_ctx;
+    req->url = talloc_strdup(req, url);
+    if (req->url == NULL) {
+        talloc_free(req);
+        return ENOMEM;
+    }
+
+    *_req = req;
+    return EOK;
+}
+
+errno_t sss_sec_delete(struct sss_sec_req *req)
+{
+    struct test_secret *s;
+
+    if (req->sctx->write_error != EOK) {
+        return req->sctx->write_error;
+    }
+
+    s = test_secret_find(req->sctx, req->url);
+    if (s == NULL) {
+        return ENOENT;
+    }
+
+    DLIST_REMOVE(req->sctx->secrets, s);
+    talloc_free(s);
+    return EOK;
+}
+
+errno_t sss_sec_list(TALLOC_CTX *mem_ctx,
+                     struct sss_sec_req *req,
+                     char ***_keys,
+                     size_t *_num_keys)
+{
+    struct test_secret *s;
+    size_t url_len = strlen(req->url);
+    char **keys = NULL;
+    size_t num_keys = 0;
+
+    if (test_secret_find(req->sctx, req->url) == NULL) {
+        return ENOENT;
+    }
+
+    DLIST_FOR_EACH(s, req->sctx->secrets) {
+        if (strncmp(s->url, req->url, url_len) != 0
+                || s->url[url_len] == '\0'
+                || strchr(s->url + url_len, '/') != NULL) {
+            continue;
+        }
+
+        keys = talloc_realloc(mem_ctx, keys, char *, num_keys + 1);
+        if (keys == NULL) {
+            return ENOMEM;
+        }
+        keys[num_keys] = talloc_strdup(keys, s->url + url_len);
+        if (keys[num_keys] == NULL) {
+            talloc_free(keys);
+            return ENOMEM;
+        }
+        num_keys++;
+    }
+
+    *_keys = keys;
+    *_num_keys = num_keys;
+    return EOK;
+}
+
+errno_t sss_sec_get(TALLOC_CTX *mem_ctx,
+                    struct sss_sec_req *req,
+                    char **_secret)
+{
+    struct test_secret *s;
+
+    s = test_secret_find(req->sctx, req->url);
+    if (s == NULL || s->secret == NULL) {
+        return ENOENT;
+    }
+
+    *_secret = talloc_strdup(mem_ctx, s->secret);
+    return *_secret == NULL ? ENOMEM : EOK;
+}
+
+errno_t sss_sec_put(struct sss_sec_req *req,
+                    const char *secret)
+{
+    return test_secret_add(req, secret);
+}
+
+errno_t sss_sec_update(struct sss_sec_req *req,
+                       const char *secret)
+{
+    struct test_secret *s;
+    char *value;
+
+    if (req->sctx->write_error != EOK) {
+        return req->sctx->write_error;
+    }
+
+    s = test_secret_find(req->sctx, req->url);
+    if (s == NULL || s->secret == NULL) {
+        return ENOENT;
+    }
+
+    value = talloc_strdup(s, secret);
+    if (value == NULL) {
+        return ENOMEM;
+    }
+    talloc_free(s->secret);
+    s->secret = value;
+    return EOK;
+}
+
+errno_t sss_sec_create_container(struct sss_sec_req *req)
+{
+    return test_secret_add(req, NULL);
+}
+
+struct kcm_secdb_test_ctx {
+    struct tevent_context *ev;
+    krb5_context kctx;
+    krb5_principal princ;
+
+    struct kcm_ccdb *db;
+    struct ccdb_secdb *secdb;
+    struct cli_creds client;
+};
+
+static int setup_kcm_secdb(void **state)
+{
+    struct kcm_secdb_test_ctx *test_ctx;
+    krb5_error_code kerr;
+    errno_t ret;
+
+    test_ctx = talloc_zero(NULL, struct kcm_secdb_test_ctx);
+    assert_non_null(test_ctx);
+
+    test_ctx->ev = tevent_context_init(test_ctx);
+    assert_non_null(test_ctx->ev);
+
+    kerr = krb5_init_context(&test_ctx->kctx);
+    assert_int_equal(kerr, 0);
+
+    kerr = krb5_build_principal(test_ctx->kctx,
+                                &test_ctx->princ,
+                                sizeof(TEST_REALM)-1, TEST_REALM,
+                                TEST_PRINC_COMPONENT, NULL);
+    assert_int_equal(kerr, 0);
+
+    test_ctx->db = talloc_zero(test_ctx, struct kcm_ccdb);
+    assert_non_null(test_ctx->db);
+    test_ctx->db->cc_be_type = CCDB_BE_SECDB;
+    test_ctx->db->ev = test_ctx->ev;
+    test_ctx->db->ops = &ccdb_secdb_ops;
+
+    test_ctx->secdb = talloc_zero(test_ctx->db, struct ccdb_secdb);
+    assert_non_null(test_ctx->secdb);
+    test_ctx->secdb->ev = test_ctx->ev;
+    test_ctx->secdb->flush_interval = TEST_FLUSH_INTERVAL;
+
+    ret = sss_sec_init(test_ctx->secdb, NULL, &test_ctx->secdb->sctx);
+    assert_int_equal(ret, EOK);
+    talloc_set_destructor(test_ctx->secdb, secdb_destructor);
+    test_ctx->db->db_handle = test_ctx->secdb;
+
+    test_ctx->client.ucred.uid = TEST_UID;
+    test_ctx->client.ucred.gid = TEST_UID;
+
+    *state = test_ctx;
+    return 0;
+}
+
+static int teardown_kcm_secdb(void **state)
+{
+    struct kcm_secdb_test_ctx *test_ctx = talloc_get_type(*state,
+                                            struct kcm_secdb_test_ctx);
+    assert_non_null(test_ctx);
+
+    talloc_zfree(test_ctx->db);
+    krb5_free_principal(test_ctx->kctx, test_ctx->princ);
+    krb5_free_context(test_ctx->kctx);
+    talloc_free(test_ctx);
+    return 0;
+}
+
+static void test_cc_create(struct kcm_secdb_test_ctx *test_ctx,
+                           struct cli_creds *client,
+                           uuid_t uuid)
+{
+    struct kcm_ccache *cc;
+    struct tevent_req *req;
+    const char *name;
+    errno_t ret;
+
+    name = talloc_asprintf(test_ctx, "%"SPRIuid":1",
+                           cli_creds_get_uid(client));
+    assert_non_null(name);
+
+    ret = kcm_cc_new(test_ctx, test_ctx->kctx, client, name,
+                     test_ctx->princ, &cc);
+    assert_int_equal(ret, EOK);
+
+    ret = kcm_cc_get_uuid(cc, uuid);
+    assert_int_equal(ret, EOK);
+
+    req = ccdb_secdb_create_send(test_ctx, test_ctx->ev, test_ctx->db,
+                                 client, cc);
+    assert_non_null(req);
+    ret = ccdb_secdb_create_recv(req);
+    assert_int_equal(ret, EOK);
+
+    talloc_free(req);
+    talloc_free(cc);
+}
+
+static errno_t test_cc_store_cred(struct kcm_secdb_test_ctx *test_ctx,
+                                  struct cli_creds *client,
+                                  uuid_t uuid)
+{
+    struct sss_iobuf *cred_blob;
+    struct tevent_req *req;
+    errno_t ret;
+
+    cred_blob = sss_iobuf_init_readonly(test_ctx,
+                                        (const uint8_t *) TEST_CREDS,
+                                        sizeof(TEST_CREDS));
+    assert_non_null(cred_blob);
+
+    req = ccdb_secdb_store_cred_send(test_ctx, test_ctx->ev, test_ctx->db,
+                                     client, uuid, cred_blob);
+    assert_non_null(req);
+    ret = ccdb_secdb_store_cred_recv(req);
+
+    talloc_free(req);
+    talloc_free(cred_blob);
+    return ret;
+}
+
+static errno_t test_cc_delete(struct kcm_secdb_test_ctx *test_ctx,
+                              struct cli_creds *client,
+                              uuid_t uuid)
+{
+    struct tevent_req *req;
+    errno_t ret;
+
+    req = ccdb_secdb_delete_send(test_ctx, test_ctx->ev, test_ctx->db,
+                                 client, uuid);
+    assert_non_null(req);
+    ret = ccdb_secdb_delete_recv(req);
+
+    talloc_free(req);
+    return ret;
+}
+
+static int test_count_creds(struct kcm_ccache *cc)
+{
+    struct kcm_cred *crd;
+    int count = 0;
+
+    for (crd = kcm_cc_get_cred(cc); crd != NULL; crd = kcm_cc_next_cred(crd)) {
+        count++;
+    }
+
+    return count;
+}
+
+/* Number of credentials of the ccache as served by the back end */
+static int test_cached_creds(struct kcm_secdb_test_ctx *test_ctx,
+                             struct cli_creds *client,
+                             uuid_t uuid)
+{
+    struct kcm_ccache *cc;
+    struct tevent_req *req;
+    errno_t ret;
+    int count;
+
+    req = ccdb_secdb_getbyuuid_send(test_ctx, test_ctx->ev, test_ctx->db,
+                                    client, uuid);
+    assert_non_null(req);
+    ret = ccdb_secdb_getbyuuid_recv(req, test_ctx, &cc);
+    assert_int_equal(ret, EOK);
+    assert_non_null(cc);
+
+    count = test_count_creds(cc);
+    talloc_free(req);
+    talloc_free(cc);
+    return count;
+}
+
+/* Number of credentials of the ccache in the database, -1 if the ccache
+ * is not stored */
+static int test_stored_creds(struct kcm_secdb_test_ctx *test_ctx,
+                             struct cli_creds *client,
+                             uuid_t uuid)
+{
+    struct sss_sec_req *sreq;
+    struct kcm_ccache *cc;
+    char **keys;
+    size_t nkeys;
+    errno_t ret;
+    int count = -1;
+
+    ret = secdb_container_url_req(test_ctx, test_ctx->secdb->sctx, client,
+                                  &sreq);
+    assert_int_equal(ret, EOK);
+
+    ret = sss_sec_list(test_ctx, sreq, &keys, &nkeys);
+    if (ret == ENOENT) {
+        talloc_free(sreq);
+        return -1;
+    }
+    assert_int_equal(ret, EOK);
+
+    for (size_t i = 0; i < nkeys; i++) {
+        if (!sec_key_match_uuid(keys[i], uuid)) {
+            continue;
+        }
+
+        ret = secdb_get_cc(test_ctx, test_ctx->secdb->sctx, keys[i], client,
+                           &cc);
+        assert_int_equal(ret, EOK);
+        count = test_count_creds(cc);
+        talloc_free(cc);
+    }
+
+    talloc_free(keys);
+    talloc_free(sreq);
+    return count;
+}
+
+static void test_wait_flush(struct kcm_secdb_test_ctx *test_ctx)
+{
+    assert_non_null(test_ctx->secdb->flush_timer);
+    assert_int_equal(tevent_loop_once(test_ctx->ev), 0);
+}
+
+/* Stored credentials are served from memory right away and written back
+ * once the flush interval passed. */
+static void test_kcm_secdb_flush_timer(void **state)
+{
+    struct kcm_secdb_test_ctx *test_ctx = talloc_get_type(*state,
+                                            struct kcm_secdb_test_ctx);
+    uuid_t uuid;
+    errno_t ret;
+
+    test_cc_create(test_ctx, &test_ctx->client, uuid);
+    assert_null(test_ctx->secdb->flush_timer);
+    assert_int_equal(test_stored_creds(test_ctx, &test_ctx->client, uuid), 0);
+
+    ret = test_cc_store_cred(test_ctx, &test_ctx->client, uuid);
+    assert_int_equal(ret, EOK);
+    ret = test_cc_store_cred(test_ctx, &test_ctx->client, uuid);
+    assert_int_equal(ret, EOK);
+
+    assert_int_equal(test_cached_creds(test_ctx, &test_ctx->client, uuid), 2);
+    assert_int_equal(test_stored_creds(test_ctx, &test_ctx->client, uuid), 0);
+
+    test_wait_flush(test_ctx);
+
+    assert_null(test_ctx->secdb->flush_timer);
+    assert_int_equal(test_stored_creds(test_ctx, &test_ctx->client, uuid), 2);
+}
+
+/* A failed write back keeps the changes and retries them. */
+static void test_kcm_secdb_flush_failure(void **state)
+{
+    struct kcm_secdb_test_ctx *test_ctx = talloc_get_type(*state,
+                                            struct kcm_secdb_test_ctx);
+    uuid_t uuid;
+    errno_t ret;
+
+    test_cc_create(test_ctx, &test_ctx->client, uuid);
+
+    ret = test_cc_store_cred(test_ctx, &test_ctx->client, uuid);
+    assert_int_equal(ret, EOK);
+
+    test_ctx->secdb->sctx->write_error = EIO;
+    test_wait_flush(test_ctx);
+
+    assert_int_equal(test_stored_creds(test_ctx, &test_ctx->client, uuid), 0);
+    assert_int_equal(test_cached_creds(test_ctx, &test_ctx->client, uuid), 1);
+
+    test_ctx->secdb->sctx->write_error = EOK;
+    test_wait_flush(test_ctx);
+
+    assert_null(test_ctx->secdb->flush_timer);
+    assert_int_equal(test_stored_creds(test_ctx, &test_ctx->client, uuid), 1);
+}
+
+/* Without a flush interval the client learns about a failed write and
+ * the stored ccache is served again. */
+static void test_kcm_secdb_write_through_failure(void **state)
+{
+    struct kcm_secdb_test_ctx *test_ctx = talloc_get_type(*state,
+                                            struct kcm_secdb_test_ctx);
+    uuid_t uuid;
+    errno_t ret;
+
+    test_ctx->secdb->flush_interval = 0;
+    test_cc_create(test_ctx, &test_ctx->client, uuid);
+
+    ret = test_cc_store_cred(test_ctx, &test_ctx->client, uuid);
+    assert_int_equal(ret, EOK);
+    assert_null(test_ctx->secdb->flush_timer);
+    assert_int_equal(test_stored_creds(test_ctx, &test_ctx->client, uuid), 1);
+
+    test_ctx->secdb->sctx->write_error = EIO;
+    ret = test_cc_store_cred(test_ctx, &test_ctx->client, uuid);
+    assert_int_equal(ret, EIO);
+    test_ctx->secdb->sctx->write_error = EOK;
+
+    assert_int_equal(test_cached_creds(test_ctx, &test_ctx->client, uuid), 1);
+    assert_int_equal(test_stored_creds(test_ctx, &test_ctx->client, uuid), 1);
+}
+
+/* The least recently used UID is written back and dropped once too many
+ * UIDs are cached, unless its changes cannot be written. */
+static void test_kcm_secdb_evict(void **state)
+{
+    struct kcm_secdb_test_ctx *test_ctx = talloc_get_type(*state,
+                                            struct kcm_secdb_test_ctx);
+    struct ccdb_secdb *secdb = test_ctx->secdb;
+    struct ccdb_secdb_uid *uid_cache;
+    struct cli_creds client;
+    uuid_t uuid;
+    errno_t ret;
+
+    test_cc_create(test_ctx, &test_ctx->client, uuid);
+    ret = test_cc_store_cred(test_ctx, &test_ctx->client, uuid);
+    assert_int_equal(ret, EOK);
+    assert_non_null(secdb_uid_find(secdb, TEST_UID));
+
+    client = test_ctx->client;
+    for (unsigned int i = 1; i < KCM_SECDB_MAX_CACHED_UIDS; i++) {
+        client.ucred.uid = TEST_UID + i;
+        ret = secdb_uid_get(secdb, &client, &uid_cache);
+        assert_int_equal(ret, EOK);
+    }
+    assert_int_equal(secdb->num_uids, KCM_SECDB_MAX_CACHED_UIDS);
+    assert_non_null(secdb_uid_find(secdb, TEST_UID));
+    assert_int_equal(test_stored_creds(test_ctx, &test_ctx->client, uuid), 0);
+
+    /* The write back fails, the UID is kept over the limit */
+    secdb->sctx->write_error = EIO;
+    client.ucred.uid = TEST_UID + KCM_SECDB_MAX_CACHED_UIDS;
+    ret = secdb_uid_get(secdb, &client, &uid_cache);
+    assert_int_equal(ret, EOK);
+    assert_int_equal(secdb->num_uids, KCM_SECDB_MAX_CACHED_UIDS + 1);
+    assert_non_null(secdb_uid_find(secdb, TEST_UID));
+
+    /* The next new UID evicts it */
+    secdb->sctx->write_error = EOK;
+    client.ucred.uid = TEST_UID + KCM_SECDB_MAX_CACHED_UIDS + 1;
+    ret = secdb_uid_get(secdb, &client, &uid_cache);
+    assert_int_equal(ret, EOK);
+    assert_int_equal(secdb->num_uids, KCM_SECDB_MAX_CACHED_UIDS + 1);
+    assert_null(secdb_uid_find(secdb, TEST_UID));
+    assert_int_equal(test_stored_creds(test_ctx, &test_ctx->client, uuid), 1);
+
+    /* and it is read from the database again */
+    assert_int_equal(test_cached_creds(test_ctx, &test_ctx->client, uuid), 1);
+    assert_non_null(secdb_uid_find(secdb, TEST_UID));
+}
+
+/* Deleting a ccache drops its pending changes, a later write back must not
+ * bring it back. */
+static void test_kcm_secdb_delete_pending(void **state)
+{
+    struct kcm_secdb_test_ctx *test_ctx = talloc_get_type(*state,
+                                            struct kcm_secdb_test_ctx);
+    struct ccdb_secdb_uid *uid_cache;
+    uuid_t uuid;
+    errno_t ret;
+
+    test_cc_create(test_ctx, &test_ctx->client, uuid);
+    ret = test_cc_store_cred(test_ctx, &test_ctx->client, uuid);
+    assert_int_equal(ret, EOK);
+
+    ret = test_cc_delete(test_ctx, &test_ctx->client, uuid);
+    assert_int_equal(ret, EOK);
+
+    uid_cache = secdb_uid_find(test_ctx->secdb, TEST_UID);
+    assert_non_null(uid_cache);
+    assert_null(uid_cache->ccs);
+
+    test_wait_flush(test_ctx);
+    assert_int_equal(test_stored_creds(test_ctx, &test_ctx->client, uuid), -1);
+
+    /* Deleting from an empty container is not an error */
+    ret = test_cc_delete(test_ctx, &test_ctx->client, uuid);
+    assert_int_equal(ret, EOK);
+}
+
+int main(int argc, const char *argv[])
+{
+    poptContext pc;
+    int opt;
+    int rv;
+    struct poptOption long_options[] = {
+        POPT_AUTOHELP
+        SSSD_DEBUG_OPTS
+        POPT_TABLEEND
+    };
+
+    const struct CMUnitTest tests[] = {
+        cmocka_unit_test_setup_teardown(test_kcm_secdb_flush_timer,
+                                        setup_kcm_secdb,
+                                        teardown_kcm_secdb),
+        cmocka_unit_test_setup_teardown(test_kcm_secdb_flush_failure,
+                                        setup_kcm_secdb,
+                                        teardown_kcm_secdb),
+        cmocka_unit_test_setup_teardown(test_kcm_secdb_write_through_failure,
+                                        setup_kcm_secdb,
+                                        teardown_kcm_secdb),
+        cmocka_unit_test_setup_teardown(test_kcm_secdb_evict,
+                                        setup_kcm_secdb,
+                                        teardown_kcm_secdb),
+        cmocka_unit_test_setup_teardown(test_kcm_secdb_delete_pending,
+                                        setup_kcm_secdb,
+                                        teardown_kcm_secdb),
+    };
+
+    /* Set debug level to invalid value so we can decide if -d 0 was used. */
+    debug_level = SSSDBG_INVALID;
+
+    pc = poptGetContext(argv[0], argc, argv, long_options, 0);
+    while((opt = poptGetNextOpt(pc)) != -1) {
+        switch(opt) {
+        default:
+            fprintf(stderr, "\nInvalid option %s: %s\n\n",
+                    poptBadOption(pc, 0), poptStrerror(opt));
+            poptPrintUsage(pc, stderr, 0);
+            return 1;
+        }
+    }
+    poptFreeContext(pc);
+
+    DEBUG_CLI_INIT(debug_level);
+
+    tests_set_cwd();
+
+    rv = cmocka_run_group_tests(tests, NULL, NULL);
+
+    return rv;
+}
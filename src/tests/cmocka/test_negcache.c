@@ -131,6 +131,23 @@ static int setup(void **state)
     return 0;
 }
 
+static int setup_tdb(void **state)
+{
+    int ret;
+    struct test_state *ts;
+
+    ts = talloc(NULL, struct test_state);
+    assert_non_null(ts);
+
+    ret = sss_ncache_init_ex(ts, SSS_NCACHE_BACKEND_TDB, SHORTSPAN, 0,
+                             &ts->ctx);
+    assert_int_equal(ret, EOK);
+    assert_non_null(ts->ctx);
+
+    *state = (void *)ts;
+    return 0;
+}
+
 static int teardown(void **state)
 {
     struct test_state *ts = talloc_get_type_abort(*state, struct test_state);
@@ -1060,6 +1077,81 @@ static void test_sss_ncache_domain_locate_type(void **state)
     assert_int_equal(ret, ENOENT);
 }
 
+/* @test_sss_ncache_many : store enough entries to grow the hash table
+ * several times and check that resizing and removal keep all of them
+ * reachable
+ */
+static void test_sss_ncache_many(void **state)
+{
+    int ret;
+    int i;
+    char *name;
+    struct test_state *ts;
+    struct sss_domain_info *dom;
+    const int count = 10000;
+
+    ts = talloc_get_type_abort(*state, struct test_state);
+    dom = talloc(ts, struct sss_domain_info);
+    assert_non_null(dom);
+    dom->name = discard_const_p(char, TEST_DOM_NAME);
+    dom->case_sensitive = true;
+
+    for (i = 0; i < count; i++) {
+        name = talloc_asprintf(ts, "user%d", i);
+        assert_non_null(name);
+
+        ret = sss_ncache_set_user(ts->ctx, i % 2 == 0, dom, name);
+        assert_int_equal(ret, EOK);
+        ret = sss_ncache_set_uid(ts->ctx, i % 2 == 0, dom, i);
+        assert_int_equal(ret, EOK);
+        talloc_free(name);
+    }
+
+    for (i = 0; i < count; i++) {
+        name = talloc_asprintf(ts, "user%d", i);
+        assert_non_null(name);
+
+        ret = sss_ncache_check_user(ts->ctx, dom, name);
+        assert_int_equal(ret, EEXIST);
+        ret = sss_ncache_check_group(ts->ctx, dom, name);
+        assert_int_equal(ret, ENOENT);
+        ret = sss_ncache_check_uid(ts->ctx, dom, i);
+        assert_int_equal(ret, EEXIST);
+        ret = sss_ncache_check_uid(ts->ctx, NULL, i);
+        assert_int_equal(ret, ENOENT);
+        talloc_free(name);
+    }
+
+    /* only the permanent half goes away */
+    ret = sss_ncache_reset_permanent(ts->ctx);
+    assert_int_equal(ret, EOK);
+
+    for (i = 0; i < count; i++) {
+        name = talloc_asprintf(ts, "user%d", i);
+        assert_non_null(name);
+
+        ret = sss_ncache_check_user(ts->ctx, dom, name);
+        assert_int_equal(ret, i % 2 == 0 ? ENOENT : EEXIST);
+        ret = sss_ncache_check_uid(ts->ctx, dom, i);
+        assert_int_equal(ret, i % 2 == 0 ? ENOENT : EEXIST);
+        talloc_free(name);
+    }
+
+    /* the rest expires */
+    sleep(SHORTSPAN + 1);
+
+    for (i = 0; i < count; i++) {
+        name = talloc_asprintf(ts, "user%d", i);
+        assert_non_null(name);
+
+        ret = sss_ncache_check_user(ts->ctx, dom, name);
+        assert_int_equal(ret, ENOENT);
+        ret = sss_ncache_check_uid(ts->ctx, dom, i);
+        assert_int_equal(ret, ENOENT);
+        talloc_free(name);
+    }
+}
+
 int main(void)
 {
     int rv;
@@ -1090,6 +1182,16 @@ int main(void)
                                         setup, teardown),
         cmocka_unit_test_setup_teardown(test_sss_ncache_domain_locate_type,
                                         setup, teardown),
+        cmocka_unit_test_setup_teardown(test_sss_ncache_many,
+                                        setup, teardown),
+        cmocka_unit_test_setup_teardown(test_sss_ncache_uid,
+                                        setup_tdb, teardown),
+        cmocka_unit_test_setup_teardown(test_sss_ncache_user,
+                                        setup_tdb, teardown),
+        cmocka_unit_test_setup_teardown(test_sss_ncache_reset,
+                                        setup_tdb, teardown),
+        cmocka_unit_test_setup_teardown(test_sss_ncache_many,
+                                        setup_tdb, teardown),
 
         /* user */
         cmocka_unit_test_setup_teardown(test_ncache_nocache_user,
@@ -587,6 +587,233 @@ static void nested_groups_test_nested_chain_with_error(void **state)
     assert_int_equal(ret, EIO);
 }
 
+static void nested_groups_test_batched_users(void **state)
+{
+    struct nested_groups_test_ctx *test_ctx = NULL;
+    struct sysdb_attrs *rootgroup = NULL;
+    struct tevent_req *req = NULL;
+    TALLOC_CTX *req_mem_ctx = NULL;
+    errno_t ret;
+    const char *users[] = { "cn=user1,"USER_BASE_DN,
+                            "cn=user2,"USER_BASE_DN,
+                            "cn=user3,"USER_BASE_DN,
+                            NULL };
+    const struct sysdb_attrs *batch_reply[5] = { NULL };
+    const char * expected[] = { "user1",
+                                "user2",
+                                "user3" };
+
+    test_ctx = talloc_get_type_abort(*state, struct nested_groups_test_ctx);
+
+    ret = dp_opt_set_int(test_ctx->sdap_opts->basic,
+                         SDAP_NESTING_BATCH_SIZE, 10);
+    assert_int_equal(ret, EOK);
+    ret = dp_opt_set_int(test_ctx->sdap_opts->basic,
+                         SDAP_NESTING_CONCURRENCY, 4);
+    assert_int_equal(ret, EOK);
+
+    /* mock return values */
+    rootgroup = mock_sysdb_group_rfc2307bis(test_ctx, GROUP_BASE_DN, 1000,
+                                            "rootgroup", users);
+
+    /* all members are returned by a single search, in any order, together
+     * with an entry that is not a member of the group */
+    batch_reply[0] = mock_sysdb_user(test_ctx, USER_BASE_DN, 2003, "user3");
+    batch_reply[1] = mock_sysdb_user(test_ctx, USER_BASE_DN, 2001, "user1");
+    batch_reply[2] = mock_sysdb_user(test_ctx, USER_BASE_DN, 2009, "user9");
+    batch_reply[3] = mock_sysdb_user(test_ctx, USER_BASE_DN, 2002, "user2");
+    assert_non_null(batch_reply[0]);
+    assert_non_null(batch_reply[1]);
+    assert_non_null(batch_reply[2]);
+    assert_non_null(batch_reply[3]);
+    will_return(sdap_get_generic_recv, 4);
+    will_return(sdap_get_generic_recv, batch_reply);
+    will_return(sdap_get_generic_recv, ERR_OK);
+
+    sss_will_return_always(sdap_has_deref_support, false);
+
+    /* run test, check for memory leaks */
+    req_mem_ctx = talloc_new(global_talloc_context);
+    assert_non_null(req_mem_ctx);
+    check_leaks_push(req_mem_ctx);
+
+    req = sdap_nested_group_send(req_mem_ctx, test_ctx->tctx->ev,
+                                 test_ctx->sdap_domain, test_ctx->sdap_opts,
+                                 test_ctx->sdap_handle, rootgroup);
+    assert_non_null(req);
+    tevent_req_set_callback(req, nested_groups_test_done, test_ctx);
+
+    ret = test_ev_loop(test_ctx->tctx);
+    assert_true(check_leaks_pop(req_mem_ctx) == true);
+    talloc_zfree(req_mem_ctx);
+
+    /* check return code */
+    assert_int_equal(ret, ERR_OK);
+
+    /* Check the users */
+    assert_int_equal(test_ctx->num_users, N_ELEMENTS(expected));
+    assert_int_equal(test_ctx->num_groups, 1);
+
+    compare_sysdb_string_array_noorder(test_ctx->users,
+                                       expected, N_ELEMENTS(expected));
+}
+
+static void nested_groups_test_batched_groups(void **state)
+{
+    struct nested_groups_test_ctx *test_ctx = NULL;
+    struct sysdb_attrs *rootgroup = NULL;
+    struct tevent_req *req = NULL;
+    TALLOC_CTX *req_mem_ctx = NULL;
+    errno_t ret;
+    const char *groups[] = { "cn=group1,"GROUP_BASE_DN,
+                             "cn=group2,"GROUP_BASE_DN,
+                             NULL };
+    const struct sysdb_attrs *batch_reply[3] = { NULL };
+    const char * expected[] = { "rootgroup",
+                                "group1",
+                                "group2" };
+
+    test_ctx = talloc_get_type_abort(*state, struct nested_groups_test_ctx);
+
+    ret = dp_opt_set_int(test_ctx->sdap_opts->basic,
+                         SDAP_NESTING_BATCH_SIZE, 10);
+    assert_int_equal(ret, EOK);
+
+    /* mock return values */
+    rootgroup = mock_sysdb_group_rfc2307bis(test_ctx, GROUP_BASE_DN, 1000,
+                                            "rootgroup", groups);
+
+    /* both nested groups are returned by a single search */
+    batch_reply[0] = mock_sysdb_group_rfc2307bis(test_ctx, GROUP_BASE_DN,
+                                                 1002, "group2", NULL);
+    batch_reply[1] = mock_sysdb_group_rfc2307bis(test_ctx, GROUP_BASE_DN,
+                                                 1001, "group1", NULL);
+    assert_non_null(batch_reply[0]);
+    assert_non_null(batch_reply[1]);
+    will_return(sdap_get_generic_recv, 2);
+    will_return(sdap_get_generic_recv, batch_reply);
+    will_return(sdap_get_generic_recv, ERR_OK);
+
+    sss_will_return_always(sdap_has_deref_support, false);
+
+    /* run test, check for memory leaks */
+    req_mem_ctx = talloc_new(global_talloc_context);
+    assert_non_null(req_mem_ctx);
+    check_leaks_push(req_mem_ctx);
+
+    req = sdap_nested_group_send(req_mem_ctx, test_ctx->tctx->ev,
+                                 test_ctx->sdap_domain, test_ctx->sdap_opts,
+                                 test_ctx->sdap_handle, rootgroup);
+    assert_non_null(req);
+    tevent_req_set_callback(req, nested_groups_test_done, test_ctx);
+
+    ret = test_ev_loop(test_ctx->tctx);
+    assert_true(check_leaks_pop(req_mem_ctx) == true);
+    talloc_zfree(req_mem_ctx);
+
+    /* check return code */
+    assert_int_equal(ret, ERR_OK);
+
+    /* Check the groups */
+    assert_int_equal(test_ctx->num_users, 0);
+    assert_int_equal(test_ctx->num_groups, N_ELEMENTS(expected));
+
+    compare_sysdb_string_array_noorder(test_ctx->groups,
+                                       expected, N_ELEMENTS(expected));
+}
+
+static void nested_groups_test_concurrent_members(void **state)
+{
+    struct nested_groups_test_ctx *test_ctx = NULL;
+    struct sysdb_attrs *rootgroup = NULL;
+    struct tevent_req *req = NULL;
+    TALLOC_CTX *req_mem_ctx = NULL;
+    errno_t ret;
+    const char *members[] = { "cn=user1,"USER_BASE_DN,
+                              "cn=group1,"GROUP_BASE_DN,
+                              "cn=user2,"USER_BASE_DN,
+                              NULL };
+    const char *group1_members[] = { "cn=user3,"USER_BASE_DN,
+                                     NULL };
+    const struct sysdb_attrs *user1_reply[2] = { NULL };
+    const struct sysdb_attrs *group1_reply[2] = { NULL };
+    const struct sysdb_attrs *user2_reply[2] = { NULL };
+    const struct sysdb_attrs *user3_reply[2] = { NULL };
+    const char * expected_users[] = { "user1",
+                                      "user2",
+                                      "user3" };
+    const char * expected_groups[] = { "rootgroup",
+                                       "group1" };
+
+    test_ctx = talloc_get_type_abort(*state, struct nested_groups_test_ctx);
+
+    ret = dp_opt_set_int(test_ctx->sdap_opts->basic,
+                         SDAP_NESTING_CONCURRENCY, 8);
+    assert_int_equal(ret, EOK);
+
+    /* mock return values, the lookups of one level are all sent before
+     * the first reply is received */
+    rootgroup = mock_sysdb_group_rfc2307bis(test_ctx, GROUP_BASE_DN, 1000,
+                                            "rootgroup", members);
+
+    user1_reply[0] = mock_sysdb_user(test_ctx, USER_BASE_DN, 2001, "user1");
+    assert_non_null(user1_reply[0]);
+    will_return(sdap_get_generic_recv, 1);
+    will_return(sdap_get_generic_recv, user1_reply);
+    will_return(sdap_get_generic_recv, ERR_OK);
+
+    group1_reply[0] = mock_sysdb_group_rfc2307bis(test_ctx, GROUP_BASE_DN,
+                                                  1001, "group1",
+                                                  group1_members);
+    assert_non_null(group1_reply[0]);
+    will_return(sdap_get_generic_recv, 1);
+    will_return(sdap_get_generic_recv, group1_reply);
+    will_return(sdap_get_generic_recv, ERR_OK);
+
+    user2_reply[0] = mock_sysdb_user(test_ctx, USER_BASE_DN, 2002, "user2");
+    assert_non_null(user2_reply[0]);
+    will_return(sdap_get_generic_recv, 1);
+    will_return(sdap_get_generic_recv, user2_reply);
+    will_return(sdap_get_generic_recv, ERR_OK);
+
+    user3_reply[0] = mock_sysdb_user(test_ctx, USER_BASE_DN, 2003, "user3");
+    assert_non_null(user3_reply[0]);
+    will_return(sdap_get_generic_recv, 1);
+    will_return(sdap_get_generic_recv, user3_reply);
+    will_return(sdap_get_generic_recv, ERR_OK);
+
+    sss_will_return_always(sdap_has_deref_support, false);
+
+    /* run test, check for memory leaks */
+    req_mem_ctx = talloc_new(global_talloc_context);
+    assert_non_null(req_mem_ctx);
+    check_leaks_push(req_mem_ctx);
+
+    req = sdap_nested_group_send(req_mem_ctx, test_ctx->tctx->ev,
+                                 test_ctx->sdap_domain, test_ctx->sdap_opts,
+                                 test_ctx->sdap_handle, rootgroup);
+    assert_non_null(req);
+    tevent_req_set_callback(req, nested_groups_test_done, test_ctx);
+
+    ret = test_ev_loop(test_ctx->tctx);
+    assert_true(check_leaks_pop(req_mem_ctx) == true);
+    talloc_zfree(req_mem_ctx);
+
+    /* check return code */
+    assert_int_equal(ret, ERR_OK);
+
+    /* Check the users and groups */
+    assert_int_equal(test_ctx->num_users, N_ELEMENTS(expected_users));
+    assert_int_equal(test_ctx->num_groups, N_ELEMENTS(expected_groups));
+
+    compare_sysdb_string_array_noorder(test_ctx->users,
+                                       expected_users,
+                                       N_ELEMENTS(expected_users));
+    compare_sysdb_string_array_noorder(test_ctx->groups,
+                                       expected_groups,
+                                       N_ELEMENTS(expected_groups));
+}
+
 static int nested_groups_test_setup(void **state)
 {
     errno_t ret;
@@ -1298,6 +1525,9 @@ int main(int argc, const char *argv[])
         new_test(one_group_dup_group_members),
         new_test(nested_chain),
         new_test(nested_chain_with_error),
+        new_test(batched_users),
+        new_test(batched_groups),
+        new_test(concurrent_members),
         cmocka_unit_test_setup_teardown(nested_group_external_member_test,
                                         nested_group_external_member_setup,
                                         nested_group_external_member_teardown),
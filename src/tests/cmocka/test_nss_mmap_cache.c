@@ -0,0 +1,450 @@
+/*
+    SSSD
+
+    NSS memory cache - tests of the responder writers and client readers
+
+    Copyright (C) 2026 Red Hat
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <cmocka.h>
+#include <popt.h>
+#include <sys/stat.h>
+#include <arpa/inet.h>
+
+#include "tests/cmocka/common_mock.h"
+#include "responder/nss/nsssrv_mmap_cache.h"
+#include "sss_client/nss_mc.h"
+#include "sss_client/idmap/sss_nss_idmap.h"
+#include "sss_client/idmap/sss_nss_idmap_private.h"
+
+#define TEST_MC_ELEMS 64
+#define TEST_MC_TIMEOUT 300
+
+struct test_mc_ctx {
+    struct sss_mc_ctx *svc_mc_ctx;
+    struct sss_mc_ctx *sid_mc_ctx;
+};
+
+/* The client readers take the client library lock when mapping a cache
+ * for the first time. The tests are single-threaded. */
+void sss_nss_mc_lock(void)
+{
+    return;
+}
+
+void sss_nss_mc_unlock(void)
+{
+    return;
+}
+
+static void test_mc_unlink(const char *name)
+{
+    char *path;
+
+    path = talloc_asprintf(NULL, "%s/%s", SSS_NSS_MCACHE_DIR, name);
+    assert_non_null(path);
+    unlink(path);
+    talloc_free(path);
+}
+
+/* The client readers map each cache file only once per process, so the
+ * caches are shared by all tests and every test uses its own keys. */
+static int test_mc_group_setup(void **state)
+{
+    struct test_mc_ctx *test_ctx;
+    errno_t ret;
+
+    assert_true(leak_check_setup());
+
+    ret = mkdir(SSS_NSS_MCACHE_DIR, 0700);
+    if (ret != 0 && errno != EEXIST) {
+        return 1;
+    }
+
+    test_ctx = talloc_zero(global_talloc_context, struct test_mc_ctx);
+    assert_non_null(test_ctx);
+
+    ret = sss_mmap_cache_init(test_ctx, "services", geteuid(), getegid(),
+                              SSS_MC_SERVICES, TEST_MC_ELEMS,
+                              TEST_MC_TIMEOUT, &test_ctx->svc_mc_ctx);
+    assert_int_equal(ret, EOK);
+
+    ret = sss_mmap_cache_init(test_ctx, "sid", geteuid(), getegid(),
+                              SSS_MC_SID, TEST_MC_ELEMS,
+                              TEST_MC_TIMEOUT, &test_ctx->sid_mc_ctx);
+    assert_int_equal(ret, EOK);
+
+    *state = test_ctx;
+    return 0;
+}
+
+static int test_mc_group_teardown(void **state)
+{
+    struct test_mc_ctx *test_ctx = talloc_get_type_abort(*state,
+                                                         struct test_mc_ctx);
+
+    talloc_free(test_ctx);
+    test_mc_unlink("services");
+    test_mc_unlink("sid");
+    rmdir(SSS_NSS_MCACHE_DIR);
+
+    assert_true(leak_check_teardown());
+    return 0;
+}
+
+static void test_mc_svc_store(struct test_mc_ctx *test_ctx,
+                              const char *name, const char *protocol,
+                              uint16_t port, const char *alias)
+{
+    struct sized_string s_name;
+    struct sized_string s_protocol;
+    struct sized_string s_alias;
+    errno_t ret;
+
+    to_sized_string(&s_name, name);
+    to_sized_string(&s_protocol, protocol);
+    to_sized_string(&s_alias, alias);
+
+    ret = sss_mmap_cache_svc_store(&test_ctx->svc_mc_ctx, &s_name,
+                                   &s_protocol, port, 1, &s_alias);
+    assert_int_equal(ret, EOK);
+}
+
+static void test_mc_svc_check(struct servent *result,
+                              const char *name, const char *protocol,
+                              uint16_t port, const char *alias)
+{
+    assert_string_equal(result->s_name, name);
+    assert_string_equal(result->s_proto, protocol);
+    assert_int_equal(result->s_port, htons(port));
+    assert_non_null(result->s_aliases);
+    assert_string_equal(result->s_aliases[0], alias);
+    assert_null(result->s_aliases[1]);
+}
+
+static void test_mc_svc_by_name(void **state)
+{
+    struct test_mc_ctx *test_ctx = talloc_get_type_abort(*state,
+                                                         struct test_mc_ctx);
+    struct servent result;
+    char buffer[1024];
+    errno_t ret;
+
+    test_mc_svc_store(test_ctx, "mc_svc_name", "tcp", 4711, "mc_svc_alias");
+
+    ret = sss_nss_mc_getservbyname("mc_svc_name", strlen("mc_svc_name"),
+                                   "tcp", &result, buffer, sizeof(buffer));
+    assert_int_equal(ret, EOK);
+    test_mc_svc_check(&result, "mc_svc_name", "tcp", 4711, "mc_svc_alias");
+
+    /* no protocol matches any protocol */
+    ret = sss_nss_mc_getservbyname("mc_svc_name", strlen("mc_svc_name"),
+                                   NULL, &result, buffer, sizeof(buffer));
+    assert_int_equal(ret, EOK);
+    test_mc_svc_check(&result, "mc_svc_name", "tcp", 4711, "mc_svc_alias");
+
+    ret = sss_nss_mc_getservbyname("mc_svc_name", strlen("mc_svc_name"),
+                                   "udp", &result, buffer, sizeof(buffer));
+    assert_int_equal(ret, ENOENT);
+
+    ret = sss_nss_mc_getservbyname("mc_svc_missing", strlen("mc_svc_missing"),
+                                   "tcp", &result, buffer, sizeof(buffer));
+    assert_int_equal(ret, ENOENT);
+
+    /* the buffer is too small for the strings of the entry */
+    ret = sss_nss_mc_getservbyname("mc_svc_name", strlen("mc_svc_name"),
+                                   "tcp", &result, buffer, 8);
+    assert_int_equal(ret, ERANGE);
+}
+
+static void test_mc_svc_by_port(void **state)
+{
+    struct test_mc_ctx *test_ctx = talloc_get_type_abort(*state,
+                                                         struct test_mc_ctx);
+    struct servent result;
+    char buffer[1024];
+    errno_t ret;
+
+    test_mc_svc_store(test_ctx, "mc_svc_port", "udp", 4712, "mc_port_alias");
+
+    /* the client readers take the port in network byte order */
+    ret = sss_nss_mc_getservbyport(htons(4712), "udp",
+                                   &result, buffer, sizeof(buffer));
+    assert_int_equal(ret, EOK);
+    test_mc_svc_check(&result, "mc_svc_port", "udp", 4712, "mc_port_alias");
+
+    ret = sss_nss_mc_getservbyport(htons(4712), NULL,
+                                   &result, buffer, sizeof(buffer));
+    assert_int_equal(ret, EOK);
+    test_mc_svc_check(&result, "mc_svc_port", "udp", 4712, "mc_port_alias");
+
+    ret = sss_nss_mc_getservbyport(htons(4712), "tcp",
+                                   &result, buffer, sizeof(buffer));
+    assert_int_equal(ret, ENOENT);
+
+    ret = sss_nss_mc_getservbyport(htons(4713), "udp",
+                                   &result, buffer, sizeof(buffer));
+    assert_int_equal(ret, ENOENT);
+}
+
+static void test_mc_svc_invalidate(void **state)
+{
+    struct test_mc_ctx *test_ctx = talloc_get_type_abort(*state,
+                                                         struct test_mc_ctx);
+    struct sized_string name;
+    struct servent result;
+    char buffer[1024];
+    errno_t ret;
+
+    test_mc_svc_store(test_ctx, "mc_svc_inv", "tcp", 4714, "mc_inv_alias");
+    test_mc_svc_store(test_ctx, "mc_svc_inv_port", "tcp", 4715,
+                      "mc_inv_port_alias");
+
+    to_sized_string(&name, "mc_svc_inv");
+    ret = sss_mmap_cache_svc_invalidate(test_ctx->svc_mc_ctx, &name);
+    assert_int_equal(ret, EOK);
+
+    ret = sss_nss_mc_getservbyname("mc_svc_inv", strlen("mc_svc_inv"),
+                                   "tcp", &result, buffer, sizeof(buffer));
+    assert_int_equal(ret, ENOENT);
+
+    ret = sss_nss_mc_getservbyport(htons(4714), "tcp",
+                                   &result, buffer, sizeof(buffer));
+    assert_int_equal(ret, ENOENT);
+
+    /* invalidating by port removes the record for both keys */
+    ret = sss_nss_mc_getservbyport(htons(4715), "tcp",
+                                   &result, buffer, sizeof(buffer));
+    assert_int_equal(ret, EOK);
+
+    ret = sss_mmap_cache_svc_invalidate_port(test_ctx->svc_mc_ctx, 4715);
+    assert_int_equal(ret, EOK);
+
+    ret = sss_nss_mc_getservbyport(htons(4715), "tcp",
+                                   &result, buffer, sizeof(buffer));
+    assert_int_equal(ret, ENOENT);
+
+    ret = sss_nss_mc_getservbyname("mc_svc_inv_port",
+                                   strlen("mc_svc_inv_port"),
+                                   "tcp", &result, buffer, sizeof(buffer));
+    assert_int_equal(ret, ENOENT);
+}
+
+#define TEST_SID_USER "S-1-5-21-3623811015-3361044348-30300820-1013"
+#define TEST_SID_GROUP "S-1-5-21-3623811015-3361044348-30300820-1014"
+#define TEST_SID_INV "S-1-5-21-3623811015-3361044348-30300820-1015"
+#define TEST_SID_PREF_USER "S-1-5-21-3623811015-3361044348-30300820-1016"
+
+static void test_mc_sid_store(struct test_mc_ctx *test_ctx,
+                              const char *sid, const char *name,
+                              enum sss_id_type type, uint32_t id)
+{
+    struct sized_string s_sid;
+    struct sized_string s_name;
+    errno_t ret;
+
+    to_sized_string(&s_sid, sid);
+    to_sized_string(&s_name, name);
+
+    ret = sss_mmap_cache_sid_store(&test_ctx->sid_mc_ctx, &s_sid, &s_name,
+                                   type, id);
+    assert_int_equal(ret, EOK);
+}
+
+static void test_mc_sid_lookups(void **state)
+{
+    struct test_mc_ctx *test_ctx = talloc_get_type_abort(*state,
+                                                         struct test_mc_ctx);
+    enum sss_id_type type;
+    char *str = NULL;
+    uint32_t id;
+    errno_t ret;
+
+    test_mc_sid_store(test_ctx, TEST_SID_USER, "mc_sid_user@test",
+                      SSS_ID_TYPE_UID, 10013);
+
+    ret = sss_nss_mc_getsidbyname("mc_sid_user@test",
+                                  strlen("mc_sid_user@test"), &str, &type);
+    assert_int_equal(ret, EOK);
+    assert_string_equal(str, TEST_SID_USER);
+    assert_int_equal(type, SSS_ID_TYPE_UID);
+    free(str);
+    str = NULL;
+
+    ret = sss_nss_mc_getnamebysid(TEST_SID_USER, strlen(TEST_SID_USER),
+                                  &str, &type);
+    assert_int_equal(ret, EOK);
+    assert_string_equal(str, "mc_sid_user@test");
+    assert_int_equal(type, SSS_ID_TYPE_UID);
+    free(str);
+    str = NULL;
+
+    ret = sss_nss_mc_getidbysid(TEST_SID_USER, strlen(TEST_SID_USER),
+                                &id, &type);
+    assert_int_equal(ret, EOK);
+    assert_int_equal(id, 10013);
+    assert_int_equal(type, SSS_ID_TYPE_UID);
+
+    ret = sss_nss_mc_getsidbyid(10013, SSS_ID_TYPE_UID, &str, &type);
+    assert_int_equal(ret, EOK);
+    assert_string_equal(str, TEST_SID_USER);
+    assert_int_equal(type, SSS_ID_TYPE_UID);
+    free(str);
+    str = NULL;
+
+    /* a user is not returned when a group ID is requested */
+    ret = sss_nss_mc_getsidbyid(10013, SSS_ID_TYPE_GID, &str, &type);
+    assert_int_equal(ret, ENOENT);
+
+    /* the SID is no name and the name is no SID */
+    ret = sss_nss_mc_getsidbyname(TEST_SID_USER, strlen(TEST_SID_USER),
+                                  &str, &type);
+    assert_int_equal(ret, ENOENT);
+
+    ret = sss_nss_mc_getnamebysid("mc_sid_user@test",
+                                  strlen("mc_sid_user@test"), &str, &type);
+    assert_int_equal(ret, ENOENT);
+}
+
+static void test_mc_sid_by_id_prefers_user(void **state)
+{
+    struct test_mc_ctx *test_ctx = talloc_get_type_abort(*state,
+                                                         struct test_mc_ctx);
+    enum sss_id_type type;
+    char *sid = NULL;
+    errno_t ret;
+
+    /* a group with the same ID as a user, stored after the user */
+    test_mc_sid_store(test_ctx, TEST_SID_PREF_USER, "mc_sid_pref@test",
+                      SSS_ID_TYPE_UID, 10014);
+    test_mc_sid_store(test_ctx, TEST_SID_GROUP, "mc_sid_group@test",
+                      SSS_ID_TYPE_GID, 10014);
+
+    ret = sss_nss_mc_getsidbyid(10014, SSS_ID_TYPE_NOT_SPECIFIED,
+                                &sid, &type);
+    assert_int_equal(ret, EOK);
+    assert_string_equal(sid, TEST_SID_PREF_USER);
+    assert_int_equal(type, SSS_ID_TYPE_UID);
+    free(sid);
+    sid = NULL;
+
+    ret = sss_nss_mc_getsidbyid(10014, SSS_ID_TYPE_GID, &sid, &type);
+    assert_int_equal(ret, EOK);
+    assert_string_equal(sid, TEST_SID_GROUP);
+    assert_int_equal(type, SSS_ID_TYPE_GID);
+    free(sid);
+}
+
+static void test_mc_sid_invalidate(void **state)
+{
+    struct test_mc_ctx *test_ctx = talloc_get_type_abort(*state,
+                                                         struct test_mc_ctx);
+    struct sized_string key;
+    enum sss_id_type type;
+    char *str = NULL;
+    uint32_t id;
+    errno_t ret;
+
+    test_mc_sid_store(test_ctx, TEST_SID_INV, "mc_sid_inv@test",
+                      SSS_ID_TYPE_BOTH, 10015);
+
+    ret = sss_nss_mc_getsidbyid(10015, SSS_ID_TYPE_GID, &str, &type);
+    assert_int_equal(ret, EOK);
+    assert_string_equal(str, TEST_SID_INV);
+    assert_int_equal(type, SSS_ID_TYPE_BOTH);
+    free(str);
+    str = NULL;
+
+    /* invalidating by name drops the SID-keyed record as well */
+    to_sized_string(&key, "mc_sid_inv@test");
+    ret = sss_mmap_cache_sid_invalidate(test_ctx->sid_mc_ctx, &key);
+    assert_int_equal(ret, EOK);
+
+    ret = sss_nss_mc_getsidbyname("mc_sid_inv@test",
+                                  strlen("mc_sid_inv@test"), &str, &type);
+    assert_int_equal(ret, ENOENT);
+
+    ret = sss_nss_mc_getidbysid(TEST_SID_INV, strlen(TEST_SID_INV),
+                                &id, &type);
+    assert_int_equal(ret, ENOENT);
+
+    ret = sss_nss_mc_getsidbyid(10015, SSS_ID_TYPE_NOT_SPECIFIED,
+                                &str, &type);
+    assert_int_equal(ret, ENOENT);
+
+    /* invalidating by ID drops the name-keyed record as well */
+    test_mc_sid_store(test_ctx, TEST_SID_INV, "mc_sid_inv@test",
+                      SSS_ID_TYPE_BOTH, 10015);
+
+    ret = sss_mmap_cache_sid_invalidate_id(test_ctx->sid_mc_ctx, 10015);
+    assert_int_equal(ret, EOK);
+
+    ret = sss_nss_mc_getnamebysid(TEST_SID_INV, strlen(TEST_SID_INV),
+                                  &str, &type);
+    assert_int_equal(ret, ENOENT);
+
+    ret = sss_nss_mc_getsidbyname("mc_sid_inv@test",
+                                  strlen("mc_sid_inv@test"), &str, &type);
+    assert_int_equal(ret, ENOENT);
+}
+
+int main(int argc, const char *argv[])
+{
+    poptContext pc;
+    int opt;
+    struct poptOption long_options[] = {
+        POPT_AUTOHELP
+        SSSD_DEBUG_OPTS
+        POPT_TABLEEND
+    };
+
+    const struct CMUnitTest tests[] = {
+        cmocka_unit_test(test_mc_svc_by_name),
+        cmocka_unit_test(test_mc_svc_by_port),
+        cmocka_unit_test(test_mc_svc_invalidate),
+        cmocka_unit_test(test_mc_sid_lookups),
+        cmocka_unit_test(test_mc_sid_by_id_prefers_user),
+        cmocka_unit_test(test_mc_sid_invalidate),
+    };
+
+    /* Set debug level to invalid value so we can decide if -d 0 was used. */
+    debug_level = SSSDBG_INVALID;
+
+    pc = poptGetContext(argv[0], argc, argv, long_options, 0);
+    while ((opt = poptGetNextOpt(pc)) != -1) {
+        switch (opt) {
+        default:
+            fprintf(stderr, "\nInvalid option %s: %s\n\n",
+                    poptBadOption(pc, 0), poptStrerror(opt));
+            poptPrintUsage(pc, stderr, 0);
+            return 1;
+        }
+    }
+    poptFreeContext(pc);
+
+    DEBUG_CLI_INIT(debug_level);
+
+    tests_set_cwd();
+
+    /* Make sure the client readers are not disabled by the environment */
+    unsetenv("SSS_NSS_USE_MEMCACHE");
+
+    return cmocka_run_group_tests(tests, test_mc_group_setup,
+                                  test_mc_group_teardown);
+}
@@ -3710,6 +3710,96 @@ void test_nss_getnamebysid_neg(void **state)
     assert_int_equal(nss_test_ctx->ncache_hits, 1);
 }
 
+static int test_nss_getnamebysid_list_check(uint32_t status,
+                                            uint8_t *body, size_t blen)
+{
+    size_t rp = 0;
+    uint32_t num_keys;
+    uint32_t key_status;
+    uint32_t key_len;
+    uint32_t id_type;
+    const char *name;
+
+    assert_int_equal(status, EOK);
+
+    SAFEALIGN_COPY_UINT32(&num_keys, body+rp, &rp);
+    assert_int_equal(num_keys, 2);
+    rp += sizeof(uint32_t); /* reserved */
+
+    /* The valid SID is resolved ... */
+    SAFEALIGN_COPY_UINT32(&key_status, body+rp, &rp);
+    assert_int_equal(key_status, EOK);
+    SAFEALIGN_COPY_UINT32(&key_len, body+rp, &rp);
+    assert_true(key_len > 3 * sizeof(uint32_t));
+
+    rp += 2 * sizeof(uint32_t); /* num_results and reserved */
+    SAFEALIGN_COPY_UINT32(&id_type, body+rp, &rp);
+    assert_int_equal(id_type, SSS_ID_TYPE_UID);
+    name = (const char *) body + rp;
+    assert_string_equal(name, testbysid.pw_name);
+    rp += key_len - 3 * sizeof(uint32_t);
+
+    /* ... while the malformed one only fails its own key */
+    SAFEALIGN_COPY_UINT32(&key_status, body+rp, &rp);
+    assert_int_equal(key_status, EINVAL);
+    SAFEALIGN_COPY_UINT32(&key_len, body+rp, &rp);
+    assert_int_equal(key_len, 0);
+
+    assert_int_equal(rp, blen);
+
+    return EOK;
+}
+
+static void test_nss_getnamebysid_list_invalid_key(void **state)
+{
+    errno_t ret;
+    struct sysdb_attrs *attrs;
+    char *user_sid;
+    const char *bad_sid = "S-1-5-not-a-sid";
+    uint8_t *data;
+    size_t data_len;
+    size_t rp = 0;
+    uint32_t num_keys = 2;
+
+    attrs = sysdb_new_attrs(nss_test_ctx);
+    assert_non_null(attrs);
+
+    user_sid = talloc_asprintf(attrs, "%s-500",
+                               nss_test_ctx->tctx->dom->domain_id);
+    assert_non_null(user_sid);
+
+    ret = sysdb_attrs_add_string(attrs, SYSDB_SID_STR, user_sid);
+    assert_int_equal(ret, EOK);
+
+    ret = store_user(nss_test_ctx, nss_test_ctx->tctx->dom,
+                     &testbysid, attrs, 0);
+    assert_int_equal(ret, EOK);
+
+    data_len = sizeof(uint32_t) + strlen(user_sid) + 1 + strlen(bad_sid) + 1;
+    data = talloc_size(nss_test_ctx, data_len);
+    assert_non_null(data);
+    SAFEALIGN_COPY_UINT32(data, &num_keys, &rp);
+    safealign_memcpy(data + rp, user_sid, strlen(user_sid) + 1, &rp);
+    safealign_memcpy(data + rp, bad_sid, strlen(bad_sid) + 1, &rp);
+
+    will_return(__wrap_sss_packet_get_body, WRAP_CALL_WRAPPER);
+    will_return(__wrap_sss_packet_get_body, data);
+    will_return(__wrap_sss_packet_get_body, data_len);
+    will_return(__wrap_sss_packet_get_cmd, SSS_NSS_GETNAMEBYSID_LIST);
+    /* The entry of the valid key, then the reply which reads the entry
+     * once and its own body once per key and once at the end */
+    will_return_count(__wrap_sss_packet_get_body, WRAP_CALL_REAL, 5);
+
+    set_cmd_cb(test_nss_getnamebysid_list_check);
+    ret = sss_cmd_execute(nss_test_ctx->cctx, SSS_NSS_GETNAMEBYSID_LIST,
+                          nss_test_ctx->nss_cmds);
+    assert_int_equal(ret, EOK);
+
+    /* Wait until the test finishes with EOK */
+    ret = test_ev_loop(nss_test_ctx->tctx);
+    assert_int_equal(ret, EOK);
+}
+
 struct passwd testbysid_update = {
     .pw_name = discard_const("testsidbyname_update"),
     .pw_uid = 123456,
@@ -5655,6 +5745,8 @@ int main(int argc, const char *argv[])
                                         nss_test_setup, nss_test_teardown),
         cmocka_unit_test_setup_teardown(test_nss_getnamebysid_neg,
                                         nss_test_setup, nss_test_teardown),
+        cmocka_unit_test_setup_teardown(test_nss_getnamebysid_list_invalid_key,
+                                        nss_test_setup, nss_test_teardown),
         cmocka_unit_test_setup_teardown(test_nss_getnamebysid_update,
                                         nss_test_setup, nss_test_teardown),
         cmocka_unit_test_setup_teardown(test_nss_getnamebycert_neg,
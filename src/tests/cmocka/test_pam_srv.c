@@ -1746,6 +1746,47 @@ void test_pam_offline_auth_success(void **state)
     assert_int_equal(ret, EOK);
 }
 
+void test_pam_token_cache(void **state)
+{
+    struct pam_token_cache *cache;
+    struct sss_domain_info *dom = pam_test_ctx->tctx->dom;
+    time_t expire_date = -1;
+    errno_t ret;
+
+    ret = pam_token_cache_init(pam_test_ctx, 2, 60, &cache);
+    assert_int_equal(ret, EOK);
+
+    assert_false(pam_token_cache_check(cache, dom, "user1", "12345",
+                                       &expire_date));
+
+    pam_token_cache_add(cache, dom, "user1", "12345", 42);
+    assert_true(pam_token_cache_check(cache, dom, "user1", "12345",
+                                      &expire_date));
+    assert_int_equal(expire_date, 42);
+
+    /* Only the same password of the same user is accepted. */
+    assert_false(pam_token_cache_check(cache, dom, "user1", "11111",
+                                       &expire_date));
+    assert_false(pam_token_cache_check(cache, dom, "user2", "12345",
+                                       &expire_date));
+
+    /* The oldest entry is dropped when the cache is full. */
+    pam_token_cache_add(cache, dom, "user2", "12345", 0);
+    pam_token_cache_add(cache, dom, "user3", "12345", 0);
+    assert_false(pam_token_cache_check(cache, dom, "user1", "12345",
+                                       &expire_date));
+    assert_true(pam_token_cache_check(cache, dom, "user2", "12345",
+                                      &expire_date));
+
+    pam_token_cache_remove(cache, dom, "user2");
+    assert_false(pam_token_cache_check(cache, dom, "user2", "12345",
+                                       &expire_date));
+    assert_true(pam_token_cache_check(cache, dom, "user3", "12345",
+                                      &expire_date));
+
+    talloc_free(cache);
+}
+
 void test_pam_offline_auth_wrong_pw(void **state)
 {
     int ret;
@@ -3387,6 +3428,8 @@ int main(int argc, const char *argv[])
                                         pam_test_setup, pam_test_teardown),
         cmocka_unit_test_setup_teardown(test_pam_offline_auth_success,
                                         pam_test_setup, pam_test_teardown),
+        cmocka_unit_test_setup_teardown(test_pam_token_cache,
+                                        pam_test_setup, pam_test_teardown),
         cmocka_unit_test_setup_teardown(test_pam_offline_auth_wrong_pw,
                                         pam_test_setup, pam_test_teardown),
         cmocka_unit_test_setup_teardown(test_pam_offline_auth_success_2fa,
@@ -334,6 +334,150 @@ void test_resolv_fake_srv(void **state)
     assert_int_equal(ret, ERR_OK);
 }
 
+static void test_resolv_fake_srv_cached_done(struct tevent_req *req)
+{
+    errno_t ret;
+    int status;
+    uint32_t ttl;
+    struct ares_srv_reply *srv_replies = NULL;
+    struct resolv_fake_ctx *test_ctx =
+        tevent_req_callback_data(req, struct resolv_fake_ctx);
+
+    ret = resolv_getsrv_recv(test_ctx, req, &status, NULL,
+                             &srv_replies, &ttl);
+    talloc_zfree(req);
+    assert_int_equal(ret, EOK);
+    assert_int_equal(status, ARES_SUCCESS);
+
+    /* the cached answer reports the remaining TTL */
+    assert_non_null(srv_replies);
+    assert_string_equal(srv_replies->host, "ldap.sssd.com");
+    assert_non_null(srv_replies->next);
+    assert_string_equal(srv_replies->next->host, "ldap2.sssd.com");
+    assert_null(srv_replies->next->next);
+    assert_true(ttl > 0 && ttl <= 500);
+
+    talloc_free(srv_replies);
+    test_ev_done(test_ctx->ctx, EOK);
+}
+
+void test_resolv_fake_srv_cached(void **state)
+{
+    int ret;
+    struct tevent_req *req;
+    struct resolv_fake_ctx *test_ctx =
+        talloc_get_type(*state, struct resolv_fake_ctx);
+    uint64_t hits;
+    uint64_t misses;
+    unsigned char *buf;
+    size_t buflen;
+    struct srv_rrdata rr[2];
+
+    rr[0].prio = 1;
+    rr[0].port = 389;
+    rr[0].weight = 40;
+    rr[0].ttl = 600;
+    rr[0].hostname = "ldap.sssd.com";
+
+    rr[1].prio = 1;
+    rr[1].port = 389;
+    rr[1].weight = 60;
+    rr[1].ttl = 500;
+    rr[1].hostname = "ldap2.sssd.com";
+
+    resolv_set_cache_options(test_ctx->resolv, true, 0);
+
+    buf = create_srv_buffer(test_ctx, TEST_SRV_QUERY, rr, 2, &buflen);
+    assert_non_null(buf);
+    mock_ares_query(0, 0, buf, buflen);
+
+    req = resolv_getsrv_send(test_ctx, test_ctx->ctx->ev,
+                             test_ctx->resolv, TEST_SRV_QUERY);
+    assert_non_null(req);
+    tevent_req_set_callback(req, test_resolv_fake_srv_cached_done, test_ctx);
+
+    ret = test_ev_loop(test_ctx->ctx);
+    assert_int_equal(ret, ERR_OK);
+
+    /* No query is mocked, the answer must come from the cache */
+    test_ctx->ctx->done = false;
+    req = resolv_getsrv_send(test_ctx, test_ctx->ctx->ev,
+                             test_ctx->resolv, TEST_SRV_QUERY);
+    assert_non_null(req);
+    tevent_req_set_callback(req, test_resolv_fake_srv_cached_done, test_ctx);
+
+    ret = test_ev_loop(test_ctx->ctx);
+    assert_int_equal(ret, ERR_OK);
+
+    resolv_get_cache_stats(test_ctx->resolv, &hits, &misses);
+    assert_int_equal(hits, 1);
+    assert_int_equal(misses, 1);
+
+    /* Flushing the cache sends the next query to the server again */
+    resolv_cache_flush(test_ctx->resolv);
+    mock_ares_query(0, 0, buf, buflen);
+
+    test_ctx->ctx->done = false;
+    req = resolv_getsrv_send(test_ctx, test_ctx->ctx->ev,
+                             test_ctx->resolv, TEST_SRV_QUERY);
+    assert_non_null(req);
+    tevent_req_set_callback(req, test_resolv_fake_srv_cached_done, test_ctx);
+
+    ret = test_ev_loop(test_ctx->ctx);
+    assert_int_equal(ret, ERR_OK);
+
+    resolv_get_cache_stats(test_ctx->resolv, &hits, &misses);
+    assert_int_equal(hits, 1);
+    assert_int_equal(misses, 2);
+}
+
+static void test_resolv_fake_srv_negative_done(struct tevent_req *req)
+{
+    errno_t ret;
+    int status;
+    struct resolv_fake_ctx *test_ctx =
+        tevent_req_callback_data(req, struct resolv_fake_ctx);
+
+    ret = resolv_getsrv_recv(test_ctx, req, &status, NULL, NULL, NULL);
+    talloc_zfree(req);
+    assert_int_equal(ret, EIO);
+    assert_int_equal(status, ARES_ENOTFOUND);
+
+    test_ev_done(test_ctx->ctx, EOK);
+}
+
+void test_resolv_fake_srv_negative(void **state)
+{
+    int ret;
+    int i;
+    struct tevent_req *req;
+    struct resolv_fake_ctx *test_ctx =
+        talloc_get_type(*state, struct resolv_fake_ctx);
+    uint64_t hits;
+    uint64_t misses;
+
+    resolv_set_cache_options(test_ctx->resolv, true, 30);
+
+    /* Only the first query reaches the server */
+    mock_ares_query(ARES_ENOTFOUND, 0, NULL, 0);
+
+    for (i = 0; i < 2; i++) {
+        test_ctx->ctx->done = false;
+        req = resolv_getsrv_send(test_ctx, test_ctx->ctx->ev,
+                                 test_ctx->resolv, TEST_SRV_QUERY);
+        assert_non_null(req);
+        tevent_req_set_callback(req, test_resolv_fake_srv_negative_done,
+                                test_ctx);
+
+        ret = test_ev_loop(test_ctx->ctx);
+        assert_int_equal(ret, ERR_OK);
+    }
+
+    resolv_get_cache_stats(test_ctx->resolv, &hits, &misses);
+    assert_int_equal(hits, 1);
+    assert_int_equal(misses, 1);
+}
+
 void test_resolv_is_address(void **state)
 {
     bool ret;
@@ -372,6 +516,12 @@ int main(int argc, const char *argv[])
         cmocka_unit_test_setup_teardown(test_resolv_fake_srv,
                                         test_resolv_fake_setup,
                                         test_resolv_fake_teardown),
+        cmocka_unit_test_setup_teardown(test_resolv_fake_srv_cached,
+                                        test_resolv_fake_setup,
+                                        test_resolv_fake_teardown),
+        cmocka_unit_test_setup_teardown(test_resolv_fake_srv_negative,
+                                        test_resolv_fake_setup,
+                                        test_resolv_fake_teardown),
         cmocka_unit_test(test_resolv_is_address),
     };
 
@@ -865,6 +865,138 @@ void test_user_by_name_cache_expired(void **state)
     check_user(test_ctx, &users[0], test_ctx->tctx->dom);
 }
 
+struct coalesce_test_req {
+    struct cache_req_test_ctx *test_ctx;
+    struct cache_req_result *result;
+    errno_t error;
+    int *pending;
+};
+
+static void cache_req_user_by_name_coalesce_done(struct tevent_req *req)
+{
+    struct coalesce_test_req *creq = NULL;
+
+    creq = tevent_req_callback_data(req, struct coalesce_test_req);
+
+    creq->error = cache_req_user_by_name_recv(creq->test_ctx, req,
+                                              &creq->result);
+    talloc_zfree(req);
+
+    (*creq->pending)--;
+    if (*creq->pending == 0) {
+        creq->test_ctx->tctx->done = true;
+    }
+}
+
+void test_user_by_name_cache_expired_coalesced(void **state)
+{
+    struct cache_req_test_ctx *test_ctx = NULL;
+    struct coalesce_test_req creqs[3];
+    TALLOC_CTX *req_mem_ctx;
+    struct tevent_req *req;
+    int pending;
+    errno_t ret;
+    int i;
+
+    test_ctx = talloc_get_type_abort(*state, struct cache_req_test_ctx);
+
+    ret = sss_hash_create(test_ctx->rctx, 10,
+                          &test_ctx->rctx->cache_req_inflight);
+    assert_int_equal(ret, EOK);
+
+    /* Setup user. */
+    prepare_user(test_ctx->tctx->dom, &users[0], -1000, time(NULL));
+
+    /* Mock values. */
+    /* DP should be contacted only once */
+    will_return(__wrap_sss_dp_get_account_send, test_ctx);
+    mock_account_recv_simple();
+
+    /* Test. */
+    req_mem_ctx = talloc_new(global_talloc_context);
+    check_leaks_push(req_mem_ctx);
+
+    pending = 3;
+    for (i = 0; i < 3; i++) {
+        creqs[i].test_ctx = test_ctx;
+        creqs[i].result = NULL;
+        creqs[i].error = ERR_INTERNAL;
+        creqs[i].pending = &pending;
+
+        req = cache_req_user_by_name_send(req_mem_ctx, test_ctx->tctx->ev,
+                                          test_ctx->rctx, test_ctx->ncache, 0,
+                                          CACHE_REQ_POSIX_DOM,
+                                          test_ctx->tctx->dom->name,
+                                          users[0].short_name);
+        assert_non_null(req);
+        tevent_req_set_callback(req, cache_req_user_by_name_coalesce_done,
+                                &creqs[i]);
+    }
+
+    ret = test_ev_loop(test_ctx->tctx);
+    assert_int_equal(ret, EOK);
+    assert_true(check_leaks_pop(req_mem_ctx));
+    talloc_free(req_mem_ctx);
+
+    assert_true(test_ctx->dp_called);
+    assert_int_equal(test_ctx->rctx->cache_req_coalesced, 2);
+
+    for (i = 0; i < 3; i++) {
+        assert_int_equal(creqs[i].error, EOK);
+
+        test_ctx->result = creqs[i].result;
+        check_user(test_ctx, &users[0], test_ctx->tctx->dom);
+        talloc_zfree(test_ctx->result);
+    }
+
+    talloc_zfree(test_ctx->rctx->cache_req_inflight);
+}
+
+void test_user_by_name_result_cache(void **state)
+{
+    struct cache_req_test_ctx *test_ctx = NULL;
+    char *fqname;
+    errno_t ret;
+
+    test_ctx = talloc_get_type_abort(*state, struct cache_req_test_ctx);
+
+    ret = cache_req_lru_init(test_ctx->rctx, 10, 60,
+                             &test_ctx->rctx->cache_req_lru);
+    assert_int_equal(ret, EOK);
+
+    /* Setup user. */
+    prepare_user(test_ctx->tctx->dom, &users[0], 1000, time(NULL));
+
+    /* Test. */
+    run_user_by_name(test_ctx, test_ctx->tctx->dom, 0, ERR_OK);
+    check_user(test_ctx, &users[0], test_ctx->tctx->dom);
+    talloc_zfree(test_ctx->result);
+
+    /* The second lookup must not touch sysdb. */
+    fqname = sss_create_internal_fqname(test_ctx, users[0].short_name,
+                                        test_ctx->tctx->dom->name);
+    assert_non_null(fqname);
+    ret = sysdb_delete_user(test_ctx->tctx->dom, fqname, 0);
+    talloc_free(fqname);
+    assert_int_equal(ret, EOK);
+
+    run_user_by_name(test_ctx, test_ctx->tctx->dom, 0, ERR_OK);
+    assert_false(test_ctx->dp_called);
+    check_user(test_ctx, &users[0], test_ctx->tctx->dom);
+    talloc_zfree(test_ctx->result);
+
+    /* After invalidation the user is looked up again. */
+    cache_req_lru_flush(test_ctx->rctx->cache_req_lru);
+
+    will_return(__wrap_sss_dp_get_account_send, test_ctx);
+    mock_account_recv_simple();
+
+    run_user_by_name(test_ctx, test_ctx->tctx->dom, 0, ENOENT);
+    assert_true(test_ctx->dp_called);
+
+    talloc_zfree(test_ctx->rctx->cache_req_lru);
+}
+
 void test_user_by_name_cache_midpoint(void **state)
 {
     struct cache_req_test_ctx *test_ctx = NULL;
@@ -3953,6 +4085,8 @@ int main(int argc, const char *argv[])
     const struct CMUnitTest tests[] = {
         new_single_domain_test(user_by_name_cache_valid),
         new_single_domain_test(user_by_name_cache_expired),
+        new_single_domain_test(user_by_name_cache_expired_coalesced),
+        new_single_domain_test(user_by_name_result_cache),
         new_single_domain_test(user_by_name_cache_midpoint),
         new_single_domain_test(user_by_name_ncache),
         new_single_domain_test(user_by_name_missing_found),
@@ -24,9 +24,11 @@
 #include <tevent.h>
 #include <errno.h>
 #include <popt.h>
+#include <sys/socket.h>
 
 #include "tests/cmocka/common_mock.h"
 #include "tests/cmocka/common_mock_resp.h"
+#include "responder/common/responder_packet.h"
 
 #define TESTS_PATH "tp_" BASE_FILE_STEM
 #define TEST_CONF_DB "test_responder_conf.ldb"
@@ -290,6 +292,203 @@ void test_sss_output_fqname(void **state)
     talloc_zfree(res);
 }
 
+void test_sss_packet_pool(void **state)
+{
+    struct sss_packet_pool *pool;
+    struct sss_packet *packet;
+    uint8_t *body;
+    uint8_t *reused;
+    size_t blen;
+    size_t i;
+    errno_t ret;
+
+    ret = sss_packet_pool_new(NULL, &pool);
+    assert_int_equal(ret, EOK);
+
+    ret = sss_packet_new_pooled(pool, pool, 0, SSS_NSS_GETGRNAM, &packet);
+    assert_int_equal(ret, EOK);
+    sss_packet_get_body(packet, &body, &blen);
+    talloc_free(packet);
+
+    /* the buffer of the freed packet is used again */
+    ret = sss_packet_new_pooled(pool, pool, 0, SSS_NSS_GETGRNAM, &packet);
+    assert_int_equal(ret, EOK);
+    sss_packet_get_body(packet, &reused, &blen);
+    assert_ptr_equal(body, reused);
+    assert_int_equal(blen, 0);
+
+    /* growing past the size class keeps the data */
+    ret = sss_packet_grow(packet, 100);
+    assert_int_equal(ret, EOK);
+    sss_packet_get_body(packet, &body, &blen);
+    for (i = 0; i < blen; i++) {
+        body[i] = i;
+    }
+
+    ret = sss_packet_reserve(packet, 5000);
+    assert_int_equal(ret, EOK);
+    ret = sss_packet_grow(packet, 5000);
+    assert_int_equal(ret, EOK);
+    sss_packet_get_body(packet, &body, &blen);
+    assert_int_equal(blen, 5100);
+    for (i = 0; i < 100; i++) {
+        assert_int_equal(body[i], i);
+    }
+    assert_int_equal(sss_packet_get_cmd(packet), SSS_NSS_GETGRNAM);
+
+    /* the packet may outlive the pool */
+    talloc_steal(NULL, packet);
+    talloc_free(pool);
+    talloc_free(packet);
+}
+
+void test_sss_packet_tail(void **state)
+{
+    struct sss_packet_pool *pool;
+    struct sss_packet *packet;
+    uint8_t reply[SSS_NSS_HEADER_SIZE + 8];
+    uint32_t len;
+    uint8_t *tail;
+    uint8_t *body;
+    size_t blen;
+    int sv[2];
+    errno_t ret;
+
+    ret = sss_packet_pool_new(NULL, &pool);
+    assert_int_equal(ret, EOK);
+
+    /* packets without a pool do not take a tail */
+    ret = sss_packet_new(pool, 0, SSS_NSS_GETGRNAM, &packet);
+    assert_int_equal(ret, EOK);
+    tail = (uint8_t *)talloc_strdup(pool, "efgh");
+    assert_non_null(tail);
+    ret = sss_packet_set_tail(packet, tail, 4);
+    assert_int_equal(ret, ENOTSUP);
+    talloc_free(packet);
+
+    ret = sss_packet_new_pooled(pool, pool, 0, SSS_NSS_GETGRNAM, &packet);
+    assert_int_equal(ret, EOK);
+    ret = sss_packet_grow(packet, 4);
+    assert_int_equal(ret, EOK);
+    sss_packet_get_body(packet, &body, &blen);
+    memcpy(body, "abcd", 4);
+
+    ret = sss_packet_set_tail(packet, tail, 4);
+    assert_int_equal(ret, EOK);
+    assert_ptr_equal(talloc_parent(tail), packet);
+
+    /* the tail is not part of the body and nothing can follow it */
+    sss_packet_get_body(packet, &body, &blen);
+    assert_int_equal(blen, 4);
+    ret = sss_packet_grow(packet, 4);
+    assert_int_equal(ret, EINVAL);
+
+    ret = socketpair(AF_UNIX, SOCK_STREAM, 0, sv);
+    assert_int_equal(ret, 0);
+
+    ret = sss_packet_send(packet, sv[0]);
+    assert_int_equal(ret, EOK);
+    assert_int_equal(sss_atomic_read_s(sv[1], reply, sizeof(reply)),
+                     sizeof(reply));
+
+    SAFEALIGN_COPY_UINT32(&len, reply, NULL);
+    assert_int_equal(len, sizeof(reply));
+    assert_memory_equal(reply + SSS_NSS_HEADER_SIZE, "abcdefgh", 8);
+
+    close(sv[0]);
+    close(sv[1]);
+    talloc_free(pool);
+}
+
+#define TEST_PARTIAL_BODY_LEN 6000
+#define TEST_PARTIAL_TAIL_LEN 60000
+#define TEST_PARTIAL_REPLY_LEN \
+    (SSS_NSS_HEADER_SIZE + TEST_PARTIAL_BODY_LEN + TEST_PARTIAL_TAIL_LEN)
+
+/* A reply larger than the socket buffer is sent by several writev() calls
+ * which stop anywhere in the buffer or in the tail. */
+void test_sss_packet_send_partial(void **state)
+{
+    struct sss_packet_pool *pool;
+    struct sss_packet *packet;
+    uint8_t *reply;
+    uint8_t *tail;
+    uint8_t *body;
+    size_t blen;
+    size_t received;
+    uint32_t len;
+    ssize_t rb;
+    int partial;
+    int sndbuf;
+    int sv[2];
+    size_t i;
+    errno_t ret;
+
+    ret = sss_packet_pool_new(NULL, &pool);
+    assert_int_equal(ret, EOK);
+
+    ret = sss_packet_new_pooled(pool, pool, 0, SSS_NSS_GETGRNAM, &packet);
+    assert_int_equal(ret, EOK);
+    ret = sss_packet_grow(packet, TEST_PARTIAL_BODY_LEN);
+    assert_int_equal(ret, EOK);
+    sss_packet_get_body(packet, &body, &blen);
+    for (i = 0; i < blen; i++) {
+        body[i] = i % 251;
+    }
+
+    tail = talloc_size(pool, TEST_PARTIAL_TAIL_LEN);
+    assert_non_null(tail);
+    for (i = 0; i < TEST_PARTIAL_TAIL_LEN; i++) {
+        tail[i] = i % 241;
+    }
+    ret = sss_packet_set_tail(packet, tail, TEST_PARTIAL_TAIL_LEN);
+    assert_int_equal(ret, EOK);
+
+    ret = socketpair(AF_UNIX, SOCK_STREAM, 0, sv);
+    assert_int_equal(ret, 0);
+
+    /* the kernel rounds the size up to its minimum */
+    sndbuf = 1024;
+    ret = setsockopt(sv[0], SOL_SOCKET, SO_SNDBUF, &sndbuf, sizeof(sndbuf));
+    assert_int_equal(ret, 0);
+    ret = sss_fd_nonblocking(sv[0]);
+    assert_int_equal(ret, EOK);
+
+    reply = talloc_size(pool, TEST_PARTIAL_REPLY_LEN);
+    assert_non_null(reply);
+
+    /* Read in small chunks so that every write is a partial one. Data is
+     * always pending while the packet is not sent completely. */
+    received = 0;
+    partial = 0;
+    while ((ret = sss_packet_send(packet, sv[0])) == EAGAIN) {
+        partial++;
+        assert_true(partial < TEST_PARTIAL_REPLY_LEN);
+
+        rb = read(sv[1], reply + received,
+                  MIN(512, TEST_PARTIAL_REPLY_LEN - received));
+        assert_true(rb > 0);
+        received += rb;
+    }
+    assert_int_equal(ret, EOK);
+    assert_true(partial > 1);
+
+    rb = sss_atomic_read_s(sv[1], reply + received,
+                           TEST_PARTIAL_REPLY_LEN - received);
+    assert_int_equal(rb, TEST_PARTIAL_REPLY_LEN - received);
+
+    SAFEALIGN_COPY_UINT32(&len, reply, NULL);
+    assert_int_equal(len, TEST_PARTIAL_REPLY_LEN);
+    assert_memory_equal(reply + SSS_NSS_HEADER_SIZE, body,
+                        TEST_PARTIAL_BODY_LEN);
+    assert_memory_equal(reply + SSS_NSS_HEADER_SIZE + TEST_PARTIAL_BODY_LEN,
+                        tail, TEST_PARTIAL_TAIL_LEN);
+
+    close(sv[0]);
+    close(sv[1]);
+    talloc_free(pool);
+}
+
 int main(int argc, const char *argv[])
 {
     int rv;
@@ -325,6 +524,9 @@ int main(int argc, const char *argv[])
         cmocka_unit_test_setup_teardown(test_sss_output_fqname,
                                         parse_inp_test_setup,
                                         parse_inp_test_teardown),
+        cmocka_unit_test(test_sss_packet_pool),
+        cmocka_unit_test(test_sss_packet_tail),
+        cmocka_unit_test(test_sss_packet_send_partial),
     };
 
     /* Set debug level to invalid value so we can decide if -d 0 was used. */
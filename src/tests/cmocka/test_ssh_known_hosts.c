@@ -0,0 +1,394 @@
+/*
+    SSSD
+
+    SSH responder known_hosts tests
+
+    Copyright (C) 2026 Red Hat
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <cmocka.h>
+#include <popt.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+
+#include "tests/cmocka/common_mock.h"
+
+#define TESTS_PATH "tp_" BASE_FILE_STEM
+#define TEST_CONF_DB "test_ssh_known_hosts_conf.ldb"
+#define TEST_DOM_NAME "ssh_known_hosts_test"
+
+#define SSS_SSH_KNOWN_HOSTS_PATH TESTS_PATH"/known_hosts"
+#define SSS_SSH_KNOWN_HOSTS_TEMP_TMPL TESTS_PATH"/.known_hosts.XXXXXX"
+
+/* Including private file makes it easier to test with static functions */
+#include "responder/ssh/ssh_known_hosts.c"
+
+#define TEST_KNOWN_HOSTS_TIMEOUT 100
+
+#define TEST_HOST1 "host1.ssh.test"
+#define TEST_HOST2 "host2.ssh.test"
+#define TEST_KEY1 "ssh-ed25519 AAAAC3NzaC1lZDI1NTE5AAAAIKey1"
+#define TEST_KEY1B "ssh-ed25519 AAAAC3NzaC1lZDI1NTE5AAAAIKey1b"
+#define TEST_KEY2 "ssh-ed25519 AAAAC3NzaC1lZDI1NTE5AAAAIKey2"
+
+#define TEST_LINE1 TEST_HOST1" "TEST_KEY1"\n"
+#define TEST_LINE1B TEST_HOST1" "TEST_KEY1B"\n"
+#define TEST_LINE2 TEST_HOST2" "TEST_KEY2"\n"
+
+struct ssh_known_hosts_test_ctx {
+    struct sss_test_ctx *tctx;
+    struct ssh_ctx *ssh_ctx;
+};
+
+static void store_host(struct sss_domain_info *domain,
+                       const char *name,
+                       const char *key)
+{
+    struct sysdb_attrs *attrs;
+    char *value;
+    errno_t ret;
+
+    attrs = sysdb_new_attrs(NULL);
+    assert_non_null(attrs);
+
+    value = sss_base64_encode(attrs, (const uint8_t *)key, strlen(key));
+    assert_non_null(value);
+
+    ret = sysdb_attrs_add_string(attrs, SYSDB_SSH_PUBKEY, value);
+    assert_int_equal(ret, EOK);
+
+    ret = sysdb_store_ssh_host(domain, name, NULL, 0, time(NULL), attrs);
+    assert_int_equal(ret, EOK);
+
+    talloc_free(attrs);
+}
+
+static char *read_known_hosts(TALLOC_CTX *mem_ctx)
+{
+    char buf[4096];
+    ssize_t len;
+    int fd;
+
+    fd = open(SSS_SSH_KNOWN_HOSTS_PATH, O_RDONLY);
+    assert_int_not_equal(fd, -1);
+
+    len = sss_atomic_read_s(fd, buf, sizeof(buf) - 1);
+    close(fd);
+    assert_true(len >= 0);
+    buf[len] = '\0';
+
+    return talloc_strdup(mem_ctx, buf);
+}
+
+static void assert_known_hosts(struct ssh_known_hosts_test_ctx *test_ctx,
+                               const char *expected)
+{
+    char *content;
+
+    content = read_known_hosts(test_ctx);
+    assert_non_null(content);
+    assert_string_equal(content, expected);
+    talloc_free(content);
+}
+
+static ino_t known_hosts_ino(void)
+{
+    struct stat st;
+    int ret;
+
+    ret = stat(SSS_SSH_KNOWN_HOSTS_PATH, &st);
+    assert_int_equal(ret, 0);
+
+    return st.st_ino;
+}
+
+static void lookup_host(struct ssh_known_hosts_test_ctx *test_ctx,
+                        const char *name)
+{
+    errno_t ret;
+
+    ret = ssh_update_known_hosts_file(test_ctx->ssh_ctx,
+                                      test_ctx->tctx->dom, name);
+    assert_int_equal(ret, EOK);
+}
+
+static void prune(struct ssh_known_hosts_test_ctx *test_ctx)
+{
+    struct ssh_known_hosts *kh = test_ctx->ssh_ctx->known_hosts;
+
+    talloc_zfree(kh->prune_timer);
+    ssh_known_hosts_prune(test_ctx->tctx->ev, NULL,
+                          tevent_timeval_current(), kh);
+}
+
+static int ssh_known_hosts_test_setup(void **state)
+{
+    struct ssh_known_hosts_test_ctx *test_ctx;
+    struct resp_ctx *rctx;
+
+    assert_true(leak_check_setup());
+
+    test_ctx = talloc_zero(global_talloc_context,
+                           struct ssh_known_hosts_test_ctx);
+    assert_non_null(test_ctx);
+
+    test_dom_suite_setup(TESTS_PATH);
+
+    test_ctx->tctx = create_dom_test_ctx(test_ctx, TESTS_PATH, TEST_CONF_DB,
+                                         TEST_DOM_NAME, "ldap", NULL);
+    assert_non_null(test_ctx->tctx);
+
+    rctx = talloc_zero(test_ctx, struct resp_ctx);
+    assert_non_null(rctx);
+    rctx->ev = test_ctx->tctx->ev;
+    rctx->domains = test_ctx->tctx->dom;
+
+    test_ctx->ssh_ctx = talloc_zero(test_ctx, struct ssh_ctx);
+    assert_non_null(test_ctx->ssh_ctx);
+    test_ctx->ssh_ctx->rctx = rctx;
+    test_ctx->ssh_ctx->known_hosts_timeout = TEST_KNOWN_HOSTS_TIMEOUT;
+
+    store_host(test_ctx->tctx->dom, TEST_HOST1, TEST_KEY1);
+    store_host(test_ctx->tctx->dom, TEST_HOST2, TEST_KEY2);
+
+    check_leaks_push(test_ctx);
+
+    *state = test_ctx;
+    return 0;
+}
+
+static int ssh_known_hosts_test_teardown(void **state)
+{
+    struct ssh_known_hosts_test_ctx *test_ctx;
+
+    test_ctx = talloc_get_type_abort(*state, struct ssh_known_hosts_test_ctx);
+
+    talloc_zfree(test_ctx->ssh_ctx->known_hosts);
+    assert_true(check_leaks_pop(test_ctx));
+
+    unlink(SSS_SSH_KNOWN_HOSTS_PATH);
+    test_dom_suite_cleanup(TESTS_PATH, TEST_CONF_DB, TEST_DOM_NAME);
+    talloc_zfree(test_ctx);
+    assert_true(leak_check_teardown());
+
+    return 0;
+}
+
+/* Looked up hosts are added, the file is not rewritten if nothing
+ * changed. */
+static void test_known_hosts_add(void **state)
+{
+    struct ssh_known_hosts_test_ctx *test_ctx;
+    ino_t ino;
+
+    test_ctx = talloc_get_type_abort(*state, struct ssh_known_hosts_test_ctx);
+
+    lookup_host(test_ctx, TEST_HOST1);
+    assert_known_hosts(test_ctx, TEST_LINE1);
+
+    lookup_host(test_ctx, TEST_HOST2);
+    assert_known_hosts(test_ctx, TEST_LINE1 TEST_LINE2);
+
+    ino = known_hosts_ino();
+    lookup_host(test_ctx, TEST_HOST1);
+    assert_int_equal(known_hosts_ino(), ino);
+    assert_known_hosts(test_ctx, TEST_LINE1 TEST_LINE2);
+}
+
+/* A host stored outside of its own lookup, e.g. by a refresh in the
+ * provider, is updated by the lookup of any host. */
+static void test_known_hosts_update(void **state)
+{
+    struct ssh_known_hosts_test_ctx *test_ctx;
+
+    test_ctx = talloc_get_type_abort(*state, struct ssh_known_hosts_test_ctx);
+
+    lookup_host(test_ctx, TEST_HOST1);
+    lookup_host(test_ctx, TEST_HOST2);
+    assert_known_hosts(test_ctx, TEST_LINE1 TEST_LINE2);
+
+    store_host(test_ctx->tctx->dom, TEST_HOST1, TEST_KEY1B);
+
+    lookup_host(test_ctx, TEST_HOST2);
+    assert_known_hosts(test_ctx, TEST_LINE2 TEST_LINE1B);
+}
+
+/* Hosts whose known_hosts timeout passed are removed by the timer. */
+static void test_known_hosts_expire(void **state)
+{
+    struct ssh_known_hosts_test_ctx *test_ctx;
+    struct ssh_known_hosts *kh;
+    struct ssh_known_host *host;
+    time_t now;
+
+    test_ctx = talloc_get_type_abort(*state, struct ssh_known_hosts_test_ctx);
+
+    now = time(NULL);
+    lookup_host(test_ctx, TEST_HOST1);
+    lookup_host(test_ctx, TEST_HOST2);
+
+    kh = test_ctx->ssh_ctx->known_hosts;
+    assert_non_null(kh->prune_timer);
+    assert_true(kh->prune_time >= now + TEST_KNOWN_HOSTS_TIMEOUT
+                                  + SSH_KNOWN_HOSTS_PRUNE_DELAY);
+
+    /* nothing expired yet */
+    prune(test_ctx);
+    assert_known_hosts(test_ctx, TEST_LINE1 TEST_LINE2);
+
+    host = ssh_known_hosts_lookup(kh, TEST_DOM_NAME"/"TEST_HOST1);
+    assert_non_null(host);
+    host->expire = now - 1;
+
+    prune(test_ctx);
+    assert_known_hosts(test_ctx, TEST_LINE2);
+    assert_null(ssh_known_hosts_lookup(kh, TEST_DOM_NAME"/"TEST_HOST1));
+    assert_non_null(kh->prune_timer);
+}
+
+/* Hosts invalidated or removed from the cache, e.g. by sss_cache, are
+ * removed even if they are not looked up. */
+static void test_known_hosts_invalidate(void **state)
+{
+    struct ssh_known_hosts_test_ctx *test_ctx;
+    struct sysdb_attrs *attrs;
+    errno_t ret;
+
+    test_ctx = talloc_get_type_abort(*state, struct ssh_known_hosts_test_ctx);
+
+    lookup_host(test_ctx, TEST_HOST1);
+    lookup_host(test_ctx, TEST_HOST2);
+    assert_known_hosts(test_ctx, TEST_LINE1 TEST_LINE2);
+
+    attrs = sysdb_new_attrs(test_ctx);
+    assert_non_null(attrs);
+    ret = sysdb_attrs_add_time_t(attrs, SYSDB_CACHE_EXPIRE, 1);
+    assert_int_equal(ret, EOK);
+
+    ret = sysdb_set_ssh_host_attr(test_ctx->tctx->dom, TEST_HOST1,
+                                  attrs, SYSDB_MOD_REP);
+    assert_int_equal(ret, EOK);
+    talloc_free(attrs);
+
+    prune(test_ctx);
+    assert_known_hosts(test_ctx, TEST_LINE2);
+
+    ret = sysdb_delete_ssh_host(test_ctx->tctx->dom, TEST_HOST2);
+    assert_int_equal(ret, EOK);
+
+    prune(test_ctx);
+    assert_known_hosts(test_ctx, "");
+}
+
+/* The hashed lines of hosts that did not change are reused. */
+static void test_known_hosts_hashed(void **state)
+{
+    struct ssh_known_hosts_test_ctx *test_ctx;
+    char *content;
+    char *line1;
+    char *line2;
+
+    test_ctx = talloc_get_type_abort(*state, struct ssh_known_hosts_test_ctx);
+    test_ctx->ssh_ctx->hash_known_hosts = true;
+
+    lookup_host(test_ctx, TEST_HOST1);
+    line1 = read_known_hosts(test_ctx);
+    assert_non_null(line1);
+    assert_true(strncmp(line1, "|1|", 3) == 0);
+    assert_null(strstr(line1, TEST_HOST1));
+
+    lookup_host(test_ctx, TEST_HOST2);
+    content = read_known_hosts(test_ctx);
+    assert_true(strncmp(content, line1, strlen(line1)) == 0);
+    line2 = talloc_strdup(test_ctx, content + strlen(line1));
+    assert_non_null(line2);
+    talloc_free(content);
+
+    /* only the changed host is hashed again */
+    store_host(test_ctx->tctx->dom, TEST_HOST1, TEST_KEY1B);
+    lookup_host(test_ctx, TEST_HOST2);
+    content = read_known_hosts(test_ctx);
+    assert_true(strncmp(content, line2, strlen(line2)) == 0);
+    assert_string_not_equal(content + strlen(line2), line1);
+    assert_non_null(strstr(content, TEST_KEY1B));
+
+    talloc_free(content);
+    talloc_free(line1);
+    talloc_free(line2);
+}
+
+int main(int argc, const char *argv[])
+{
+    poptContext pc;
+    int opt;
+    int rv;
+    struct poptOption long_options[] = {
+        POPT_AUTOHELP
+        SSSD_DEBUG_OPTS
+        POPT_TABLEEND
+    };
+
+    const struct CMUnitTest tests[] = {
+        cmocka_unit_test_setup_teardown(test_known_hosts_add,
+                                        ssh_known_hosts_test_setup,
+                                        ssh_known_hosts_test_teardown),
+        cmocka_unit_test_setup_teardown(test_known_hosts_update,
+                                        ssh_known_hosts_test_setup,
+                                        ssh_known_hosts_test_teardown),
+        cmocka_unit_test_setup_teardown(test_known_hosts_expire,
+                                        ssh_known_hosts_test_setup,
+                                        ssh_known_hosts_test_teardown),
+        cmocka_unit_test_setup_teardown(test_known_hosts_invalidate,
+                                        ssh_known_hosts_test_setup,
+                                        ssh_known_hosts_test_teardown),
+        cmocka_unit_test_setup_teardown(test_known_hosts_hashed,
+                                        ssh_known_hosts_test_setup,
+                                        ssh_known_hosts_test_teardown),
+    };
+
+    /* Set debug level to invalid value so we can decide if -d 0 was used. */
+    debug_level = SSSDBG_INVALID;
+
+    pc = poptGetContext(argv[0], argc, argv, long_options, 0);
+    while ((opt = poptGetNextOpt(pc)) != -1) {
+        switch (opt) {
+        default:
+            fprintf(stderr, "\nInvalid option %s: %s\n\n",
+                    poptBadOption(pc, 0), poptStrerror(opt));
+            poptPrintUsage(pc, stderr, 0);
+            return 1;
+        }
+    }
+    poptFreeContext(pc);
+
+    DEBUG_CLI_INIT(debug_level);
+
+    /* Even though normally the tests should clean up after themselves
+     * they might not after a failed run. Remove the old DB to be sure */
+    tests_set_cwd();
+    unlink(SSS_SSH_KNOWN_HOSTS_PATH);
+    test_dom_suite_cleanup(TESTS_PATH, TEST_CONF_DB, TEST_DOM_NAME);
+    test_dom_suite_setup(TESTS_PATH);
+
+    rv = cmocka_run_group_tests(tests, NULL, NULL);
+    if (rv == 0) {
+        test_dom_suite_cleanup(TESTS_PATH, TEST_CONF_DB, TEST_DOM_NAME);
+    }
+    return rv;
+}
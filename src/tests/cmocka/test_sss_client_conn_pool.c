@@ -0,0 +1,368 @@
+/*
+    SSSD
+
+    NSS client connection pool tests
+
+    Copyright (C) 2026 Red Hat
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <cmocka.h>
+#include <popt.h>
+#include <pthread.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+
+#include "tests/cmocka/common_mock.h"
+#include "util/atomic_io.h"
+#include "sss_client/sss_cli.h"
+
+#define TEST_POOL_SIZE 2
+#define TEST_POOL_SIZE_STR "2"
+#define TEST_THREADS 8
+#define TEST_REQUESTS 4
+#define TEST_REPLY_DELAY_US 20000
+#define TEST_TIMEOUT 5000
+
+/* A minimal NSS responder answering SSS_GET_VERSION and echoing the body
+ * of every other request. It counts the accepted connections and the
+ * number of requests served in parallel. */
+struct test_srv {
+    int lsd;
+    pthread_t thread;
+
+    pthread_mutex_t mtx;
+    int accepted;
+    int in_flight;
+    int max_in_flight;
+};
+
+static struct test_srv test_srv = { .lsd = -1,
+                                    .mtx = PTHREAD_MUTEX_INITIALIZER };
+
+static errno_t test_srv_reply(int sd, uint32_t cmd,
+                              uint8_t *body, size_t body_len)
+{
+    uint32_t header[4];
+    ssize_t len;
+
+    header[0] = SSS_NSS_HEADER_SIZE + body_len;
+    header[1] = cmd;
+    header[2] = 0;
+    header[3] = 0;
+
+    len = sss_atomic_write_s(sd, header, SSS_NSS_HEADER_SIZE);
+    if (len != SSS_NSS_HEADER_SIZE) {
+        return EIO;
+    }
+
+    if (body_len > 0) {
+        len = sss_atomic_write_s(sd, body, body_len);
+        if (len != body_len) {
+            return EIO;
+        }
+    }
+
+    return EOK;
+}
+
+static void *test_srv_conn(void *arg)
+{
+    int sd = (int)(intptr_t)arg;
+    uint32_t header[4];
+    uint32_t version = SSS_NSS_PROTOCOL_VERSION;
+    uint8_t body[256];
+    size_t body_len;
+    ssize_t len;
+    errno_t ret;
+
+    while (1) {
+        len = sss_atomic_read_s(sd, header, SSS_NSS_HEADER_SIZE);
+        if (len != SSS_NSS_HEADER_SIZE) {
+            break;
+        }
+
+        body_len = header[0] - SSS_NSS_HEADER_SIZE;
+        if (header[0] < SSS_NSS_HEADER_SIZE || body_len > sizeof(body)) {
+            break;
+        }
+
+        if (body_len > 0) {
+            len = sss_atomic_read_s(sd, body, body_len);
+            if (len != body_len) {
+                break;
+            }
+        }
+
+        if (header[1] == SSS_GET_VERSION) {
+            ret = test_srv_reply(sd, header[1], (uint8_t *)&version,
+                                 sizeof(version));
+        } else {
+            pthread_mutex_lock(&test_srv.mtx);
+            test_srv.in_flight++;
+            if (test_srv.in_flight > test_srv.max_in_flight) {
+                test_srv.max_in_flight = test_srv.in_flight;
+            }
+            pthread_mutex_unlock(&test_srv.mtx);
+
+            usleep(TEST_REPLY_DELAY_US);
+
+            pthread_mutex_lock(&test_srv.mtx);
+            test_srv.in_flight--;
+            pthread_mutex_unlock(&test_srv.mtx);
+
+            ret = test_srv_reply(sd, header[1], body, body_len);
+        }
+
+        if (ret != EOK) {
+            break;
+        }
+    }
+
+    close(sd);
+    return NULL;
+}
+
+static void *test_srv_accept(void *arg)
+{
+    pthread_t thread;
+    int sd;
+    int ret;
+
+    while (1) {
+        sd = accept(test_srv.lsd, NULL, NULL);
+        if (sd == -1) {
+            break;
+        }
+
+        pthread_mutex_lock(&test_srv.mtx);
+        test_srv.accepted++;
+        pthread_mutex_unlock(&test_srv.mtx);
+
+        ret = pthread_create(&thread, NULL, test_srv_conn,
+                             (void *)(intptr_t)sd);
+        if (ret != 0) {
+            close(sd);
+            break;
+        }
+        pthread_detach(thread);
+    }
+
+    return NULL;
+}
+
+static int test_conn_pool_group_setup(void **state)
+{
+    struct sockaddr_un addr;
+    int ret;
+
+    memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    if (strlen(SSS_NSS_SOCKET_NAME) >= sizeof(addr.sun_path)) {
+        return 1;
+    }
+    strcpy(addr.sun_path, SSS_NSS_SOCKET_NAME);
+    unlink(SSS_NSS_SOCKET_NAME);
+
+    test_srv.lsd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (test_srv.lsd == -1) {
+        return 1;
+    }
+
+    ret = bind(test_srv.lsd, (struct sockaddr *)&addr, sizeof(addr));
+    if (ret != 0) {
+        return 1;
+    }
+
+    ret = listen(test_srv.lsd, TEST_THREADS);
+    if (ret != 0) {
+        return 1;
+    }
+
+    ret = pthread_create(&test_srv.thread, NULL, test_srv_accept, NULL);
+    if (ret != 0) {
+        return 1;
+    }
+
+    return 0;
+}
+
+static int test_conn_pool_group_teardown(void **state)
+{
+    /* wakes up the accept() of the server thread */
+    shutdown(test_srv.lsd, SHUT_RDWR);
+    pthread_join(test_srv.thread, NULL);
+    close(test_srv.lsd);
+    unlink(SSS_NSS_SOCKET_NAME);
+
+    return 0;
+}
+
+static int test_conn_pool_setup(void **state)
+{
+    pthread_mutex_lock(&test_srv.mtx);
+    test_srv.accepted = 0;
+    test_srv.max_in_flight = 0;
+    pthread_mutex_unlock(&test_srv.mtx);
+
+    return 0;
+}
+
+static errno_t test_conn_pool_request(enum sss_cli_command cmd,
+                                      const char *name)
+{
+    struct sss_cli_req_data rd;
+    uint8_t *repbuf = NULL;
+    size_t replen;
+    enum nss_status status;
+    int errnop = 0;
+    errno_t ret;
+
+    rd.len = strlen(name) + 1;
+    rd.data = name;
+
+    status = sss_nss_make_request_timeout(cmd, &rd, TEST_TIMEOUT,
+                                          &repbuf, &replen, &errnop);
+    if (status != NSS_STATUS_SUCCESS) {
+        return errnop != 0 ? errnop : EIO;
+    }
+
+    if (replen != rd.len || memcmp(repbuf, name, rd.len) != 0) {
+        ret = EBADMSG;
+    } else {
+        ret = EOK;
+    }
+
+    free(repbuf);
+    return ret;
+}
+
+/* cmocka assertions must not be used outside of the main thread, the
+ * number of failed requests is returned instead */
+static void *test_conn_pool_thread(void *arg)
+{
+    char name[32];
+    intptr_t failed = 0;
+    errno_t ret;
+    int i;
+
+    for (i = 0; i < TEST_REQUESTS; i++) {
+        snprintf(name, sizeof(name), "user%d_%d", (int)(intptr_t)arg, i);
+        ret = test_conn_pool_request(SSS_NSS_GETPWNAM, name);
+        if (ret != EOK) {
+            failed++;
+        }
+    }
+
+    return (void *)failed;
+}
+
+/* Lookups of single users from many threads are served in parallel but
+ * never open more sockets than the pool holds. */
+static void test_conn_pool_parallel(void **state)
+{
+    pthread_t threads[TEST_THREADS];
+    void *failed;
+    errno_t ret;
+    int i;
+
+    for (i = 0; i < TEST_THREADS; i++) {
+        ret = pthread_create(&threads[i], NULL, test_conn_pool_thread,
+                             (void *)(intptr_t)i);
+        assert_int_equal(ret, 0);
+    }
+
+    for (i = 0; i < TEST_THREADS; i++) {
+        pthread_join(threads[i], &failed);
+        assert_int_equal((intptr_t)failed, 0);
+    }
+
+    pthread_mutex_lock(&test_srv.mtx);
+    assert_int_equal(test_srv.accepted, TEST_POOL_SIZE);
+    assert_int_equal(test_srv.max_in_flight, TEST_POOL_SIZE);
+    pthread_mutex_unlock(&test_srv.mtx);
+
+    /* the pooled sockets are reused */
+    ret = test_conn_pool_request(SSS_NSS_INITGR, "user");
+    assert_int_equal(ret, EOK);
+    ret = test_conn_pool_request(SSS_NSS_GETPWNAM, "user");
+    assert_int_equal(ret, EOK);
+
+    pthread_mutex_lock(&test_srv.mtx);
+    assert_int_equal(test_srv.accepted, TEST_POOL_SIZE);
+    pthread_mutex_unlock(&test_srv.mtx);
+}
+
+/* Commands which are not pooled keep using the shared socket. */
+static void test_conn_pool_shared_socket(void **state)
+{
+    errno_t ret;
+
+    ret = test_conn_pool_request(SSS_NSS_GETGRNAM, "group");
+    assert_int_equal(ret, EOK);
+    ret = test_conn_pool_request(SSS_NSS_GETGRNAM, "group");
+    assert_int_equal(ret, EOK);
+
+    pthread_mutex_lock(&test_srv.mtx);
+    assert_int_equal(test_srv.accepted, 1);
+    pthread_mutex_unlock(&test_srv.mtx);
+}
+
+int main(int argc, const char *argv[])
+{
+    poptContext pc;
+    int opt;
+    struct poptOption long_options[] = {
+        POPT_AUTOHELP
+        SSSD_DEBUG_OPTS
+        POPT_TABLEEND
+    };
+
+    const struct CMUnitTest tests[] = {
+        cmocka_unit_test_setup(test_conn_pool_parallel,
+                               test_conn_pool_setup),
+        cmocka_unit_test_setup(test_conn_pool_shared_socket,
+                               test_conn_pool_setup),
+    };
+
+    /* Set debug level to invalid value so we can decide if -d 0 was used. */
+    debug_level = SSSDBG_INVALID;
+
+    pc = poptGetContext(argv[0], argc, argv, long_options, 0);
+    while ((opt = poptGetNextOpt(pc)) != -1) {
+        switch (opt) {
+        default:
+            fprintf(stderr, "\nInvalid option %s: %s\n\n",
+                    poptBadOption(pc, 0), poptStrerror(opt));
+            poptPrintUsage(pc, stderr, 0);
+            return 1;
+        }
+    }
+    poptFreeContext(pc);
+
+    DEBUG_CLI_INIT(debug_level);
+
+    tests_set_cwd();
+
+    /* The pool size is read once by the client library */
+    setenv("SSS_NSS_CONNECTION_POOL", TEST_POOL_SIZE_STR, 1);
+    unsetenv("_SSS_LOOPS");
+
+    return cmocka_run_group_tests(tests, test_conn_pool_group_setup,
+                                  test_conn_pool_group_teardown);
+}
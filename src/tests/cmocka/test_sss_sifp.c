@@ -2118,6 +2118,169 @@ void test_sss_sifp_fetch_domain_by_name(void **state)
     /* messages are unreferenced in the library */
 }
 
+void test_sss_sifp_fetch_users_attrs(void **state)
+{
+    sss_sifp_ctx *ctx = test_ctx.dbus_ctx;
+    DBusMessage *msg_attrs = NULL;
+    DBusMessageIter iter;
+    DBusMessageIter objects_iter;
+    DBusMessageIter array_iter;
+    DBusMessageIter dict_iter;
+    DBusMessageIter values_iter;
+    dbus_bool_t bret;
+    sss_sifp_error ret;
+    const char *paths[] = {SSS_SIFP_PATH "/Users/LDAP/1000",
+                           SSS_SIFP_PATH "/Users/LDAP/1001",
+                           NULL};
+    const char *attrs[] = {"name", "mail", NULL};
+    const char *name = "alice";
+    const char *mails[] = {"alice@example.com", "a@example.com"};
+    const char *attr_name;
+    const char * const *values = NULL;
+    const char *prop = NULL;
+    unsigned int num_values;
+    sss_sifp_object **out = NULL;
+    int i;
+
+    msg_attrs = dbus_message_new(DBUS_MESSAGE_TYPE_METHOD_RETURN);
+    assert_non_null(msg_attrs);
+
+    /* prepare message, the second user does not exist */
+    dbus_message_iter_init_append(msg_attrs, &iter);
+
+    bret = dbus_message_iter_open_container(&iter, DBUS_TYPE_ARRAY,
+                                            DBUS_TYPE_ARRAY_AS_STRING
+                                            DBUS_DICT_ENTRY_BEGIN_CHAR_AS_STRING
+                                            DBUS_TYPE_STRING_AS_STRING
+                                            DBUS_TYPE_ARRAY_AS_STRING
+                                            DBUS_TYPE_STRING_AS_STRING
+                                            DBUS_DICT_ENTRY_END_CHAR_AS_STRING,
+                                            &objects_iter);
+    assert_true(bret);
+
+    for (i = 0; paths[i] != NULL; i++) {
+        bret = dbus_message_iter_open_container(&objects_iter,
+                                            DBUS_TYPE_ARRAY,
+                                            DBUS_DICT_ENTRY_BEGIN_CHAR_AS_STRING
+                                            DBUS_TYPE_STRING_AS_STRING
+                                            DBUS_TYPE_ARRAY_AS_STRING
+                                            DBUS_TYPE_STRING_AS_STRING
+                                            DBUS_DICT_ENTRY_END_CHAR_AS_STRING,
+                                            &array_iter);
+        assert_true(bret);
+
+        if (i == 0) {
+            /* name */
+            bret = dbus_message_iter_open_container(&array_iter,
+                                                    DBUS_TYPE_DICT_ENTRY,
+                                                    NULL, &dict_iter);
+            assert_true(bret);
+
+            attr_name = attrs[0];
+            bret = dbus_message_iter_append_basic(&dict_iter,
+                                                  DBUS_TYPE_STRING,
+                                                  &attr_name);
+            assert_true(bret);
+
+            bret = dbus_message_iter_open_container(&dict_iter,
+                                                    DBUS_TYPE_ARRAY,
+                                                    DBUS_TYPE_STRING_AS_STRING,
+                                                    &values_iter);
+            assert_true(bret);
+
+            bret = dbus_message_iter_append_basic(&values_iter,
+                                                  DBUS_TYPE_STRING, &name);
+            assert_true(bret);
+
+            bret = dbus_message_iter_close_container(&dict_iter,
+                                                     &values_iter);
+            assert_true(bret);
+
+            bret = dbus_message_iter_close_container(&array_iter, &dict_iter);
+            assert_true(bret);
+
+            /* mail */
+            bret = dbus_message_iter_open_container(&array_iter,
+                                                    DBUS_TYPE_DICT_ENTRY,
+                                                    NULL, &dict_iter);
+            assert_true(bret);
+
+            attr_name = attrs[1];
+            bret = dbus_message_iter_append_basic(&dict_iter,
+                                                  DBUS_TYPE_STRING,
+                                                  &attr_name);
+            assert_true(bret);
+
+            bret = dbus_message_iter_open_container(&dict_iter,
+                                                    DBUS_TYPE_ARRAY,
+                                                    DBUS_TYPE_STRING_AS_STRING,
+                                                    &values_iter);
+            assert_true(bret);
+
+            bret = dbus_message_iter_append_basic(&values_iter,
+                                                  DBUS_TYPE_STRING,
+                                                  &mails[0]);
+            assert_true(bret);
+
+            bret = dbus_message_iter_append_basic(&values_iter,
+                                                  DBUS_TYPE_STRING,
+                                                  &mails[1]);
+            assert_true(bret);
+
+            bret = dbus_message_iter_close_container(&dict_iter,
+                                                     &values_iter);
+            assert_true(bret);
+
+            bret = dbus_message_iter_close_container(&array_iter, &dict_iter);
+            assert_true(bret);
+        }
+
+        bret = dbus_message_iter_close_container(&objects_iter, &array_iter);
+        assert_true(bret);
+    }
+
+    bret = dbus_message_iter_close_container(&iter, &objects_iter);
+    assert_true(bret);
+
+    will_return(__wrap_dbus_connection_send_with_reply_and_block, msg_attrs);
+
+    /* test */
+    ret = sss_sifp_fetch_users_attrs(ctx, paths, attrs, &out);
+    assert_int_equal(ret, SSS_SIFP_OK);
+    assert_non_null(out);
+
+    assert_non_null(out[0]);
+    assert_string_equal(out[0]->object_path, paths[0]);
+    assert_string_equal(out[0]->interface,
+                        "org.freedesktop.sssd.infopipe.Users.User");
+    assert_non_null(out[0]->name);
+    assert_string_equal(out[0]->name, name);
+
+    ret = sss_sifp_find_attr_as_string(out[0]->attrs, "name", &prop);
+    assert_int_equal(ret, SSS_SIFP_OK);
+    assert_string_equal(prop, name);
+
+    ret = sss_sifp_find_attr_as_string_array(out[0]->attrs, "mail",
+                                             &num_values, &values);
+    assert_int_equal(ret, SSS_SIFP_OK);
+    assert_int_equal(num_values, 2);
+    assert_string_equal(values[0], mails[0]);
+    assert_string_equal(values[1], mails[1]);
+
+    assert_non_null(out[1]);
+    assert_string_equal(out[1]->object_path, paths[1]);
+    assert_null(out[1]->name);
+    assert_non_null(out[1]->attrs);
+    assert_null(out[1]->attrs[0]);
+
+    assert_null(out[2]);
+
+    sss_sifp_free_objects(ctx, &out);
+    assert_null(out);
+
+    /* messages are unreferenced in the library */
+}
+
 int main(int argc, const char *argv[])
 {
     int rv;
@@ -2225,6 +2388,8 @@ int main(int argc, const char *argv[])
                                         test_setup, test_teardown_api),
         cmocka_unit_test_setup_teardown(test_sss_sifp_fetch_domain_by_name,
                                         test_setup, test_teardown_api),
+        cmocka_unit_test_setup_teardown(test_sss_sifp_fetch_users_attrs,
+                                        test_setup, test_teardown_api),
     };
 
     /* Set debug level to invalid value so we can decide if -d 0 was used. */
@@ -0,0 +1,377 @@
+/*
+    SSSD
+
+    sudo responder rule index tests
+
+    Copyright (C) 2026 Red Hat
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <cmocka.h>
+#include <popt.h>
+
+#include "tests/cmocka/common_mock.h"
+
+/* Including private file makes it easier to test with static functions */
+#include "responder/sudo/sudosrv_get_sudorules.c"
+
+#define TESTS_PATH "tp_" BASE_FILE_STEM
+#define TEST_CONF_DB "test_sudo_rule_index_conf.ldb"
+#define TEST_DOM_NAME "sudo_index_test"
+
+#define TEST_SUDO_TIMEOUT 100
+
+#define TEST_USER1_NAME "user1"
+#define TEST_USER1_UID 1001
+#define TEST_USER2_NAME "user2"
+#define TEST_USER2_UID 1002
+#define TEST_GROUP_NAME "group1"
+
+struct test_rule {
+    const char *name;
+    const char *user;
+    const char *order;
+} test_rules[] = { { "rule_user", TEST_USER1_NAME, "1" },
+                   { "rule_group", "%"TEST_GROUP_NAME, "2" },
+                   { "rule_uid", "#1001", "3" },
+                   { "rule_all", "ALL", "4" },
+                   { "rule_netgroup", "+netgroup1", "5" },
+                   { "rule_other", TEST_USER2_NAME, "0" },
+                   { "defaults", NULL, "0" } };
+
+struct sudo_index_test_ctx {
+    struct sss_test_ctx *tctx;
+    struct sudo_ctx *sudo_ctx;
+};
+
+static void store_rules(struct sss_domain_info *domain)
+{
+    struct sysdb_attrs **rules;
+    size_t num_rules = sizeof(test_rules) / sizeof(test_rules[0]);
+    errno_t ret;
+    size_t i;
+
+    rules = talloc_zero_array(NULL, struct sysdb_attrs *, num_rules);
+    assert_non_null(rules);
+
+    for (i = 0; i < num_rules; i++) {
+        rules[i] = sysdb_new_attrs(rules);
+        assert_non_null(rules[i]);
+
+        ret = sysdb_attrs_add_string(rules[i], SYSDB_SUDO_CACHE_AT_CN,
+                                     test_rules[i].name);
+        assert_int_equal(ret, EOK);
+
+        ret = sysdb_attrs_add_string(rules[i], SYSDB_SUDO_CACHE_AT_ORDER,
+                                     test_rules[i].order);
+        assert_int_equal(ret, EOK);
+
+        if (test_rules[i].user != NULL) {
+            ret = sysdb_attrs_add_string(rules[i], SYSDB_SUDO_CACHE_AT_USER,
+                                         test_rules[i].user);
+            assert_int_equal(ret, EOK);
+        }
+    }
+
+    ret = sysdb_sudo_store(domain, rules, num_rules);
+    assert_int_equal(ret, EOK);
+
+    talloc_free(rules);
+}
+
+static void expire_rule(struct sss_domain_info *domain, const char *name)
+{
+    struct sysdb_attrs *attrs;
+    errno_t ret;
+
+    attrs = sysdb_new_attrs(NULL);
+    assert_non_null(attrs);
+
+    ret = sysdb_attrs_add_time_t(attrs, SYSDB_CACHE_EXPIRE, 1);
+    assert_int_equal(ret, EOK);
+
+    ret = sysdb_set_sudo_rule_attr(domain, name, attrs, SYSDB_MOD_REP);
+    assert_int_equal(ret, EOK);
+
+    talloc_free(attrs);
+}
+
+static void assert_rule_names(struct sysdb_attrs **rules,
+                              uint32_t num_rules,
+                              const char *attr,
+                              const char **expected)
+{
+    const char *name;
+    uint32_t i;
+    errno_t ret;
+
+    for (i = 0; expected[i] != NULL; i++) {
+        assert_true(i < num_rules);
+        ret = sysdb_attrs_get_string(rules[i], attr, &name);
+        assert_int_equal(ret, EOK);
+        assert_string_equal(name, expected[i]);
+    }
+
+    assert_int_equal(i, num_rules);
+}
+
+static int sudo_index_test_setup(void **state)
+{
+    struct sudo_index_test_ctx *test_ctx;
+
+    assert_true(leak_check_setup());
+
+    test_ctx = talloc_zero(global_talloc_context, struct sudo_index_test_ctx);
+    assert_non_null(test_ctx);
+
+    test_dom_suite_setup(TESTS_PATH);
+
+    test_ctx->tctx = create_dom_test_ctx(test_ctx, TESTS_PATH, TEST_CONF_DB,
+                                         TEST_DOM_NAME, "ldap", NULL);
+    assert_non_null(test_ctx->tctx);
+    test_ctx->tctx->dom->sudo_timeout = TEST_SUDO_TIMEOUT;
+
+    test_ctx->sudo_ctx = talloc_zero(test_ctx, struct sudo_ctx);
+    assert_non_null(test_ctx->sudo_ctx);
+
+    store_rules(test_ctx->tctx->dom);
+
+    check_leaks_push(test_ctx);
+
+    *state = test_ctx;
+    return 0;
+}
+
+static int sudo_index_test_teardown(void **state)
+{
+    struct sudo_index_test_ctx *test_ctx;
+
+    test_ctx = talloc_get_type_abort(*state, struct sudo_index_test_ctx);
+
+    assert_true(check_leaks_pop(test_ctx));
+
+    test_dom_suite_cleanup(TESTS_PATH, TEST_CONF_DB, TEST_DOM_NAME);
+    talloc_zfree(test_ctx);
+    assert_true(leak_check_teardown());
+
+    return 0;
+}
+
+/* The index is reused until the rules generation changes. */
+static void test_sudo_index_get(void **state)
+{
+    struct sudo_index_test_ctx *test_ctx;
+    struct sudosrv_rule_index *index;
+    struct sudosrv_rule_index *index2;
+    uint32_t generation;
+    errno_t ret;
+
+    test_ctx = talloc_get_type_abort(*state, struct sudo_index_test_ctx);
+
+    ret = sudosrv_index_get(test_ctx->sudo_ctx, test_ctx->tctx->dom, &index);
+    assert_int_equal(ret, EOK);
+    assert_int_equal(index->num_rules,
+                     sizeof(test_rules) / sizeof(test_rules[0]));
+    assert_true(index->defaults >= 0);
+
+    ret = sudosrv_index_get(test_ctx->sudo_ctx, test_ctx->tctx->dom, &index2);
+    assert_int_equal(ret, EOK);
+    assert_ptr_equal(index, index2);
+    generation = index->generation;
+
+    /* the old index is freed */
+    ret = sysdb_sudo_bump_generation(test_ctx->tctx->dom);
+    assert_int_equal(ret, EOK);
+
+    ret = sudosrv_index_get(test_ctx->sudo_ctx, test_ctx->tctx->dom, &index2);
+    assert_int_equal(ret, EOK);
+    assert_int_equal(index2->generation, generation + 1);
+    assert_ptr_equal(test_ctx->sudo_ctx->rule_indexes, index2);
+    assert_null(index2->next);
+
+    talloc_zfree(test_ctx->sudo_ctx->rule_indexes);
+}
+
+/* Rules are matched by name, uid, group, ALL and netgroup in the order
+ * of sudoOrder, the same as the sysdb filters select them. */
+static void test_sudo_index_user_rules(void **state)
+{
+    struct sudo_index_test_ctx *test_ctx;
+    struct sudosrv_rule_index *index;
+    struct sysdb_attrs **rules;
+    uint32_t num_rules;
+    const char **values;
+    char *groups[] = { discard_const(TEST_GROUP_NAME), NULL };
+    const char *user1_rules[] = { "rule_netgroup", "rule_all", "rule_uid",
+                                  "rule_group", "rule_user", NULL };
+    const char *user2_rules[] = { "rule_netgroup", "rule_all", "rule_other",
+                                  NULL };
+    errno_t ret;
+
+    test_ctx = talloc_get_type_abort(*state, struct sudo_index_test_ctx);
+
+    ret = sudosrv_index_get(test_ctx->sudo_ctx, test_ctx->tctx->dom, &index);
+    assert_int_equal(ret, EOK);
+
+    ret = sudosrv_index_user_rules(test_ctx, index, TEST_USER1_UID,
+                                   TEST_USER1_UID, TEST_USER1_NAME, groups,
+                                   &rules, &num_rules);
+    assert_int_equal(ret, EOK);
+    assert_rule_names(rules, num_rules, SYSDB_SUDO_CACHE_AT_CN, user1_rules);
+
+    /* sudoUser is replaced by the uid of the client, except for netgroup
+     * rules that are evaluated by sudo */
+    ret = sysdb_attrs_get_string_array(rules[4], SYSDB_SUDO_CACHE_AT_USER,
+                                       test_ctx, &values);
+    assert_int_equal(ret, EOK);
+    assert_string_equal(values[0], "#1001");
+    assert_null(values[1]);
+    talloc_free(values);
+
+    ret = sysdb_attrs_get_string_array(rules[0], SYSDB_SUDO_CACHE_AT_USER,
+                                       test_ctx, &values);
+    assert_int_equal(ret, EOK);
+    assert_string_equal(values[0], "+netgroup1");
+    talloc_free(values);
+    talloc_zfree(rules);
+
+    ret = sudosrv_index_user_rules(test_ctx, index, TEST_USER2_UID,
+                                   TEST_USER2_UID, TEST_USER2_NAME, NULL,
+                                   &rules, &num_rules);
+    assert_int_equal(ret, EOK);
+    assert_rule_names(rules, num_rules, SYSDB_SUDO_CACHE_AT_CN, user2_rules);
+    talloc_zfree(rules);
+
+    ret = sudosrv_index_user_rules(test_ctx, index, 1003, 1003, "nouser",
+                                   NULL, &rules, &num_rules);
+    assert_int_equal(ret, EOK);
+    assert_int_equal(num_rules, 2);
+    talloc_zfree(rules);
+
+    talloc_zfree(test_ctx->sudo_ctx->rule_indexes);
+}
+
+/* Rules expired after the index was built, e.g. by sss_cache, are seen. */
+static void test_sudo_index_expired_rules(void **state)
+{
+    struct sudo_index_test_ctx *test_ctx;
+    struct sss_domain_info *dom;
+    struct sudosrv_rule_index *index;
+    struct sysdb_attrs **rules;
+    uint32_t num_rules;
+    char *groups[] = { discard_const(TEST_GROUP_NAME), NULL };
+    const char *user1_expired[] = { "rule_group", "rule_user", NULL };
+    const char *user2_expired[] = { "defaults", NULL };
+    errno_t ret;
+
+    test_ctx = talloc_get_type_abort(*state, struct sudo_index_test_ctx);
+    dom = test_ctx->tctx->dom;
+
+    ret = sudosrv_expired_rules(test_ctx, test_ctx->sudo_ctx, dom,
+                                TEST_USER1_UID, TEST_USER1_NAME, groups,
+                                &rules, &num_rules);
+    assert_int_equal(ret, EOK);
+    assert_int_equal(num_rules, 0);
+    assert_null(rules);
+
+    expire_rule(dom, "rule_user");
+    expire_rule(dom, "rule_group");
+
+    ret = sudosrv_expired_rules(test_ctx, test_ctx->sudo_ctx, dom,
+                                TEST_USER1_UID, TEST_USER1_NAME, groups,
+                                &rules, &num_rules);
+    assert_int_equal(ret, EOK);
+    assert_rule_names(rules, num_rules, SYSDB_NAME, user1_expired);
+    talloc_zfree(rules);
+
+    /* the expired rules of other users are not returned but the defaults
+     * entry always is */
+    ret = sudosrv_expired_rules(test_ctx, test_ctx->sudo_ctx, dom,
+                                TEST_USER2_UID, TEST_USER2_NAME, NULL,
+                                &rules, &num_rules);
+    assert_int_equal(ret, EOK);
+    assert_int_equal(num_rules, 0);
+
+    expire_rule(dom, "defaults");
+
+    ret = sudosrv_expired_rules(test_ctx, test_ctx->sudo_ctx, dom,
+                                TEST_USER2_UID, TEST_USER2_NAME, NULL,
+                                &rules, &num_rules);
+    assert_int_equal(ret, EOK);
+    assert_rule_names(rules, num_rules, SYSDB_NAME, user2_expired);
+    talloc_zfree(rules);
+
+    ret = sudosrv_index_get(test_ctx->sudo_ctx, dom, &index);
+    assert_int_equal(ret, EOK);
+    assert_int_equal(index->generation, 3);
+
+    talloc_zfree(test_ctx->sudo_ctx->rule_indexes);
+}
+
+int main(int argc, const char *argv[])
+{
+    poptContext pc;
+    int opt;
+    int rv;
+    struct poptOption long_options[] = {
+        POPT_AUTOHELP
+        SSSD_DEBUG_OPTS
+        POPT_TABLEEND
+    };
+
+    const struct CMUnitTest tests[] = {
+        cmocka_unit_test_setup_teardown(test_sudo_index_get,
+                                        sudo_index_test_setup,
+                                        sudo_index_test_teardown),
+        cmocka_unit_test_setup_teardown(test_sudo_index_user_rules,
+                                        sudo_index_test_setup,
+                                        sudo_index_test_teardown),
+        cmocka_unit_test_setup_teardown(test_sudo_index_expired_rules,
+                                        sudo_index_test_setup,
+                                        sudo_index_test_teardown),
+    };
+
+    /* Set debug level to invalid value so we can decide if -d 0 was used. */
+    debug_level = SSSDBG_INVALID;
+
+    pc = poptGetContext(argv[0], argc, argv, long_options, 0);
+    while ((opt = poptGetNextOpt(pc)) != -1) {
+        switch (opt) {
+        default:
+            fprintf(stderr, "\nInvalid option %s: %s\n\n",
+                    poptBadOption(pc, 0), poptStrerror(opt));
+            poptPrintUsage(pc, stderr, 0);
+            return 1;
+        }
+    }
+    poptFreeContext(pc);
+
+    DEBUG_CLI_INIT(debug_level);
+
+    /* Even though normally the tests should clean up after themselves
+     * they might not after a failed run. Remove the old DB to be sure */
+    tests_set_cwd();
+    test_dom_suite_cleanup(TESTS_PATH, TEST_CONF_DB, TEST_DOM_NAME);
+    test_dom_suite_setup(TESTS_PATH);
+
+    rv = cmocka_run_group_tests(tests, NULL, NULL);
+    if (rv == 0) {
+        test_dom_suite_cleanup(TESTS_PATH, TEST_CONF_DB, TEST_DOM_NAME);
+    }
+    return rv;
+}
@@ -498,6 +498,37 @@ void test_sudo_set_get_last_full_refresh(void **state)
     assert_int_equal(now, loaded_time);
 }
 
+void test_sudo_bump_generation(void **state)
+{
+    errno_t ret;
+    uint32_t generation;
+    struct sysdb_test_ctx *test_ctx = talloc_get_type_abort(*state,
+                                                         struct sysdb_test_ctx);
+
+    ret = sysdb_sudo_get_generation(test_ctx->tctx->dom, &generation);
+    assert_int_equal(ret, EOK);
+    assert_int_equal(generation, 0);
+
+    ret = sysdb_sudo_bump_generation(test_ctx->tctx->dom);
+    assert_int_equal(ret, EOK);
+    ret = sysdb_sudo_bump_generation(test_ctx->tctx->dom);
+    assert_int_equal(ret, EOK);
+
+    ret = sysdb_sudo_get_generation(test_ctx->tctx->dom, &generation);
+    assert_int_equal(ret, EOK);
+    assert_int_equal(generation, 2);
+
+    /* other attributes of the container are kept */
+    ret = sysdb_sudo_set_last_full_refresh(test_ctx->tctx->dom, 1000);
+    assert_int_equal(ret, EOK);
+    ret = sysdb_sudo_bump_generation(test_ctx->tctx->dom);
+    assert_int_equal(ret, EOK);
+
+    ret = sysdb_sudo_get_generation(test_ctx->tctx->dom, &generation);
+    assert_int_equal(ret, EOK);
+    assert_int_equal(generation, 3);
+}
+
 void test_get_sudo_user_info(void **state)
 {
     errno_t ret;
@@ -751,6 +782,53 @@ void test_set_sudo_rule_attr_replace(void **state)
     talloc_zfree(msgs);
 }
 
+void test_set_sudo_rule_attr_generation(void **state)
+{
+    errno_t ret;
+    uint32_t generation;
+    struct sysdb_attrs *rule;
+    struct sysdb_attrs *new_rule;
+    struct sysdb_test_ctx *test_ctx = talloc_get_type_abort(*state,
+                                                         struct sysdb_test_ctx);
+
+    rule = sysdb_new_attrs(test_ctx);
+    assert_non_null(rule);
+    create_rule_attrs(rule, 0);
+
+    ret = sysdb_sudo_store(test_ctx->tctx->dom, &rule, 1);
+    assert_int_equal(ret, EOK);
+
+    ret = sysdb_sudo_get_generation(test_ctx->tctx->dom, &generation);
+    assert_int_equal(ret, EOK);
+    assert_int_equal(generation, 0);
+
+    /* e.g. sss_cache expiring the rule */
+    new_rule = sysdb_new_attrs(test_ctx);
+    assert_non_null(new_rule);
+    ret = sysdb_attrs_add_time_t(new_rule, SYSDB_CACHE_EXPIRE, 1);
+    assert_int_equal(ret, EOK);
+
+    ret = sysdb_set_sudo_rule_attr(test_ctx->tctx->dom, rules[0].name,
+                                   new_rule, SYSDB_MOD_REP);
+    assert_int_equal(ret, EOK);
+
+    ret = sysdb_sudo_get_generation(test_ctx->tctx->dom, &generation);
+    assert_int_equal(ret, EOK);
+    assert_int_equal(generation, 1);
+
+    /* a failed modification does not bump the generation */
+    ret = sysdb_set_sudo_rule_attr(test_ctx->tctx->dom, rules[1].name,
+                                   new_rule, SYSDB_MOD_REP);
+    assert_int_not_equal(ret, EOK);
+
+    ret = sysdb_sudo_get_generation(test_ctx->tctx->dom, &generation);
+    assert_int_equal(ret, EOK);
+    assert_int_equal(generation, 1);
+
+    talloc_zfree(rule);
+    talloc_zfree(new_rule);
+}
+
 void test_set_sudo_rule_attr_delete(void **state)
 {
     errno_t ret;
@@ -989,6 +1067,14 @@ int main(int argc, const char *argv[])
                                         test_sysdb_setup,
                                         test_sysdb_teardown),
 
+        /*
+         * sysdb_sudo_bump_generation()
+         * sysdb_sudo_get_generation()
+         */
+        cmocka_unit_test_setup_teardown(test_sudo_bump_generation,
+                                        test_sysdb_setup,
+                                        test_sysdb_teardown),
+
         /* sysdb_get_sudo_user_info() */
         cmocka_unit_test_setup_teardown(test_get_sudo_user_info,
                                         test_sysdb_setup,
@@ -1019,6 +1105,9 @@ int main(int argc, const char *argv[])
         cmocka_unit_test_setup_teardown(test_set_sudo_rule_attr_delete,
                                         test_sysdb_setup,
                                         test_sysdb_teardown),
+        cmocka_unit_test_setup_teardown(test_set_sudo_rule_attr_generation,
+                                        test_sysdb_setup,
+                                        test_sysdb_teardown),
 
         /* sysdb_search_sudo_rules() */
         cmocka_unit_test_setup_teardown(test_search_sudo_rules,
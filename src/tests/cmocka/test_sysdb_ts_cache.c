@@ -49,6 +49,10 @@
 #define TEST_USER_SID           "S-1-5-21-123-456-789-222"
 #define TEST_USER_UPN           "test_user@TEST_REALM"
 
+#define TEST_USER_NAME_2        "test_user_2"
+#define TEST_USER_UID_2         4323
+#define TEST_USER_NAME_3        "test_user_3"
+
 #define TEST_MODSTAMP_1   "20160408132553Z"
 #define TEST_MODSTAMP_2   "20160408142553Z"
 #define TEST_MODSTAMP_3   "20160408152553Z"
@@ -1606,6 +1610,340 @@ static void test_sysdb_search_with_ts(void **state)
     talloc_free(res);
 }
 
+static void test_sysdb_users_bulk(void **state)
+{
+    int ret;
+    struct sysdb_ts_test_ctx *test_ctx = talloc_get_type_abort(*state,
+                                                     struct sysdb_ts_test_ctx);
+    struct sysdb_store_user_data users[2];
+    struct ldb_result *res;
+    uint64_t cache_expire_sysdb;
+    uint64_t cache_expire_ts;
+    size_t failed;
+
+    memset(users, 0, sizeof(users));
+    users[0].name = TEST_USER_NAME;
+    users[0].uid = TEST_USER_UID;
+    users[0].gid = TEST_USER_GID;
+    users[0].homedir = "/home/"TEST_USER_NAME;
+    users[0].shell = "/bin/bash";
+    users[1].name = TEST_USER_NAME_2;
+    users[1].uid = TEST_USER_UID_2;
+    users[1].gid = TEST_USER_GID;
+    users[1].homedir = "/home/"TEST_USER_NAME_2;
+    users[1].shell = "/bin/bash";
+
+    /* Both users are new */
+    users[0].attrs = create_modstamp_attrs(test_ctx, TEST_MODSTAMP_1);
+    users[1].attrs = create_modstamp_attrs(test_ctx, TEST_MODSTAMP_1);
+    ret = sysdb_store_users_bulk(test_ctx->tctx->dom, users, 2,
+                                 TEST_CACHE_TIMEOUT, TEST_NOW_1, &failed);
+    assert_int_equal(ret, EOK);
+    assert_int_equal(failed, 0);
+
+    res = sysdb_getpwnam_res(test_ctx, test_ctx->tctx->dom, TEST_USER_NAME_2);
+    assert_int_equal(res->count, 1);
+    talloc_free(res);
+
+    get_pw_timestamp_attrs(test_ctx, TEST_USER_NAME,
+                           &cache_expire_sysdb, &cache_expire_ts);
+    assert_int_equal(cache_expire_sysdb, TEST_CACHE_TIMEOUT + TEST_NOW_1);
+    assert_int_equal(cache_expire_ts, TEST_CACHE_TIMEOUT + TEST_NOW_1);
+
+    /* Nothing changed, only the timestamp cache is written */
+    talloc_free(users[0].attrs);
+    talloc_free(users[1].attrs);
+    users[0].attrs = create_modstamp_attrs(test_ctx, TEST_MODSTAMP_1);
+    users[1].attrs = create_modstamp_attrs(test_ctx, TEST_MODSTAMP_1);
+    ret = sysdb_store_users_bulk(test_ctx->tctx->dom, users, 2,
+                                 TEST_CACHE_TIMEOUT, TEST_NOW_2, &failed);
+    assert_int_equal(ret, EOK);
+    assert_int_equal(failed, 0);
+
+    get_pw_timestamp_attrs(test_ctx, TEST_USER_NAME,
+                           &cache_expire_sysdb, &cache_expire_ts);
+    assert_int_equal(cache_expire_sysdb, TEST_CACHE_TIMEOUT + TEST_NOW_1);
+    assert_int_equal(cache_expire_ts, TEST_CACHE_TIMEOUT + TEST_NOW_2);
+
+    get_pw_timestamp_attrs(test_ctx, TEST_USER_NAME_2,
+                           &cache_expire_sysdb, &cache_expire_ts);
+    assert_int_equal(cache_expire_sysdb, TEST_CACHE_TIMEOUT + TEST_NOW_1);
+    assert_int_equal(cache_expire_ts, TEST_CACHE_TIMEOUT + TEST_NOW_2);
+
+    /* Only the second user changed and is written to both caches */
+    talloc_free(users[0].attrs);
+    talloc_free(users[1].attrs);
+    users[0].attrs = create_modstamp_attrs(test_ctx, TEST_MODSTAMP_2);
+    users[1].attrs = create_modstamp_attrs(test_ctx, TEST_MODSTAMP_2);
+    users[1].shell = "/bin/zsh";
+    ret = sysdb_store_users_bulk(test_ctx->tctx->dom, users, 2,
+                                 TEST_CACHE_TIMEOUT, TEST_NOW_3, &failed);
+    assert_int_equal(ret, EOK);
+    assert_int_equal(failed, 0);
+
+    get_pw_timestamp_attrs(test_ctx, TEST_USER_NAME,
+                           &cache_expire_sysdb, &cache_expire_ts);
+    assert_int_equal(cache_expire_sysdb, TEST_CACHE_TIMEOUT + TEST_NOW_1);
+    assert_int_equal(cache_expire_ts, TEST_CACHE_TIMEOUT + TEST_NOW_3);
+
+    get_pw_timestamp_attrs(test_ctx, TEST_USER_NAME_2,
+                           &cache_expire_sysdb, &cache_expire_ts);
+    assert_int_equal(cache_expire_sysdb, TEST_CACHE_TIMEOUT + TEST_NOW_3);
+    assert_int_equal(cache_expire_ts, TEST_CACHE_TIMEOUT + TEST_NOW_3);
+
+    res = sysdb_getpwnam_res(test_ctx, test_ctx->tctx->dom, TEST_USER_NAME_2);
+    assert_int_equal(res->count, 1);
+    assert_string_equal(ldb_msg_find_attr_as_string(res->msgs[0],
+                                                    SYSDB_SHELL, NULL),
+                        "/bin/zsh");
+    talloc_free(res);
+
+    talloc_free(users[0].attrs);
+    talloc_free(users[1].attrs);
+}
+
+static void bulk_test_user(struct sysdb_store_user_data *user,
+                           const char *name, uid_t uid)
+{
+    memset(user, 0, sizeof(struct sysdb_store_user_data));
+    user->name = name;
+    user->uid = uid;
+    user->gid = TEST_USER_GID;
+    user->homedir = "/home/user";
+    user->shell = "/bin/bash";
+}
+
+static void test_sysdb_users_bulk_rename(void **state)
+{
+    int ret;
+    struct sysdb_ts_test_ctx *test_ctx = talloc_get_type_abort(*state,
+                                                     struct sysdb_ts_test_ctx);
+    struct sysdb_store_user_data users[2];
+    struct ldb_result *res;
+    size_t failed;
+
+    bulk_test_user(&users[0], TEST_USER_NAME, TEST_USER_UID);
+    bulk_test_user(&users[1], TEST_USER_NAME_2, TEST_USER_UID_2);
+    users[0].attrs = create_modstamp_attrs(test_ctx, TEST_MODSTAMP_1);
+    users[1].attrs = create_modstamp_attrs(test_ctx, TEST_MODSTAMP_1);
+    ret = sysdb_store_users_bulk(test_ctx->tctx->dom, users, 2,
+                                 TEST_CACHE_TIMEOUT, TEST_NOW_1, &failed);
+    assert_int_equal(ret, EOK);
+    assert_int_equal(failed, 0);
+    talloc_free(users[0].attrs);
+    talloc_free(users[1].attrs);
+
+    /* The first user is renamed, the second one did not change */
+    bulk_test_user(&users[0], TEST_USER_NAME_3, TEST_USER_UID);
+    users[0].attrs = create_modstamp_attrs(test_ctx, TEST_MODSTAMP_2);
+    users[1].attrs = create_modstamp_attrs(test_ctx, TEST_MODSTAMP_1);
+    ret = sysdb_store_users_bulk(test_ctx->tctx->dom, users, 2,
+                                 TEST_CACHE_TIMEOUT, TEST_NOW_2, &failed);
+    assert_int_equal(ret, EOK);
+    assert_int_equal(failed, 0);
+    talloc_free(users[0].attrs);
+    talloc_free(users[1].attrs);
+
+    res = sysdb_getpwnam_res(test_ctx, test_ctx->tctx->dom, TEST_USER_NAME);
+    assert_int_equal(res->count, 0);
+    talloc_free(res);
+
+    res = sysdb_getpwnam_res(test_ctx, test_ctx->tctx->dom, TEST_USER_NAME_3);
+    assert_int_equal(res->count, 1);
+    assert_int_equal(ldb_msg_find_attr_as_uint(res->msgs[0],
+                                               SYSDB_UIDNUM, 0),
+                     TEST_USER_UID);
+    talloc_free(res);
+
+    res = sysdb_getpwnam_res(test_ctx, test_ctx->tctx->dom, TEST_USER_NAME_2);
+    assert_int_equal(res->count, 1);
+    talloc_free(res);
+}
+
+static void test_sysdb_users_bulk_duplicate_uid(void **state)
+{
+    int ret;
+    struct sysdb_ts_test_ctx *test_ctx = talloc_get_type_abort(*state,
+                                                     struct sysdb_ts_test_ctx);
+    struct sysdb_store_user_data users[2];
+    struct ldb_result *res;
+    size_t failed;
+
+    bulk_test_user(&users[0], TEST_USER_NAME, TEST_USER_UID);
+    users[0].attrs = create_modstamp_attrs(test_ctx, TEST_MODSTAMP_1);
+    ret = sysdb_store_users_bulk(test_ctx->tctx->dom, users, 1,
+                                 TEST_CACHE_TIMEOUT, TEST_NOW_1, &failed);
+    assert_int_equal(ret, EOK);
+    assert_int_equal(failed, 0);
+    talloc_free(users[0].attrs);
+
+    /* A new user takes the UID of the existing one, which is removed
+     * although it is still part of the batch and unchanged. The prefetched
+     * copy must not hide that, the result is the same as storing the users
+     * one by one: the last one wins. */
+    bulk_test_user(&users[0], TEST_USER_NAME_3, TEST_USER_UID);
+    bulk_test_user(&users[1], TEST_USER_NAME, TEST_USER_UID);
+    users[0].attrs = create_modstamp_attrs(test_ctx, TEST_MODSTAMP_1);
+    users[1].attrs = create_modstamp_attrs(test_ctx, TEST_MODSTAMP_1);
+    ret = sysdb_store_users_bulk(test_ctx->tctx->dom, users, 2,
+                                 TEST_CACHE_TIMEOUT, TEST_NOW_2, &failed);
+    assert_int_equal(ret, EOK);
+    assert_int_equal(failed, 0);
+    talloc_free(users[0].attrs);
+    talloc_free(users[1].attrs);
+
+    res = sysdb_getpwnam_res(test_ctx, test_ctx->tctx->dom, TEST_USER_NAME);
+    assert_int_equal(res->count, 1);
+    talloc_free(res);
+
+    res = sysdb_getpwnam_res(test_ctx, test_ctx->tctx->dom, TEST_USER_NAME_3);
+    assert_int_equal(res->count, 0);
+    talloc_free(res);
+}
+
+static void test_sysdb_groups_bulk(void **state)
+{
+    int ret;
+    struct sysdb_ts_test_ctx *test_ctx = talloc_get_type_abort(*state,
+                                                     struct sysdb_ts_test_ctx);
+    struct sysdb_store_group_data groups[2];
+    struct ldb_result *res;
+    uint64_t cache_expire_sysdb;
+    uint64_t cache_expire_ts;
+    size_t failed;
+
+    memset(groups, 0, sizeof(groups));
+    groups[0].name = TEST_GROUP_NAME;
+    groups[0].gid = TEST_GROUP_GID;
+    groups[1].name = TEST_GROUP_NAME_2;
+    groups[1].gid = TEST_GROUP_GID_2;
+
+    /* Both groups are new */
+    groups[0].attrs = create_modstamp_attrs(test_ctx, TEST_MODSTAMP_1);
+    groups[1].attrs = create_modstamp_attrs(test_ctx, TEST_MODSTAMP_1);
+    ret = sysdb_store_groups_bulk(test_ctx->tctx->dom, groups, 2,
+                                  TEST_CACHE_TIMEOUT, TEST_NOW_1, &failed);
+    assert_int_equal(ret, EOK);
+    assert_int_equal(failed, 0);
+
+    get_gr_timestamp_attrs(test_ctx, TEST_GROUP_NAME_2,
+                           &cache_expire_sysdb, &cache_expire_ts);
+    assert_int_equal(cache_expire_sysdb, TEST_CACHE_TIMEOUT + TEST_NOW_1);
+    assert_int_equal(cache_expire_ts, TEST_CACHE_TIMEOUT + TEST_NOW_1);
+
+    /* Same modifyTimestamp, only the timestamp cache is written */
+    talloc_free(groups[0].attrs);
+    talloc_free(groups[1].attrs);
+    groups[0].attrs = create_modstamp_attrs(test_ctx, TEST_MODSTAMP_1);
+    groups[1].attrs = create_modstamp_attrs(test_ctx, TEST_MODSTAMP_1);
+    ret = sysdb_store_groups_bulk(test_ctx->tctx->dom, groups, 2,
+                                  TEST_CACHE_TIMEOUT, TEST_NOW_2, &failed);
+    assert_int_equal(ret, EOK);
+    assert_int_equal(failed, 0);
+
+    get_gr_timestamp_attrs(test_ctx, TEST_GROUP_NAME,
+                           &cache_expire_sysdb, &cache_expire_ts);
+    assert_int_equal(cache_expire_sysdb, TEST_CACHE_TIMEOUT + TEST_NOW_1);
+    assert_int_equal(cache_expire_ts, TEST_CACHE_TIMEOUT + TEST_NOW_2);
+
+    /* New modifyTimestamp, but only the second group really changed */
+    talloc_free(groups[0].attrs);
+    talloc_free(groups[1].attrs);
+    groups[0].attrs = create_modstamp_attrs(test_ctx, TEST_MODSTAMP_2);
+    groups[1].attrs = create_modstamp_attrs(test_ctx, TEST_MODSTAMP_2);
+    ret = sysdb_attrs_add_string(groups[1].attrs, SYSDB_SID_STR,
+                                 TEST_GROUP_SID);
+    assert_int_equal(ret, EOK);
+    ret = sysdb_store_groups_bulk(test_ctx->tctx->dom, groups, 2,
+                                  TEST_CACHE_TIMEOUT, TEST_NOW_3, &failed);
+    assert_int_equal(ret, EOK);
+    assert_int_equal(failed, 0);
+
+    get_gr_timestamp_attrs(test_ctx, TEST_GROUP_NAME,
+                           &cache_expire_sysdb, &cache_expire_ts);
+    assert_int_equal(cache_expire_sysdb, TEST_CACHE_TIMEOUT + TEST_NOW_1);
+    assert_int_equal(cache_expire_ts, TEST_CACHE_TIMEOUT + TEST_NOW_3);
+
+    get_gr_timestamp_attrs(test_ctx, TEST_GROUP_NAME_2,
+                           &cache_expire_sysdb, &cache_expire_ts);
+    assert_int_equal(cache_expire_sysdb, TEST_CACHE_TIMEOUT + TEST_NOW_3);
+    assert_int_equal(cache_expire_ts, TEST_CACHE_TIMEOUT + TEST_NOW_3);
+
+    ret = sysdb_search_object_by_sid(test_ctx, test_ctx->tctx->dom,
+                                     TEST_GROUP_SID, NULL, &res);
+    assert_int_equal(ret, EOK);
+    assert_int_equal(res->count, 1);
+    talloc_free(res);
+
+    talloc_free(groups[0].attrs);
+    talloc_free(groups[1].attrs);
+}
+
+/* The files provider has no modifyTimestamp, it stores the same data again
+ * and relies on the comparison with the cached entry */
+static void test_sysdb_groups_bulk_unchanged(void **state)
+{
+    int ret;
+    struct sysdb_ts_test_ctx *test_ctx = talloc_get_type_abort(*state,
+                                                     struct sysdb_ts_test_ctx);
+    struct sysdb_store_group_data group;
+    struct ldb_result *res;
+    uint64_t cache_expire_sysdb;
+    uint64_t cache_expire_ts;
+    char **remove;
+    size_t failed;
+
+    memset(&group, 0, sizeof(group));
+    group.name = TEST_GROUP_NAME;
+    group.gid = TEST_GROUP_GID;
+
+    group.attrs = sysdb_new_attrs(test_ctx);
+    assert_non_null(group.attrs);
+    ret = sysdb_attrs_add_string(group.attrs, SYSDB_GHOST, TEST_USER_NAME);
+    assert_int_equal(ret, EOK);
+    ret = sysdb_store_groups_bulk(test_ctx->tctx->dom, &group, 1,
+                                  TEST_CACHE_TIMEOUT, TEST_NOW_1, &failed);
+    assert_int_equal(ret, EOK);
+    assert_int_equal(failed, 0);
+    talloc_free(group.attrs);
+
+    /* Same data, the entry is not rewritten */
+    group.attrs = sysdb_new_attrs(test_ctx);
+    assert_non_null(group.attrs);
+    ret = sysdb_attrs_add_string(group.attrs, SYSDB_GHOST, TEST_USER_NAME);
+    assert_int_equal(ret, EOK);
+    ret = sysdb_store_groups_bulk(test_ctx->tctx->dom, &group, 1,
+                                  TEST_CACHE_TIMEOUT, TEST_NOW_2, &failed);
+    assert_int_equal(ret, EOK);
+    assert_int_equal(failed, 0);
+    talloc_free(group.attrs);
+
+    get_gr_timestamp_attrs(test_ctx, TEST_GROUP_NAME,
+                           &cache_expire_sysdb, &cache_expire_ts);
+    assert_int_equal(cache_expire_sysdb, TEST_CACHE_TIMEOUT + TEST_NOW_1);
+    assert_int_equal(cache_expire_ts, TEST_CACHE_TIMEOUT + TEST_NOW_2);
+
+    /* The member is gone from the group, it is removed from the entry */
+    remove = talloc_zero_array(test_ctx, char *, 2);
+    assert_non_null(remove);
+    remove[0] = discard_const(SYSDB_GHOST);
+    group.attrs = sysdb_new_attrs(test_ctx);
+    assert_non_null(group.attrs);
+    group.remove_attrs = remove;
+    ret = sysdb_store_groups_bulk(test_ctx->tctx->dom, &group, 1,
+                                  TEST_CACHE_TIMEOUT, TEST_NOW_3, &failed);
+    assert_int_equal(ret, EOK);
+    assert_int_equal(failed, 0);
+    talloc_free(group.attrs);
+    talloc_free(remove);
+
+    ret = sysdb_getgrnam(test_ctx, test_ctx->tctx->dom, TEST_GROUP_NAME, &res);
+    assert_int_equal(ret, EOK);
+    assert_int_equal(res->count, 1);
+    assert_null(ldb_msg_find_element(res->msgs[0], SYSDB_GHOST));
+    talloc_free(res);
+}
+
 int main(int argc, const char *argv[])
 {
     int rv;
@@ -1660,6 +1998,21 @@ int main(int argc, const char *argv[])
         cmocka_unit_test_setup_teardown(test_sysdb_search_with_ts,
                                         test_sysdb_ts_setup,
                                         test_sysdb_ts_teardown),
+        cmocka_unit_test_setup_teardown(test_sysdb_users_bulk,
+                                        test_sysdb_ts_setup,
+                                        test_sysdb_ts_teardown),
+        cmocka_unit_test_setup_teardown(test_sysdb_users_bulk_rename,
+                                        test_sysdb_ts_setup,
+                                        test_sysdb_ts_teardown),
+        cmocka_unit_test_setup_teardown(test_sysdb_users_bulk_duplicate_uid,
+                                        test_sysdb_ts_setup,
+                                        test_sysdb_ts_teardown),
+        cmocka_unit_test_setup_teardown(test_sysdb_groups_bulk,
+                                        test_sysdb_ts_setup,
+                                        test_sysdb_ts_teardown),
+        cmocka_unit_test_setup_teardown(test_sysdb_groups_bulk_unchanged,
+                                        test_sysdb_ts_setup,
+                                        test_sysdb_ts_teardown),
     };
 
     /* Set debug level to invalid value so we can decide if -d 0 was used. */
@@ -715,6 +715,111 @@ static void test_sysdb_enumpwent_views(void **state)
     check_enumpwent(ret, test_ctx->domain, res, true);
 }
 
+static void test_sysdb_enumpwent_paged(void **state)
+{
+    int ret;
+    struct sysdb_test_ctx *test_ctx = talloc_get_type_abort(*state,
+                                                        struct sysdb_test_ctx);
+    struct ldb_result *dns;
+    struct ldb_result *page;
+    struct ldb_result *res;
+    size_t i;
+
+    ret = sysdb_enumpwent_dns(test_ctx, test_ctx->domain, &dns);
+    assert_int_equal(ret, EOK);
+    assert_int_equal(dns->count, N_ELEMENTS(users)-1);
+    for (i = 0; i < dns->count; i++) {
+        assert_null(ldb_msg_find_element(dns->msgs[i], SYSDB_GECOS));
+    }
+
+    /* Read the users in chunks of two. */
+    res = talloc_zero(test_ctx, struct ldb_result);
+    assert_non_null(res);
+    for (i = 0; i < dns->count; i += 2) {
+        ret = sysdb_enumpwent_by_dns_with_views(test_ctx, test_ctx->domain,
+                                                dns->msgs + i,
+                                                MIN(2, dns->count - i),
+                                                &page);
+        assert_int_equal(ret, EOK);
+
+        res->msgs = talloc_realloc(res, res->msgs, struct ldb_message *,
+                                   res->count + page->count);
+        assert_non_null(res->msgs);
+        memcpy(res->msgs + res->count, page->msgs,
+               page->count * sizeof(struct ldb_message *));
+        res->count += page->count;
+    }
+
+    check_enumpwent(EOK, test_ctx->domain, res, true);
+
+    /* Removed users are skipped. */
+    ret = sysdb_delete_user(test_ctx->domain,
+                            ldb_msg_find_attr_as_string(dns->msgs[0],
+                                                        SYSDB_NAME, NULL),
+                            0);
+    assert_int_equal(ret, EOK);
+
+    ret = sysdb_enumpwent_by_dns_with_views(test_ctx, test_ctx->domain,
+                                            dns->msgs, dns->count, &page);
+    assert_int_equal(ret, EOK);
+    assert_int_equal(page->count, dns->count - 1);
+}
+
+static void test_sysdb_enumpwent_paged_name_override(void **state)
+{
+    int ret;
+    struct sysdb_test_ctx *test_ctx = talloc_get_type_abort(*state,
+                                                        struct sysdb_test_ctx);
+    struct sysdb_attrs *attrs;
+    struct ldb_result *dns;
+    struct ldb_dn *dn;
+    const char *fqname;
+    const char *name;
+    const char *override_name;
+    size_t i;
+
+    fqname = sss_create_internal_fqname(test_ctx, "alice",
+                                        test_ctx->domain->name);
+    assert_non_null(fqname);
+
+    dn = sysdb_user_dn(test_ctx, test_ctx->domain, fqname);
+    assert_non_null(dn);
+
+    attrs = sysdb_new_attrs(test_ctx);
+    assert_non_null(attrs);
+
+    ret = sysdb_attrs_add_string(attrs, SYSDB_OVERRIDE_ANCHOR_UUID,
+                                 TEST_ANCHOR_PREFIX "alice");
+    assert_int_equal(ret, EOK);
+
+    ret = sysdb_attrs_add_string(attrs, SYSDB_NAME, "alice_override");
+    assert_int_equal(ret, EOK);
+
+    ret = sysdb_store_override(test_ctx->domain, TEST_VIEW_NAME,
+                               SYSDB_MEMBER_USER, attrs, dn);
+    assert_int_equal(ret, EOK);
+
+    /* The list already carries the overridden names, the rest of the
+     * override attributes is only read with the chunks. */
+    ret = sysdb_enumpwent_dns(test_ctx, test_ctx->domain, &dns);
+    assert_int_equal(ret, EOK);
+    assert_int_equal(dns->count, N_ELEMENTS(users)-1);
+    for (i = 0; i < dns->count; i++) {
+        name = ldb_msg_find_attr_as_string(dns->msgs[i], SYSDB_NAME, NULL);
+        assert_non_null(name);
+        override_name = ldb_msg_find_attr_as_string(dns->msgs[i],
+                                                    OVERRIDE_PREFIX SYSDB_NAME,
+                                                    NULL);
+        if (strcmp(name, fqname) == 0) {
+            assert_string_equal(override_name, "alice_override");
+        } else {
+            assert_null(override_name);
+        }
+        assert_null(ldb_msg_find_element(dns->msgs[i],
+                                         OVERRIDE_PREFIX SYSDB_GECOS));
+    }
+}
+
 static void test_sysdb_enumpwent_filter(void **state)
 {
     int ret;
@@ -957,6 +1062,22 @@ static void test_sysdb_enumgrent_views(void **state)
     check_enumgrent(ret, test_ctx->domain, res, true);
 }
 
+static void test_sysdb_enumgrent_paged(void **state)
+{
+    int ret;
+    struct sysdb_test_ctx *test_ctx = talloc_get_type_abort(*state,
+                                                        struct sysdb_test_ctx);
+    struct ldb_result *dns;
+    struct ldb_result *res;
+
+    ret = sysdb_enumgrent_dns(test_ctx, test_ctx->domain, &dns);
+    assert_int_equal(ret, EOK);
+
+    ret = sysdb_enumgrent_by_dns_with_views(test_ctx, test_ctx->domain,
+                                            dns->msgs, dns->count, &res);
+    check_enumgrent(ret, test_ctx->domain, res, true);
+}
+
 static void test_sysdb_enumgrent_filter(void **state)
 {
     int ret;
@@ -1081,6 +1202,12 @@ int main(int argc, const char *argv[])
         cmocka_unit_test_setup_teardown(test_sysdb_enumpwent_views,
                                         test_enum_users_setup,
                                         test_enum_users_teardown),
+        cmocka_unit_test_setup_teardown(test_sysdb_enumpwent_paged,
+                                        test_enum_users_setup,
+                                        test_enum_users_teardown),
+        cmocka_unit_test_setup_teardown(test_sysdb_enumpwent_paged_name_override,
+                                        test_enum_users_setup,
+                                        test_enum_users_teardown),
         cmocka_unit_test_setup_teardown(test_sysdb_enumpwent_filter,
                                         test_enum_users_setup,
                                         test_enum_users_teardown),
@@ -1093,6 +1220,9 @@ int main(int argc, const char *argv[])
         cmocka_unit_test_setup_teardown(test_sysdb_enumgrent_views,
                                         test_enum_groups_setup,
                                         test_enum_groups_teardown),
+        cmocka_unit_test_setup_teardown(test_sysdb_enumgrent_paged,
+                                        test_enum_groups_setup,
+                                        test_enum_groups_teardown),
         cmocka_unit_test_setup_teardown(test_sysdb_enumgrent_filter,
                                         test_enum_groups_setup,
                                         test_enum_groups_teardown),
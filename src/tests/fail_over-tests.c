@@ -55,10 +55,11 @@ struct task {
     int port;
     int new_server_status;
     int new_port_status;
+    uint32_t rtt_usec;
 };
 
 static struct test_ctx *
-setup_test(void)
+setup_test(enum fo_selection_policy selection_policy)
 {
     struct test_ctx *ctx;
     struct fo_options fopts;
@@ -82,6 +83,7 @@ setup_test(void)
     memset(&fopts, 0, sizeof(fopts));
     fopts.retry_timeout = 30;
     fopts.family_order  = IPV4_FIRST;
+    fopts.selection_policy = selection_policy;
 
     ctx->fo_ctx = fo_context_init(ctx, &fopts);
     if (ctx->fo_ctx == NULL) {
@@ -107,7 +109,7 @@ START_TEST(test_fo_new_service)
     struct fo_service *service;
     struct fo_service *services[10];
 
-    ctx = setup_test();
+    ctx = setup_test(FO_SELECTION_ORDER);
     ck_leaks_push(ctx);
 
     for (i = 0; i < 10; i++) {
@@ -172,6 +174,19 @@ test_resolve_service_callback(struct tevent_req *req)
     if (task->new_server_status >= 0)
         fo_set_server_status(server, task->new_server_status);
 
+    if (task->rtt_usec > 0) {
+        struct timeval start;
+
+        gettimeofday(&start, NULL);
+        start.tv_sec -= task->rtt_usec / 1000000;
+        start.tv_usec -= task->rtt_usec % 1000000;
+        if (start.tv_usec < 0) {
+            start.tv_sec--;
+            start.tv_usec += 1000000;
+        }
+        fo_server_add_rtt_sample(server, &start);
+    }
+
     if (fo_get_server_name(server) != NULL) {
         he = fo_get_server_hostent(server);
         fail_if(he == NULL, "fo_get_server_hostent() returned NULL");
@@ -193,12 +208,15 @@ test_resolve_service_callback(struct tevent_req *req)
 }
 
 #define get_request(a, b, c, d, e, f) \
-       _get_request(a, b, c, d, e, f, __location__)
+       _get_request(a, b, c, d, e, f, 0, __location__)
+
+#define get_request_rtt(a, b, c, d, e, f, g) \
+       _get_request(a, b, c, d, e, f, g, __location__)
 
 static void
 _get_request(struct test_ctx *test_ctx, struct fo_service *service,
              int expected_recv, int expected_port, int new_port_status,
-             int new_server_status, const char *location)
+             int new_server_status, uint32_t rtt_usec, const char *location)
 {
     struct tevent_req *req;
     struct task *task;
@@ -211,6 +229,7 @@ _get_request(struct test_ctx *test_ctx, struct fo_service *service,
     task->port = expected_port;
     task->new_port_status = new_port_status;
     task->new_server_status = new_server_status;
+    task->rtt_usec = rtt_usec;
     task->location = location;
     task->service = service;
     test_ctx->tasks++;
@@ -229,7 +248,7 @@ START_TEST(test_fo_resolve_service)
     struct test_ctx *ctx;
     struct fo_service *service[3];
 
-    ctx = setup_test();
+    ctx = setup_test(FO_SELECTION_ORDER);
     fail_if(ctx == NULL);
 
     /* Add service. */
@@ -268,6 +287,44 @@ START_TEST(test_fo_resolve_service)
 }
 END_TEST
 
+START_TEST(test_fo_resolve_service_latency)
+{
+    struct test_ctx *ctx;
+    struct fo_service *service;
+    int i;
+
+    ctx = setup_test(FO_SELECTION_LATENCY);
+    fail_if(ctx == NULL);
+
+    fail_if(fo_new_service(ctx->fo_ctx, "ldap", NULL, &service) != EOK);
+    fail_if(fo_add_server(service, "localhost", 1389, NULL, true) != EOK);
+    fail_if(fo_add_server(service, "127.0.0.1", 2389, NULL, true) != EOK);
+    fail_if(fo_add_server(service, "127.0.0.1", 3389, NULL, false) != EOK);
+
+    /* Servers without a round trip time are tried first, in order. */
+    get_request_rtt(ctx, service, EOK, 1389, PORT_WORKING, -1, 50000);
+    get_request_rtt(ctx, service, EOK, 2389, PORT_WORKING, -1, 5000);
+
+    /* The faster server is kept. */
+    get_request_rtt(ctx, service, EOK, 2389, -1, -1, 5000);
+    get_request_rtt(ctx, service, EOK, 2389, -1, -1, 5000);
+
+    /* It slows down, but it is used until the other one is
+     * significantly faster. */
+    for (i = 0; i < 7; i++) {
+        get_request_rtt(ctx, service, EOK, 2389, -1, -1, 100000);
+    }
+    get_request(ctx, service, EOK, 1389, -1, -1);
+
+    /* The backup server is only used when no primary server works. */
+    get_request(ctx, service, EOK, 1389, PORT_NOT_WORKING, -1);
+    get_request(ctx, service, EOK, 2389, PORT_NOT_WORKING, -1);
+    get_request(ctx, service, EOK, 3389, -1, -1);
+
+    talloc_free(ctx);
+}
+END_TEST
+
 Suite *
 create_suite(void)
 {
@@ -279,6 +336,7 @@ create_suite(void)
     /* Do some testing */
     tcase_add_test(tc, test_fo_new_service);
     tcase_add_test(tc, test_fo_resolve_service);
+    tcase_add_test(tc, test_fo_resolve_service_latency);
     if (use_net_test) {
     }
     /* Add all test cases to the test suite */
@@ -783,3 +783,115 @@ def test_ldap_auto_private_groups_enumerate(ldap_conn,
     with pytest.raises(KeyError):
         grp.getgrnam("conflict1")
     ent.assert_group_by_gid(1002, dict(name="user2", mem=ent.contains_only()))
+
+
+@pytest.fixture
+def paged_rfc2307(request, ldap_conn):
+    """
+    Create an RFC2307 directory fixture with more users than fit in one
+    page of the paged search
+    """
+    ent_list = ldap_ent.List(ldap_conn.ds_inst.base_dn)
+    for i in range(1, 8):
+        ent_list.add_user("user%d" % i, 1000 + i, 2000)
+    create_ldap_fixture(request, ldap_conn, ent_list)
+    conf = \
+        format_interactive_conf(ldap_conn, SCHEMA_RFC2307) + \
+        unindent("""
+            [domain/LDAP]
+            ldap_page_size                      = 2
+        """)
+    create_conf_fixture(request, conf)
+    create_sssd_fixture(request)
+
+
+def test_enumerate_paged(ldap_conn, paged_rfc2307):
+    """Test users saved page by page are all enumerated"""
+    time.sleep(INTERACTIVE_TIMEOUT)
+    ent.assert_passwd(ent.contains_only(
+        *[dict(name="user%d" % i, uid=1000 + i) for i in range(1, 8)]
+    ))
+
+
+def enable_syncprov(ldap_conn):
+    """Enable the syncprov overlay on the directory database"""
+    ds_inst = ldap_conn.ds_inst
+    config_conn = ldap.initialize(ds_inst.ldapi_url)
+    config_conn.simple_bind_s(ds_inst.admin_rdn + ",cn=config",
+                              ds_inst.admin_pw)
+    overlay_dn = "olcOverlay=syncprov,olcDatabase={1}hdb,cn=config"
+    try:
+        if config_conn.search_s(overlay_dn, ldap.SCOPE_BASE):
+            return
+    except ldap.NO_SUCH_OBJECT:
+        pass
+
+    try:
+        config_conn.modify_s("cn=module{0},cn=config",
+                             [(ldap.MOD_ADD, "olcModuleLoad", [b"syncprov"])])
+    except (ldap.TYPE_OR_VALUE_EXISTS, ldap.OTHER):
+        # built into slapd or already loaded
+        pass
+
+    config_conn.add_s(overlay_dn, [
+        ("objectClass", [b"olcOverlayConfig", b"olcSyncProvConfig"]),
+        ("olcOverlay", [b"syncprov"]),
+    ])
+    config_conn.unbind_s()
+
+
+def format_syncrepl_conf(ldap_conn, schema):
+    """
+    Format an SSSD configuration where changes are only picked up through
+    content synchronization, the periodic enumeration runs too rarely
+    """
+    return \
+        format_basic_conf(ldap_conn, schema) + \
+        unindent("""
+            [nss]
+            memcache_timeout                    = 0
+            enum_cache_timeout                  = 1
+            entry_negative_timeout              = 0
+
+            [domain/LDAP]
+            ldap_enumeration_syncrepl           = true
+            ldap_enumeration_refresh_timeout    = 3600
+            entry_cache_timeout                 = 3600
+        """)
+
+
+@pytest.fixture
+def blank_syncrepl_rfc2307(request, ldap_conn):
+    """
+    Create blank RFC2307 directory fixture with content synchronization
+    enabled on the server and in SSSD
+    """
+    try:
+        enable_syncprov(ldap_conn)
+    except ldap.LDAPError as err:
+        pytest.skip("syncprov overlay not available: %s" % err)
+    create_ldap_cleanup(request, ldap_conn)
+    create_conf_fixture(request,
+                        format_syncrepl_conf(ldap_conn, SCHEMA_RFC2307))
+    create_sssd_fixture(request)
+
+
+def test_syncrepl_add_remove(ldap_conn, blank_syncrepl_rfc2307):
+    """Test changes are picked up by content synchronization"""
+    user = ldap_ent.user(ldap_conn.ds_inst.base_dn, "user", 2001, 2000)
+    group = ldap_ent.group(ldap_conn.ds_inst.base_dn, "group", 2001)
+    time.sleep(INTERACTIVE_TIMEOUT)
+    ent.assert_passwd(ent.contains_only())
+    ent.assert_group(ent.contains_only())
+    # Add the entries
+    ldap_conn.add_s(*user)
+    ldap_conn.add_s(*group)
+    time.sleep(INTERACTIVE_TIMEOUT)
+    ent.assert_passwd(ent.contains_only(dict(name="user", uid=2001)))
+    ent.assert_group(ent.contains_only(dict(name="group", gid=2001)))
+    # Remove the entries
+    ldap_conn.delete_s(user[0])
+    ldap_conn.delete_s(group[0])
+    time.sleep(INTERACTIVE_TIMEOUT)
+    ent.assert_passwd(ent.contains_only())
+    ent.assert_group(ent.contains_only())
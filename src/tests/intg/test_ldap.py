@@ -2060,3 +2060,92 @@ def test_conflicting_mail_addresses(ldap_conn,
     # However resolving the users on their own must work
     ent.assert_passwd_by_name("userx", dict(name="userx", uid=1004, gid=2004))
     ent.assert_passwd_by_name("usery", dict(name="usery", uid=1005, gid=2005))
+
+
+@pytest.fixture
+def connection_pool_rfc2307(request, ldap_conn):
+    ent_list = ldap_ent.List(ldap_conn.ds_inst.base_dn)
+    for i in range(1, 21):
+        ent_list.add_user("pooluser%d" % i, 3000 + i, 4000)
+    ent_list.add_group("poolgroup", 4000)
+    for i in range(1, 201):
+        ent_list.add_group("poolbig%d" % i, 5000 + i, ["pooluser1"])
+    create_ldap_fixture(request, ldap_conn, ent_list)
+
+    conf = \
+        format_basic_conf(ldap_conn, SCHEMA_RFC2307) + \
+        unindent("""
+            ldap_connection_pool_size = 4
+        """)
+    create_conf_fixture(request, conf)
+    create_sssd_fixture(request)
+    return None
+
+
+def count_sssd_be_ldap_connections(port):
+    """Count the established connections from sssd_be to the given port"""
+    inodes = set()
+    for pid in os.listdir("/proc"):
+        if not pid.isdigit():
+            continue
+        try:
+            with open("/proc/%s/comm" % pid) as comm:
+                if comm.read().strip() != "sssd_be":
+                    continue
+            for fd in os.listdir("/proc/%s/fd" % pid):
+                target = os.readlink("/proc/%s/fd/%s" % (pid, fd))
+                if target.startswith("socket:["):
+                    inodes.add(target[8:-1])
+        except OSError:
+            continue
+
+    count = 0
+    for table in ("/proc/net/tcp", "/proc/net/tcp6"):
+        if not os.path.exists(table):
+            continue
+        with open(table) as f:
+            next(f)
+            for line in f:
+                fields = line.split()
+                rem_port = int(fields[2].split(":")[1], 16)
+                # 01 is TCP_ESTABLISHED
+                if rem_port == port and fields[3] == "01" and \
+                        fields[9] in inodes:
+                    count += 1
+    return count
+
+
+def lookup_pool_user(name):
+    """Resolve a user in a child process, exit with 0 on success"""
+    res, user = call_sssd_getpwnam(name)
+    os._exit(0 if res == NssReturnCode.SUCCESS else 1)
+
+
+def test_connection_pool(ldap_conn, connection_pool_rfc2307):
+    """
+    Concurrent lookups are spread over more than one connection to the
+    server and all of them are answered while a user with many groups is
+    being resolved.
+    """
+    children = []
+    pid = os.fork()
+    if pid == 0:
+        res, errno, gids = sssd_id.call_sssd_initgroups("pooluser1", 4000)
+        os._exit(0 if res == NssReturnCode.SUCCESS and len(gids) == 201
+                 else 1)
+    children.append(pid)
+
+    for i in range(2, 21):
+        pid = os.fork()
+        if pid == 0:
+            lookup_pool_user("pooluser%d" % i)
+        children.append(pid)
+
+    for pid in children:
+        _, status = os.waitpid(pid, 0)
+        assert os.WIFEXITED(status) and os.WEXITSTATUS(status) == 0
+
+    assert count_sssd_be_ldap_connections(ldap_conn.ds_inst.port) > 1
+
+    ent.assert_passwd_by_name("pooluser20", dict(name="pooluser20",
+                                                 uid=3020, gid=4000))
@@ -0,0 +1,323 @@
+/*
+   SSSD
+
+   memberof plugin benchmark
+
+   Copyright (C) 2026 Red Hat
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/* Compares the batched memberof plugin operation, which is the default,
+ * with the serial one selected by the memberof_serial ldb opaque. For each mode a fresh cache is filled
+ * with the requested number of users, then:
+ *  - wide: one group with all users as direct members is stored
+ *  - nest: a group containing the wide group is stored
+ *  - deep: a chain of nested groups is stored bottom-up, the innermost
+ *          group contains all users
+ *
+ * Run with LDB_MODULES_PATH pointing to the directory with the memberof
+ * module that was just built (ldb_mod_test_dir in the build directory). */
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <time.h>
+#include <talloc.h>
+#include <popt.h>
+
+#include "util/util.h"
+#include "db/sysdb.h"
+#include "tests/common.h"
+
+#define TESTS_PATH "tp_memberof_bench"
+#define TEST_CONF_DB "tests_conf.ldb"
+#define TEST_DOM_NAME "memberof_bench"
+#define TEST_ID_PROVIDER "ldap"
+
+#define DEFAULT_USERS 10000
+#define DEFAULT_DEPTH 20
+#define BENCH_UID_BASE 100000
+#define BENCH_GID_BASE 200000
+
+static double elapsed(struct timespec *start)
+{
+    struct timespec now;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+
+    return (now.tv_sec - start->tv_sec)
+               + (now.tv_nsec - start->tv_nsec) / 1e9;
+}
+
+static void report(const char *mode, const char *op,
+                   int entries, double secs)
+{
+    printf("%-6s %-8s %9d entries %8.3f s\n", mode, op, entries, secs);
+}
+
+static const char *bench_name(TALLOC_CTX *mem_ctx,
+                              struct sss_domain_info *dom,
+                              const char *prefix, int i)
+{
+    char *shortname;
+
+    shortname = talloc_asprintf(mem_ctx, "%s%d", prefix, i);
+    if (shortname == NULL) {
+        return NULL;
+    }
+
+    return sss_create_internal_fqname(mem_ctx, shortname, dom->name);
+}
+
+/* Store a group whose members are the groups or users with the given
+ * names. */
+static int bench_store_group(struct sss_domain_info *dom,
+                             const char *name, gid_t gid,
+                             const char **members, int num_members,
+                             bool groups)
+{
+    TALLOC_CTX *tmp_ctx;
+    struct sysdb_attrs *attrs;
+    char *dn;
+    int ret;
+    int i;
+
+    tmp_ctx = talloc_new(NULL);
+    if (tmp_ctx == NULL) {
+        return ENOMEM;
+    }
+
+    attrs = sysdb_new_attrs(tmp_ctx);
+    if (attrs == NULL) {
+        ret = ENOMEM;
+        goto done;
+    }
+
+    for (i = 0; i < num_members; i++) {
+        if (groups) {
+            dn = sysdb_group_strdn(attrs, dom->name, members[i]);
+        } else {
+            dn = sysdb_user_strdn(attrs, dom->name, members[i]);
+        }
+        if (dn == NULL) {
+            ret = ENOMEM;
+            goto done;
+        }
+
+        ret = sysdb_attrs_steal_string(attrs, SYSDB_MEMBER, dn);
+        if (ret != EOK) {
+            goto done;
+        }
+    }
+
+    ret = sysdb_transaction_start(dom->sysdb);
+    if (ret != EOK) {
+        goto done;
+    }
+
+    ret = sysdb_store_group(dom, name, gid, attrs, 0, time(NULL));
+    if (ret != EOK) {
+        sysdb_transaction_cancel(dom->sysdb);
+        goto done;
+    }
+
+    ret = sysdb_transaction_commit(dom->sysdb);
+
+done:
+    talloc_free(tmp_ctx);
+    return ret;
+}
+
+static int bench_mode(const char *mode, bool serial,
+                      int num_users, int depth)
+{
+    TALLOC_CTX *tmp_ctx;
+    struct sss_test_ctx *tctx;
+    struct sss_domain_info *dom;
+    struct timespec start;
+    const char **users;
+    const char *group;
+    const char *prev;
+    int ret;
+    int i;
+
+    tmp_ctx = talloc_new(NULL);
+    if (tmp_ctx == NULL) {
+        return ENOMEM;
+    }
+
+    test_dom_suite_setup(TESTS_PATH);
+
+    tctx = create_dom_test_ctx(tmp_ctx, TESTS_PATH, TEST_CONF_DB,
+                               TEST_DOM_NAME, TEST_ID_PROVIDER, NULL);
+    if (tctx == NULL) {
+        fprintf(stderr, "Unable to create the test cache\n");
+        ret = EIO;
+        goto done;
+    }
+    dom = tctx->dom;
+
+    if (serial) {
+        ret = ldb_set_opaque(sysdb_ctx_get_ldb(dom->sysdb),
+                             "memberof_serial", tctx);
+        if (ret != LDB_SUCCESS) {
+            ret = EIO;
+            goto done;
+        }
+    }
+
+    users = talloc_array(tmp_ctx, const char *, num_users);
+    if (users == NULL) {
+        ret = ENOMEM;
+        goto done;
+    }
+
+    ret = sysdb_transaction_start(dom->sysdb);
+    if (ret != EOK) {
+        goto done;
+    }
+
+    for (i = 0; i < num_users; i++) {
+        users[i] = bench_name(users, dom, "user", i);
+        if (users[i] == NULL) {
+            sysdb_transaction_cancel(dom->sysdb);
+            ret = ENOMEM;
+            goto done;
+        }
+
+        ret = sysdb_add_user(dom, users[i], BENCH_UID_BASE + i,
+                             BENCH_GID_BASE, NULL, NULL, NULL,
+                             NULL, NULL, 0, 0);
+        if (ret != EOK) {
+            sysdb_transaction_cancel(dom->sysdb);
+            goto done;
+        }
+    }
+
+    ret = sysdb_transaction_commit(dom->sysdb);
+    if (ret != EOK) {
+        goto done;
+    }
+
+    /* one group with all users */
+    group = bench_name(tmp_ctx, dom, "wide", 0);
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    ret = bench_store_group(dom, group, BENCH_GID_BASE, users, num_users,
+                            false);
+    if (ret != EOK) {
+        goto done;
+    }
+    report(mode, "wide", num_users, elapsed(&start));
+
+    /* a parent of the wide group, memberof is added to all users */
+    prev = group;
+    group = bench_name(tmp_ctx, dom, "nest", 0);
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    ret = bench_store_group(dom, group, BENCH_GID_BASE + 1, &prev, 1, true);
+    if (ret != EOK) {
+        goto done;
+    }
+    report(mode, "nest", num_users, elapsed(&start));
+
+    /* a chain of nested groups on top of a group with all users */
+    prev = bench_name(tmp_ctx, dom, "deep", 0);
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    ret = bench_store_group(dom, prev, BENCH_GID_BASE + 2,
+                            users, num_users, false);
+    for (i = 1; ret == EOK && i < depth; i++) {
+        group = bench_name(tmp_ctx, dom, "deep", i);
+        ret = bench_store_group(dom, group, BENCH_GID_BASE + 2 + i,
+                                &prev, 1, true);
+        prev = group;
+    }
+    if (ret != EOK) {
+        goto done;
+    }
+    report(mode, "deep", num_users * depth, elapsed(&start));
+
+    ret = EOK;
+
+done:
+    if (ret != EOK) {
+        fprintf(stderr, "%s mode failed [%d]: %s\n",
+                mode, ret, sss_strerror(ret));
+    }
+    talloc_free(tmp_ctx);
+    test_dom_suite_cleanup(TESTS_PATH, TEST_CONF_DB, TEST_DOM_NAME);
+    return ret;
+}
+
+int main(int argc, const char *argv[])
+{
+    int opt;
+    poptContext pc;
+    int pc_users = DEFAULT_USERS;
+    int pc_depth = DEFAULT_DEPTH;
+    char *pc_mode = NULL;
+    int failures = 0;
+    int ret;
+
+    struct poptOption long_options[] = {
+        POPT_AUTOHELP
+        { "users", 'u', POPT_ARG_INT | POPT_ARGFLAG_SHOW_DEFAULT,
+                    &pc_users, 0,
+                    "Number of users stored in the cache", NULL },
+        { "depth", 'n', POPT_ARG_INT | POPT_ARGFLAG_SHOW_DEFAULT,
+                    &pc_depth, 0,
+                    "Number of groups in the nested chain", NULL },
+        { "mode", 'm', POPT_ARG_STRING, &pc_mode, 0,
+                    "Only run the given mode (serial or batch)", NULL },
+        POPT_TABLEEND
+    };
+
+    /* parse the params */
+    pc = poptGetContext(argv[0], argc, argv, long_options, 0);
+    while ((opt = poptGetNextOpt(pc)) != -1) {
+        switch (opt) {
+            default:
+                fprintf(stderr, "\nInvalid option %s: %s\n\n",
+                        poptBadOption(pc, 0), poptStrerror(opt));
+                poptPrintUsage(pc, stderr, 0);
+                return 1;
+        }
+    }
+    poptFreeContext(pc);
+
+    if (pc_users <= 0 || pc_depth <= 0) {
+        fprintf(stderr, "The number of users and the depth must be "
+                        "positive\n");
+        return 1;
+    }
+
+    if (getenv("LDB_MODULES_PATH") == NULL) {
+        fprintf(stderr, "LDB_MODULES_PATH is not set, the installed "
+                        "memberof module will be used\n");
+    }
+
+    if (pc_mode == NULL || strcmp(pc_mode, "serial") == 0) {
+        ret = bench_mode("serial", true, pc_users, pc_depth);
+        if (ret != EOK) {
+            failures++;
+        }
+    }
+
+    if (pc_mode == NULL || strcmp(pc_mode, "batch") == 0) {
+        ret = bench_mode("batch", false, pc_users, pc_depth);
+        if (ret != EOK) {
+            failures++;
+        }
+    }
+
+    return (failures == 0 ? EXIT_SUCCESS : EXIT_FAILURE);
+}
@@ -0,0 +1,188 @@
+/*
+   SSSD
+
+   Negative cache backend benchmark
+
+   Copyright (C) 2026 Red Hat
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/* Compares the negative cache storage backends. Each backend is filled
+ * with the requested number of user entries, then all of them are looked
+ * up (hits), the same number of unknown names is looked up (misses) and
+ * finally the permanent entries are dropped. */
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <time.h>
+#include <talloc.h>
+#include <popt.h>
+
+#include "util/util.h"
+#include "responder/common/negcache_private.h"
+
+#define DEFAULT_ENTRIES 1000000
+#define BENCH_DOMAIN "bench.example.com"
+
+static double elapsed(struct timespec *start)
+{
+    struct timespec now;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+
+    return (now.tv_sec - start->tv_sec)
+               + (now.tv_nsec - start->tv_nsec) / 1e9;
+}
+
+static void report(const char *backend, const char *op,
+                   int entries, double secs)
+{
+    printf("%-5s %-16s %9d ops %8.3f s %10.0f ops/s\n",
+           backend, op, entries, secs, entries / secs);
+}
+
+static int bench_backend(const struct sss_nc_backend *be, int entries)
+{
+    TALLOC_CTX *tmp_ctx;
+    struct sss_nc_key key = { SSS_NC_KEY_USER, BENCH_DOMAIN, NULL, 0 };
+    struct timespec start;
+    char name[64];
+    void *pvt;
+    time_t now;
+    int ret;
+    int i;
+
+    tmp_ctx = talloc_new(NULL);
+    if (tmp_ctx == NULL) {
+        return ENOMEM;
+    }
+
+    ret = be->init(tmp_ctx, &pvt);
+    if (ret != EOK) {
+        fprintf(stderr, "Unable to initialize backend %s [%d]: %s\n",
+                be->name, ret, sss_strerror(ret));
+        goto done;
+    }
+
+    key.name = name;
+    now = time(NULL);
+
+    /* every fourth entry is permanent, like filter_users entries */
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (i = 0; i < entries; i++) {
+        snprintf(name, sizeof(name), "user%d@" BENCH_DOMAIN, i);
+        ret = be->set(pvt, &key, now, i % 4 == 0 ? 0 : now + 3600);
+        if (ret != EOK) {
+            fprintf(stderr, "set failed [%d]: %s\n", ret, sss_strerror(ret));
+            goto done;
+        }
+    }
+    report(be->name, "insert", entries, elapsed(&start));
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (i = 0; i < entries; i++) {
+        snprintf(name, sizeof(name), "user%d@" BENCH_DOMAIN, i);
+        ret = be->check(pvt, &key, now);
+        if (ret != EEXIST) {
+            fprintf(stderr, "expected hit for [%s]\n", name);
+            ret = EINVAL;
+            goto done;
+        }
+    }
+    report(be->name, "check hit", entries, elapsed(&start));
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (i = 0; i < entries; i++) {
+        snprintf(name, sizeof(name), "missing%d@" BENCH_DOMAIN, i);
+        ret = be->check(pvt, &key, now);
+        if (ret != ENOENT) {
+            fprintf(stderr, "expected miss for [%s]\n", name);
+            ret = EINVAL;
+            goto done;
+        }
+    }
+    report(be->name, "check miss", entries, elapsed(&start));
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    ret = be->reset_permanent(pvt);
+    if (ret != EOK) {
+        fprintf(stderr, "reset failed [%d]: %s\n", ret, sss_strerror(ret));
+        goto done;
+    }
+    report(be->name, "reset permanent", entries, elapsed(&start));
+
+    ret = EOK;
+
+done:
+    talloc_free(tmp_ctx);
+    return ret;
+}
+
+int main(int argc, const char *argv[])
+{
+    int opt;
+    poptContext pc;
+    int pc_entries = DEFAULT_ENTRIES;
+    char *pc_backend = NULL;
+    const struct sss_nc_backend *backends[] = {
+        &sss_nc_backend_hash,
+        &sss_nc_backend_tdb,
+        NULL
+    };
+    int failures = 0;
+    int ret;
+    int i;
+
+    struct poptOption long_options[] = {
+        POPT_AUTOHELP
+        { "entries", 'n', POPT_ARG_INT | POPT_ARGFLAG_SHOW_DEFAULT,
+                    &pc_entries, 0,
+                    "Number of entries stored in the cache", NULL },
+        { "backend", 'b', POPT_ARG_STRING, &pc_backend, 0,
+                    "Only run the given backend (hash or tdb)", NULL },
+        POPT_TABLEEND
+    };
+
+    /* parse the params */
+    pc = poptGetContext(argv[0], argc, argv, long_options, 0);
+    while ((opt = poptGetNextOpt(pc)) != -1) {
+        switch (opt) {
+            default:
+                fprintf(stderr, "\nInvalid option %s: %s\n\n",
+                        poptBadOption(pc, 0), poptStrerror(opt));
+                poptPrintUsage(pc, stderr, 0);
+                return 1;
+        }
+    }
+    poptFreeContext(pc);
+
+    if (pc_entries <= 0) {
+        fprintf(stderr, "The number of entries must be positive\n");
+        return 1;
+    }
+
+    for (i = 0; backends[i] != NULL; i++) {
+        if (pc_backend != NULL && strcmp(pc_backend, backends[i]->name) != 0) {
+            continue;
+        }
+
+        ret = bench_backend(backends[i], pc_entries);
+        if (ret != EOK) {
+            failures++;
+        }
+    }
+
+    return (failures == 0 ? EXIT_SUCCESS : EXIT_FAILURE);
+}
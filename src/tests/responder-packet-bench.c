@@ -0,0 +1,575 @@
+/*
+   SSSD
+
+   Responder packet benchmark
+
+   Copyright (C) 2026 Red Hat
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/* Drives the NSS protocol of the responder packet layer with synthetic
+ * clients. Each client is a child process sending getgrnam requests over
+ * its own socket, the server answers all of them from a tevent loop with a
+ * group of the requested size, encoded in one of the modes:
+ *  - plain:   a new packet for every request, the members are appended
+ *             one by one
+ *  - pool:    the packets of all clients reuse buffers of one pool, the
+ *             member list is built at once and copied into the packet
+ *  - scatter: like pool, but the member list is sent after the packet
+ *             with the same writev() call instead of being copied */
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <time.h>
+#include <sys/socket.h>
+#include <sys/wait.h>
+#include <talloc.h>
+#include <tevent.h>
+#include <popt.h>
+
+#include "util/util.h"
+#include "responder/common/responder_packet.h"
+
+#define DEFAULT_CLIENTS 4
+#define DEFAULT_REQUESTS 1000
+#define DEFAULT_MEMBERS 1000
+#define BENCH_GROUP "benchgroup@bench"
+#define BENCH_GID 200000
+
+enum bench_mode {
+    BENCH_PLAIN,
+    BENCH_POOL,
+    BENCH_SCATTER,
+};
+
+static const char *bench_mode_names[] = { "plain", "pool", "scatter" };
+
+static double elapsed(struct timespec *start)
+{
+    struct timespec now;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+
+    return (now.tv_sec - start->tv_sec)
+               + (now.tv_nsec - start->tv_nsec) / 1e9;
+}
+
+static void report(const char *mode, int requests, double secs)
+{
+    printf("%-7s %9d requests %8.3f s %10.1f us/request\n",
+           mode, requests, secs, secs * 1e6 / requests);
+}
+
+/* client side, runs in a child process with blocking I/O */
+
+static int bench_client(int fd, int requests, int members)
+{
+    uint8_t req[SSS_NSS_HEADER_SIZE + sizeof(BENCH_GROUP)];
+    uint32_t header[4];
+    uint32_t num_results;
+    uint32_t num_members;
+    uint8_t *reply = NULL;
+    size_t reply_size = 0;
+    ssize_t len;
+    int i;
+
+    header[0] = sizeof(req);
+    header[1] = SSS_NSS_GETGRNAM;
+    header[2] = 0;
+    header[3] = 0;
+    memcpy(req, header, SSS_NSS_HEADER_SIZE);
+    memcpy(req + SSS_NSS_HEADER_SIZE, BENCH_GROUP, sizeof(BENCH_GROUP));
+
+    for (i = 0; i < requests; i++) {
+        len = sss_atomic_write_s(fd, req, sizeof(req));
+        if (len != sizeof(req)) {
+            return EIO;
+        }
+
+        len = sss_atomic_read_s(fd, (uint8_t *)header, SSS_NSS_HEADER_SIZE);
+        if (len != SSS_NSS_HEADER_SIZE || header[0] < SSS_NSS_HEADER_SIZE) {
+            return EIO;
+        }
+
+        if (header[0] > reply_size) {
+            free(reply);
+            reply_size = header[0];
+            reply = malloc(reply_size);
+            if (reply == NULL) {
+                return ENOMEM;
+            }
+        }
+
+        len = header[0] - SSS_NSS_HEADER_SIZE;
+        if (sss_atomic_read_s(fd, reply, len) != len || header[2] != EOK) {
+            free(reply);
+            return EIO;
+        }
+
+        /* num_results, reserved, gid, num_members, ... */
+        SAFEALIGN_COPY_UINT32(&num_results, reply, NULL);
+        SAFEALIGN_COPY_UINT32(&num_members, reply + 3 * sizeof(uint32_t),
+                              NULL);
+        if (num_results != 1 || num_members != members) {
+            free(reply);
+            return EIO;
+        }
+    }
+
+    free(reply);
+    return EOK;
+}
+
+/* server side */
+
+struct bench_ctx {
+    struct tevent_context *ev;
+    enum bench_mode mode;
+    struct sss_packet_pool *pool;
+
+    const char **members;
+    size_t *members_len;
+    int num_members;
+    size_t members_size;
+
+    int active;
+    errno_t ret;
+};
+
+struct bench_request {
+    struct sss_packet *in;
+    struct sss_packet *out;
+};
+
+struct bench_client {
+    struct bench_ctx *bctx;
+    struct bench_request *req;
+    struct tevent_fd *fde;
+    int fd;
+};
+
+static int bench_client_destructor(struct bench_client *client)
+{
+    client->bctx->active--;
+    close(client->fd);
+    return 0;
+}
+
+static errno_t bench_fill_group(struct bench_ctx *bctx,
+                                struct sss_packet *packet)
+{
+    struct sized_string name;
+    struct sized_string pwfield;
+    uint8_t *members = NULL;
+    uint8_t *body;
+    size_t body_len;
+    size_t rp;
+    size_t mp;
+    errno_t ret;
+    int i;
+
+    to_sized_string(&name, BENCH_GROUP);
+    to_sized_string(&pwfield, "*");
+
+    if (bctx->mode != BENCH_PLAIN) {
+        ret = sss_packet_reserve(packet, 4 * sizeof(uint32_t) + name.len
+                                         + pwfield.len
+                                         + (bctx->mode == BENCH_POOL
+                                                ? bctx->members_size : 0));
+        if (ret != EOK) {
+            return ret;
+        }
+
+        members = talloc_size(packet, bctx->members_size);
+        if (members == NULL) {
+            return ENOMEM;
+        }
+
+        mp = 0;
+        for (i = 0; i < bctx->num_members; i++) {
+            safealign_memcpy(&members[mp], bctx->members[i],
+                             bctx->members_len[i], &mp);
+        }
+    }
+
+    ret = sss_packet_grow(packet, 4 * sizeof(uint32_t) + name.len
+                                  + pwfield.len);
+    if (ret != EOK) {
+        return ret;
+    }
+
+    sss_packet_get_body(packet, &body, &body_len);
+    rp = 0;
+    SAFEALIGN_SETMEM_UINT32(&body[rp], 1, &rp);
+    SAFEALIGN_SETMEM_UINT32(&body[rp], 0, &rp);
+    SAFEALIGN_SETMEM_UINT32(&body[rp], BENCH_GID, &rp);
+    SAFEALIGN_SETMEM_UINT32(&body[rp], bctx->num_members, &rp);
+    SAFEALIGN_SET_STRING(&body[rp], name.str, name.len, &rp);
+    SAFEALIGN_SET_STRING(&body[rp], pwfield.str, pwfield.len, &rp);
+
+    switch (bctx->mode) {
+    case BENCH_PLAIN:
+        for (i = 0; i < bctx->num_members; i++) {
+            ret = sss_packet_grow(packet, bctx->members_len[i]);
+            if (ret != EOK) {
+                return ret;
+            }
+
+            sss_packet_get_body(packet, &body, &body_len);
+            SAFEALIGN_SET_STRING(&body[rp], bctx->members[i],
+                                 bctx->members_len[i], &rp);
+        }
+        break;
+    case BENCH_POOL:
+        ret = sss_packet_grow(packet, bctx->members_size);
+        if (ret != EOK) {
+            return ret;
+        }
+
+        sss_packet_get_body(packet, &body, &body_len);
+        safealign_memcpy(&body[rp], members, bctx->members_size, &rp);
+        talloc_free(members);
+        break;
+    case BENCH_SCATTER:
+        ret = sss_packet_set_tail(packet, members, bctx->members_size);
+        if (ret != EOK) {
+            return ret;
+        }
+        break;
+    }
+
+    sss_packet_set_error(packet, EOK);
+    return EOK;
+}
+
+static void bench_client_recv(struct bench_client *client)
+{
+    struct bench_ctx *bctx = client->bctx;
+    struct sss_packet_pool *pool;
+    errno_t ret;
+
+    pool = bctx->mode == BENCH_PLAIN ? NULL : bctx->pool;
+
+    if (client->req == NULL) {
+        client->req = talloc_zero(client, struct bench_request);
+        if (client->req == NULL) {
+            ret = ENOMEM;
+            goto fail;
+        }
+
+        ret = sss_packet_new_pooled(client->req, pool,
+                                    SSS_PACKET_MAX_RECV_SIZE, 0,
+                                    &client->req->in);
+        if (ret != EOK) {
+            goto fail;
+        }
+    }
+
+    ret = sss_packet_recv(client->req->in, client->fd);
+    switch (ret) {
+    case EOK:
+        break;
+    case EAGAIN:
+        return;
+    case ENODATA:
+        /* the client sent all its requests */
+        talloc_free(client);
+        return;
+    default:
+        goto fail;
+    }
+
+    ret = sss_packet_new_pooled(client->req, pool, 0,
+                                sss_packet_get_cmd(client->req->in),
+                                &client->req->out);
+    if (ret != EOK) {
+        goto fail;
+    }
+
+    ret = bench_fill_group(bctx, client->req->out);
+    if (ret != EOK) {
+        goto fail;
+    }
+
+    TEVENT_FD_NOT_READABLE(client->fde);
+    TEVENT_FD_WRITEABLE(client->fde);
+    return;
+
+fail:
+    bctx->ret = ret;
+    talloc_free(client);
+}
+
+static void bench_client_send(struct bench_client *client)
+{
+    errno_t ret;
+
+    ret = sss_packet_send(client->req->out, client->fd);
+    if (ret == EAGAIN) {
+        return;
+    }
+    if (ret != EOK) {
+        client->bctx->ret = ret;
+        talloc_free(client);
+        return;
+    }
+
+    TEVENT_FD_NOT_WRITEABLE(client->fde);
+    TEVENT_FD_READABLE(client->fde);
+    talloc_zfree(client->req);
+}
+
+static void bench_client_handler(struct tevent_context *ev,
+                                 struct tevent_fd *fde,
+                                 uint16_t flags, void *ptr)
+{
+    struct bench_client *client;
+
+    client = talloc_get_type(ptr, struct bench_client);
+
+    if (flags & TEVENT_FD_WRITE) {
+        bench_client_send(client);
+        return;
+    }
+
+    if (flags & TEVENT_FD_READ) {
+        bench_client_recv(client);
+        return;
+    }
+}
+
+static errno_t bench_add_client(struct bench_ctx *bctx, int fd)
+{
+    struct bench_client *client;
+    errno_t ret;
+
+    client = talloc_zero(bctx, struct bench_client);
+    if (client == NULL) {
+        close(fd);
+        return ENOMEM;
+    }
+
+    client->bctx = bctx;
+    client->fd = fd;
+    bctx->active++;
+    talloc_set_destructor(client, bench_client_destructor);
+
+    ret = sss_fd_nonblocking(fd);
+    if (ret != EOK) {
+        talloc_free(client);
+        return ret;
+    }
+
+    client->fde = tevent_add_fd(bctx->ev, client, fd, TEVENT_FD_READ,
+                                bench_client_handler, client);
+    if (client->fde == NULL) {
+        talloc_free(client);
+        return ENOMEM;
+    }
+
+    return EOK;
+}
+
+static errno_t bench_members(struct bench_ctx *bctx, int num_members)
+{
+    int i;
+
+    bctx->members = talloc_array(bctx, const char *, num_members);
+    bctx->members_len = talloc_array(bctx, size_t, num_members);
+    if (bctx->members == NULL || bctx->members_len == NULL) {
+        return ENOMEM;
+    }
+
+    bctx->num_members = num_members;
+    bctx->members_size = 0;
+    for (i = 0; i < num_members; i++) {
+        bctx->members[i] = talloc_asprintf(bctx->members, "user%d@bench", i);
+        if (bctx->members[i] == NULL) {
+            return ENOMEM;
+        }
+
+        bctx->members_len[i] = strlen(bctx->members[i]) + 1;
+        bctx->members_size += bctx->members_len[i];
+    }
+
+    return EOK;
+}
+
+static int bench_mode(enum bench_mode mode, int clients, int requests,
+                      int members)
+{
+    TALLOC_CTX *tmp_ctx;
+    struct bench_ctx *bctx;
+    struct timespec start;
+    int sv[2];
+    pid_t pid;
+    int status;
+    int failed;
+    int ret;
+    int i;
+
+    tmp_ctx = talloc_new(NULL);
+    if (tmp_ctx == NULL) {
+        return ENOMEM;
+    }
+
+    bctx = talloc_zero(tmp_ctx, struct bench_ctx);
+    if (bctx == NULL) {
+        ret = ENOMEM;
+        goto done;
+    }
+    bctx->mode = mode;
+
+    bctx->ev = tevent_context_init(bctx);
+    if (bctx->ev == NULL) {
+        ret = ENOMEM;
+        goto done;
+    }
+
+    ret = bench_members(bctx, members);
+    if (ret != EOK) {
+        goto done;
+    }
+
+    ret = sss_packet_pool_new(bctx, &bctx->pool);
+    if (ret != EOK) {
+        goto done;
+    }
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (i = 0; i < clients; i++) {
+        if (socketpair(AF_UNIX, SOCK_STREAM, 0, sv) == -1) {
+            ret = errno;
+            goto done;
+        }
+
+        pid = fork();
+        if (pid == -1) {
+            ret = errno;
+            close(sv[0]);
+            close(sv[1]);
+            goto done;
+        }
+
+        if (pid == 0) {
+            close(sv[0]);
+            ret = bench_client(sv[1], requests, members);
+            _exit(ret == EOK ? 0 : 1);
+        }
+
+        close(sv[1]);
+        ret = bench_add_client(bctx, sv[0]);
+        if (ret != EOK) {
+            goto done;
+        }
+    }
+
+    while (bctx->active > 0) {
+        if (tevent_loop_once(bctx->ev) != 0) {
+            ret = EIO;
+            goto done;
+        }
+    }
+
+    ret = bctx->ret;
+    if (ret != EOK) {
+        goto done;
+    }
+    report(bench_mode_names[mode], clients * requests, elapsed(&start));
+
+done:
+    /* closes the remaining server sockets so that the clients finish */
+    talloc_free(tmp_ctx);
+
+    failed = 0;
+    while ((pid = wait(&status)) != -1) {
+        if (!WIFEXITED(status) || WEXITSTATUS(status) != 0) {
+            failed++;
+        }
+    }
+    if (ret == EOK && failed > 0) {
+        ret = EIO;
+    }
+
+    if (ret != EOK) {
+        fprintf(stderr, "%s mode failed [%d]: %s\n",
+                bench_mode_names[mode], ret, sss_strerror(ret));
+    }
+    return ret;
+}
+
+int main(int argc, const char *argv[])
+{
+    int opt;
+    poptContext pc;
+    int pc_clients = DEFAULT_CLIENTS;
+    int pc_requests = DEFAULT_REQUESTS;
+    int pc_members = DEFAULT_MEMBERS;
+    char *pc_mode = NULL;
+    int failures = 0;
+    int ret;
+    int i;
+
+    struct poptOption long_options[] = {
+        POPT_AUTOHELP
+        { "clients", 'c', POPT_ARG_INT | POPT_ARGFLAG_SHOW_DEFAULT,
+                    &pc_clients, 0,
+                    "Number of concurrent clients", NULL },
+        { "requests", 'n', POPT_ARG_INT | POPT_ARGFLAG_SHOW_DEFAULT,
+                    &pc_requests, 0,
+                    "Number of requests sent by each client", NULL },
+        { "members", 'u', POPT_ARG_INT | POPT_ARGFLAG_SHOW_DEFAULT,
+                    &pc_members, 0,
+                    "Number of members of the returned group", NULL },
+        { "mode", 'm', POPT_ARG_STRING, &pc_mode, 0,
+                    "Only run the given mode (plain, pool or scatter)", NULL },
+        POPT_TABLEEND
+    };
+
+    /* parse the params */
+    pc = poptGetContext(argv[0], argc, argv, long_options, 0);
+    while ((opt = poptGetNextOpt(pc)) != -1) {
+        switch (opt) {
+            default:
+                fprintf(stderr, "\nInvalid option %s: %s\n\n",
+                        poptBadOption(pc, 0), poptStrerror(opt));
+                poptPrintUsage(pc, stderr, 0);
+                return 1;
+        }
+    }
+    poptFreeContext(pc);
+
+    if (pc_clients <= 0 || pc_requests <= 0 || pc_members < 0) {
+        fprintf(stderr, "The number of clients and requests must be "
+                        "positive\n");
+        return 1;
+    }
+
+    /* a client dying early must not terminate the benchmark */
+    signal(SIGPIPE, SIG_IGN);
+
+    for (i = BENCH_PLAIN; i <= BENCH_SCATTER; i++) {
+        if (pc_mode != NULL && strcmp(pc_mode, bench_mode_names[i]) != 0) {
+            continue;
+        }
+
+        ret = bench_mode(i, pc_clients, pc_requests, pc_members);
+        if (ret != EOK) {
+            failures++;
+        }
+    }
+
+    return (failures == 0 ? EXIT_SUCCESS : EXIT_FAILURE);
+}
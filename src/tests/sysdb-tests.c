@@ -67,6 +67,10 @@ struct sysdb_test_ctx {
     size_t null_pointer_size;
 };
 
+/* Set by the fixture of the serial memberof tests, see the memberof
+ * plugin. */
+static bool memberof_serial;
+
 static int _setup_sysdb_tests(struct sysdb_test_ctx **ctx, bool enumerate)
 {
     struct sysdb_test_ctx *test_ctx;
@@ -161,6 +165,16 @@ static int _setup_sysdb_tests(struct sysdb_test_ctx **ctx, bool enumerate)
     }
     test_ctx->sysdb = test_ctx->domain->sysdb;
 
+    if (memberof_serial) {
+        ret = ldb_set_opaque(sysdb_ctx_get_ldb(test_ctx->sysdb),
+                             "memberof_serial", test_ctx);
+        if (ret != LDB_SUCCESS) {
+            fail("Could not set the memberof_serial opaque");
+            talloc_free(test_ctx);
+            return EIO;
+        }
+    }
+
     test_ctx->null_pointer_size = talloc_total_size(NULL);
 
     *ctx = test_ctx;
@@ -2192,6 +2206,54 @@ START_TEST (test_sysdb_cache_password_ex)
 }
 END_TEST
 
+START_TEST (test_sysdb_cache_password_rounds)
+{
+    struct sysdb_test_ctx *test_ctx;
+    struct test_data *data;
+    int ret;
+    struct ldb_result *res;
+    const char *attrs[] = { SYSDB_CACHEDPWD, NULL };
+    const char *hash;
+    time_t expire_date = -1;
+    time_t delayed_until = -1;
+    const char *val[] = { "0", NULL };
+
+    /* Setup */
+    ret = setup_sysdb_tests(&test_ctx);
+    fail_unless(ret == EOK, "Could not set up the test");
+
+    data = test_data_new_user(test_ctx, _i);
+    fail_if(data == NULL, "OOM\n");
+
+    ret = confdb_add_param(test_ctx->confdb, true, CONFDB_PAM_CONF_ENTRY,
+                           CONFDB_PAM_CRED_TIMEOUT, val);
+    fail_unless(ret == EOK, "Could not set offline credentials expiration");
+
+    test_ctx->domain->cache_credentials_hash_rounds = 2000;
+    ret = sysdb_cache_password(test_ctx->domain, data->username,
+                               data->username);
+    test_ctx->domain->cache_credentials_hash_rounds = 0;
+    fail_unless(ret == EOK, "sysdb_cache_password request failed [%d].", ret);
+
+    ret = sysdb_get_user_attr(test_ctx, test_ctx->domain, data->username,
+                              attrs, &res);
+    fail_unless(ret == EOK, "sysdb_get_user_attr request failed [%d].", ret);
+
+    hash = ldb_msg_find_attr_as_string(res->msgs[0], SYSDB_CACHEDPWD, NULL);
+    fail_if(hash == NULL, "Missing cached password");
+    fail_unless(strncmp(hash, "$6$rounds=2000$", 15) == 0,
+                "Unexpected cached password hash [%s].", hash);
+
+    /* The rounds are taken from the stored hash. */
+    ret = sysdb_cache_auth(test_ctx->domain, data->username, data->username,
+                           test_ctx->confdb, false,
+                           &expire_date, &delayed_until);
+    fail_unless(ret == EOK, "sysdb_cache_auth request failed [%d].", ret);
+
+    talloc_free(test_ctx);
+}
+END_TEST
+
 static void cached_authentication_without_expiration(uid_t uid,
                                                      const char *password,
                                                      int expected_result)
@@ -7784,6 +7846,17 @@ START_TEST(test_sysdb_add_ipnetworks)
 }
 END_TEST
 
+/* The unchecked fixture runs in the parent process, the flag is inherited
+ * by the forked tests. */
+static void memberof_serial_setup(void)
+{
+    memberof_serial = true;
+}
+
+static void memberof_serial_teardown(void)
+{
+    memberof_serial = false;
+}
 
 Suite *create_sysdb_suite(void)
 {
@@ -7897,6 +7970,8 @@ Suite *create_sysdb_suite(void)
     tcase_add_loop_test(tc_sysdb, test_sysdb_cached_authentication, 27010, 27011);
 
     tcase_add_loop_test(tc_sysdb, test_sysdb_cache_password_ex, 27010, 27011);
+    tcase_add_loop_test(tc_sysdb, test_sysdb_cache_password_rounds,
+                        27010, 27011);
 
     /* ASQ search test */
     tcase_add_loop_test(tc_sysdb, test_sysdb_prepare_asq_test_user, 28011, 28020);
@@ -8177,6 +8252,47 @@ Suite *create_sysdb_suite(void)
                         MBO_GROUP_BASE , MBO_GROUP_BASE + 10);
     suite_add_tcase(s, tc_memberof);
 
+    TCase *tc_memberof_serial = tcase_create("SYSDB serial memberof Tests");
+    tcase_add_unchecked_fixture(tc_memberof_serial,
+                                memberof_serial_setup,
+                                memberof_serial_teardown);
+
+    tcase_add_loop_test(tc_memberof_serial, test_sysdb_memberof_store_group,
+                        0, 10);
+    tcase_add_loop_test(tc_memberof_serial, test_sysdb_memberof_store_user,
+                        0, 10);
+    tcase_add_loop_test(tc_memberof_serial,
+                        test_sysdb_memberof_add_group_member, 0, 10);
+    tcase_add_loop_test(tc_memberof_serial,
+                        test_sysdb_memberof_check_memberuid, 0, 10);
+    tcase_add_loop_test(tc_memberof_serial,
+                        test_sysdb_remove_local_group_by_gid,
+                        MBO_GROUP_BASE , MBO_GROUP_BASE + 10);
+
+    tcase_add_loop_test(tc_memberof_serial, test_sysdb_memberof_store_group,
+                        0, 10);
+    tcase_add_test(tc_memberof_serial, test_sysdb_memberof_close_loop);
+    tcase_add_loop_test(tc_memberof_serial, test_sysdb_memberof_store_user,
+                        0, 10);
+    tcase_add_loop_test(tc_memberof_serial,
+                        test_sysdb_memberof_add_group_member, 0, 10);
+    tcase_add_loop_test(tc_memberof_serial,
+                        test_sysdb_memberof_check_memberuid_loop, 0, 10);
+    tcase_add_loop_test(tc_memberof_serial,
+                        test_sysdb_remove_local_group_by_gid,
+                        MBO_GROUP_BASE , MBO_GROUP_BASE + 10);
+
+    tcase_add_loop_test(tc_memberof_serial,
+                        test_sysdb_memberof_store_group_with_ghosts,
+                        MBO_GROUP_BASE , MBO_GROUP_BASE + 10);
+    tcase_add_loop_test(tc_memberof_serial,
+                        test_sysdb_memberof_check_nested_ghosts,
+                        MBO_GROUP_BASE , MBO_GROUP_BASE + 10);
+    tcase_add_loop_test(tc_memberof_serial,
+                        test_sysdb_remove_local_group_by_gid,
+                        MBO_GROUP_BASE , MBO_GROUP_BASE + 10);
+    suite_add_tcase(s, tc_memberof_serial);
+
     TCase *tc_subdomain = tcase_create("SYSDB sub-domain Tests");
 
     tcase_add_test(tc_subdomain, test_sysdb_subdomain_store_user);
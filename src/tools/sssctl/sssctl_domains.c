@@ -245,6 +245,7 @@ sssctl_domain_status_server_list(struct sbus_sync_connection *conn,
     TALLOC_CTX *tmp_ctx;
     const char **servers;
     const char **services;
+    uint32_t *rtt_usec;
     errno_t ret;
     int i, j;
 
@@ -272,8 +273,8 @@ sssctl_domain_status_server_list(struct sbus_sync_connection *conn,
     for (i = 0; services[i] != NULL; i++) {
         PRINT("Discovered %s servers:\n", proper_service_name(services[i]));
 
-        ret = sbus_call_ifp_domain_ListServers(tmp_ctx, conn, IFP_BUS,
-                  domain_path, services[i], &servers);
+        ret = sbus_call_ifp_domain_ListServerLatencies(tmp_ctx, conn, IFP_BUS,
+                  domain_path, services[i], &servers, &rtt_usec);
         if (ret != EOK) {
             DEBUG(SSSDBG_CRIT_FAILURE, "Unable to get domain servers [%d]: %s\n",
                   ret, sss_strerror(ret));
@@ -287,7 +288,13 @@ sssctl_domain_status_server_list(struct sbus_sync_connection *conn,
         }
 
         for (j = 0; servers[j] != NULL; j++) {
-            printf("- %s\n", servers[j]);
+            if ((size_t)j < talloc_array_length(rtt_usec)
+                    && rtt_usec[j] != 0) {
+                PRINT("- %s (round trip time %.1f ms)\n",
+                      servers[j], rtt_usec[j] / 1000.0);
+            } else {
+                printf("- %s\n", servers[j]);
+            }
         }
 
         printf("\n");
@@ -28,6 +28,9 @@
 #include <tevent.h>
 #include <sys/wait.h>
 #include <errno.h>
+#ifdef HAVE_PRCTL
+#include <sys/prctl.h>
+#endif
 
 #include "util/util.h"
 #include "util/find_uid.h"
@@ -519,6 +522,147 @@ int read_pipe_recv(struct tevent_req *req, TALLOC_CTX *mem_ctx,
     return EOK;
 }
 
+struct read_pipe_frame_state {
+    int fd;
+    uint8_t hdr[sizeof(uint32_t)];
+    size_t hdr_len;
+    uint8_t *buf;
+    uint32_t len;
+    uint32_t received;
+};
+
+static void read_pipe_frame_handler(struct tevent_context *ev,
+                                    struct tevent_fd *fde,
+                                    uint16_t flags, void *pvt);
+
+struct tevent_req *read_pipe_frame_send(TALLOC_CTX *mem_ctx,
+                                        struct tevent_context *ev, int fd)
+{
+    struct tevent_req *req;
+    struct read_pipe_frame_state *state;
+    struct tevent_fd *fde;
+
+    req = tevent_req_create(mem_ctx, &state, struct read_pipe_frame_state);
+    if (req == NULL) return NULL;
+
+    state->fd = fd;
+
+    fde = tevent_add_fd(ev, state, fd, TEVENT_FD_READ,
+                        read_pipe_frame_handler, req);
+    if (fde == NULL) {
+        DEBUG(SSSDBG_CRIT_FAILURE, "tevent_add_fd failed.\n");
+        talloc_zfree(req);
+        return NULL;
+    }
+
+    return req;
+}
+
+static void read_pipe_frame_handler(struct tevent_context *ev,
+                                    struct tevent_fd *fde,
+                                    uint16_t flags, void *pvt)
+{
+    struct tevent_req *req = talloc_get_type(pvt, struct tevent_req);
+    struct read_pipe_frame_state *state =
+                tevent_req_data(req, struct read_pipe_frame_state);
+    ssize_t size;
+    size_t p;
+    errno_t err;
+
+    if (state->hdr_len < sizeof(state->hdr)) {
+        size = read(state->fd, state->hdr + state->hdr_len,
+                    sizeof(state->hdr) - state->hdr_len);
+    } else {
+        size = read(state->fd, state->buf + state->received,
+                    state->len - state->received);
+    }
+
+    if (size == -1) {
+        err = errno;
+        if (err == EAGAIN || err == EINTR) {
+            return;
+        }
+        DEBUG(SSSDBG_CRIT_FAILURE,
+              "read failed [%d][%s].\n", err, strerror(err));
+        tevent_req_error(req, err);
+        return;
+    } else if (size == 0) {
+        DEBUG(SSSDBG_CRIT_FAILURE, "EOF received before the whole message\n");
+        tevent_req_error(req, EPIPE);
+        return;
+    }
+
+    if (state->hdr_len < sizeof(state->hdr)) {
+        state->hdr_len += size;
+        if (state->hdr_len < sizeof(state->hdr)) {
+            return;
+        }
+
+        p = 0;
+        SAFEALIGN_COPY_UINT32(&state->len, state->hdr, &p);
+        if (state->len > CHILD_MAX_FRAME_SIZE) {
+            DEBUG(SSSDBG_CRIT_FAILURE,
+                  "Message too large [%"PRIu32"]\n", state->len);
+            tevent_req_error(req, EMSGSIZE);
+            return;
+        }
+
+        if (state->len == 0) {
+            tevent_req_done(req);
+            return;
+        }
+
+        state->buf = talloc_size(state, state->len);
+        if (state->buf == NULL) {
+            tevent_req_error(req, ENOMEM);
+        }
+        return;
+    }
+
+    state->received += size;
+    if (state->received == state->len) {
+        tevent_req_done(req);
+    }
+}
+
+int read_pipe_frame_recv(struct tevent_req *req, TALLOC_CTX *mem_ctx,
+                         uint8_t **buf, ssize_t *len)
+{
+    struct read_pipe_frame_state *state =
+                tevent_req_data(req, struct read_pipe_frame_state);
+
+    TEVENT_REQ_RETURN_ON_ERROR(req);
+
+    *buf = talloc_steal(mem_ctx, state->buf);
+    *len = state->len;
+
+    return EOK;
+}
+
+uint8_t *child_frame_message(TALLOC_CTX *mem_ctx, uint8_t *buf, size_t len,
+                             size_t *_frame_len)
+{
+    uint8_t *frame;
+    size_t p = 0;
+
+    if (len > CHILD_MAX_FRAME_SIZE) {
+        return NULL;
+    }
+
+    frame = talloc_size(mem_ctx, sizeof(uint32_t) + len);
+    if (frame == NULL) {
+        return NULL;
+    }
+
+    SAFEALIGN_SET_UINT32(frame, len, &p);
+    if (len > 0) {
+        safealign_memcpy(frame + p, buf, len, &p);
+    }
+
+    *_frame_len = p;
+    return frame;
+}
+
 static void child_invoke_callback(struct tevent_context *ev,
                                   struct tevent_immediate *imm,
                                   void *pvt);
@@ -831,3 +975,902 @@ errno_t child_debug_init(const char *logfile, int *debug_fd)
 
     return EOK;
 }
+
+/* ==Child side of a pool===================================================*/
+
+static errno_t child_read_exact(int fd, uint8_t *buf, size_t len)
+{
+    ssize_t ret;
+
+    errno = 0;
+    ret = sss_atomic_read_s(fd, buf, len);
+    if (ret == -1) {
+        return (errno == 0) ? EIO : errno;
+    }
+
+    if (ret == 0 && len > 0) {
+        return ENODATA;
+    }
+
+    return (ret == len) ? EOK : EIO;
+}
+
+errno_t child_read_frame(TALLOC_CTX *mem_ctx, int fd,
+                         uint8_t **_buf, size_t *_len)
+{
+    uint8_t hdr[sizeof(uint32_t)];
+    uint8_t *buf = NULL;
+    uint32_t len;
+    size_t p = 0;
+    errno_t ret;
+
+    ret = child_read_exact(fd, hdr, sizeof(hdr));
+    if (ret != EOK) {
+        return ret;
+    }
+
+    SAFEALIGN_COPY_UINT32(&len, hdr, &p);
+    if (len > CHILD_MAX_FRAME_SIZE) {
+        DEBUG(SSSDBG_CRIT_FAILURE, "Message too large [%"PRIu32"]\n", len);
+        return EMSGSIZE;
+    }
+
+    if (len > 0) {
+        buf = talloc_size(mem_ctx, len);
+        if (buf == NULL) {
+            return ENOMEM;
+        }
+
+        ret = child_read_exact(fd, buf, len);
+        if (ret != EOK) {
+            talloc_free(buf);
+            return (ret == ENODATA) ? EIO : ret;
+        }
+    }
+
+    *_buf = buf;
+    *_len = len;
+    return EOK;
+}
+
+errno_t child_write_frame(int fd, uint8_t *buf, size_t len)
+{
+    uint8_t hdr[sizeof(uint32_t)];
+    ssize_t written;
+    size_t p = 0;
+
+    if (len > CHILD_MAX_FRAME_SIZE) {
+        return EMSGSIZE;
+    }
+
+    SAFEALIGN_SET_UINT32(hdr, len, &p);
+
+    errno = 0;
+    written = sss_atomic_write_s(fd, hdr, sizeof(hdr));
+    if (written == sizeof(hdr) && len > 0) {
+        written = sss_atomic_write_s(fd, buf, len);
+        p = len;
+    }
+
+    if (written == -1) {
+        return (errno == 0) ? EIO : errno;
+    }
+
+    return (written == p) ? EOK : EIO;
+}
+
+errno_t child_serve_requests(int in_fd, int out_fd,
+                             child_request_fn_t fn, void *pvt)
+{
+    TALLOC_CTX *tmp_ctx;
+    uint8_t *req;
+    size_t req_len;
+    uint8_t *reply;
+    size_t reply_len;
+    errno_t ret;
+
+    while (1) {
+        tmp_ctx = talloc_new(NULL);
+        if (tmp_ctx == NULL) {
+            return ENOMEM;
+        }
+
+        ret = child_read_frame(tmp_ctx, in_fd, &req, &req_len);
+        if (ret == ENODATA) {
+            DEBUG(SSSDBG_TRACE_FUNC, "No more requests\n");
+            ret = EOK;
+            break;
+        } else if (ret != EOK) {
+            DEBUG(SSSDBG_CRIT_FAILURE, "Unable to read request [%d]: %s\n",
+                  ret, sss_strerror(ret));
+            break;
+        }
+
+        reply = NULL;
+        reply_len = 0;
+
+        /* An empty request only checks that the child is alive. */
+        if (req_len > 0) {
+            ret = fn(tmp_ctx, req, req_len, &reply, &reply_len, pvt);
+            if (ret == EOK && reply_len == 0) {
+                ret = EINVAL;
+            }
+            if (ret != EOK) {
+                DEBUG(SSSDBG_CRIT_FAILURE, "Request failed [%d]: %s\n",
+                      ret, sss_strerror(ret));
+                /* Tell the parent and let it start a new child. */
+                child_write_frame(out_fd, NULL, 0);
+                break;
+            }
+        }
+
+        ret = child_write_frame(out_fd, reply, reply_len);
+        if (ret != EOK) {
+            DEBUG(SSSDBG_CRIT_FAILURE, "Unable to send reply [%d]: %s\n",
+                  ret, sss_strerror(ret));
+            break;
+        }
+
+        talloc_free(tmp_ctx);
+    }
+
+    talloc_free(tmp_ctx);
+    return ret;
+}
+
+/* In a worker, the process serving the current request and the worker
+ * which forked it, see child_worker_run(). */
+static pid_t child_worker_request_pid;
+static pid_t child_worker_pid;
+
+void child_worker_set_pdeathsig(void)
+{
+#ifdef HAVE_PRCTL
+    int ret;
+
+    if (child_worker_request_pid == 0
+            || getpid() != child_worker_request_pid) {
+        return;
+    }
+
+    ret = prctl(PR_SET_PDEATHSIG, SIGKILL);
+    if (ret != 0) {
+        ret = errno;
+        DEBUG(SSSDBG_MINOR_FAILURE, "prctl failed [%d]: %s\n",
+              ret, sss_strerror(ret));
+    }
+
+    /* The worker might be gone before the signal was set. */
+    if (getppid() != child_worker_pid) {
+        DEBUG(SSSDBG_CRIT_FAILURE, "Worker exited.\n");
+        _exit(-1);
+    }
+#endif
+}
+
+/* Run one request in a forked process and read its reply. */
+static errno_t child_worker_run(uint8_t *req, size_t req_len,
+                                uint8_t **_reply, size_t *_reply_len,
+                                bool *_is_request_process)
+{
+    int pipefd_to_req[2] = PIPE_INIT;
+    int pipefd_from_req[2] = PIPE_INIT;
+    uint8_t chunk[CHILD_MSG_CHUNK];
+    uint8_t *reply = NULL;
+    size_t reply_len = 0;
+    ssize_t len;
+    pid_t worker_pid;
+    pid_t pid;
+    int status;
+    errno_t ret;
+
+    *_is_request_process = false;
+
+    if (pipe(pipefd_to_req) == -1 || pipe(pipefd_from_req) == -1) {
+        ret = errno;
+        DEBUG(SSSDBG_CRIT_FAILURE,
+              "pipe failed [%d][%s].\n", ret, strerror(ret));
+        goto done;
+    }
+
+    worker_pid = getpid();
+
+    pid = fork();
+    if (pid == -1) {
+        ret = errno;
+        DEBUG(SSSDBG_CRIT_FAILURE,
+              "fork failed [%d][%s].\n", ret, strerror(ret));
+        goto done;
+    }
+
+    if (pid == 0) {
+        child_worker_pid = worker_pid;
+        child_worker_request_pid = getpid();
+        child_worker_set_pdeathsig();
+
+        if (dup2(pipefd_to_req[0], STDIN_FILENO) == -1
+                || dup2(pipefd_from_req[1], STDOUT_FILENO) == -1) {
+            ret = errno;
+            DEBUG(SSSDBG_CRIT_FAILURE,
+                  "dup2 failed [%d][%s].\n", ret, strerror(ret));
+            _exit(-1);
+        }
+        PIPE_CLOSE(pipefd_to_req);
+        PIPE_CLOSE(pipefd_from_req);
+
+        *_is_request_process = true;
+        return EOK;
+    }
+
+    PIPE_FD_CLOSE(pipefd_to_req[0]);
+    PIPE_FD_CLOSE(pipefd_from_req[1]);
+
+    errno = 0;
+    len = sss_atomic_write_s(pipefd_to_req[1], req, req_len);
+    if (len == -1) {
+        ret = (errno == 0) ? EIO : errno;
+    } else {
+        ret = (len == req_len) ? EOK : EIO;
+    }
+    PIPE_FD_CLOSE(pipefd_to_req[1]);
+    if (ret != EOK) {
+        DEBUG(SSSDBG_CRIT_FAILURE, "Unable to pass the request [%d]: %s\n",
+              ret, sss_strerror(ret));
+    }
+
+    /* Read the reply until the request process exits. */
+    while (ret == EOK) {
+        errno = 0;
+        len = sss_atomic_read_s(pipefd_from_req[0], chunk, sizeof(chunk));
+        if (len == -1) {
+            ret = (errno == 0) ? EIO : errno;
+            break;
+        } else if (len == 0) {
+            break;
+        }
+
+        reply = talloc_realloc(NULL, reply, uint8_t, reply_len + len);
+        if (reply == NULL) {
+            ret = ENOMEM;
+            break;
+        }
+        memcpy(reply + reply_len, chunk, len);
+        reply_len += len;
+    }
+
+    while (waitpid(pid, &status, 0) == -1 && errno == EINTR);
+
+    if (ret == EOK && reply_len == 0) {
+        DEBUG(SSSDBG_CRIT_FAILURE, "Request process [%d] did not reply.\n",
+              pid);
+        ret = EIO;
+    }
+
+done:
+    PIPE_CLOSE(pipefd_to_req);
+    PIPE_CLOSE(pipefd_from_req);
+
+    if (ret != EOK) {
+        talloc_free(reply);
+        return ret;
+    }
+
+    *_reply = reply;
+    *_reply_len = reply_len;
+    return EOK;
+}
+
+errno_t child_worker_loop(size_t max_len)
+{
+    TALLOC_CTX *tmp_ctx;
+    uint8_t *req;
+    size_t req_len;
+    uint8_t *reply;
+    size_t reply_len;
+    bool is_request_process;
+    errno_t ret;
+
+    DEBUG(SSSDBG_TRACE_FUNC, "Waiting for requests.\n");
+
+    while (1) {
+        tmp_ctx = talloc_new(NULL);
+        if (tmp_ctx == NULL) {
+            break;
+        }
+
+        ret = child_read_frame(tmp_ctx, STDIN_FILENO, &req, &req_len);
+        if (ret == ENODATA) {
+            DEBUG(SSSDBG_TRACE_FUNC, "No more requests, exiting.\n");
+            _exit(0);
+        } else if (ret != EOK) {
+            break;
+        }
+
+        reply = NULL;
+        reply_len = 0;
+
+        /* An empty request only checks that the worker is alive. */
+        if (req_len > max_len) {
+            DEBUG(SSSDBG_CRIT_FAILURE, "Request too large [%zu].\n", req_len);
+            ret = EINVAL;
+        } else if (req_len > 0) {
+            ret = child_worker_run(req, req_len, &reply, &reply_len,
+                                   &is_request_process);
+            sss_erase_mem_securely(req, req_len);
+            if (is_request_process) {
+                talloc_free(tmp_ctx);
+                return EOK;
+            }
+            talloc_steal(tmp_ctx, reply);
+        }
+
+        if (ret != EOK) {
+            /* Let the parent know the request failed, it will replace
+             * this process. */
+            child_write_frame(STDOUT_FILENO, NULL, 0);
+            break;
+        }
+
+        ret = child_write_frame(STDOUT_FILENO, reply, reply_len);
+        talloc_free(tmp_ctx);
+        if (ret != EOK) {
+            break;
+        }
+    }
+
+    DEBUG(SSSDBG_CRIT_FAILURE, "Worker failed, exiting.\n");
+    _exit(-1);
+}
+
+/* ==Pool of long-lived children============================================*/
+
+#define CHILD_POOL_CHECK_INTERVAL 30
+#define CHILD_POOL_PING_TIMEOUT 5
+
+struct sss_child_worker {
+    struct sss_child_worker *prev;
+    struct sss_child_worker *next;
+
+    struct sss_child_pool *pool;
+    struct sss_child_ctx_old *child_ctx;
+    pid_t pid;
+    int to_child_fd;
+    int from_child_fd;
+
+    /* request currently served by the child */
+    struct tevent_req *req;
+    uint32_t requests;
+    time_t last_used;
+};
+
+struct sss_child_pool {
+    struct tevent_context *ev;
+    const char *binary;
+    const char **argv;
+    int debug_fd;
+
+    uint32_t size;
+    uint32_t max_requests;
+    uint32_t idle_timeout;
+
+    struct sss_child_worker *workers;
+    uint32_t num_workers;
+    struct tevent_timer *check_timer;
+};
+
+static int sss_child_worker_destructor(struct sss_child_worker *worker);
+
+static void sss_child_worker_exited(int child_status,
+                                    struct tevent_signal *sige,
+                                    void *pvt)
+{
+    struct sss_child_worker *worker;
+
+    worker = talloc_get_type(pvt, struct sss_child_worker);
+
+    /* The handler context is freed by the caller. */
+    worker->child_ctx = NULL;
+
+    DEBUG(SSSDBG_TRACE_FUNC, "Pooled child [%d] exited\n", worker->pid);
+
+    /* A busy child is released by its request which fails on EOF. */
+    if (worker->req == NULL) {
+        talloc_free(worker);
+    }
+}
+
+static errno_t sss_child_worker_spawn(struct sss_child_pool *pool)
+{
+    int pipefd_to_child[2] = PIPE_INIT;
+    int pipefd_from_child[2] = PIPE_INIT;
+    struct sss_child_worker *worker;
+    pid_t pid;
+    errno_t ret;
+
+    if (pipe(pipefd_from_child) == -1 || pipe(pipefd_to_child) == -1) {
+        ret = errno;
+        DEBUG(SSSDBG_CRIT_FAILURE,
+              "pipe failed [%d][%s].\n", ret, strerror(ret));
+        goto done;
+    }
+
+    pid = fork();
+    if (pid == 0) { /* child */
+        exec_child_ex(pool, pipefd_to_child, pipefd_from_child,
+                      pool->binary, pool->debug_fd, pool->argv, false,
+                      STDIN_FILENO, STDOUT_FILENO);
+
+        /* We should never get here */
+        DEBUG(SSSDBG_CRIT_FAILURE, "BUG: Could not exec %s\n", pool->binary);
+        _exit(1);
+    } else if (pid == -1) {
+        ret = errno;
+        DEBUG(SSSDBG_CRIT_FAILURE,
+              "fork failed [%d][%s].\n", ret, strerror(ret));
+        goto done;
+    }
+
+    worker = talloc_zero(pool, struct sss_child_worker);
+    if (worker == NULL) {
+        kill(pid, SIGKILL);
+        ret = ENOMEM;
+        goto done;
+    }
+
+    worker->pool = pool;
+    worker->pid = pid;
+    worker->last_used = time(NULL);
+    worker->from_child_fd = pipefd_from_child[0];
+    pipefd_from_child[0] = -1;
+    worker->to_child_fd = pipefd_to_child[1];
+    pipefd_to_child[1] = -1;
+    sss_fd_nonblocking(worker->from_child_fd);
+    sss_fd_nonblocking(worker->to_child_fd);
+
+    DLIST_ADD(pool->workers, worker);
+    pool->num_workers++;
+    talloc_set_destructor(worker, sss_child_worker_destructor);
+
+    ret = child_handler_setup(pool->ev, pid, sss_child_worker_exited, worker,
+                              &worker->child_ctx);
+    if (ret != EOK) {
+        DEBUG(SSSDBG_CRIT_FAILURE, "Could not set up child signal handler\n");
+        kill(pid, SIGKILL);
+        talloc_free(worker);
+        goto done;
+    }
+
+    DEBUG(SSSDBG_TRACE_FUNC, "Started pooled child [%d] of %s\n",
+          pid, pool->binary);
+    ret = EOK;
+
+done:
+    PIPE_CLOSE(pipefd_from_child);
+    PIPE_CLOSE(pipefd_to_child);
+    return ret;
+}
+
+static void sss_child_pool_fill(struct sss_child_pool *pool)
+{
+    errno_t ret;
+
+    while (pool->num_workers < pool->size) {
+        ret = sss_child_worker_spawn(pool);
+        if (ret != EOK) {
+            DEBUG(SSSDBG_OP_FAILURE, "Unable to start a pooled child "
+                  "[%d]: %s\n", ret, sss_strerror(ret));
+            return;
+        }
+    }
+}
+
+struct sss_child_exchange_state {
+    struct tevent_context *ev;
+    struct sss_child_worker *worker;
+    struct tevent_req *subreq;
+    struct tevent_timer *timeout_handler;
+
+    uint8_t *frame;
+    size_t frame_len;
+    uint8_t *buf;
+    ssize_t len;
+    bool ping;
+};
+
+static void sss_child_worker_release(struct sss_child_worker *worker,
+                                     bool ok, bool ping)
+{
+    struct sss_child_pool *pool = worker->pool;
+
+    worker->req = NULL;
+    if (!ping) {
+        worker->requests++;
+        worker->last_used = time(NULL);
+    }
+
+    if (!ok || worker->child_ctx == NULL
+            || (pool->max_requests > 0
+                    && worker->requests >= pool->max_requests)) {
+        DEBUG(SSSDBG_TRACE_FUNC, "Retiring pooled child [%d] after "
+              "%"PRIu32" requests\n", worker->pid, worker->requests);
+        talloc_free(worker);
+    }
+}
+
+static int sss_child_worker_destructor(struct sss_child_worker *worker)
+{
+    struct sss_child_exchange_state *state;
+
+    if (worker->req != NULL) {
+        /* Only happens when the whole pool is freed. */
+        state = tevent_req_data(worker->req, struct sss_child_exchange_state);
+        talloc_zfree(state->subreq);
+        state->worker = NULL;
+        worker->req = NULL;
+    }
+
+    if (worker->child_ctx != NULL) {
+        /* kills the child, it is still reaped in the background */
+        child_handler_destroy(worker->child_ctx);
+        worker->child_ctx = NULL;
+    }
+
+    if (worker->to_child_fd != -1) {
+        close(worker->to_child_fd);
+    }
+    if (worker->from_child_fd != -1) {
+        close(worker->from_child_fd);
+    }
+
+    DLIST_REMOVE(worker->pool->workers, worker);
+    worker->pool->num_workers--;
+
+    return 0;
+}
+
+static int sss_child_exchange_destructor(struct sss_child_exchange_state *state)
+{
+    /* A successful exchange already released the child, one still attached
+     * here did not finish and cannot be trusted with another request. */
+    if (state->worker != NULL) {
+        sss_child_worker_release(state->worker, false, state->ping);
+        state->worker = NULL;
+    }
+
+    return 0;
+}
+
+static void sss_child_exchange_timeout(struct tevent_context *ev,
+                                       struct tevent_timer *te,
+                                       struct timeval tv, void *pvt);
+static void sss_child_exchange_written(struct tevent_req *subreq);
+static void sss_child_exchange_done(struct tevent_req *subreq);
+
+/* Sends one framed message to the given child and waits for the reply. */
+static struct tevent_req *
+sss_child_exchange_send(TALLOC_CTX *mem_ctx,
+                        struct tevent_context *ev,
+                        struct sss_child_worker *worker,
+                        uint8_t *buf, size_t len,
+                        uint32_t timeout,
+                        bool ping)
+{
+    struct sss_child_exchange_state *state;
+    struct tevent_req *req;
+    struct timeval tv;
+    errno_t ret;
+
+    req = tevent_req_create(mem_ctx, &state, struct sss_child_exchange_state);
+    if (req == NULL) {
+        return NULL;
+    }
+
+    state->ev = ev;
+    state->ping = ping;
+
+    /* empty messages are reserved for the health checks */
+    if (!ping && len == 0) {
+        ret = EINVAL;
+        goto done;
+    }
+
+    if (worker == NULL) {
+        ret = EBUSY;
+        goto done;
+    }
+
+    state->worker = worker;
+    worker->req = req;
+    talloc_set_destructor(state, sss_child_exchange_destructor);
+
+    state->frame = child_frame_message(state, buf, len, &state->frame_len);
+    if (state->frame == NULL) {
+        ret = ENOMEM;
+        goto done;
+    }
+
+    if (timeout > 0) {
+        tv = tevent_timeval_current_ofs(timeout, 0);
+        state->timeout_handler = tevent_add_timer(ev, state, tv,
+                                                  sss_child_exchange_timeout,
+                                                  req);
+        if (state->timeout_handler == NULL) {
+            ret = ENOMEM;
+            goto done;
+        }
+    }
+
+    state->subreq = write_pipe_send(state, ev, state->frame, state->frame_len,
+                                    worker->to_child_fd);
+    if (state->subreq == NULL) {
+        ret = ENOMEM;
+        goto done;
+    }
+    tevent_req_set_callback(state->subreq, sss_child_exchange_written, req);
+
+    return req;
+
+done:
+    tevent_req_error(req, ret);
+    tevent_req_post(req, ev);
+    return req;
+}
+
+static void sss_child_exchange_timeout(struct tevent_context *ev,
+                                       struct tevent_timer *te,
+                                       struct timeval tv, void *pvt)
+{
+    struct tevent_req *req = talloc_get_type(pvt, struct tevent_req);
+    struct sss_child_exchange_state *state =
+                tevent_req_data(req, struct sss_child_exchange_state);
+
+    state->timeout_handler = NULL;
+    talloc_zfree(state->subreq);
+
+    if (state->worker != NULL) {
+        DEBUG(SSSDBG_IMPORTANT_INFO, "Timeout for pooled child [%d] "
+              "reached\n", state->worker->pid);
+
+        /* The child is killed when it is released. */
+        sss_child_worker_release(state->worker, false, state->ping);
+        state->worker = NULL;
+    }
+
+    tevent_req_error(req, ETIMEDOUT);
+}
+
+static void sss_child_exchange_written(struct tevent_req *subreq)
+{
+    struct tevent_req *req = tevent_req_callback_data(subreq,
+                                                      struct tevent_req);
+    struct sss_child_exchange_state *state =
+                tevent_req_data(req, struct sss_child_exchange_state);
+    errno_t ret;
+
+    ret = write_pipe_recv(subreq);
+    talloc_zfree(subreq);
+    state->subreq = NULL;
+    if (ret != EOK) {
+        tevent_req_error(req, ret);
+        return;
+    }
+
+    state->subreq = read_pipe_frame_send(state, state->ev,
+                                         state->worker->from_child_fd);
+    if (state->subreq == NULL) {
+        tevent_req_error(req, ENOMEM);
+        return;
+    }
+    tevent_req_set_callback(state->subreq, sss_child_exchange_done, req);
+}
+
+static void sss_child_exchange_done(struct tevent_req *subreq)
+{
+    struct tevent_req *req = tevent_req_callback_data(subreq,
+                                                      struct tevent_req);
+    struct sss_child_exchange_state *state =
+                tevent_req_data(req, struct sss_child_exchange_state);
+    errno_t ret;
+
+    ret = read_pipe_frame_recv(subreq, state, &state->buf, &state->len);
+    talloc_zfree(subreq);
+    state->subreq = NULL;
+    talloc_zfree(state->timeout_handler);
+    if (ret != EOK) {
+        tevent_req_error(req, ret);
+        return;
+    }
+
+    if (!state->ping && state->len == 0) {
+        DEBUG(SSSDBG_OP_FAILURE, "Pooled child [%d] failed to handle "
+              "the request\n", state->worker->pid);
+        tevent_req_error(req, EIO);
+        return;
+    }
+
+    /* The child can serve the next request right away. */
+    sss_child_worker_release(state->worker, true, state->ping);
+    state->worker = NULL;
+
+    tevent_req_done(req);
+}
+
+static int sss_child_exchange_recv(struct tevent_req *req,
+                                   TALLOC_CTX *mem_ctx,
+                                   uint8_t **buf, ssize_t *len)
+{
+    struct sss_child_exchange_state *state =
+                tevent_req_data(req, struct sss_child_exchange_state);
+
+    TEVENT_REQ_RETURN_ON_ERROR(req);
+
+    if (buf != NULL) {
+        *buf = talloc_steal(mem_ctx, state->buf);
+    }
+    if (len != NULL) {
+        *len = state->len;
+    }
+
+    return EOK;
+}
+
+static void sss_child_pool_ping_done(struct tevent_req *req)
+{
+    errno_t ret;
+
+    ret = sss_child_exchange_recv(req, NULL, NULL, NULL);
+    talloc_free(req);
+    if (ret != EOK) {
+        DEBUG(SSSDBG_MINOR_FAILURE, "Pooled child did not answer the health "
+              "check [%d]: %s\n", ret, sss_strerror(ret));
+    }
+}
+
+static void sss_child_pool_check(struct tevent_context *ev,
+                                 struct tevent_timer *te,
+                                 struct timeval tv, void *pvt);
+
+static void sss_child_pool_schedule_check(struct sss_child_pool *pool)
+{
+    struct timeval tv;
+
+    tv = tevent_timeval_current_ofs(CHILD_POOL_CHECK_INTERVAL, 0);
+    pool->check_timer = tevent_add_timer(pool->ev, pool, tv,
+                                         sss_child_pool_check, pool);
+    if (pool->check_timer == NULL) {
+        DEBUG(SSSDBG_MINOR_FAILURE,
+              "Unable to schedule the pooled children check\n");
+    }
+}
+
+/* Stops children idle for longer than the idle timeout and checks that the
+ * remaining idle children still answer. */
+static void sss_child_pool_check(struct tevent_context *ev,
+                                 struct tevent_timer *te,
+                                 struct timeval tv, void *pvt)
+{
+    struct sss_child_pool *pool = talloc_get_type(pvt, struct sss_child_pool);
+    struct sss_child_worker *worker;
+    struct sss_child_worker *next;
+    struct tevent_req *req;
+    time_t now = time(NULL);
+
+    pool->check_timer = NULL;
+
+    DLIST_FOR_EACH_SAFE(worker, next, pool->workers) {
+        if (worker->req != NULL || worker->child_ctx == NULL) {
+            continue;
+        }
+
+        if (pool->idle_timeout > 0
+                && now - worker->last_used >= pool->idle_timeout) {
+            DEBUG(SSSDBG_TRACE_FUNC, "Stopping idle pooled child [%d]\n",
+                  worker->pid);
+            talloc_free(worker);
+            continue;
+        }
+
+        req = sss_child_exchange_send(pool, ev, worker, NULL, 0,
+                                      CHILD_POOL_PING_TIMEOUT, true);
+        if (req == NULL) {
+            continue;
+        }
+        tevent_req_set_callback(req, sss_child_pool_ping_done, NULL);
+    }
+
+    sss_child_pool_schedule_check(pool);
+}
+
+errno_t sss_child_pool_init(TALLOC_CTX *mem_ctx,
+                            struct tevent_context *ev,
+                            const char *binary,
+                            const char *extra_argv[],
+                            int debug_fd,
+                            uint32_t size,
+                            uint32_t max_requests,
+                            uint32_t idle_timeout,
+                            struct sss_child_pool **_pool)
+{
+    struct sss_child_pool *pool;
+    size_t argc = 0;
+    size_t i;
+
+    if (binary == NULL || size == 0) {
+        return EINVAL;
+    }
+
+    pool = talloc_zero(mem_ctx, struct sss_child_pool);
+    if (pool == NULL) {
+        return ENOMEM;
+    }
+
+    pool->ev = ev;
+    pool->debug_fd = debug_fd;
+    pool->size = size;
+    pool->max_requests = max_requests;
+    pool->idle_timeout = idle_timeout;
+
+    pool->binary = talloc_strdup(pool, binary);
+    if (pool->binary == NULL) {
+        goto fail;
+    }
+
+    if (extra_argv != NULL) {
+        for (argc = 0; extra_argv[argc] != NULL; argc++);
+    }
+
+    pool->argv = talloc_zero_array(pool, const char *, argc + 2);
+    if (pool->argv == NULL) {
+        goto fail;
+    }
+
+    for (i = 0; i < argc; i++) {
+        pool->argv[i] = talloc_strdup(pool->argv, extra_argv[i]);
+        if (pool->argv[i] == NULL) {
+            goto fail;
+        }
+    }
+    pool->argv[argc] = "--" CHILD_OPT_WORKER;
+
+    sss_child_pool_fill(pool);
+    sss_child_pool_schedule_check(pool);
+
+    *_pool = pool;
+    return EOK;
+
+fail:
+    talloc_free(pool);
+    return ENOMEM;
+}
+
+struct tevent_req *sss_child_pool_send(TALLOC_CTX *mem_ctx,
+                                       struct tevent_context *ev,
+                                       struct sss_child_pool *pool,
+                                       uint8_t *buf, size_t len,
+                                       uint32_t timeout)
+{
+    struct sss_child_worker *worker;
+
+    /* Start the children stopped since the last request ahead of time. */
+    sss_child_pool_fill(pool);
+
+    DLIST_FOR_EACH(worker, pool->workers) {
+        if (worker->req == NULL && worker->child_ctx != NULL) {
+            break;
+        }
+    }
+
+    if (worker == NULL) {
+        DEBUG(SSSDBG_TRACE_FUNC, "All pooled children of %s are busy\n",
+              pool->binary);
+    }
+
+    return sss_child_exchange_send(mem_ctx, ev, worker, buf, len, timeout,
+                                   false);
+}
+
+int sss_child_pool_recv(struct tevent_req *req, TALLOC_CTX *mem_ctx,
+                        uint8_t **buf, ssize_t *len)
+{
+    return sss_child_exchange_recv(req, mem_ctx, buf, len);
+}
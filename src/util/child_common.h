@@ -38,6 +38,10 @@
 #define SIGTERM_TO_SIGKILL_TIME 2
 #define CHILD_TIMEOUT_EXIT_CODE 7
 
+/* Children started by a pool get this option and read framed requests. */
+#define CHILD_OPT_WORKER "worker"
+#define CHILD_MAX_FRAME_SIZE (1024 * 1024)
+
 struct response {
     uint8_t *buf;
     size_t size;
@@ -100,6 +104,80 @@ struct tevent_req *read_pipe_send(TALLOC_CTX *mem_ctx,
 int read_pipe_recv(struct tevent_req *req, TALLOC_CTX *mem_ctx,
                    uint8_t **buf, ssize_t *len);
 
+/* Messages exchanged with long-lived children are framed with their length
+ * as a 32-bit integer so the pipes can be used for several requests. */
+uint8_t *child_frame_message(TALLOC_CTX *mem_ctx, uint8_t *buf, size_t len,
+                             size_t *_frame_len);
+
+/* Reads one framed message, buf is NULL if the message is empty */
+struct tevent_req *read_pipe_frame_send(TALLOC_CTX *mem_ctx,
+                                        struct tevent_context *ev, int fd);
+int read_pipe_frame_recv(struct tevent_req *req, TALLOC_CTX *mem_ctx,
+                         uint8_t **buf, ssize_t *len);
+
+/* Blocking variants for the child side, child_read_frame() returns
+ * ENODATA if the parent closed the pipe. */
+errno_t child_read_frame(TALLOC_CTX *mem_ctx, int fd,
+                         uint8_t **_buf, size_t *_len);
+errno_t child_write_frame(int fd, uint8_t *buf, size_t len);
+
+typedef errno_t (*child_request_fn_t)(TALLOC_CTX *mem_ctx,
+                                      uint8_t *req, size_t req_len,
+                                      uint8_t **_reply, size_t *_reply_len,
+                                      void *pvt);
+
+/* Serve framed requests until the parent closes the pipe. Empty requests
+ * are health checks and are answered with an empty reply. If fn fails an
+ * empty reply is sent and the error is returned, the child should exit. */
+errno_t child_serve_requests(int in_fd, int out_fd,
+                             child_request_fn_t fn, void *pvt);
+
+/* Serve framed requests, each one in a process forked for it which reads
+ * the request on stdin and writes the reply to stdout, as a child started
+ * for a single request does. Requests larger than max_len are refused.
+ * Only returns, with EOK, in the forked process; the worker itself exits
+ * when the parent closes the pipe or a request fails. */
+errno_t child_worker_loop(size_t max_len);
+
+/* The parent death signal is cleared by the kernel whenever the credentials
+ * change, the process forked by child_worker_loop() must call this after
+ * each switch. Otherwise the request would outlive a worker killed because
+ * of a timeout. Does nothing in other processes. */
+void child_worker_set_pdeathsig(void);
+
+/* Pool of long-lived children of one helper binary. The children are
+ * started with the CHILD_OPT_WORKER option and must serve the requests with
+ * child_serve_requests(), child_worker_loop() or an equivalent loop.
+ *
+ * size children are started ahead of time. A child is replaced after a
+ * failed request and after max_requests requests (0 means no limit).
+ * Children idle for more than idle_timeout seconds (0 means never) are
+ * stopped and started again on the next request. Idle children are
+ * periodically checked with an empty request and replaced if they do not
+ * answer. */
+struct sss_child_pool;
+
+errno_t sss_child_pool_init(TALLOC_CTX *mem_ctx,
+                            struct tevent_context *ev,
+                            const char *binary,
+                            const char *extra_argv[],
+                            int debug_fd,
+                            uint32_t size,
+                            uint32_t max_requests,
+                            uint32_t idle_timeout,
+                            struct sss_child_pool **_pool);
+
+/* Fails with EBUSY if all children are busy, the caller may start a
+ * dedicated child instead. The child is killed if it does not reply
+ * within timeout seconds (0 means no timeout). */
+struct tevent_req *sss_child_pool_send(TALLOC_CTX *mem_ctx,
+                                       struct tevent_context *ev,
+                                       struct sss_child_pool *pool,
+                                       uint8_t *buf, size_t len,
+                                       uint32_t timeout);
+int sss_child_pool_recv(struct tevent_req *req, TALLOC_CTX *mem_ctx,
+                        uint8_t **buf, ssize_t *len);
+
 /* The pipes to communicate with the child must be nonblocking */
 void fd_nonblocking(int fd);
 
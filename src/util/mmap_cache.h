@@ -60,6 +60,12 @@ typedef uint32_t rel_ptr_t;
  *
  * 3 blocks are enough for groups w/o users (private user groups)
  * group records have 68 bytes of overhead, 120 - 66 = 54 bytes
+ *
+ * 2 blocks are enough for services w/o aliases (name + protocol)
+ * service records have 56 bytes of overhead, 80 - 56 = 24 bytes
+ *
+ * 3 blocks are enough for a SID and a fully qualified name
+ * sid records have 52 bytes of overhead, 120 - 52 = 68 bytes
  */
 #define MC_SLOT_SIZE 40
 #define MC_SIZE_TO_SLOTS(len) (((len) + (MC_SLOT_SIZE - 1)) / MC_SLOT_SIZE)
@@ -149,6 +155,30 @@ struct sss_mc_initgr_data {
                              * after gids */
 };
 
+struct sss_mc_svc_data {
+    rel_ptr_t name;         /* ptr to name string, rel. to struct base addr */
+    uint32_t port;          /* port number in host byte order */
+    uint32_t aliases;       /* number of aliases in strs */
+    uint32_t strs_len;      /* length of strs */
+    char strs[0];           /* concatenation of all service strings, each
+                             * string is zero terminated ordered as follows:
+                             * name, protocol, alias1, alias2, ... */
+};
+
+struct sss_mc_sid_data {
+    rel_ptr_t name;         /* ptr to key string, rel. to struct base addr,
+                             * points either to the SID (record is chained
+                             * by SID and ID) or to the name (record is
+                             * chained by name and SID) */
+    uint32_t type;          /* enum sss_id_type of the object */
+    uint32_t id;            /* POSIX ID of the object */
+    uint32_t reserved;      /* reserved for future changes */
+    uint32_t strs_len;      /* length of strs */
+    char strs[0];           /* concatenation of all sid strings, each
+                             * string is zero terminated ordered as follows:
+                             * sid, name */
+};
+
 #pragma pack()
 
 